@@ -605,8 +605,8 @@ TFE_TensorHandle* TFE_NewTensorHandleFromDeviceMemory(
     dimvec[i] = static_cast<int64_t>(dims[i]);
   }
 
-  // TODO(apassos) do we need to wrap the deallocator here to make sure to sync
-  // the device?
+  // The deallocator is not synchronized with the device, see the contract in
+  // c_api_experimental.h.
   TF_ManagedBuffer* buf =
       new TF_ManagedBuffer(data, len, deallocator, deallocator_arg,
                            /*owns_memory=*/false);
@@ -459,6 +459,15 @@ TF_CAPI_EXPORT extern size_t TFE_TensorHandleDeviceMemorySize(TFE_TensorHandle*,
 // device_name. Takes ownership of the memory, and will call deleter to release
 // it after TF no longer needs it or in case of error.
 //
+// The memory is wrapped without a copy, so this can pass host or pinned host
+// buffers (on a CPU device) and device buffers (on e.g. a GPU device) produced
+// outside of TF into ops. The memory must be ready when this is called: if it
+// was written on a stream other than TF's, synchronize that stream first.
+// Conversely, device kernels reading the memory may still be in flight when
+// the deallocator is called, so device memory must be released in a way that
+// is ordered after them (e.g. a blocking cudaFree, or a stream-ordered free on
+// TF's compute stream).
+//
 // Custom devices must use TFE_NewCustomDeviceTensorHandle instead.
 TF_CAPI_EXPORT extern TFE_TensorHandle* TFE_NewTensorHandleFromDeviceMemory(
     TFE_Context* ctx, const char* device_name, TF_DataType, const int64_t* dims,
@@ -452,6 +452,34 @@ TEST(CAPI, TensorHandleOnDeviceMemory) {
   TF_DeleteStatus(status);
 }
 
+void SetDeleted(void* data, size_t unused, void* deleted) {
+  *static_cast<bool*>(deleted) = true;
+}
+
+TEST(CAPI, TensorHandleOnHostMemoryIsNotCopied) {
+  TF_Status* status = TF_NewStatus();
+  TFE_ContextOptions* opts = TFE_NewContextOptions();
+  TFE_Context* ctx = TFE_NewContext(opts, status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  TFE_DeleteContextOptions(opts);
+
+  alignas(64) float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  bool deleted = false;
+  int64_t dims[] = {2, 2};
+  TFE_TensorHandle* h = TFE_NewTensorHandleFromDeviceMemory(
+      ctx, "/job:localhost/replica:0/task:0/device:CPU:0", TF_FLOAT, dims, 2,
+      data, sizeof(data), &SetDeleted, &deleted, status);
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  EXPECT_EQ(data, TFE_TensorHandleDevicePointer(h, status));
+  CHECK_EQ(TF_OK, TF_GetCode(status)) << TF_Message(status);
+  EXPECT_FALSE(deleted);
+  TFE_DeleteTensorHandle(h);
+  EXPECT_TRUE(deleted);
+
+  TFE_DeleteContext(ctx);
+  TF_DeleteStatus(status);
+}
+
 TEST(CAPI, TensorHandleNullptr) {
   TFE_TensorHandle* h = nullptr;
   std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status(
@@ -33,10 +33,12 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/op_def.pb.h"
 #include "tensorflow/core/framework/versions.pb.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system_helper.h"
 #include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/fingerprint.pb.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
@@ -265,6 +267,91 @@ absl::StatusOr<uint64_t> HashFields(
   return field_checksum;
 }
 
+namespace {
+
+// Chunks are read and hashed in batches of about this many bytes, which bounds
+// the memory held while hashing.
+constexpr uint64_t kMaxChunkBatchBytes = uint64_t{256} << 20;
+
+// Appends the indices of the chunks referenced by `chunked_message`, in the
+// order in which HashFields hashes them when given no field tags.
+void CollectChunkIndices(const ChunkedMessage& chunked_message,
+                         std::vector<uint64_t>* chunk_indices) {
+  for (const ChunkedField& chunked_field : chunked_message.chunked_fields()) {
+    const ChunkedMessage& message = chunked_field.message();
+    if (message.has_chunk_index()) {
+      chunk_indices->push_back(message.chunk_index());
+    } else {
+      CollectChunkIndices(message, chunk_indices);
+    }
+  }
+}
+
+// Combines `chunk_hashes`, from index `*next` in CollectChunkIndices order,
+// the same way HashFields combines the hashes of the chunks.
+uint64_t CombineChunkHashes(const ChunkedMessage& chunked_message,
+                            const std::vector<uint64_t>& chunk_hashes,
+                            size_t* next) {
+  uint64_t field_checksum = 0;
+  for (const ChunkedField& chunked_field : chunked_message.chunked_fields()) {
+    const ChunkedMessage& message = chunked_field.message();
+    const uint64_t hash =
+        message.has_chunk_index()
+            ? chunk_hashes[(*next)++]
+            : CombineChunkHashes(message, chunk_hashes, next);
+    field_checksum = FingerprintCat64(field_checksum, hash);
+  }
+  return field_checksum;
+}
+
+}  // namespace
+
+absl::StatusOr<uint64_t> HashChunks(
+    const ChunkedMessage& chunked_message,
+    riegeli::RecordReader<riegeli::FdReader<>>& reader,
+    const std::vector<ChunkInfo>& chunks_info,
+    thread::ThreadPool* thread_pool) {
+  std::vector<uint64_t> chunk_indices;
+  CollectChunkIndices(chunked_message, &chunk_indices);
+  std::vector<uint64_t> chunk_hashes(chunk_indices.size());
+
+  std::vector<std::string> batch;
+  size_t batch_start = 0;
+  uint64_t batch_bytes = 0;
+  auto hash_batch = [&]() {
+    auto hash_chunks = [&](int64_t start, int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        chunk_hashes[batch_start + i] = Fingerprint64(batch[i]);
+      }
+    };
+    if (thread_pool != nullptr && batch.size() > 1) {
+      thread_pool->ParallelFor(batch.size(), batch_bytes / batch.size(),
+                               hash_chunks);
+    } else {
+      hash_chunks(0, batch.size());
+    }
+    batch_start += batch.size();
+    batch.clear();
+    batch_bytes = 0;
+  };
+  // The reader is not thread safe, so the chunks are read sequentially.
+  for (uint64_t chunk_index : chunk_indices) {
+    if (chunk_index >= chunks_info.size()) {
+      return absl::FailedPreconditionError(
+          absl::StrCat("Chunk index out of range: ", chunk_index));
+    }
+    TF_ASSIGN_OR_RETURN(std::string chunk,
+                        ReadChunk(reader, chunks_info[chunk_index]));
+    batch_bytes += chunk.size();
+    batch.push_back(std::move(chunk));
+    if (batch_bytes >= kMaxChunkBatchBytes) hash_batch();
+  }
+  hash_batch();
+
+  size_t next = 0;
+  return CombineChunkHashes(chunked_message, chunk_hashes, &next);
+}
+
 inline RepeatedPtrField<FieldIndex> GraphDefFieldTags() {
   // SavedModel.meta_graphs[0].graph_def
   FieldIndex meta_graph_field_tag;
@@ -395,7 +482,7 @@ absl::StatusOr<uint64_t> HashSavedObjectGraph(
 
 }  // namespace fingerprinting_utils_internal
 
-using fingerprinting_utils_internal::HashFields;
+using fingerprinting_utils_internal::HashChunks;
 using fingerprinting_utils_internal::HashGraphDef;
 using fingerprinting_utils_internal::HashSavedObjectGraph;
 using fingerprinting_utils_internal::HashSignatureDef;
@@ -437,10 +524,13 @@ absl::StatusOr<FingerprintDef> CreateFingerprintDefCpb(
   FingerprintDef fingerprint_def;
   SavedModel saved_model;
 
-  // Set the saved_model_checksum.
+  // Set the saved_model_checksum. It covers every chunk of the model, which
+  // are hashed in parallel.
+  thread::ThreadPool thread_pool(Env::Default(), "fingerprint_chunks",
+                                 port::MaxParallelism());
   TF_ASSIGN_OR_RETURN(uint64_t saved_model_hash,
-                      HashFields(chunk_metadata.message(), reader, chunks_info,
-                                 {}, &saved_model));
+                      HashChunks(chunk_metadata.message(), reader, chunks_info,
+                                 &thread_pool));
   saved_model_hash = FingerprintCat64(
       saved_model_hash, Fingerprint64(SerializeProto(saved_model)));
   fingerprint_def.set_saved_model_checksum(saved_model_hash);
@@ -26,6 +26,7 @@ limitations under the License.
 #include "riegeli/records/record_reader.h"  // from @riegeli
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/platform/protobuf.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/fingerprint.pb.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
@@ -71,6 +72,15 @@ absl::StatusOr<uint64_t> HashFields(
         field_tags,
     Message* merged_message);
 
+// Hashes all the chunks referenced by `chunked_message`. Returns the same
+// hash as HashFields with no `field_tags`, but hashes the chunks on
+// `thread_pool` if not null.
+absl::StatusOr<uint64_t> HashChunks(
+    const ::tensorflow::proto_splitter::ChunkedMessage& chunked_message,
+    riegeli::RecordReader<riegeli::FdReader<>>& reader,
+    const std::vector<::tensorflow::proto_splitter::ChunkInfo>& chunks_info,
+    thread::ThreadPool* thread_pool);
+
 // Gets the field tags for `graph_def`.::tensorflow
 inline RepeatedPtrField<::tensorflow::proto_splitter::FieldIndex>
 GraphDefFieldTags();
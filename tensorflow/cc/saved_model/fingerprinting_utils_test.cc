@@ -27,7 +27,9 @@ limitations under the License.
 #include "absl/strings/string_view.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/saved_object_graph.pb.h"
 #include "tensorflow/tools/proto_splitter/cc/util.h"
@@ -45,6 +47,7 @@ namespace tensorflow::saved_model::fingerprinting {
 namespace {
 
 using fingerprinting_utils_internal::fieldTagMatches;
+using fingerprinting_utils_internal::HashChunks;
 using fingerprinting_utils_internal::HashFields;
 using fingerprinting_utils_internal::HashGraphDef;
 using fingerprinting_utils_internal::HashSavedObjectGraph;
@@ -319,6 +322,31 @@ TEST(FingerprintingTest, TestHashFieldsV2) {
   ASSERT_EQ(many_fields_hash, 14850154939410192811U);
 }
 
+TEST(FingerprintingTest, TestHashChunks) {
+  std::string cpb_file = io::JoinPath(
+      TensorFlowSrcRoot(), "tools/proto_splitter/testdata", "many-field.cpb");
+  TF_ASSERT_OK_AND_ASSIGN(auto reader, GetRiegeliReader(cpb_file));
+
+  auto read_metadata = GetChunkMetadata(reader);
+  if (!read_metadata.ok()) {
+    reader.Close();
+    TF_ASSERT_OK(read_metadata.status());
+  }
+  ChunkMetadata chunk_metadata = read_metadata.value();
+
+  std::vector<ChunkInfo> chunks_info = std::vector<ChunkInfo>(
+      chunk_metadata.chunks().begin(), chunk_metadata.chunks().end());
+
+  // Same hash as TestHashFieldsV2, with and without a thread pool.
+  EXPECT_THAT(
+      HashChunks(chunk_metadata.message(), reader, chunks_info, nullptr),
+      IsOkAndHolds(14850154939410192811U));
+  thread::ThreadPool thread_pool(Env::Default(), "test", 4);
+  EXPECT_THAT(
+      HashChunks(chunk_metadata.message(), reader, chunks_info, &thread_pool),
+      IsOkAndHolds(14850154939410192811U));
+}
+
 TEST(FingerprintingTest, TestHashGraphDef) {
   std::string cpb_file =
       io::JoinPath(TensorFlowSrcRoot(), "tools/proto_splitter/testdata",
@@ -48,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/protobuf/saver.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
@@ -213,7 +214,6 @@ Status RunOnce(const RunOptions& run_options,
 // RunInitOp will return OK if the initialization op was run successfully.
 // An empty init_op_name indicates that there are no init ops to run.
 Status RunInitOp(const RunOptions& run_options, const string& export_dir,
-                 const MetaGraphDef& meta_graph_def,
                  const std::vector<AssetFileDef>& asset_file_defs,
                  Session* session, const string& init_op_name) {
   if (!init_op_name.empty()) {
@@ -268,6 +268,103 @@ Status RunRestore(const RunOptions& run_options, const string& export_dir,
                  nullptr /* outputs */, &run_metadata, session);
 }
 
+// Returns true if the restore op and the init op are run in a single
+// Session::Run, so that the init op (e.g. table initializers reading vocabulary
+// assets) runs concurrently with the restore of the variables instead of after
+// it. This is opt-in through TF_SAVED_MODEL_OVERLAP_RESTORE_AND_INIT, and only
+// done when the init op does not read the restored variables or tables.
+bool OverlapRestoreAndInitOp(const MetaGraphDef& meta_graph,
+                             const string& init_op_name) {
+  if (!meta_graph.has_saver_def() || init_op_name.empty()) return false;
+  bool overlap = false;
+  Status status = ReadBoolFromEnvVar("TF_SAVED_MODEL_OVERLAP_RESTORE_AND_INIT",
+                                     /*default_val=*/false, &overlap);
+  if (!status.ok()) {
+    LOG(ERROR) << "OverlapRestoreAndInitOp: " << status.message();
+    return false;
+  }
+  return overlap && !internal::InitOpReadsRestoredState(
+                        meta_graph.graph_def(),
+                        meta_graph.saver_def().restore_op_name(), init_op_name);
+}
+
+// Runs the restore op and the init op together (see OverlapRestoreAndInitOp).
+Status RunRestoreAndInitOp(const RunOptions& run_options,
+                           const string& export_dir,
+                           const SaverDef& saver_def,
+                           const std::vector<AssetFileDef>& asset_file_defs,
+                           Session* session, const string& init_op_name) {
+  const string variables_path = io::JoinPath(
+      export_dir, kSavedModelVariablesDirectory, kSavedModelVariablesFilename);
+  TF_ASSIGN_OR_RETURN(bool variables_index_exists,
+                      internal::FileExists(Env::Default(),
+                                           MetaFilename(variables_path)));
+  if (!variables_index_exists) {
+    TF_RETURN_IF_ERROR(RunRestore(run_options, export_dir,
+                                  saver_def.restore_op_name(),
+                                  saver_def.filename_tensor_name(),
+                                  asset_file_defs, session));
+    return RunInitOp(run_options, export_dir, asset_file_defs, session,
+                     init_op_name);
+  }
+  LOG(INFO) << "Restoring SavedModel bundle and running initialization op "
+               "concurrently on SavedModel bundle at path: "
+            << export_dir;
+  Tensor variables_path_tensor(DT_STRING, TensorShape({}));
+  variables_path_tensor.scalar<tstring>()() = variables_path;
+  std::vector<std::pair<string, Tensor>> inputs = {
+      {saver_def.filename_tensor_name(), variables_path_tensor}};
+  AddAssetsTensorsToInputs(export_dir, asset_file_defs, &inputs);
+  RunMetadata run_metadata;
+  return RunOnce(run_options, inputs, {},
+                 {saver_def.restore_op_name(), init_op_name},
+                 nullptr /* outputs */, &run_metadata, session);
+}
+
+// Restores the variables and runs the init op. `overlap_restore_and_init_op`
+// is computed by the caller, as the graph may no longer be in `meta_graph`.
+Status RestoreSessionInternal(const RunOptions& run_options,
+                              const MetaGraphDef& meta_graph,
+                              const string& export_dir,
+                              const string& init_op_name,
+                              bool overlap_restore_and_init_op,
+                              std::unique_ptr<Session>* session) {
+  std::vector<AssetFileDef> asset_file_defs;
+  TF_RETURN_IF_ERROR(internal::GetAssetFileDefs(meta_graph, &asset_file_defs));
+  if (overlap_restore_and_init_op) {
+    const uint64 start_microseconds = Env::Default()->NowMicros();
+    TF_RETURN_IF_ERROR(RunRestoreAndInitOp(run_options, export_dir,
+                                           meta_graph.saver_def(),
+                                           asset_file_defs, session->get(),
+                                           init_op_name));
+    load_latency_by_stage->GetCell(export_dir, "restore_and_init_graph")
+        ->Add(GetLatencyMicroseconds(start_microseconds));
+    return absl::OkStatus();
+  }
+
+  const uint64 read_start_microseconds = Env::Default()->NowMicros();
+  if (meta_graph.has_saver_def()) {
+    TF_RETURN_IF_ERROR(RunRestore(run_options, export_dir,
+                                  meta_graph.saver_def().restore_op_name(),
+                                  meta_graph.saver_def().filename_tensor_name(),
+                                  asset_file_defs, session->get()));
+  }
+  // Record walltime spent in restoring graph from disk, but postpone metric
+  // increments until graph init finishes.
+  const uint64 restore_graph_walltime =
+      GetLatencyMicroseconds(read_start_microseconds);
+
+  const uint64 graph_init_start_microseconds = Env::Default()->NowMicros();
+  TF_RETURN_IF_ERROR(RunInitOp(run_options, export_dir, asset_file_defs,
+                               session->get(), init_op_name));
+  load_latency_by_stage->GetCell(export_dir, "restore_graph")
+      ->Add(restore_graph_walltime);
+  // Record wall time spent in init op.
+  load_latency_by_stage->GetCell(export_dir, "init_graph")
+      ->Add(GetLatencyMicroseconds(graph_init_start_microseconds));
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 SavedModelBundleInterface::~SavedModelBundleInterface() = default;
@@ -431,12 +528,20 @@ Status LoadSavedModelInternal(const SessionOptions& session_options,
   MetaGraphDef meta_graph_def;
   TF_RETURN_IF_ERROR(
       ReadMetaGraphDefFromSavedModel(export_dir, tags, &meta_graph_def));
+  string init_op_name;
+  TF_RETURN_IF_ERROR(
+      internal::GetInitOp(export_dir, meta_graph_def, &init_op_name));
+  // Decided before the graph is moved into the session.
+  const bool overlap_restore_and_init_op =
+      OverlapRestoreAndInitOp(meta_graph_def, init_op_name);
   std::unique_ptr<Session> session;
   TF_RETURN_IF_ERROR(LoadGraphDefIntoSession(
       session_options, std::move(*meta_graph_def.mutable_graph_def()),
       &session));
-  TF_RETURN_IF_ERROR(
-      RestoreSession(run_options, meta_graph_def, export_dir, &session));
+  TF_RETURN_IF_ERROR(RestoreSessionInternal(run_options, meta_graph_def,
+                                            export_dir, init_op_name,
+                                            overlap_restore_and_init_op,
+                                            &session));
   *bundle = SavedModelBundleLite(
       std::make_unique<LiteSessionWrapper>(std::move(session)),
       std::move(*meta_graph_def.mutable_signature_def()));
@@ -490,32 +595,12 @@ Status LoadSavedModel(const SessionOptions& session_options,
 Status RestoreSession(const RunOptions& run_options,
                       const MetaGraphDef& meta_graph, const string& export_dir,
                       std::unique_ptr<Session>* session) {
-  const uint64 read_start_microseconds = Env::Default()->NowMicros();
-  std::vector<AssetFileDef> asset_file_defs;
-  TF_RETURN_IF_ERROR(internal::GetAssetFileDefs(meta_graph, &asset_file_defs));
-  if (meta_graph.has_saver_def()) {
-    TF_RETURN_IF_ERROR(RunRestore(run_options, export_dir,
-                                  meta_graph.saver_def().restore_op_name(),
-                                  meta_graph.saver_def().filename_tensor_name(),
-                                  asset_file_defs, session->get()));
-  }
-  // Record walltime spent in restoring graph from disk, but postpone metric
-  // increments until graph init finishes.
-  const uint64 restore_graph_walltime =
-      GetLatencyMicroseconds(read_start_microseconds);
-
-  const uint64 graph_init_start_microseconds = Env::Default()->NowMicros();
   string init_op_name;
   TF_RETURN_IF_ERROR(
       internal::GetInitOp(export_dir, meta_graph, &init_op_name));
-  TF_RETURN_IF_ERROR(RunInitOp(run_options, export_dir, meta_graph,
-                               asset_file_defs, session->get(), init_op_name));
-  load_latency_by_stage->GetCell(export_dir, "restore_graph")
-      ->Add(restore_graph_walltime);
-  // Record wall time spent in init op.
-  load_latency_by_stage->GetCell(export_dir, "init_graph")
-      ->Add(GetLatencyMicroseconds(graph_init_start_microseconds));
-  return absl::OkStatus();
+  return RestoreSessionInternal(
+      run_options, meta_graph, export_dir, init_op_name,
+      OverlapRestoreAndInitOp(meta_graph, init_op_name), session);
 }
 
 Status LoadSavedModel(const SessionOptions& session_options,
@@ -118,6 +118,11 @@ Status LoadMetagraphIntoSession(const SessionOptions& session_options,
 /// *bundle with a session and the requested MetaGraphDef, if found.
 ///
 /// NOTE: Prefer the overload that takes a SavedModelBundleLite* in new code.
+///
+/// NOTE: When several sessions in a process load the same variable values
+/// (e.g. several versions or replicas of one SavedModel), setting
+/// TF_SHARE_RESTORED_TENSORS=1 makes them share one copy of each value; see
+/// SharedTensorStore.
 Status LoadSavedModel(const SessionOptions& session_options,
                       const RunOptions& run_options, const string& export_dir,
                       const std::unordered_set<string>& tags,
@@ -17,7 +17,11 @@ limitations under the License.
 
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/strip.h"
 #include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/protobuf_internal.h"
@@ -91,5 +95,65 @@ Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
   return absl::OkStatus();
 }
 
+namespace {
+
+// Returns the node name of a tensor name ("node:1") or control input ("^node").
+StringPiece NodeName(StringPiece name) {
+  absl::ConsumePrefix(&name, "^");
+  return name.substr(0, name.rfind(':'));
+}
+
+// Returns the nodes `node_name` depends on (transitively, through data and
+// control inputs), including itself, or false if a node is not in the graph.
+bool GetTransitiveInputs(
+    const absl::flat_hash_map<StringPiece, const NodeDef*>& nodes,
+    StringPiece node_name, absl::flat_hash_set<StringPiece>* inputs) {
+  std::vector<StringPiece> stack = {node_name};
+  while (!stack.empty()) {
+    const StringPiece name = stack.back();
+    stack.pop_back();
+    if (!inputs->insert(name).second) continue;
+    const auto it = nodes.find(name);
+    if (it == nodes.end()) return false;
+    for (const string& input : it->second->input()) {
+      stack.push_back(NodeName(input));
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool InitOpReadsRestoredState(const GraphDef& graph_def,
+                              const string& restore_op_name,
+                              const string& init_op_name) {
+  absl::flat_hash_map<StringPiece, const NodeDef*> nodes;
+  for (const NodeDef& node : graph_def.node()) {
+    nodes[node.name()] = &node;
+  }
+  absl::flat_hash_set<StringPiece> restore_inputs;
+  absl::flat_hash_set<StringPiece> init_inputs;
+  if (!GetTransitiveInputs(nodes, NodeName(restore_op_name),
+                           &restore_inputs) ||
+      !GetTransitiveInputs(nodes, NodeName(init_op_name), &init_inputs)) {
+    return true;
+  }
+  for (StringPiece name : restore_inputs) {
+    const NodeDef& node = *nodes.at(name);
+    // The first input of these ops is the variable or table being restored.
+    if (node.op() != "Assign" && node.op() != "AssignVariableOp" &&
+        node.op() != "LookupTableImport" &&
+        node.op() != "LookupTableImportV2") {
+      continue;
+    }
+    if (node.input_size() == 0 ||
+        init_inputs.contains(NodeName(node.input(0))) ||
+        init_inputs.contains(name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace internal
 }  // namespace tensorflow
@@ -17,7 +17,9 @@ limitations under the License.
 #define TENSORFLOW_CC_SAVED_MODEL_LOADER_UTIL_H_
 
 #include <string>
+#include <vector>
 
+#include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 
@@ -33,6 +35,14 @@ Status GetInitOp(const string& export_dir, const MetaGraphDef& meta_graph_def,
 Status GetAssetFileDefs(const MetaGraphDef& meta_graph_def,
                         std::vector<AssetFileDef>* asset_file_defs);
 
+// Returns true if the init op may read state written by the restore op, i.e.
+// if one of the variables or tables assigned in the restore op is an input of
+// the init op (transitively). Returns true as well if either op is not in the
+// graph, so that the caller conservatively runs the ops one after the other.
+bool InitOpReadsRestoredState(const GraphDef& graph_def,
+                              const string& restore_op_name,
+                              const string& init_op_name);
+
 }  // namespace internal
 }  // namespace tensorflow
 
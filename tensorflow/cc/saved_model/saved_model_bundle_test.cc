@@ -250,6 +250,24 @@ TEST_F(LoaderTest, MainOpFormat) {
   CheckSavedModelBundle(export_dir, bundle);
 }
 
+TEST_F(LoaderTest, MainOpFormatOverlapRestoreAndInitOp) {
+  setenv("TF_SAVED_MODEL_OVERLAP_RESTORE_AND_INIT", "1", 1 /* overwrite */);
+  SavedModelBundle bundle;
+  SessionOptions session_options;
+  RunOptions run_options;
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataMainOp);
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  CheckSavedModelBundle(export_dir, bundle);
+
+  SavedModelBundleLite bundle_lite;
+  TF_ASSERT_OK(LoadSavedModel(session_options, run_options, export_dir,
+                              {kSavedModelTagServe}, &bundle_lite));
+  unsetenv("TF_SAVED_MODEL_OVERLAP_RESTORE_AND_INIT");
+}
+
 TEST_F(LoaderTest, InvalidExportPath) {
   SavedModelBundle bundle;
   RunOptions run_options;
@@ -23,6 +23,10 @@ limitations under the License.
 #include <sys/time.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -108,6 +112,45 @@ void DumpStatsToStdout(const Stats& stats) {
   }
 }
 
+// Parses `arg` of the form --<name>=<value> into `value`.  Returns false if
+// `arg` is not that flag, or its value is not a positive integer.
+static bool ParseInt64Flag(const char* arg, const char* name, int64_t* value) {
+  const size_t name_len = strlen(name);
+  if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, name_len) != 0 ||
+      arg[2 + name_len] != '=') {
+    return false;
+  }
+  const char* str = arg + 2 + name_len + 1;
+  char* end = nullptr;
+  errno = 0;
+  const long long parsed = strtoll(str, &end, 10);  // NOLINT
+  if (errno != 0 || end == str || *end != '\0' || parsed <= 0) {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+bool ParseFlags(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    int64_t num_threads = 0;
+    if (ParseInt64Flag(argv[i], "max_iters", &options->max_iters) ||
+        ParseInt64Flag(argv[i], "max_micros", &options->max_micros)) {
+      continue;
+    }
+    if (ParseInt64Flag(argv[i], "num_threads", &num_threads)) {
+      options->num_threads = static_cast<int>(num_threads);
+      continue;
+    }
+    fprintf(stderr,
+            "Invalid argument: %s\n"
+            "Usage: %s [--max_iters=N] [--max_micros=N] [--num_threads=N]\n",
+            argv[i], argv[0]);
+    return false;
+  }
+  return true;
+}
+
 void Benchmark(const Options& options, const BenchmarkFn& fn, Stats* stats) {
   // If neither max_seconds or max_iters is set, stop at kDefaultMicros.
   const int64_t max_us = (options.max_micros <= 0 && options.max_iters <= 0)
@@ -42,8 +42,16 @@ struct Options {
 
   int64_t max_iters = 0;   // Maximum iterations to run, ignored if <= 0.
   int64_t max_micros = 0;  // Maximum microseconds to run, ignored if <= 0.
+  // Number of threads of the Eigen thread pool the function runs the intra-op
+  // work of e.g. matrix multiplications and convolutions on.
+  int num_threads = 1;
 };
 
+// ParseFlags sets `options` from the flags --max_iters=N, --max_micros=N and
+// --num_threads=N in `argv`.  Returns false, after printing the usage to
+// stderr, if `argv` contains any other argument or an invalid value.
+bool ParseFlags(int argc, char** argv, Options* options);
+
 // Stats holds statistics collected during benchmarking.
 struct Stats {
   std::vector<int64_t> per_iter_us;  // Per-iteration deltas in us.
@@ -40,6 +40,26 @@ TEST(Benchmark, Benchmark) {
   EXPECT_EQ(stats5.per_iter_us.size(), 5);
 }
 
+TEST(Benchmark, ParseFlags) {
+  char arg0[] = "benchmark";
+  char arg1[] = "--max_iters=10";
+  char arg2[] = "--num_threads=4";
+  char* argv[] = {arg0, arg1, arg2};
+  Options options;
+  EXPECT_TRUE(ParseFlags(3, argv, &options));
+  EXPECT_EQ(options.max_iters, 10);
+  EXPECT_EQ(options.max_micros, 0);
+  EXPECT_EQ(options.num_threads, 4);
+
+  char invalid_value[] = "--num_threads=0";
+  char* invalid_value_argv[] = {arg0, invalid_value};
+  EXPECT_FALSE(ParseFlags(2, invalid_value_argv, &options));
+
+  char unknown_flag[] = "--max_iter=10";
+  char* unknown_flag_argv[] = {arg0, unknown_flag};
+  EXPECT_FALSE(ParseFlags(2, unknown_flag_argv, &options));
+}
+
 }  // namespace
 }  // namespace benchmark
 }  // namespace tfcompile
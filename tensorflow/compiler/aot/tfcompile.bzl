@@ -474,7 +474,9 @@ def tf_library(
                       gen_test=True.
       foo_benchmark: A cc_binary that runs a minimal-dependency benchmark,
                       useful for mobile devices or other platforms that can't
-                      compile the full test libraries. Only created if
+                      compile the full test libraries. Accepts
+                      --num_threads=N to run the intra-op work on N threads,
+                      and --max_iters=N or --max_micros=N. Only created if
                       gen_benchmark=True.
     The output header is called <name>.h.
 
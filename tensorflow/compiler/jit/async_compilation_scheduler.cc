@@ -0,0 +1,85 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/jit/async_compilation_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/jit/flags.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+
+AsyncCompilationScheduler::AsyncCompilationScheduler(
+    int64_t max_concurrent_compilations) {
+  const int64_t num_threads = std::max<int64_t>(max_concurrent_compilations, 1);
+  threads_.reserve(num_threads);
+  for (int64_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(Env::Default()->StartThread(
+        ThreadOptions(), absl::StrCat("async_compiler_thread_", i),
+        [this] { WorkerLoop(); }));
+  }
+}
+
+AsyncCompilationScheduler::~AsyncCompilationScheduler() {
+  {
+    mutex_lock lock(mu_);
+    shutting_down_ = true;
+    cond_var_.notify_all();
+  }
+  // Joins the threads.
+  threads_.clear();
+}
+
+AsyncCompilationScheduler* AsyncCompilationScheduler::Global() {
+  static AsyncCompilationScheduler* scheduler = new AsyncCompilationScheduler(
+      GetXlaOpsCommonFlags()->tf_xla_max_concurrent_async_compilations);
+  return scheduler;
+}
+
+void AsyncCompilationScheduler::Schedule(int64_t priority,
+                                         std::function<void()> compile) {
+  mutex_lock lock(mu_);
+  queue_.push({priority, next_sequence_number_++, std::move(compile)});
+  cond_var_.notify_one();
+}
+
+int64_t AsyncCompilationScheduler::num_queued() const {
+  mutex_lock lock(mu_);
+  return queue_.size();
+}
+
+void AsyncCompilationScheduler::WorkerLoop() {
+  while (true) {
+    std::function<void()> compile;
+    {
+      mutex_lock lock(mu_);
+      while (queue_.empty() && !shutting_down_) {
+        cond_var_.wait(lock);
+      }
+      if (queue_.empty()) return;
+      compile = queue_.top().compile;
+      queue_.pop();
+    }
+    compile();
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,88 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_JIT_ASYNC_COMPILATION_SCHEDULER_H_
+#define TENSORFLOW_COMPILER_JIT_ASYNC_COMPILATION_SCHEDULER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Runs asynchronous cluster compilations on a fixed number of threads. When
+// more compilations are queued than there are threads, the ones with the
+// highest priority run first, and compilations with the same priority run in
+// the order they were scheduled.
+//
+// A single scheduler is shared by all the DeviceCompilers of the process, so
+// that independent clusters are compiled in parallel, while the total number
+// of concurrent compilations stays bounded.
+class AsyncCompilationScheduler {
+ public:
+  // Starts `max_concurrent_compilations` threads.
+  explicit AsyncCompilationScheduler(int64_t max_concurrent_compilations);
+
+  // Waits for the running compilations to finish. Compilations that have not
+  // started yet are run before the threads exit.
+  ~AsyncCompilationScheduler();
+
+  // Returns the scheduler shared by the process, which runs up to
+  // `tf_xla_max_concurrent_async_compilations` compilations concurrently.
+  static AsyncCompilationScheduler* Global();
+
+  // Queues `compile` with the given `priority`, e.g. the number of times the
+  // cluster has been executed so far.
+  void Schedule(int64_t priority, std::function<void()> compile);
+
+  // Returns the number of compilations that have been scheduled but have not
+  // started yet.
+  int64_t num_queued() const;
+
+ private:
+  struct Compilation {
+    int64_t priority;
+    // Breaks ties between compilations with the same priority.
+    int64_t sequence_number;
+    std::function<void()> compile;
+
+    bool operator<(const Compilation& other) const {
+      if (priority != other.priority) return priority < other.priority;
+      return sequence_number > other.sequence_number;
+    }
+  };
+
+  void WorkerLoop();
+
+  mutable mutex mu_;
+  condition_variable cond_var_;
+  std::priority_queue<Compilation> queue_ TF_GUARDED_BY(mu_);
+  int64_t next_sequence_number_ TF_GUARDED_BY(mu_) = 0;
+  bool shutting_down_ TF_GUARDED_BY(mu_) = false;
+  std::vector<std::unique_ptr<Thread>> threads_;
+
+  AsyncCompilationScheduler(const AsyncCompilationScheduler&) = delete;
+  void operator=(const AsyncCompilationScheduler&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_JIT_ASYNC_COMPILATION_SCHEDULER_H_
@@ -0,0 +1,81 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/jit/async_compilation_scheduler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/synchronization/notification.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(AsyncCompilationSchedulerTest, RunsHighestPriorityFirst) {
+  mutex mu;
+  std::vector<int64_t> order;
+  absl::Notification started;
+  absl::Notification release;
+  {
+    AsyncCompilationScheduler scheduler(/*max_concurrent_compilations=*/1);
+    // Keeps the only thread busy while the other compilations are queued.
+    scheduler.Schedule(0, [&] {
+      started.Notify();
+      release.WaitForNotification();
+    });
+    started.WaitForNotification();
+    for (int64_t priority : {1, 5, 3, 5, 0}) {
+      scheduler.Schedule(priority, [&mu, &order, priority] {
+        mutex_lock lock(mu);
+        order.push_back(priority);
+      });
+    }
+    EXPECT_EQ(scheduler.num_queued(), 5);
+    release.Notify();
+  }
+  EXPECT_THAT(order, ElementsAre(5, 5, 3, 1, 0));
+}
+
+TEST(AsyncCompilationSchedulerTest, LimitsConcurrentCompilations) {
+  std::atomic<int64_t> num_running = 0;
+  std::atomic<int64_t> max_running = 0;
+  {
+    AsyncCompilationScheduler scheduler(/*max_concurrent_compilations=*/3);
+    for (int i = 0; i < 50; ++i) {
+      scheduler.Schedule(i, [&] {
+        const int64_t running = ++num_running;
+        int64_t max = max_running.load();
+        while (running > max &&
+               !max_running.compare_exchange_weak(max, running)) {
+        }
+        Env::Default()->SleepForMicroseconds(100);
+        --num_running;
+      });
+    }
+  }
+  EXPECT_EQ(num_running, 0);
+  EXPECT_GE(max_running, 1);
+  EXPECT_LE(max_running, 3);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,9 +15,17 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/build_xla_ops_pass.h"
 
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
 #include "absl/algorithm/container.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/types/span.h"
 #include "tensorflow/cc/framework/ops.h"
 #include "tensorflow/cc/framework/scope_internal.h"
 #include "tensorflow/cc/ops/array_ops.h"
@@ -25,6 +33,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/control_flow_ops.h"
 #include "tensorflow/cc/ops/functional_ops.h"
 #include "tensorflow/cc/ops/logging_ops.h"
+#include "tensorflow/cc/ops/math_ops.h"
 #include "tensorflow/compiler/jit/defs.h"
 #include "tensorflow/compiler/jit/device_util.h"
 #include "tensorflow/compiler/jit/encapsulate_subgraphs_pass.h"
@@ -378,14 +387,121 @@ absl::StatusOr<jit::DeviceId> InferDeviceForCluster(
   return result;
 }
 
+// Parses the increasing batch sizes in --tf_xla_batch_size_buckets.
+absl::StatusOr<std::vector<int32>> ParseBatchSizeBuckets(
+    absl::string_view buckets_str) {
+  std::vector<int32> buckets;
+  for (absl::string_view bucket_str :
+       absl::StrSplit(buckets_str, ',', absl::SkipEmpty())) {
+    int32 bucket;
+    if (!absl::SimpleAtoi(bucket_str, &bucket) || bucket <= 0 ||
+        (!buckets.empty() && bucket <= buckets.back())) {
+      return errors::InvalidArgument(
+          "--tf_xla_batch_size_buckets must be a comma-separated list of "
+          "increasing positive batch sizes, got: ",
+          buckets_str);
+    }
+    buckets.push_back(bucket);
+  }
+  return buckets;
+}
+
+// Returns the batch size of `batched_input` (its dimension 0) as a vector of
+// size 1.
+Output BatchSize(const Scope& s, Output batched_input) {
+  return ops::Slice(s.WithOpName("batch_size"),
+                    ops::Shape(s, batched_input, ops::Shape::OutType(DT_INT32)),
+                    {0}, {1});
+}
+
+// Pads `inputs` along dimension 0 from `batch_size` to the smallest of
+// `buckets` that holds it, if any.
+std::vector<Output> PadToBatchSizeBucket(const Scope& s,
+                                         absl::Span<const Output> inputs,
+                                         Output batch_size,
+                                         absl::Span<const int32> buckets) {
+  Tensor buckets_tensor(DT_INT32,
+                        TensorShape({static_cast<int64_t>(buckets.size())}));
+  absl::c_copy(buckets, buckets_tensor.flat<int32>().data());
+  Output buckets_const =
+      ops::Const(s.WithOpName("batch_size_buckets"), buckets_tensor);
+  Output no_bucket = ops::Const(s, std::numeric_limits<int32>::max());
+  Output bucket = ops::Min(
+      s, ops::SelectV2(s, ops::GreaterEqual(s, buckets_const, batch_size),
+                       buckets_const, no_bucket),
+      /*axis=*/0, ops::Min::KeepDims(true));
+  Output padded_batch_size =
+      ops::SelectV2(s.WithOpName("padded_batch_size"),
+                    ops::Equal(s, bucket, no_bucket), batch_size, bucket);
+  // The paddings of dimension 0, the other dimensions are not padded.
+  Output batch_paddings = ops::Reshape(
+      s,
+      ops::Concat(s, {ops::Const(s, {0}), ops::Sub(s, padded_batch_size,
+                                                   batch_size)},
+                  /*axis=*/0),
+      {1, 2});
+
+  std::vector<Output> padded_inputs;
+  padded_inputs.reserve(inputs.size());
+  int input_idx = 0;
+  for (const Output& input : inputs) {
+    Output other_paddings = ops::Fill(
+        s,
+        ops::Stack(s, {ops::Sub(s, ops::Rank(s, input), 1), ops::Const(s, 2)}),
+        0);
+    padded_inputs.push_back(ops::Pad(
+        s.WithOpName("pad_input_", input_idx), input,
+        ops::Concat(s, {batch_paddings, other_paddings}, /*axis=*/0)));
+    input_idx++;
+  }
+  return padded_inputs;
+}
+
+// Slices each output of `node` along dimension 0 back to `batch_size`, for the
+// outputs of a cluster whose inputs were padded by PadToBatchSizeBucket().
+void SliceOutgoingDataEdgesToBatchSize(const Scope& s, Node* node,
+                                       Output batch_size) {
+  if (!s.status().ok()) {
+    return;
+  }
+
+  std::vector<const Edge*> data_edges;
+  absl::c_copy_if(node->out_edges(), std::back_inserter(data_edges),
+                  [](const Edge* e) { return !e->IsControlEdge(); });
+
+  std::vector<Output> sliced_outputs(node->num_outputs(), Output(nullptr));
+  for (const Edge* e : data_edges) {
+    int oidx = e->src_output();
+    Output sliced_output = sliced_outputs[oidx];
+    if (sliced_output.node() == nullptr) {
+      Output output(node, oidx);
+      Output rank = ops::Reshape(s, ops::Rank(s, output), {1});
+      Output begin = ops::Fill(s, rank, 0);
+      Output size = ops::Concat(
+          s, {batch_size, ops::Fill(s, ops::Sub(s, rank, 1), -1)},
+          /*axis=*/0);
+      sliced_output = sliced_outputs[oidx] =
+          ops::Slice(s.WithOpName("slice_output_", oidx), output, begin, size);
+    }
+
+    Node* dst = e->dst();
+    int dst_idx = e->dst_input();
+
+    s.graph()->RemoveEdge(e);
+    s.graph()->AddEdge(sliced_output.node(), sliced_output.index(), dst,
+                       dst_idx);
+  }
+}
+
 std::vector<Output> GetXlaRunArgs(const Scope& s,
                                   const XlaClusterInfo& cluster_info,
+                                  absl::Span<const Output> non_constant_inputs,
                                   const DebuggingOpts& debugging_opts) {
   std::vector<Output> xla_run_args;
-  xla_run_args.reserve(cluster_info.non_constant_inputs.size() +
+  xla_run_args.reserve(non_constant_inputs.size() +
                        cluster_info.resource_inputs.size());
   int input_idx = 0;
-  for (const Output& o : cluster_info.non_constant_inputs) {
+  for (const Output& o : non_constant_inputs) {
     if (debugging_opts.check_input_numerics && DataTypeIsFloating(o.type())) {
       ops::CheckNumerics check_numerics_op(
           s.WithOpName("check_input_", input_idx), o,
@@ -468,7 +584,8 @@ Status ReplaceNodeWithXlaCompileAndXlaRun(
     jit::DeviceInfoCache* device_info_cache,
     const GraphOptimizationPassOptions& options,
     const FunctionLibraryDefinition& flib_def, bool lazy_compilation_enabled,
-    const DebuggingOpts& debugging_opts, Graph* g, Node* n) {
+    const DebuggingOpts& debugging_opts,
+    absl::Span<const int32> batch_size_buckets, Graph* g, Node* n) {
   XlaClusterInfo cluster_info;
   TF_RETURN_IF_ERROR(GetXlaClusterInfo(n, &cluster_info));
 
@@ -492,9 +609,19 @@ Status ReplaceNodeWithXlaCompileAndXlaRun(
                    .WithDevice(n->requested_device())
                    .WithAssignedDevice(device_name_str);
 
+  // With batch size buckets, the cluster is compiled and run with padded
+  // inputs, while the TF fallback runs with the original inputs.
+  std::vector<Output> non_constant_inputs = cluster_info.non_constant_inputs;
+  std::optional<Output> batch_size;
+  if (!batch_size_buckets.empty() && !non_constant_inputs.empty()) {
+    batch_size = BatchSize(root, non_constant_inputs[0]);
+    non_constant_inputs = PadToBatchSizeBucket(
+        root, non_constant_inputs, *batch_size, batch_size_buckets);
+  }
+
   ops::_XlaCompile xla_compile(root.WithOpName("xla_compile"),
                                /*constants=*/cluster_info.constant_inputs,
-                               /*args=*/cluster_info.non_constant_inputs,
+                               /*args=*/non_constant_inputs,
                                /*resources=*/cluster_info.resource_inputs,
                                /*must_compile=*/requires_compilation,
                                cluster_info.function);
@@ -507,7 +634,7 @@ Status ReplaceNodeWithXlaCompileAndXlaRun(
       CopyIncomingControlEdges(g, /*from=*/n, /*to=*/xla_compile.key.node()));
 
   std::vector<Output> xla_run_args =
-      GetXlaRunArgs(root, cluster_info, debugging_opts);
+      GetXlaRunArgs(root, cluster_info, non_constant_inputs, debugging_opts);
 
   if (requires_compilation) {
     // "Strict" compilation:  every _XlaCompile invocation must compile the
@@ -518,6 +645,11 @@ Status ReplaceNodeWithXlaCompileAndXlaRun(
     MoveOutgoingEdges(g, /*old_node=*/n,
                       /*new_node=*/xla_run.operation.node());
     g->RemoveNode(n);
+    if (batch_size.has_value()) {
+      SliceOutgoingDataEdgesToBatchSize(root, xla_run.operation.node(),
+                                        *batch_size);
+      TF_RETURN_IF_ERROR(root.status());
+    }
   } else {
     // "Lazy" compilation: an _XlaCompile invocation may decide not to compile
     // the cluster based on profitability heuristics.
@@ -545,6 +677,10 @@ Status ReplaceNodeWithXlaCompileAndXlaRun(
     MergeOutgoingDataEdges(root, /*old_node=*/n,
                            /*new_node=*/xla_run.operation.node(),
                            cluster_info.function.name(), debugging_opts);
+    if (batch_size.has_value()) {
+      SliceOutgoingDataEdgesToBatchSize(root, xla_run.operation.node(),
+                                        *batch_size);
+    }
 
     TF_RETURN_IF_ERROR(root.status());
 
@@ -605,10 +741,14 @@ Status BuildXlaOpsPass::Run(const GraphOptimizationPassOptions& options) {
   VLOG(1) << "check_input_numerics = " << debugging_opts.check_input_numerics;
   VLOG(1) << "check_output_numerics = " << debugging_opts.check_output_numerics;
 
+  TF_ASSIGN_OR_RETURN(std::vector<int32> batch_size_buckets,
+                      ParseBatchSizeBuckets(flags.tf_xla_batch_size_buckets));
+
   for (Node* n : xla_compiled_kernels) {
     TF_RETURN_IF_ERROR(ReplaceNodeWithXlaCompileAndXlaRun(
         &device_info_cache, options, *options.flib_def,
-        lazy_compilation_enabled, debugging_opts, graph, n));
+        lazy_compilation_enabled, debugging_opts, batch_size_buckets, graph,
+        n));
   }
 
   if (VLOG_IS_ON(1)) {
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/compiler/jit/defs.h"
 #include "tensorflow/compiler/jit/encapsulate_subgraphs_pass.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/node_matchers.h"
 #include "tensorflow/compiler/jit/test_util.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
@@ -257,6 +258,63 @@ TEST_F(BuildXlaOpsTest, NoExtraMergeForEdgeToSink) {
                                 NodeWith(Op("NoOp")))));
 }
 
+TEST_F(BuildXlaOpsTest, PadsInputsToBatchSizeBuckets) {
+  Scope root = Scope::NewRootScope().ExitOnError();
+
+  FunctionDefLibrary fdef_lib;
+  *fdef_lib.add_function() = FunctionDefHelper::Create(
+      /*function_name=*/"cluster_0", /*in_def=*/{"in: float"},
+      /*out_def=*/{"out: float"},
+      /*attr_def=*/{}, /*node_def=*/{{{"out"}, "Identity", {"in"}}},
+      /*ret_def=*/{{"out", "out:output:0"}});
+  TF_ASSERT_OK(root.graph()->AddFunctionLibrary(fdef_lib));
+  Node* call;
+  TF_ASSERT_OK(MakeXlaCompiledKernel(root.graph(), "cluster_0", "C", &call));
+  call->AddAttr(kXlaHasReferenceVarsAttr, false);
+  auto input = ops::Placeholder(root.WithOpName("input"), DT_FLOAT);
+  root.graph()->AddEdge(input.node(), 0, call, 0);
+  TF_ASSERT_OK(root.DoShapeInference(call));
+  auto output = ops::Identity(root.WithOpName("output"), Output(call));
+
+  GetBuildXlaOpsPassFlags()->tf_xla_batch_size_buckets = "8,32";
+  std::unique_ptr<Graph> graph;
+  Status status = BuildXlaOps(root, fdef_lib, &graph);
+  GetBuildXlaOpsPassFlags()->tf_xla_batch_size_buckets = "";
+  TF_ASSERT_OK(status);
+
+  auto pad = NodeWith(Op("Pad"), Inputs(Out(NodeWith(Op("Placeholder"))), _));
+  auto xla_compile = NodeWith(Op("_XlaCompile"), Inputs(Out(pad)));
+  auto xla_run = NodeWith(Op("_XlaRun"), Inputs(Out(pad), _));
+  auto slice = NodeWith(Op("Slice"), Inputs(Out(xla_run), _, _));
+  auto merge = NodeWith(Op("_XlaMerge"),
+                        Inputs(Out(NodeWith(Op("StatefulPartitionedCall"),
+                                            Inputs(Out(NodeWith(
+                                                Op("Placeholder")))))),
+                               Out(slice)));
+
+  Node* output_new = FindNodeByName(graph.get(), "output");
+  ASSERT_NE(output_new, nullptr);
+  EXPECT_THAT(output_new, NodeWith(Inputs(Out(merge))));
+  EXPECT_THAT(FindNodeByName(graph.get(), "C/xla_compile"), xla_compile);
+}
+
+TEST_F(BuildXlaOpsTest, InvalidBatchSizeBuckets) {
+  Scope root = Scope::NewRootScope().ExitOnError();
+
+  FunctionDefLibrary fdef_lib =
+      CreateFunctionDefLibWithConstFunction("cluster_0");
+  TF_ASSERT_OK(root.graph()->AddFunctionLibrary(fdef_lib));
+  Node* call;
+  TF_ASSERT_OK(MakeXlaCompiledKernel(root.graph(), "cluster_0", "C", &call));
+  call->AddAttr(kXlaHasReferenceVarsAttr, false);
+
+  GetBuildXlaOpsPassFlags()->tf_xla_batch_size_buckets = "32,8";
+  std::unique_ptr<Graph> graph;
+  Status status = BuildXlaOps(root, fdef_lib, &graph);
+  GetBuildXlaOpsPassFlags()->tf_xla_batch_size_buckets = "";
+  EXPECT_EQ(status.code(), error::INVALID_ARGUMENT);
+}
+
 #ifdef GOOGLE_CUDA
 FunctionDefLibrary CreateFunctionDefLibWithInt32Input(const string& name) {
   FunctionDefLibrary fdef_lib;
@@ -28,6 +28,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "tensorflow/compiler/jit/async_compilation_scheduler.h"
 #include "tensorflow/compiler/jit/device_compilation_cache.h"
 #include "tensorflow/compiler/jit/device_compilation_cluster_signature.h"
 #include "tensorflow/compiler/jit/device_compilation_profiler.h"
@@ -40,7 +41,6 @@ limitations under the License.
 #include "xla/client/local_client.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
-#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/thread_annotations.h"
 
@@ -166,8 +166,16 @@ class DeviceCompiler : public ResourceBase {
       compiler_client_;
   std::unique_ptr<DeviceCompilationCache<ExecutableType>> cache_;
 
-  // Pool of threads for asynchronous compilations.
-  std::unique_ptr<thread::ThreadPool> async_compiler_threads_;
+  // Runs the asynchronous compilations, shared with the other DeviceCompilers
+  // of the process.
+  AsyncCompilationScheduler* async_compilation_scheduler_;
+
+  mutex async_compilations_mu_;
+  condition_variable async_compilations_done_;
+  // Number of asynchronous compilations scheduled by this DeviceCompiler that
+  // have not finished yet.
+  int64_t num_pending_async_compilations_
+      TF_GUARDED_BY(async_compilations_mu_) = 0;
 
   mutex cluster_mutexes_mu_;
   absl::flat_hash_map<DeviceCompilationClusterSignature, std::unique_ptr<mutex>,
@@ -212,11 +220,9 @@ DeviceCompiler<ExecutableType, ClientType>::DeviceCompiler(
     std::unique_ptr<DeviceCompilerClient<ExecutableType, ClientType>>
         compiler_client)
     : persistor_(std::move(persistor)),
-      compiler_client_(std::move(compiler_client)) {
+      compiler_client_(std::move(compiler_client)),
+      async_compilation_scheduler_(AsyncCompilationScheduler::Global()) {
   cache_ = std::make_unique<DeviceCompilationCache<ExecutableType>>();
-  async_compiler_threads_ = std::make_unique<tensorflow::thread::ThreadPool>(
-      tensorflow::Env::Default(), "async_compiler_threads",
-      kNumAsyncDeviceCompilerThreads);
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -224,12 +230,14 @@ DeviceCompiler<ExecutableType, ClientType>::~DeviceCompiler() {
   // Since programs are owned by the cache, ensure any use of our programs have
   // completed by waiting for all stream executors to complete.
   compiler_client_->WaitForProgramsToFinish();
-  // Wait for all outstanding compilations to finish.
-  // Resetting the pointer explicitly in the top level destructor.
-  // Without this, the pointer would be reset when the AsyncCompilationState
-  // is destructed, which is dependent on the order of the members in the
-  // DeviceCompiler class, which is error prone if the order changes.
-  async_compiler_threads_.reset();
+  // Wait for all outstanding compilations to finish, including the ones still
+  // queued in the shared scheduler, since they use the members of this class.
+  {
+    mutex_lock lock(async_compilations_mu_);
+    while (num_pending_async_compilations_ > 0) {
+      async_compilations_done_.wait(lock);
+    }
+  }
   // TODO(b/110813685): Think about the program ownership model. Programs are
   // currently owned by the compilation cache which means we must wait for
   // program completion in the destructor. There are multiple compilation caches
@@ -365,14 +373,24 @@ Status DeviceCompiler<ExecutableType, ClientType>::CompileAsynchronous(
   // Don't move the above code into the thread function as it synchronously
   // updates the async compilation state!
 
-  // When the ThreadPool for the compilation cache is destroyed, it waits for
-  // compilations to have finished. This means that both 'entry' and 'this' will
-  // be alive for the duration of the compilation.
+  // The destructor waits for the compilations scheduled by this DeviceCompiler
+  // to have finished. This means that both 'entry' and 'this' will be alive for
+  // the duration of the compilation.
   // !!Pay attention when additional variables must be captured by this lambda!!
   // All values are captured by value. Make sure that all pointer values (like
   // entry) do not get freed until the lambda has finished.
   const std::string& function_name = function.name();
-  async_compiler_threads_->Schedule([=] {
+  // Clusters that have been executed more often are expected to benefit more
+  // from being compiled, so they are compiled first.
+  int64_t priority = 0;
+  if (auto stats = profiler->GetCompileStats(function); stats.ok()) {
+    priority = stats->execution_count;
+  }
+  {
+    mutex_lock lock(async_compilations_mu_);
+    ++num_pending_async_compilations_;
+  }
+  async_compilation_scheduler_->Schedule(priority, [=] {
     VLOG(2) << "Starting asynchronous compilation of cluster " << function_name
             << '.';
     // We don't need to lock mu, but do it anyway to satisfy thread safety
@@ -390,6 +408,10 @@ Status DeviceCompiler<ExecutableType, ClientType>::CompileAsynchronous(
       cache_->Store(signature, std::nullopt, s.status(), std::nullopt,
                     std::nullopt);
     }
+    mutex_lock async_lock(async_compilations_mu_);
+    if (--num_pending_async_compilations_ == 0) {
+      async_compilations_done_.notify_all();
+    }
   });
   return absl::OkStatus();
 }
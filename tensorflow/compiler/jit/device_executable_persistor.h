@@ -46,7 +46,9 @@ std::string XlaSerializedCacheKeyToFileName(const XlaSerializedCacheKey& key);
 
 // Offers a way to persist and/or load compiled `ExecutableType`s along with the
 // corresponding HLO (`CompilationResult`) to/from `persistent_cache_directory`
-// (if one was provided during construction) on disk  using `ClientType`.
+// (if one was provided during construction) on disk  using `ClientType`, and
+// to/from `shared_persistent_cache_directory`, e.g. on a remote file system
+// shared by a fleet of processes that compile the same clusters.
 template <typename ExecutableType, typename ClientType>
 class DeviceExecutablePersistor {
  public:
@@ -83,6 +85,12 @@ class DeviceExecutablePersistor {
 
     // Cache is read-only if set to true.
     bool persistent_cache_directory_read_only = false;
+
+    // If non-empty, JIT-compiled executables are also saved to the specified
+    // file system directory path, and loaded from it if they are not found in
+    // `persistent_cache_directory`. They are then copied to
+    // `persistent_cache_directory`, unless the cache is read-only.
+    std::string shared_persistent_cache_directory;
   };
 
   DeviceExecutablePersistor(const Config& config,
@@ -90,9 +98,9 @@ class DeviceExecutablePersistor {
   virtual ~DeviceExecutablePersistor() = default;
 
   // Returns std::nullopt if persistence is not enabled (i.e.
-  // `persistent_cache_directory_` is empty) or if the serialized entry is not
-  // found on disk. Otherwise, loads and returns the serialized executable
-  // (or returns a status).
+  // `persistent_cache_directory_` and `shared_persistent_cache_directory_` are
+  // empty) or if the serialized entry is not found on disk. Otherwise, loads
+  // and returns the serialized executable (or returns a status).
   // TODO(b/255826209): Take in Signature instead of hash and string once cache
   // is refactored.
   std::optional<StatusOr<std::unique_ptr<ExecutableType>>> TryToLoadExecutable(
@@ -136,22 +144,25 @@ class DeviceExecutablePersistor {
       const ExecutableType& executable,
       DeviceCompilerClient<ExecutableType, ClientType>* compiler_client) const;
 
-  // Saves the cache entry in the file directory supplied during the
-  // construction of this class. Overwrites existing entries.
-  Status SaveSerializedEntry(const XlaSerializedCacheEntry& entry) const;
+  // Saves the cache entry in `directory`, one of the file directories supplied
+  // during the construction of this class. Overwrites existing entries.
+  Status SaveSerializedEntry(const std::string& directory,
+                             const XlaSerializedCacheEntry& entry) const;
 
-  // Tries to read a cache entry given a `key` by searching the file directory
-  // supplied during the construction of this class. Returns std::nullopt if no
-  // cache entry is found.
+  // Tries to read a cache entry given a `key` by searching `directory`, one of
+  // the file directories supplied during the construction of this class.
+  // Returns std::nullopt if no cache entry is found.
   absl::StatusOr<std::optional<XlaSerializedCacheEntry>>
-  TryToReadSerializedEntry(const XlaSerializedCacheKey& key) const;
+  TryToReadSerializedEntry(const std::string& directory,
+                           const XlaSerializedCacheKey& key) const;
 
   // Checks if the loaded `entry` matches the expected `key` and `hlo_module`.
   Status VerifyLoadedCacheEntry(const XlaSerializedCacheKey& key,
                                 const xla::HloModuleProto& hlo_module,
                                 const XlaSerializedCacheEntry& entry) const;
 
-  std::string GetFilePath(const XlaSerializedCacheKey& key) const;
+  std::string GetFilePath(const std::string& directory,
+                          const XlaSerializedCacheKey& key) const;
 
   const DeviceType device_type_;
   const bool disable_strict_signature_checks_;
@@ -164,6 +175,10 @@ class DeviceExecutablePersistor {
   // Cache is read-only if set to true.
   const bool persistent_cache_directory_read_only_;
 
+  // If non-empty, JIT-compiled executables are also saved to and loaded from
+  // the specified file system directory path, shared with other processes.
+  const std::string shared_persistent_cache_directory_;
+
   DeviceExecutablePersistor(const DeviceExecutablePersistor&) = delete;
   void operator=(const DeviceExecutablePersistor&) = delete;
 };
@@ -177,13 +192,15 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::
       persistence_prefix_(config.persistence_prefix),
       persistent_cache_directory_(config.persistent_cache_directory),
       persistent_cache_directory_read_only_(
-          config.persistent_cache_directory_read_only) {}
+          config.persistent_cache_directory_read_only),
+      shared_persistent_cache_directory_(
+          config.shared_persistent_cache_directory) {}
 
 template <typename ExecutableType, typename ClientType>
 std::string DeviceExecutablePersistor<ExecutableType, ClientType>::GetFilePath(
-    const XlaSerializedCacheKey& key) const {
+    const std::string& directory, const XlaSerializedCacheKey& key) const {
   const std::string file_name = XlaSerializedCacheKeyToFileName(key);
-  return io::JoinPath(persistent_cache_directory_, file_name);
+  return io::JoinPath(directory, file_name);
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -220,9 +237,9 @@ DeviceExecutablePersistor<xla::PjRtLoadedExecutable, xla::PjRtClient>::
 template <typename ExecutableType, typename ClientType>
 absl::StatusOr<std::optional<XlaSerializedCacheEntry>>
 DeviceExecutablePersistor<ExecutableType, ClientType>::TryToReadSerializedEntry(
-    const XlaSerializedCacheKey& key) const {
+    const std::string& directory, const XlaSerializedCacheKey& key) const {
   Env* env = Env::Default();
-  const std::string file_path = GetFilePath(key);
+  const std::string file_path = GetFilePath(directory, key);
   if (!env->FileExists(file_path).ok()) {
     return absl::StatusOr<std::optional<XlaSerializedCacheEntry>>(std::nullopt);
   }
@@ -269,21 +286,19 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::VerifyLoadedCacheEntry(
 template <typename ExecutableType, typename ClientType>
 Status
 DeviceExecutablePersistor<ExecutableType, ClientType>::SaveSerializedEntry(
-    const XlaSerializedCacheEntry& entry) const {
+    const std::string& directory, const XlaSerializedCacheEntry& entry) const {
   Env* env = Env::Default();
-  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(persistent_cache_directory_));
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(directory));
 
   // The cache on the filesystem can be read while we're writing out the proto.
   // To prevent reads of partially-written files, we write the proto to a temp
   // file, then move it into place once we're done writing.  And we warn the
   // user if these moves are not known to be atomic.
   bool has_atomic_move = false;
-  env->HasAtomicMove(persistent_cache_directory_, &has_atomic_move)
-      .IgnoreError();
+  env->HasAtomicMove(directory, &has_atomic_move).IgnoreError();
   if (!has_atomic_move) {
     LOG_EVERY_POW_2(WARNING)
-        << "Filesystem for XLA persistent cache at "
-        << persistent_cache_directory_
+        << "Filesystem for XLA persistent cache at " << directory
         << " does not support atomic moves.  Therefore the persistent cache is "
            "racy if you have multiple XLA compilations occurring "
            "simultaneously!  You have been warned. :)";
@@ -291,15 +306,13 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::SaveSerializedEntry(
 
   // Write to temp location, then when that completes, atomically move into the
   // final location.
-  std::string temp_path =
-      io::JoinPath(persistent_cache_directory_,
-                   XlaSerializedCacheKeyToFileName(entry.key()));
+  std::string temp_path = GetFilePath(directory, entry.key());
   if (!env->CreateUniqueFileName(&temp_path, ".tmp")) {
-    return absl::UnavailableError(absl::StrCat(
-        "Could not create a unique file inside ", persistent_cache_directory_));
+    return absl::UnavailableError(
+        absl::StrCat("Could not create a unique file inside ", directory));
   }
   TF_RETURN_IF_ERROR(WriteBinaryProto(env, temp_path, entry));
-  return env->RenameFile(temp_path, GetFilePath(entry.key()));
+  return env->RenameFile(temp_path, GetFilePath(directory, entry.key()));
 }
 
 template <typename ExecutableType, typename ClientType>
@@ -344,7 +357,8 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToLoadExecutable(
     const XlaCompiler::Options& options,
     const XlaCompiler::CompilationResult& compilation_result,
     DeviceCompilerClient<ExecutableType, ClientType>* compiler_client) const {
-  if (persistent_cache_directory_.empty()) {
+  if (persistent_cache_directory_.empty() &&
+      shared_persistent_cache_directory_.empty()) {
     return std::nullopt;
   }
 
@@ -355,10 +369,22 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToLoadExecutable(
       BuildSerializedCacheKey(signature_hash, hlo_module);
 
   std::optional<XlaSerializedCacheEntry> serialized_entry;
+  bool loaded_from_shared_cache = false;
   {
     XLA_SCOPED_LOGGING_TIMER(
         absl::StrCat("Try loading serialized cache entry:", signature_str));
-    TF_ASSIGN_OR_RETURN(serialized_entry, TryToReadSerializedEntry(cache_key));
+    if (!persistent_cache_directory_.empty()) {
+      TF_ASSIGN_OR_RETURN(
+          serialized_entry,
+          TryToReadSerializedEntry(persistent_cache_directory_, cache_key));
+    }
+    if (!serialized_entry.has_value() &&
+        !shared_persistent_cache_directory_.empty()) {
+      TF_ASSIGN_OR_RETURN(serialized_entry,
+                          TryToReadSerializedEntry(
+                              shared_persistent_cache_directory_, cache_key));
+      loaded_from_shared_cache = serialized_entry.has_value();
+    }
   }
 
   if (!serialized_entry.has_value()) {
@@ -368,6 +394,17 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToLoadExecutable(
   TF_RETURN_IF_ERROR(
       VerifyLoadedCacheEntry(cache_key, hlo_module, *serialized_entry));
 
+  if (loaded_from_shared_cache && !persistent_cache_directory_.empty() &&
+      !persistent_cache_directory_read_only_) {
+    // The next lookups do not need to go to the shared cache.
+    Status status =
+        SaveSerializedEntry(persistent_cache_directory_, *serialized_entry);
+    if (!status.ok()) {
+      LOG(WARNING) << "Could not copy the XLA cache entry for " << signature_str
+                   << " from the shared cache: " << status;
+    }
+  }
+
   VLOG(1) << "Loading cached entry for: " << signature_str;
   return compiler_client->LoadExecutable(options, compilation_result,
                                          serialized_entry->executable());
@@ -381,7 +418,8 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToPersistExecutable(
     const XlaCompiler::CompilationResult& compilation_result,
     const ExecutableType& executable,
     DeviceCompilerClient<ExecutableType, ClientType>* client) const {
-  if (persistent_cache_directory_.empty() ||
+  if ((persistent_cache_directory_.empty() &&
+       shared_persistent_cache_directory_.empty()) ||
       persistent_cache_directory_read_only_) {
     VLOG(1) << "Not persisting executable. No `persistent_cache_directory` "
                "provided or cache is read-only.";
@@ -393,7 +431,14 @@ DeviceExecutablePersistor<ExecutableType, ClientType>::TryToPersistExecutable(
   TF_ASSIGN_OR_RETURN(XlaSerializedCacheEntry serialized_entry,
                       SerializeEntry(signature_hash, options,
                                      compilation_result, executable, client));
-  TF_RETURN_IF_ERROR(SaveSerializedEntry(std::move(serialized_entry)));
+  if (!persistent_cache_directory_.empty()) {
+    TF_RETURN_IF_ERROR(
+        SaveSerializedEntry(persistent_cache_directory_, serialized_entry));
+  }
+  if (!shared_persistent_cache_directory_.empty()) {
+    TF_RETURN_IF_ERROR(SaveSerializedEntry(shared_persistent_cache_directory_,
+                                           serialized_entry));
+  }
   VLOG(2) << "XlaSerializedCacheEntry saved for signature: [" << signature_str
           << "] with signature hash: " << signature_hash;
   return absl::OkStatus();
@@ -38,6 +38,7 @@ limitations under the License.
 #include "xla/pjrt/tfrt_cpu_pjrt_client.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/tfrt/common/create_pjrt_client_util.h"
@@ -631,5 +632,48 @@ TEST_F(DeviceExecutionPersistorTest, PersistPjRtAndXlaExecutables) {
   EXPECT_EQ(entry.executable(), serialized_xla_executable_);
 }
 
+TEST_F(DeviceExecutionPersistorTest, LoadFromSharedCache) {
+  const std::string local_cache_dir = io::JoinPath(cache_dir_, "local");
+  const std::string shared_cache_dir = io::JoinPath(cache_dir_, "shared");
+
+  // Persist the executable to the shared cache only.
+  XlaDeviceExecutablePersistor::Config shared_config;
+  shared_config.persistence_prefix = "xla";
+  shared_config.shared_persistent_cache_directory = shared_cache_dir;
+  XlaDeviceExecutablePersistor shared_persistor(
+      shared_config, DefaultXlaOptions().device_type);
+  MockXlaCompilerClient mock_client;
+  EXPECT_CALL(mock_client, SerializeExecutable(_))
+      .WillOnce(Return(serialized_xla_executable_));
+  TF_ASSERT_OK_AND_ASSIGN(auto executable, BuildSampleExecutable());
+  TF_ASSERT_OK(shared_persistor.TryToPersistExecutable(
+      /*signature_hash=*/123, "signature_string", DefaultXlaOptions(),
+      compilation_result_add_, *executable, &mock_client));
+
+  // A persistor with an empty local cache loads it from the shared cache, and
+  // copies it to the local cache.
+  XlaDeviceExecutablePersistor::Config config = shared_config;
+  config.persistent_cache_directory = local_cache_dir;
+  XlaDeviceExecutablePersistor persistor(config,
+                                         DefaultXlaOptions().device_type);
+  auto key =
+      CreateCacheKey(/*signature_hash=*/123, compilation_result_add_,
+                     persistor.device_type(), persistor.persistence_prefix());
+  EXPECT_FALSE(ReadCacheEntryFromFile(key, local_cache_dir).ok());
+
+  TF_ASSERT_OK_AND_ASSIGN(executable, BuildSampleExecutable());
+  EXPECT_CALL(mock_client, LoadExecutable(_, _, serialized_xla_executable_))
+      .WillOnce(Return(ByMove(std::move(executable))));
+  auto loaded_executable = persistor.TryToLoadExecutable(
+      /*signature_hash=*/123, "signature_string", DefaultXlaOptions(),
+      compilation_result_add_, &mock_client);
+  ASSERT_TRUE(loaded_executable.has_value());
+  TF_EXPECT_OK(loaded_executable->status());
+
+  TF_ASSERT_OK_AND_ASSIGN(auto entry,
+                          ReadCacheEntryFromFile(key, local_cache_dir));
+  EXPECT_EQ(entry.executable(), serialized_xla_executable_);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -155,10 +155,22 @@ void AppendMarkForCompilationPassFlagsInternal(std::vector<Flag>* flag_list) {
            &mark_for_compilation_flags->tf_xla_deterministic_cluster_names,
            "Causes the function names assigned by auto clustering to be "
            "deterministic from run to run."),
+      Flag("tf_xla_cost_model_clustering",
+           &mark_for_compilation_flags->tf_xla_cost_model_clustering,
+           "If true, auto clustering estimates the cost of each cluster with "
+           "and without XLA from the statically known shapes, and does not "
+           "compile the clusters predicted to be slower with XLA."),
       Flag("tf_xla_persistent_cache_directory",
            &mark_for_compilation_flags->tf_xla_persistent_cache_directory,
            "If non-empty, JIT-compiled executables are saved to and loaded "
            "from the specified file system directory path. Empty by default."),
+      Flag("tf_xla_shared_persistent_cache_directory",
+           &mark_for_compilation_flags
+                ->tf_xla_shared_persistent_cache_directory,
+           "If non-empty, JIT-compiled executables are also saved to and "
+           "loaded from this directory, shared by many processes (e.g. on a "
+           "remote file system). Executables loaded from it are copied to "
+           "--tf_xla_persistent_cache_directory. Empty by default."),
       Flag("tf_xla_persistent_cache_device_types",
            &mark_for_compilation_flags->tf_xla_persistent_cache_device_types,
            "If non-empty, the persistent cache will only be used for the "
@@ -222,6 +234,7 @@ void AllocateAndParseFlags() {
   build_ops_flags->tf_xla_disable_constant_folding = false;
   build_ops_flags->tf_xla_disable_full_embedding_pipelining = false;
   build_ops_flags->tf_xla_embedding_parallel_iterations = 0;
+  build_ops_flags->tf_xla_batch_size_buckets = "";
 
   mark_for_compilation_flags = new MarkForCompilationPassFlags;
   mark_for_compilation_flags->xla_auto_jit_flag.optimization_level_single_gpu =
@@ -239,7 +252,9 @@ void AllocateAndParseFlags() {
   mark_for_compilation_flags
       ->tf_xla_disable_resource_variable_safety_checks_for_debugging = false;
   mark_for_compilation_flags->tf_xla_deterministic_cluster_names = false;
+  mark_for_compilation_flags->tf_xla_cost_model_clustering = false;
   mark_for_compilation_flags->tf_xla_persistent_cache_directory = "";
+  mark_for_compilation_flags->tf_xla_shared_persistent_cache_directory = "";
   mark_for_compilation_flags->tf_xla_persistent_cache_device_types = "";
   mark_for_compilation_flags->tf_xla_persistent_cache_read_only = false;
   mark_for_compilation_flags->tf_xla_disable_strict_signature_checks = false;
@@ -263,6 +278,7 @@ void AllocateAndParseFlags() {
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
   ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_max_concurrent_async_compilations = 10;
   ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_on_demand_ = true;
   ops_flags->tf_xla_use_device_api.enabled_for_compile_and_run_ = true;
@@ -317,6 +333,13 @@ void AllocateAndParseFlags() {
             "If >0 then use this many parallel iterations in "
             "embedding_pipelining and embedding_sequency. By default, use the "
             "parallel_iterations on the original model WhileOp."),
+       Flag("tf_xla_batch_size_buckets",
+            &build_ops_flags->tf_xla_batch_size_buckets,
+            "Comma-separated, increasing batch sizes. If not empty then the "
+            "inputs of XLA clusters are padded along dimension 0 to the "
+            "smallest bucket that holds the batch, and the outputs are sliced "
+            "back. Only correct if the clusters compute the examples of "
+            "batch-major inputs and outputs independently."),
 
        Flag("tf_xla_compile_on_demand", &device_flags->tf_xla_compile_on_demand,
             "Switch a device into 'on-demand' mode, where instead of "
@@ -334,6 +357,11 @@ void AllocateAndParseFlags() {
             "When lazy compilation is enabled, asynchronous compilation starts "
             "the cluster compilation in the background, and the fallback path "
             "is executed until the compilation has finished."),
+       Flag("tf_xla_max_concurrent_async_compilations",
+            &ops_flags->tf_xla_max_concurrent_async_compilations,
+            "Maximum number of asynchronous cluster compilations running "
+            "concurrently in the process. When more clusters are waiting to "
+            "be compiled, the most executed ones are compiled first."),
        Flag("tf_xla_use_device_api_for_xla_launch",
             &ops_flags->tf_xla_use_device_api.enabled_for_xla_launch_,
             "If true, uses Device API (PjRt) for single device compilation and "
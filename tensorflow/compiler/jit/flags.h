@@ -93,10 +93,20 @@ struct MarkForCompilationPassFlags {
   // so that they remain stable from run to run of auto clusteing.
   bool tf_xla_deterministic_cluster_names;
 
+  // If true, auto-clustering estimates the cost of each cluster with and
+  // without XLA, and does not compile the clusters predicted to be slower.
+  bool tf_xla_cost_model_clustering;
+
   // If non-empty, JIT-compiled executables are saved to and loaded from the
   // specified file system directory path.
   std::string tf_xla_persistent_cache_directory;
 
+  // If non-empty, a directory shared by many processes, e.g. on a remote file
+  // system, that JIT-compiled executables are also saved to and loaded from.
+  // Executables missing from `tf_xla_persistent_cache_directory` are loaded
+  // from it, and copied to `tf_xla_persistent_cache_directory`.
+  std::string tf_xla_shared_persistent_cache_directory;
+
   // If non-empty, the persistent cache will only be used for the specified
   // devices (comma separated). Each device type should be able to be converted
   // to `DeviceType`.
@@ -151,6 +161,10 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile compiles the cluster asynchronously with respect to
   // the main execution. The fallback path is taken while compilation happens.
   bool tf_xla_async_compilation;
+  // Maximum number of asynchronous cluster compilations running concurrently
+  // in the process. Queued compilations of the most executed clusters run
+  // first.
+  int64_t tf_xla_max_concurrent_async_compilations;
 
   class PjRtForSingleDeviceCompilationRollout {
    public:
@@ -280,6 +294,15 @@ struct BuildXlaOpsPassFlags {
   // Force the WhileOps in embedding_pipelining and embedding_sequencing to use
   // this many parallel_iterations
   int tf_xla_embedding_parallel_iterations;
+
+  // Comma-separated, increasing batch sizes, e.g. "1,8,32,128". If not empty,
+  // the inputs of auto-clustered computations are padded along dimension 0 to
+  // the smallest bucket that holds the batch (dimension 0 of the first input),
+  // and the outputs are sliced back, so that XLA compiles each cluster once per
+  // bucket rather than once per batch size. Only correct if all the inputs and
+  // outputs of the clusters are batch-major tensors, and the examples in a
+  // batch are computed independently. Defaults to empty.
+  std::string tf_xla_batch_size_buckets;
 };
 
 // Flags for common MLIR configurations.
@@ -41,6 +41,7 @@ limitations under the License.
 #include "tensorflow/compiler/jit/device_util.h"
 #include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/resource_operation_safety_analysis.h"
+#include "tensorflow/compiler/jit/xla_cluster_cost_model.h"
 #include "tensorflow/compiler/jit/xla_cluster_util.h"
 #include "tensorflow/compiler/tf2xla/const_analysis.h"
 #include "tensorflow/compiler/tf2xla/resource_operation_table.h"
@@ -112,6 +113,10 @@ class MarkForCompilationPassImpl {
     int max_cluster_size;
     int min_cluster_size;
 
+    // If true, do not compile auto-clusters that XlaClusterCostModel predicts
+    // to be slower with XLA.
+    bool use_cost_model;
+
     // Compiler fuel for the auto-clustering algorithm.
     //
     // We decrement this value by one on every time we choose a compilation
@@ -311,6 +316,12 @@ class MarkForCompilationPassImpl {
   // tf_xla_min_cluster_size, are applied here.
   Status CreateClusters();
 
+  // Returns the auto-clusters that XlaClusterCostModel predicts to be slower
+  // when compiled with XLA than when run by the TF executor.  Clusters that
+  // must be compiled, and clusters whose cost is unknown, are never returned.
+  absl::StatusOr<absl::flat_hash_set<const Cluster*>>
+  FindUnprofitableClusters();
+
   Status DumpDebugInfo();
 
   bool IsCompilationCandidate(Node* n) const {
@@ -898,6 +909,20 @@ Status MarkForCompilationPassImpl::RunEdgeContractionLoop() {
   return absl::OkStatus();
 }
 
+// Returns true if `n`, a Const node, holds a value of at least
+// `kLargeConstantBytes` bytes.
+absl::StatusOr<bool> IsLargeConstant(const Node& n) {
+  constexpr int64_t kLargeConstantBytes = 1 << 16;
+  const TensorProto* proto = nullptr;
+  TF_RETURN_IF_ERROR(GetNodeAttr(n.attrs(), "value", &proto));
+  int64_t num_elements = 1;
+  for (const auto& dim : proto->tensor_shape().dim()) {
+    if (dim.size() < 0) return false;
+    num_elements *= dim.size();
+  }
+  return num_elements * DataTypeSize(proto->dtype()) >= kLargeConstantBytes;
+}
+
 Status MarkForCompilationPassImpl::DeclusterNodes() {
   for (Node* n : compilation_candidates_) {
     Cluster* cluster = GetClusterForNode(n);
@@ -923,6 +948,25 @@ Status MarkForCompilationPassImpl::DeclusterNodes() {
         })) {
       declustered_nodes_.insert(n);
     }
+
+    // De-cluster large constants that are used at least once outside the
+    // cluster, e.g. weights shared by several clusters.
+    //
+    // If we cluster such a constant, the cluster materializes it into a fresh
+    // output buffer on every run, for the users outside the cluster.  If we
+    // don't, the Const kernel keeps a single copy in device memory, and every
+    // cluster using it receives that buffer as an argument without copying.
+    if (n->IsConstant() &&
+        absl::c_any_of(n->out_nodes(), [&](Node* user) {
+          return !user->IsSink() && GetClusterForNode(user) != cluster;
+        })) {
+      TF_ASSIGN_OR_RETURN(bool is_large_constant, IsLargeConstant(*n));
+      if (is_large_constant) {
+        VLOG(2) << "Declustering constant " << n->name()
+                << " used outside of its cluster";
+        declustered_nodes_.insert(n);
+      }
+    }
   }
 
   return absl::OkStatus();
@@ -970,6 +1014,11 @@ Status MarkForCompilationPassImpl::CreateClusters() {
     DumpGraphToFile("before_mark_for_compilation", *graph_, flib_def_);
   }
 
+  absl::flat_hash_set<const Cluster*> unprofitable_clusters;
+  if (debug_options_.use_cost_model) {
+    TF_ASSIGN_OR_RETURN(unprofitable_clusters, FindUnprofitableClusters());
+  }
+
   // Mark clusters for compilation that:
   // * are placed on a device that requires compilation (an XlaDevice),
   // * are explicitly marked for compilation (_XlaCompile=true), or
@@ -980,7 +1029,8 @@ Status MarkForCompilationPassImpl::CreateClusters() {
     Cluster* cluster = GetClusterForNode(n);
     TF_ASSIGN_OR_RETURN(bool should_compile_cluster,
                         ShouldCompileCluster(*cluster));
-    if (!should_compile_cluster || declustered_nodes_.contains(n)) {
+    if (!should_compile_cluster || declustered_nodes_.contains(n) ||
+        unprofitable_clusters.contains(cluster)) {
       continue;
     }
 
@@ -1016,6 +1066,56 @@ Status MarkForCompilationPassImpl::CreateClusters() {
   return absl::OkStatus();
 }
 
+absl::StatusOr<absl::flat_hash_set<const MarkForCompilationPassImpl::Cluster*>>
+MarkForCompilationPassImpl::FindUnprofitableClusters() {
+  absl::flat_hash_map<const Cluster*, std::vector<Node*>> nodes_by_cluster;
+  for (Node* n : compilation_candidates_) {
+    const Cluster* cluster = GetClusterForNode(n);
+    // The cost model does not look into the functions called by If and While.
+    if (cluster->is_xla_compile_attr_true() ||
+        cluster->has_functional_control_flow()) {
+      continue;
+    }
+    nodes_by_cluster[cluster].push_back(n);
+  }
+
+  absl::flat_hash_set<const Cluster*> unprofitable_clusters;
+  if (nodes_by_cluster.empty()) {
+    return unprofitable_clusters;
+  }
+
+  absl::StatusOr<std::unique_ptr<XlaClusterCostModel>> cost_model =
+      XlaClusterCostModel::Create(graph_, flib_def_);
+  if (!cost_model.ok()) {
+    VLOG(1) << "Not using the clustering cost model: " << cost_model.status();
+    return unprofitable_clusters;
+  }
+
+  for (const auto& [cluster, nodes] : nodes_by_cluster) {
+    TF_ASSIGN_OR_RETURN(
+        DeviceId chosen_device,
+        PickDeviceForXla(device_info_cache_, cluster->devices(),
+                         /*allow_mixing_unknown_and_cpu=*/false));
+    const XlaOpRegistry::DeviceRegistration* registration =
+        device_info_cache_.GetCompilationDevice(chosen_device);
+    if (registration == nullptr ||
+        registration->autoclustering_policy ==
+            XlaOpRegistry::AutoclusteringPolicy::kAlways) {
+      continue;
+    }
+
+    std::optional<double> savings_us = (*cost_model)->EstimateSavingsUs(nodes);
+    VLOG(2) << "Estimated savings of compiling "
+            << cluster->DebugString(*graph_) << ": "
+            << (savings_us.has_value() ? absl::StrCat(*savings_us, "us")
+                                       : "unknown");
+    if (savings_us.has_value() && *savings_us < 0) {
+      unprofitable_clusters.insert(cluster);
+    }
+  }
+  return unprofitable_clusters;
+}
+
 Status MarkForCompilationPassImpl::DumpDebugInfo() {
   TF_RET_CHECK(initialized_ && edges_contracted_ && clusters_created_);
 
@@ -1922,6 +2022,7 @@ Status MarkForCompilationPass::Run(
       flags->tf_xla_deterministic_cluster_names;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.use_cost_model = flags->tf_xla_cost_model_clustering;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -1941,6 +2042,7 @@ Status MarkForCompilationPass::RunForTest(
   debug_options.deterministic_cluster_names = deterministic_cluster_names;
   debug_options.max_cluster_size = flags->tf_xla_max_cluster_size;
   debug_options.min_cluster_size = flags->tf_xla_min_cluster_size;
+  debug_options.use_cost_model = flags->tf_xla_cost_model_clustering;
   debug_options.fuel = GetPointerToFuel(flags->tf_xla_clustering_fuel);
   debug_options.dump_graphs = flags->tf_xla_clustering_debug;
 
@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/sendrecv_ops.h"
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/compiler/jit/defs.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/jit/mark_for_compilation_pass_test_helper.h"
 #include "tensorflow/compiler/jit/node_matchers.h"
 #include "tensorflow/compiler/jit/xla_cluster_util.h"
@@ -142,6 +143,39 @@ TEST(XlaCompilationTest, Chains) {
   EXPECT_TRUE(clusters.find("D") == clusters.cend());
 }
 
+TEST(XlaCompilationTest, DontClusterLargeConstantsSharedByClusters) {
+  std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+  {
+    GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+    // 64 KiB of weights.
+    Tensor weights(DT_FLOAT, TensorShape({128, 128}));
+    Node* w = ops::SourceOp("Const", builder.opts()
+                                         .WithName("W")
+                                         .WithAttr("dtype", DT_FLOAT)
+                                         .WithAttr("value", weights));
+    Node* a = ops::BinaryOp("MatMul", w, w, builder.opts().WithName("A"));
+    for (int i = 0; i < 3; ++i) {
+      a = ops::UnaryOp("Relu", a,
+                       builder.opts().WithName(absl::StrCat("A", i)));
+    }
+    Node* b =
+        ops::UnaryOp("UncompilableUnary", a, builder.opts().WithName("B"));
+    Node* c = ops::BinaryOp("MatMul", b, w, builder.opts().WithName("C"));
+    for (int i = 0; i < 3; ++i) {
+      c = ops::UnaryOp("Relu", c,
+                       builder.opts().WithName(absl::StrCat("C", i)));
+    }
+    TF_EXPECT_OK(GraphDefBuilderToGraph(builder, graph.get()));
+  }
+
+  TF_ASSERT_OK(MarkForCompilationPassTestHelper::MarkForCompilation(&graph));
+  auto clusters = GetClusters(*graph);
+  EXPECT_TRUE(clusters.find("W") == clusters.cend());
+  EXPECT_NE(clusters["A"], "");
+  EXPECT_NE(clusters["C"], "");
+  EXPECT_NE(clusters["A"], clusters["C"]);
+}
+
 TEST(XlaCompilationTest, UncompilableCycles) {
   std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
   {
@@ -1530,6 +1564,36 @@ TEST(XlaCompilationTest, DontClusterResourceOpsWhenUnsafe) {
   EXPECT_EQ(clusters[resource_read_name], "");
 }
 
+TEST(XlaCompilationTest, CostModelRejectsClustersPredictedToBeSlower) {
+  Scope root = Scope::NewRootScope().ExitOnError();
+  Output small = ops::Placeholder(root.WithOpName("test/small"), DT_FLOAT,
+                                  ops::Placeholder::Shape({}));
+  Output large = ops::Placeholder(root.WithOpName("test/large"), DT_FLOAT,
+                                  ops::Placeholder::Shape({1024, 1024}));
+  // On scalars, the launch of the cluster costs more than the TF executor
+  // spends dispatching the ops.  On large tensors, not writing the
+  // intermediate tensors to memory pays off.
+  for (int i = 0; i < 5; ++i) {
+    small = ops::Tanh(root.WithOpName(absl::StrCat("test/small_", i)), small);
+    large = ops::Tanh(root.WithOpName(absl::StrCat("test/large_", i)), large);
+  }
+
+  std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+  TF_ASSERT_OK(root.ToGraph(graph.get()));
+
+  MarkForCompilationPassFlags* flags = GetMarkForCompilationPassFlags();
+  flags->tf_xla_cost_model_clustering = true;
+  absl::Status status =
+      MarkForCompilationPassTestHelper::MarkForCompilation(&graph);
+  flags->tf_xla_cost_model_clustering = false;
+  TF_ASSERT_OK(status);
+
+  std::unordered_map<string, string> clusters = GetClusters(*graph);
+  EXPECT_EQ(clusters["test/small_0"], "");
+  EXPECT_NE(clusters["test/large_0"], "");
+  EXPECT_EQ(clusters["test/large_0"], clusters["test/large_4"]);
+}
+
 TEST(XlaCompilationTest, DontClusterNodesWithScopedAllocatorAttr) {
   Scope root = Scope::NewRootScope().ExitOnError();
   Output a = ops::Placeholder(root.WithOpName("test/a"), DT_FLOAT);
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/jit/pjrt_device_context.h"
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -42,8 +43,8 @@ namespace {
 absl::StatusOr<std::unique_ptr<xla::PjRtBuffer>> HostTensorToPjRtBuffer(
     const tensorflow::Tensor* cpu_tensor, tensorflow::Device* device,
     xla::PjRtClient* pjrt_client,
-    const XlaShapeLayoutHelpers::ShapeDeterminationFns
-        shape_determination_fns) {
+    const XlaShapeLayoutHelpers::ShapeDeterminationFns& shape_determination_fns,
+    std::atomic<bool>* device_layout_unimplemented) {
   XlaLayoutPreference layout_preference =
       shape_determination_fns.layout_preference_fn(
           cpu_tensor->shape(), cpu_tensor->dtype(), std::nullopt);
@@ -59,32 +60,28 @@ absl::StatusOr<std::unique_ptr<xla::PjRtBuffer>> HostTensorToPjRtBuffer(
   TF_ASSIGN_OR_RETURN(xla::PjRtDevice * pjrt_device,
                       pjrt_client->LookupAddressableDevice(
                           xla::PjRtLocalDeviceId(pjrt_device_id)));
-  auto first_try_buffer = pjrt_client->BufferFromHostBuffer(
-      cpu_tensor->data(), shape.element_type(), shape.dimensions(),
-      /*byte_strides=*/std::nullopt,
-      xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy,
-      /*on_done_with_host_buffer=*/
-      [cpu_tensor = *cpu_tensor]() { /* frees tensor */ }, pjrt_device,
-      device_layout);
-  if (first_try_buffer.ok()) {
-    return std::move(*first_try_buffer);
-  }
-  if (first_try_buffer.status().code() == absl::StatusCode::kUnimplemented) {
+  if (!device_layout_unimplemented->load(std::memory_order_relaxed)) {
+    auto first_try_buffer = pjrt_client->BufferFromHostBuffer(
+        cpu_tensor->data(), shape.element_type(), shape.dimensions(),
+        /*byte_strides=*/std::nullopt,
+        xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy,
+        /*on_done_with_host_buffer=*/
+        [cpu_tensor = *cpu_tensor]() { /* frees tensor */ }, pjrt_device,
+        device_layout);
+    if (first_try_buffer.status().code() != absl::StatusCode::kUnimplemented) {
+      return first_try_buffer;
+    }
     LOG_FIRST_N(WARNING, 1)
         << first_try_buffer.status()
         << "; fallback to BufferFromHostBuffer without device layout.";
-    TF_ASSIGN_OR_RETURN(
-        std::unique_ptr<xla::PjRtBuffer> second_try_buffer,
-        pjrt_client->BufferFromHostBuffer(
-            cpu_tensor->data(), shape.element_type(), shape.dimensions(),
-            /*byte_strides=*/std::nullopt,
-            xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy,
-            /*on_done_with_host_buffer=*/
-            [cpu_tensor = *cpu_tensor]() { /* frees tensor */ }, pjrt_device));
-    return second_try_buffer;
-  } else {
-    return first_try_buffer.status();
+    device_layout_unimplemented->store(true, std::memory_order_relaxed);
   }
+  return pjrt_client->BufferFromHostBuffer(
+      cpu_tensor->data(), shape.element_type(), shape.dimensions(),
+      /*byte_strides=*/std::nullopt,
+      xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy,
+      /*on_done_with_host_buffer=*/
+      [cpu_tensor = *cpu_tensor]() { /* frees tensor */ }, pjrt_device);
 }
 }  // namespace
 
@@ -161,7 +158,8 @@ void PjRtDeviceContext::CopyCPUTensorToDevice(const Tensor* cpu_tensor,
   }
   absl::StatusOr<std::unique_ptr<xla::PjRtBuffer>> buffer_or =
       HostTensorToPjRtBuffer(cpu_tensor, device, *pjrt_client,
-                             shape_determination_fns_);
+                             shape_determination_fns_,
+                             &device_layout_unimplemented_);
   if (!buffer_or.ok()) {
     done(buffer_or.status());
     return;
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_JIT_PJRT_DEVICE_CONTEXT_H_
 #define TENSORFLOW_COMPILER_JIT_PJRT_DEVICE_CONTEXT_H_
 
+#include <atomic>
 #include <utility>
 
 #include "tensorflow/compiler/tf2xla/layout_util.h"
@@ -50,6 +51,9 @@ class PjRtDeviceContext : public DeviceContext {
   XlaShapeLayoutHelpers::ShapeDeterminationFns shape_determination_fns_;
   // Note: we currently assume the PjRtBuffer is a PjRtStreamExecutorBuffer.
   bool use_pjrt_tensor_buffer_;
+  // Set once the PjRt client has rejected a host-to-device transfer with a
+  // device layout, so that later transfers do not pay for the failed attempt.
+  mutable std::atomic<bool> device_layout_unimplemented_ = false;
 };
 
 void PjRtDeviceToDeviceCopy(DeviceContext* send_dev_context,
@@ -0,0 +1,191 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/jit/xla_cluster_cost_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "tensorflow/compiler/jit/shape_inference.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/costs/op_context.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace {
+
+using grappler::Costs;
+
+double ToMicroseconds(Costs::Duration duration) {
+  return static_cast<double>(duration.count()) / 1000;
+}
+
+OpInfo::TensorProperties TensorProperties(DataType dtype,
+                                          const GraphShapeInfo& shape_info,
+                                          const Node* node, int output) {
+  OpInfo::TensorProperties properties;
+  properties.set_dtype(dtype);
+  auto it = shape_info.find(node->name());
+  if (it != shape_info.end() && output < it->second.size()) {
+    it->second[output].shape.AsProto(properties.mutable_shape());
+  } else {
+    properties.mutable_shape()->set_unknown_rank(true);
+  }
+  return properties;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<XlaClusterCostModel>>
+XlaClusterCostModel::Create(Graph* graph,
+                            const FunctionLibraryDefinition* flib_def,
+                            const Options& options) {
+  GraphShapeInfo shape_info;
+  TF_RETURN_IF_ERROR(InferShapes(graph, /*arg_shapes=*/{}, flib_def,
+                                 &shape_info));
+
+  std::unordered_map<string, const NodeDef*> name_to_node;
+  for (const Node* node : graph->op_nodes()) {
+    name_to_node[node->name()] = &node->def();
+  }
+
+  auto cost_model = absl::WrapUnique(new XlaClusterCostModel(options));
+  cost_model->node_costs_.resize(graph->num_node_ids());
+  cost_model->topological_index_.resize(graph->num_node_ids());
+
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  for (int i = 0; i < order.size(); ++i) {
+    cost_model->topological_index_[order[i]->id()] = i;
+  }
+
+  grappler::OpLevelCostEstimator estimator;
+  absl::flat_hash_map<string, DeviceProperties> device_properties;
+  for (const Node* node : graph->op_nodes()) {
+    std::vector<OpInfo::TensorProperties> inputs(node->num_inputs());
+    for (const Edge* edge : node->in_edges()) {
+      if (edge->IsControlEdge()) continue;
+      inputs[edge->dst_input()] =
+          TensorProperties(node->input_type(edge->dst_input()), shape_info,
+                           edge->src(), edge->src_output());
+    }
+
+    grappler::OpContext op_context;
+    op_context.name = node->name();
+    op_context.op_info =
+        grappler::BuildOpInfoWithoutDevice(node->def(), name_to_node, inputs);
+    for (int i = 0; i < node->num_outputs(); ++i) {
+      *op_context.op_info.add_outputs() =
+          TensorProperties(node->output_type(i), shape_info, node, i);
+    }
+
+    string device = !node->assigned_device_name().empty()
+                        ? node->assigned_device_name()
+                        : node->requested_device();
+    if (device.empty()) device = "/device:CPU:0";
+    auto [it, inserted] = device_properties.try_emplace(device);
+    if (inserted) it->second = grappler::GetDeviceInfo(device);
+    *op_context.op_info.mutable_device() = it->second;
+    op_context.device_name = device;
+
+    const Costs costs = estimator.PredictCosts(op_context);
+    NodeCost& cost = cost_model->node_costs_[node->id()];
+    cost.accurate =
+        !costs.inaccurate && costs.num_ops_with_unknown_shapes == 0;
+    cost.compute_us = ToMicroseconds(costs.compute_time);
+    cost.memory_us = ToMicroseconds(costs.memory_time);
+
+    const double gb_per_sec = estimator.GetDeviceInfo(it->second).gb_per_sec;
+    for (const OpInfo::TensorProperties& output :
+         op_context.op_info.outputs()) {
+      // 1 GB/s moves 1000 bytes per microsecond.
+      cost.output_memory_us.push_back(
+          grappler::CalculateTensorSize(output) / (gb_per_sec * 1000));
+    }
+  }
+  return cost_model;
+}
+
+std::optional<double> XlaClusterCostModel::EstimateSavingsUs(
+    absl::Span<Node* const> nodes) const {
+  std::vector<Node*> sorted_nodes(nodes.begin(), nodes.end());
+  absl::c_sort(sorted_nodes, [&](const Node* a, const Node* b) {
+    return topological_index_[a->id()] < topological_index_[b->id()];
+  });
+
+  // The time at which each node finishes when the cluster runs in the
+  // TensorFlow executor, assuming unbounded parallelism.
+  absl::flat_hash_map<const Node*, double> tf_finish_us;
+  for (const Node* node : sorted_nodes) {
+    tf_finish_us[node] = 0;
+  }
+
+  double tf_total_us = 0;
+  double tf_critical_path_us = 0;
+  double xla_compute_us = 0;
+  double xla_memory_us = 0;
+  for (const Node* node : sorted_nodes) {
+    const NodeCost& cost = node_costs_[node->id()];
+    if (!cost.accurate) return std::nullopt;
+
+    double tf_start_us = 0;
+    for (const Edge* edge : node->in_edges()) {
+      auto it = tf_finish_us.find(edge->src());
+      if (it == tf_finish_us.end()) continue;
+      tf_start_us = std::max(tf_start_us, it->second);
+      if (!edge->IsControlEdge()) {
+        // XLA neither writes the tensor to memory nor reads it back.
+        xla_memory_us -=
+            2 * node_costs_[edge->src()->id()].output_memory_us.at(
+                    edge->src_output());
+      }
+    }
+    const double tf_node_us =
+        cost.compute_us + cost.memory_us + options_.tf_op_overhead_us;
+    tf_finish_us[node] = tf_start_us + tf_node_us;
+    tf_critical_path_us = std::max(tf_critical_path_us, tf_finish_us[node]);
+    tf_total_us += tf_node_us;
+
+    xla_compute_us += cost.compute_us;
+    xla_memory_us += cost.memory_us;
+  }
+
+  const double tf_us = std::max(
+      tf_critical_path_us,
+      tf_total_us / std::max<int64_t>(options_.inter_op_parallelism, 1));
+  const double amortized_compile_us =
+      sorted_nodes.size() * options_.compile_time_per_node_us /
+      std::max<int64_t>(options_.num_executions_to_amortize_compilation, 1);
+  const double xla_us = xla_compute_us + std::max(xla_memory_us, 0.0) +
+                        options_.xla_launch_overhead_us + amortized_compile_us;
+  return tf_us - xla_us;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,94 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_JIT_XLA_CLUSTER_COST_MODEL_H_
+#define TENSORFLOW_COMPILER_JIT_XLA_CLUSTER_COST_MODEL_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+// Estimates, per execution, whether running a candidate cluster as a single
+// XLA computation is faster than running its nodes one by one in the
+// TensorFlow executor. Node costs are predicted by grappler's
+// OpLevelCostEstimator from the statically inferred shapes of the graph.
+//
+// The TensorFlow executor pays a dispatch overhead per op, and writes every
+// intermediate tensor to memory, but may run independent ops concurrently.
+// The XLA computation avoids the per-op overhead and the memory traffic of the
+// tensors produced and consumed inside the cluster, but runs the ops one after
+// the other, and pays a launch overhead and its compilation time.
+class XlaClusterCostModel {
+ public:
+  struct Options {
+    // Time the TensorFlow executor spends dispatching each op, in
+    // microseconds.
+    double tf_op_overhead_us = 5;
+
+    // Time to launch a compiled cluster, in microseconds.
+    double xla_launch_overhead_us = 50;
+
+    // Compilation time per node of the cluster, in microseconds, spread over
+    // `num_executions_to_amortize_compilation` executions.
+    double compile_time_per_node_us = 1000;
+    int64_t num_executions_to_amortize_compilation = 1000;
+
+    // Number of ops the TensorFlow executor is assumed to run concurrently.
+    int64_t inter_op_parallelism = 4;
+  };
+
+  // Infers the shapes of `graph` and predicts the cost of each of its nodes.
+  static absl::StatusOr<std::unique_ptr<XlaClusterCostModel>> Create(
+      Graph* graph, const FunctionLibraryDefinition* flib_def,
+      const Options& options);
+  static absl::StatusOr<std::unique_ptr<XlaClusterCostModel>> Create(
+      Graph* graph, const FunctionLibraryDefinition* flib_def) {
+    return Create(graph, flib_def, Options());
+  }
+
+  // Returns the time saved per execution by compiling `nodes` as one cluster,
+  // in microseconds, which is negative if the cluster is predicted to be
+  // slower. Returns nullopt if the cost of some node is unknown, e.g. because
+  // its shapes are not known statically.
+  std::optional<double> EstimateSavingsUs(absl::Span<Node* const> nodes) const;
+
+ private:
+  struct NodeCost {
+    bool accurate = false;
+    double compute_us = 0;
+    double memory_us = 0;
+    // Time to write each output to memory, or to read it back.
+    std::vector<double> output_memory_us;
+  };
+
+  explicit XlaClusterCostModel(const Options& options) : options_(options) {}
+
+  const Options options_;
+  // Indexed by node id.
+  std::vector<NodeCost> node_costs_;
+  std::vector<int> topological_index_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_JIT_XLA_CLUSTER_COST_MODEL_H_
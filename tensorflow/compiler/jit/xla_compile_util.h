@@ -23,7 +23,9 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 
 namespace tensorflow {
-// The number of compiler threads to use for asynchronous device compilation.
+// The maximum number of asynchronous device compilations of a device that can
+// be queued or running at the same time. The compilations run on the threads
+// of the process-wide AsyncCompilationScheduler.
 inline constexpr int64_t kNumAsyncDeviceCompilerThreads = 10;
 
 enum class DeviceCompileMode {
@@ -161,8 +161,6 @@ XlaComputationLaunchContext::PopulateInputs(
     int arg_num = compilation_result->input_mapping[i];
     CHECK_GE(arg_num, missing_ctx_input_prefix);
     const xla::Shape& device_shape = compilation_result->xla_input_shapes[i];
-    const xla::Shape& host_shape =
-        xla::ShapeUtil::DeviceShapeToHostShape(device_shape);
 
     auto resource_var_it = resource_vars.find(arg_num);
     bool is_resource_variable = resource_var_it != resource_vars.end();
@@ -197,7 +195,8 @@ XlaComputationLaunchContext::PopulateInputs(
           ctx->op_device_context()->stream());
     }
 
-    arguments.emplace_back(device_shape, host_shape);
+    // ExecutionInput derives the host shape from the device shape itself.
+    arguments.emplace_back(device_shape);
     xla::ExecutionInput& execution_input = arguments.back();
     se::DeviceMemoryBase dmem = XlaTensor::DeviceMemoryFromTensor(*t);
     PopulateExecutionInputBuffer(execution_input, xla::ShapeIndex{}, dmem,
@@ -403,9 +402,11 @@ Status XlaComputationLaunchContext::PopulateOutputs(
     }
   }
 
-  std::vector<TensorShape> output_tensor_shapes;
-  output_tensor_shapes.reserve(ctx->num_outputs());
+  // The shapes of the outputs are only computed when they are dynamic;
+  // otherwise the compiled shapes are used without copying them.
+  std::vector<TensorShape> dynamic_output_shapes;
   if (output.on_host_shape().is_dynamic()) {
+    dynamic_output_shapes.reserve(ctx->num_outputs());
     const se::Platform* platform = nullptr;
     if (stream != nullptr) {
       platform = stream->parent()->GetPlatform();
@@ -428,18 +429,16 @@ Status XlaComputationLaunchContext::PopulateOutputs(
           xla::ShapeUtil::GetSubshape(output_device_shape, {i});
       TensorShape shape;
       TF_RETURN_IF_ERROR(XLAShapeToTensorShape(subshape, &shape));
-      output_tensor_shapes.push_back(shape);
-    }
-  } else {
-    for (int i = 0; i < ctx->num_outputs(); ++i) {
-      output_tensor_shapes.push_back(compilation_result->outputs[i].shape);
+      dynamic_output_shapes.push_back(shape);
     }
   }
 
   // Copy XLA results to the OpOutputList.
   int output_num = 0;
   for (int i = 0, end = ctx->num_outputs(); i < end; ++i) {
-    const TensorShape& shape = output_tensor_shapes[i];
+    const TensorShape& shape = dynamic_output_shapes.empty()
+                                   ? compilation_result->outputs[i].shape
+                                   : dynamic_output_shapes[i];
     const DataType& type = compilation_result->outputs[i].type;
     VLOG(2) << "Populating output for retval " << i << " shape "
             << shape.DebugString() << " type " << DataTypeString(type);
@@ -468,12 +467,6 @@ Status XlaComputationLaunchContext::PopulateOutputs(
     }
   }
 
-  // input_index -> index into variable_infos.
-  absl::flat_hash_map<int, int> variable_info_lookup;
-  for (int i = 0; i < variable_infos.size(); i++) {
-    variable_info_lookup.emplace(variable_infos[i].index(), i);
-  }
-
   // Apply variable updates, if any.
   for (int i = 0, end = compilation_result->resource_updates.size(); i < end;
        ++i) {
@@ -482,7 +475,18 @@ Status XlaComputationLaunchContext::PopulateOutputs(
     int actual_input_index = write.input_index - missing_ctx_input_prefix;
     CHECK_GE(actual_input_index, 0);
     CHECK_LT(actual_input_index, ctx->num_inputs());
-    Var* var = variable_infos[variable_info_lookup[actual_input_index]].var();
+    // `variable_infos` usually comes from GatherVariableInfo, which returns
+    // the variables in the order of the resource updates.
+    const VariableInfo* variable_info =
+        i < variable_infos.size() &&
+                variable_infos[i].index() == actual_input_index
+            ? &variable_infos[i]
+            : absl::c_find_if(variable_infos,
+                              [&](const VariableInfo& info) {
+                                return info.index() == actual_input_index;
+                              });
+    CHECK(variable_info != variable_infos.end());
+    Var* var = variable_info->var();
     CHECK(var);
 
     VLOG(2) << "Updating variable #" << i
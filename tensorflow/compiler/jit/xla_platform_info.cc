@@ -78,6 +78,8 @@ PjRtDeviceCompiler* CreatePjRtDeviceCompiler(DeviceType compilation_device_type,
       GetMarkForCompilationPassFlags()->tf_xla_disable_strict_signature_checks,
       GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_prefix,
       GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_read_only);
+  persistor_config.shared_persistent_cache_directory =
+      GetSharedPersistentCacheDirectory(compilation_device_type);
 
   return new PjRtDeviceCompiler(
       std::make_unique<PjRtDeviceExecutablePersistor>(
@@ -151,25 +153,38 @@ Status GetCompilationDeviceTypeAndPjRtClient(
 
   return absl::OkStatus();
 }
+
+// Returns true if the persistent cache is used for `compilation_device_type`.
+bool UsePersistentCache(const DeviceType& compilation_device_type) {
+  // If a persistent cache device type is specified, ensure it matches
+  // compilation device type.
+  const std::string& device_types =
+      GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_device_types;
+  return device_types.empty() ||
+         absl::c_any_of(absl::StrSplit(device_types, ','),
+                        [&](absl::string_view device) {
+                          return compilation_device_type == DeviceType(device);
+                        });
+}
 }  // namespace
 
 std::string GetPersistentCacheDirectory(
     const DeviceType& compilation_device_type) {
-  // If a persistent cache device type is specified, ensure it matches
-  // compilation device type.
-  if (!GetMarkForCompilationPassFlags()
-           ->tf_xla_persistent_cache_device_types.empty() &&
-      !absl::c_any_of(absl::StrSplit(GetMarkForCompilationPassFlags()
-                                         ->tf_xla_persistent_cache_device_types,
-                                     ','),
-                      [&](absl::string_view device) {
-                        return compilation_device_type == DeviceType(device);
-                      })) {
+  if (!UsePersistentCache(compilation_device_type)) {
     return "";
   }
   return GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_directory;
 }
 
+std::string GetSharedPersistentCacheDirectory(
+    const DeviceType& compilation_device_type) {
+  if (!UsePersistentCache(compilation_device_type)) {
+    return "";
+  }
+  return GetMarkForCompilationPassFlags()
+      ->tf_xla_shared_persistent_cache_directory;
+}
+
 absl::StatusOr<std::optional<std::set<int>>> ParseVisibleDeviceList(
     absl::string_view visible_device_list) {
   std::set<int> gpu_ids;
@@ -225,6 +240,8 @@ Status BuildXlaDeviceCompiler(DeviceBase* device, FunctionLibraryRuntime* flr,
       GetMarkForCompilationPassFlags()->tf_xla_disable_strict_signature_checks,
       GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_prefix,
       GetMarkForCompilationPassFlags()->tf_xla_persistent_cache_read_only);
+  persistor_config.shared_persistent_cache_directory =
+      GetSharedPersistentCacheDirectory(platform_info.device_type());
 
   if (platform_info.xla_device_metadata()) {
     *xla_device_compiler = CreateXlaDeviceCompiler(
@@ -156,6 +156,10 @@ XlaPlatformInfo XlaPlatformInfoFromDevice(DeviceBase* device);
 std::string GetPersistentCacheDirectory(
     const DeviceType& compilation_device_type);
 
+// Same as above, for the persistent cache directory shared by many processes.
+std::string GetSharedPersistentCacheDirectory(
+    const DeviceType& compilation_device_type);
+
 // Returns allocator from platform info if non-null, or populate and return a
 // pointer to the allocator adapter with allocator from context.
 //
@@ -735,8 +735,9 @@ class Translator {
   bool EstimateArithmeticCount(int64_t* count);
 
   // Append constant and custom op buffers at the end of the flatbuffer and
-  // calculate the offsets
-  void AppendBufferData(absl::Cord& result);
+  // calculate the offsets. Each constant buffer is released as soon as it is
+  // appended, so the weights are held only once during the export.
+  void AppendBufferData(std::string& result);
 
   // Update constant & custom op buffer offsets
   // Return false if fail to update offset
@@ -844,7 +845,9 @@ class Translator {
   // Maps buffer data to corresponding buffer index
   // in the idx map, the value is a pair of offset and size
   absl::flat_hash_map<int, std::pair<uint64_t, uint64_t>> buffer_idx_map_;
-  absl::flat_hash_map<int, std::string> buffer_data_map_;
+  // The constant buffers are not copied, the cords reference the tensors
+  // they were converted to.
+  absl::flat_hash_map<int, absl::Cord> buffer_data_map_;
   bool buffer_data_exported_ = false;
 
   // Maps custom options data to corresponding node
@@ -998,7 +1001,7 @@ std::optional<BufferOffset<tflite::Buffer>> Translator::BuildBuffer(
     auto packed_buffer = tflite::PackInt4ValuesDensely(data);
     if (use_buffer_offset_) {
       buffer_data_map_[index] =
-          std::string(packed_buffer.begin(), packed_buffer.end());
+          absl::Cord(std::string(packed_buffer.begin(), packed_buffer.end()));
       return tflite::CreateBuffer(builder_, 0, 1, 1);
     } else {
       if (IsModelBiggerThan2GB(packed_buffer.size())) {
@@ -1037,10 +1040,9 @@ std::optional<BufferOffset<tflite::Buffer>> Translator::BuildBuffer(
     char* tensor_buffer;
     int bytes = dynamic_buffer.WriteToBuffer(&tensor_buffer);
     if (use_buffer_offset_) {
-      std::vector<uint8_t> buffer_data(tensor_buffer, tensor_buffer + bytes);
-      free(tensor_buffer);
-      buffer_data_map_[index] =
-          std::string(buffer_data.begin(), buffer_data.end());
+      buffer_data_map_[index] = absl::MakeCordFromExternal(
+          absl::string_view(tensor_buffer, bytes),
+          [tensor_buffer]() { free(tensor_buffer); });
       return tflite::CreateBuffer(builder_, 0, 1, 1);
     } else {
       if (IsModelBiggerThan2GB(bytes)) {
@@ -1056,7 +1058,9 @@ std::optional<BufferOffset<tflite::Buffer>> Translator::BuildBuffer(
 
   absl::string_view tensor_data = tensor.tensor_data();
   if (use_buffer_offset_) {
-    buffer_data_map_[index] = std::string(tensor_data);
+    // The cord shares the tensor buffer rather than copying the weights.
+    buffer_data_map_[index] =
+        absl::MakeCordFromExternal(tensor_data, [tensor]() {});
     return tflite::CreateBuffer(builder_, 0, 1, 1);
   } else {
     if (IsModelBiggerThan2GB(tensor_data.size())) {
@@ -3944,21 +3948,15 @@ std::optional<std::string> Translator::TranslateInternal() {
   tflite::UpdateOpVersion(builder_.GetBufferPointer());
   tflite::UpdateMinimumRuntimeVersionForModel(builder_.GetBufferPointer());
 
-  absl::Cord result;
-  auto fbs = absl::string_view(
+  std::string result_str(
       reinterpret_cast<const char*>(builder_.GetBufferPointer()),
       builder_.GetSize());
-  result.Append(fbs);
 
   // Return serialized string for the built FlatBuffer.
   if (use_buffer_offset_) {
     // Pad to be 16 bytes aligned
-    {
-      std::string pad(kFbAlignment - result.size() % kFbAlignment, '\0');
-      result.Append(std::move(pad));
-    }
-    AppendBufferData(result);
-    std::string result_str = std::string(std::move(result));
+    result_str.append(kFbAlignment - result_str.size() % kFbAlignment, '\0');
+    AppendBufferData(result_str);
     auto mutable_model = tflite::GetMutableModel(result_str.data());
     bool ret = UpdateBufferOffsets(mutable_model);
     if (!ret) {
@@ -3966,17 +3964,29 @@ std::optional<std::string> Translator::TranslateInternal() {
     }
     return result_str;
   }
-  return std::string(result);
+  return result_str;
 }
 
-void Translator::AppendBufferData(absl::Cord& result) {
+void Translator::AppendBufferData(std::string& result) {
   std::unordered_map<uint64_t, std::pair<int64_t, int64_t>> hashcode_to_pos;
   // Buffer data should be exported only once.
   assert(!buffer_data_exported_);
 
+  // Reserve the upper bound of the exported size, so that growing the result
+  // never holds a second copy of the weights.
+  size_t reserved_size = result.size() + 3 * kFbAlignment;
+  for (const auto& it : buffer_data_map_) {
+    reserved_size += it.second.size() + kFbAlignment;
+  }
+  for (const auto& it : custom_op_data_map_) {
+    reserved_size += it.second.size() + kFbAlignment +
+                     custom_option_alignment_.value_or(0);
+  }
+  result.reserve(reserved_size);
+
   auto it = buffer_data_map_.begin();
   while (it != buffer_data_map_.end()) {
-    std::string buffer = it->second;
+    absl::string_view buffer = it->second.Flatten();
     int64_t index = it->first;
     int64_t offset = result.size();
     int64_t size = buffer.size();
@@ -3984,51 +3994,36 @@ void Translator::AppendBufferData(absl::Cord& result) {
     if (hashcode_to_pos.find(hash) == hashcode_to_pos.end()) {
       hashcode_to_pos[hash] = std::make_pair(offset, size);
       buffer_idx_map_[index] = std::make_pair(offset, size);
-      result.Append(std::move(buffer));
+      result.append(buffer.data(), buffer.size());
       // Pad to be 16 bytes aligned.
-      {
-        std::string pad(kFbAlignment - result.size() % kFbAlignment, '\0');
-        result.Append(std::move(pad));
-      }
+      result.append(kFbAlignment - result.size() % kFbAlignment, '\0');
     } else {
       // only update offset/index.
       buffer_idx_map_[index] = hashcode_to_pos[hash];
     }
+    // Releases the tensor backing the buffer.
     buffer_data_map_.erase(it);
     it = buffer_data_map_.begin();
     buffer_data_exported_ = true;
   }
   // pad 16 bytes for the last buffer for XNNPack
-  result.Append("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0");
+  result.append("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0");
   // pad to be 16 bytes aligned
-  {
-    std::string pad(kFbAlignment - result.size() % kFbAlignment, '\0');
-    result.Append(std::move(pad));
-  }
+  result.append(kFbAlignment - result.size() % kFbAlignment, '\0');
 
   for (auto& it : custom_op_data_map_) {
-    {
-      std::string pad(kFbAlignment - result.size() % kFbAlignment, '\0');
-      result.Append(std::move(pad));
-    }
+    result.append(kFbAlignment - result.size() % kFbAlignment, '\0');
     if (custom_option_alignment_.has_value()) {
-      {
-        auto alignment = custom_option_alignment_.value();
-        std::string pad(alignment - result.size() % alignment, '\0');
-        result.Append(std::move(pad));
-      }
+      auto alignment = custom_option_alignment_.value();
+      result.append(alignment - result.size() % alignment, '\0');
     }
-    auto buffer = std::string(it.second.begin(), it.second.end());
     int64_t offset = result.size();
     int64_t size = it.second.size();
     custom_op_idx_map_[it.first] = std::make_pair(offset, size);
-    result.Append(std::move(buffer));
+    result.append(it.second.begin(), it.second.end());
   }
   // pad to be 16 bytes aligned
-  {
-    std::string pad(kFbAlignment - result.size() % kFbAlignment, '\0');
-    result.Append(std::move(pad));
-  }
+  result.append(kFbAlignment - result.size() % kFbAlignment, '\0');
 }
 
 bool Translator::UpdateBufferOffsets(tflite::Model* mutable_model) {
@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tf2xla/internal/clustering_bridge_passes.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/inference/inference_passes.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/logging_hooks.h"
+#include "tensorflow/compiler/mlir/tf2xla/internal/pass_profiling.h"
 #include "xla/tsl/framework/device_type.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/platform/errors.h"
@@ -124,6 +125,7 @@ tensorflow::Status RunTFXLABridge(
     internal::EnablePassIRPrinting(bridge, kDebugGroupBridgePhase1Clustering,
                                    module_name);
   }
+  internal::EnablePassProfiling(bridge);
 
   LogicalResult result = bridge.run(module);
   (void)result;
@@ -64,6 +64,7 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tensorflow/utils/translate_utils.h"
 #include "tensorflow/compiler/mlir/tensorflow/utils/xla_sharding_util.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/mlir_pass_instrumentation.h"
+#include "tensorflow/compiler/mlir/tf2xla/internal/pass_profiling.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/passes/lowering_passes.h"
 #include "tensorflow/compiler/mlir/tf2xla/transforms/passes.h"
 #include "tensorflow/compiler/tf2xla/layout_util.h"
@@ -396,6 +397,7 @@ void CreateMlirLoweringPassesPipeline(mlir::PassManager& pm) {
   for (const auto& creator : pass_instrumentors) {
     pm.addInstrumentation(creator());
   }
+  tf2xla::internal::EnablePassProfiling(pm);
 }
 
 // If the module should be dumped then dumps the file and turns on the before
@@ -648,6 +650,7 @@ Status CreateAndRunMlirBridge(mlir::ModuleOp module_op,
   for (const auto& creator : pass_instrumentors) {
     tf2xla.addInstrumentation(creator());
   }
+  tf2xla::internal::EnablePassProfiling(tf2xla);
   MaybeDumpMlirModuleAndPasses(tf2xla, module_op, module_name.str(),
                                /*tag=*/"legalize_hlo_before");
 
@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tf2xla/api/v2/device_type.pb.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/clustering_bridge_passes.h"
 #include "tensorflow/compiler/mlir/tf2xla/internal/logging_hooks.h"
+#include "tensorflow/compiler/mlir/tf2xla/internal/pass_profiling.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/platform/error_payloads.h"
 #include "tensorflow/core/platform/errors.h"
@@ -96,6 +97,7 @@ tensorflow::Status RunTFXLABridge(
     ::tensorflow::tf2xla::internal::EnablePassIRPrinting(
         bridge, kDebugGroupBridgePhase1Clustering, module_name);
   }
+  ::tensorflow::tf2xla::internal::EnablePassProfiling(bridge);
 
   LogicalResult result = bridge.run(module);
   (void)result;
@@ -0,0 +1,130 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/mlir/tf2xla/internal/pass_profiling.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/IR/SymbolTable.h"  // from @llvm-project
+#include "mlir/Pass/Pass.h"  // from @llvm-project
+#include "mlir/Pass/PassInstrumentation.h"  // from @llvm-project
+#include "mlir/Pass/PassManager.h"  // from @llvm-project
+#include "tsl/platform/mem.h"
+#include "tsl/profiler/lib/traceme.h"
+#include "tsl/profiler/lib/traceme_encode.h"
+
+namespace tensorflow {
+namespace tf2xla {
+namespace internal {
+
+namespace {
+
+using tsl::profiler::TraceMe;
+using tsl::profiler::TraceMeEncode;
+
+// Returns the number of operations nested in `op`, including `op` itself.
+int64_t CountOps(mlir::Operation* op) {
+  int64_t num_ops = 0;
+  op->walk([&](mlir::Operation*) { ++num_ops; });
+  return num_ops;
+}
+
+// Returns the host memory in use in bytes, or 0 if it is not known.
+int64_t HostMemoryInUse() {
+  tsl::port::MemoryInfo info = tsl::port::GetMemoryInfo();
+  if (info.total == std::numeric_limits<int64_t>::max() ||
+      info.free == std::numeric_limits<int64_t>::max()) {
+    return 0;
+  }
+  return info.total - info.free;
+}
+
+// Returns the symbol name of `op`, e.g. the function name, or the name of the
+// operation if it has none.
+std::string OpName(mlir::Operation* op) {
+  if (auto sym_name = op->getAttrOfType<mlir::StringAttr>(
+          mlir::SymbolTable::getSymbolAttrName())) {
+    return sym_name.str();
+  }
+  return op->getName().getStringRef().str();
+}
+
+class PassProfilingInstrumentation : public mlir::PassInstrumentation {
+ public:
+  void runBeforePass(mlir::Pass* pass, mlir::Operation* op) override {
+    // Passes run on a given thread are strictly nested, so the events of that
+    // thread form a stack. Nested passes may run on other threads when
+    // multi-threading is enabled, each with its own stack. A null entry is
+    // pushed while the profiler is inactive to keep the stack balanced.
+    if (!TraceMe::Active()) {
+      Events().push_back(nullptr);
+      return;
+    }
+    Events().push_back(std::make_unique<TraceMe>([&] {
+      return TraceMeEncode(pass->getName().str(),
+                           {{"op", OpName(op)},
+                            {"num_ops_before", CountOps(op)},
+                            {"host_mem_before", HostMemoryInUse()}});
+    }));
+  }
+
+  void runAfterPass(mlir::Pass* pass, mlir::Operation* op) override {
+    EndEvent(op, /*failed=*/false);
+  }
+
+  void runAfterPassFailed(mlir::Pass* pass, mlir::Operation* op) override {
+    EndEvent(op, /*failed=*/true);
+  }
+
+ private:
+  static std::vector<std::unique_ptr<TraceMe>>& Events() {
+    static thread_local std::vector<std::unique_ptr<TraceMe>> events;
+    return events;
+  }
+
+  static void EndEvent(mlir::Operation* op, bool failed) {
+    auto& events = Events();
+    if (events.empty()) return;
+    if (events.back() != nullptr) {
+      events.back()->AppendMetadata([&] {
+        return TraceMeEncode({{"num_ops_after", CountOps(op)},
+                              {"host_mem_after", HostMemoryInUse()},
+                              {"failed", failed ? 1 : 0}});
+      });
+    }
+    events.pop_back();
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<mlir::PassInstrumentation>
+CreatePassProfilingInstrumentation() {
+  return std::make_unique<PassProfilingInstrumentation>();
+}
+
+void EnablePassProfiling(mlir::PassManager& pm) {
+  pm.addInstrumentation(CreatePassProfilingInstrumentation());
+}
+
+};  // namespace internal
+};  // namespace tf2xla
+};  // namespace tensorflow
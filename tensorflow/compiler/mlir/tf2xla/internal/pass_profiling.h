@@ -0,0 +1,44 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_MLIR_TF2XLA_INTERNAL_PASS_PROFILING_H_
+#define TENSORFLOW_COMPILER_MLIR_TF2XLA_INTERNAL_PASS_PROFILING_H_
+
+#include <memory>
+
+#include "mlir/Pass/PassInstrumentation.h"  // from @llvm-project
+#include "mlir/Pass/PassManager.h"  // from @llvm-project
+
+namespace tensorflow {
+namespace tf2xla {
+namespace internal {
+
+// Returns an instrumentation that records a TraceMe event for each pass run
+// on each operation, e.g. on each function for nested passes, while the
+// profiler is active. The profiler exports the events to XPlane, with the
+// wall time of the pass as the duration of the event, and with the number of
+// operations in the IR and the host memory in use before and after the pass
+// as metadata.
+std::unique_ptr<mlir::PassInstrumentation> CreatePassProfilingInstrumentation();
+
+// Adds the instrumentation above to the input pass manager. The
+// instrumentation does nothing when the profiler is not active.
+void EnablePassProfiling(mlir::PassManager& pm);
+
+};  // namespace internal
+};  // namespace tf2xla
+};  // namespace tensorflow
+
+#endif  // TENSORFLOW_COMPILER_MLIR_TF2XLA_INTERNAL_PASS_PROFILING_H_
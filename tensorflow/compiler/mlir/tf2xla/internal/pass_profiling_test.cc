@@ -0,0 +1,154 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/mlir/tf2xla/internal/pass_profiling.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/IR/BuiltinOps.h"  // from @llvm-project
+#include "mlir/IR/MLIRContext.h"  // from @llvm-project
+#include "mlir/Parser/Parser.h"  // from @llvm-project
+#include "mlir/Pass/PassManager.h"  // from @llvm-project
+#include "mlir/Transforms/Passes.h"  // from @llvm-project
+#include "tensorflow/compiler/mlir/register_common_dialects.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/resource_loader.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/profiler/lib/profiler_session.h"
+#include "tensorflow/core/profiler/protobuf/xplane.pb.h"
+
+namespace tensorflow {
+namespace tf2xla {
+namespace internal {
+namespace {
+
+using mlir::DialectRegistry;
+using mlir::LogicalResult;
+using mlir::MLIRContext;
+using mlir::ModuleOp;
+using mlir::OwningOpRef;
+using mlir::PassManager;
+using mlir::func::FuncOp;
+
+std::string TestDataPath() {
+  return tensorflow::GetDataDependencyFilepath(
+      "tensorflow/compiler/mlir/tf2xla/internal/testdata/");
+}
+
+class PassProfilingTest : public ::testing::Test {
+ public:
+  PassProfilingTest() {
+    mlir::RegisterCommonToolingDialects(registry_);
+    context_.appendDialectRegistry(registry_);
+    context_.loadAllAvailableDialects();
+  }
+
+  absl::Status CreateMlirModule(std::string mlir_module_filename) {
+    std::string mlir_module_path = TestDataPath() + mlir_module_filename;
+    mlir_module_ =
+        mlir::parseSourceFile<mlir::ModuleOp>(mlir_module_path, &context_);
+    if (!mlir_module_) {
+      return absl::Status(
+          absl::StatusCode::kNotFound,
+          absl::StrCat("Could not find MLIR module at ", mlir_module_path));
+    }
+    return absl::OkStatus();
+  }
+
+  // Returns the stats of the first event named `name`, keyed by stat name.
+  static std::map<std::string, std::string> FindEventStats(
+      const profiler::XSpace& xspace, const std::string& name) {
+    std::map<std::string, std::string> stats;
+    for (const auto& plane : xspace.planes()) {
+      for (const auto& line : plane.lines()) {
+        for (const auto& event : line.events()) {
+          auto metadata = plane.event_metadata().find(event.metadata_id());
+          if (metadata == plane.event_metadata().end() ||
+              metadata->second.name() != name) {
+            continue;
+          }
+          for (const auto& stat : event.stats()) {
+            const std::string& stat_name =
+                plane.stat_metadata().at(stat.metadata_id()).name();
+            switch (stat.value_case()) {
+              case profiler::XStat::kInt64Value:
+                stats[stat_name] = absl::StrCat(stat.int64_value());
+                break;
+              case profiler::XStat::kUint64Value:
+                stats[stat_name] = absl::StrCat(stat.uint64_value());
+                break;
+              case profiler::XStat::kStrValue:
+                stats[stat_name] = stat.str_value();
+                break;
+              default:
+                break;
+            }
+          }
+          return stats;
+        }
+      }
+    }
+    return stats;
+  }
+
+  DialectRegistry registry_;
+  MLIRContext context_;
+  OwningOpRef<mlir::ModuleOp> mlir_module_;
+};
+
+TEST_F(PassProfilingTest, RecordsNestedPassesPerFunction) {
+  TF_ASSERT_OK(CreateMlirModule("dead_const.mlir"));
+  PassManager pass_manager(&context_);
+  pass_manager.addNestedPass<FuncOp>(mlir::createCanonicalizerPass());
+  EnablePassProfiling(pass_manager);
+
+  std::unique_ptr<ProfilerSession> profiler =
+      ProfilerSession::Create(ProfilerSession::DefaultOptions());
+  LogicalResult pass_status = pass_manager.run(mlir_module_.get());
+  EXPECT_TRUE(pass_status.succeeded());
+
+  profiler::XSpace xspace;
+  TF_ASSERT_OK(profiler->CollectData(&xspace));
+
+  auto stats = FindEventStats(xspace, "Canonicalizer");
+  EXPECT_THAT(stats, ::testing::Contains(::testing::Pair("op", "main")));
+  EXPECT_THAT(stats,
+              ::testing::Contains(::testing::Pair("num_ops_before", "3")));
+  EXPECT_THAT(stats,
+              ::testing::Contains(::testing::Pair("num_ops_after", "2")));
+  EXPECT_THAT(stats, ::testing::Contains(::testing::Pair("failed", "0")));
+  EXPECT_THAT(stats, ::testing::Contains(::testing::Key("host_mem_after")));
+}
+
+TEST_F(PassProfilingTest, RunsWithoutProfiler) {
+  TF_ASSERT_OK(CreateMlirModule("dead_const.mlir"));
+  PassManager pass_manager(&context_);
+  pass_manager.addNestedPass<FuncOp>(mlir::createCanonicalizerPass());
+  EnablePassProfiling(pass_manager);
+
+  LogicalResult pass_status = pass_manager.run(mlir_module_.get());
+  EXPECT_TRUE(pass_status.succeeded());
+}
+
+};  // namespace
+};  // namespace internal
+};  // namespace tf2xla
+};  // namespace tensorflow
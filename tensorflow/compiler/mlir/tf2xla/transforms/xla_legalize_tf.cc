@@ -18,6 +18,8 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -31,10 +33,13 @@ limitations under the License.
 #include "mlir/IR/Attributes.h"  // from @llvm-project
 #include "mlir/IR/BuiltinAttributeInterfaces.h"  // from @llvm-project
 #include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
+#include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "mlir/IR/PatternMatch.h"  // from @llvm-project
+#include "mlir/IR/Threading.h"  // from @llvm-project
 #include "mlir/Pass/Pass.h"  // from @llvm-project
 #include "mlir/Support/LLVM.h"  // from @llvm-project
+#include "mlir/Rewrite/FrozenRewritePatternSet.h"  // from @llvm-project
 #include "mlir/Support/LogicalResult.h"  // from @llvm-project
 #include "mlir/Transforms/DialectConversion.h"  // from @llvm-project
 #include "stablehlo/dialect/ChloOps.h"  // from @stablehlo
@@ -135,7 +140,8 @@ void IncrementFailedLegalizationCount(Operation *op,
       ->IncrementBy(1);
 }
 
-mlir::LogicalResult ApplyPatterns(Operation *op, RewritePatternSet &patterns,
+mlir::LogicalResult ApplyPatterns(Operation *op,
+                                  const FrozenRewritePatternSet &patterns,
                                   bool legalize_chlo) {
   ConversionTarget target =
       GetDefaultLegalConversionTargets(*op->getContext(), legalize_chlo);
@@ -143,7 +149,7 @@ mlir::LogicalResult ApplyPatterns(Operation *op, RewritePatternSet &patterns,
   DenseSet<Operation *> unconverted_ops;
   ConversionConfig config;
   config.unlegalizedOps = &unconverted_ops;
-  auto result = applyPartialConversion(op, target, std::move(patterns), config);
+  auto result = applyPartialConversion(op, target, patterns, config);
   if (failed(result)) {
     IncrementFailedLegalizationCount(op, target);
   }
@@ -153,6 +159,25 @@ mlir::LogicalResult ApplyPatterns(Operation *op, RewritePatternSet &patterns,
   return result;
 }
 
+// Legalizes each function of `module` independently, in parallel on the
+// context thread pool when multi-threading is enabled. Native patterns only
+// read other functions, e.g. to look up the type of a callee, so functions
+// can be converted concurrently. Falls back to converting the whole module if
+// it holds anything other than functions.
+mlir::LogicalResult ApplyPatternsPerFunction(
+    ModuleOp module, const FrozenRewritePatternSet &patterns,
+    bool legalize_chlo) {
+  if (!llvm::all_of(module.getOps(),
+                    [](Operation &op) { return isa<func::FuncOp>(op); })) {
+    return ApplyPatterns(module, patterns, legalize_chlo);
+  }
+  llvm::SmallVector<func::FuncOp> funcs(module.getOps<func::FuncOp>());
+  return failableParallelForEach(
+      module.getContext(), funcs, [&](func::FuncOp func) {
+        return ApplyPatterns(func, patterns, legalize_chlo);
+      });
+}
+
 /// When `tf2xla_fallback_device_type` is not `None`, also uses legalization
 /// patterns from TF2XLA fallback for provided device type (see
 /// legalize_tf_with_tf2xla.cc for details). By default, TF2XLA fallback is
@@ -215,7 +240,15 @@ LogicalResult legalizeTF(Operation *op, bool legalize_chlo,
   // canonicalization pattern to pattern list to enable multi-hop lowering.
   chlo::ConstantLikeOp::getCanonicalizationPatterns(patterns, context);
 
-  return ApplyPatterns(op, patterns, legalize_chlo);
+  FrozenRewritePatternSet frozen_patterns(std::move(patterns));
+  // TF2XLA fallback patterns may insert functions into the module for ops
+  // with subcomputations, so they must not run concurrently with other
+  // functions.
+  auto module = dyn_cast<ModuleOp>(op);
+  if (module && !tf2xla_fallback_device_type) {
+    return ApplyPatternsPerFunction(module, frozen_patterns, legalize_chlo);
+  }
+  return ApplyPatterns(op, frozen_patterns, legalize_chlo);
 }
 
 // Performs the lowering to XLA dialect.
@@ -14,10 +14,13 @@ limitations under the License.
 ==============================================================================*/
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include <gtest/gtest.h>
 #include "absl/strings/string_view.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/DialectRegistry.h"  // from @llvm-project
@@ -110,6 +113,41 @@ TEST(XlaLegalizeTest, LegalOp) {
   EXPECT_TRUE(status);
   EXPECT_EQ(legalize_failure_count.Read("tf.InfeedDequeueTuple", "Unknown"), 1);
 }
+
+TEST(XlaLegalizeTest, LegalizesEachFunctionWithoutFallback) {
+  constexpr char kMlirMultipleFunctionsStr[] = R"(
+  module attributes {tf.versions = {bad_consumers = [], min_consumer = 0 : i32, producer = 268 : i32}} {
+    func.func @main(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+      %0 = "tf.AddV2"(%arg0, %arg0) : (tensor<2xf32>, tensor<2xf32>) -> tensor<2xf32>
+      func.return %0 : tensor<2xf32>
+    }
+    func.func @f1(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+      %0 = "tf.Mul"(%arg0, %arg0) : (tensor<2xf32>, tensor<2xf32>) -> tensor<2xf32>
+      func.return %0 : tensor<2xf32>
+    }
+    func.func @f2(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+      %0 = "tf.Sub"(%arg0, %arg0) : (tensor<2xf32>, tensor<2xf32>) -> tensor<2xf32>
+      func.return %0 : tensor<2xf32>
+    }
+  })";
+  MLIRContext context;
+  OwningOpRef<ModuleOp> module =
+      GetMlirModuleFromString(kMlirMultipleFunctionsStr, &context).value();
+
+  PassManager pm(&context);
+  pm.addPass(mlir::mhlo::createLegalizeTFPass(
+      /*legalize_chlo=*/true, /*tf2xla_fallback_device_type=*/std::nullopt,
+      /*prefer_tf2xla=*/false));
+  ASSERT_TRUE(pm.run(module.get()).succeeded());
+
+  std::string module_str;
+  llvm::raw_string_ostream os(module_str);
+  module->print(os);
+  EXPECT_EQ(module_str.find("\"tf."), std::string::npos) << module_str;
+  EXPECT_NE(module_str.find("mhlo.add"), std::string::npos) << module_str;
+  EXPECT_NE(module_str.find("mhlo.multiply"), std::string::npos) << module_str;
+  EXPECT_NE(module_str.find("mhlo.subtract"), std::string::npos) << module_str;
+}
 }  // namespace
 
 }  // namespace tensorflow
@@ -451,10 +451,16 @@ GlobalDeviceMap EstablishGlobalRank(const CollGroupParams& gp,
     TaskDeviceMap& tdm = iter.second;
     OrderTaskDeviceMap(gpu_ring_order, &tdm);
   }
-  // Connect the global rank order by the lexicographical order of the tasks.
-  std::set<string> tasks;
+  // Connect the global rank order by the order of the tasks in gp.members,
+  // which are sorted by parsed device name. Unlike the lexicographical order
+  // of the task names, this keeps tasks with adjacent indices, which are
+  // commonly placed close to each other, adjacent in the ring.
+  std::vector<string> tasks;
+  absl::flat_hash_set<string> seen_tasks;
   for (const CollGroupMember& member : gp.members) {
-    tasks.insert(member.task);
+    if (seen_tasks.insert(member.task).second) {
+      tasks.push_back(member.task);
+    }
   }
   int next_rank = 0;
   for (const string& task : tasks) {
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/collective_param_resolver_local.h"
 
+#include <algorithm>
 #include <atomic>
 
 #include "absl/strings/str_join.h"
@@ -89,6 +90,25 @@ class CollectiveParamResolverLocalTest : public ::testing::Test {
   std::unique_ptr<CollectiveParamResolverLocal> prl_;
 };
 
+TEST_F(CollectiveParamResolverLocalTest, CompleteDefaultRankingOrdersTasks) {
+  constexpr int kNumTasks = 12;
+  CollGroupParams group;
+  group.device_type = DeviceType("CPU");
+  group.num_tasks = kNumTasks;
+  group.group_size = kNumTasks;
+  std::vector<string> expected_device_order;
+  for (int task_idx = 0; task_idx < kNumTasks; ++task_idx) {
+    CollGroupMember member;
+    member.task = strings::StrCat("/job:worker/replica:0/task:", task_idx);
+    member.device.set_name(strings::StrCat(member.task, "/device:CPU:0"));
+    expected_device_order.push_back(member.device.name());
+    group.members.push_back(member);
+  }
+  // Tasks are ranked by index, rather than by name, e.g. task:10 after task:9.
+  std::reverse(group.members.begin(), group.members.end());
+  RunCompleteDefaultRanking(group, {}, expected_device_order);
+}
+
 TEST_F(CollectiveParamResolverLocalTest, CompleteDefaultRanking) {
   constexpr int kNumGpus = 8;
   CollGroupParams group;
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -39,10 +40,13 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/setround.h"
 #include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -613,8 +617,70 @@ bool ReplaceTensorWithConstant(
   return true;
 }
 
+// Returns the key of the tensors `tensor_names` of `constant_graph` in a
+// ConstantFoldingCache.
+uint64 ConstantFoldingCacheKey(const Graph& constant_graph,
+                               const std::vector<string>& tensor_names) {
+  GraphDef graph_def;
+  constant_graph.ToGraphDef(&graph_def);
+  uint64 key = DeterministicProtoHash64(graph_def);
+  for (const string& tensor_name : tensor_names) {
+    key = Hash64Combine(key, Hash64(tensor_name));
+  }
+  return key;
+}
+
 }  // namespace
 
+ConstantFoldingCache* ConstantFoldingCache::Global() {
+  static ConstantFoldingCache* cache = [] {
+    int64_t capacity_in_bytes;
+    Status status = ReadInt64FromEnvVar("TF_CONSTANT_FOLDING_CACHE_BYTES",
+                                        /*default_val=*/0, &capacity_in_bytes);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      capacity_in_bytes = 0;
+    }
+    return new ConstantFoldingCache(capacity_in_bytes);
+  }();
+  return cache;
+}
+
+bool ConstantFoldingCache::Lookup(uint64 key, std::vector<Tensor>* tensors) {
+  mutex_lock l(mu_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  *tensors = it->second.tensors;
+  return true;
+}
+
+void ConstantFoldingCache::Insert(uint64 key,
+                                  const std::vector<Tensor>& tensors) {
+  int64_t bytes = 0;
+  for (const Tensor& tensor : tensors) {
+    bytes += tensor.TotalBytes();
+  }
+  if (bytes > capacity_in_bytes_) {
+    return;
+  }
+  mutex_lock l(mu_);
+  if (entries_.contains(key)) {
+    return;
+  }
+  while (size_in_bytes_ + bytes > capacity_in_bytes_) {
+    auto it = entries_.find(lru_.back());
+    size_in_bytes_ -= it->second.bytes;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+  lru_.push_front(key);
+  entries_[key] = Entry{tensors, bytes, lru_.begin()};
+  size_in_bytes_ += bytes;
+}
+
 Status ConstantFold(const ConstantFoldingOptions& opts,
                     FunctionLibraryRuntime* function_library, Env* env,
                     const Device* partition_device, Graph* graph,
@@ -689,25 +755,47 @@ Status ConstantFold(const ConstantFoldingOptions& opts,
     graph_runner.reset(nullptr);
   });
 
-  Status s =
-      graph_runner->Run(constant_graph.get(), function_library, {} /* inputs*/,
-                        tensors_to_fetch_names, &outputs);
-  if (!s.ok()) {
-    VLOG(1) << "Could not fetch constants: " << s;
-    *was_mutated = false;
-    return s;
+  std::optional<uint64> cache_key;
+  if (opts.cache != nullptr && opts.cache->capacity_in_bytes() > 0) {
+    cache_key =
+        ConstantFoldingCacheKey(*constant_graph, tensors_to_fetch_names);
+  }
+  if (cache_key.has_value() && opts.cache->Lookup(*cache_key, &outputs)) {
+    VLOG(1) << "Found " << outputs.size() << " constants in the cache";
+  } else {
+    Status s = graph_runner->Run(constant_graph.get(), function_library,
+                                 {} /* inputs*/, tensors_to_fetch_names,
+                                 &outputs);
+    if (!s.ok()) {
+      VLOG(1) << "Could not fetch constants: " << s;
+      *was_mutated = false;
+      return s;
+    }
+    if (cache_key.has_value()) {
+      opts.cache->Insert(*cache_key, outputs);
+    }
   }
 
   // Fetch the constant tensors and replace the corresponding tensors in the
   // original graph with those constants.
   int32_t num_nodes_replaced = 0;
+  int64_t total_constant_size_in_bytes = 0;
   for (size_t c = 0; c < outputs.size(); ++c) {
+    if (opts.max_total_constant_size_in_bytes >= 0 &&
+        total_constant_size_in_bytes + outputs[c].TotalBytes() >
+            opts.max_total_constant_size_in_bytes) {
+      VLOG(1) << "Not replacing " << tensors_to_replace[c].first->name()
+              << " :: " << tensors_to_replace[c].second
+              << " with a constant, since it does not fit in the budget";
+      continue;
+    }
     const gtl::FlatSet<Node*>& control_deps =
         constant_control_deps[tensors_to_replace[c].first];
     if (ReplaceTensorWithConstant(
             graph, partition_device, tensors_to_replace[c], outputs[c],
             control_deps, opts.max_constant_size_in_bytes, generate_new_name)) {
       ++num_nodes_replaced;
+      total_constant_size_in_bytes += outputs[c].TotalBytes();
     }
   }
 
@@ -16,11 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_CONSTANT_FOLDING_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_CONSTANT_FOLDING_H_
 
+#include <list>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 
 // TODO(skyewm): can this be combined with EvaluateConstantTensor?
 
@@ -31,6 +37,44 @@ namespace tensorflow {
 using ConstantFoldNameGenerator =
     std::function<string(Graph* graph, string old_name)>;
 
+// Caches the tensors computed by ConstantFold(), keyed by a fingerprint of the
+// constant subgraph that was evaluated and the tensors fetched from it, so that
+// folding the same subgraph again, e.g. when a function is instantiated again,
+// does not evaluate it again. The least recently used entries are evicted to
+// keep the cached tensors under `capacity_in_bytes`. Thread-safe.
+class ConstantFoldingCache {
+ public:
+  explicit ConstantFoldingCache(int64_t capacity_in_bytes)
+      : capacity_in_bytes_(capacity_in_bytes) {}
+
+  // Returns the cache used by the graph optimizer. Its capacity is read from
+  // the TF_CONSTANT_FOLDING_CACHE_BYTES environment variable, and is 0 (caching
+  // is disabled) by default.
+  static ConstantFoldingCache* Global();
+
+  // Returns true and sets `tensors` if there is an entry for `key`.
+  bool Lookup(uint64 key, std::vector<Tensor>* tensors);
+
+  // Adds `tensors` for `key`, unless they do not fit in the cache.
+  void Insert(uint64 key, const std::vector<Tensor>& tensors);
+
+  int64_t capacity_in_bytes() const { return capacity_in_bytes_; }
+
+ private:
+  struct Entry {
+    std::vector<Tensor> tensors;
+    int64_t bytes;
+    std::list<uint64>::iterator lru_position;
+  };
+
+  const int64_t capacity_in_bytes_;
+  mutex mu_;
+  // Keys of the entries, the most recently used first.
+  std::list<uint64> lru_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<uint64, Entry> entries_ TF_GUARDED_BY(mu_);
+  int64_t size_in_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
 // Options specific to constant folding optimizations.
 struct ConstantFoldingOptions {
   // If "consider" is not a nullptr, then only constant fold a node "n" if
@@ -44,6 +88,13 @@ struct ConstantFoldingOptions {
   // The maximum size of each constant created during constant folding
   // optimization.
   int64_t max_constant_size_in_bytes = 10 * 1024 * 1024;
+  // If non-negative, the maximum total size of the constants created by a
+  // ConstantFold() call. The candidate tensors are considered in the order of
+  // their names, and are not replaced if they do not fit in what is left.
+  int64_t max_total_constant_size_in_bytes = -1;
+  // If not nullptr, the computed constants are looked up in and added to this
+  // cache.
+  ConstantFoldingCache* cache = nullptr;  // not owned
 
   // A generator for the name suffix of constant folded nodes. A
   // default id generator that monotonically increases is used if nullptr is
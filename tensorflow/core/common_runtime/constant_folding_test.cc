@@ -333,6 +333,65 @@ TEST_F(ConstantFoldingTest, TestNoReplaceLargeConstant) {
   EXPECT_TRUE(was_mutated);
 }
 
+TEST_F(ConstantFoldingTest, TotalConstantSizeBudget) {
+  Scope s = Scope::NewRootScope();
+  BuildSimpleGraph(&s);
+  Graph g(OpRegistry::Global());
+  TF_ASSERT_OK(s.ToGraph(&g));
+
+  // Only one of the 2x2 float products fits in the budget.
+  ConstantFoldingOptions opt;
+  opt.max_total_constant_size_in_bytes = 16;
+  bool was_mutated;
+  TF_ASSERT_OK(
+      ConstantFold(opt, nullptr, Env::Default(), nullptr, &g, &was_mutated));
+  EXPECT_TRUE(was_mutated);
+
+  std::unordered_map<string, Node*> index = g.BuildNodeNameIndex();
+  ExpectNodeClose<float>(*(index.at("s1")->in_nodes().begin()),
+                         {1.0, 2.0, 3.0, 4.0}, {2, 2});
+  EXPECT_EQ(index.at("m2"), *(index.at("s2")->in_nodes().begin()));
+}
+
+TEST_F(ConstantFoldingTest, Cache) {
+  ConstantFoldingCache cache(/*capacity_in_bytes=*/1024);
+  ConstantFoldingOptions opt;
+  opt.cache = &cache;
+  for (int i = 0; i < 2; ++i) {
+    Scope s = Scope::NewRootScope();
+    BuildSimpleGraph(&s);
+    Graph g(OpRegistry::Global());
+    TF_ASSERT_OK(s.ToGraph(&g));
+    bool was_mutated;
+    TF_ASSERT_OK(
+        ConstantFold(opt, nullptr, Env::Default(), nullptr, &g, &was_mutated));
+    EXPECT_TRUE(was_mutated);
+
+    std::unordered_map<string, Node*> index = g.BuildNodeNameIndex();
+    ExpectNodeClose<float>(*(index.at("s1")->in_nodes().begin()),
+                           {1.0, 2.0, 3.0, 4.0}, {2, 2});
+    ExpectNodeClose<float>(*(index.at("s2")->in_nodes().begin()),
+                           {2.0, 1.0, 4.0, 3.0}, {2, 2});
+  }
+}
+
+TEST(ConstantFoldingCacheTest, EvictsLeastRecentlyUsed) {
+  ConstantFoldingCache cache(/*capacity_in_bytes=*/8);
+  cache.Insert(1, {test::AsScalar<int32>(1)});
+  cache.Insert(2, {test::AsScalar<int32>(2)});
+  std::vector<Tensor> tensors;
+  ASSERT_TRUE(cache.Lookup(1, &tensors));
+  test::ExpectTensorEqual<int32>(tensors[0], test::AsScalar<int32>(1));
+
+  cache.Insert(3, {test::AsScalar<int32>(3)});
+  EXPECT_TRUE(cache.Lookup(1, &tensors));
+  EXPECT_FALSE(cache.Lookup(2, &tensors));
+  EXPECT_TRUE(cache.Lookup(3, &tensors));
+  // Does not fit at all.
+  cache.Insert(4, {test::AsTensor<int32>({1, 2, 3})});
+  EXPECT_FALSE(cache.Lookup(4, &tensors));
+}
+
 TEST_F(ConstantFoldingTest, TestNoReplaceFunctionCall) {
   FunctionDefLibrary flib;
   *flib.add_function() = test::function::XTimesTwo();
@@ -44,6 +44,10 @@ inline constexpr char kGcuWithSmearCostName[] = "gcu_with_smear";
 inline constexpr char kGcuNoSmearCostName[] = "gcu_no_smear";
 inline constexpr char kGcuNonBatchingCostName[] = "gcu_non_batching";
 
+// Time a request waited in batch queues, summed over the batches processing
+// it. Recorded with the other per-request costs, though it uses no resources.
+inline constexpr char kBatchQueueingDelayCostName[] = "batch_queueing_delay";
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_COMMON_RUNTIME_COST_CONSTANTS_H_
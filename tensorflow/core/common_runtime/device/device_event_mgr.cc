@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -33,6 +34,13 @@ namespace {
 //  - Should EventMgrs be shared between devices on a machine with multiple
 //  devices of the same type?
 static const int kNumThreads = 2;
+
+bool UseHostCallbacks() {
+  bool use_host_callbacks;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS",
+                                 /*default_val=*/false, &use_host_callbacks));
+  return use_host_callbacks;
+}
 }  // namespace
 
 namespace device_event_mgr {
@@ -100,12 +108,20 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       polling_active_delay_usecs_(gpu_options.polling_active_delay_usecs()
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
+      use_host_callbacks_(UseHostCallbacks()),
       threadpool_(Env::Default(), "Device_Event_Manager", kNumThreads) {
   device_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
 }
 
 EventMgr::~EventMgr() {
+  {
+    // Host callbacks still entrained on streams refer to this object.
+    mutex_lock l(mu_);
+    while (pending_host_callbacks_ > 0) {
+      host_callbacks_done_.wait(l);
+    }
+  }
   StopPollingLoop();
 
   for (auto& [stream, stream_callbacks] : callbacks_) {
@@ -168,6 +184,72 @@ void EventMgr::PollLoop() {
   polling_stopped_->Notify();
 }
 
+Status EventMgr::ThenExecuteWithHostCallback(se::Stream* stream,
+                                             std::function<void()>* func) {
+  {
+    mutex_lock l(mu_);
+    ++pending_host_callbacks_;
+  }
+  // Shared with the host callback so that `*func` can be handed back if the
+  // callback cannot be entrained, in which case it never runs.
+  auto pending = std::make_shared<std::function<void()>>(std::move(*func));
+  Status status = stream->DoHostCallback(
+      [this, pending]() { OnHostCallback(std::move(*pending)); });
+  if (!status.ok()) {
+    LOG(WARNING) << "Falling back to polling an event after failing to "
+                    "entrain a host callback: "
+                 << status;
+    *func = std::move(*pending);
+    mutex_lock l(mu_);
+    if (--pending_host_callbacks_ == 0) {
+      host_callbacks_done_.notify_all();
+    }
+  }
+  return status;
+}
+
+void EventMgr::OnHostCallback(std::function<void()> func) {
+  // Runs on the thread of the driver, which must not be blocked for long and
+  // must not call back into it, so `func` runs in threadpool_. Callbacks that
+  // complete before that thread gets to them run in the same batch.
+  bool schedule;
+  {
+    mutex_lock l(mu_);
+    completed_callbacks_.push_back(std::move(func));
+    schedule = !run_completed_callbacks_scheduled_;
+    run_completed_callbacks_scheduled_ = true;
+  }
+  if (schedule) {
+    threadpool_.Schedule([this]() { RunCompletedCallbacks(); });
+  }
+  // Only now, since the destructor tears down threadpool_ once there are no
+  // pending host callbacks.
+  mutex_lock l(mu_);
+  if (--pending_host_callbacks_ == 0) {
+    host_callbacks_done_.notify_all();
+  }
+}
+
+void EventMgr::RunCompletedCallbacks() {
+  // Keeps running batches until none is left, so that a single thread runs
+  // the callbacks, in the order they completed.
+  std::vector<std::function<void()>> callbacks;
+  while (true) {
+    {
+      mutex_lock l(mu_);
+      if (completed_callbacks_.empty()) {
+        run_completed_callbacks_scheduled_ = false;
+        return;
+      }
+      callbacks.swap(completed_callbacks_);
+    }
+    for (auto& callback : callbacks) {
+      callback();
+    }
+    callbacks.clear();
+  }
+}
+
 void EventMgr::EnqueueCallback(se::Stream* stream, std::function<void()> func) {
   VLOG(2) << "EnqueueCallback with one or more callbacks pending on "
           << callbacks_.size() << " streams and " << free_events_.size()
@@ -60,6 +60,11 @@ void WarnIfInCallback(std::function<void()> f);
 // EventMgr lets you register a callback to be executed when a given
 // StreamExecutor stream completes all the work that's thus-far been enqueued on
 // the stream.
+//
+// By default completion is detected by polling an event recorded on the
+// stream. With TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS=true, the stream itself
+// calls back to the host instead (e.g. cudaLaunchHostFunc), so the latency of
+// callbacks is not bounded by the polling interval.
 class EventMgr {
  public:
   virtual ~EventMgr();
@@ -68,6 +73,10 @@ class EventMgr {
   // be brief and non-blocking since it executes in the one thread used for all
   // such callbacks and also buffer deletions.
   void ThenExecute(se::Stream* stream, std::function<void()> func) {
+    if (use_host_callbacks_ &&
+        ThenExecuteWithHostCallback(stream, &func).ok()) {
+      return;
+    }
     ToFreeVector to_free;
     {
       mutex_lock l(mu_);
@@ -84,6 +93,7 @@ class EventMgr {
 
   se::StreamExecutor* const exec_;
   const int32 polling_active_delay_usecs_;
+  const bool use_host_callbacks_;
   mutex mu_;
   condition_variable events_pending_ TF_GUARDED_BY(mu_);
 
@@ -116,6 +126,18 @@ class EventMgr {
   void PollEvents(se::Stream* stream, ToFreeVector* to_free)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Entrains a host callback onto `stream` that runs `*func` once the stream
+  // completes its outstanding work. On failure `*func` is left untouched.
+  Status ThenExecuteWithHostCallback(se::Stream* stream,
+                                     std::function<void()>* func);
+
+  // Called from the host callback of a stream: queues `func` to run in
+  // threadpool_, together with the other callbacks completed meanwhile.
+  void OnHostCallback(std::function<void()> func);
+
+  // Runs the callbacks queued by OnHostCallback.
+  void RunCompletedCallbacks();
+
   // An internal polling loop that runs at a low frequency to clear straggler
   // Events.
   void PollLoop();
@@ -133,6 +155,14 @@ class EventMgr {
       std::deque<std::pair<std::unique_ptr<se::Event>, std::function<void()>>>>
       callbacks_ TF_GUARDED_BY(mu_);
 
+  // Callbacks completed through host callbacks and not run yet, and whether
+  // RunCompletedCallbacks is scheduled to run them.
+  std::vector<std::function<void()>> completed_callbacks_ TF_GUARDED_BY(mu_);
+  bool run_completed_callbacks_scheduled_ TF_GUARDED_BY(mu_) = false;
+  // The number of host callbacks entrained but not called yet.
+  int64_t pending_host_callbacks_ TF_GUARDED_BY(mu_) = 0;
+  condition_variable host_callbacks_done_;
+
   bool stop_polling_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Notification> polling_stopped_;
 
@@ -138,6 +138,41 @@ TEST(EventMgr, WarnIfInCallback) {
   note.WaitForNotification();
   EXPECT_TRUE(hit);
 }
+
+// Tests that callbacks run in order on the EventMgr threads when completion is
+// signaled by host callbacks rather than polled events.
+TEST(EventMgr, HostCallbacks) {
+  setenv("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS", "true", /*overwrite=*/1);
+  auto stream_exec = se::GPUMachineManager()->ExecutorForDevice(0).value();
+  TEST_EventMgr em(stream_exec, GPUOptions());
+  unsetenv("TF_GPU_EVENT_MGR_USE_HOST_CALLBACKS");
+  TEST_EventMgrHelper th(&em);
+  TF_ASSERT_OK_AND_ASSIGN(auto stream, stream_exec->CreateStream());
+  constexpr int kNumCallbacks = 100;
+  mutex mu;
+  std::vector<int> order;
+  bool in_callback_thread = true;
+  Notification note;
+  for (int i = 0; i < kNumCallbacks; ++i) {
+    em.ThenExecute(stream.get(), [i, &mu, &order, &in_callback_thread,
+                                  &note]() {
+      bool hit = false;
+      device_event_mgr::WarnIfInCallback([&hit] { hit = true; });
+      mutex_lock l(mu);
+      in_callback_thread &= hit;
+      order.push_back(i);
+      if (order.size() == kNumCallbacks) note.Notify();
+    });
+  }
+  note.WaitForNotification();
+  // Nothing was left for the (stopped) polling loop.
+  EXPECT_EQ(0, th.queue_size());
+  mutex_lock l(mu);
+  EXPECT_TRUE(in_callback_thread);
+  for (int i = 0; i < kNumCallbacks; ++i) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
 }  // namespace
 
 // Provides access to private resources of BaseGPUDevice.
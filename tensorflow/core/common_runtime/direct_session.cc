@@ -364,6 +364,13 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.message();
   }
+  // Serving the small intermediate allocations of each step from blocks owned
+  // by the step avoids a round-trip to the device allocator per allocation.
+  const Status arena_status = ReadBoolFromEnvVar(
+      "TF_STEP_ARENA_ALLOCATOR", false, &use_step_arena_allocator_);
+  if (!arena_status.ok()) {
+    LOG(ERROR) << arena_status.message();
+  }
   session_handle_ =
       strings::StrCat("direct", strings::FpToString(random::New64()));
   if (options.config.log_device_placement()) {
@@ -669,6 +676,7 @@ Status DirectSession::RunInternal(
   args.tensor_store = &run_state.tensor_store;
   args.step_container = &run_state.step_container;
   args.sync_on_finish = sync_on_finish_;
+  args.use_step_arena_allocator = use_step_arena_allocator_;
   args.user_intra_op_threadpool = threadpool_options.intra_op_threadpool;
   args.run_all_kernels_inline = pool == nullptr;
   args.start_time_usecs = start_time_usecs;
@@ -1027,6 +1035,7 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
     LogMemory::RecordStep(args.step_id, run_state_args.handle);
   }
   args.sync_on_finish = sync_on_finish_;
+  args.use_step_arena_allocator = use_step_arena_allocator_;
 
   if (options_.config.graph_options().build_cost_model()) {
     run_state->collector.reset(new StepStatsCollector(nullptr));
@@ -355,6 +355,10 @@ class DirectSession : public Session {
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
 
+  // If true, each step serves small intermediate allocations from its own
+  // blocks. Set by the TF_STEP_ARENA_ALLOCATOR environment variable.
+  bool use_step_arena_allocator_ = false;
+
   std::vector<std::unique_ptr<FunctionInfo>> functions_
       TF_GUARDED_BY(executor_lock_);
 
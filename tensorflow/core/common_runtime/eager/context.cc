@@ -480,6 +480,7 @@ void EagerContext::ClearCachesAndDefaultExecutor() {
   {
     mutex_lock dl(device_cache_mu_);
     device_cache_.clear();
+    kernel_def_cache_.clear();
   }
   {
     mutex_lock ml(metadata_mu_);
@@ -1232,6 +1233,15 @@ Device* EagerContext::GetCachedDevice(Fprint128 device_cache_key) {
   return iter->second;
 }
 
+bool EagerContext::GetCachedKernelDef(Fprint128 kernel_def_cache_key,
+                                      const KernelDef** kernel_def) {
+  tf_shared_lock l(device_cache_mu_);
+  auto iter = kernel_def_cache_.find(kernel_def_cache_key);
+  if (iter == kernel_def_cache_.end()) return false;
+  *kernel_def = iter->second;
+  return true;
+}
+
 core::RefCountPtr<KernelAndDevice> EagerContext::AddKernelToCache(
     Fprint128 cache_key, core::RefCountPtr<KernelAndDevice> kernel) {
   mutex_lock ml(cache_mu_);
@@ -1262,6 +1272,12 @@ void EagerContext::AddDeviceToCache(Fprint128 device_cache_key,
   device_cache_[device_cache_key] = device;
 }
 
+void EagerContext::AddKernelDefToCache(Fprint128 kernel_def_cache_key,
+                                       const KernelDef* kernel_def) {
+  mutex_lock l(device_cache_mu_);
+  kernel_def_cache_[kernel_def_cache_key] = kernel_def;
+}
+
 bool EagerContext::ShouldStoreGraphs() { return should_store_graphs_.load(); }
 
 void EagerContext::SetShouldStoreGraphs(bool value) {
@@ -42,6 +42,7 @@ limitations under the License.
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/kernel_def.pb.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -282,10 +283,16 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
 
   core::RefCountPtr<KernelAndDevice> GetCachedKernel(Fprint128 cache_key);
   Device* GetCachedDevice(Fprint128 device_cache_key);
+  // Returns whether a lookup of the kernel def for `kernel_def_cache_key` is
+  // cached, and sets `kernel_def` to its result (which may be null).
+  bool GetCachedKernelDef(Fprint128 kernel_def_cache_key,
+                          const KernelDef** kernel_def);
 
   core::RefCountPtr<KernelAndDevice> AddKernelToCache(
       Fprint128 cache_key, core::RefCountPtr<KernelAndDevice> kernel);
   void AddDeviceToCache(Fprint128 device_cache_key, Device* device);
+  void AddKernelDefToCache(Fprint128 kernel_def_cache_key,
+                           const KernelDef* kernel_def);
 
   bool LogDevicePlacement() const { return log_device_placement_; }
   void SetLogDevicePlacement(bool enable) override {
@@ -783,6 +790,9 @@ class EagerContext : public ImmediateExecutionContext, public core::RefCounted {
       component_function_libraries_ TF_GUARDED_BY(cache_mu_);
   absl::flat_hash_map<Fprint128, Device*, Fprint128Hasher> device_cache_
       TF_GUARDED_BY(device_cache_mu_);
+  // Kernel defs are owned by the kernel registry.
+  absl::flat_hash_map<Fprint128, const KernelDef*, Fprint128Hasher>
+      kernel_def_cache_ TF_GUARDED_BY(device_cache_mu_);
   std::unordered_map<std::string, std::vector<std::function<void()>>>
       remove_function_notifiers_ TF_GUARDED_BY(remove_function_notifiers_mu_);
 
@@ -1303,21 +1303,26 @@ Status GetOrCreateKernelAndDevice(
   absl::flat_hash_map<string, const std::vector<string>*> composite_devices;
   std::unordered_map<int, DtypeAndPartialTensorShape>
       input_resource_variable_dtypes_and_shapes;
+  // The kernel def is only needed to run a primitive op as a function.
+  // Matching it against the registered kernels costs more than the rest of a
+  // cached dispatch, so lookups are cached by the attributes and device.
   const KernelDef* kernel_def = nullptr;
-  if (!op->is_function()) {
-    const NodeDef& node_def = op->MutableAttrs()->BuildNodeDef();
-    auto get_kernel_def = [](const EagerOperation& op, const NodeDef& node_def,
-                             const Device* op_device) -> const KernelDef* {
-      const KernelDef* kernel_def = nullptr;
-      Status s = FindKernelDef(DeviceType(op_device->device_type()), node_def,
-                               &kernel_def,
-                               /*kernel_class_name=*/nullptr);
-      if (!s.ok()) return nullptr;
-      return kernel_def;
-    };
-    kernel_def = get_kernel_def(*op, node_def, device);
-  }
   if (op->is_function() || ctx.RunEagerOpAsFunction()) {
+    if (!op->is_function()) {
+      const Fprint128 kernel_def_cache_key = tsl::FingerprintCat128(
+          op->MutableAttrs()->CacheKey(op->DeviceName()),
+          Fingerprint128(device->device_type()));
+      if (!ctx.GetCachedKernelDef(kernel_def_cache_key, &kernel_def)) {
+        const NodeDef& node_def = op->MutableAttrs()->BuildNodeDef();
+        if (!FindKernelDef(DeviceType(device->device_type()), node_def,
+                           &kernel_def,
+                           /*kernel_class_name=*/nullptr)
+                 .ok()) {
+          kernel_def = nullptr;
+        }
+        ctx.AddKernelDefToCache(kernel_def_cache_key, kernel_def);
+      }
+    }
     TF_RETURN_IF_ERROR(ExtractFunctionInputInfo(
         op, kernel_def, input_device_ptrs, composite_devices,
         input_resource_variable_dtypes_and_shapes));
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 namespace {
@@ -428,5 +429,80 @@ TEST(ExecuteTest, MultipleNestedCompiledFunction) {
   ctx->Unref();
 }
 
+TEST(ExecuteTest, EagerOperationAsFunctionCachesKernelDef) {
+  StaticDeviceMgr device_mgr(
+      DeviceFactory::NewDevice("CPU", {}, "/job:localhost/replica:0/task:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_EXPLICIT,
+      false, &device_mgr, false, nullptr, nullptr);
+  ctx->SetRunEagerOpAsFunction(true);
+
+  Tensor input_tensor = test::AsScalar<int64_t>(3);
+  auto input = core::RefCountPtr<ImmediateExecutionTensorHandle>(
+      ctx->CreateLocalHandleFromTFTensor(input_tensor,
+                                         ctx->HostCPUName().c_str()));
+  for (int i = 0; i < 2; ++i) {
+    auto op = std::make_unique<EagerOperation>(ctx);
+    TF_ASSERT_OK(op->Reset(
+        /*op=*/"Mul",
+        /*raw_device_name=*/"/job:localhost/replica:0/task:0/device:CPU:0"));
+    TF_ASSERT_OK(op->AddInput(input.get()));
+    TF_ASSERT_OK(op->AddInput(input.get()));
+
+    std::vector<TensorHandle*> retvals(1);
+    int num_retvals = retvals.size();
+    TF_ASSERT_OK(EagerExecute(op.get(), retvals.data(), &num_retvals));
+    const Tensor* output;
+    TF_ASSERT_OK(retvals[0]->Tensor(&output));
+    test::ExpectTensorEqual<int64_t>(*output, test::AsScalar<int64_t>(9));
+    retvals[0]->Unref();
+
+    const KernelDef* kernel_def = nullptr;
+    EXPECT_TRUE(ctx->GetCachedKernelDef(
+        tsl::FingerprintCat128(
+            op->MutableAttrs()->CacheKey(op->DeviceName()),
+            Fingerprint128(DEVICE_CPU)),
+        &kernel_def));
+    ASSERT_NE(kernel_def, nullptr);
+    EXPECT_EQ(kernel_def->op(), "Mul");
+  }
+  ctx->Unref();
+}
+
+// Measures the host overhead of dispatching a small op whose kernel is cached.
+void BM_EagerExecuteMul(::testing::benchmark::State& state) {
+  const bool run_eager_op_as_function = state.range(0);
+  StaticDeviceMgr device_mgr(
+      DeviceFactory::NewDevice("CPU", {}, "/job:localhost/replica:0/task:0"));
+  auto ctx = new EagerContext(
+      SessionOptions(),
+      tensorflow::ContextDevicePlacementPolicy::DEVICE_PLACEMENT_EXPLICIT,
+      false, &device_mgr, false, nullptr, nullptr);
+  ctx->SetRunEagerOpAsFunction(run_eager_op_as_function);
+
+  Tensor input_tensor = test::AsScalar<float>(3);
+  auto input = core::RefCountPtr<ImmediateExecutionTensorHandle>(
+      ctx->CreateLocalHandleFromTFTensor(input_tensor,
+                                         ctx->HostCPUName().c_str()));
+  auto op = std::make_unique<EagerOperation>(ctx);
+  std::vector<TensorHandle*> retvals(1);
+  for (auto s : state) {
+    TF_CHECK_OK(op->Reset(
+        /*op=*/"Mul",
+        /*raw_device_name=*/"/job:localhost/replica:0/task:0/device:CPU:0"));
+    TF_CHECK_OK(op->AddInput(input.get()));
+    TF_CHECK_OK(op->AddInput(input.get()));
+    int num_retvals = retvals.size();
+    TF_CHECK_OK(EagerExecute(op.get(), retvals.data(), &num_retvals));
+    retvals[0]->Unref();
+    op->Clear();
+  }
+  op.reset();
+  input.reset();
+  ctx->Unref();
+}
+BENCHMARK(BM_EagerExecuteMul)->Arg(0)->Arg(1);
+
 }  // namespace
 }  // namespace tensorflow
@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -50,6 +51,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/edgeset.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
@@ -62,6 +64,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
@@ -141,6 +144,28 @@ struct KernelTimer {
   }
 };
 
+// Counts of the closures that all executors have enqueued to, and dequeued
+// from, their runners. Aligned at 64 bytes to avoid false-sharing, assuming the
+// cacheline size is 64 bytes or smaller.
+alignas(64) std::atomic<int64_t> num_enqueued_tasks{0};
+alignas(64) std::atomic<int64_t> num_dequeued_tasks{0};
+
+// Returns the (approximate) number of closures that have been enqueued to a
+// runner but have not started yet.
+int64_t PendingTaskCount() {
+  return num_enqueued_tasks.load(std::memory_order_relaxed) -
+         num_dequeued_tasks.load(std::memory_order_relaxed);
+}
+
+// Returns a small, dense identifier for the calling thread. Used to pick the
+// work-stealing ready queue that the calling thread owns.
+int CurrentThreadQueueHint() {
+  static std::atomic<int> next_hint{0};
+  thread_local const int hint =
+      next_hint.fetch_add(1, std::memory_order_relaxed);
+  return hint;
+}
+
 // TODO(b/152925936): Re-evaluate these constants with current usage patterns.
 typedef absl::InlinedVector<TensorValue, 4UL> TensorValueVec;
 typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
@@ -151,7 +176,7 @@ class ExecutorImpl : public Executor {
 
   Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
-    kernel_stats_.Initialize(immutable_state_.graph_view());
+    kernel_stats_.Initialize(immutable_state_.graph_view(), graph);
     return absl::OkStatus();
   }
 
@@ -166,7 +191,7 @@ class ExecutorImpl : public Executor {
    public:
     KernelStats() = default;
 
-    void Initialize(const GraphView& gview) {
+    void Initialize(const GraphView& gview, const Graph& graph) {
       is_expensive_.resize(gview.num_nodes());
       cost_estimates_ =
           std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
@@ -177,6 +202,26 @@ class ExecutorImpl : public Executor {
           cost_estimates_[i] = kInitialCostEstimateCycles;
         }
       }
+
+      // Compute the number of nodes on the longest path from each node to the
+      // sink. Loop back edges are ignored, so that the remaining graph is
+      // acyclic and a post-order visits each node after its successors.
+      critical_path_lengths_.assign(gview.num_nodes(), 0);
+      const auto is_forward_edge = [](const Edge& e) {
+        return !e.src()->IsNextIteration();
+      };
+      std::vector<Node*> post_order;
+      GetPostOrder(graph, &post_order, /*stable_comparator=*/{},
+                   is_forward_edge);
+      for (const Node* n : post_order) {
+        int32_t length = 0;
+        for (const Edge* e : n->out_edges()) {
+          if (is_forward_edge(*e)) {
+            length = std::max(length, critical_path_lengths_[e->dst()->id()]);
+          }
+        }
+        critical_path_lengths_[n->id()] = length + 1;
+      }
     }
 
     // Returns true iff the given node is considered "expensive". The
@@ -193,6 +238,18 @@ class ExecutorImpl : public Executor {
       return is_expensive_[node.node_id];
     }
 
+    // Returns the current estimate of the cost (in CPU cycles) of the given
+    // node. Only meaningful if `HasExpensiveMarker(node)` is true.
+    uint64 CostEstimate(const NodeItem& node) const {
+      return cost_estimates_[node.node_id].load(std::memory_order_relaxed);
+    }
+
+    // Returns the number of nodes on the longest path from the given node to
+    // the sink, ignoring loop back edges.
+    int32_t CriticalPathLength(const NodeItem& node) const {
+      return critical_path_lengths_[node.node_id];
+    }
+
     // Updates the dynamic cost estimate, which is used to determine whether the
     // given node is expensive. The new cost estimate is a weighted average of
     // the old cost estimate and the latest cost. We only update cost estimates
@@ -221,6 +278,7 @@ class ExecutorImpl : public Executor {
     std::vector<bool> is_expensive_;
     // std::unique_ptr<std::atomic<bool>[]> is_expensive_;
     std::unique_ptr<std::atomic_uint_fast64_t[]> cost_estimates_;
+    std::vector<int32_t> critical_path_lengths_;
   };
 
   ImmutableExecutorState immutable_state_;
@@ -332,6 +390,11 @@ class ExecutorState {
                 NodeExecStatsInterface* stats,
                 TaggedNodeReadyQueue* inline_ready);
 
+  // Dispatches each of the expensive nodes in `nodes` to the runner. If the
+  // runner has a backlog, nodes whose cost estimate is small relative to the
+  // cost of a dispatch are batched into shared closures.
+  void DispatchExpensiveNodes(TaggedNodeSeq* nodes, int64_t scheduled_nsec);
+
   // Schedule all the expensive nodes in '*ready', and put all the inexpensive
   // nodes in 'ready' into 'inline_ready'.
   //
@@ -346,6 +409,34 @@ class ExecutorState {
   template <typename Closure>
   void RunTask(Closure&& c, int sample_rate = 0);
 
+  // The following methods implement the work-stealing dispatch mode, which is
+  // used iff `use_work_stealing_` is true.
+  //
+  // Adds `nodes` to the ready queue owned by the calling thread, or spreads
+  // them round-robin over all queues if `spread` is true, and starts enough
+  // worker closures to drain them.
+  void PushWorkStealingReadyNodes(const TaggedNodeSeq& nodes,
+                                  int64_t scheduled_nsec, bool spread);
+
+  // Moves one ready node into `*inline_ready`, preferring the most recently
+  // pushed node of queue `queue_id`, and otherwise stealing the oldest node of
+  // another queue. Returns false if all queues are empty.
+  bool PopWorkStealingReadyNode(int queue_id,
+                                TaggedNodeReadyQueue* inline_ready,
+                                int64_t* scheduled_nsec);
+
+  // Reserves a worker slot. Returns false if `max_work_stealing_workers_` are
+  // already active.
+  bool TryReserveWorkStealingWorker();
+
+  // Starts up to `num_ready` new workers, subject to the worker limit.
+  void MaybeStartWorkStealingWorkers(int64_t num_ready);
+
+  // The body of a worker closure: processes ready nodes until all queues are
+  // empty. Each active worker holds a reference on `num_outstanding_ops_`, so
+  // that the step cannot finish while a worker may still touch `this`.
+  void RunWorkStealingWorker();
+
   // Clean up when this executor is done.
   void Finish();
   void ScheduleFinish();
@@ -370,6 +461,11 @@ class ExecutorState {
   // TODO(fishx): Make it configurable if necessary.
   static constexpr uint64 kInlineScheduleReadyThreshold = 500;
 
+  // Minimum estimated cost (in CPU cycles) of the nodes in a closure created by
+  // `DispatchExpensiveNodes()`. Nodes that are cheaper than this are batched
+  // with their siblings when the runner has a backlog.
+  static constexpr uint64 kDispatchBatchCostCycles = 100 * 1000;
+
   // Not owned.
   RendezvousInterface* rendezvous_;
   CollectiveExecutor* collective_executor_ = nullptr;
@@ -395,10 +491,33 @@ class ExecutorState {
   absl::optional<ManagedStackTrace> stack_trace_ = absl::nullopt;
   // If not null, use this device to schedule intra-op operation
   std::unique_ptr<DeviceBase> user_device_;
+  // If not null, serves the allocations with default attributes of all kernels
+  // in the step. Released (and eventually deleted) when the step is done.
+  StepArenaAllocator* step_allocator_ = nullptr;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
+  // A ready queue owned by one worker thread. The owner pops at the back,
+  // other workers steal from the front. Aligned to avoid false sharing between
+  // the queues of different workers.
+  struct alignas(64) WorkStealingQueue {
+    mutex mu;
+    std::vector<std::pair<TaggedNode, int64_t>> nodes TF_GUARDED_BY(mu);
+    size_t front_index TF_GUARDED_BY(mu) = 0;
+    // Number of nodes in the queue, readable without `mu` so that thieves can
+    // skip empty queues cheaply.
+    std::atomic<int64_t> size{0};
+  };
+
+  const bool use_work_stealing_;
+  const int max_work_stealing_workers_;
+  std::unique_ptr<WorkStealingQueue[]> work_stealing_queues_;
+  // Number of nodes that have been (or are about to be) pushed to
+  // `work_stealing_queues_` and not yet popped.
+  std::atomic<int64_t> num_queued_nodes_{0};
+  std::atomic<int> num_active_workers_{0};
+
   PropagatorStateType propagator_;
 
   // Invoked when the execution finishes.
@@ -448,13 +567,30 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
       run_all_kernels_inline_(args.run_all_kernels_inline),
+      use_work_stealing_(args.use_work_stealing_ready_queues &&
+                         !args.run_all_kernels_inline),
+      max_work_stealing_workers_(
+          use_work_stealing_ ? std::max(1, port::MaxParallelism()) : 0),
       propagator_(immutable_state, step_id_, vlog_),
       num_outstanding_ops_(0) {
+  if (use_work_stealing_) {
+    work_stealing_queues_ =
+        std::make_unique<WorkStealingQueue[]>(max_work_stealing_workers_);
+  }
   if (args.user_intra_op_threadpool != nullptr) {
     Device* device = immutable_state_.params().device;
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (args.use_step_arena_allocator) {
+    Device* device = immutable_state_.params().device;
+    // Only CPU devices are known to return the same allocator for all default
+    // allocator attributes.
+    if (device->device_type() == DEVICE_CPU) {
+      step_allocator_ =
+          new StepArenaAllocator(device->GetAllocator(AllocatorAttributes()));
+    }
+  }
 }
 
 template <class PropagatorStateType>
@@ -462,33 +598,146 @@ ExecutorState<PropagatorStateType>::~ExecutorState() {
   if (device_context_) {
     device_context_->Unref();
   }
+  if (step_allocator_) {
+    step_allocator_->Release();
+  }
   delete slice_reader_cache_;
 }
 
 template <class PropagatorStateType>
 template <typename Closure>
 void ExecutorState<PropagatorStateType>::RunTask(Closure&& c, int sample_rate) {
-  // Align the atomic variables at 64 bytes to avoid false-sharing, assuming the
-  // cacheline size is 64 bytes or smaller.
-  alignas(64) static std::atomic<int64_t> num_enqueue_ops{0};
-  alignas(64) static std::atomic<int64_t> num_dequeue_ops{0};
-
-  auto n_enqueues = num_enqueue_ops.fetch_add(1, std::memory_order_relaxed);
+  auto n_enqueues = num_enqueued_tasks.fetch_add(1, std::memory_order_relaxed);
   // Sample the queue length on at least every 16 enqueue operations. This
   // amortizes the cost of metric updates across 16 operations.
   if (n_enqueues % std::max(16, sample_rate) == 0) {
-    auto n_dequeues = num_dequeue_ops.load(std::memory_order_relaxed);
+    auto n_dequeues = num_dequeued_tasks.load(std::memory_order_relaxed);
     metrics::UpdateGraphPendingQueueLength(n_enqueues - n_dequeues);
   }
 
   // mutable is needed because std::forward<Closure> in the lambda body may move
   // the Closure `c`.
   runner_([c = std::forward<Closure>(c)]() mutable {
-    num_dequeue_ops.fetch_add(1, std::memory_order_relaxed);
+    num_dequeued_tasks.fetch_add(1, std::memory_order_relaxed);
     std::forward<Closure>(c)();
   });
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::PushWorkStealingReadyNodes(
+    const TaggedNodeSeq& nodes, int64_t scheduled_nsec, bool spread) {
+  DCHECK(use_work_stealing_);
+  const int num_queues = max_work_stealing_workers_;
+  int queue_id = CurrentThreadQueueHint() % num_queues;
+  // Count the nodes before they become visible, so that a worker that is about
+  // to retire cannot miss them (see `RunWorkStealingWorker()`).
+  num_queued_nodes_.fetch_add(nodes.size());
+  if (spread) {
+    for (const TaggedNode& tagged_node : nodes) {
+      WorkStealingQueue& queue = work_stealing_queues_[queue_id];
+      {
+        mutex_lock l(queue.mu);
+        queue.nodes.emplace_back(tagged_node, scheduled_nsec);
+        queue.size.store(queue.nodes.size() - queue.front_index,
+                         std::memory_order_relaxed);
+      }
+      queue_id = (queue_id + 1) % num_queues;
+    }
+  } else {
+    WorkStealingQueue& queue = work_stealing_queues_[queue_id];
+    mutex_lock l(queue.mu);
+    for (const TaggedNode& tagged_node : nodes) {
+      queue.nodes.emplace_back(tagged_node, scheduled_nsec);
+    }
+    queue.size.store(queue.nodes.size() - queue.front_index,
+                     std::memory_order_relaxed);
+  }
+  MaybeStartWorkStealingWorkers(nodes.size());
+}
+
+template <class PropagatorStateType>
+bool ExecutorState<PropagatorStateType>::PopWorkStealingReadyNode(
+    int queue_id, TaggedNodeReadyQueue* inline_ready,
+    int64_t* scheduled_nsec) {
+  const int num_queues = max_work_stealing_workers_;
+  for (int i = 0; i < num_queues; ++i) {
+    WorkStealingQueue& queue =
+        work_stealing_queues_[(queue_id + i) % num_queues];
+    if (queue.size.load(std::memory_order_relaxed) == 0) continue;
+    mutex_lock l(queue.mu);
+    if (queue.front_index == queue.nodes.size()) continue;
+    if (i == 0) {
+      // The most recently produced node is the most likely to find its inputs
+      // in the cache of this thread.
+      inline_ready->push_back(queue.nodes.back().first);
+      *scheduled_nsec = queue.nodes.back().second;
+      queue.nodes.pop_back();
+    } else {
+      inline_ready->push_back(queue.nodes[queue.front_index].first);
+      *scheduled_nsec = queue.nodes[queue.front_index].second;
+      ++queue.front_index;
+    }
+    if (queue.front_index == queue.nodes.size()) {
+      queue.nodes.clear();
+      queue.front_index = 0;
+    }
+    queue.size.store(queue.nodes.size() - queue.front_index,
+                     std::memory_order_relaxed);
+    num_queued_nodes_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+template <class PropagatorStateType>
+bool ExecutorState<PropagatorStateType>::TryReserveWorkStealingWorker() {
+  int num_active = num_active_workers_.load();
+  while (num_active < max_work_stealing_workers_) {
+    if (num_active_workers_.compare_exchange_weak(num_active, num_active + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::MaybeStartWorkStealingWorkers(
+    int64_t num_ready) {
+  int num_new_workers = 0;
+  while (num_new_workers < num_ready && TryReserveWorkStealingWorker()) {
+    ++num_new_workers;
+  }
+  if (num_new_workers == 0) return;
+  // Take all the references before starting the first worker, because the
+  // step may finish (and delete `this`) as soon as the last reference is
+  // dropped.
+  num_outstanding_ops_.fetch_add(num_new_workers, std::memory_order_relaxed);
+  for (int i = 0; i < num_new_workers; ++i) {
+    RunTask([this]() { RunWorkStealingWorker(); },
+            /*sample_rate=*/num_new_workers);
+  }
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::RunWorkStealingWorker() {
+  const int queue_id = CurrentThreadQueueHint() % max_work_stealing_workers_;
+  TaggedNodeReadyQueue inline_ready;
+  int64_t scheduled_nsec = 0;
+  while (true) {
+    while (PopWorkStealingReadyNode(queue_id, &inline_ready, &scheduled_nsec)) {
+      ProcessInline(&inline_ready, scheduled_nsec);
+    }
+    // Retire this worker. A concurrent `PushWorkStealingReadyNodes()` either
+    // observes the released slot and starts a new worker, or its nodes are
+    // observed here and this worker carries on.
+    num_active_workers_.fetch_sub(1);
+    if (num_queued_nodes_.load() == 0 || !TryReserveWorkStealingWorker()) {
+      break;
+    }
+  }
+  if (num_outstanding_ops_.fetch_sub(1) == 1) ScheduleFinish();
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::RunAsync(Executor::DoneCallback done) {
   TaggedNodeSeq ready;
@@ -760,6 +1009,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   params->start_time_usecs = start_time_usecs_;
   params->deadline = deadline_;
   params->log_memory = log_memory_;
+  params->step_allocator = step_allocator_;
   params->rendezvous = rendezvous_;
   params->collective_executor = collective_executor_;
   params->session_config = session_config_;
@@ -1263,6 +1513,53 @@ bool ExecutorState<PropagatorStateType>::NodeDone(
   }
 }
 
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::DispatchExpensiveNodes(
+    TaggedNodeSeq* nodes, int64_t scheduled_nsec) {
+  // While the runner has idle capacity, one closure per node maximizes
+  // parallelism. Otherwise more closures only add queueing overhead, and the
+  // cheaper nodes are better off sharing a closure.
+  if (nodes->size() == 1 || PendingTaskCount() <= 0) {
+    for (auto& tagged_node : *nodes) {
+      RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
+                        scheduled_nsec),
+              /*sample_rate=*/nodes->size());
+    }
+    return;
+  }
+
+  // Start the nodes on the longest paths first.
+  std::stable_sort(nodes->begin(), nodes->end(),
+                   [this](const TaggedNode& a, const TaggedNode& b) {
+                     return kernel_stats_->CriticalPathLength(*a.node_item) >
+                            kernel_stats_->CriticalPathLength(*b.node_item);
+                   });
+  auto run_batch = [this, scheduled_nsec](TaggedNodeReadyQueue batch) {
+    RunTask([this, batch = std::move(batch), scheduled_nsec]() mutable {
+      ProcessInline(&batch, scheduled_nsec);
+    });
+  };
+  TaggedNodeReadyQueue batch;
+  uint64 batch_cost = 0;
+  for (auto& tagged_node : *nodes) {
+    const uint64 cost = kernel_stats_->CostEstimate(*tagged_node.node_item);
+    if (cost >= kDispatchBatchCostCycles) {
+      RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
+                        scheduled_nsec),
+              /*sample_rate=*/nodes->size());
+      continue;
+    }
+    batch.push_back(tagged_node);
+    batch_cost += cost;
+    if (batch_cost >= kDispatchBatchCostCycles) {
+      run_batch(std::move(batch));
+      batch = TaggedNodeReadyQueue();
+      batch_cost = 0;
+    }
+  }
+  if (!batch.empty()) run_batch(std::move(batch));
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleReady(
     TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready) {
@@ -1298,6 +1595,33 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         inline_ready->push_back(tagged_node);
       }
     }
+  } else if (use_work_stealing_) {
+    if (inline_ready == nullptr) {
+      // There is no worker on this thread, so spread the nodes over all queues
+      // to let the workers pick them up without contending on one queue.
+      PushWorkStealingReadyNodes(*ready, scheduled_nsec, /*spread=*/true);
+    } else {
+      // As above, run inexpensive nodes and one expensive node inline, and
+      // keep the remaining expensive nodes on this thread's queue, from which
+      // idle workers may steal them.
+      TaggedNodeSeq expensive_nodes;
+      for (auto& tagged_node : *ready) {
+        const NodeItem& item = *tagged_node.node_item;
+        if (tagged_node.get_is_dead() || !kernel_stats_->IsExpensive(item)) {
+          inline_ready->push_back(tagged_node);
+        } else {
+          expensive_nodes.push_back(tagged_node);
+        }
+      }
+      if (!expensive_nodes.empty() && inline_ready->empty()) {
+        inline_ready->push_back(expensive_nodes.back());
+        expensive_nodes.pop_back();
+      }
+      if (!expensive_nodes.empty()) {
+        PushWorkStealingReadyNodes(expensive_nodes, scheduled_nsec,
+                                   /*spread=*/false);
+      }
+    }
   } else {
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
@@ -1313,11 +1637,17 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         if (tagged_node.get_is_dead() || !kernel_stats_->IsExpensive(item)) {
           // Inline this inexpensive node.
           inline_ready->push_back(tagged_node);
-        } else {
-          if (curr_expensive_node) {
-            expensive_nodes.push_back(*curr_expensive_node);
-          }
+        } else if (curr_expensive_node == nullptr) {
+          curr_expensive_node = &tagged_node;
+        } else if (kernel_stats_->CriticalPathLength(item) >
+                   kernel_stats_->CriticalPathLength(
+                       *curr_expensive_node->node_item)) {
+          // Prefer to keep the node on the longest path on this thread, which
+          // saves it a dispatch.
+          expensive_nodes.push_back(*curr_expensive_node);
           curr_expensive_node = &tagged_node;
+        } else {
+          expensive_nodes.push_back(tagged_node);
         }
       }
     }
@@ -1332,11 +1662,7 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
     }
     if (!expensive_nodes.empty()) {
       if (expensive_nodes.size() < kInlineScheduleReadyThreshold) {
-        for (auto& tagged_node : expensive_nodes) {
-          RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
-                            scheduled_nsec),
-                  /*sample_rate=*/expensive_nodes.size());
-        }
+        DispatchExpensiveNodes(&expensive_nodes, scheduled_nsec);
       } else {
         // There are too many ready expensive nodes. Schedule them in child
         // threads.
@@ -125,6 +125,21 @@ class Executor {
     // If true, all kernels will be treated as "inexpensive", and hence executed
     // on the scheduling thread.
     bool run_all_kernels_inline = false;
+
+    // If true, expensive ready nodes are not dispatched to `runner` one closure
+    // at a time. Instead, the step keeps a small set of per-thread ready queues
+    // that are drained by a bounded number of worker closures, which steal
+    // from each other when their own queue is empty. This reduces contention
+    // on the `runner` queue for wide graphs, and keeps ready nodes on the
+    // thread that produced their inputs. Ignored if `run_all_kernels_inline`
+    // is true.
+    bool use_work_stealing_ready_queues = false;
+
+    // If true, and the executor runs on a CPU device, small allocations made by
+    // kernels through `OpKernelContext::get_allocator()` with default
+    // attributes are served from blocks owned by the step, rather than by a
+    // call to the device allocator each. See "step_arena_allocator.h".
+    bool use_step_arena_allocator = false;
   };
   typedef std::function<void(const Status&)> DoneCallback;
 
@@ -101,6 +101,7 @@ class ExecutorTest : public ::testing::Test {
     args.rendezvous = rendez;
     args.stats_collector = &step_stats_collector_;
     args.runner = runner_;
+    args.use_work_stealing_ready_queues = use_work_stealing_ready_queues_;
     return exec_->Run(args);
   }
 
@@ -111,6 +112,7 @@ class ExecutorTest : public ::testing::Test {
   StepStats step_stats_;
   Executor::Args::Runner runner_;
   Rendezvous* rendez_ = nullptr;
+  bool use_work_stealing_ready_queues_ = false;
 };
 
 // A float val -> Tensor<float>
@@ -439,6 +441,24 @@ TEST_F(ExecutorTest, NoInputTensors) {
   TF_ASSERT_OK(Run(rendez_));
 }
 
+TEST_F(ExecutorTest, RandomTreeWorkStealing) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g));
+  use_work_stealing_ready_queues_ = true;
+  Rendezvous::Args args;
+  for (int i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(
+        rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(4096.0, V(out));
+  }
+}
+
 // Create a graph that is 'depth' deep. At each level, fan-in and fan-out a
 // maximum of 'width' nodes. All nodes are no-ops and all dependencies are
 // control dependencies.
@@ -493,6 +513,70 @@ BENCHMARK(BM_executor)->UseRealTime()->ArgPair(8192, 32);
 // Tall fat graph
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 1024);
 
+// Measures the step latency of a wide graph of `width` independent chains of
+// small matmuls, on an inter-op threadpool with `num_threads` threads, with and
+// without work-stealing ready queues.
+static void BM_executor_work_stealing(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const bool use_work_stealing = state.range(1);
+  constexpr int kWidth = 1024;
+  constexpr int kDepth = 8;
+
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Tensor t(DT_FLOAT, TensorShape({16, 16}));
+  t.flat<float>().setConstant(0.01f);
+  for (int i = 0; i < kWidth; ++i) {
+    Node* n = test::graph::Constant(g.get(), t);
+    for (int j = 0; j < kDepth; ++j) {
+      n = test::graph::Matmul(g.get(), n, n, false, false);
+    }
+  }
+  FixupSourceAndSinkEdges(g.get());
+
+  std::unique_ptr<Device> device = DeviceFactory::NewDevice(
+      "CPU", {}, "/job:localhost/replica:0/task:0");
+  const int version = g->versions().producer();
+  LocalExecutorParams params;
+  params.device = device.get();
+  params.create_kernel =
+      [&device, version](const std::shared_ptr<const NodeProperties>& props,
+                         OpKernel** kernel) {
+        return CreateNonCachedKernel(device.get(), nullptr, props, version,
+                                     kernel);
+      };
+  params.delete_kernel = [](OpKernel* kernel) {
+    DeleteNonCachedKernel(kernel);
+  };
+  Executor* exec = nullptr;
+  TF_CHECK_OK(NewLocalExecutor(params, *g, &exec));
+  std::unique_ptr<Executor> exec_holder(exec);
+
+  thread::ThreadPool pool(Env::Default(), "inter_op", num_threads);
+  Executor::Args args;
+  args.runner = [&pool](std::function<void()> fn) {
+    pool.Schedule(std::move(fn));
+  };
+  args.use_work_stealing_ready_queues = use_work_stealing;
+  // Warm up the kernel cost estimates.
+  for (int i = 0; i < 3; ++i) {
+    TF_CHECK_OK(exec->Run(args));
+  }
+
+  for (auto s : state) {
+    TF_CHECK_OK(exec->Run(args));
+  }
+  state.SetLabel(use_work_stealing ? "work_stealing" : "default");
+  state.SetItemsProcessed(kWidth * kDepth *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_executor_work_stealing)
+    ->UseRealTime()
+    ->ArgPair(64, 0)
+    ->ArgPair(64, 1)
+    ->ArgPair(128, 0)
+    ->ArgPair(128, 1);
+
 static void BM_const_identity(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int outputs_per_const = state.range(1);
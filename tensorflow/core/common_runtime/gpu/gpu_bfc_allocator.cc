@@ -15,14 +15,17 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_bfc_allocator.h"
 
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/strings/numbers.h"
 #include "xla/tsl/framework/bfc_allocator.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
 
 namespace tensorflow {
 
@@ -80,6 +83,36 @@ bool GetGarbageCollectionValue() {
       << " Using the default value \"true\".";
   return true;
 }
+
+size_t GetThreadCacheMaxChunkSizeValue() {
+  const char* thread_cache_max_chunk_size =
+      std::getenv("TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_SIZE");
+  if (thread_cache_max_chunk_size == nullptr) {
+    // By default, don't use thread caches.
+    return 0;
+  }
+  size_t value;
+  if (absl::SimpleAtoi(thread_cache_max_chunk_size, &value)) {
+    return value;
+  }
+
+  LOG(ERROR)
+      << "The TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_SIZE environment variable is"
+      << " set but could not be parsed: \"" << thread_cache_max_chunk_size
+      << "\". Valid values are non-negative byte counts."
+      << " Using the default value 0.";
+  return 0;
+}
+
+std::string GetAllocationTraceFile(const std::string& allocator_name) {
+  const char* allocation_trace_dir =
+      std::getenv("TF_GPU_BFC_ALLOCATION_TRACE_DIR");
+  if (allocation_trace_dir == nullptr) {
+    return "";
+  }
+  return tsl::io::JoinPath(allocation_trace_dir,
+                           allocator_name + ".bfctrace");
+}
 }  // anonymous namespace
 
 GPUBFCAllocator::GPUBFCAllocator(
@@ -95,6 +128,12 @@ GPUBFCAllocator::GPUBFCAllocator(
           o.garbage_collection = GetGarbageCollectionValue();
         }
         o.fragmentation_fraction = opts.fragmentation_fraction;
+        if (opts.thread_cache_max_chunk_size.has_value()) {
+          o.thread_cache_max_chunk_size = *opts.thread_cache_max_chunk_size;
+        } else {
+          o.thread_cache_max_chunk_size = GetThreadCacheMaxChunkSizeValue();
+        }
+        o.allocation_trace_file = GetAllocationTraceFile(name);
         return o;
       }()) {}
 
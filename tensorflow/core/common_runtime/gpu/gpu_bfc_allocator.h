@@ -46,6 +46,10 @@ class GPUBFCAllocator : public tsl::BFCAllocator {
 
     double fragmentation_fraction = 0;
     bool allow_retry_on_failure = true;
+
+    // If nullopt, defaults to TF_GPU_BFC_THREAD_CACHE_MAX_CHUNK_SIZE, or 0
+    // (no thread caches) if that envvar is not present.
+    std::optional<size_t> thread_cache_max_chunk_size;
   };
 
   GPUBFCAllocator(std::unique_ptr<tsl::SubAllocator> sub_allocator,
@@ -299,6 +299,87 @@ TEST_P(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   }
 }
 
+TEST_P(GPUBFCAllocatorTest, ThreadCacheReusesFreedChunks) {
+  GPUBFCAllocator::Options opts;
+  opts.thread_cache_max_chunk_size = 1 << 20;
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 30, "GPU_0_bfc", opts);
+
+  void* p1 = a.AllocateRaw(1, 4096);
+  a.DeallocateRaw(p1);
+  // Cached chunks are accounted as free.
+  CheckStats(&a, 1, 0, 4096, 4096);
+
+  // Served from the thread cache, since the rounded size is the same.
+  void* p2 = a.AllocateRaw(1, 4000);
+  EXPECT_EQ(p1, p2);
+  EXPECT_EQ(4000, a.RequestedSize(p2));
+  EXPECT_EQ(4096, a.AllocatedSize(p2));
+  CheckStats(&a, 2, 4096, 4096, 4096);
+
+  // A cached chunk is never split, so it cannot serve a much smaller request.
+  a.DeallocateRaw(p2);
+  void* p3 = a.AllocateRaw(1, 256);
+  EXPECT_NE(p1, p3);
+  a.DeallocateRaw(p3);
+  CheckStats(&a, 3, 0, 4096, 4096);
+}
+
+TEST_P(GPUBFCAllocatorTest, ThreadCacheIsFlushedBeforeFailing) {
+  GPUBFCAllocator::Options opts;
+  opts.thread_cache_max_chunk_size = 1 << 20;
+  // Configure a 2MiB byte limit
+  GPUBFCAllocator a(GetParam()(1ull << 32), 2 << 20, "GPU_0_bfc", opts);
+
+  // The freed chunk is cached, so it is not coalesced with the rest of the
+  // region.
+  void* p1 = a.AllocateRaw(1, 1 << 20);
+  ASSERT_NE(nullptr, p1);
+  a.DeallocateRaw(p1);
+
+  void* p2 = a.AllocateRaw(1, 2 << 20);
+  EXPECT_NE(nullptr, p2);
+  a.DeallocateRaw(p2);
+}
+
+TEST_P(GPUBFCAllocatorTest, ThreadCacheConcurrentAllocations) {
+  GPUBFCAllocator::Options opts;
+  opts.thread_cache_max_chunk_size = 1 << 16;
+  GPUBFCAllocator a(GetParam()(1ull << 32), 1 << 30, "GPU_0_bfc", opts);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIterations = 1000;
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int t = 0; t < kNumThreads; t++) {
+      pool.Schedule([&a, t]() {
+        random::PhiloxRandom philox(123, t);
+        random::SimplePhilox rand(&philox);
+        std::vector<void*> live;
+        for (int i = 0; i < kNumIterations; i++) {
+          size_t size = 256 + rand.Rand32() % (1 << 17);
+          void* p = a.AllocateRaw(1, size);
+          ASSERT_NE(nullptr, p);
+          ASSERT_EQ(size, a.RequestedSize(p));
+          live.push_back(p);
+          if (live.size() > 4) {
+            size_t index = rand.Rand32() % live.size();
+            a.DeallocateRaw(live[index]);
+            live.erase(live.begin() + index);
+          }
+        }
+        for (void* p : live) {
+          a.DeallocateRaw(p);
+        }
+      });
+    }
+  }
+
+  std::optional<AllocatorStats> stats = a.GetStats();
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->num_allocs, kNumThreads * kNumIterations);
+  EXPECT_EQ(stats->bytes_in_use, 0);
+}
+
 TEST_P(GPUBFCAllocatorTest, DISABLED_AllocatorReceivesZeroMemory) {
   GPUBFCAllocator a(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
   GPUBFCAllocator b(GetParam()(1ul << 62), 1UL << 60, "GPU_0_bfc", {});
@@ -330,11 +411,13 @@ BENCHMARK(BM_Allocation);
 static void BM_AllocationThreaded(::testing::benchmark::State& state) {
   int num_threads = state.range(0);
   int sub_iters = 500;  // Pick a reasonably large number.
+  GPUBFCAllocator::Options opts;
+  opts.thread_cache_max_chunk_size = state.range(1);
 
   for (auto s : state) {
     state.PauseTiming();
     GPUBFCAllocator a(CreateSubAllocator(1ul << 36), 1uLL << 33, "GPU_0_bfc",
-                      {});
+                      opts);
     thread::ThreadPool pool(Env::Default(), "test", num_threads);
 
     std::atomic_int_fast32_t count(sub_iters);
@@ -369,7 +452,13 @@ static void BM_AllocationThreaded(::testing::benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_AllocationThreaded)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_AllocationThreaded)
+    ->ArgPair(1, 0)
+    ->ArgPair(4, 0)
+    ->ArgPair(16, 0)
+    ->ArgPair(1, 1 << 20)
+    ->ArgPair(4, 1 << 20)
+    ->ArgPair(16, 1 << 20);
 
 // A more complex benchmark that defers deallocation of an object for
 // "delay" allocations.
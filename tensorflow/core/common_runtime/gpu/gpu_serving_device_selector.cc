@@ -52,17 +52,34 @@ GpuServingDeviceSelector::GpuServingDeviceSelector(
 tsl::DeviceReservation GpuServingDeviceSelector::ReserveDevice(
     absl::string_view program_fingerprint) {
   absl::MutexLock lock(&mu_);
-  DeviceStates device_states;
-  device_states.states = absl::Span<const DeviceState>(device_states_);
   auto [it, emplaced] =
       execution_info_.try_emplace(program_fingerprint, ExecutionInfo());
+
+  // Predicts when each device would complete the program, from the estimated
+  // execution times of the programs queued on it and of this program.
+  const int64_t now_ns = NowNs();
+  const int64_t min_exec_time = min_exec_time_.value_or(kDefaultEstimateNs);
+  const int64_t program_time_ns =
+      std::max(it->second.MaybeGetValidTime(/*result=*/0), min_exec_time);
+  absl::FixedArray<int64_t, 8> estimated_completion_ns(device_states_.size());
+  for (int i = 0; i < device_states_.size(); ++i) {
+    estimated_completion_ns[i] =
+        ServingDeviceSelector::EstimateTimeTillIdleNs(
+            device_states_[i], /*priority=*/0, min_exec_time, now_ns) +
+        program_time_ns;
+  }
+
+  DeviceStates device_states;
+  device_states.states = absl::Span<const DeviceState>(device_states_);
+  device_states.estimated_completion_ns =
+      absl::Span<const int64_t>(estimated_completion_ns);
   const int device_index =
       device_selector_policy_->SelectDevice(program_fingerprint, device_states);
 
   ServingDeviceSelector::EnqueueHelper(
       device_states_.at(device_index), device_index, it->second,
       program_fingerprint, /*priority=*/0, req_id_counter_++,
-      /*priority_queue_count=*/1, /*prefetch_results=*/0, NowNs());
+      /*priority_queue_count=*/1, /*prefetch_results=*/0, now_ns);
 
   return tsl::DeviceReservation(device_index, this);
 }
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "absl/time/clock.h"
@@ -67,6 +68,38 @@ TEST(GpuServingDeviceSelector, Basic) {
   EXPECT_EQ(reservation.device_index(), 0);
 }
 
+TEST(GpuServingDeviceSelector, EarliestCompletionPolicy) {
+  ServingDeviceSelectorTestHelper helper;
+  GpuServingDeviceSelector selector(
+      /*num_devices=*/2, std::make_unique<tsl::EarliestCompletionPolicy>());
+
+  // Records the execution times of a long and a short program. Only the
+  // second program of a device's queue is timed, as the first one may have
+  // waited for the host.
+  selector.Enqueue(0, "long");
+  selector.Enqueue(0, "long");
+  helper.ElapseNs(16e6);
+  selector.Completed(0, false);
+  helper.ElapseNs(16e6);
+  selector.Completed(0, false);
+  selector.Enqueue(1, "short");
+  selector.Enqueue(1, "short");
+  helper.ElapseNs(1e6);
+  selector.Completed(1, false);
+  helper.ElapseNs(1e6);
+  selector.Completed(1, false);
+
+  // With a long program running on one device, the short programs go to the
+  // other device until it has as much queued work.
+  tsl::DeviceReservation long_program = selector.ReserveDevice("long");
+  const int long_device = long_program.device_index();
+  std::vector<tsl::DeviceReservation> short_programs;
+  for (int i = 0; i < 10; ++i) {
+    short_programs.push_back(selector.ReserveDevice("short"));
+    EXPECT_NE(short_programs.back().device_index(), long_device);
+  }
+}
+
 TEST(GpuServingDeviceSelector, DefaultPolicyOnlyEnqueueCall) {
   ServingDeviceSelectorTestHelper helper;
   auto policy = std::make_unique<tsl::RoundRobinPolicy>();
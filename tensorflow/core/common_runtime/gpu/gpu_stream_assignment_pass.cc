@@ -0,0 +1,248 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_assignment_pass.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
+#include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Smaller branches do not make up for the copies to and from another stream.
+constexpr int kMinBranchSize = 4;
+
+// Forks with more consumers are left alone, so that a consumer is a bit of a
+// mask.
+constexpr int kMaxForkConsumers = 64;
+
+// Bounds the nodes visited tracing the forks of one graph.
+constexpr int64_t kMaxVisitedNodes = int64_t{1} << 24;
+
+// Returns whether `node`, placed on `device`, can run on another virtual
+// device of the same GPU with only its tensors crossing devices.
+bool IsMovable(const Node* node, const string& device) {
+  if (!node->IsOp() || node->assigned_device_name() != device) return false;
+  if (node->op_def().is_stateful() || node->IsControlFlow() ||
+      node->IsSend() || node->IsRecv() || node->IsArg() || node->IsRetval() ||
+      node->IsFunctionCall() || node->IsCollective() ||
+      node->IsScopedAllocator()) {
+    return false;
+  }
+  if (node->attrs().Find(kColocationAttrName) != nullptr) return false;
+  // Resources and variants may only be usable on the device that made them.
+  auto is_pinned = [](DataType dtype) {
+    return IsRefType(dtype) || dtype == DT_RESOURCE || dtype == DT_VARIANT;
+  };
+  return std::none_of(node->input_types().begin(), node->input_types().end(),
+                      is_pinned) &&
+         std::none_of(node->output_types().begin(),
+                      node->output_types().end(), is_pinned);
+}
+
+int FindRoot(std::vector<int>& parents, int i) {
+  while (parents[i] != i) {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+struct Branch {
+  std::vector<Node*> nodes;
+  // Position of the first node of the branch in the topological order, to
+  // break ties deterministically.
+  int first = 0;
+};
+
+}  // namespace
+
+Status AssignBranchesToVirtualDevices(
+    const std::vector<std::vector<string>>& virtual_devices,
+    int min_branch_size, Graph* graph) {
+  for (const Node* node : graph->op_nodes()) {
+    // Moving ops of a v1 while loop would need control loops on each device.
+    if (node->IsEnter()) {
+      VLOG(1) << "Not assigning branches to streams in a graph with loops";
+      return absl::OkStatus();
+    }
+  }
+
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  std::vector<int> position(graph->num_node_ids(), 0);
+  for (int i = 0; i < order.size(); ++i) position[order[i]->id()] = i;
+
+  int64_t visited = 0;
+  for (const std::vector<string>& devices : virtual_devices) {
+    if (devices.size() < 2) continue;
+    const string& primary = devices[0];
+    for (int i = 0; i < order.size(); ++i) {
+      Node* fork = order[i];
+      if (fork->assigned_device_name() != primary) continue;
+
+      std::vector<Node*> consumers;
+      for (const Edge* edge : fork->out_edges()) {
+        if (!edge->IsControlEdge() && IsMovable(edge->dst(), primary) &&
+            std::find(consumers.begin(), consumers.end(), edge->dst()) ==
+                consumers.end()) {
+          consumers.push_back(edge->dst());
+        }
+      }
+      const int num_consumers = consumers.size();
+      if (num_consumers < 2 || num_consumers > kMaxForkConsumers) continue;
+
+      visited += order.size() - i;
+      if (visited > kMaxVisitedNodes) {
+        VLOG(1) << "Stopped assigning branches to streams after visiting "
+                << visited << " nodes";
+        return absl::OkStatus();
+      }
+
+      // The consumers of the fork each node is reachable from.
+      absl::flat_hash_map<int, uint64_t> reachable_from;
+      for (int c = 0; c < num_consumers; ++c) {
+        reachable_from[consumers[c]->id()] |= uint64_t{1} << c;
+      }
+      for (int j = i + 1; j < order.size(); ++j) {
+        auto it = reachable_from.find(order[j]->id());
+        if (it == reachable_from.end()) continue;
+        const uint64_t mask = it->second;
+        for (const Edge* edge : order[j]->out_edges()) {
+          reachable_from[edge->dst()->id()] |= mask;
+        }
+      }
+
+      // Consumers whose paths meet before the paths of all consumers do are
+      // in the same branch.
+      const uint64_t all = num_consumers == 64
+                               ? ~uint64_t{0}
+                               : (uint64_t{1} << num_consumers) - 1;
+      std::vector<int> parents(num_consumers);
+      std::iota(parents.begin(), parents.end(), 0);
+      for (const auto& [id, mask] : reachable_from) {
+        if (mask == all) continue;
+        const int first = absl::countr_zero(mask);
+        for (int c = first + 1; c < num_consumers; ++c) {
+          if (mask & (uint64_t{1} << c)) {
+            parents[FindRoot(parents, c)] = FindRoot(parents, first);
+          }
+        }
+      }
+
+      std::map<int, Branch> branches;
+      for (const auto& [id, mask] : reachable_from) {
+        Node* node = graph->FindNodeId(id);
+        if (mask == all || !IsMovable(node, primary)) continue;
+        Branch& branch = branches[FindRoot(parents, absl::countr_zero(mask))];
+        if (branch.nodes.empty() || position[id] < branch.first) {
+          branch.first = position[id];
+        }
+        branch.nodes.push_back(node);
+      }
+      std::vector<Branch*> candidates;
+      for (auto& [root, branch] : branches) {
+        if (branch.nodes.size() >= min_branch_size) {
+          candidates.push_back(&branch);
+        }
+      }
+      if (candidates.size() < 2) continue;
+
+      // Largest first, each on the least loaded device, so the largest stays
+      // on the primary device.
+      std::sort(candidates.begin(), candidates.end(),
+                [](const Branch* a, const Branch* b) {
+                  if (a->nodes.size() != b->nodes.size()) {
+                    return a->nodes.size() > b->nodes.size();
+                  }
+                  return a->first < b->first;
+                });
+      std::vector<int64_t> loads(devices.size(), 0);
+      for (const Branch* branch : candidates) {
+        const int d =
+            std::min_element(loads.begin(), loads.end()) - loads.begin();
+        loads[d] += branch->nodes.size();
+        if (d == 0) continue;
+        VLOG(2) << "Assigning " << branch->nodes.size() << " ops after "
+                << fork->name() << " to " << devices[d];
+        for (Node* node : branch->nodes) {
+          node->set_assigned_device_name(devices[d]);
+        }
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+Status GpuStreamAssignmentPass::Run(
+    const GraphOptimizationPassOptions& options) {
+  bool enabled;
+  TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_GPU_ASSIGN_BRANCHES_TO_STREAMS",
+                                        /*default_val=*/false, &enabled));
+  if (!enabled || options.graph == nullptr || options.device_set == nullptr ||
+      options.device_set->client_device() == nullptr) {
+    return absl::OkStatus();
+  }
+
+  // The virtual devices of each local GPU, by TF device id.
+  const DeviceNameUtils::ParsedName& client_name =
+      options.device_set->client_device()->parsed_name();
+  std::map<int, std::map<int, string>> gpus;
+  for (const Device* device : options.device_set->devices()) {
+    const DeviceNameUtils::ParsedName& name = device->parsed_name();
+    if (device->device_type() != DEVICE_GPU ||
+        !DeviceNameUtils::IsSameAddressSpace(client_name, name)) {
+      continue;
+    }
+    tsl::PlatformDeviceId platform_device_id;
+    if (GpuIdManager::TfToPlatformDeviceId(tsl::TfDeviceId(name.id),
+                                           &platform_device_id)
+            .ok()) {
+      gpus[platform_device_id.value()][name.id] = device->name();
+    }
+  }
+  std::vector<std::vector<string>> virtual_devices;
+  for (const auto& [platform_device_id, devices] : gpus) {
+    if (devices.size() < 2) continue;
+    virtual_devices.emplace_back();
+    for (const auto& [tf_device_id, name] : devices) {
+      virtual_devices.back().push_back(name);
+    }
+  }
+  if (virtual_devices.empty()) return absl::OkStatus();
+  return AssignBranchesToVirtualDevices(virtual_devices, kMinBranchSize,
+                                        options.graph->get());
+}
+
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::POST_PLACEMENT, 0,
+                      GpuStreamAssignmentPass);
+
+}  // namespace tensorflow
@@ -0,0 +1,56 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_PASS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_PASS_H_
+
+#include <vector>
+
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Spreads independent branches of a graph over the compute streams of a GPU.
+//
+// A GPU split into virtual devices (GPUOptions.Experimental.virtual_devices)
+// has one compute stream per virtual device, but ops are placed on the first
+// one unless requested otherwise, so all their kernels run on one stream. For
+// every fork of a tensor on the first virtual device, this pass groups the
+// consumers whose paths meet before all of them do, which gives the
+// independent branches (e.g. towers or attention heads). It then moves the
+// movable ops of the branches to the other virtual devices, balancing their
+// number of ops. Partitioning inserts the Send/Recv pairs that synchronize the
+// streams and keep the tensors crossing them alive.
+//
+// Enabled with TF_GPU_ASSIGN_BRANCHES_TO_STREAMS=true.
+class GpuStreamAssignmentPass : public GraphOptimizationPass {
+ public:
+  Status Run(const GraphOptimizationPassOptions& options) override;
+};
+
+// Moves the branches of `graph` as described above. `virtual_devices` lists
+// the names of the virtual devices of each GPU, starting with the one ops are
+// placed on. Branches with fewer than `min_branch_size` movable ops are left
+// where they are.
+Status AssignBranchesToVirtualDevices(
+    const std::vector<std::vector<string>>& virtual_devices,
+    int min_branch_size, Graph* graph);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_STREAM_ASSIGNMENT_PASS_H_
@@ -0,0 +1,171 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_stream_assignment_pass.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/graph_def_builder_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/graph_def_builder.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/strcat.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+const char kGpu0[] = "/job:localhost/replica:0/task:0/device:GPU:0";
+const char kGpu1[] = "/job:localhost/replica:0/task:0/device:GPU:1";
+
+// Adds a chain of `length` Neg ops named `prefix`_i after `input`.
+Node* Chain(Node* input, const string& prefix, int length,
+            GraphDefBuilder* builder) {
+  for (int i = 0; i < length; ++i) {
+    input = ops::UnaryOp("Neg", input,
+                         builder->opts().WithName(strings::StrCat(prefix, i)));
+  }
+  return input;
+}
+
+std::unique_ptr<Graph> ToGraphOnGpu0(const GraphDefBuilder& builder) {
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  TF_CHECK_OK(GraphDefBuilderToGraph(builder, graph.get()));
+  for (Node* node : graph->op_nodes()) {
+    node->set_assigned_device_name(kGpu0);
+  }
+  return graph;
+}
+
+std::string DeviceOf(const Graph& graph, const std::string& name) {
+  for (const Node* node : graph.op_nodes()) {
+    if (node->name() == name) return node->assigned_device_name();
+  }
+  return "";
+}
+
+TEST(GpuStreamAssignmentPassTest, MovesIndependentTowers) {
+  GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+  Node* input = ops::SourceOp(
+      "Const", builder.opts()
+                   .WithName("input")
+                   .WithAttr("dtype", DT_FLOAT)
+                   .WithAttr("value", Tensor(1.0f)));
+  Node* a = Chain(input, "a", 5, &builder);
+  Node* b = Chain(input, "b", 4, &builder);
+  Node* sum = ops::BinaryOp("Add", a, b, builder.opts().WithName("sum"));
+  Chain(sum, "c", 4, &builder);
+  std::unique_ptr<Graph> graph = ToGraphOnGpu0(builder);
+
+  TF_ASSERT_OK(AssignBranchesToVirtualDevices({{kGpu0, kGpu1}},
+                                              /*min_branch_size=*/4,
+                                              graph.get()));
+
+  // The larger tower stays, the other one moves, and the ops after the towers
+  // meet stay.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(DeviceOf(*graph, strings::StrCat("a", i)), kGpu0);
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(DeviceOf(*graph, strings::StrCat("b", i)), kGpu1);
+    EXPECT_EQ(DeviceOf(*graph, strings::StrCat("c", i)), kGpu0);
+  }
+  EXPECT_EQ(DeviceOf(*graph, "input"), kGpu0);
+  EXPECT_EQ(DeviceOf(*graph, "sum"), kGpu0);
+}
+
+TEST(GpuStreamAssignmentPassTest, KeepsBranchesThatMeetEarlyTogether) {
+  // Two heads, each made of two paths from the input that meet in the head.
+  GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+  Node* input = ops::SourceOp(
+      "Const", builder.opts()
+                   .WithName("input")
+                   .WithAttr("dtype", DT_FLOAT)
+                   .WithAttr("value", Tensor(1.0f)));
+  std::vector<Node*> heads;
+  for (const char* head : {"h0", "h1"}) {
+    Node* q = Chain(input, strings::StrCat(head, "q"), 2, &builder);
+    Node* k = Chain(input, strings::StrCat(head, "k"), 2, &builder);
+    heads.push_back(ops::BinaryOp(
+        "Mul", q, k, builder.opts().WithName(strings::StrCat(head, "qk"))));
+  }
+  ops::BinaryOp("Add", heads[0], heads[1], builder.opts().WithName("sum"));
+  std::unique_ptr<Graph> graph = ToGraphOnGpu0(builder);
+
+  TF_ASSERT_OK(AssignBranchesToVirtualDevices({{kGpu0, kGpu1}},
+                                              /*min_branch_size=*/4,
+                                              graph.get()));
+
+  const std::string h0 = DeviceOf(*graph, "h0qk");
+  const std::string h1 = DeviceOf(*graph, "h1qk");
+  EXPECT_NE(h0, h1);
+  for (const char* head : {"h0", "h1"}) {
+    const std::string device = DeviceOf(*graph, strings::StrCat(head, "qk"));
+    for (const char* path : {"q0", "q1", "k0", "k1"}) {
+      EXPECT_EQ(DeviceOf(*graph, strings::StrCat(head, path)), device);
+    }
+  }
+  EXPECT_EQ(DeviceOf(*graph, "sum"), kGpu0);
+}
+
+TEST(GpuStreamAssignmentPassTest, LeavesResidualConnections) {
+  // The skip connection meets the other branch right away, so nothing runs
+  // alongside the long branch.
+  GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+  Node* input = ops::SourceOp(
+      "Const", builder.opts()
+                   .WithName("input")
+                   .WithAttr("dtype", DT_FLOAT)
+                   .WithAttr("value", Tensor(1.0f)));
+  Node* a = Chain(input, "a", 8, &builder);
+  ops::BinaryOp("Add", a, input, builder.opts().WithName("sum"));
+  std::unique_ptr<Graph> graph = ToGraphOnGpu0(builder);
+
+  TF_ASSERT_OK(AssignBranchesToVirtualDevices({{kGpu0, kGpu1}},
+                                              /*min_branch_size=*/4,
+                                              graph.get()));
+
+  for (const Node* node : graph->op_nodes()) {
+    EXPECT_EQ(node->assigned_device_name(), kGpu0) << node->name();
+  }
+}
+
+TEST(GpuStreamAssignmentPassTest, LeavesSmallBranches) {
+  GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+  Node* input = ops::SourceOp(
+      "Const", builder.opts()
+                   .WithName("input")
+                   .WithAttr("dtype", DT_FLOAT)
+                   .WithAttr("value", Tensor(1.0f)));
+  Node* a = Chain(input, "a", 3, &builder);
+  Node* b = Chain(input, "b", 3, &builder);
+  ops::BinaryOp("Add", a, b, builder.opts().WithName("sum"));
+  std::unique_ptr<Graph> graph = ToGraphOnGpu0(builder);
+
+  TF_ASSERT_OK(AssignBranchesToVirtualDevices({{kGpu0, kGpu1}},
+                                              /*min_branch_size=*/4,
+                                              graph.get()));
+
+  for (const Node* node : graph->op_nodes()) {
+    EXPECT_EQ(node->assigned_device_name(), kGpu0) << node->name();
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -27,6 +27,7 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/shape_refiner.h"
@@ -50,9 +51,12 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/public/version.h"
 
 namespace tensorflow {
@@ -63,6 +67,12 @@ namespace {
 // can skip expensive duplicates check in 'AddControlEdge'.
 static constexpr const bool kDoNotCheckDuplicates = true;
 
+// Below this many nodes, preparing the nodes in parallel does not pay for the
+// thread pool.
+constexpr int kMinNodesToPrepareInParallel = 1 << 14;
+// Rough cost of preparing a node, in cycles, e.g. to infer its types.
+constexpr int64_t kPrepareNodeCost = 10000;
+
 inline bool IsMerge(const NodeDef& node_def) {
   return node_def.op() == "Merge" || node_def.op() == "RefMerge" ||
          node_def.op() == "_XlaMerge";
@@ -222,6 +232,8 @@ class GraphConstructor {
   Status ValidateInputMapAndControlDependencies();
   Status BuildNodeIndex();
   Status InitFromEdges();
+  // Prepares the nodes in parallel for Convert(), if it is worth it.
+  Status PrepareNodes();
   Status Convert();
   Status AddBackEdges();
   Status UpdateVersionDef();
@@ -244,6 +256,8 @@ class GraphConstructor {
   Status IsNodeFullyMapped(const NodeDef& node_def, bool* is_node_mapped);
   Status ValidateColocationConstraints(const NodeDef& node_def);
   Status MakeNode(NodeDef&& node_def, Node** node);
+  Status MakeNode(Graph::PreparedNode&& prepared_node, Node** node);
+  void SetAssignedDevice(Node* node);
   Status MakeEdge(Node* src, int output_index, Node* dst, int input_index);
   Status ValidateShape(Node* node);
   Status ModifyNodeDefForImport(NodeDef* node_def);
@@ -298,7 +312,7 @@ class GraphConstructor {
   virtual const NodeDef& get_node_def(int i) const = 0;
   // Destructively reads the i^th node in the graph, avoiding a copy if
   // possible. After calling this method, the result of get_node_def(i) is
-  // undefined.
+  // undefined. May be called concurrently for different nodes.
   virtual NodeDef consume_node_def(int i) = 0;
   // Returns the version information for the graph, or nullptr if none is
   // available.
@@ -406,6 +420,10 @@ class GraphConstructor {
   };
   std::vector<EdgeInfo> back_edges_;
 
+  // The nodes prepared by PrepareNodes(), by index within node_defs_, or empty
+  // if the nodes are prepared by Convert() one at a time.
+  std::vector<std::optional<Graph::PreparedNode>> prepared_nodes_;
+
   GraphConstructor(const GraphConstructor&) = delete;
   void operator=(const GraphConstructor&) = delete;
 };
@@ -486,7 +504,9 @@ class NodeDefMovingGraphConstructor : public GraphConstructor {
   }
 
   GraphDef graph_def_;
-  std::vector<bool> is_consumed_;
+  // Not a std::vector<bool>, so that different NodeDefs can be consumed
+  // concurrently.
+  std::vector<char> is_consumed_;
 };
 
 bool ForwardCompatibilityWindowPassed(const VersionDef& versions) {
@@ -807,11 +827,22 @@ Status GraphConstructor::MakeNode(NodeDef&& node_def, Node** node) {
   Status status;
   *node = g_->AddNode(std::move(node_def), &status);
   if (!status.ok()) return status;
+  SetAssignedDevice(*node);
+  return absl::OkStatus();
+}
+
+Status GraphConstructor::MakeNode(Graph::PreparedNode&& prepared_node,
+                                  Node** node) {
+  *node = g_->AddNode(std::move(prepared_node));
+  SetAssignedDevice(*node);
+  return absl::OkStatus();
+}
+
+void GraphConstructor::SetAssignedDevice(Node* node) {
   if (opts_.expect_device_spec ||
-      (opts_.propagate_device_spec && !(*node)->def().device().empty())) {
-    (*node)->set_assigned_device_name((*node)->def().device());
+      (opts_.propagate_device_spec && !node->def().device().empty())) {
+    node->set_assigned_device_name(node->def().device());
   }
-  return absl::OkStatus();
 }
 
 Status GraphConstructor::ValidateShape(Node* node) {
@@ -1161,6 +1192,46 @@ GraphConstructor::CreateStackTracesForFunctionDefLibrary(
   }
 }
 
+Status GraphConstructor::PrepareNodes() {
+  // Importing rewrites the NodeDefs in topological order, before they can be
+  // prepared.
+  if (opts_.importing || node_def_count() < kMinNodesToPrepareInParallel) {
+    return absl::OkStatus();
+  }
+  const int num_nodes = node_def_count();
+  prepared_nodes_.resize(num_nodes);
+  std::vector<Status> statuses(num_nodes);
+  thread::ThreadPool pool(Env::Default(), "graph_constructor",
+                          port::MaxParallelism());
+  pool.ParallelFor(
+      num_nodes, kPrepareNodeCost, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          NodeDef node_def = consume_node_def(i);
+          const OpDef* op_def;
+          statuses[i] = g_->op_registry()->LookUpOpDef(node_def.op(), &op_def);
+          if (!statuses[i].ok()) continue;
+          if (opts_.add_default_attributes) {
+            AddDefaultsToNodeDef(*op_def, &node_def);
+          }
+          if (opts_.validate_nodes) {
+            statuses[i] = ValidateNodeDef(node_def, *op_def);
+            if (!statuses[i].ok()) continue;
+          }
+          absl::StatusOr<Graph::PreparedNode> prepared_node =
+              g_->PrepareNode(std::move(node_def));
+          if (!prepared_node.ok()) {
+            statuses[i] = prepared_node.status();
+            continue;
+          }
+          prepared_nodes_[i] = *std::move(prepared_node);
+        }
+      });
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
 Status GraphConstructor::Convert() {
   if (debug_info() != nullptr) {
     traces_ = LoadTracesFromDebugInfo(*debug_info());
@@ -1185,6 +1256,9 @@ Status GraphConstructor::Convert() {
         g_->AddFunctionLibrary(*std::move(library), library_traces));
   }
 
+  // Nodes may refer to the functions as well.
+  TF_RETURN_IF_ERROR(PrepareNodes());
+
   std::vector<InputInfo> inputs;
   int processed = 0;
 
@@ -1201,7 +1275,17 @@ Status GraphConstructor::Convert() {
     inputs.clear();
     bool has_data_back_edge = false;
 
-    NodeDef node_def = consume_node_def(o);
+    // Prepared nodes are final, so `mutable_node_def` is only modified (and
+    // `node_def` refers to it) if the node is not prepared.
+    std::optional<Graph::PreparedNode> prepared_node;
+    NodeDef mutable_node_def;
+    if (prepared_nodes_.empty()) {
+      mutable_node_def = consume_node_def(o);
+    } else {
+      prepared_node = std::move(prepared_nodes_[o]);
+    }
+    const NodeDef& node_def =
+        prepared_node.has_value() ? prepared_node->def() : mutable_node_def;
 
     // input_already_exists[i] is true iff the i-th input of the node we're
     // importing refers to a preexisting node in g_ (i.e. input[i] existed prior
@@ -1225,14 +1309,14 @@ Status GraphConstructor::Convert() {
 
       if (!opts_.input_map.empty()) {
         // Note that input_already_exists can shrink here
-        RemapNodeDefInputs(&node_def, &input_already_exists);
+        RemapNodeDefInputs(&mutable_node_def, &input_already_exists);
       }
       if (!opts_.control_dependencies.empty()) {
         // Note that input_already_exists can grow here
-        AddControlDependencies(&node_def, &input_already_exists);
+        AddControlDependencies(&mutable_node_def, &input_already_exists);
       }
       if (!opts_.default_device.empty() && node_def.device().empty()) {
-        node_def.set_device(opts_.default_device);
+        mutable_node_def.set_device(opts_.default_device);
       }
     }
 
@@ -1286,31 +1370,34 @@ Status GraphConstructor::Convert() {
     Node* node;
     if (opts_.importing) {
       if (!prefix_.empty()) {
-        AddPrefixToNodeDef(input_already_exists, &node_def);
+        AddPrefixToNodeDef(input_already_exists, &mutable_node_def);
       }
       // Note: no need to uniquify names if the prefix already guarantees
       // uniqueness
       if (opts_.uniquify_names && (prefix_.empty() || !opts_.uniquify_prefix)) {
-        UniquifyNames(input_already_exists, &node_def);
+        UniquifyNames(input_already_exists, &mutable_node_def);
       }
     }
 
-    if (opts_.importing) {
-      TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&node_def));
+    if (prepared_node.has_value()) {
+      TF_RETURN_IF_ERROR(MakeNode(*std::move(prepared_node), &node));
     } else {
-      const OpDef* op_def;
-      TF_RETURN_IF_ERROR(
-          g_->op_registry()->LookUpOpDef(node_def.op(), &op_def));
-      if (opts_.add_default_attributes) {
-        AddDefaultsToNodeDef(*op_def, &node_def);
-      }
-      if (opts_.validate_nodes) {
-        TF_RETURN_IF_ERROR(ValidateNodeDef(node_def, *op_def));
+      if (opts_.importing) {
+        TF_RETURN_IF_ERROR(ModifyNodeDefForImport(&mutable_node_def));
+      } else {
+        const OpDef* op_def;
+        TF_RETURN_IF_ERROR(
+            g_->op_registry()->LookUpOpDef(mutable_node_def.op(), &op_def));
+        if (opts_.add_default_attributes) {
+          AddDefaultsToNodeDef(*op_def, &mutable_node_def);
+        }
+        if (opts_.validate_nodes) {
+          TF_RETURN_IF_ERROR(ValidateNodeDef(mutable_node_def, *op_def));
+        }
       }
+      TF_RETURN_IF_ERROR(MakeNode(std::move(mutable_node_def), &node));
     }
 
-    TF_RETURN_IF_ERROR(MakeNode(std::move(node_def), &node));
-
     if (node != nullptr) {
       if (traces_.contains(node_name)) {
         node->SetStackTrace(traces_[node_name]);
@@ -1352,7 +1439,10 @@ Status GraphConstructor::Convert() {
                  << " NODES IN A CYCLE";
     for (int64_t i = 0; i < node_def_count(); i++) {
       if (pending_count_[i] != 0) {
-        LOG(WARNING) << "PENDING: " << SummarizeNodeDef(get_node_def(i))
+        LOG(WARNING) << "PENDING: "
+                     << SummarizeNodeDef(prepared_nodes_.empty()
+                                             ? get_node_def(i)
+                                             : prepared_nodes_[i]->def())
                      << " WITH PENDING COUNT = " << pending_count_[i];
       }
     }
@@ -3510,5 +3510,42 @@ TEST_F(GraphConstructorTest,
             "File \"delta.cc\", line 34, in jape");
 }
 
+TEST_F(GraphConstructorTest, ConvertLargeGraph) {
+  // Large enough for the nodes to be prepared in parallel.
+  constexpr int kNumNodes = 1 << 15;
+  GraphDef gdef;
+  NodeDef* params = gdef.add_node();
+  params->set_name("n0");
+  params->set_op("TestParams");
+  for (int i = 1; i < kNumNodes; ++i) {
+    NodeDef* node = gdef.add_node();
+    node->set_name(strings::StrCat("n", i));
+    node->set_op("TestOneInputOneOutput");
+    node->add_input(strings::StrCat("n", i - 1));
+    (*node->mutable_attr())["T"].set_type(DT_FLOAT);
+  }
+  NodeDef* default_attr = gdef.add_node();
+  default_attr->set_name("default_attr");
+  default_attr->set_op("TestDefaultAttr");
+
+  GraphConstructorOptions opts;
+  TF_ASSERT_OK(ConvertGraphDefToGraph(opts, gdef, &graph_));
+  EXPECT_EQ(graph_.num_op_nodes(), kNumNodes + 1);
+  EXPECT_TRUE(HasEdge("n0", 0, "n1", 0));
+  EXPECT_TRUE(HasEdge(strings::StrCat("n", kNumNodes - 2), 0,
+                      strings::StrCat("n", kNumNodes - 1), 0));
+  int value = 0;
+  TF_EXPECT_OK(
+      GetNodeAttr(FindNode("default_attr")->attrs(), "default_int", &value));
+  EXPECT_EQ(value, 31415);
+
+  // Errors found while preparing the nodes are reported as well.
+  gdef.mutable_node(kNumNodes / 2)->set_op("UnknownOp");
+  Graph graph(OpRegistry::Global());
+  Status s = ConvertGraphDefToGraph(opts, gdef, &graph);
+  EXPECT_FALSE(s.ok());
+  EXPECT_TRUE(absl::StrContains(s.message(), "Op type not registered")) << s;
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -17,6 +17,8 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/local_device.h"
 
+#include <algorithm>
+
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/common_runtime/process_util.h"
@@ -76,10 +78,16 @@ struct LocalDevice::EigenThreadPoolInfo {
     if (intra_op_parallelism_threads == 0) {
       static int env_num_threads = NumIntraOpThreadsFromEnvironment();
       intra_op_parallelism_threads = env_num_threads;
+    }
+    if (intra_op_parallelism_threads == 0) {
       // If no session setting or environment, compute a reasonable default.
-      if (intra_op_parallelism_threads == 0) {
-        intra_op_parallelism_threads = port::MaxParallelism(numa_node);
-      }
+      intra_op_parallelism_threads = port::MaxParallelism(numa_node);
+    } else if (numa_node != port::kNUMANoAffinity) {
+      // The setting is for the process, and there is one pool per NUMA node.
+      const int num_numa_nodes = port::NUMANumNodes();
+      intra_op_parallelism_threads =
+          std::max(1, (intra_op_parallelism_threads + num_numa_nodes - 1) /
+                          num_numa_nodes);
     }
     ThreadOptions thread_opts;
     thread_opts.numa_node = numa_node;
@@ -153,9 +161,15 @@ LocalDevice::LocalDevice(const SessionOptions& options,
   } else {
     // Each LocalDevice owns a separate ThreadPoolDevice for numerical
     // computations.
-    // TODO(tucker): NUMA for these too?
-    owned_tp_info_.reset(new LocalDevice::EigenThreadPoolInfo(
-        options, port::kNUMANoAffinity, nullptr));
+    if (options.config.experimental().use_numa_affinity()) {
+      int numa_node = attributes.locality().numa_node();
+      owned_tp_info_.reset(new LocalDevice::EigenThreadPoolInfo(
+          options, numa_node,
+          ProcessState::singleton()->GetCPUAllocator(numa_node)));
+    } else {
+      owned_tp_info_.reset(new LocalDevice::EigenThreadPoolInfo(
+          options, port::kNUMANoAffinity, nullptr));
+    }
     tp_info = owned_tp_info_.get();
   }
 
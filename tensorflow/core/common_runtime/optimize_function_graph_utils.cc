@@ -48,7 +48,9 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/util/debug_data_dumper.h"
 #include "tsl/platform/env.h"
@@ -232,18 +234,61 @@ absl::StatusOr<OptimizedFunctionGraphInfo> ReadFromCache(
   return optimized_function_graph_info_restored;
 }
 
+// Returns a fingerprint of what the optimized graph depends on besides the
+// function name: the definitions of the function and of the functions it
+// calls, the instantiation attrs and options, and the available devices.
+// Options that only hold per-process pointers or handles are left out.
+uint64 GetFileCacheFingerprint(
+    const FunctionDef& fdef, AttrSlice attrs,
+    const FunctionLibraryRuntime::InstantiateOptions& options,
+    const DeviceSet& dev_set, const FunctionLibraryDefinition& lib_def) {
+  const FunctionLibraryDefinition reachable_lib_def =
+      lib_def.ReachableDefinitions(fdef);
+  std::vector<string> function_names = reachable_lib_def.ListFunctionNames();
+  std::sort(function_names.begin(), function_names.end());
+  // The name of the function is left out like in GetFileCacheName.
+  FunctionDef unnamed_fdef = fdef;
+  unnamed_fdef.mutable_signature()->clear_name();
+  string serialized;
+  SerializeToStringDeterministic(unnamed_fdef, &serialized);
+  uint64 fingerprint = Fingerprint64(serialized);
+  for (const string& function_name : function_names) {
+    SerializeToStringDeterministic(*reachable_lib_def.Find(function_name),
+                                   &serialized);
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(serialized));
+  }
+
+  FunctionLibraryRuntime::InstantiateOptions stable_options = options;
+  stable_options.lib_def = nullptr;
+  stable_options.state_handle.clear();
+  fingerprint = FingerprintCat64(
+      fingerprint, Fingerprint64(Canonicalize("", attrs, stable_options)));
+
+  std::vector<string> device_names;
+  device_names.reserve(dev_set.devices().size());
+  for (const Device* device : dev_set.devices()) {
+    device_names.push_back(device->name());
+  }
+  std::sort(device_names.begin(), device_names.end());
+  for (const string& device_name : device_names) {
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(device_name));
+  }
+  return fingerprint;
+}
+
 // Gets the full path name of the file cache.
 // TODO(b/276813768) Include more runtime specific info like env/flag
-// values, or line number. An alternative is to use the fingerprint of the
-// graph once graph building cache is enabled.
+// values, or line number.
 //
 // Current file cache key components:
 // 1) Job name.
 // 2) Task ID.
 // 3) Function name (without UUID suffix).
 // 4) TF graph node count.
+// 5) The fingerprint from GetFileCacheFingerprint, so that instantiations
+//    with different bodies, attrs, options or devices do not share a file.
 string GetFileCacheName(const string& dir_name, const string& function_name,
-                        const FunctionDef* fdef) {
+                        const FunctionDef* fdef, uint64 fingerprint) {
   string plain_func_name = function_name;
   // Remove the random UUID in the function name.
   if (absl::StrContains(function_name, "_")) {
@@ -254,7 +299,8 @@ string GetFileCacheName(const string& dir_name, const string& function_name,
 
   return absl::StrCat(dir_name, "/", tsl::port::JobName(), "_",
                       tsl::port::TaskId(), "_", plain_func_name, "_",
-                      fdef->node_def_size());
+                      fdef->node_def_size(), "_",
+                      absl::Hex(fingerprint, absl::kZeroPad16));
 }
 
 // Generates graph and return information given the input function name,
@@ -693,7 +739,9 @@ OptimizeFunctionGraphOrReadFromFileCache(
         "Failed to find function ", function_name,
         " in function library: ", lib_def->ToProto().DebugString()));
   }
-  const string file_name = GetFileCacheName(dir_name, function_name, fdef);
+  const string file_name = GetFileCacheName(
+      dir_name, function_name, fdef,
+      GetFileCacheFingerprint(*fdef, attrs, options, dev_set, *lib_def));
 
   // Scenario (2): File cache exists for this function; restore from the cache.
   if (env->FileExists(file_name).ok()) {
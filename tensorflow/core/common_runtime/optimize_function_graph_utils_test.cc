@@ -195,7 +195,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   // Check that only one cache file exists.
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/_-1_FindDevice_1_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_EQ(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -215,7 +215,7 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   TF_ASSERT_OK(optimized_info.status());
   file_list.clear();
   TF_ASSERT_OK(env->GetMatchingPaths(
-      absl::StrCat(temp_dir, "/_-1_FindDevice_1"), &file_list));
+      absl::StrCat(temp_dir, "/_-1_FindDevice_1_*"), &file_list));
   EXPECT_EQ(file_list.size(), 1);
   EXPECT_GT(metrics::GetFunctionGraphOptimizationSavingTimeUsecs(
                 metrics::GraphOptimizationSource::kJit),
@@ -230,6 +230,26 @@ TEST(OptimizeFunctionGraphTest, OptimizeFunctionGraphAndWriteToCache) {
   EXPECT_EQ(optimized_info->num_return_nodes, 1);
   EXPECT_THAT(optimized_info->ret_types, ElementsAre(DT_STRING));
 
+  // Expect a second file cache for the same function with other devices.
+  DeviceSet other_device_set;
+  other_device_set.AddDevice(devices[0].get());
+  other_device_set.AddDevice(devices[1].get());
+  optimized_info = OptimizeFunctionGraphOrReadFromFileCache(
+      "FindDevice_1234", {}, opts, other_device_set, lib_def.get(),
+      /*composite_devices=*/{}, devices[0].get(), devices[1].get(),
+      Env::Default(), /*caching_threshold_duration=*/absl::ZeroDuration());
+  TF_ASSERT_OK(optimized_info.status());
+  file_list.clear();
+  TF_ASSERT_OK(env->GetMatchingPaths(
+      absl::StrCat(temp_dir, "/_-1_FindDevice_1_*"), &file_list));
+  EXPECT_EQ(file_list.size(), 2);
+  EXPECT_EQ(metrics::GetFunctionGraphOptimizationCacheHitCount(
+                metrics::GraphOptimizationSource::kJit),
+            1);
+  EXPECT_EQ(metrics::GetFunctionGraphOptimizationCacheMissCount(
+                metrics::GraphOptimizationSource::kJit),
+            3);
+
   // Clean up the cache directory for cases when the test is run multiple times
   // in a row without clearing the filesystem where the test is running.
   int64_t undeleted_files;
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/placer.h"
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -154,6 +155,39 @@ bool MatchIdentityOperation(const Node* node) {
   return input->requested_device() == output->requested_device();
 }
 
+// If `devices` are CPU devices on more than one NUMA node, returns the
+// device among them that a data input of `node` was assigned to, so that
+// the tensors of each partition stay in node-local memory. Returns -1
+// otherwise.
+int FindNumaLocalInputDevice(const Node* node,
+                             const std::vector<Device*>& devices) {
+  if (devices.size() < 2 || devices[0]->device_type() != DEVICE_CPU) {
+    return -1;
+  }
+  const int numa_node = devices[0]->attributes().locality().numa_node();
+  const bool spans_numa_nodes =
+      std::any_of(devices.begin(), devices.end(), [numa_node](Device* d) {
+        return d->device_type() == DEVICE_CPU &&
+               d->attributes().locality().numa_node() != numa_node;
+      });
+  if (!spans_numa_nodes) {
+    return -1;
+  }
+  for (const Edge* edge : node->in_edges()) {
+    if (edge->IsControlEdge() || !edge->src()->has_assigned_device_name()) {
+      continue;
+    }
+    const Node* input = edge->src();
+    for (const Device* device : devices) {
+      if (device->device_type() == DEVICE_CPU &&
+          device->name() == input->assigned_device_name()) {
+        return input->assigned_device_name_index();
+      }
+    }
+  }
+  return -1;
+}
+
 void LogDeviceAssignment(const Node* node, bool log_device_placement) {
   // Log placement if log_device_placement is set.
   if (log_device_placement) {
@@ -307,6 +341,13 @@ Status Placer::Run(const GraphOptimizationPassOptions& options) {
       }
     }
 
+    // Heuristic C: If the node can run on CPU devices on several NUMA nodes
+    // (see ConfigProto.Experimental.use_numa_affinity), place it with its
+    // data input.
+    if (assigned_device == -1) {
+      assigned_device = FindNumaLocalInputDevice(node, *devices);
+    }
+
     // Provide the default, if necessary.
     if (assigned_device == -1) {
       assigned_device = graph_->InternDeviceName((*devices)[0]->name());
@@ -107,6 +107,15 @@ class FakeDevice : public Device {
   static std::unique_ptr<Device> MakeGPU(const string& name) {
     return MakeDevice(name, "FakeGPU");
   }
+
+  static std::unique_ptr<Device> MakeNUMACPU(const string& name,
+                                             int numa_node) {
+    DeviceAttributes device_attributes;
+    device_attributes.set_name(name);
+    device_attributes.set_device_type(DEVICE_CPU);
+    device_attributes.mutable_locality()->set_numa_node(numa_node);
+    return std::unique_ptr<Device>(new FakeDevice(device_attributes));
+  }
 };
 
 class DummyFactory : public DeviceFactory {
@@ -149,6 +158,7 @@ REGISTER_KERNEL_BUILDER(Name("TestAdd").Device("FakeGPU"), DummyOp);
 REGISTER_OP("TestRelu").Input("i: float").Output("o: float");
 REGISTER_KERNEL_BUILDER(Name("TestRelu").Device("FakeCPU"), DummyOp);
 REGISTER_KERNEL_BUILDER(Name("TestRelu").Device("FakeGPU"), DummyOp);
+REGISTER_KERNEL_BUILDER(Name("TestRelu").Device(DEVICE_CPU), DummyOp);
 
 REGISTER_OP("ReluCPU").Input("i: float").Output("o: float");
 REGISTER_KERNEL_BUILDER(Name("ReluCPU").Device("FakeCPU"), DummyOp);
@@ -173,6 +183,7 @@ REGISTER_KERNEL_BUILDER(Name("TestInput").Device("FakeCPU"), DummyOp);
 REGISTER_OP("TestCPUGPUOutput").Output("a: float");
 REGISTER_KERNEL_BUILDER(Name("TestCPUGPUOutput").Device("FakeCPU"), DummyOp);
 REGISTER_KERNEL_BUILDER(Name("TestCPUGPUOutput").Device("FakeGPU"), DummyOp);
+REGISTER_KERNEL_BUILDER(Name("TestCPUGPUOutput").Device(DEVICE_CPU), DummyOp);
 
 REGISTER_OP("TestGPUOutput").Output("a: float");
 REGISTER_KERNEL_BUILDER(Name("TestGPUOutput").Device("FakeGPU"), DummyOp);
@@ -838,6 +849,38 @@ TEST_F(PlacerTest, TestIgnoreGeneratorHeuristicIfWrongPartialDevice) {
 
 // Test that a graph with partial device specifications on the ops
 // will successfully
+// Heuristic C: with one CPU device per NUMA node, a node without a requested
+// device follows its data input to the input's NUMA node.
+TEST_F(PlacerTest, TestNUMAHeuristicFollowsDataInput) {
+  for (const bool distinct_numa_nodes : {false, true}) {
+    std::vector<std::unique_ptr<Device>> cpu_devices;
+    DeviceSet devices;
+    for (int i = 0; i < 2; ++i) {
+      cpu_devices.push_back(FakeDevice::MakeNUMACPU(
+          strings::StrCat("/job:a/replica:0/task:0/device:CPU:", i),
+          distinct_numa_nodes ? i : 0));
+      devices.AddDevice(cpu_devices.back().get());
+    }
+
+    Graph g(OpRegistry::Global());
+    {  // Scope for temporary variables used to construct g.
+      GraphDefBuilder b(GraphDefBuilder::kFailImmediately);
+      Node* input = ops::SourceOp(
+          "TestCPUGPUOutput", b.opts().WithName("in").WithDevice("/cpu:1"));
+      Node* relu_1 = ops::UnaryOp(
+          "TestRelu", input, b.opts().WithName("relu_1").WithDevice("/cpu:1"));
+      ops::UnaryOp("TestRelu", relu_1, b.opts().WithName("relu_2"));
+      TF_EXPECT_OK(BuildGraph(b, &g));
+    }
+
+    TF_EXPECT_OK(Place(&g, &devices));
+    EXPECT_DEVICE_CONTAINS(g, "relu_1", "/device:CPU:1");
+    EXPECT_DEVICE_CONTAINS(g, "relu_2",
+                           distinct_numa_nodes ? "/device:CPU:1"
+                                               : "/device:CPU:0");
+  }
+}
+
 TEST_F(PlacerTest, TestPartialSpec) {
   Graph g(OpRegistry::Global());
   {  // Scope for temporary variables used to construct g.
@@ -394,6 +394,12 @@ string RingAlg::RingField::DebugString() const {
   return rv;
 }
 
+bool RingAlg::UsesWireDtype(int dev_idx) const {
+  return wire_dtype_ != DT_INVALID &&
+         col_params_->group.members[dev_idx].task !=
+             col_params_->group.members[col_params_->default_rank].task;
+}
+
 void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
   DCHECK(rf->do_send);
   string send_buf_key = RingAlgBufKey(name_, col_ctx_->exec_key,
@@ -404,11 +410,23 @@ void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
   int send_to_rank = (rf->rank + 1) % group_size_;
   int send_to_dev_idx = col_params_->instance.impl_details
                             .subdiv_permutations[rf->subdiv_idx][send_to_rank];
+  if (wire_dtype_ != DT_INVALID && rf->second_pass && !rf->do_recv) {
+    // This device holds the final value of the chunk, and the other devices
+    // may receive it in wire_dtype_. Round it the same way so that all
+    // devices end with the same value.
+    rf->chunk.flat<float>() =
+        rf->chunk.flat<float>().cast<bfloat16>().cast<float>();
+  }
+  const Tensor* send_tensor = &rf->chunk;
+  if (UsesWireDtype(send_to_dev_idx)) {
+    rf->wire_chunk.flat<bfloat16>() = rf->chunk.flat<float>().cast<bfloat16>();
+    send_tensor = &rf->wire_chunk;
+  }
   col_ctx_->col_exec->remote_access()->PostToPeer(
       col_params_->group.members[send_to_dev_idx].device.name(),
       col_params_->group.members[send_to_dev_idx].task, send_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
-      col_ctx_->op_ctx->output_alloc_attr(0), &rf->chunk,
+      col_ctx_->op_ctx->output_alloc_attr(0), send_tensor,
       col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
       done);
 }
@@ -424,6 +442,17 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
   Tensor* dst_tensor = (!rf->second_pass && (col_params_->merge_op != nullptr))
                            ? &rf->tmp_chunk
                            : &rf->chunk;
+  StatusCallback recv_done = done;
+  if (UsesWireDtype(rf->recv_dev_idx)) {
+    recv_done = [rf, dst_tensor, done](const Status& s) {
+      if (s.ok()) {
+        dst_tensor->flat<float>() =
+            rf->wire_chunk.flat<bfloat16>().cast<float>();
+      }
+      done(s);
+    };
+    dst_tensor = &rf->wire_chunk;
+  }
   col_ctx_->col_exec->remote_access()->RecvFromPeer(
       col_params_->group.members[rf->recv_dev_idx].device.name(),
       col_params_->group.members[rf->recv_dev_idx].task,
@@ -431,7 +460,7 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
       col_ctx_->op_ctx->output_alloc_attr(0), dst_tensor,
       col_ctx_->device_locality, rf->subdiv_idx,
-      col_ctx_->op_ctx->cancellation_manager(), done);
+      col_ctx_->op_ctx->cancellation_manager(), recv_done);
 }
 
 string RingAlg::FieldState() {
@@ -75,6 +75,7 @@ class RingAlg : public CollectiveImplementationInterface {
     bool is_final = false;  // is the last field in the pass for this rank
     Tensor chunk;           // alias to field values
     Tensor tmp_chunk;
+    Tensor wire_chunk;      // chunk in wire_dtype_, when sent or recv'd as such
     Status status;
     string DebugString() const;
   };
@@ -84,6 +85,10 @@ class RingAlg : public CollectiveImplementationInterface {
   void DispatchSend(RingField* rf, const StatusCallback& done);
   void DispatchRecv(RingField* rf, const StatusCallback& done);
 
+  // Whether chunks exchanged with the device at `dev_idx` in the group are
+  // converted to wire_dtype_, i.e. when it is in another task.
+  bool UsesWireDtype(int dev_idx) const;
+
   // For constructing log messages for debugging.
   string FieldState();
   string TensorDebugString(const Tensor& tensor);
@@ -111,6 +116,8 @@ class RingAlg : public CollectiveImplementationInterface {
   Tensor group_size_tensor_;
   Notification group_size_tensor_ready_;
   std::unique_ptr<CollectiveAdapter> ca_;
+  // If not DT_INVALID, float chunks are sent between tasks in this type.
+  DataType wire_dtype_ = DT_INVALID;
   mutex status_mu_;
   Status status_ TF_GUARDED_BY(status_mu_);
   std::vector<RingField> rfv_;
@@ -64,6 +64,13 @@ void RingReducer::Run(StatusCallback done) {
   num_subdivs_ = static_cast<int>(
       col_params_->instance.impl_details.subdiv_permutations.size());
   CHECK_GT(num_subdivs_, 0);
+  if (col_params_->instance.impl_details.communication_hint ==
+          kBfloat16WireHint &&
+      col_params_->instance.data_type == DT_FLOAT &&
+      col_params_->group.device_type == DEVICE_CPU &&
+      col_params_->group.num_tasks > 1) {
+    wire_dtype_ = DT_BFLOAT16;
+  }
 
   if (VLOG_IS_ON(1)) {
     string buf;
@@ -168,6 +175,11 @@ void RingReducer::InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
   if (rf->do_recv) {
     rf->tmp_chunk = ca_->TempChunk(rf->sc_idx);
   }
+  if (wire_dtype_ != DT_INVALID && (rf->do_send || rf->do_recv)) {
+    AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+    rf->wire_chunk = Tensor(col_ctx_->device->GetAllocator(attr), wire_dtype_,
+                            rf->chunk.shape());
+  }
 }
 
 // At the beginning of the algorithm initialize a RingField struct for
@@ -427,6 +427,39 @@ DEF_TEST(INT64, CPU, 2, 8, 3, 4095, 0)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 1)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 7)
 DEF_TEST(FLOAT, CPU, 2, 8, 2, 9408, 11)
+
+TEST_F(RingReducerTest, Bfloat16WireHint) {
+  const int kNumWorkers = 3;
+  const int kNumDevices = 2;
+  const int kTensorLen = 1001;
+  Init(kNumWorkers, kNumDevices, DT_FLOAT, TensorShape({kTensorLen}),
+       DEVICE_CPU, /*num_subdivs=*/2, /*fail_after=*/0);
+  std::vector<float> expected(kTensorLen);
+  for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+    instances_[di]->col_params_->instance.impl_details.communication_hint =
+        RingReducer::kBfloat16WireHint;
+    instances_[di]->InitTensor([&expected, di](Tensor* t) {
+      for (int i = 0; i < kTensorLen; ++i) {
+        float value = 0.1f * di + 0.003f * i;
+        t->flat<float>()(i) = value;
+        expected[i] += value / (kNumWorkers * kNumDevices);
+      }
+    });
+  }
+  Reduce(/*fail_after=*/0);
+  for (int di = 0; di < static_cast<int>(instances_.size()); ++di) {
+    TF_EXPECT_OK(instances_[di]->status_);
+    // Every device ends with the same value, rounded to bfloat16.
+    test::ExpectTensorEqual<float>(instances_[0]->tensor(),
+                                   instances_[di]->tensor());
+    test::ExpectClose(instances_[di]->tensor(), test::AsTensor<float>(expected),
+                      /*atol=*/0.0, /*rtol=*/0.02);
+    for (int i = 0; i < kTensorLen; ++i) {
+      const float value = instances_[di]->tensor().flat<float>()(i);
+      EXPECT_EQ(static_cast<float>(static_cast<bfloat16>(value)), value);
+    }
+  }
+}
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
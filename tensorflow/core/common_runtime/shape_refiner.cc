@@ -22,11 +22,13 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/common_runtime/eval_const_tensor.h"
 #include "tensorflow/core/common_runtime/function_utils.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/common_shape_fns.h"
+#include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -34,6 +36,8 @@ limitations under the License.
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tsl/platform/statusor.h"
 
 namespace tensorflow {
@@ -64,6 +68,22 @@ namespace {
 constexpr char kArgOp[] = "_Arg";
 constexpr char kRetvalOp[] = "_Retval";
 
+auto* function_shapes_cache_lookups = monitoring::Counter<1>::New(
+    "/tensorflow/core/shape_refiner/function_shapes_cache_lookups",
+    "The number of lookups of the function shapes cache of the ShapeRefiner.",
+    "result");
+
+auto* function_shapes_inference_time_usecs = monitoring::Counter<0>::New(
+    "/tensorflow/core/shape_refiner/function_shapes_inference_time_usecs",
+    "The time spent inferring the shapes of function bodies on misses of the "
+    "function shapes cache. Each hit saves about the average of a miss.");
+
+// Appends `piece` to `key` so that distinct sequences of pieces never produce
+// the same key.
+void AppendToKey(absl::string_view piece, std::string* key) {
+  absl::StrAppend(key, piece.size(), ":", piece);
+}
+
 }  // namespace
 
 // Runs shape inference for the given node using the given ShapeRefiner.
@@ -158,9 +178,124 @@ Status ShapeRefiner::InferShapesForFunctionSubNode(
 // NOTE: Recursive user-defined functions are not supported.
 // Maybe we won't support recursive functions at all in TF, because of
 // other maintainability issues.
+std::optional<std::string> ShapeRefiner::FunctionShapesKey(
+    const FunctionDef& function_def, AttrSlice attributes,
+    InferenceContext* outer_context) const {
+  std::string key = Canonicalize(function_def.signature().name(), attributes);
+  for (int i = 0; i < outer_context->num_inputs(); ++i) {
+    ShapeHandle input = outer_context->input(i);
+    if (input.IsSet()) {
+      AppendToKey(
+          absl::StrCat("s", outer_context->ShapeHandleToProto(input)
+                                .SerializeAsString()),
+          &key);
+    } else {
+      AppendToKey("u", &key);
+    }
+
+    const Tensor* tensor = outer_context->input_tensor(i);
+    if (tensor != nullptr) {
+      // Like the constant tensor cache, only small tensors are part of keys.
+      if (tensor->TotalBytes() > kMaxTensorSize) return std::nullopt;
+      TensorProto proto;
+      tensor->AsProtoTensorContent(&proto);
+      AppendToKey(absl::StrCat("t", proto.SerializeAsString()), &key);
+    } else {
+      AppendToKey("", &key);
+    }
+
+    const std::vector<ShapeAndType>* handle_data =
+        outer_context->input_handle_shapes_and_types(i);
+    if (handle_data == nullptr) {
+      AppendToKey("", &key);
+      continue;
+    }
+    AppendToKey(absl::StrCat("h", handle_data->size()), &key);
+    for (const ShapeAndType& shape_and_type : *handle_data) {
+      AppendToKey(outer_context->ShapeHandleToProto(shape_and_type.shape)
+                      .SerializeAsString(),
+                  &key);
+      AppendToKey(absl::StrCat(static_cast<int>(shape_and_type.dtype)), &key);
+      AppendToKey(shape_and_type.type.SerializeAsString(), &key);
+    }
+  }
+  return key;
+}
+
 Status ShapeRefiner::InferShapesForFunction(const FunctionDef* function_def,
                                             AttrSlice attributes,
                                             InferenceContext* outer_context) {
+  std::optional<std::string> key =
+      FunctionShapesKey(*function_def, attributes, outer_context);
+  if (key.has_value()) {
+    auto it = function_shapes_.find(*key);
+    if (it != function_shapes_.end()) {
+      function_shapes_cache_lookups->GetCell("hit")->IncrementBy(1);
+      const FunctionShapes& shapes = it->second;
+      for (int i = 0; i < shapes.output_shapes.size(); ++i) {
+        ShapeHandle handle;
+        TF_RETURN_IF_ERROR(outer_context->MakeShapeFromShapeProto(
+            shapes.output_shapes[i], &handle));
+        outer_context->set_output(i, handle);
+        if (!shapes.output_handle_shapes[i].has_value()) continue;
+        std::vector<ShapeAndType> shapes_and_types;
+        for (const FunctionShapes::HandleShape& handle_shape :
+             *shapes.output_handle_shapes[i]) {
+          TF_RETURN_IF_ERROR(outer_context->MakeShapeFromShapeProto(
+              handle_shape.shape, &handle));
+          shapes_and_types.push_back(
+              ShapeAndType(handle, handle_shape.dtype, handle_shape.type));
+        }
+        outer_context->set_output_handle_shapes_and_types(i, shapes_and_types);
+      }
+      for (int index : shapes.requested_input_tensors) {
+        outer_context->request_input_tensor(index);
+      }
+      return absl::OkStatus();
+    }
+    function_shapes_cache_lookups->GetCell("miss")->IncrementBy(1);
+  }
+
+  const uint64 start_time_usecs = Env::Default()->NowMicros();
+  Status status =
+      InferShapesForFunctionBody(function_def, attributes, outer_context);
+  function_shapes_inference_time_usecs->GetCell()->IncrementBy(
+      Env::Default()->NowMicros() - start_time_usecs);
+  if (!status.ok() || !key.has_value()) return status;
+
+  // Only complete results are cached, as a failed or partial inference may
+  // succeed once more of the outer graph is known.
+  FunctionShapes shapes;
+  for (int i = 0; i < outer_context->num_outputs(); ++i) {
+    ShapeHandle output = outer_context->output(i);
+    if (!output.IsSet()) return status;
+    shapes.output_shapes.push_back(outer_context->ShapeHandleToProto(output));
+    const std::vector<ShapeAndType>* handle_data =
+        outer_context->output_handle_shapes_and_types(i);
+    if (handle_data == nullptr) {
+      shapes.output_handle_shapes.push_back(std::nullopt);
+      continue;
+    }
+    std::vector<FunctionShapes::HandleShape> handle_shapes;
+    for (const ShapeAndType& shape_and_type : *handle_data) {
+      handle_shapes.push_back(
+          {outer_context->ShapeHandleToProto(shape_and_type.shape),
+           shape_and_type.dtype, shape_and_type.type});
+    }
+    shapes.output_handle_shapes.push_back(std::move(handle_shapes));
+  }
+  for (int i = 0; i < outer_context->num_inputs(); ++i) {
+    if (outer_context->requested_input_tensor(i)) {
+      shapes.requested_input_tensors.push_back(i);
+    }
+  }
+  function_shapes_.emplace(*std::move(key), std::move(shapes));
+  return status;
+}
+
+Status ShapeRefiner::InferShapesForFunctionBody(
+    const FunctionDef* function_def, AttrSlice attributes,
+    InferenceContext* outer_context) {
   const Graph* graph;
   const string& fname = function_def->signature().name();
   auto it = functions_.find(fname);
@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_SHAPE_REFINER_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -23,6 +24,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/graph_runner.h"
 #include "tensorflow/core/framework/function.pb.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -139,10 +141,20 @@ class ShapeRefiner {
   //
   // On success:
   // - outer_context will contain output shapes inferred from input shapes
+  //
+  // The inferred shapes are memoized by the function, its attributes and the
+  // input shapes, constant inputs and handle data of outer_context, so that
+  // repeated calls of a function with the same signature are not re-inferred.
   Status InferShapesForFunction(
       const FunctionDef* function_def, AttrSlice attributes,
       shape_inference::InferenceContext* outer_context);
 
+  // Performs shape inference for the body of function_def, without the cache
+  // of InferShapesForFunction.
+  Status InferShapesForFunctionBody(
+      const FunctionDef* function_def, AttrSlice attributes,
+      shape_inference::InferenceContext* outer_context);
+
   // Performs shape inference for a node inside a function.
   //
   // 'outer_context' is the 'InferenceContext' for the function's call op.
@@ -283,6 +295,29 @@ class ShapeRefiner {
   // are refined.
   absl::flat_hash_map<std::string, std::unique_ptr<const Graph>> functions_;
 
+  // The result of a successful shape inference of a function, as protos since
+  // the shape handles are owned by the InferenceContext of a single call.
+  struct FunctionShapes {
+    struct HandleShape {
+      TensorShapeProto shape;
+      DataType dtype;
+      FullTypeDef type;
+    };
+    std::vector<TensorShapeProto> output_shapes;
+    std::vector<std::optional<std::vector<HandleShape>>> output_handle_shapes;
+    // The inputs whose constant value was requested by the function body.
+    std::vector<int> requested_input_tensors;
+  };
+
+  // Returns the key of the function shapes cache for a call with the inputs
+  // of `outer_context`, or std::nullopt if the call should not be cached.
+  std::optional<std::string> FunctionShapesKey(
+      const FunctionDef& function_def, AttrSlice attributes,
+      shape_inference::InferenceContext* outer_context) const;
+
+  // Cache of the output shapes inferred for each function call signature.
+  absl::flat_hash_map<std::string, FunctionShapes> function_shapes_;
+
   ShapeRefiner(const ShapeRefiner&) = delete;
   void operator=(const ShapeRefiner&) = delete;
 };
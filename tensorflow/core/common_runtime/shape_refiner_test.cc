@@ -26,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/version.h"
@@ -1464,6 +1465,37 @@ TEST_F(ShapeRefinerTest, SimpleFunctionShapeInference) {
   TestSimpleFunctionInference(true /* enable_function_inference */);
 }
 
+TEST_F(ShapeRefinerTest, FunctionShapeInferenceIsCachedBySignature) {
+  monitoring::testing::CellReader<int64_t> lookups(
+      "/tensorflow/core/shape_refiner/function_shapes_cache_lookups");
+  FunctionDefLibrary f_lib_proto;
+  *(f_lib_proto.add_function()) = test::function::XTimesTwo();
+  FunctionLibraryDefinition f_lib(OpRegistry::Global(), f_lib_proto);
+
+  Scope root = Scope::NewRootScope();
+  TF_ASSERT_OK(root.graph()->AddFunctionLibrary(f_lib_proto));
+  auto x = ops::Const(root, {{1.0f, 2.0f}});
+  auto y = ops::Const(root, {{3.0f, 4.0f}});
+  auto z = ops::Const(root, {1.0f, 2.0f, 3.0f});
+  auto x2 = test::function::Call(&root, "x2", "XTimesTwo", {x});
+  auto y2 = test::function::Call(&root, "y2", "XTimesTwo", {y});
+  auto z2 = test::function::Call(&root, "z2", "XTimesTwo", {z});
+
+  ShapeRefiner m(TF_GRAPH_DEF_VERSION, &f_lib);
+  m.set_function_library_for_shape_inference(&f_lib);
+
+  for (const Output& output : {x, y, z, x2, y2, z2}) {
+    TF_ASSERT_OK(m.AddNode(output.node()));
+  }
+
+  // The call of y has the signature of the call of x, z has another one.
+  EXPECT_SHAPE("[1,2]", m, x2, 0);
+  EXPECT_SHAPE("[1,2]", m, y2, 0);
+  EXPECT_SHAPE("[3]", m, z2, 0);
+  EXPECT_EQ(lookups.Delta("miss"), 2);
+  EXPECT_EQ(lookups.Delta("hit"), 1);
+}
+
 TEST_F(ShapeRefinerTest, FunctionShapeInferenceFallback) {
   // Test that function inference falls back to returning unknown shapes,
   // if the function lookup fails.
@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/executor.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -67,6 +68,8 @@ typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
 
 static const string& kSingleThreadedExecutor =
     *new string("SINGLE_THREADED_EXECUTOR");
+static const string& kStaticScheduleExecutor =
+    *new string("STATIC_SCHEDULE_EXECUTOR");
 
 class SingleThreadedExecutorImpl : public Executor {
  public:
@@ -589,6 +592,52 @@ class SingleThreadedExecutorRegistrar {
 };
 static SingleThreadedExecutorRegistrar registrar;
 
+// Returns true if `graph` can be executed by the single-threaded executor on
+// the device in `params`. See "single_threaded_executor.h" for the
+// limitations.
+bool IsSafeForSingleThreadedExecution(const LocalExecutorParams& params,
+                                      const Graph& graph) {
+  if (params.device->device_type() != DEVICE_CPU) return false;
+  for (const Node* n : graph.op_nodes()) {
+    if (n->IsSend() || n->IsRecv()) return false;
+    if (!ValidateOpIsSafeForSyncExecution(
+             *n, params.allow_control_flow_sync_execution)
+             .ok()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Uses the single-threaded executor, which replays a topological order and
+// input slot assignment computed once at construction time, for graphs that
+// support it. Falls back to the default executor for all other graphs, so that
+// it can be enabled for all partitions of a session.
+class StaticScheduleExecutorRegistrar {
+ public:
+  StaticScheduleExecutorRegistrar() {
+    ExecutorFactory::Register(kStaticScheduleExecutor, new Factory());
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    Status NewExecutor(const LocalExecutorParams& params, const Graph& graph,
+                       std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret;
+      if (IsSafeForSingleThreadedExecution(params, graph)) {
+        VLOG(1) << "Using a static schedule for a graph with "
+                << graph.num_op_nodes() << " nodes.";
+        TF_RETURN_IF_ERROR(NewSingleThreadedExecutor(params, graph, &ret));
+      } else {
+        TF_RETURN_IF_ERROR(NewLocalExecutor(params, graph, &ret));
+      }
+      out_executor->reset(ret);
+      return absl::OkStatus();
+    }
+  };
+};
+static StaticScheduleExecutorRegistrar static_schedule_registrar;
+
 }  // namespace
 
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
@@ -51,6 +51,10 @@ namespace tensorflow {
 //
 // The single-threaded executor is primarily suitable for executing simple
 // TensorFlow functions, such as one might find in a `tf.data` pipeline.
+//
+// The executor type "STATIC_SCHEDULE_EXECUTOR" (e.g. set as
+// `ConfigProto.Experimental.executor_type` of a session) uses this executor for
+// every graph that it supports, and the default executor for all other graphs.
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
                                  const Graph& graph, Executor** executor);
 
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph.h"
@@ -85,7 +86,8 @@ class ExecutorTest : public ::testing::Test {
 
   // Resets executor_ with a new executor based on a graph 'gdef'.
   void Create(std::unique_ptr<const Graph> graph,
-              std::function<void(OpKernelContext*)> mock_fn = nullptr) {
+              std::function<void(OpKernelContext*)> mock_fn = nullptr,
+              const string& executor_type = "SINGLE_THREADED_EXECUTOR") {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_.get();
@@ -103,8 +105,7 @@ class ExecutorTest : public ::testing::Test {
     params.delete_kernel = [](OpKernel* kernel) {
       DeleteNonCachedKernel(kernel);
     };
-    TF_CHECK_OK(
-        NewExecutor("SINGLE_THREADED_EXECUTOR", params, *graph, &exec_));
+    TF_CHECK_OK(NewExecutor(executor_type, params, *graph, &exec_));
     runner_ = [](const std::function<void()>& fn) { fn(); };
     rendez_ = NewLocalRendezvous();
   }
@@ -356,6 +357,38 @@ TEST_F(ExecutorTest, ControlDependenciesFromSpecialNodes) {
   EXPECT_EQ(3.0, V(retvals[0]));  // out = 1.0 + 2.0 = 3.0
 }
 
+TEST_F(ExecutorTest, StaticScheduleRandomTree) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g), /*mock_fn=*/nullptr, "STATIC_SCHEDULE_EXECUTOR");
+  for (int i = 0; i < 3; ++i) {
+    FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+    TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+    TF_ASSERT_OK(Run(&call_frame));
+    std::vector<Tensor> retvals;
+    TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+    EXPECT_EQ(4096.0, V(retvals[0]));
+  }
+}
+
+TEST_F(ExecutorTest, StaticScheduleFallsBackForControlFlow) {
+  // The single-threaded executor does not support Switch, so the default
+  // executor must be used instead.
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  auto pred = test::graph::Constant(g.get(), test::AsScalar<bool>(true));
+  auto sw = test::graph::Switch(g.get(), in0, pred);
+  test::graph::Retval(g.get(), 0, sw, /*in_index=*/1);
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g), /*mock_fn=*/nullptr, "STATIC_SCHEDULE_EXECUTOR");
+  FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(1.0, V(retvals[0]));
+}
+
 void BM_executor(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int depth = state.range(1);
@@ -0,0 +1,131 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+StepArenaAllocator::StepArenaAllocator(Allocator* allocator, size_t block_size,
+                                       size_t max_allocation_size)
+    : allocator_(allocator),
+      block_size_(block_size),
+      max_allocation_size_(max_allocation_size) {
+  CHECK_LE(max_allocation_size_, block_size_);
+}
+
+StepArenaAllocator::~StepArenaAllocator() {
+  mutex_lock l(mu_);
+  DCHECK(blocks_.empty());
+}
+
+std::string StepArenaAllocator::Name() {
+  return absl::StrCat("step_arena_", allocator_->Name());
+}
+
+void* StepArenaAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  if (num_bytes > max_allocation_size_ || alignment > kAllocatorAlignment) {
+    void* ptr = allocator_->AllocateRaw(alignment, num_bytes, allocation_attr);
+    if (ptr != nullptr) ref_.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+  }
+
+  // Round up every allocation, so that all allocations from a block are
+  // aligned, and so that each of them has a distinct address.
+  const size_t size =
+      std::max<size_t>(1, (num_bytes + kAllocatorAlignment - 1) /
+                              kAllocatorAlignment) *
+      kAllocatorAlignment;
+  mutex_lock l(mu_);
+  DCHECK(!released_);
+  if (current_block_ == nullptr ||
+      current_block_->used + size > block_size_) {
+    Block* previous_block = current_block_;
+    current_block_ = nullptr;
+    if (previous_block != nullptr) MaybeFreeBlock(previous_block);
+    char* base = static_cast<char*>(allocator_->AllocateRaw(
+        kAllocatorAlignment, block_size_, allocation_attr));
+    if (base == nullptr) return nullptr;
+    current_block_ = &blocks_[base];
+    current_block_->base = base;
+  }
+  char* ptr = current_block_->base + current_block_->used;
+  current_block_->used += size;
+  ++current_block_->num_live_allocations;
+  ref_.fetch_add(1, std::memory_order_relaxed);
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  // Freeing a null ptr is a no-op.
+  if (ptr == nullptr) {
+    return;
+  }
+  bool from_block = false;
+  {
+    mutex_lock l(mu_);
+    auto it = blocks_.upper_bound(static_cast<const char*>(ptr));
+    if (it != blocks_.begin()) {
+      --it;
+      if (static_cast<const char*>(ptr) < it->first + block_size_) {
+        from_block = true;
+        --it->second.num_live_allocations;
+        MaybeFreeBlock(&it->second);
+      }
+    }
+  }
+  if (!from_block) {
+    allocator_->DeallocateRaw(ptr);
+  }
+  Unref();
+}
+
+void StepArenaAllocator::Release() {
+  {
+    mutex_lock l(mu_);
+    DCHECK(!released_);
+    released_ = true;
+    Block* block = current_block_;
+    current_block_ = nullptr;
+    if (block != nullptr) MaybeFreeBlock(block);
+  }
+  Unref();
+}
+
+size_t StepArenaAllocator::NumLiveBlocksForTest() const {
+  mutex_lock l(mu_);
+  return blocks_.size();
+}
+
+void StepArenaAllocator::MaybeFreeBlock(Block* block) {
+  if (block == current_block_ || block->num_live_allocations > 0) return;
+  char* base = block->base;
+  blocks_.erase(base);
+  allocator_->DeallocateRaw(base);
+}
+
+void StepArenaAllocator::Unref() {
+  if (ref_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,118 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// StepArenaAllocator is a wrapper for an Allocator that serves the small
+// allocations of a single executor step from large blocks, using bump-pointer
+// allocation. The underlying allocator (and its lock) is only involved once per
+// block, and for allocations that are too large or too strictly aligned to be
+// served from a block.
+//
+// A block is returned to the underlying allocator once no further allocations
+// will be made from it and all the allocations made from it have been
+// deallocated. Tensors that escape the step, e.g. fetched outputs or values
+// stored in a resource, therefore keep only their own block alive, and no
+// escape analysis is needed for correctness.
+//
+// Like `TrackingAllocator`, the wrapper cannot be deleted until the last
+// outstanding call to `DeallocateRaw()` has occurred. The owner calls
+// `Release()` at the end of the step, and the wrapper deletes itself once all
+// allocations that were made through it have been deallocated.
+class StepArenaAllocator : public Allocator {
+ public:
+  static constexpr size_t kDefaultBlockSize = 64 << 10;
+  static constexpr size_t kDefaultMaxAllocationSize = 4 << 10;
+
+  // Allocations of at most `max_allocation_size` bytes are served from blocks
+  // of `block_size` bytes, which are allocated from `allocator`.
+  //
+  // REQUIRES: `max_allocation_size <= block_size`.
+  explicit StepArenaAllocator(
+      Allocator* allocator, size_t block_size = kDefaultBlockSize,
+      size_t max_allocation_size = kDefaultMaxAllocationSize);
+
+  std::string Name() override;
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return AllocateRaw(alignment, num_bytes, AllocationAttributes());
+  }
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+  void DeallocateRaw(void* ptr) override;
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return allocator_->GetMemoryType();
+  }
+
+  // Called by the owner at the end of the step. After this call, the only
+  // further calls allowed on this wrapper are calls to `DeallocateRaw()` with
+  // pointers that were allocated by this wrapper and have not yet been
+  // deallocated.
+  void Release();
+
+  // Returns the number of blocks that have been allocated from the underlying
+  // allocator and not yet returned to it. For testing.
+  size_t NumLiveBlocksForTest() const;
+
+ protected:
+  ~StepArenaAllocator() override;
+
+ private:
+  struct Block {
+    char* base;
+    // Offset of the first free byte in the block.
+    size_t used = 0;
+    // Number of allocations from this block that have not been deallocated.
+    int64_t num_live_allocations = 0;
+  };
+
+  // Returns `block` to the underlying allocator if it is no longer needed.
+  void MaybeFreeBlock(Block* block) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Drops one reference, and deletes `this` if it was the last one.
+  void Unref();
+
+  Allocator* const allocator_;  // Not owned.
+  const size_t block_size_;
+  const size_t max_allocation_size_;
+
+  // The number of allocations that have not yet been deallocated, plus 1 if
+  // the owner has not yet called `Release()`.
+  std::atomic<int64_t> ref_{1};
+
+  mutable mutex mu_;
+  bool released_ TF_GUARDED_BY(mu_) = false;
+  // The block from which new allocations are made.
+  Block* current_block_ TF_GUARDED_BY(mu_) = nullptr;
+  // All blocks that have not been returned to `allocator_`, keyed by their base
+  // address.
+  std::map<const char*, Block> blocks_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
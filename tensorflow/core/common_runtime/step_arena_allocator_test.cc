@@ -0,0 +1,96 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(StepArenaAllocatorTest, SmallAllocationsShareBlock) {
+  auto* a = new StepArenaAllocator(cpu_allocator(), /*block_size=*/1024,
+                                   /*max_allocation_size=*/256);
+  void* p0 = a->AllocateRaw(Allocator::kAllocatorAlignment, 10);
+  void* p1 = a->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(p0, nullptr);
+  ASSERT_NE(p1, nullptr);
+  EXPECT_NE(p0, p1);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p0) % Allocator::kAllocatorAlignment,
+            0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) % Allocator::kAllocatorAlignment,
+            0);
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 1);
+  a->DeallocateRaw(p0);
+  a->DeallocateRaw(p1);
+  // The current block is kept for further allocations.
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 1);
+  a->Release();
+}
+
+TEST(StepArenaAllocatorTest, LargeAllocationsPassThrough) {
+  auto* a = new StepArenaAllocator(cpu_allocator(), /*block_size=*/1024,
+                                   /*max_allocation_size=*/256);
+  void* p = a->AllocateRaw(Allocator::kAllocatorAlignment, 512);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 0);
+  void* q = a->AllocateRaw(2 * Allocator::kAllocatorAlignment, 16);
+  ASSERT_NE(q, nullptr);
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 0);
+  a->DeallocateRaw(p);
+  a->DeallocateRaw(q);
+  a->Release();
+}
+
+TEST(StepArenaAllocatorTest, FullBlocksAreFreedWhenEmpty) {
+  auto* a = new StepArenaAllocator(cpu_allocator(), /*block_size=*/256,
+                                   /*max_allocation_size=*/64);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 4; ++i) {
+    ptrs.push_back(a->AllocateRaw(Allocator::kAllocatorAlignment, 64));
+  }
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 1);
+  // The first block is full, so this starts a second one.
+  void* p = a->AllocateRaw(Allocator::kAllocatorAlignment, 64);
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 2);
+  for (void* ptr : ptrs) {
+    a->DeallocateRaw(ptr);
+  }
+  EXPECT_EQ(a->NumLiveBlocksForTest(), 1);
+  a->DeallocateRaw(p);
+  a->Release();
+}
+
+TEST(StepArenaAllocatorTest, AllocationsOutliveRelease) {
+  auto* a = new StepArenaAllocator(cpu_allocator());
+  Tensor small(a, DT_FLOAT, TensorShape({4}));
+  Tensor large(a, DT_FLOAT, TensorShape({4096}));
+  small.flat<float>().setConstant(1.0f);
+  large.flat<float>().setConstant(2.0f);
+  // The step ends while both tensors are still alive, e.g. because they were
+  // fetched. The allocator deletes itself when they are destroyed.
+  a->Release();
+  EXPECT_EQ(small.flat<float>()(3), 1.0f);
+  EXPECT_EQ(large.flat<float>()(4095), 2.0f);
+}
+
+}  // namespace
+}  // namespace tensorflow
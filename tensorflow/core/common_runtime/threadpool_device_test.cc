@@ -15,7 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -68,5 +73,19 @@ TEST(ThreadPoolDeviceTest, CopyTensor) {
   device_context->Unref();
 }
 
+TEST(ThreadPoolDeviceTest, OneDevicePerNUMANode) {
+  SessionOptions options;
+  options.config.mutable_experimental()->set_use_numa_affinity(true);
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_ASSERT_OK(DeviceFactory::GetFactory(DEVICE_CPU)
+                   ->CreateDevices(options, "/job:a/replica:0/task:0",
+                                   &devices));
+  ASSERT_EQ(devices.size(), port::NUMANumNodes());
+  for (int i = 0; i < devices.size(); ++i) {
+    EXPECT_EQ(devices[i]->attributes().locality().numa_node(), i);
+    EXPECT_NE(devices[i]->tensorflow_cpu_worker_threads(), nullptr);
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -14,12 +14,14 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/platform/errors.h"
@@ -234,5 +236,12 @@ Status UncompressElement(const CompressedElement& compressed,
 REGISTER_UNARY_VARIANT_DECODE_FUNCTION(CompressedElement,
                                        "tensorflow.data.CompressedElement");
 
+bool IsIncompressible(const DataTypeVector& dtypes) {
+  return !dtypes.empty() &&
+         std::all_of(dtypes.begin(), dtypes.end(), [](DataType dtype) {
+           return DataTypeIsFloating(dtype) || DataTypeIsComplex(dtype);
+         });
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/platform/status.h"
 
 namespace tensorflow {
@@ -37,6 +38,12 @@ Status CompressElement(const std::vector<Tensor>& element,
 Status UncompressElement(const CompressedElement& compressed,
                          std::vector<Tensor>* out);
 
+// Returns whether elements with components of `dtypes` are unlikely to shrink
+// when compressed, so that compressing them only costs CPU time. This is the
+// case for floating point and complex components, whose mantissas look random
+// to a byte-oriented compressor like Snappy.
+bool IsIncompressible(const DataTypeVector& dtypes);
+
 }  // namespace data
 }  // namespace tensorflow
 
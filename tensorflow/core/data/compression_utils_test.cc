@@ -39,6 +39,14 @@ TEST(CompressionUtilsTest, Exceeds4GB) {
                        HasSubstr("exceeding the 4GB Snappy limit")));
 }
 
+TEST(CompressionUtilsTest, IsIncompressible) {
+  EXPECT_TRUE(IsIncompressible({DT_FLOAT}));
+  EXPECT_TRUE(IsIncompressible({DT_BFLOAT16, DT_COMPLEX64}));
+  EXPECT_FALSE(IsIncompressible({DT_FLOAT, DT_INT64}));
+  EXPECT_FALSE(IsIncompressible({DT_STRING}));
+  EXPECT_FALSE(IsIncompressible({}));
+}
+
 std::vector<std::vector<Tensor>> TestCases() {
   return {
       // Single int64.
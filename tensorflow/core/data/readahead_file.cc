@@ -0,0 +1,151 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/readahead_file.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data {
+
+ReadaheadFile::ReadaheadFile(std::unique_ptr<RandomAccessFile> file,
+                             size_t block_size,
+                             std::function<void(std::function<void()>)> runner,
+                             std::function<int64_t()> readahead)
+    : file_(std::move(file)),
+      block_size_(block_size),
+      runner_(std::move(runner)),
+      readahead_(std::move(readahead)) {}
+
+ReadaheadFile::~ReadaheadFile() {
+  mutex_lock l(mu_);
+  while (num_reads_in_flight_ > 0) {
+    cond_var_.wait(l);
+  }
+}
+
+absl::Status ReadaheadFile::Name(StringPiece* result) const {
+  return file_->Name(result);
+}
+
+absl::Status ReadaheadFile::Read(uint64 offset, size_t n, StringPiece* result,
+                                 char* scratch) const {
+  size_t bytes_read = 0;
+  absl::Status status;
+  while (bytes_read < n) {
+    const uint64 position = offset + bytes_read;
+    const uint64 index = position / block_size_;
+    std::shared_ptr<Block> block;
+    std::vector<std::pair<uint64, std::shared_ptr<Block>>> reads;
+    {
+      mutex_lock l(mu_);
+      // Blocks before the one being read are not read again.
+      blocks_.erase(blocks_.begin(), blocks_.lower_bound(index));
+      if (last_block_.has_value() && index > *last_block_) {
+        status = absl::OutOfRangeError("Read past the end of the file.");
+        break;
+      }
+      reads = ScheduleLocked(index);
+      block = blocks_[index];
+    }
+    // The runner may run the reads inline, so they are started without
+    // holding `mu_`.
+    for (auto& [read_index, read_block] : reads) {
+      runner_([this, read_index = read_index,
+               read_block = std::move(read_block)]() mutable {
+        ReadBlock(read_index, std::move(read_block));
+      });
+    }
+
+    mutex_lock l(mu_);
+    while (!block->done) {
+      cond_var_.wait(l);
+    }
+    if (!block->status.ok() && !absl::IsOutOfRange(block->status)) {
+      // Retry on the next call.
+      blocks_.erase(index);
+      status = block->status;
+      break;
+    }
+    const size_t block_offset = position - index * block_size_;
+    if (block_offset >= block->data.size()) {
+      status = absl::OutOfRangeError("Read past the end of the file.");
+      break;
+    }
+    const size_t bytes_to_copy =
+        std::min(n - bytes_read, block->data.size() - block_offset);
+    std::memcpy(scratch + bytes_read, block->data.data() + block_offset,
+                bytes_to_copy);
+    bytes_read += bytes_to_copy;
+  }
+  *result = StringPiece(scratch, bytes_read);
+  return status;
+}
+
+std::vector<std::pair<uint64, std::shared_ptr<ReadaheadFile::Block>>>
+ReadaheadFile::ScheduleLocked(uint64 first) const {
+  std::vector<std::pair<uint64, std::shared_ptr<Block>>> reads;
+  const int64_t readahead = std::max<int64_t>(readahead_(), 1);
+  for (uint64 index = first; index < first + readahead; ++index) {
+    if (last_block_.has_value() && index > *last_block_) {
+      break;
+    }
+    if (blocks_.find(index) != blocks_.end()) {
+      continue;
+    }
+    auto block = std::make_shared<Block>();
+    blocks_[index] = block;
+    ++num_reads_in_flight_;
+    reads.emplace_back(index, std::move(block));
+  }
+  return reads;
+}
+
+void ReadaheadFile::ReadBlock(uint64 index,
+                              std::shared_ptr<Block> block) const {
+  block->data.resize(block_size_);
+  StringPiece data;
+  absl::Status status =
+      file_->Read(index * block_size_, block_size_, &data, block->data.data());
+  if (data.data() != block->data.data()) {
+    std::memmove(block->data.data(), data.data(), data.size());
+  }
+  block->data.resize(data.size());
+
+  mutex_lock l(mu_);
+  block->status = status;
+  block->done = true;
+  if (absl::IsOutOfRange(status) &&
+      (!last_block_.has_value() || index < *last_block_)) {
+    last_block_ = index;
+  }
+  --num_reads_in_flight_;
+  cond_var_.notify_all();
+}
+
+}  // namespace data
+}  // namespace tensorflow
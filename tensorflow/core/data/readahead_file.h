@@ -0,0 +1,95 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_READAHEAD_FILE_H_
+#define TENSORFLOW_CORE_DATA_READAHEAD_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data {
+
+// Wraps a file which is read sequentially, e.g. by an `io::RecordReader`, to
+// read ahead of the reader: while the reader consumes one block, the next
+// blocks are read in the background, with up to `readahead()` concurrent
+// range requests. Over high-latency filesystems (e.g. GCS or S3), this
+// overlaps the round-trips with each other, and with decoding and
+// decompression by the reader.
+//
+// Reads at other offsets are supported, but discard the blocks read ahead.
+class ReadaheadFile : public RandomAccessFile {
+ public:
+  // `runner` runs the background reads. `readahead` returns the number of
+  // blocks to read ahead. It is called on each read, so that it can be tuned
+  // while the file is read.
+  ReadaheadFile(std::unique_ptr<RandomAccessFile> file, size_t block_size,
+                std::function<void(std::function<void()>)> runner,
+                std::function<int64_t()> readahead);
+
+  // Waits for the background reads to finish.
+  ~ReadaheadFile() override;
+
+  absl::Status Name(StringPiece* result) const override;
+
+  absl::Status Read(uint64 offset, size_t n, StringPiece* result,
+                    char* scratch) const override;
+
+ private:
+  struct Block {
+    bool done = false;
+    absl::Status status;
+    std::string data;
+  };
+
+  // Adds the blocks from `first` to `first + readahead()` that are not read
+  // yet, and returns them, so that the caller starts reading them.
+  std::vector<std::pair<uint64, std::shared_ptr<Block>>> ScheduleLocked(
+      uint64 first) const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Reads `block`, which starts at block index `index`.
+  void ReadBlock(uint64 index, std::shared_ptr<Block> block) const;
+
+  const std::unique_ptr<RandomAccessFile> file_;
+  const size_t block_size_;
+  const std::function<void(std::function<void()>)> runner_;
+  const std::function<int64_t()> readahead_;
+
+  mutable mutex mu_;
+  mutable condition_variable cond_var_;
+  // Blocks being read or not yet consumed, by block index.
+  mutable std::map<uint64, std::shared_ptr<Block>> blocks_ TF_GUARDED_BY(mu_);
+  mutable int64_t num_reads_in_flight_ TF_GUARDED_BY(mu_) = 0;
+  // Index of the block holding the end of the file, once known.
+  mutable std::optional<uint64> last_block_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_READAHEAD_FILE_H_
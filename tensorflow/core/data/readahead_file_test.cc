@@ -0,0 +1,151 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/readahead_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::string Contents(size_t size) {
+  std::string contents(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  return contents;
+}
+
+std::unique_ptr<RandomAccessFile> OpenFile(const std::string& name,
+                                           const std::string& contents) {
+  const std::string filename = io::JoinPath(testing::TmpDir(), name);
+  TF_CHECK_OK(WriteStringToFile(Env::Default(), filename, contents));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_CHECK_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  return file;
+}
+
+class ReadaheadFileTest : public ::testing::TestWithParam<bool> {
+ protected:
+  ReadaheadFileTest() : thread_pool_(Env::Default(), "readahead_test", 4) {}
+
+  // Runs reads in `thread_pool_`, or inline.
+  std::function<void(std::function<void()>)> Runner() {
+    if (GetParam()) {
+      return [this](std::function<void()> fn) {
+        thread_pool_.Schedule(std::move(fn));
+      };
+    }
+    return [](std::function<void()> fn) { fn(); };
+  }
+
+  thread::ThreadPool thread_pool_;
+};
+
+TEST_P(ReadaheadFileTest, SequentialReads) {
+  const std::string contents = Contents(1000);
+  ReadaheadFile file(OpenFile("sequential_reads", contents),
+                     /*block_size=*/64, Runner(),
+                     /*readahead=*/[] { return 4; });
+  std::string result;
+  char scratch[100];
+  StringPiece data;
+  // The chunks are not aligned with the blocks.
+  for (uint64 offset = 0; offset < 1000; offset += 100) {
+    TF_ASSERT_OK(file.Read(offset, 100, &data, scratch));
+    result.append(data.data(), data.size());
+  }
+  EXPECT_EQ(result, contents);
+  EXPECT_TRUE(absl::IsOutOfRange(file.Read(1000, 100, &data, scratch)));
+  EXPECT_TRUE(data.empty());
+}
+
+TEST_P(ReadaheadFileTest, ReadPastEnd) {
+  const std::string contents = Contents(100);
+  ReadaheadFile file(OpenFile("read_past_end", contents), /*block_size=*/16,
+                     Runner(), /*readahead=*/[] { return 2; });
+  char scratch[200];
+  StringPiece data;
+  EXPECT_TRUE(absl::IsOutOfRange(file.Read(50, 200, &data, scratch)));
+  EXPECT_EQ(data, StringPiece(contents).substr(50));
+}
+
+TEST_P(ReadaheadFileTest, RandomReads) {
+  const std::string contents = Contents(1000);
+  int64_t readahead = 1;
+  ReadaheadFile file(OpenFile("random_reads", contents), /*block_size=*/32,
+                     Runner(), [&readahead] { return readahead; });
+  char scratch[50];
+  StringPiece data;
+  for (uint64 offset : {900, 10, 500, 10, 0}) {
+    TF_ASSERT_OK(file.Read(offset, 50, &data, scratch));
+    EXPECT_EQ(data, StringPiece(contents).substr(offset, 50));
+    readahead = readahead * 2;
+  }
+}
+
+TEST_P(ReadaheadFileTest, ReadRecords) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "read_records");
+  std::vector<std::string> records;
+  {
+    std::unique_ptr<WritableFile> file;
+    TF_ASSERT_OK(Env::Default()->NewWritableFile(filename, &file));
+    io::RecordWriter writer(file.get());
+    for (int i = 0; i < 100; ++i) {
+      records.push_back(Contents(i * 7));
+      TF_ASSERT_OK(writer.WriteRecord(records.back()));
+    }
+    TF_ASSERT_OK(writer.Close());
+    TF_ASSERT_OK(file->Close());
+  }
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(filename, &file));
+  ReadaheadFile readahead_file(std::move(file), /*block_size=*/128, Runner(),
+                               /*readahead=*/[] { return 3; });
+  io::RecordReaderOptions options;
+  options.buffer_size = 100;
+  io::SequentialRecordReader reader(&readahead_file, options);
+  tstring record;
+  for (const std::string& expected : records) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, expected);
+  }
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+INSTANTIATE_TEST_SUITE_P(ReadaheadFileTests, ReadaheadFileTest,
+                         ::testing::Bool());
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
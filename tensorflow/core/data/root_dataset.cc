@@ -19,15 +19,20 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/status/statusor.h"
 #include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/hash_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/rewrite_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/model.pb.h"
@@ -58,6 +63,12 @@ constexpr char kRamUsage[] = "ram_usage_megabytes";
 constexpr char kMaxBufferBytes[] = "max_buffered_megabytes";
 constexpr char kWarmStart[] = "warm_start";
 
+constexpr char kAutotuneFingerprint[] = "autotune_fingerprint";
+constexpr char kAutotuneNumParameters[] = "autotune_num_parameters";
+constexpr char kAutotuneNodeName[] = "autotune_node_name";
+constexpr char kAutotuneParameterName[] = "autotune_parameter_name";
+constexpr char kAutotuneParameterValue[] = "autotune_parameter_value";
+
 // If value `x` matches `y`, returns default value `z`. Otherwise, return `x`.
 inline int64_t value_or_default(int64_t x, int64_t y, int64_t z) {
   return x == y ? z : x;
@@ -107,6 +118,25 @@ void SetRootDatasetParams(const Options& options, RootDataset::Params* params) {
   params->ram_budget_share = ram_budget_share;
 }
 
+// Returns a fingerprint of the input pipeline rooted in `dataset`. It is saved
+// with the tuned parameter values, so that they are only used to warm-start
+// autotuning of the same pipeline. Data tensors and random seeds are not part
+// of the fingerprint.
+absl::StatusOr<uint64> PipelineFingerprint(const DatasetBase* dataset) {
+  std::vector<std::pair<string, Tensor>> input_list;
+  SerializationContext::Params params;
+  params.input_list = &input_list;
+  params.external_state_policy = ExternalStatePolicy::POLICY_IGNORE;
+  params.is_graph_rewrite = true;
+  params.resource_mgr = nullptr;
+  GraphDef graph_def;
+  TF_RETURN_IF_ERROR(
+      AsGraphDef(dataset, SerializationContext(params), &graph_def));
+  uint64 fingerprint;
+  TF_RETURN_IF_ERROR(HashGraph(graph_def, &fingerprint));
+  return fingerprint;
+}
+
 void AddTraceMetadata(const RootDataset::Params& params, const Options& options,
                       TraceMeMetadata* trace_metadata) {
   if (params.autotune) {
@@ -261,6 +291,9 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
   Status SaveInternal(SerializationContext* ctx,
                       IteratorStateWriter* writer) override {
     TF_RETURN_IF_ERROR(SaveInput(ctx, writer, input_impl_));
+    if (model_ != nullptr) {
+      TF_RETURN_IF_ERROR(SaveTunableParameters(writer));
+    }
     return absl::OkStatus();
   }
 
@@ -269,6 +302,9 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
     IteratorContext iter_ctx(CreateParams(ctx));
     TF_RETURN_IF_ERROR(RestoreInput(&iter_ctx, reader, input_impl_));
     ctx->MergeCheckpoint(iter_ctx.checkpoint());
+    if (model_ != nullptr && reader->Contains(prefix(), kAutotuneFingerprint)) {
+      TF_RETURN_IF_ERROR(RestoreTunableParameters(reader));
+    }
     return absl::OkStatus();
   }
 
@@ -340,6 +376,90 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
     return params;
   }
 
+  absl::StatusOr<uint64> GetFingerprint() {
+    {
+      mutex_lock l(mu_);
+      if (fingerprint_.has_value()) {
+        return *fingerprint_;
+      }
+    }
+    TF_ASSIGN_OR_RETURN(uint64 fingerprint,
+                        PipelineFingerprint(dataset()->input_));
+    mutex_lock l(mu_);
+    fingerprint_ = fingerprint;
+    return fingerprint;
+  }
+
+  // Saves the tuned values of the tunable parameters, so that autotuning of a
+  // restored iterator (e.g. after a job restart) starts from them, instead of
+  // from the defaults.
+  Status SaveTunableParameters(IteratorStateWriter* writer) {
+    absl::StatusOr<uint64> fingerprint = GetFingerprint();
+    if (!fingerprint.ok()) {
+      VLOG(1) << "Not saving tuned parameter values, because the pipeline "
+              << "could not be fingerprinted: " << fingerprint.status();
+      return absl::OkStatus();
+    }
+    TF_RETURN_IF_ERROR(writer->WriteScalar(
+        prefix(), kAutotuneFingerprint, static_cast<int64_t>(*fingerprint)));
+    int64_t num_parameters = 0;
+    for (const auto& [node_name, values] :
+         model_->GetTunableParameterValues()) {
+      for (const auto& [parameter_name, value] : values) {
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            prefix(),
+            strings::StrCat(kAutotuneNodeName, "[", num_parameters, "]"),
+            node_name));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            prefix(),
+            strings::StrCat(kAutotuneParameterName, "[", num_parameters, "]"),
+            parameter_name));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            prefix(),
+            strings::StrCat(kAutotuneParameterValue, "[", num_parameters, "]"),
+            static_cast<int64_t>(value)));
+        ++num_parameters;
+      }
+    }
+    return writer->WriteScalar(prefix(), kAutotuneNumParameters,
+                               num_parameters);
+  }
+
+  // Warm-starts autotuning from the saved parameter values, if they were tuned
+  // for the same pipeline.
+  Status RestoreTunableParameters(IteratorStateReader* reader) {
+    int64_t saved_fingerprint;
+    TF_RETURN_IF_ERROR(
+        reader->ReadScalar(prefix(), kAutotuneFingerprint, &saved_fingerprint));
+    absl::StatusOr<uint64> fingerprint = GetFingerprint();
+    if (!fingerprint.ok() ||
+        static_cast<int64_t>(*fingerprint) != saved_fingerprint) {
+      VLOG(1) << "Not restoring tuned parameter values, because they were "
+              << "saved for a different pipeline.";
+      return absl::OkStatus();
+    }
+    int64_t num_parameters;
+    TF_RETURN_IF_ERROR(
+        reader->ReadScalar(prefix(), kAutotuneNumParameters, &num_parameters));
+    model::Model::TunableParameterValues values;
+    for (int64_t i = 0; i < num_parameters; ++i) {
+      tstring node_name, parameter_name;
+      int64_t value;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(
+          prefix(), strings::StrCat(kAutotuneNodeName, "[", i, "]"),
+          &node_name));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(
+          prefix(), strings::StrCat(kAutotuneParameterName, "[", i, "]"),
+          &parameter_name));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(
+          prefix(), strings::StrCat(kAutotuneParameterValue, "[", i, "]"),
+          &value));
+      values[node_name][parameter_name] = value;
+    }
+    model_->SetTunableParameterValues(values);
+    return absl::OkStatus();
+  }
+
   Status EnsureModelThreadStarted(IteratorContext* ctx) {
     mutex_lock l(mu_);
     if (!model_thread_) {
@@ -382,6 +502,9 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
   // The end time of the previous `GetNextInternal` call.
   uint64_t end_time_usec_ TF_GUARDED_BY(mu_) = 0;
 
+  // Fingerprint of the input pipeline, computed when it is first needed.
+  std::optional<uint64> fingerprint_ TF_GUARDED_BY(mu_);
+
   // Must be ordered last as its execution may depend on other members.
   std::unique_ptr<IteratorBase> input_impl_;
 };
@@ -60,6 +60,14 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// Weight of the latest request in the moving average of request latencies.
+constexpr double kLatencySmoothingFactor = 0.2;
+// A task is slow if its average latency is more than `kSlowTaskLatencyFactor`
+// times the median latency of the tasks.
+constexpr double kSlowTaskLatencyFactor = 2.0;
+// Slow tasks are only detected among at least this many tasks.
+constexpr int64_t kMinTasksForSlowTaskDetection = 3;
+
 bool IsColocatedTask(const TaskInfo& task) {
   return absl::c_any_of(task.worker_tags(), [](std::string_view worker_tag) {
     return absl::AsciiStrToUpper(worker_tag) == kColocatedWorkerTag;
@@ -423,6 +431,7 @@ Status DataServiceClient::AddTask(const TaskInfo& task_info)
       worker->GetDataTransferProtocol(),
       /*user_specified=*/!params_.data_transfer_protocol.empty());
   tasks_.push_back(std::make_shared<Task>(task_info, std::move(worker)));
+  tasks_.back()->straggler = task_info.straggler();
   worker_thread_cv_.notify_one();
   if (IsCoordinatedRead()) {
     VLOG(1) << "Consumer " << params_.consumer_index.value() << " adding task "
@@ -481,6 +490,7 @@ void DataServiceClient::Heartbeat() TF_LOCKS_EXCLUDED(mu_) {
     worker_thread_cv_.notify_all();
   }
   UpdateTasks(resp);
+  UpdateSlowTasks();
   RecordTFMetrics(resp);
 }
 
@@ -500,7 +510,9 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
     if (task_id_to_task.contains(task->info.task_id())) {
       // Remove already-known tasks from `task_id_to_task`, so that at the
       // end of the loop, only new tasks remain.
-      task_id_to_task.erase(task->info.task_id());
+      auto it = task_id_to_task.find(task->info.task_id());
+      task->straggler = it->second.straggler();
+      task_id_to_task.erase(it);
       ++index;
     } else {
       // Task has been removed.
@@ -535,6 +547,27 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
   }
 }
 
+void DataServiceClient::UpdateSlowTasks() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::vector<double> latencies;
+  for (const std::shared_ptr<Task>& task : tasks_) {
+    if (task->average_latency_usec > 0) {
+      latencies.push_back(task->average_latency_usec);
+    }
+  }
+  double slow_latency_usec = std::numeric_limits<double>::infinity();
+  if (static_cast<int64_t>(latencies.size()) >= kMinTasksForSlowTaskDetection) {
+    auto median = latencies.begin() + latencies.size() / 2;
+    std::nth_element(latencies.begin(), median, latencies.end());
+    slow_latency_usec = kSlowTaskLatencyFactor * *median;
+  }
+  for (const std::shared_ptr<Task>& task : tasks_) {
+    task->slow = task->average_latency_usec > slow_latency_usec;
+    VLOG_IF(3, task->slow) << "Task " << task->info.task_id() << " is slow, "
+                           << "with average latency "
+                           << task->average_latency_usec << "us.";
+  }
+}
+
 bool DataServiceClient::ShouldReadFromTask(const TaskInfo& task) const
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   if (IsCoordinatedRead()) {
@@ -714,6 +747,9 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
     return nullptr;
   }
 
+  // Stragglers and slow tasks are only read from if no other task can be
+  // processed.
+  std::shared_ptr<Task> straggler;
   for (int i = 0; i < tasks_.size(); ++i) {
     std::shared_ptr<Task>& task = tasks_[next_task_index_];
     if (IsCoordinatedRead() &&
@@ -737,11 +773,22 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
       AdvanceTaskIndex();
       continue;
     }
+    if (!IsCoordinatedRead() && (task->straggler || task->slow)) {
+      VLOG(3) << "Deferring straggler task " << next_task_index_;
+      if (straggler == nullptr) {
+        straggler = task;
+      }
+      AdvanceTaskIndex();
+      continue;
+    }
     task->round = current_round_;
     AdvanceTaskIndex();
     return task;
   }
-  return nullptr;
+  if (straggler != nullptr) {
+    straggler->round = current_round_;
+  }
+  return straggler;
 }
 
 // Increments the next task index, starting over if all tasks have been
@@ -817,10 +864,20 @@ Status DataServiceClient::GetElementTraced(Task* task, int64_t deadline_micros,
            {"round_index", task->round}});
     });
   }
+  const int64_t start_micros = Env::Default()->NowMicros();
   Status s =
       GetElement(task, deadline_micros, enqueue_result, allow_skip, result);
   mutex_lock l(mu_);
   VLOG(3) << "Got an element for task id " << task->info.task_id();
+  if (s.ok() && !result->skip && !result->end_of_sequence) {
+    // Skipped requests return immediately, so only count received elements.
+    const double latency_usec = Env::Default()->NowMicros() - start_micros;
+    task->average_latency_usec =
+        task->average_latency_usec == 0
+            ? latency_usec
+            : kLatencySmoothingFactor * latency_usec +
+                  (1 - kLatencySmoothingFactor) * task->average_latency_usec;
+  }
   return s;
 }
 
@@ -115,6 +115,14 @@ class DataServiceClient {
     // Number of retries. The more it is retried, the longer it should wait
     // before the next retry.
     int64_t num_retries = 0;
+    // Whether the dispatcher reported the task as a straggler in its last
+    // heartbeat.
+    bool straggler TF_GUARDED_BY(&DataServiceClient::mu_) = false;
+    // Moving average of the latency of the element requests to the task, or 0
+    // before the first element is received.
+    double average_latency_usec TF_GUARDED_BY(&DataServiceClient::mu_) = 0;
+    // Whether `average_latency_usec` is well above that of the other tasks.
+    bool slow TF_GUARDED_BY(&DataServiceClient::mu_) = false;
   };
 
   struct Result {
@@ -164,6 +172,9 @@ class DataServiceClient {
       const DataTransferServerInfo& transfer_server, const TaskInfo& task_info);
   void Heartbeat();
   void UpdateTasks(const ClientHeartbeatResponse& resp);
+  // Updates whether each task is slow, based on the latencies observed by
+  // this client.
+  void UpdateSlowTasks();
   bool ShouldReadFromTask(const TaskInfo& task) const;
   void RecordTFMetrics(const ClientHeartbeatResponse& resp);
   void UpdateBufferSize();
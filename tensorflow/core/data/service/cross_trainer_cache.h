@@ -16,18 +16,26 @@ limitations under the License.
 #define TENSORFLOW_CORE_DATA_SERVICE_CROSS_TRAINER_CACHE_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -46,6 +54,11 @@ namespace data {
 // collected when the cache becomes full. Consequently, trainers read from a
 // sliding window through the dataset and may not read the full dataset.
 //
+// Optionally, elements garbage collected from memory are spilled to chunk
+// files in a local directory, with a separate disk budget. Trainers that fall
+// behind the in-memory window then read from disk, and only skip data once
+// they also fall behind the spilled elements.
+//
 // The `CrossTrainerCache` class is thread-safe.
 //
 // Example usage:
@@ -89,6 +102,17 @@ class CachableSequence {
 
   // Returns the estimated size of the element in bytes.
   virtual size_t GetElementSizeBytes(const ElementType&) const = 0;
+
+  // Serializes and deserializes elements, so that the cache can spill them to
+  // disk. Only needed if the cache is given a spill directory.
+  virtual StatusOr<std::string> Serialize(const ElementType&) const {
+    return errors::Unimplemented(
+        "tf.data service cross-trainer cache elements cannot be spilled.");
+  }
+  virtual StatusOr<ElementType> Deserialize(absl::string_view) const {
+    return errors::Unimplemented(
+        "tf.data service cross-trainer cache elements cannot be spilled.");
+  }
 };
 
 // Sliding-window cache shared across concurrent trainers.
@@ -98,10 +122,15 @@ class CrossTrainerCache {
   // Creates a `CrossTrainerCache` with `max_cache_size_bytes` of memory budget.
   // The cache should be able to hold at least one element, i.e.:
   // REQUIRES: `max_cache_size_bytes >= max(GetElementSizeBytes(*))`
+  //
+  // If `spill_dir` is nonempty, elements freed from memory are spilled to
+  // `spill_dir`, using up to `max_spill_size_bytes` of disk.
   explicit CrossTrainerCache(
       size_t max_cache_size_bytes,
-      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence);
-  virtual ~CrossTrainerCache() = default;
+      std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+      std::string spill_dir = "", size_t max_spill_size_bytes = 0);
+  // Deletes the spilled chunk files.
+  virtual ~CrossTrainerCache();
   CrossTrainerCache(const CrossTrainerCache&) = delete;
   CrossTrainerCache& operator=(const CrossTrainerCache&) = delete;
 
@@ -126,6 +155,13 @@ class CrossTrainerCache {
     bool cache_hit;
   };
 
+  // Location of an element spilled to disk.
+  struct SpilledElement {
+    int64_t chunk_index;
+    uint64_t offset;
+    size_t size_bytes;
+  };
+
   // Returns the next element and metrics about this query.
   StatusOr<CacheQueryResult> GetCacheQueryResult(const std::string& trainer_id);
 
@@ -138,22 +174,45 @@ class CrossTrainerCache {
   // the cached elements).
   size_t GetElementIndex(const std::string& trainer_id);
 
-  // Returns the next element for `trainer_id`.
+  // Returns the next element for `trainer_id`, if it is in memory. Otherwise,
+  // returns the location of the element on disk.
   StatusOr<std::shared_ptr<const ElementType>> GetElement(
-      const std::string& trainer_id);
+      const std::string& trainer_id, std::optional<SpilledElement>& spilled);
+
+  // Reads an element spilled to disk.
+  StatusOr<std::shared_ptr<const ElementType>> ReadSpilledElement(
+      const SpilledElement& spilled) const;
 
   // Reads a new element and writes it into the cache.
   Status ExtendCache();
 
   // Frees old elements to keep the cache size below `max_cache_size_bytes_`.
   // `new_element_size_bytes` is the size of the new element being inserted.
+  // If spilling is enabled, the freed elements move to `spilling_`.
   void FreeSpace(size_t new_element_size_bytes);
 
+  // Writes `elements`, the elements in `spilling_`, to disk. If spilling
+  // fails, it is disabled, and the spilled elements are discarded.
+  void Spill(const std::vector<std::shared_ptr<const ElementType>>& elements);
+  Status WriteSpilledElements(
+      const std::vector<std::shared_ptr<const ElementType>>& elements,
+      std::vector<SpilledElement>& spilled);
+
+  // Discards the oldest chunks to keep the spilled size below
+  // `max_spill_size_bytes_`. Returns the files to delete.
+  std::vector<std::string> FreeSpillSpace();
+
+  // Returns the file name of the spilled chunk `chunk_index`.
+  std::string ChunkFilename(int64_t chunk_index) const;
+
   // Records the cache hit rate and cache size.
   void RecordMetrics(const CacheQueryResult& result);
 
   // Maximum cache size in bytes.
   const size_t max_cache_size_bytes_;
+  // Directory and maximum size in bytes of the spilled elements.
+  const std::string spill_dir_;
+  const size_t max_spill_size_bytes_;
 
   // The element sequence over which the sliding window cache operates.
   std::unique_ptr<CachableSequence<ElementType>> cachable_sequence_;
@@ -170,6 +229,23 @@ class CrossTrainerCache {
   size_t cache_size_bytes_ TF_GUARDED_BY(mu_) = 0;
   size_t cache_start_index_ TF_GUARDED_BY(mu_) = 0;
 
+  // The elements freed from `cache_`, which precede it. `spilled_` are on
+  // disk, and `spilling_` are being written by the thread extending the cache.
+  // Without spilling, both are empty and `spill_start_index_` is
+  // `cache_start_index_`.
+  bool spill_enabled_ TF_GUARDED_BY(mu_) = false;
+  std::deque<SpilledElement> spilled_ TF_GUARDED_BY(mu_);
+  std::deque<std::shared_ptr<const ElementType>> spilling_ TF_GUARDED_BY(mu_);
+  size_t spill_size_bytes_ TF_GUARDED_BY(mu_) = 0;
+  size_t spill_start_index_ TF_GUARDED_BY(mu_) = 0;
+
+  // The chunk file being written. Only accessed by the thread extending the
+  // cache.
+  std::string chunk_prefix_;
+  std::unique_ptr<WritableFile> chunk_file_;
+  int64_t chunk_index_ = -1;
+  uint64_t chunk_size_bytes_ = 0;
+
   // True if one thread is extending the cache.
   bool extending_cache_ TF_GUARDED_BY(mu_) = false;
 
@@ -180,16 +256,58 @@ class CrossTrainerCache {
       TF_GUARDED_BY(mu_);
 };
 
+// Spilled elements are written to chunk files of up to this size.
+constexpr uint64_t kCrossTrainerCacheSpillChunkSizeBytes = 64 << 20;  // 64MB
+
 template <class ElementType>
 CrossTrainerCache<ElementType>::CrossTrainerCache(
     size_t max_cache_size_bytes,
-    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence)
+    std::unique_ptr<CachableSequence<ElementType>> cachable_sequence,
+    std::string spill_dir, size_t max_spill_size_bytes)
     : max_cache_size_bytes_(max_cache_size_bytes),
+      spill_dir_(std::move(spill_dir)),
+      max_spill_size_bytes_(max_spill_size_bytes),
       cachable_sequence_(std::move(cachable_sequence)) {
   DCHECK_GT(max_cache_size_bytes, 0)
       << "CrossTrainerCache size must be greater than 0.";
   VLOG(2) << "Initialized tf.data service cross-trainer cache with "
           << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
+  if (spill_dir_.empty() || max_spill_size_bytes_ == 0) {
+    return;
+  }
+  Status s = Env::Default()->RecursivelyCreateDir(spill_dir_);
+  chunk_prefix_ = io::JoinPath(spill_dir_, "cross_trainer_cache");
+  if (s.ok() && !Env::Default()->CreateUniqueFileName(&chunk_prefix_, "")) {
+    s = errors::Internal("Failed to create a unique file name in ", spill_dir_);
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Not spilling the tf.data service cross-trainer cache "
+                 << "to disk: " << s;
+    return;
+  }
+  mutex_lock l(mu_);
+  spill_enabled_ = true;
+  VLOG(2) << "Spilling the tf.data service cross-trainer cache to "
+          << spill_dir_ << ", using up to "
+          << ByteSize::Bytes(max_spill_size_bytes_) << " of disk.";
+}
+
+template <class ElementType>
+CrossTrainerCache<ElementType>::~CrossTrainerCache() {
+  chunk_file_.reset();
+  std::optional<int64_t> first_chunk_index;
+  {
+    mutex_lock l(mu_);
+    if (!spilled_.empty()) {
+      first_chunk_index = spilled_.front().chunk_index;
+    }
+  }
+  for (int64_t i = first_chunk_index.value_or(chunk_index_); i <= chunk_index_;
+       ++i) {
+    if (i >= 0) {
+      Env::Default()->DeleteFile(ChunkFilename(i)).IgnoreError();
+    }
+  }
 }
 
 template <class ElementType>
@@ -212,20 +330,21 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
     const std::string& trainer_id) {
   bool should_extend_cache = false;
   while (true) {
+    std::optional<SpilledElement> spilled;
     {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(status_);
       if (IsElementReady(trainer_id)) {
         TF_ASSIGN_OR_RETURN(std::shared_ptr<const ElementType> element,
-                            GetElement(trainer_id));
-        return CacheQueryResult{element,
-                                /*is_cache_hit=*/!should_extend_cache};
-      }
-
-      // Extends the cache or waits for another thread to extend the cache. When
-      // concurrent trainers wait for the next element, only one of them should
-      // extend the cache.
-      if (extending_cache_) {
+                            GetElement(trainer_id, spilled));
+        if (!spilled.has_value()) {
+          return CacheQueryResult{element,
+                                  /*is_cache_hit=*/!should_extend_cache};
+        }
+      } else if (extending_cache_) {
+        // Extends the cache or waits for another thread to extend the cache.
+        // When concurrent trainers wait for the next element, only one of them
+        // should extend the cache.
         should_extend_cache = false;
         cv_.wait(l);
       } else {
@@ -234,6 +353,18 @@ CrossTrainerCache<ElementType>::GetCacheQueryResult(
       }
     }
 
+    if (spilled.has_value()) {
+      StatusOr<std::shared_ptr<const ElementType>> element =
+          ReadSpilledElement(*spilled);
+      // The chunk may have been discarded since, in which case the trainer
+      // moves on to the oldest element still cached.
+      if (!errors::IsNotFound(element.status())) {
+        TF_RETURN_IF_ERROR(element.status());
+        return CacheQueryResult{*element, /*is_cache_hit=*/true};
+      }
+      continue;
+    }
+
     if (should_extend_cache) {
       Status s = ExtendCache();
       mutex_lock l(mu_);
@@ -252,7 +383,8 @@ bool CrossTrainerCache<ElementType>::IsElementReady(
 
 template <class ElementType>
 StatusOr<std::shared_ptr<const ElementType>>
-CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
+CrossTrainerCache<ElementType>::GetElement(
+    const std::string& trainer_id, std::optional<SpilledElement>& spilled)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   size_t element_index = GetElementIndex(trainer_id);
   if (element_index >= std::numeric_limits<size_t>::max()) {
@@ -261,18 +393,49 @@ CrossTrainerCache<ElementType>::GetElement(const std::string& trainer_id)
         element_index);
   }
 
-  std::shared_ptr<const ElementType> result =
-      cache_[element_index - cache_start_index_];
   trainer_to_element_index_map_[trainer_id] = element_index + 1;
-  return result;
+  if (element_index >= cache_start_index_) {
+    return cache_[element_index - cache_start_index_];
+  }
+  const size_t spilling_start_index = cache_start_index_ - spilling_.size();
+  if (element_index >= spilling_start_index) {
+    return spilling_[element_index - spilling_start_index];
+  }
+  spilled = spilled_[element_index - spill_start_index_];
+  return nullptr;
+}
+
+template <class ElementType>
+StatusOr<std::shared_ptr<const ElementType>>
+CrossTrainerCache<ElementType>::ReadSpilledElement(
+    const SpilledElement& spilled) const TF_LOCKS_EXCLUDED(mu_) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(
+      ChunkFilename(spilled.chunk_index), &file));
+  std::string data(spilled.size_bytes, '\0');
+  absl::string_view result;
+  TF_RETURN_IF_ERROR(
+      file->Read(spilled.offset, spilled.size_bytes, &result, data.data()));
+  if (result.size() != spilled.size_bytes) {
+    return errors::DataLoss("Truncated tf.data service cross-trainer cache "
+                            "chunk ",
+                            ChunkFilename(spilled.chunk_index));
+  }
+  TF_ASSIGN_OR_RETURN(ElementType element,
+                      cachable_sequence_->Deserialize(result));
+  return std::make_shared<const ElementType>(std::move(element));
 }
 
 template <class ElementType>
 size_t CrossTrainerCache<ElementType>::GetElementIndex(
     const std::string& trainer_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  size_t element_index = trainer_to_element_index_map_[trainer_id];
-  if (element_index < cache_start_index_) {
-    element_index = cache_start_index_;
+  auto it = trainer_to_element_index_map_.find(trainer_id);
+  // New trainers start from the in-memory elements.
+  size_t element_index = it == trainer_to_element_index_map_.end()
+                             ? cache_start_index_
+                             : it->second;
+  if (element_index < spill_start_index_) {
+    element_index = spill_start_index_;
   }
   return element_index;
 }
@@ -289,11 +452,18 @@ Status CrossTrainerCache<ElementType>::ExtendCache() TF_LOCKS_EXCLUDED(mu_) {
         " and cache size: ", max_cache_size_bytes_);
   }
 
-  mutex_lock l(mu_);
-  TF_RETURN_IF_ERROR(status_);
-  FreeSpace(new_element_size_bytes);
-  cache_.push_back(std::make_shared<ElementType>(std::move(element)));
-  cache_size_bytes_ += new_element_size_bytes;
+  std::vector<std::shared_ptr<const ElementType>> elements_to_spill;
+  {
+    mutex_lock l(mu_);
+    TF_RETURN_IF_ERROR(status_);
+    FreeSpace(new_element_size_bytes);
+    cache_.push_back(std::make_shared<ElementType>(std::move(element)));
+    cache_size_bytes_ += new_element_size_bytes;
+    elements_to_spill.assign(spilling_.begin(), spilling_.end());
+  }
+  if (!elements_to_spill.empty()) {
+    Spill(elements_to_spill);
+  }
   return absl::OkStatus();
 }
 
@@ -305,17 +475,113 @@ void CrossTrainerCache<ElementType>::FreeSpace(size_t new_element_size_bytes)
          cache_size_bytes_ + new_element_size_bytes > max_cache_size_bytes_) {
     size_t free_bytes =
         cachable_sequence_->GetElementSizeBytes(*cache_.front());
+    if (spill_enabled_) {
+      spilling_.push_back(std::move(cache_.front()));
+    }
     cache_.pop_front();
     cache_size_bytes_ -= free_bytes;
     ++cache_start_index_;
     ++num_elements_discarded;
   }
+  if (!spill_enabled_) {
+    spill_start_index_ = cache_start_index_;
+  }
 
   VLOG(3) << "Freed " << num_elements_discarded << " element(s) from "
           << "tf.data service cross-trainer cache. Memory usage: "
           << ByteSize::Bytes(cache_size_bytes_) << ".";
 }
 
+template <class ElementType>
+void CrossTrainerCache<ElementType>::Spill(
+    const std::vector<std::shared_ptr<const ElementType>>& elements)
+    TF_LOCKS_EXCLUDED(mu_) {
+  std::vector<SpilledElement> spilled;
+  Status s = WriteSpilledElements(elements, spilled);
+  std::vector<std::string> files_to_delete;
+  {
+    mutex_lock l(mu_);
+    spilling_.erase(spilling_.begin(), spilling_.begin() + elements.size());
+    if (s.ok()) {
+      for (const SpilledElement& element : spilled) {
+        spilled_.push_back(element);
+        spill_size_bytes_ += element.size_bytes;
+      }
+      files_to_delete = FreeSpillSpace();
+    } else {
+      LOG(WARNING) << "Failed to spill the tf.data service cross-trainer "
+                   << "cache to disk. Spilling is disabled: " << s;
+      spill_enabled_ = false;
+      spilled_.clear();
+      spill_size_bytes_ = 0;
+      spill_start_index_ = cache_start_index_;
+      for (int64_t i = 0; i <= chunk_index_; ++i) {
+        files_to_delete.push_back(ChunkFilename(i));
+      }
+    }
+  }
+  if (!s.ok()) {
+    chunk_file_.reset();
+  }
+  for (const std::string& filename : files_to_delete) {
+    Env::Default()->DeleteFile(filename).IgnoreError();
+  }
+}
+
+template <class ElementType>
+Status CrossTrainerCache<ElementType>::WriteSpilledElements(
+    const std::vector<std::shared_ptr<const ElementType>>& elements,
+    std::vector<SpilledElement>& spilled) TF_LOCKS_EXCLUDED(mu_) {
+  for (const std::shared_ptr<const ElementType>& element : elements) {
+    TF_ASSIGN_OR_RETURN(std::string data,
+                        cachable_sequence_->Serialize(*element));
+    if (chunk_file_ == nullptr ||
+        chunk_size_bytes_ >= kCrossTrainerCacheSpillChunkSizeBytes) {
+      if (chunk_file_ != nullptr) {
+        TF_RETURN_IF_ERROR(chunk_file_->Close());
+      }
+      ++chunk_index_;
+      chunk_size_bytes_ = 0;
+      TF_RETURN_IF_ERROR(Env::Default()->NewWritableFile(
+          ChunkFilename(chunk_index_), &chunk_file_));
+    }
+    TF_RETURN_IF_ERROR(chunk_file_->Append(data));
+    spilled.push_back({chunk_index_, chunk_size_bytes_, data.size()});
+    chunk_size_bytes_ += data.size();
+  }
+  // Makes the elements visible to readers.
+  return chunk_file_->Flush();
+}
+
+template <class ElementType>
+std::vector<std::string> CrossTrainerCache<ElementType>::FreeSpillSpace()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::vector<std::string> files_to_delete;
+  // The chunk being written is never discarded.
+  while (spill_size_bytes_ > max_spill_size_bytes_ &&
+         spilled_.front().chunk_index < chunk_index_) {
+    const int64_t chunk_index = spilled_.front().chunk_index;
+    while (!spilled_.empty() && spilled_.front().chunk_index == chunk_index) {
+      spill_size_bytes_ -= spilled_.front().size_bytes;
+      spilled_.pop_front();
+      ++spill_start_index_;
+    }
+    files_to_delete.push_back(ChunkFilename(chunk_index));
+  }
+  if (!files_to_delete.empty()) {
+    VLOG(3) << "Discarded " << files_to_delete.size() << " spilled chunk(s) "
+            << "from tf.data service cross-trainer cache. Disk usage: "
+            << ByteSize::Bytes(spill_size_bytes_) << ".";
+  }
+  return files_to_delete;
+}
+
+template <class ElementType>
+std::string CrossTrainerCache<ElementType>::ChunkFilename(
+    int64_t chunk_index) const {
+  return absl::StrCat(chunk_prefix_, "_", chunk_index);
+}
+
 template <class ElementType>
 void CrossTrainerCache<ElementType>::Cancel(Status status)
     TF_LOCKS_EXCLUDED(mu_) {
@@ -22,7 +22,9 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
@@ -30,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/random.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
@@ -61,6 +64,25 @@ class InfiniteRange : public CachableSequence<int64_t> {
   int64_t next_ = 0;
 };
 
+class SpillableInfiniteRange : public InfiniteRange {
+ public:
+  absl::StatusOr<std::string> Serialize(const int64_t& element) const override {
+    return absl::StrCat(element);
+  }
+  absl::StatusOr<int64_t> Deserialize(absl::string_view data) const override {
+    int64_t element;
+    if (!absl::SimpleAtoi(data, &element)) {
+      return errors::DataLoss("Invalid element: ", data);
+    }
+    return element;
+  }
+};
+
+std::string SpillDir() {
+  return io::JoinPath(testing::TmpDir(),
+                      absl::StrCat("cross_trainer_cache_", random::New64()));
+}
+
 class TensorDataset : public CachableSequence<Tensor> {
  public:
   absl::StatusOr<Tensor> GetNext() override { return Tensor("Test Tensor"); }
@@ -190,6 +212,36 @@ TEST(CrossTrainerCacheTest, SlowTrainersSkipData) {
   EXPECT_THAT(cache.Get("Slow trainer 2"), IsOkAndHolds(Pointee(Gt(94))));
 }
 
+TEST(CrossTrainerCacheTest, SlowTrainersReadSpilledData) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<SpillableInfiniteRange>(), SpillDir(),
+      /*max_spill_size_bytes=*/1 << 20);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+
+  // The slow trainer reads the elements freed from memory from disk.
+  for (int i = 1; i < 100; ++i) {
+    EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  // New trainers start from the elements in memory.
+  EXPECT_THAT(cache.Get("New trainer"), IsOkAndHolds(Pointee(95)));
+}
+
+TEST(CrossTrainerCacheTest, UnspillableElementsAreDiscarded) {
+  CrossTrainerCache<int64_t> cache(
+      /*max_cache_size_bytes=*/5 * sizeof(int64_t),
+      std::make_unique<InfiniteRange>(), SpillDir(),
+      /*max_spill_size_bytes=*/1 << 20);
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(0)));
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_THAT(cache.Get("Fast trainer"), IsOkAndHolds(Pointee(i)));
+  }
+  EXPECT_THAT(cache.Get("Slow trainer"), IsOkAndHolds(Pointee(Gt(14))));
+}
+
 TEST(CrossTrainerCacheTest, NewTrainersStartLate) {
   CrossTrainerCache<int64_t> cache(
       /*max_cache_size_bytes=*/5 * sizeof(int64_t),
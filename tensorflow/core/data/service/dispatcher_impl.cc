@@ -105,6 +105,12 @@ constexpr absl::Duration kDefaultIterationGcTimeout = absl::Minutes(5);
 constexpr absl::Duration kDefaultClientTimeout = absl::Minutes(5);
 constexpr absl::Duration kDefaultWorkerTimeout = absl::Minutes(10);
 
+// A task is a straggler if its processing time is more than
+// `kStragglerProcessingTimeFactor` times the median of its iteration.
+constexpr double kStragglerProcessingTimeFactor = 2.0;
+// Stragglers are only detected among at least this many tasks.
+constexpr int64_t kMinTasksForStragglerDetection = 3;
+
 constexpr std::array<const char*, 8> kNodeNameSharingOps = {
     "HashTable",
     "HashTableV2",
@@ -396,9 +402,15 @@ Status DataServiceDispatcherImpl::FindNewTasks(
 void DataServiceDispatcherImpl::ReportProcessingTimesFromActiveTasks(
     const std::vector<ActiveTask>& active_tasks,
     const std::string& worker_address) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  absl::flat_hash_map<int64_t, double>& processing_times =
+      worker_processing_times_nsec_[worker_address];
+  processing_times.clear();
   for (const ActiveTask& active_task : active_tasks) {
     const int64_t task_id = active_task.task_id();
     const double processing_time_nsec = active_task.processing_time_nsec();
+    if (processing_time_nsec > 0) {
+      processing_times[task_id] = processing_time_nsec;
+    }
     VLOG(3) << "Received processing time from task id " << task_id
             << " in worker with address " << worker_address
             << ". Time in nanoseconds: " << processing_time_nsec;
@@ -1149,6 +1161,8 @@ Status DataServiceDispatcherImpl::ClientHeartbeat(
 
   std::vector<std::shared_ptr<const Task>> tasks;
   TF_RETURN_IF_ERROR(state_.TasksForIteration(iteration->iteration_id, tasks));
+  const absl::flat_hash_set<int64_t> straggler_tasks =
+      FindStragglerTasks(tasks);
   for (const auto& task : tasks) {
     TaskInfo* task_info = response->mutable_task_info()->Add();
     task_info->set_worker_address(task->worker_address);
@@ -1160,6 +1174,7 @@ Status DataServiceDispatcherImpl::ClientHeartbeat(
     task_info->set_iteration_id(iteration->iteration_id);
     task_info->set_worker_uid(task->worker_uid);
     task_info->set_starting_round(task->starting_round);
+    task_info->set_straggler(straggler_tasks.contains(task->task_id));
   }
   response->set_iteration_finished(iteration->finished);
   response->set_deployment_mode(config_.deployment_mode());
@@ -1169,6 +1184,42 @@ Status DataServiceDispatcherImpl::ClientHeartbeat(
   return absl::OkStatus();
 }
 
+absl::flat_hash_set<int64_t> DataServiceDispatcherImpl::FindStragglerTasks(
+    const std::vector<std::shared_ptr<const Task>>& tasks) const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::vector<std::pair<int64_t, double>> processing_times;
+  for (const auto& task : tasks) {
+    auto worker_it = worker_processing_times_nsec_.find(task->worker_address);
+    if (worker_it == worker_processing_times_nsec_.end()) {
+      continue;
+    }
+    auto task_it = worker_it->second.find(task->task_id);
+    if (task_it != worker_it->second.end()) {
+      processing_times.emplace_back(task->task_id, task_it->second);
+    }
+  }
+  absl::flat_hash_set<int64_t> stragglers;
+  if (static_cast<int64_t>(processing_times.size()) <
+      kMinTasksForStragglerDetection) {
+    return stragglers;
+  }
+  std::vector<double> sorted_times;
+  sorted_times.reserve(processing_times.size());
+  for (const auto& [task_id, processing_time] : processing_times) {
+    sorted_times.push_back(processing_time);
+  }
+  auto median = sorted_times.begin() + sorted_times.size() / 2;
+  std::nth_element(sorted_times.begin(), median, sorted_times.end());
+  for (const auto& [task_id, processing_time] : processing_times) {
+    if (processing_time > kStragglerProcessingTimeFactor * *median) {
+      VLOG(2) << "Task " << task_id << " is a straggler, with processing time "
+              << processing_time << "ns and median " << *median << "ns.";
+      stragglers.insert(task_id);
+    }
+  }
+  return stragglers;
+}
+
 Status DataServiceDispatcherImpl::GetWorkers(const GetWorkersRequest* request,
                                              GetWorkersResponse* response) {
   TF_RETURN_IF_ERROR(CheckStarted());
@@ -254,10 +254,16 @@ class DataServiceDispatcherImpl {
       const absl::flat_hash_set<int64_t>& current_tasks,
       std::vector<std::shared_ptr<const DispatcherState::Task>>& assigned_tasks,
       WorkerHeartbeatResponse* response);
-  // Reports the processing time of each active task to `auto_scaler_`.
+  // Reports the processing time of each active task to `auto_scaler_`, and
+  // records it in `worker_processing_times_nsec_`.
   void ReportProcessingTimesFromActiveTasks(
       const std::vector<ActiveTask>& active_tasks,
       const std::string& worker_address) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the ids of the `tasks` whose workers are stragglers, i.e. whose
+  // reported processing time is well above that of the other workers.
+  absl::flat_hash_set<int64_t> FindStragglerTasks(
+      const std::vector<std::shared_ptr<const DispatcherState::Task>>& tasks)
+      const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Acquires an iteration client id to read from the given iteration and sets
   // `iteration_client_id`.
   Status AcquireIterationClientId(
@@ -379,6 +385,10 @@ class DataServiceDispatcherImpl {
   // Map from worker address to the time of the worker's last heartbeat.
   absl::flat_hash_map<std::string, absl::Time> latest_worker_heartbeats_time_
       TF_GUARDED_BY(mu_);
+  // Map from worker address to the processing times of its active tasks, by
+  // task id, in the worker's last heartbeat.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<int64_t, double>>
+      worker_processing_times_nsec_ TF_GUARDED_BY(mu_);
 
   // TODO(mpcallanan): Don't recover completed snapshots.
   // TODO(mpcallanan): Garbage collect completed snapshots.
@@ -12,13 +12,16 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/snapshot_utils.h"
@@ -29,6 +32,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/tstring.h"
@@ -45,6 +50,8 @@ constexpr const char* const kOutputShapes = "output_shapes";
 constexpr const char* const kSnapshotChunkDataset = "SnapshotChunkDataset";
 
 constexpr int64_t kTFRecordReaderOutputBufferSize = 512 << 20;  // 512MB
+// Elements are read and decoded ahead of the consumer, up to this many bytes.
+constexpr size_t kMaxPrefetchedBytes = 64 << 20;  // 64MB
 
 absl::string_view GetSnapshotPath(absl::string_view chunk_file) {
   // Snapshot chunks are placed in snapshot_path/chunks/chunk_x.
@@ -125,7 +132,10 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
     explicit Iterator(const Params& params)
         : DatasetIterator<Dataset>(params) {}
 
-    ~Iterator() override { RecordBytesRead(); }
+    ~Iterator() override {
+      StopReadThread();
+      RecordBytesRead();
+    }
 
     absl::Status Initialize(IteratorContext* ctx) override {
       reader_ = std::make_unique<snapshot_util::TFRecordReader>(
@@ -139,7 +149,16 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) override {
       *end_of_sequence = false;
-      absl::Status status = reader_->ReadTensors(out_tensors);
+      mutex_lock l(mu_);
+      if (read_thread_ == nullptr) {
+        // Reading and decoding the chunk overlaps with the consumer.
+        read_thread_ = ctx->StartThread("tf_data_snapshot_chunk_reader",
+                                        [this]() { ReadThread(); });
+      }
+      while (buffer_.empty()) {
+        cond_var_.wait(l);
+      }
+      absl::Status status = buffer_.front().status();
       if (absl::IsOutOfRange(status)) {
         *end_of_sequence = true;
         return absl::OkStatus();
@@ -147,6 +166,12 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_WITH_CONTEXT_IF_ERROR(
           status,
           " Failed to read tf.data snapshot file: ", dataset()->chunk_file_);
+      *out_tensors = std::move(*buffer_.front());
+      buffer_.pop_front();
+      for (const Tensor& tensor : *out_tensors) {
+        buffer_bytes_ -= tensor.TotalBytes();
+      }
+      cond_var_.notify_all();
       ++start_index_;
       return status;
     }
@@ -160,6 +185,7 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
 
     absl::Status RestoreInternal(IteratorContext* ctx,
                                  IteratorStateReader* reader) override {
+      StopReadThread();
       TF_RETURN_IF_ERROR(
           reader->ReadScalar(full_name(kStartIndex), &start_index_));
       TF_RETURN_IF_ERROR(Initialize(ctx));
@@ -178,14 +204,71 @@ class SnapshotChunkDatasetOp::Dataset : public DatasetBase {
       return absl::OkStatus();
     }
 
+    // Reads elements into `buffer_` until the end of the chunk, an error, or
+    // cancellation. The status ending the reads is added to `buffer_`.
+    void ReadThread() {
+      while (true) {
+        {
+          mutex_lock l(mu_);
+          while (!cancelled_ && buffer_bytes_ >= kMaxPrefetchedBytes) {
+            cond_var_.wait(l);
+          }
+          if (cancelled_) {
+            return;
+          }
+        }
+        std::vector<Tensor> tensors;
+        absl::Status status = reader_->ReadTensors(&tensors);
+        mutex_lock l(mu_);
+        if (!status.ok()) {
+          buffer_.push_back(std::move(status));
+          cond_var_.notify_all();
+          return;
+        }
+        for (const Tensor& tensor : tensors) {
+          buffer_bytes_ += tensor.TotalBytes();
+        }
+        buffer_.push_back(std::move(tensors));
+        cond_var_.notify_all();
+      }
+    }
+
+    // Stops the read thread, and discards the elements read ahead.
+    void StopReadThread() {
+      {
+        mutex_lock l(mu_);
+        cancelled_ = true;
+        cond_var_.notify_all();
+      }
+      std::unique_ptr<Thread> read_thread;
+      {
+        mutex_lock l(mu_);
+        read_thread = std::move(read_thread_);
+      }
+      read_thread.reset();
+      mutex_lock l(mu_);
+      cancelled_ = false;
+      buffer_.clear();
+      buffer_bytes_ = 0;
+    }
+
     void RecordBytesRead() {
       uint64_t bytes_read = reader_->BytesRead();
       metrics::GetTFDataBytesReadCounter(kSnapshotChunkDataset)
           ->IncrementBy(bytes_read);
     }
 
+    // Only used by the read thread once it is started.
     std::unique_ptr<snapshot_util::TFRecordReader> reader_;
     int64_t start_index_ = 0;
+
+    mutex mu_;
+    condition_variable cond_var_;
+    std::unique_ptr<Thread> read_thread_ TF_GUARDED_BY(mu_);
+    bool cancelled_ TF_GUARDED_BY(mu_) = false;
+    // Elements read ahead, followed by the status ending the reads, if any.
+    std::deque<absl::StatusOr<std::vector<Tensor>>> buffer_ TF_GUARDED_BY(mu_);
+    size_t buffer_bytes_ TF_GUARDED_BY(mu_) = 0;
   };
 
   const tstring chunk_file_;
@@ -17,9 +17,11 @@ limitations under the License.
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/env.h"
@@ -100,8 +103,10 @@ Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
         worker_config.cross_trainer_cache_size_bytes() > 0
             ? worker_config.cross_trainer_cache_size_bytes()
             : kDefaultCrossTrainerCacheSizeBytes;
-    out = std::make_unique<CachingTaskRunner>(std::move(iterator),
-                                              max_cache_size_bytes);
+    out = std::make_unique<CachingTaskRunner>(
+        std::move(iterator), max_cache_size_bytes,
+        worker_config.cross_trainer_cache_spill_dir(),
+        worker_config.cross_trainer_cache_spill_size_bytes());
   } else {
     out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
   }
@@ -178,10 +183,13 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
 }
 
 CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                                     size_t max_cache_size_bytes)
+                                     size_t max_cache_size_bytes,
+                                     const std::string& spill_dir,
+                                     size_t max_spill_size_bytes)
     : fcfs_task_runner_(std::move(iterator)),
       cache_(max_cache_size_bytes,
-             std::make_unique<GetElementResultSequence>(fcfs_task_runner_)) {
+             std::make_unique<GetElementResultSequence>(fcfs_task_runner_),
+             spill_dir, max_spill_size_bytes) {
   LOG(INFO) << "Initialized tf.data service cross-trainer cache with "
             << ByteSize::Bytes(max_cache_size_bytes) << " of memory.";
 }
@@ -217,6 +225,41 @@ size_t CachingTaskRunner::GetElementResultSequence::GetElementSizeBytes(
   return element.EstimatedMemoryUsageBytes();
 }
 
+absl::StatusOr<std::string>
+CachingTaskRunner::GetElementResultSequence::Serialize(
+    const GetElementResult& element) const {
+  GetElementResponse response;
+  for (const Tensor& component : element.components) {
+    component.AsProtoTensorContent(
+        response.mutable_uncompressed()->add_components());
+  }
+  response.set_element_index(element.element_index);
+  return response.SerializeAsString();
+}
+
+absl::StatusOr<GetElementResult>
+CachingTaskRunner::GetElementResultSequence::Deserialize(
+    absl::string_view data) const {
+  GetElementResponse response;
+  if (!response.ParseFromArray(data.data(), data.size())) {
+    return errors::DataLoss(
+        "Failed to parse a spilled tf.data service cross-trainer cache "
+        "element.");
+  }
+  GetElementResult result;
+  for (const TensorProto& proto : response.uncompressed().components()) {
+    Tensor component;
+    if (!component.FromProto(proto)) {
+      return errors::DataLoss(
+          "Failed to parse a spilled tf.data service cross-trainer cache "
+          "tensor.");
+    }
+    result.components.push_back(std::move(component));
+  }
+  result.element_index = response.element_index();
+  return result;
+}
+
 void CachingTaskRunner::Cancel() {
   VLOG(2) << "Cancelling tf.data service cross-trainer cache task.";
   if (!cache_.IsCancelled()) {
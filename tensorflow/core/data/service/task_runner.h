@@ -17,8 +17,10 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -153,8 +155,12 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
 // read the full dataset.
 class CachingTaskRunner : public TaskRunner {
  public:
+  // If `spill_dir` is nonempty, elements freed from memory are spilled to it,
+  // using up to `max_spill_size_bytes` of disk.
   explicit CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
-                             size_t max_cache_size_bytes);
+                             size_t max_cache_size_bytes,
+                             const std::string& spill_dir = "",
+                             size_t max_spill_size_bytes = 0);
   ~CachingTaskRunner() override;
 
   // Gets the next element from the cross-trainer cache, blocking if the data is
@@ -180,6 +186,10 @@ class CachingTaskRunner : public TaskRunner {
         FirstComeFirstServedTaskRunner& fcfs_task_runner);
     absl::StatusOr<GetElementResult> GetNext() override;
     size_t GetElementSizeBytes(const GetElementResult& element) const override;
+    absl::StatusOr<std::string> Serialize(
+        const GetElementResult& element) const override;
+    absl::StatusOr<GetElementResult> Deserialize(
+        absl::string_view data) const override;
 
    private:
     FirstComeFirstServedTaskRunner& fcfs_task_runner_;
@@ -27,6 +27,7 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "xla/tsl/lib/io/snappy/snappy_inputbuffer.h"
 #include "xla/tsl/lib/io/snappy/snappy_outputbuffer.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -781,6 +782,11 @@ absl::StatusOr<std::vector<Tensor>> TFRecordReaderImpl::GetTensors() {
   return tensors;
 }
 
+Status TFRecordReaderImpl::Skip(int num_tensors) {
+  int num_skipped = 0;
+  return record_reader_->SkipRecords(&offset_, num_tensors, &num_skipped);
+}
+
 absl::StatusOr<Tensor> TFRecordReaderImpl::Parse(const tstring& record) {
   TensorProto proto;
   if (!proto.ParseFromArray(record.data(), record.size())) {
@@ -800,10 +806,32 @@ absl::StatusOr<Tensor> TFRecordReaderImpl::Parse(const tstring& record) {
 
 Status TFRecordReader::ReadTensors(std::vector<Tensor>* read_tensors) {
   read_tensors->clear();
-  read_tensors->reserve(dtypes_.size());
-  for (int i = 0; i < dtypes_.size(); ++i) {
+  if (projection_.empty()) {
+    read_tensors->reserve(dtypes_.size());
+    for (int i = 0; i < dtypes_.size(); ++i) {
+      TF_ASSIGN_OR_RETURN(Tensor tensor, reader_impl_.GetNext());
+      read_tensors->push_back(std::move(tensor));
+    }
+    return absl::OkStatus();
+  }
+
+  read_tensors->reserve(projection_.size());
+  int64_t next_component = 0;
+  for (const int64_t component : projection_) {
+    if (component < next_component || component >= dtypes_.size()) {
+      return errors::InvalidArgument(
+          "Snapshot projection must hold increasing component indices in [0, ",
+          dtypes_.size(), "), got ", absl::StrJoin(projection_, ", "), ".");
+    }
+    if (component > next_component) {
+      TF_RETURN_IF_ERROR(reader_impl_.Skip(component - next_component));
+    }
     TF_ASSIGN_OR_RETURN(Tensor tensor, reader_impl_.GetNext());
     read_tensors->push_back(std::move(tensor));
+    next_component = component + 1;
+  }
+  if (next_component < dtypes_.size()) {
+    TF_RETURN_IF_ERROR(reader_impl_.Skip(dtypes_.size() - next_component));
   }
   return absl::OkStatus();
 }
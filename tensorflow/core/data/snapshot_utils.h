@@ -267,6 +267,9 @@ class TFRecordReaderImpl {
   // Reads all Tensors in the input file.
   absl::StatusOr<std::vector<Tensor>> GetTensors();
 
+  // Skips the next `num_tensors` Tensors without parsing them.
+  Status Skip(int num_tensors);
+
   // Returns the number of bytes read.
   uint64_t BytesRead() const { return bytes_read_; }
 
@@ -287,18 +290,25 @@ class TFRecordReaderImpl {
 // Reads snapshots previously written with `TFRecordWriter`.
 class TFRecordReader : public Reader {
  public:
+  // `projection` holds the indices of the components to read, in increasing
+  // order. If empty, all components are read. Since each component is written
+  // as a separate record, the records of the other components are skipped
+  // without being parsed.
   TFRecordReader(const std::string& filename, const string& compression,
                  const DataTypeVector& dtypes,
-                 std::optional<int64_t> output_buffer_size = std::nullopt)
+                 std::optional<int64_t> output_buffer_size = std::nullopt,
+                 std::vector<int64_t> projection = {})
       : reader_impl_(filename, compression, output_buffer_size),
-        dtypes_(dtypes) {}
+        dtypes_(dtypes),
+        projection_(std::move(projection)) {}
 
   // Initializes the reader. Callers must initialize the reader before calling
   // `ReadTensors`.
   Status Initialize(Env* env) override { return reader_impl_.Initialize(env); }
 
   // Reads Tensors into `read_tensors`. Returns OK on success, OutOfRange for
-  // end of file, or an error status if there is an error.
+  // end of file, or an error status if there is an error. If a projection is
+  // set, only reads the projected components.
   Status ReadTensors(std::vector<Tensor>* read_tensors) override;
 
   // Returns the number of bytes read.
@@ -307,6 +317,7 @@ class TFRecordReader : public Reader {
  private:
   TFRecordReaderImpl reader_impl_;
   const DataTypeVector dtypes_;
+  const std::vector<int64_t> projection_;
 };
 
 // Reads snapshots previously written with `CustomWriter`.
@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/data/snapshot_utils.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "tensorflow/core/data/service/test_util.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -99,6 +102,43 @@ TEST(SnapshotUtilTest, CombinationRoundTripTest) {
   SnapshotRoundTrip(io::compression::kSnappy, 2);
 }
 
+TEST(SnapshotUtilTest, TFRecordReaderProjection) {
+  std::vector<Tensor> tensors;
+  DataTypeVector dtypes;
+  for (int i = 0; i < 5; ++i) {
+    tensors.push_back(Tensor(static_cast<int64_t>(i)));
+    dtypes.push_back(DT_INT64);
+  }
+  std::string filename = LocalTempFilename();
+  TFRecordWriter writer(filename, io::compression::kSnappy);
+  TF_ASSERT_OK(writer.Initialize(Env::Default()));
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(writer.WriteTensors(tensors));
+  }
+  TF_ASSERT_OK(writer.Close());
+
+  TFRecordReader reader(filename, io::compression::kSnappy, dtypes,
+                        /*output_buffer_size=*/std::nullopt,
+                        /*projection=*/{1, 2, 4});
+  TF_ASSERT_OK(reader.Initialize(Env::Default()));
+  std::vector<Tensor> read_tensors;
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(reader.ReadTensors(&read_tensors));
+    ASSERT_EQ(read_tensors.size(), 3);
+    EXPECT_EQ(read_tensors[0].scalar<int64_t>()(), 1);
+    EXPECT_EQ(read_tensors[1].scalar<int64_t>()(), 2);
+    EXPECT_EQ(read_tensors[2].scalar<int64_t>()(), 4);
+  }
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadTensors(&read_tensors)));
+
+  TFRecordReader invalid_reader(filename, io::compression::kSnappy, dtypes,
+                                /*output_buffer_size=*/std::nullopt,
+                                /*projection=*/{2, 1});
+  TF_ASSERT_OK(invalid_reader.Initialize(Env::Default()));
+  EXPECT_TRUE(
+      absl::IsInvalidArgument(invalid_reader.ReadTensors(&read_tensors)));
+}
+
 TEST(SnapshotUtilTest, MetadataFileRoundTrip) {
   experimental::DistributedSnapshotMetadata metadata_in;
   metadata_in.set_compression(io::compression::kGzip);
@@ -0,0 +1,161 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/raw_coding.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tsl/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kIndexSuffix[] = ".index";
+constexpr uint64_t kMagic = 0x78646e6963657274;  // "trecindx"
+constexpr size_t kHeaderSize = 2 * sizeof(uint64_t);
+
+}  // namespace
+
+std::string TFRecordIndexFilename(absl::string_view filename) {
+  return absl::StrCat(filename, kIndexSuffix);
+}
+
+void TFRecordIndexBuilder::AddRecord(size_t record_size) {
+  offsets_.push_back(next_offset_);
+  next_offset_ += io::RecordWriter::kHeaderSize + record_size +
+                  io::RecordWriter::kFooterSize;
+}
+
+absl::Status TFRecordIndexBuilder::Write(Env* env,
+                                         const std::string& filename) const {
+  std::string contents;
+  contents.reserve(kHeaderSize + offsets_.size() * sizeof(uint64_t) +
+                   sizeof(uint32_t));
+  core::PutFixed64(&contents, kMagic);
+  core::PutFixed64(&contents, offsets_.size());
+  for (const uint64_t offset : offsets_) {
+    core::PutFixed64(&contents, offset);
+  }
+  const uint32_t crc = crc32c::Value(contents.data(), contents.size());
+  core::PutFixed32(&contents, crc32c::Mask(crc));
+  return WriteStringToFile(env, TFRecordIndexFilename(filename), contents);
+}
+
+absl::Status BuildTFRecordIndex(Env* env, const std::string& filename) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+  io::RecordReader reader(file.get());
+  TFRecordIndexBuilder builder;
+  uint64_t offset = 0;
+  while (true) {
+    const uint64_t record_offset = offset;
+    int num_skipped = 0;
+    absl::Status s = reader.SkipRecords(&offset, 1, &num_skipped);
+    if (absl::IsOutOfRange(s)) {
+      break;
+    }
+    TF_RETURN_IF_ERROR(s);
+    builder.AddRecord(offset - record_offset - io::RecordWriter::kHeaderSize -
+                      io::RecordWriter::kFooterSize);
+  }
+  return builder.Write(env, filename);
+}
+
+absl::StatusOr<TFRecordIndex> TFRecordIndex::Read(
+    Env* env, const std::string& filename) {
+  const std::string index_filename = TFRecordIndexFilename(filename);
+  std::string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, index_filename, &contents));
+  if (contents.size() < kHeaderSize + sizeof(uint32_t) ||
+      core::DecodeFixed64(contents.data()) != kMagic) {
+    return absl::DataLossError(
+        absl::StrCat(index_filename, " is not a TFRecord index."));
+  }
+  const uint64_t num_records =
+      core::DecodeFixed64(contents.data() + sizeof(uint64_t));
+  const size_t crc_offset = contents.size() - sizeof(uint32_t);
+  if (num_records != (crc_offset - kHeaderSize) / sizeof(uint64_t) ||
+      (crc_offset - kHeaderSize) % sizeof(uint64_t) != 0 ||
+      crc32c::Unmask(core::DecodeFixed32(contents.data() + crc_offset)) !=
+          crc32c::Value(contents.data(), crc_offset)) {
+    return absl::DataLossError(
+        absl::StrCat("Corrupted TFRecord index ", index_filename, "."));
+  }
+  std::vector<uint64_t> offsets(num_records);
+  for (uint64_t i = 0; i < num_records; ++i) {
+    offsets[i] = core::DecodeFixed64(contents.data() + kHeaderSize +
+                                     i * sizeof(uint64_t));
+  }
+  return TFRecordIndex(std::move(offsets));
+}
+
+absl::StatusOr<std::unique_ptr<IndexedTFRecordReader>>
+IndexedTFRecordReader::Open(Env* env, const std::vector<std::string>& filenames,
+                            const io::RecordReaderOptions& options) {
+  auto reader = absl::WrapUnique(new IndexedTFRecordReader());
+  reader->files_.reserve(filenames.size());
+  for (const std::string& filename : filenames) {
+    TF_ASSIGN_OR_RETURN(TFRecordIndex index,
+                        TFRecordIndex::Read(env, filename));
+    std::unique_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+    reader->cumulative_num_records_.push_back(
+        reader->cumulative_num_records_.back() + index.num_records());
+    reader->files_.push_back(
+        std::make_unique<File>(std::move(file), std::move(index), options));
+  }
+  return reader;
+}
+
+absl::Status IndexedTFRecordReader::ReadRecord(int64_t index,
+                                               tstring* record) const {
+  if (index < 0 || index >= num_records()) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "Record index out of range [0, ", num_records(), "): ", index));
+  }
+  // The file holding `index` is the last one with fewer records before it.
+  const size_t file_index =
+      std::upper_bound(cumulative_num_records_.begin(),
+                       cumulative_num_records_.end(), index) -
+      cumulative_num_records_.begin() - 1;
+  File& file = *files_[file_index];
+  uint64_t offset =
+      file.index.offset(index - cumulative_num_records_[file_index]);
+  mutex_lock l(file.mu);
+  return file.reader->ReadRecord(&offset, record);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,132 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+#define TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+// A TFRecord index is a sidecar file, stored next to an uncompressed TFRecord
+// file as `<filename>.index`, which holds the byte offset of each record. It
+// lets readers seek to record `i` directly instead of scanning the file.
+//
+// Format:
+//   fixed64  magic
+//   fixed64  number of records
+//   fixed64  offset of each record
+//   fixed32  masked crc32c of the above
+
+// Returns the name of the index file of the TFRecord file `filename`.
+std::string TFRecordIndexFilename(absl::string_view filename);
+
+// Builds the index of a TFRecord file as it is written. Call `AddRecord` for
+// each record passed to `RecordWriter::WriteRecord`, and `Write` once the
+// writer is closed.
+class TFRecordIndexBuilder {
+ public:
+  void AddRecord(size_t record_size);
+  int64_t num_records() const { return offsets_.size(); }
+
+  // Writes the index of the TFRecord file `filename`.
+  absl::Status Write(Env* env, const std::string& filename) const;
+
+ private:
+  std::vector<uint64_t> offsets_;
+  uint64_t next_offset_ = 0;
+};
+
+// Scans the uncompressed TFRecord file `filename`, and writes its index.
+absl::Status BuildTFRecordIndex(Env* env, const std::string& filename);
+
+// The record offsets of a TFRecord file.
+class TFRecordIndex {
+ public:
+  // Reads the index of the TFRecord file `filename`. Returns NotFound if the
+  // file has no index.
+  static absl::StatusOr<TFRecordIndex> Read(Env* env,
+                                            const std::string& filename);
+
+  int64_t num_records() const { return offsets_.size(); }
+  uint64_t offset(int64_t index) const { return offsets_[index]; }
+
+ private:
+  explicit TFRecordIndex(std::vector<uint64_t> offsets)
+      : offsets_(std::move(offsets)) {}
+
+  std::vector<uint64_t> offsets_;
+};
+
+// Reads arbitrary records of a set of indexed TFRecord files, which are
+// numbered consecutively across files, with one seek per record.
+//
+// Thread-safe.
+class IndexedTFRecordReader {
+ public:
+  // Opens `filenames` and their indexes. Returns NotFound if a file has no
+  // index.
+  static absl::StatusOr<std::unique_ptr<IndexedTFRecordReader>> Open(
+      Env* env, const std::vector<std::string>& filenames,
+      const io::RecordReaderOptions& options);
+
+  int64_t num_records() const { return cumulative_num_records_.back(); }
+
+  // Reads the record at `index`.
+  // REQUIRES: 0 <= index < num_records().
+  absl::Status ReadRecord(int64_t index, tstring* record) const;
+
+ private:
+  struct File {
+    File(std::unique_ptr<RandomAccessFile> file, TFRecordIndex index,
+         const io::RecordReaderOptions& options)
+        : file(std::move(file)),
+          index(std::move(index)),
+          reader(std::make_unique<io::RecordReader>(this->file.get(),
+                                                    options)) {}
+
+    const std::unique_ptr<RandomAccessFile> file;
+    const TFRecordIndex index;
+    mutex mu;
+    // Borrows `file`, and is not thread-safe.
+    const std::unique_ptr<io::RecordReader> reader TF_PT_GUARDED_BY(mu);
+  };
+
+  IndexedTFRecordReader() = default;
+
+  std::vector<std::unique_ptr<File>> files_;
+  // `cumulative_num_records_[i]` is the number of records in the first `i`
+  // files.
+  std::vector<int64_t> cumulative_num_records_ = {0};
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_TFRECORD_INDEX_H_
@@ -0,0 +1,130 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/tfrecord_index.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tsl::testing::StatusIs;
+
+std::string TestFilename(const std::string& name) {
+  return io::JoinPath(testing::TmpDir(), name);
+}
+
+// Writes `records` to `filename`, optionally with an index.
+absl::Status WriteRecords(const std::string& filename,
+                          const std::vector<std::string>& records,
+                          bool write_index) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  TFRecordIndexBuilder builder;
+  for (const std::string& record : records) {
+    TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+    builder.AddRecord(record.size());
+  }
+  TF_RETURN_IF_ERROR(writer.Close());
+  TF_RETURN_IF_ERROR(file->Close());
+  if (write_index) {
+    TF_RETURN_IF_ERROR(builder.Write(Env::Default(), filename));
+  }
+  return absl::OkStatus();
+}
+
+TEST(TFRecordIndexTest, ReadRecords) {
+  const std::vector<std::string> filenames = {TestFilename("read_records_1"),
+                                              TestFilename("read_records_2"),
+                                              TestFilename("read_records_3")};
+  TF_ASSERT_OK(WriteRecords(filenames[0], {"a", "bb", "ccc"},
+                            /*write_index=*/true));
+  TF_ASSERT_OK(WriteRecords(filenames[1], {}, /*write_index=*/true));
+  TF_ASSERT_OK(WriteRecords(filenames[2], {"", std::string(1000, 'd')},
+                            /*write_index=*/true));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IndexedTFRecordReader> reader,
+      IndexedTFRecordReader::Open(Env::Default(), filenames,
+                                  io::RecordReaderOptions()));
+  EXPECT_EQ(reader->num_records(), 5);
+  const std::vector<std::string> expected = {"a", "bb", "ccc", "",
+                                             std::string(1000, 'd')};
+  tstring record;
+  for (int64_t i : {4, 0, 3, 2, 1, 4}) {
+    TF_ASSERT_OK(reader->ReadRecord(i, &record));
+    EXPECT_EQ(record, expected[i]);
+  }
+  EXPECT_THAT(reader->ReadRecord(5, &record),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(reader->ReadRecord(-1, &record),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+TEST(TFRecordIndexTest, BuildIndexOfExistingFile) {
+  const std::string filename = TestFilename("build_index");
+  TF_ASSERT_OK(WriteRecords(filename, {"x", "", "zzz"},
+                            /*write_index=*/false));
+  EXPECT_THAT(TFRecordIndex::Read(Env::Default(), filename),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  TF_ASSERT_OK(BuildTFRecordIndex(Env::Default(), filename));
+  TF_ASSERT_OK_AND_ASSIGN(TFRecordIndex index,
+                          TFRecordIndex::Read(Env::Default(), filename));
+  ASSERT_EQ(index.num_records(), 3);
+  EXPECT_EQ(index.offset(0), 0);
+  EXPECT_EQ(index.offset(1), 17);
+  EXPECT_EQ(index.offset(2), 33);
+}
+
+TEST(TFRecordIndexTest, RejectsCorruptedIndex) {
+  const std::string filename = TestFilename("corrupted_index");
+  TF_ASSERT_OK(WriteRecords(filename, {"a", "b"}, /*write_index=*/true));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(),
+                                TFRecordIndexFilename(filename), &contents));
+  contents[20] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(),
+                                 TFRecordIndexFilename(filename), contents));
+  EXPECT_THAT(TFRecordIndex::Read(Env::Default(), filename),
+              StatusIs(absl::StatusCode::kDataLoss, HasSubstr("Corrupted")));
+
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(),
+                                 TFRecordIndexFilename(filename), "index"));
+  EXPECT_THAT(TFRecordIndex::Read(Env::Default(), filename),
+              StatusIs(absl::StatusCode::kDataLoss,
+                       HasSubstr("is not a TFRecord index")));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -369,7 +369,11 @@ void CollectiveParamResolverDistributed::CompleteInstanceDistributed(
   if (group_leader_.empty()) {
     // This is the group leader so resolution is local.
     return CompleteInstanceLocal(device, cp, done);
-  } else if (InstanceIsCached(cp->group.group_key, cp->instance)) {
+  } else if (cp->instance.type != BROADCAST_COLLECTIVE ||
+             InstanceIsCached(cp->group.group_key, cp->instance)) {
+    // Only broadcasts need the leader, to learn the rank of the source. Other
+    // instances are resolved from the cached group, so that new instance keys
+    // and step ids do not block on an RPC to the leader during the step.
     return CompleteInstanceLocal(device, cp, done);
   } else {
     CompleteInstanceCall* call = new CompleteInstanceCall(
@@ -58,6 +58,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -454,7 +455,6 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
     partitions_.emplace_back();
     Part* part = &partitions_.back();
     part->name = name_def.first;
-    TrackFeedsAndFetches(part, name_def.second, popts);
     part->worker = worker_cache_->GetOrCreateWorker(part->name);
     if (part->worker == nullptr) {
       s = errors::NotFound("worker ", part->name);
@@ -475,20 +475,41 @@ Status MasterSession::ReffedClientGraph::DoRegisterPartitions(
   };
   const int num = partitions_.size();
   absl::InlinedVector<Call, 4UL> calls(num);
+  // Preparing the requests visits every node of every partition, so it is
+  // done for the partitions in parallel. Each shard only touches its own
+  // partitions.
+  int64_t num_nodes = 0;
+  for (const auto& name_def : graph_partitions) {
+    num_nodes += name_def.second.node_size();
+  }
+  auto prepare_requests = [&](int64_t start, int64_t limit) {
+    for (int64_t i = start; i < limit; ++i) {
+      Part* part = &partitions_[i];
+      Call* c = &calls[i];
+      GraphDef& graph_def = graph_partitions.find(part->name)->second;
+      TrackFeedsAndFetches(part, graph_def, popts);
+      c->req.set_session_handle(session_handle_);
+      c->req.set_create_worker_session_called(!should_deregister_);
+      c->req.mutable_graph_def()->Swap(&graph_def);
+      StripDefaultAttributes(*OpRegistry::Global(),
+                             c->req.mutable_graph_def()->mutable_node());
+      *c->req.mutable_config_proto() = session_opts_.config;
+      *c->req.mutable_graph_options() = session_opts_.config.graph_options();
+      *c->req.mutable_debug_options() =
+          callable_opts_.run_options().debug_options();
+      c->req.set_collective_graph_key(collective_graph_key_);
+    }
+  };
+  // Roughly the cycles to track and strip the attributes of one node.
+  constexpr int64_t kCostPerNode = 1000;
+  ComputePool(session_opts_)
+      ->ParallelFor(num, kCostPerNode * (num_nodes / std::max(num, 1) + 1),
+                    prepare_requests);
+
   BlockingCounter done(num);
   for (int i = 0; i < num; ++i) {
     const Part& part = partitions_[i];
     Call* c = &calls[i];
-    c->req.set_session_handle(session_handle_);
-    c->req.set_create_worker_session_called(!should_deregister_);
-    c->req.mutable_graph_def()->Swap(&graph_partitions[part.name]);
-    StripDefaultAttributes(*OpRegistry::Global(),
-                           c->req.mutable_graph_def()->mutable_node());
-    *c->req.mutable_config_proto() = session_opts_.config;
-    *c->req.mutable_graph_options() = session_opts_.config.graph_options();
-    *c->req.mutable_debug_options() =
-        callable_opts_.run_options().debug_options();
-    c->req.set_collective_graph_key(collective_graph_key_);
     VLOG(2) << "Register " << c->req.graph_def().DebugString();
     auto cb = [c, &done](const Status& s) {
       c->status = s;
@@ -1187,15 +1208,23 @@ void BuildBuildGraphOptions(const PartialRunSetupRequest& req,
 
 uint64 HashBuildGraphOptions(const BuildGraphOptions& opts) {
   uint64 h = 0x2b992ddfa23249d6ull;
+  // The number of names in each list is hashed too, so that e.g. feeding "a"
+  // and fetching "b" differs from fetching both "a" and "b".
   for (const string& name : opts.callable_options.feed()) {
     h = Hash64(name.c_str(), name.size(), h);
   }
+  h = Hash64Combine(h, opts.callable_options.feed_size());
   for (const string& name : opts.callable_options.target()) {
     h = Hash64(name.c_str(), name.size(), h);
   }
+  h = Hash64Combine(h, opts.callable_options.target_size());
   for (const string& name : opts.callable_options.fetch()) {
     h = Hash64(name.c_str(), name.size(), h);
   }
+  h = Hash64Combine(h, opts.callable_options.fetch_size());
+  // Graphs with different collective keys get different step ids.
+  h = Hash64Combine(h, opts.collective_graph_key);
+  h = Hash64Combine(h, static_cast<uint64>(opts.collective_order));
 
   const DebugOptions& debug_options =
       opts.callable_options.run_options().debug_options();
@@ -173,6 +173,11 @@ class ExchangeQueue {
   // Returns nullptr if there is no such exchange.
   Exchange* GetReadyForRequestWriting();
 
+  // Returns whether exchanges were added after `exchange`.
+  bool HasExchangesAfter(const Exchange& exchange) const {
+    return !exchanges_.empty() && &exchange != &exchanges_.back();
+  }
+
   // Returns an exchange for which we can initiate response reading, if any.
   // Returns nullptr if there is no such exchange.
   Exchange* GetReadyForResponseReading();
@@ -398,8 +403,17 @@ class StreamingRPCState : public UntypedStreamingRPCState {
     }
     exchange->MarkRequestWriteIssued();
     Ref();
+    // When more requests are already queued, let gRPC buffer this one so that
+    // a burst of small requests (e.g. remote eager ops) goes out in a few
+    // frames. The last queued request is written without the hint, which
+    // flushes the buffered ones.
+    ::grpc::WriteOptions options;
+    if (exchanges_.HasExchangesAfter(*exchange)) {
+      options.set_buffer_hint();
+    }
     VLOG(3) << "StreamingRPCState(" << this << ") calling grpc::Write";
-    call_->Write(exchange->request_buf(), &request_write_completed_tag_);
+    call_->Write(exchange->request_buf(), options,
+                 &request_write_completed_tag_);
   }
 
   void MaybeIssueResponseReadLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
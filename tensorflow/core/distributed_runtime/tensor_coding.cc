@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/platform/notification.h"
 
 namespace tensorflow {
 
@@ -81,6 +82,20 @@ void TensorResponse::InitPartial(const RecvTensorResponse& response,
 
 Status TensorResponse::ParseFrom(Source* source) {
   if (!on_host_) {
+    const DeviceBase::AcceleratorDeviceInfo* device_info =
+        device_->tensorflow_accelerator_device_info();
+    if (device_info != nullptr && device_info->default_context != nullptr) {
+      // Parse the content straight into a staging tensor in host memory the
+      // device can DMA from, rather than into `meta_` first, saving a copy of
+      // the content.
+      AllocatorAttributes staging_attrs;
+      staging_attrs.set_on_host(true);
+      staging_attrs.set_gpu_compatible(true);
+      if (ParseFast(source, device_->GetAllocator(staging_attrs))) {
+        return CopyToDevice(device_info->default_context);
+      }
+      ClearTensor();
+    }
     protobuf::io::CodedInputStream input(source->contents());
 
     // Pre-parse into local storage, then delegate to device.
@@ -101,7 +116,7 @@ Status TensorResponse::ParseFrom(Source* source) {
     ClearTensor();
   }
   already_used_ = true;
-  if (ParseFast(source)) return absl::OkStatus();
+  if (ParseFast(source, allocator_)) return absl::OkStatus();
   meta_.Clear();
   if (ParseSlow(source)) return absl::OkStatus();
   return errors::InvalidArgument("Cannot parse tensor from response");
@@ -144,7 +159,8 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 }  // namespace
 
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta,
+    Allocator* allocator) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -155,7 +171,7 @@ bool TensorResponse::ParseTensorSubmessage(
       if (ok && !seen_tensor_content) {
         // No tensor content: could be because it's a zero-length tensor
         TensorShape shape(tensor_meta->tensor_shape());
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
+        Tensor t(allocator, tensor_meta->dtype(), shape);
         tensor_ = std::move(t);
       }
       return ok;
@@ -195,7 +211,7 @@ bool TensorResponse::ParseTensorSubmessage(
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
         TensorShape shape(tensor_meta->tensor_shape());
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
+        Tensor t(allocator, tensor_meta->dtype(), shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
         // TODO(jeff,sanjay): Figure out a way to avoid this copy if
@@ -215,7 +231,7 @@ bool TensorResponse::ParseTensorSubmessage(
   }
 }
 
-bool TensorResponse::ParseFast(Source* source) {
+bool TensorResponse::ParseFast(Source* source, Allocator* allocator) {
   protobuf::io::CodedInputStream input(source->contents());
   while (true) {
     auto p = input.ReadTagWithCutoff(127);
@@ -233,7 +249,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(&input, meta_.mutable_tensor(), allocator)) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
@@ -275,6 +291,21 @@ bool TensorResponse::ParseFast(Source* source) {
   return false;
 }
 
+Status TensorResponse::CopyToDevice(DeviceContext* device_context) {
+  Tensor host_tensor = std::move(tensor_);
+  tensor_ = Tensor(allocator_, host_tensor.dtype(), host_tensor.shape());
+  Notification n;
+  Status status;
+  device_context->CopyCPUTensorToDevice(&host_tensor,
+                                        static_cast<Device*>(device_), &tensor_,
+                                        [&n, &status](const Status& s) {
+                                          status = s;
+                                          n.Notify();
+                                        });
+  n.WaitForNotification();
+  return status;
+}
+
 bool TensorResponse::ParseSlow(Source* source) {
   if (!meta_.ParseFromZeroCopyStream(source->contents())) {
     return false;
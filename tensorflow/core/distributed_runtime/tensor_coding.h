@@ -26,6 +26,7 @@ limitations under the License.
 namespace tensorflow {
 
 class DeviceBase;
+class DeviceContext;
 class TensorProto;
 
 // TensorResponse can be used as the destination of an RPC that returns
@@ -91,11 +92,16 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
+  // Parses the tensor content directly into a tensor allocated by
+  // `allocator`.
   bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
-                             TensorProto* tensor_meta);
-  bool ParseFast(Source* source);
+                             TensorProto* tensor_meta, Allocator* allocator);
+  bool ParseFast(Source* source, Allocator* allocator);
   bool ParseSlow(Source* source);
 
+  // Copies tensor_, parsed into host memory, to device_.
+  Status CopyToDevice(DeviceContext* device_context);
+
   bool on_host_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
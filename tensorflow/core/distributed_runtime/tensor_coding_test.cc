@@ -15,10 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <cstring>
+
+#include "absl/status/status.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
@@ -156,6 +160,94 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+// Copies tensors to the "device" with memcpy, and counts the copies.
+class CountingDeviceContext : public DeviceContext {
+ public:
+  void CopyCPUTensorToDevice(const Tensor* cpu_tensor, Device* device,
+                             Tensor* device_tensor, StatusCallback done,
+                             bool sync_dst_compute) const override {
+    ++num_copies_;
+    StringPiece src = cpu_tensor->tensor_data();
+    memcpy(const_cast<char*>(device_tensor->tensor_data().data()), src.data(),
+           src.size());
+    done(absl::OkStatus());
+  }
+
+  mutable int num_copies_ = 0;
+};
+
+class DummyAcceleratorDevice : public DeviceBase {
+ public:
+  explicit DummyAcceleratorDevice(Env* env) : DeviceBase(env) {
+    attr_.set_device_type("GPU");
+    device_info_.default_context = &device_context_;
+    set_tensorflow_accelerator_device_info(&device_info_);
+  }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+  Status MakeTensorFromProto(const TensorProto& tensor_proto,
+                             const AllocatorAttributes alloc_attrs,
+                             Tensor* tensor) override {
+    ++num_protos_;
+    if (!tensor->FromProto(cpu_allocator(), tensor_proto)) {
+      return errors::InvalidArgument("Cannot parse tensor from proto");
+    }
+    return absl::OkStatus();
+  }
+
+  int num_copies() const { return device_context_.num_copies_; }
+  int num_protos() const { return num_protos_; }
+
+ private:
+  DeviceAttributes attr_;
+  CountingDeviceContext device_context_;
+  AcceleratorDeviceInfo device_info_;
+  int num_protos_ = 0;
+};
+
+TEST(TensorResponseDeviceTest, ParsesIntoStagingTensor) {
+  Tensor src(DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&src, {1, 2, 3, 4, 5, 6});
+  RecvTensorResponse proto;
+  proto.set_send_start_micros(123456);
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+  StringSource source(&encoded, 1024);
+
+  DummyAcceleratorDevice device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&device, AllocatorAttributes());
+  TF_EXPECT_OK(response.ParseFrom(&source));
+  test::ExpectTensorEqual<float>(response.tensor(), src);
+  EXPECT_EQ(response.metadata().send_start_micros(), 123456);
+  EXPECT_EQ(device.num_copies(), 1);
+  EXPECT_EQ(device.num_protos(), 0);
+}
+
+TEST(TensorResponseDeviceTest, FallsBackToTensorProto) {
+  Tensor src(DT_STRING, TensorShape({2}));
+  test::FillValues<tstring>(&src, {"a", "b"});
+  RecvTensorResponse proto;
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+  StringSource source(&encoded, 1024);
+
+  DummyAcceleratorDevice device(Env::Default());
+  TensorResponse response;
+  response.InitAlloc(&device, AllocatorAttributes());
+  TF_EXPECT_OK(response.ParseFrom(&source));
+  test::ExpectTensorEqual<tstring>(response.tensor(), src);
+  EXPECT_EQ(device.num_copies(), 0);
+  EXPECT_EQ(device.num_protos(), 1);
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
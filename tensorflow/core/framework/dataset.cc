@@ -1229,6 +1229,82 @@ Status DatasetBaseIterator::Skip(IteratorContext* ctx, int num_to_skip,
   return s;
 }
 
+Status DatasetBaseIterator::GetNextBlock(IteratorContext* ctx,
+                                         int64_t max_elements,
+                                         std::vector<Tensor>* out_tensors,
+                                         int64_t* num_elements,
+                                         bool* end_of_sequence) {
+  tsl::profiler::TraceMe activity([&] { return BuildTraceMeName(); },
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  DVLOG(3) << prefix() << " GetNextBlock enter";
+  if (max_elements <= 0) {
+    return errors::InvalidArgument(
+        "GetNextBlock expects a positive number of elements, got ",
+        max_elements, ".");
+  }
+  bool output_was_recording =
+      node_ && node_->output() && node_->output()->is_recording();
+  if (collect_resource_usage(ctx)) {
+    int64_t now_nanos = EnvTime::NowNanos();
+    if (output_was_recording) {
+      node_->output()->record_stop(now_nanos);
+    }
+    node_->record_start(now_nanos);
+  }
+  out_tensors->clear();
+  *num_elements = 0;
+  Status s = GetNextBlockInternal(ctx, max_elements, out_tensors, num_elements,
+                                  end_of_sequence);
+  ctx->SaveCheckpoint(this);
+  if (!SymbolicCheckpointCompatible()) {
+    ctx->UpdateCheckpointStatus([this]() {
+      return errors::Unimplemented(dataset()->type_string(),
+                                   " does not support symbolic checkpointing.");
+    });
+  }
+  if (TF_PREDICT_TRUE(s.ok())) {
+    if (TF_PREDICT_TRUE(!*end_of_sequence)) {
+      if (TF_PREDICT_FALSE(out_tensors->size() !=
+                           dataset()->output_dtypes().size())) {
+        return errors::Internal("Expected ", dataset()->output_dtypes().size(),
+                                " components but got ", out_tensors->size(),
+                                ".");
+      }
+      if (collect_resource_usage(ctx)) {
+        // Each element of the block counts as an element produced.
+        int64_t num_bytes = GetAllocatedBytes(*out_tensors);
+        for (int64_t i = 0; i < *num_elements; ++i) {
+          node_->record_element();
+        }
+        node_->record_bytes_produced(num_bytes);
+        if (node_->output()) {
+          node_->output()->record_bytes_consumed(num_bytes);
+        }
+      }
+    } else {
+      out_tensors->clear();
+      *num_elements = 0;
+    }
+  }
+  if (collect_resource_usage(ctx)) {
+    int64_t now_nanos = EnvTime::NowNanos();
+    node_->record_stop(now_nanos);
+    if (output_was_recording) {
+      node_->output()->record_start(now_nanos);
+    }
+  }
+  if (TF_PREDICT_FALSE(errors::IsOutOfRange(s))) {
+    s = errors::Internal("Iterator \"", params_.prefix,
+                         "\" returned `OutOfRange`. This indicates an "
+                         "implementation error as `OutOfRange` errors are not "
+                         "expected to be returned here. Original message: ",
+                         s.message());
+    LOG(ERROR) << s;
+  }
+  DVLOG(3) << prefix() << " GetNextBlock exit";
+  return s;
+}
+
 Status DatasetBaseIterator::SkipInternal(IteratorContext* ctx, int num_to_skip,
                                          bool* end_of_sequence,
                                          int* num_skipped) {
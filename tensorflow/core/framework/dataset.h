@@ -1100,6 +1100,29 @@ class IteratorBase : public Checkpointable {
     return Skip(&ctx, num_to_skip, end_of_sequence, num_skipped);
   }
 
+  // Gets the next `max_elements` elements of the sequence as a block: one
+  // tensor per tuple component, holding the elements stacked along a new 0th
+  // dimension, as `BatchDataset` would batch them. `*num_elements` stores the
+  // number of elements in the block.
+  //
+  // Fewer than `max_elements` elements are returned only at the end of the
+  // sequence. `*end_of_sequence` is set to `true` only if there are no
+  // elements left, in which case `*out_tensors` is empty.
+  //
+  // Only iterators for which `SupportsBlocks()` is true implement this method.
+  virtual Status GetNextBlock(IteratorContext* ctx, int64_t max_elements,
+                              std::vector<Tensor>* out_tensors,
+                              int64_t* num_elements, bool* end_of_sequence) {
+    return errors::Unimplemented("GetNextBlock is not supported for this ",
+                                 "iterator.");
+  }
+
+  // Returns whether this iterator can produce blocks of elements with
+  // `GetNextBlock()`, without the per-element overhead of `GetNext()`.
+  // Consumers that batch their input may then use blocks instead, as long as
+  // their context has no index mapper (i.e. no global shuffling).
+  virtual bool SupportsBlocks() const { return false; }
+
   // Returns a vector of DataType values, representing the respective
   // element types of each tuple component in the outputs of this
   // iterator.
@@ -1537,6 +1560,10 @@ class DatasetBaseIterator : public IteratorBase {
   Status Skip(IteratorContext* ctx, int num_to_skip, bool* end_of_sequence,
               int* num_skipped) final;
 
+  Status GetNextBlock(IteratorContext* ctx, int64_t max_elements,
+                      std::vector<Tensor>* out_tensors, int64_t* num_elements,
+                      bool* end_of_sequence) final;
+
   Status Save(SerializationContext* ctx, IteratorStateWriter* writer) final {
     VLOG(2) << "Attempting to save checkpoints on iterator (prefix: "
             << prefix() << ") from " << dataset()->DebugString();
@@ -1573,6 +1600,19 @@ class DatasetBaseIterator : public IteratorBase {
   virtual Status SkipInternal(IteratorContext* ctx, int num_to_skip,
                               bool* end_of_sequence, int* num_skipped);
 
+  // Internal implementation of GetNextBlock that is wrapped in tracing logic.
+  // Iterators that override it must also override `SupportsBlocks()`.
+  // Implementations may assume that `*out_tensors` is empty and that
+  // `max_elements` is positive.
+  virtual Status GetNextBlockInternal(IteratorContext* ctx,
+                                      int64_t max_elements,
+                                      std::vector<Tensor>* out_tensors,
+                                      int64_t* num_elements,
+                                      bool* end_of_sequence) {
+    return errors::Unimplemented("GetNextBlock is not supported for ",
+                                 dataset()->type_string(), ".");
+  }
+
   string full_name(const string& name) const {
     return FullName(params_.prefix, name);
   }
@@ -16,10 +16,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 #define TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -89,7 +91,9 @@ class LocalRendezvous {
   // nullptr otherwise.
   Rendezvous* rc_owner_;
 
-  struct TableBucket {
+  // Buckets are cache line aligned, so that threads sending to different
+  // buckets do not contend on the same cache line.
+  struct ABSL_CACHELINE_ALIGNED TableBucket {
     mutex mu;
     Table table TF_GUARDED_BY(mu);
 
@@ -102,6 +106,9 @@ class LocalRendezvous {
   const std::unique_ptr<TableBucket[]> table_buckets_;
   mutex mu_;
   Status status_ TF_GUARDED_BY(mu_);
+  // Set once `status_` is an error, so that Send and Recv check for an abort
+  // without taking `mu_`, which all buckets would otherwise contend on.
+  std::atomic<bool> aborted_{false};
 
   // We deliberately leak one reference of the aborted rendezvous here, so that
   // they won't be destructed, and lose the status_.
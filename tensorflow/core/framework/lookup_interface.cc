@@ -30,6 +30,11 @@ Status LookupInterface::CheckKeyShape(const TensorShape& shape) {
   return absl::OkStatus();
 }
 
+Status LookupInterface::GetAdmissionStats(AdmissionStats* stats) const {
+  return errors::Unimplemented("Table ", DebugString(),
+                               " has no admission policy");
+}
+
 Status LookupInterface::CheckKeyAndValueTypes(const Tensor& keys,
                                               const Tensor& values) {
   if (keys.dtype() != key_dtype()) {
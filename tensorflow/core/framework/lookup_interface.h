@@ -142,6 +142,20 @@ class LookupInterface : public ResourceBase {
     return nullptr;
   }
 
+  // Counters of the admission and eviction policies of a table.
+  struct AdmissionStats {
+    // Keys added to the table by Insert.
+    int64_t num_admitted = 0;
+    // New keys that Insert dropped because they were not frequent enough.
+    int64_t num_rejected = 0;
+    // Keys removed to keep the table within its memory limit.
+    int64_t num_evicted = 0;
+  };
+
+  // Fills `stats` for tables with admission and eviction policies. Returns
+  // Unimplemented for other tables.
+  virtual Status GetAdmissionStats(AdmissionStats* stats) const;
+
  protected:
   virtual ~LookupInterface() = default;
 
@@ -79,6 +79,17 @@ auto* graph_unused_outputs = tsl::monitoring::Counter<1>::New(
     "/tensorflow/core/graph_unused_outputs",
     "The number of unused outputs for ops of a given type.", "name");
 
+auto* mkl_primitive_cache_lookups = tsl::monitoring::Counter<1>::New(
+    "/tensorflow/core/mkl_primitive_cache_lookups",
+    "The number of lookups in the primitive cache of the oneDNN kernels, by "
+    "result (hit or miss).",
+    "result");
+
+auto* mkl_primitive_cache_evictions = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/mkl_primitive_cache_evictions",
+    "The number of primitives evicted from the primitive cache of the oneDNN "
+    "kernels.");
+
 auto* tf_data_fetch_op_counter = tsl::monitoring::Counter<1>::New(
     "/tensorflow/data/fetch_op",
     "The number of times a tf.data operation that fetches output(s) of a "
@@ -104,6 +115,12 @@ auto* tf_data_bytes_fetched_counter = tsl::monitoring::Counter<0>::New(
     "/tensorflow/data/bytes_fetched",
     "The number of bytes fetched from tf.data Dataset iterator.");
 
+auto* tf_data_padded_batch_values_counter = tsl::monitoring::Counter<1>::New(
+    "/tensorflow/data/padded_batch_values",
+    "The number of values in the batches produced by tf.data padded batch "
+    "transformations, by whether they are data or padding.",
+    "type");
+
 auto* tf_data_elements_counter = tsl::monitoring::Counter<1>::New(
     "/tensorflow/data/elements", "tf.data elements", "name");
 
@@ -530,6 +547,13 @@ void RecordTFDataBytesFetched(int64_t num_bytes) {
   tf_data_bytes_fetched_counter->GetCell()->IncrementBy(num_bytes);
 }
 
+void RecordTFDataPaddedBatch(int64_t num_values, int64_t num_padding_values) {
+  tf_data_padded_batch_values_counter->GetCell("data")->IncrementBy(
+      num_values - num_padding_values);
+  tf_data_padded_batch_values_counter->GetCell("padding")->IncrementBy(
+      num_padding_values);
+}
+
 void RecordTFDataExperiment(const string& name) {
   tf_data_experiment_counter->GetCell(name)->IncrementBy(1);
 }
@@ -925,6 +949,17 @@ void RecordUnusedOutput(const string& op_name) {
   graph_unused_outputs->GetCell(op_name)->IncrementBy(1);
 }
 
+void RecordMklPrimitiveCacheLookup(bool hit) {
+  // Looked up on every execution of a oneDNN kernel.
+  static auto* hits = mkl_primitive_cache_lookups->GetCell("hit");
+  static auto* misses = mkl_primitive_cache_lookups->GetCell("miss");
+  (hit ? hits : misses)->IncrementBy(1);
+}
+
+void RecordMklPrimitiveCacheEviction() {
+  mkl_primitive_cache_evictions->GetCell()->IncrementBy(1);
+}
+
 void RecordPipelineProcessingTime(const string& id,
                                   double pipeline_processing_time_usec) {
   GetTFDataPipelineProcessingTimeGauge(id)->Set(pipeline_processing_time_usec);
@@ -81,6 +81,10 @@ monitoring::GaugeCell<std::function<std::string()>>* GetTFDataModelGauge(
 // Records the number of bytes fetched from tf.data.Dataset iterator.
 void RecordTFDataBytesFetched(int64_t num_bytes);
 
+// Records the number of values in the batches produced by a tf.data padded
+// batch transformation, and how many of them are padding.
+void RecordTFDataPaddedBatch(int64_t num_values, int64_t num_padding_values);
+
 // Records the number of times a tf.data experiment was applied.
 void RecordTFDataExperiment(const string& name);
 
@@ -272,6 +276,14 @@ void UpdateGraphPendingQueueLength(uint64 len);
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const string& op_name);
 
+// Records a lookup in the primitive cache of the oneDNN kernels, and whether
+// the primitive was found.
+void RecordMklPrimitiveCacheLookup(bool hit);
+
+// Records that a primitive was evicted from the primitive cache of the oneDNN
+// kernels to make room for another one.
+void RecordMklPrimitiveCacheEviction();
+
 // Records the pipeline processing time in microseconds
 void RecordPipelineProcessingTime(const string& id,
                                   double pipeline_processing_time_usec);
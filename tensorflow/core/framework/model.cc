@@ -786,6 +786,14 @@ class KnownRatio : public Node {
  public:
   KnownRatio(Node::Args args, double ratio) : Node(args), ratio_(ratio) {}
 
+  KnownRatio(Node::Args args, double ratio,
+             std::vector<std::shared_ptr<Parameter>> parameters)
+      : Node(args), ratio_(ratio) {
+    for (auto& parameter : parameters) {
+      parameters_[parameter->name] = std::move(parameter);
+    }
+  }
+
   ~KnownRatio() override {}
 
   double Ratio() const override { return ratio_; }
@@ -867,6 +875,16 @@ class KnownRatio : public Node {
         self_processing_time + inputs_processing_time;
   }
 
+  // A synchronous node buffers elements only if it has a (non-tunable)
+  // buffer size, e.g. the buffer of a shuffle.
+  double MaximumBufferedBytes() const override TF_SHARED_LOCKS_REQUIRED(mu_) {
+    auto* parameter = gtl::FindOrNull(parameters_, kBufferSize);
+    if (parameter == nullptr) {
+      return 0.0;
+    }
+    return (*parameter)->value * AverageBufferedElementSizeLocked();
+  }
+
   Status ToProto(ModelProto::Node* node_proto) const override {
     TF_RETURN_IF_ERROR(Node::ToProto(node_proto));
     node_proto->set_node_class(NodeClass::KNOWN_RATIO);
@@ -1443,6 +1461,13 @@ std::shared_ptr<Node> MakeKnownRatioNode(Node::Args args, double ratio) {
   return std::make_shared<KnownRatio>(std::move(args), ratio);
 }
 
+std::shared_ptr<Node> MakeKnownRatioNode(
+    Node::Args args, double ratio,
+    std::vector<std::shared_ptr<Parameter>> parameters) {
+  return std::make_shared<KnownRatio>(std::move(args), ratio,
+                                      std::move(parameters));
+}
+
 std::shared_ptr<Node> MakeAsyncKnownRatioNode(
     Node::Args args, double ratio, double memory_ratio,
     std::vector<std::shared_ptr<Parameter>> parameters,
@@ -1647,6 +1672,50 @@ Node::ModelParameters Node::CollectNodeTunableParameters() const {
   return parameters;
 }
 
+absl::flat_hash_map<string, double> Node::TunableParameterValues() const {
+  absl::flat_hash_map<string, double> values;
+  // The state mutexes are acquired without holding `mu_`, because iterators
+  // record into their node while holding them.
+  for (const auto& parameter : CollectNodeParameters()) {
+    if (parameter->state == nullptr || !parameter->state->tunable) {
+      continue;
+    }
+    mutex_lock l(*parameter->state->mu);
+    if (parameter->state->value != kAutotune) {
+      values[parameter->name] = parameter->state->value;
+    }
+  }
+  return values;
+}
+
+void Node::SetTunableParameterValues(
+    const absl::flat_hash_map<string, double>& values) {
+  for (const auto& parameter : CollectNodeParameters()) {
+    const double* value = gtl::FindOrNull(values, parameter->name);
+    if (value == nullptr || parameter->state == nullptr ||
+        !parameter->state->tunable) {
+      continue;
+    }
+    const double new_value =
+        std::min(std::max(*value, parameter->min), parameter->max);
+    VLOG(2) << "Setting tunable parameter " << long_name()
+            << ":: " << parameter->name << " to " << new_value;
+    mutex_lock l(*parameter->state->mu);
+    parameter->state->value = new_value;
+    parameter->state->cond_var->notify_all();
+  }
+}
+
+std::vector<std::shared_ptr<Parameter>> Node::CollectNodeParameters() const {
+  std::vector<std::shared_ptr<Parameter>> parameters;
+  tf_shared_lock l(mu_);
+  parameters.reserve(parameters_.size());
+  for (const auto& pair : parameters_) {
+    parameters.push_back(pair.second);
+  }
+  return parameters;
+}
+
 string Node::DebugString() const {
   absl::flat_hash_map<string, string> debug_strings;
   tf_shared_lock l(mu_);
@@ -2144,6 +2213,8 @@ Status Node::ToProto(ModelProto::Node* node_proto) const {
   node_proto->set_name(name_);
   node_proto->set_autotune(autotune_);
   node_proto->set_buffered_bytes(buffered_bytes_);
+  node_proto->set_maximum_buffered_bytes(autotune_ ? MaximumBufferedBytes()
+                                                   : 0);
   node_proto->set_buffered_elements(buffered_elements_);
   node_proto->set_bytes_consumed(bytes_consumed_);
   node_proto->set_bytes_produced(bytes_produced_);
@@ -2391,13 +2462,8 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
                         ram_budget_manager);
       break;
     case AutotuneAlgorithm::GRADIENT_DESCENT:
-      LOG(WARNING) << "AutotuneAlgorithm::GRADIENT_DESCENT and prefetch "
-                      "legacy autotuner should not be turned on together"
-                   << "as OptimizeGradientDescent will update state values "
-                      "without consulting ram_budget_manager first."
-                   << "This might cause out-of-memory (OOM)";
       OptimizeGradientDescent(snapshot, optimization_params,
-                              cancellation_manager);
+                              cancellation_manager, ram_budget_manager);
       break;
     case AutotuneAlgorithm::STAGE_BASED:
       OptimizeStageBased(snapshot, optimization_params, cancellation_manager,
@@ -2465,6 +2531,37 @@ void Model::RemoveNode(std::shared_ptr<Node> node) {
   }
 }
 
+Model::TunableParameterValues Model::GetTunableParameterValues() const {
+  TunableParameterValues values;
+  std::shared_ptr<Node> root = output();
+  if (root == nullptr) {
+    return values;
+  }
+  Node::NodeVector nodes = root->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(root);
+  for (const auto& node : nodes) {
+    auto node_values = node->TunableParameterValues();
+    if (!node_values.empty()) {
+      values[node->name()] = std::move(node_values);
+    }
+  }
+  return values;
+}
+
+void Model::SetTunableParameterValues(const TunableParameterValues& values) {
+  std::shared_ptr<Node> root = output();
+  if (root == nullptr) {
+    return;
+  }
+  Node::NodeVector nodes = root->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(root);
+  for (const auto& node : nodes) {
+    if (const auto* node_values = gtl::FindOrNull(values, node->name())) {
+      node->SetTunableParameterValues(*node_values);
+    }
+  }
+}
+
 Model::ModelParameters Model::CollectTunableParameters(
     std::shared_ptr<Node> node) {
   return node->CollectTunableParameters();
@@ -2601,7 +2698,8 @@ Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
 void Model::OptimizeGradientDescent(
     std::shared_ptr<Node> snapshot,
     const OptimizationParams& optimization_params,
-    CancellationManager* cancellation_manager) {
+    CancellationManager* cancellation_manager,
+    RamBudgetManager& ram_budget_manager) {
   VLOG(2) << "Starting optimization of tunable parameters with Gradient "
              "Descent.";
   auto parameters = CollectTunableParameters(snapshot);
@@ -2637,6 +2735,10 @@ void Model::OptimizeGradientDescent(
   // and we only increase the buffer size parameters.
   bool cpu_budget_reached = false;
 
+  // Parameter values before the last step, which is undone if it exceeds the
+  // RAM budget.
+  std::vector<double> previous_values;
+
   for (int i = 0; i < kMaxIterations; ++i) {
     if (cancellation_manager->IsCancelled() ||
         ShouldStop(optimization_params.cpu_budget(),
@@ -2654,15 +2756,28 @@ void Model::OptimizeGradientDescent(
       break;
     }
 
+    previous_values.clear();
+    for (auto& pair : parameters) {
+      previous_values.push_back(pair.second->value);
+    }
     UpdateParameterValues(
         gradients, &(cpu_budget_reached ? buffer_size_parameters : parameters));
     output_time = new_output_time;
   }
 
+  if (!previous_values.empty() &&
+      TotalMaximumBufferedBytes(snapshot) > optimization_params.ram_budget()) {
+    for (int i = 0; i < parameters.size(); ++i) {
+      parameters[i].second->value = previous_values[i];
+    }
+  }
   for (auto& pair : parameters) {
     pair.second->value = std::round(pair.second->value);
   }
-  UpdateStateValues(&parameters);
+  if (ram_budget_manager.RequestModelAllocation(
+          TotalMaximumBufferedBytes(snapshot))) {
+    UpdateStateValues(&parameters);
+  }
 }
 
 void Model::OptimizeHillClimbHelper(
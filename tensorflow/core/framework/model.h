@@ -563,6 +563,16 @@ class Node {
   // Collects tunable parameters in this node.
   ModelParameters CollectNodeTunableParameters() const TF_LOCKS_EXCLUDED(mu_);
 
+  // Returns the state values of the tunable parameters of this node, keyed by
+  // parameter name.
+  absl::flat_hash_map<string, double> TunableParameterValues() const
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Sets the state values of the tunable parameters of this node that are in
+  // `values`, clamped to the range of each parameter.
+  void SetTunableParameterValues(
+      const absl::flat_hash_map<string, double>& values) TF_LOCKS_EXCLUDED(mu_);
+
   // Returns a human-readable representation of this node.
   string DebugString() const TF_LOCKS_EXCLUDED(mu_);
 
@@ -771,6 +781,10 @@ class Node {
                                          NodeValues* total_processing_times)
       TF_SHARED_LOCKS_REQUIRED(mu_) = 0;
 
+  // Returns the parameters of this node.
+  std::vector<std::shared_ptr<Parameter>> CollectNodeParameters() const
+      TF_LOCKS_EXCLUDED(mu_);
+
   // This is the locked version of the public `CollectNodes`.
   NodeVector CollectNodesLocked(TraversalOrder order,
                                 bool collect_node(const std::shared_ptr<Node>))
@@ -883,6 +897,13 @@ std::shared_ptr<Node> MakeAsyncInterleaveManyNode(
 // input element per output element.
 std::shared_ptr<Node> MakeKnownRatioNode(Node::Args args, double ratio);
 
+// A KnownRatio node with the given (non-tunable) parameters. A `kBufferSize`
+// parameter makes the model charge the elements the node buffers against the
+// RAM budget.
+std::shared_ptr<Node> MakeKnownRatioNode(
+    Node::Args args, double ratio,
+    std::vector<std::shared_ptr<Parameter>> parameters);
+
 // AsyncKnownRatio nodes are the asynchronous version of KnownRate nodes.
 std::shared_ptr<Node> MakeAsyncKnownRatioNode(
     Node::Args args, double ratio, double memory_ratio,
@@ -935,6 +956,11 @@ class Model {
   using ModelParameters = Node::ModelParameters;
   using NodeValues = Node::NodeValues;
   using ParameterGradients = Node::ParameterGradients;
+  // Values of tunable parameters, keyed by node name and parameter name. Unlike
+  // node ids, node names (i.e. iterator prefixes) identify the same node across
+  // runs of a pipeline.
+  using TunableParameterValues =
+      absl::flat_hash_map<string, absl::flat_hash_map<string, double>>;
 
   explicit Model(std::optional<std::string> dataset_name);
   explicit Model() : Model(std::nullopt) {}
@@ -1005,6 +1031,17 @@ class Model {
   // Removes the given node.
   void RemoveNode(std::shared_ptr<Node> node) TF_LOCKS_EXCLUDED(mu_);
 
+  // Returns the current values of the tunable parameters of the model.
+  TunableParameterValues GetTunableParameterValues() const
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Sets the tunable parameters of the model to the given values, e.g. to
+  // warm-start autotuning from the values tuned by a previous run of the
+  // pipeline. Parameters that are not in `values` are left unchanged, and
+  // parameters that are in `values` continue to be tuned.
+  void SetTunableParameterValues(const TunableParameterValues& values)
+      TF_LOCKS_EXCLUDED(mu_);
+
   // Produces a proto for this model.
   Status ToProto(ModelProto* model_proto);
 
@@ -1087,10 +1124,12 @@ class Model {
   // projecting resulting values on the feasible intervals. Improvement step is
   // repeated until either the output time improvement is smaller than threshold
   // value or the output time is less than the processing time needed to produce
-  // an element divided by CPU budget.
+  // an element divided by CPU budget. The last step is undone if it exceeds the
+  // RAM budget.
   void OptimizeGradientDescent(std::shared_ptr<Node> snapshot,
                                const OptimizationParams& optimization_params,
-                               CancellationManager* cancellation_manager);
+                               CancellationManager* cancellation_manager,
+                               RamBudgetManager& ram_budget_manager);
 
   // Helper method for implementing hill-climb optimization that can be
   // parametrized by a predicate to use for stopping the optimization.
@@ -687,6 +687,28 @@ TEST(BufferedBytesTest, Node) {
   EXPECT_EQ(node->inputs().size(), 0);
 }
 
+TEST(BufferedBytesTest, KnownRatioWithBufferSize) {
+  std::shared_ptr<Node> node = model::MakeKnownRatioNode(
+      {-1, "TestNode", nullptr}, /*ratio=*/1,
+      {model::MakeNonTunableParameter(kBufferSize, /*value=*/10)});
+  EXPECT_EQ(node->TotalMaximumBufferedBytes(), 0);
+
+  node->record_buffer_event(40, 2);
+  EXPECT_EQ(node->TotalBufferedBytes(), 40);
+  EXPECT_EQ(node->TotalMaximumBufferedBytes(), 200);
+
+  ModelProto::Node node_proto;
+  ASSERT_EQ(node->ToProto(&node_proto), absl::OkStatus());
+  EXPECT_EQ(node_proto.maximum_buffered_bytes(), 200);
+
+  // Without a buffer size, a known ratio node doesn't buffer elements.
+  std::shared_ptr<Node> unbuffered =
+      model::MakeKnownRatioNode({0, "TestInput", node}, /*ratio=*/1);
+  unbuffered->record_buffer_event(40, 2);
+  node->add_input(unbuffered);
+  EXPECT_EQ(node->TotalMaximumBufferedBytes(), 200);
+}
+
 // Returns a weighted sum of a prior and the actual processing time.
 double weighted_processing_time(int64_t num_elements, double processing_time,
                                 double prior) {
@@ -1386,6 +1408,47 @@ TEST_P(OptimizeZeroRamBudgetTest, Model) {
 INSTANTIATE_TEST_SUITE_P(Test, OptimizeZeroRamBudgetTest,
                          ::testing::Values(0, 1, 2, 3));
 
+TEST(ModelTest, TunableParameterValues) {
+  std::shared_ptr<SharedState> parallelism = std::make_shared<SharedState>(
+      /*value=*/model::kAutotune, std::make_shared<mutex>(),
+      std::make_shared<condition_variable>());
+  std::shared_ptr<SharedState> buffer_size = std::make_shared<SharedState>(
+      /*value=*/model::kAutotune, std::make_shared<mutex>(),
+      std::make_shared<condition_variable>());
+  std::shared_ptr<Node> node1 = model::MakeAsyncKnownRatioNode(
+      {1, "map", nullptr}, 1,
+      {model::MakeParameter("parallelism", parallelism, /*min=*/1,
+                            /*max=*/8)});
+  std::shared_ptr<Node> node2 = model::MakeAsyncKnownRatioNode(
+      {2, "prefetch", node1}, 1,
+      {model::MakeParameter("buffer_size", buffer_size, /*min=*/0,
+                            /*max=*/16),
+       model::MakeNonTunableParameter("fixed", /*value=*/3)});
+
+  model::Model model;
+  model.AddNode([&node1](model::Node::Args args) { return node1; }, "map",
+                nullptr, &node1);
+  model.AddNode([&node2](model::Node::Args args) { return node2; }, "prefetch",
+                node1, &node2);
+
+  // Parameters that have not been set yet are not returned.
+  EXPECT_TRUE(model.GetTunableParameterValues().empty());
+
+  model.SetTunableParameterValues({{"map", {{"parallelism", 4}}},
+                                   {"prefetch", {{"buffer_size", 32}}},
+                                   {"unknown", {{"parallelism", 2}}}});
+  EXPECT_EQ(node1->parameter_value("parallelism"), 4);
+  // Values are clamped to the range of the parameter.
+  EXPECT_EQ(node2->parameter_value("buffer_size"), 16);
+
+  model::Model::TunableParameterValues values =
+      model.GetTunableParameterValues();
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_EQ(values["map"]["parallelism"], 4);
+  EXPECT_EQ(values["prefetch"]["buffer_size"], 16);
+  EXPECT_FALSE(values["prefetch"].contains("fixed"));
+}
+
 TEST(RecordTimeTest, RecordTimeTest) {
   std::shared_ptr<Node> source = model::MakeSourceNode({});
   EXPECT_FALSE(source->is_recording());
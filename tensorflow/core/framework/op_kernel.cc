@@ -379,6 +379,8 @@ Allocator* OpKernelContext::get_allocator(AllocatorAttributes attr) {
   if (TF_PREDICT_FALSE(attr.scope_id > 0)) {
     allocator = params_->device->GetScopedAllocator(attr, step_id());
     CHECK(allocator);
+  } else if (params_->step_allocator != nullptr && attr.value == 0) {
+    allocator = params_->step_allocator;
   } else {
     allocator = params_->device->GetAllocator(attr);
   }
@@ -621,6 +621,11 @@ class OpKernelContext {
     bool track_allocations = false;
     bool log_memory = false;
 
+    // If not null, used by `get_allocator()` instead of the device allocator
+    // for allocations with default attributes. Set by the executor to a
+    // step-local allocator. Not owned.
+    Allocator* step_allocator = nullptr;
+
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
@@ -451,6 +451,38 @@ void BM_SendRecv(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_SendRecv);
 
+void BM_SendRecvMultiThreaded(::testing::benchmark::State& state) {
+  static Rendezvous* rendez = nullptr;
+  if (state.thread_index() == 0) {
+    rendez = NewLocalRendezvous(/*num_shards=*/state.range(0));
+  }
+  // Each thread uses its own key, like the Send/Recv pairs of distinct edges.
+  const Rendezvous::ParsedKey key =
+      MakeKey(strings::StrCat("edge", state.thread_index()));
+  Tensor orig = V("val");
+  Tensor val(DT_STRING, TensorShape({}));
+  bool is_dead = false;
+  Rendezvous::Args args;
+
+  for (auto s : state) {
+    TF_CHECK_OK(rendez->Send(key, args, orig, is_dead));
+    TF_CHECK_OK(rendez->Recv(key, args, &val, &is_dead));
+  }
+  CHECK_EQ(V(val), V(orig));
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    rendez->Unref();
+    rendez = nullptr;
+  }
+}
+BENCHMARK(BM_SendRecvMultiThreaded)
+    ->UseRealTime()
+    ->ArgName("num_shards")
+    ->Arg(1)
+    ->Arg(16)
+    ->Threads(64);
+
 void BM_RecvSend(::testing::benchmark::State& state) {
   Rendezvous* rendez = NewLocalRendezvous();
   Tensor orig = V("val");
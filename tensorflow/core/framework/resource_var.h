@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 
+#include <atomic>
 #include <string>
 
 #include "tensorflow/core/framework/resource_base.h"
@@ -59,6 +60,12 @@ namespace tensorflow {
 // shared mutex prevents them from overlapping with dense writes, which is
 // necessary as dense writes can change the shape the of the tensor.
 //
+// Since dense reads in copy-on-read mode copy the whole variable, the copy can
+// optionally be kept as a snapshot of the variable, which later dense reads
+// alias for as long as the variable is not updated. Writers increment the
+// version of the variable with `RecordUpdate()` after every update, which
+// invalidates the snapshot.
+//
 // Transitioning a variable from copy-on-read mode to copy-on-write mode is
 // currently not supported. To upgrade a variable from copy-on-write to
 // copy-on-read use `EnsureSparseVariableAccess()`, and then grab the variable's
@@ -84,6 +91,34 @@ class Var : public ResourceBase {
     // move frees the buffer of the tensor after unused goes out of scope.
     Tensor unused = std::move(tensor_);
     is_initialized = false;
+    RecordUpdate();
+  }
+
+  // The number of updates of the variable so far. Must be incremented with
+  // `RecordUpdate()` once an update of the tensor is complete.
+  uint64 version() const { return version_.load(std::memory_order_acquire); }
+  void RecordUpdate() { version_.fetch_add(1, std::memory_order_acq_rel); }
+
+  // Sets `*snapshot` to the snapshot of the variable and returns true if the
+  // variable was not updated since the snapshot was taken.
+  bool GetSnapshot(Tensor* snapshot) TF_LOCKS_EXCLUDED(snapshot_mu_) {
+    mutex_lock l(snapshot_mu_);
+    if (!snapshot_.IsInitialized()) return false;
+    if (snapshot_version_ != version()) {
+      // Frees a stale snapshot rather than holding on to it.
+      snapshot_ = Tensor();
+      return false;
+    }
+    *snapshot = snapshot_;
+    return true;
+  }
+
+  // Keeps `snapshot`, a copy of the tensor read at `version`, for later reads.
+  void SetSnapshot(const Tensor& snapshot, uint64 version)
+      TF_LOCKS_EXCLUDED(snapshot_mu_) {
+    mutex_lock l(snapshot_mu_);
+    snapshot_ = snapshot;
+    snapshot_version_ = version;
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override;
@@ -115,6 +150,11 @@ class Var : public ResourceBase {
   Tensor tensor_;
   std::string debug_name_;
 
+  std::atomic<uint64> version_{0};
+  mutex snapshot_mu_;
+  Tensor snapshot_ TF_GUARDED_BY(snapshot_mu_);
+  uint64 snapshot_version_ TF_GUARDED_BY(snapshot_mu_) = 0;
+
   ~Var() override {}
   Var(const Var&) = delete;
   void operator=(const Var&) = delete;
@@ -132,6 +172,7 @@ class TF_SCOPED_LOCKABLE ScopedUnlockUnrefVar {
   }
   void Release() TF_UNLOCK_FUNCTION() {
     if (var_) {
+      var_->RecordUpdate();
       var_->mu()->unlock();
       var_->Unref();
       var_ = nullptr;
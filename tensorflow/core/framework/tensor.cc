@@ -26,6 +26,10 @@ limitations under the License.
 // * Helper<T>: provides various routines given type T.  The routines
 //   includes running the constructor and destructor of T[], encoding
 //   a decoding T[] into/from a Cord, etc.
+//
+// * InlineBuffer: stores the payload of a small tensor of a simple type in
+//   the same allocation as the TensorBuffer itself. Its allocations are
+//   recycled through a per-thread free list.
 
 #include "tensorflow/core/framework/tensor.h"
 
@@ -33,9 +37,11 @@ limitations under the License.
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <new>
 #include <ostream>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/escaping.h"
 #include "xla/tsl/util/byte_swap_array.h"
@@ -168,6 +174,122 @@ bool MemoryLoggingEnabled() {
   return memory_logging_enabled;
 }
 
+// The largest payload stored in an InlineBuffer. Covers scalars and the
+// shape and index vectors that dominate control-heavy graphs.
+constexpr size_t kInlineBufferBytes = 64;
+
+// A TensorBuffer for up to kInlineBufferBytes of a simple type, laid out
+// after its payload in a single block of memory. Used by Tensor(type, shape)
+// instead of a Buffer<T>, which makes two allocations.
+class InlineBuffer : public TensorBuffer {
+ public:
+  // Returns a new buffer for `num_elements` of `type`, or nullptr if the tensor
+  // should use an allocator instead.
+  static InlineBuffer* MaybeNew(DataType type, int64_t num_elements);
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  bool GetAllocatedBytes(size_t* out_bytes) const override { return false; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("InlineBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return AllocatorMemoryType::kHostPageable;
+  }
+
+  // Returns the block of the buffer to the free list of the calling thread,
+  // when `delete this` runs in `core::RefCounted::Unref()`.
+  static void operator delete(void* ptr);
+
+  static void operator delete(void*, void*) {
+    // Some compilers require an overridden class-specific deallocation
+    // function, which will be called if placement `new` throws an exception.
+  }
+
+ private:
+  InlineBuffer(void* data, size_t size) : TensorBuffer(data), size_(size) {}
+  ~InlineBuffer() override = default;
+
+  const size_t size_;
+};
+
+// A free list of InlineBuffer blocks owned by a thread. Blocks may be freed
+// by a different thread than the one which allocated them.
+class InlineBufferFreeList {
+ public:
+  ~InlineBufferFreeList() {
+    for (void* block : blocks_) port::AlignedFree(block);
+    destroyed_ = true;
+  }
+
+  static void* Allocate(size_t bytes) {
+    if (!destroyed_) {
+      std::vector<void*>& blocks = Get().blocks_;
+      if (!blocks.empty()) {
+        void* block = blocks.back();
+        blocks.pop_back();
+        return block;
+      }
+    }
+    return port::AlignedMalloc(bytes, EIGEN_MAX_ALIGN_BYTES);
+  }
+
+  static void Free(void* block) {
+    // The free list is destroyed first when a thread exits, and is bounded so
+    // that a thread only freeing blocks does not accumulate them.
+    if (!destroyed_) {
+      std::vector<void*>& blocks = Get().blocks_;
+      if (blocks.size() < kMaxBlocks) {
+        blocks.push_back(block);
+        return;
+      }
+    }
+    port::AlignedFree(block);
+  }
+
+ private:
+  static constexpr size_t kMaxBlocks = 256;
+
+  static InlineBufferFreeList& Get() {
+    static thread_local InlineBufferFreeList free_list;
+    return free_list;
+  }
+
+  static thread_local bool destroyed_;
+
+  std::vector<void*> blocks_;
+};
+
+thread_local bool InlineBufferFreeList::destroyed_ = false;
+
+InlineBuffer* InlineBuffer::MaybeNew(DataType type, int64_t num_elements) {
+  if (num_elements <= 0 || num_elements > kInlineBufferBytes ||
+      !DataTypeCanUseMemcpy(type)) {
+    return nullptr;
+  }
+  const size_t size = num_elements * DataTypeSize(type);
+  // Memory logging and CPU allocator stats account for every tensor, so they
+  // need the tensors to be allocated by the CPU allocator.
+  if (size > kInlineBufferBytes || MemoryLoggingEnabled() ||
+      CPUAllocatorStatsEnabled()) {
+    return nullptr;
+  }
+  // The buffer follows the payload, at an offset which keeps both aligned.
+  static_assert(kInlineBufferBytes % alignof(InlineBuffer) == 0);
+  char* block = static_cast<char*>(InlineBufferFreeList::Allocate(
+      kInlineBufferBytes + sizeof(InlineBuffer)));
+  return new (block + kInlineBufferBytes) InlineBuffer(block, size);
+}
+
+void InlineBuffer::operator delete(void* ptr) {
+  InlineBufferFreeList::Free(static_cast<char*>(ptr) - kInlineBufferBytes);
+}
+
 // A set of helper functions depending on T.
 template <typename T>
 struct Helper {
@@ -1017,7 +1139,12 @@ static Allocator* get_default_cpu_allocator() {
 }
 
 Tensor::Tensor(DataType type, const TensorShape& shape)
-    : Tensor(get_default_cpu_allocator(), type, shape) {}
+    : shape_(shape), buf_(nullptr) {
+  set_dtype(type);
+  // Small tensors of simple types do not need the default allocator.
+  buf_ = InlineBuffer::MaybeNew(type, shape.num_elements());
+  if (buf_ == nullptr) *this = Tensor(get_default_cpu_allocator(), type, shape);
+}
 
 bool Tensor::HostScalarTensorBufferBase::GetAllocatedBytes(
     size_t* out_bytes) const {
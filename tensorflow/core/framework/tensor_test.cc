@@ -1894,6 +1894,51 @@ void BM_Assign(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_Assign);
 
+TEST(Tensor, SmallTensorsAreStoredInline) {
+  Tensor small(DT_INT64, TensorShape({8}));
+  small.flat<int64_t>().setConstant(7);
+  EXPECT_TRUE(small.IsAligned());
+  TensorDescription small_description;
+  small.FillDescription(&small_description);
+  EXPECT_EQ(small_description.allocation_description().allocator_name(),
+            "InlineBuffer");
+  EXPECT_EQ(small_description.allocation_description().requested_bytes(), 64);
+  Tensor copy(small);
+  EXPECT_TRUE(copy.SharesBufferWith(small));
+  test::ExpectTensorEqual<int64_t>(copy, test::AsTensor<int64_t>(
+                                             {7, 7, 7, 7, 7, 7, 7, 7}, {8}));
+
+  Tensor large(DT_INT64, TensorShape({9}));
+  TensorDescription large_description;
+  large.FillDescription(&large_description);
+  EXPECT_NE(large_description.allocation_description().allocator_name(),
+            "InlineBuffer");
+  Tensor strings(DT_STRING, TensorShape({1}));
+  TensorDescription strings_description;
+  strings.FillDescription(&strings_description);
+  EXPECT_NE(strings_description.allocation_description().allocator_name(),
+            "InlineBuffer");
+}
+
+// Benchmark create and destroy a small tensor, which is stored inline.
+void BM_CreateAndDestroySmall(::testing::benchmark::State& state) {
+  TensorShape shape({4});
+  for (auto s : state) {
+    Tensor t(DT_INT32, shape);
+  }
+}
+BENCHMARK(BM_CreateAndDestroySmall);
+
+// Benchmark create and destroy a small tensor, using the allocator interface.
+void BM_CreateAndDestroySmallWithBuf(::testing::benchmark::State& state) {
+  TensorShape shape({4});
+  Allocator* allocator = cpu_allocator();
+  for (auto s : state) {
+    Tensor t(allocator, DT_INT32, shape);
+  }
+}
+BENCHMARK(BM_CreateAndDestroySmallWithBuf);
+
 // Ensure tensor_data() works on empty tensors
 TEST(Tensor, EmptyTensorData) {
   Tensor empty;
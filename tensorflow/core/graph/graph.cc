@@ -544,17 +544,26 @@ absl::StatusOr<Node*> Graph::AddNode(NodeDef node_def) {
 }
 
 Node* Graph::AddNode(NodeDef node_def, Status* status) {
+  absl::StatusOr<PreparedNode> prepared_node =
+      PrepareNode(std::move(node_def));
+  if (!prepared_node.ok()) {
+    status->Update(prepared_node.status());
+    return nullptr;
+  }
+  return AddNode(*std::move(prepared_node));
+}
+
+absl::StatusOr<Graph::PreparedNode> Graph::PrepareNode(
+    NodeDef node_def) const {
   const OpRegistrationData* op_reg_data;
-  status->Update(ops_.LookUp(node_def.op(), &op_reg_data));
-  if (!status->ok()) return nullptr;
+  TF_RETURN_IF_ERROR(ops_.LookUp(node_def.op(), &op_reg_data));
 
   DataTypeVector inputs;
   DataTypeVector outputs;
-  status->Update(
-      InOutTypesForNode(node_def, op_reg_data->op_def, &inputs, &outputs));
-  if (!status->ok()) {
-    *status = AttachDef(*status, node_def);
-    return nullptr;
+  Status status =
+      InOutTypesForNode(node_def, op_reg_data->op_def, &inputs, &outputs);
+  if (!status.ok()) {
+    return AttachDef(status, node_def);
   }
 
   Node::NodeClass node_class = op_reg_data->is_function_op
@@ -571,21 +580,24 @@ Node* Graph::AddNode(NodeDef node_def, Status* status) {
           full_type::SpecializeType(AttrSlice(node_def), op_reg_data->op_def,
                                     *(node_def.mutable_experimental_type()));
       if (!s.ok()) {
-        *status = errors::InvalidArgument("type error: ", s.ToString());
         VLOG(3) << "AddNode: type inference failed for " << node_def.name()
                 << ": " << s;
-        return nullptr;
+        return errors::InvalidArgument("type error: ", s.ToString());
       }
     } else {
       VLOG(3) << "AddNode: no type constructor for " << node_def.name();
     }
   }
 
-  Node* node = AllocateNode(
+  return PreparedNode(
       std::make_shared<NodeProperties>(&op_reg_data->op_def,
                                        std::move(node_def), inputs, outputs),
-      nullptr, node_class);
-  return node;
+      node_class);
+}
+
+Node* Graph::AddNode(PreparedNode prepared_node) {
+  return AllocateNode(std::move(prepared_node.props_), nullptr,
+                      prepared_node.node_class_);
 }
 
 Node* Graph::CopyNode(const Node* node) {
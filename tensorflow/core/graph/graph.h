@@ -565,6 +565,29 @@ class Graph {
   // Same as above, but using StatusOr. This method is always preferred.
   absl::StatusOr<Node*> AddNode(NodeDef node_def);
 
+  // A node that is ready to be added to a graph, see PrepareNode().
+  class PreparedNode {
+   public:
+    const NodeDef& def() const { return props_->node_def; }
+
+   private:
+    friend class Graph;
+    PreparedNode(std::shared_ptr<NodeProperties> props,
+                 Node::NodeClass node_class)
+        : props_(std::move(props)), node_class_(node_class) {}
+
+    std::shared_ptr<NodeProperties> props_;
+    Node::NodeClass node_class_;
+  };
+
+  // Does the work of AddNode() that does not modify the graph: infers the Op
+  // and input/output types for the node. Unlike the other methods, it can be
+  // called concurrently, so that many nodes can be prepared in parallel.
+  absl::StatusOr<PreparedNode> PrepareNode(NodeDef node_def) const;
+
+  // Adds a node returned by PrepareNode() to this graph, and returns it.
+  Node* AddNode(PreparedNode prepared_node);
+
   // Copies *node, which may belong to another graph, to a new node,
   // which is returned.  Does not copy any edges.  *this owns the
   // returned instance.
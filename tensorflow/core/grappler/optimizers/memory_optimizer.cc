@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/memory_optimizer.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -440,9 +442,51 @@ void RecomputeSubgraph(
   }
 }
 
-void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
-                                const string& recomputation_targets_name_scope,
-                                GraphDef* graph, const GrapplerItem& item) {
+// Returns the size of the tensors produced by each node which are live when the
+// memory usage of a GPU peaks above its memory size, or nullopt if the peak
+// memory usage is not known for any GPU.
+std::optional<std::unordered_map<string, int64_t>> FindTensorsLiveAtPeak(
+    Cluster* cluster, const GrapplerItem& item) {
+  GraphMemory memory(item);
+  Status s = memory.InferStatically(cluster->GetDevices());
+  if (!s.ok()) {
+    VLOG(1) << "Failed to infer memory usage: " << s.message();
+    return std::nullopt;
+  }
+  std::optional<std::unordered_map<string, int64_t>> live_bytes;
+  for (const auto& device : cluster->GetDevices()) {
+    const string& name = device.first;
+    const DeviceProperties& prop = device.second;
+    if (prop.type() != "GPU" || prop.memory_size() <= 0) {
+      continue;
+    }
+    const GraphMemory::MemoryUsage& mem_usage = memory.GetPeakMemoryUsage(name);
+    if (mem_usage.used_memory < 0) {
+      continue;
+    }
+    if (!live_bytes.has_value()) live_bytes.emplace();
+    if (mem_usage.used_memory <= prop.memory_size()) {
+      continue;
+    }
+    VLOG(1) << "Peak memory usage of " << name << " is "
+            << mem_usage.used_memory << " bytes, "
+            << mem_usage.used_memory - prop.memory_size()
+            << " bytes more than its memory size";
+    for (const auto& live_tensor : mem_usage.live_tensors) {
+      (*live_bytes)[live_tensor.node] += live_tensor.memory_used;
+    }
+  }
+  return live_bytes;
+}
+
+// If `peak_live_bytes` is not null, the heuristics only recompute subgraphs
+// which produce some of these tensors, since recomputing other nodes would not
+// lower the peak memory usage.
+void RecomputationRewritingPass(
+    RewriterConfig::MemOptType optimization_level,
+    const string& recomputation_targets_name_scope,
+    const std::unordered_map<string, int64_t>* peak_live_bytes,
+    GraphDef* graph, const GrapplerItem& item) {
   // The topological numberings and NodeMap will be stale as soon as we start
   // modifying the graph in RecomputeSubgraph. However, RecomputeSubgraph only
   // looks up nodes which were in the original graph, and preserves the graph
@@ -488,6 +532,30 @@ void RecomputationRewritingPass(RewriterConfig::MemOptType optimization_level,
                   node.attr().count(kRecomputeHint) > 0);
         },
         is_target);
+    if (peak_live_bytes != nullptr) {
+      int64_t freed_bytes = 0;
+      const auto frees_peak_memory = [&](const RecomputedSubGraph& subgraph) {
+        bool frees_memory = false;
+        for (const NodeDef* node : subgraph.recomputed_source_nodes) {
+          auto it = peak_live_bytes->find(node->name());
+          if (it != peak_live_bytes->end()) {
+            freed_bytes += it->second;
+            frees_memory = true;
+          }
+        }
+        return frees_memory;
+      };
+      recomputed_subgraphs.erase(
+          std::remove_if(recomputed_subgraphs.begin(),
+                         recomputed_subgraphs.end(),
+                         [&](const RecomputedSubGraph& subgraph) {
+                           return !frees_peak_memory(subgraph);
+                         }),
+          recomputed_subgraphs.end());
+      VLOG(1) << "Recomputing " << recomputed_subgraphs.size()
+              << " subgraphs is expected to lower the peak memory usage by up "
+              << "to " << freed_bytes << " bytes";
+    }
   } else if (optimization_level == RewriterConfig::MANUAL) {
     recomputed_subgraphs = GetOpGroupsToRecompute(
         graph, node_map,
@@ -1395,9 +1463,16 @@ Status MemoryOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   RelaxAssignNodes(nodes_to_relax, &optimized_item.graph);
 
   if (run_recomputation_pass) {
-    RecomputationRewritingPass(optimization_level_,
-                               recomputation_targets_name_scope_,
-                               &optimized_item.graph, item);
+    // The memory usage can only be inferred when there are fetches.
+    std::optional<std::unordered_map<string, int64_t>> peak_live_bytes;
+    if (optimization_level_ != RewriterConfig::MANUAL && cluster != nullptr &&
+        !item.fetch.empty()) {
+      peak_live_bytes = FindTensorsLiveAtPeak(cluster, optimized_item);
+    }
+    RecomputationRewritingPass(
+        optimization_level_, recomputation_targets_name_scope_,
+        peak_live_bytes.has_value() ? &*peak_live_bytes : nullptr,
+        &optimized_item.graph, item);
   }
 
   std::unordered_set<string> skip_list;
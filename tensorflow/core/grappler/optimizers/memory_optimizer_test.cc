@@ -224,6 +224,34 @@ class MemoryOptimizerTest : public GrapplerTest {
   }
 };
 
+TEST_F(MemoryOptimizerTest, NoRecomputationBelowPeakMemory) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope().WithDevice("/gpu:0");
+
+  Output a = ops::Variable(s.WithOpName("Conv"), {2, 3, 4}, DT_FLOAT);
+  Output b = ops::Identity(s.WithOpName("BN"), a);
+  Output c = ops::Identity(s.WithOpName("ReLU"), b);
+  Output d = ops::Identity(s.WithOpName("Conv1"), c);
+  Output trigger = ops::AddN(s.WithOpName("gradients/BN1Grad"), {d});
+  Output e = ops::AddN(s.WithOpName("gradients/Conv1Grad"), {trigger, c});
+  Output f = ops::AddN(s.WithOpName("gradients/ReLUGrad"), {e, c});
+  Output g = ops::AddN(s.WithOpName("gradients/BNGrad"), {f, a});
+  Output h = ops::AddN(s.WithOpName("gradients/ConvGrad"), {g});
+
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  item.fetch = {"gradients/ConvGrad"};
+  NodeMap node_map(&item.graph);
+  node_map.GetNode("BN")->set_op("FusedBatchNorm");
+  node_map.GetNode("ReLU")->set_op("Relu");
+
+  // The graph fits in the GPU memory, so nothing is recomputed.
+  std::unique_ptr<VirtualCluster> cluster(CreateVirtualCluster());
+  MemoryOptimizer optimizer(RewriterConfig::RECOMPUTATION_HEURISTICS);
+  GraphDef output;
+  TF_EXPECT_OK(optimizer.Optimize(cluster.get(), item, &output));
+  EXPECT_EQ(item.graph.node_size(), output.node_size());
+}
+
 TEST_F(MemoryOptimizerTest, SimpleSwapping) {
   // Build a simple graph with an op that's marked for swapping.
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
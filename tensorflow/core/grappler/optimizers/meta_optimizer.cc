@@ -17,10 +17,13 @@ limitations under the License.
 
 #include <algorithm>
 #include <functional>
+#include <map>
+#include <set>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
@@ -62,8 +65,14 @@ limitations under the License.
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/hash.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/public/version.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 #include "tensorflow/core/util/xla_config_registry.h"
 
@@ -186,6 +195,72 @@ Status GetGraphDevice(const GraphDef& g_def, std::set<std::string>* devices) {
   return absl::OkStatus();
 }
 
+// Returns the file in the `TF_GRAPPLER_CACHE_DIR` directory that holds the
+// result of optimizing `item` on `cluster` with `config`, or an empty string if
+// the cache is disabled. The key covers everything the optimizers read, as
+// long as the registered custom optimizers do not change between runs.
+string CachedGraphFilename(const ConfigProto& config, Cluster* cluster,
+                           const GrapplerItem& item) {
+  string cache_dir;
+  TF_CHECK_OK(ReadStringFromEnvVar("TF_GRAPPLER_CACHE_DIR", "", &cache_dir));
+  if (cache_dir.empty()) return "";
+
+  uint64 key = Hash64(TF_VERSION_STRING);
+  key = Hash64Combine(key, DeterministicProtoHash64(item.graph));
+  key = Hash64Combine(key, DeterministicProtoHash64(config));
+  for (const auto& [name, tensor] : item.feed) {
+    key = Hash64Combine(key, Hash64(name));
+    key = Hash64Combine(key, tensor.dtype());
+    key = Hash64Combine(key, Hash64(tensor.shape().DebugString()));
+  }
+  for (const std::vector<string>* names :
+       {&item.fetch, &item.init_ops, &item.keep_ops}) {
+    key = Hash64Combine(key, names->size());
+    for (const string& name : *names) {
+      key = Hash64Combine(key, Hash64(name));
+    }
+  }
+  const GrapplerItem::OptimizationOptions& options =
+      item.optimization_options();
+  key = Hash64Combine(key, options.allow_non_differentiable_rewrites);
+  key = Hash64Combine(key, options.allow_pruning_stateful_and_dataset_ops);
+  key = Hash64Combine(key, options.optimize_function_library);
+  key = Hash64Combine(key, options.is_eager_mode);
+  key = Hash64Combine(key, options.intra_op_parallelism_threads);
+  const std::set<string> devices(item.devices().begin(), item.devices().end());
+  for (const string& device : devices) {
+    key = Hash64Combine(key, Hash64(device));
+  }
+  if (cluster != nullptr) {
+    const std::map<string, DeviceProperties> cluster_devices(
+        cluster->GetDevices().begin(), cluster->GetDevices().end());
+    for (const auto& [name, properties] : cluster_devices) {
+      key = Hash64Combine(key, Hash64(name));
+      key = Hash64Combine(key, DeterministicProtoHash64(properties));
+    }
+  }
+  return io::JoinPath(cache_dir, strings::StrCat(strings::Hex(key), ".pb"));
+}
+
+// Writes `graph` to `filename` in the cache. The graph is written to a
+// temporary file first, so that concurrent readers never see a partial graph.
+void WriteCachedGraph(const string& filename, const GraphDef& graph) {
+  Env* env = Env::Default();
+  string tmp_filename = filename;
+  Status status = env->RecursivelyCreateDir(string(io::Dirname(filename)));
+  if (status.ok() && !env->CreateUniqueFileName(&tmp_filename, ".tmp")) {
+    status = errors::Internal("Failed to create a temporary file name for ",
+                              filename);
+  }
+  if (status.ok()) status = WriteBinaryProto(env, tmp_filename, graph);
+  if (status.ok()) status = env->RenameFile(tmp_filename, filename);
+  if (!status.ok()) {
+    LOG_EVERY_N_SEC(WARNING, 60)
+        << "Failed to cache the optimized graph: " << status;
+    env->DeleteFile(tmp_filename).IgnoreError();
+  }
+}
+
 }  // namespace
 
 #define MK_OPT(NAME, CONFIG, VALUE)                                    \
@@ -813,6 +888,10 @@ Status MetaOptimizer::OptimizeGraph(
     CompressConstants(optimized_graph);
   }
 
+  // Fingerprint of `optimized_graph`, updated after each optimizer run to
+  // detect when an iteration leaves the graph unchanged.
+  uint64 fingerprint = DeterministicProtoHash64(*optimized_graph);
+
   for (int iteration = 0; iteration < NumIterations(cfg_); ++iteration) {
     // Don't bother optimizing further if the graph is already tiny.
     if (optimized_graph->node_size() < min_graph_nodes) {
@@ -823,6 +902,7 @@ Status MetaOptimizer::OptimizeGraph(
     }
 
     VLOG(4) << "Starting optimization iteration " << iteration;
+    bool graph_changed = false;
     if (VLOG_IS_ON(4)) {
       DumpGraphDefToFile(
           strings::StrCat("before_MetaOptimizer_iteration_", iteration, "_",
@@ -849,6 +929,10 @@ Status MetaOptimizer::OptimizeGraph(
         CompressConstants(optimized_graph);
       }
 
+      const uint64 new_fingerprint = DeterministicProtoHash64(*optimized_graph);
+      graph_changed |= new_fingerprint != fingerprint;
+      fingerprint = new_fingerprint;
+
       if (VLOG_IS_ON(4)) {
         DumpGraphDefToFile(
             strings::StrCat("after_MetaOptimizer_iteration_", iteration, "_",
@@ -871,6 +955,13 @@ Status MetaOptimizer::OptimizeGraph(
     for (const auto& verifier : post_optimization_verifiers) {
       TF_RETURN_IF_ERROR(verifier->Verify(*optimized_graph));
     }
+    // Every optimizer returned the graph it was given, so the next iteration
+    // would run them on the same graph again, with the same result.
+    if (!graph_changed) {
+      VLOG(3) << "Stopping after iteration " << iteration
+              << ", graph did not change";
+      break;
+    }
   }
 #ifndef ENABLE_MKL
   // ScopedAllocatorOptimizer must run last.
@@ -1057,6 +1148,23 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
   optimization_results_.clear();
 
+  // Servers restarting with the same model optimize the same graphs again, so
+  // the results can be reused from a persistent cache.
+  const string cache_filename =
+      CachedGraphFilename(config_proto_, cluster, item);
+  if (!cache_filename.empty() &&
+      Env::Default()->FileExists(cache_filename).ok()) {
+    Status status =
+        ReadBinaryProto(Env::Default(), cache_filename, optimized_graph);
+    if (status.ok()) {
+      VLOG(1) << "Read optimized grappler item " << item.id << " from "
+              << cache_filename;
+      return absl::OkStatus();
+    }
+    LOG_EVERY_N_SEC(WARNING, 60) << "Failed to read the optimized graph from "
+                                 << cache_filename << ": " << status;
+  }
+
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
   const auto minimized_flib =
@@ -1316,6 +1424,18 @@ Status MetaOptimizer::OptimizeConsumeItem(Cluster* cluster, GrapplerItem&& item,
         *optimized_graph);
   }
 
+  // Only the results of successful runs are cached, as optimizers that failed
+  // or timed out may succeed next time.
+  const bool all_optimizers_succeeded = absl::c_all_of(
+      optimization_results_, [](const GraphOptimizationResult& graph_result) {
+        return absl::c_all_of(
+            graph_result.results,
+            [](const OptimizerResult& result) { return result.status.ok(); });
+      });
+  if (!cache_filename.empty() && all_optimizers_succeeded) {
+    WriteCachedGraph(cache_filename, *optimized_graph);
+  }
+
   return absl::OkStatus();
 }
 
@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/grappler_test.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -129,6 +130,45 @@ gtl::FlatMap<string, GrapplerItem::OptimizationOptions>*
 
 REGISTER_GRAPH_OPTIMIZER(GrapplerItemPropertiesAccumulator);
 
+// Counts its runs, and adds a node to the graph on each run if requested.
+class CountingOptimizer : public CustomGraphOptimizer {
+ public:
+  static void Reset(const bool modify_graph) {
+    num_runs_ = 0;
+    modify_graph_ = modify_graph;
+  }
+  static int NumRuns() { return num_runs_; }
+
+  string name() const override { return "counting_optimizer"; }
+  bool UsesFunctionLibrary() const override { return false; }
+
+  Status Init(
+      const tensorflow::RewriterConfig_CustomGraphOptimizer* config) override {
+    return absl::OkStatus();
+  }
+
+  Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                  GraphDef* optimized_graph) override {
+    ++num_runs_;
+    *optimized_graph = item.graph;
+    if (modify_graph_) {
+      NodeDef* node = optimized_graph->add_node();
+      node->set_name(strings::StrCat("counting_optimizer_", num_runs_));
+      node->set_op("NoOp");
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  static int num_runs_;
+  static bool modify_graph_;
+};
+
+int CountingOptimizer::num_runs_;
+bool CountingOptimizer::modify_graph_;
+
+REGISTER_GRAPH_OPTIMIZER(CountingOptimizer);
+
 class MetaOptimizerTest : public GrapplerTest {};
 
 TEST_F(MetaOptimizerTest, RunsCustomOptimizer) {
@@ -255,6 +295,69 @@ TEST_F(MetaOptimizerTest, RunToggleOptimizersAndCustomGraphOptimizerTwice) {
   EXPECT_TRUE(TestGraphOptimizer::IsOptimized());
 }
 
+TEST_F(MetaOptimizerTest, StopsIteratingWhenGraphDoesNotChange) {
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
+  GrapplerItem item;
+  ASSERT_TRUE(fake_input.NextItem(&item));
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("CountingOptimizer");
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  rewriter_config.set_min_graph_nodes(-1);
+
+  for (const bool modify_graph : {false, true}) {
+    CountingOptimizer::Reset(modify_graph);
+    MetaOptimizer optimizer(nullptr, config_proto);
+    GraphDef output;
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+    EXPECT_EQ(CountingOptimizer::NumRuns(), modify_graph ? 2 : 1);
+  }
+}
+
+TEST_F(MetaOptimizerTest, ReusesCachedGraph) {
+  const string cache_dir = io::JoinPath(testing::TmpDir(), "grappler_cache");
+  setenv("TF_GRAPPLER_CACHE_DIR", cache_dir.c_str(), /*overwrite=*/1);
+
+  TrivialTestGraphInputYielder fake_input(4, 1, 10, false, {kDevice});
+  GrapplerItem item;
+  ASSERT_TRUE(fake_input.NextItem(&item));
+
+  ConfigProto config_proto;
+  auto& rewriter_config =
+      *config_proto.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config.add_optimizers("CountingOptimizer");
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::ONE);
+  rewriter_config.set_min_graph_nodes(-1);
+
+  CountingOptimizer::Reset(/*modify_graph=*/true);
+  GraphDef output;
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+  }
+  EXPECT_EQ(CountingOptimizer::NumRuns(), 1);
+
+  GraphDef cached_output;
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &cached_output));
+  }
+  EXPECT_EQ(CountingOptimizer::NumRuns(), 1);
+  CompareGraphs(output, cached_output);
+
+  // A different config is a different cache entry.
+  rewriter_config.set_meta_optimizer_iterations(RewriterConfig::TWO);
+  {
+    MetaOptimizer optimizer(nullptr, config_proto);
+    TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &cached_output));
+  }
+  EXPECT_EQ(CountingOptimizer::NumRuns(), 3);
+
+  unsetenv("TF_GRAPPLER_CACHE_DIR");
+}
+
 TEST_F(MetaOptimizerTest, OptimizeFunctionLibrary) {
   using test::function::NDef;
 
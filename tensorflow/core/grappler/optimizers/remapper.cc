@@ -74,6 +74,8 @@ namespace grappler {
 //
 // Sigmoid + Mul -> _MklSwish  // This fusion only works on Intel CPU.
 //
+// Chain of elementwise ops -> _FusedElementwise  // After the fusions above.
+//
 //
 // In all cases, the supported activation functions are Relu, Relu6, and Elu.
 //
@@ -92,6 +94,9 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kHashedSparseSegmentReduction[] =
+    "_HashedSparseSegmentReduction";
+constexpr char kFusedElementwise[] = "_FusedElementwise";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -106,6 +111,19 @@ constexpr char kFill[] = "fill";
 
 constexpr int kMissingIndex = -1;
 
+// Longest chain of elementwise ops fused into a _FusedElementwise.
+constexpr int kMaxFusedElementwiseOps = 16;
+
+// Returns the fused ops listed in `TF_REMAPPER_DISABLED_FUSIONS`, e.g.
+// "_FusedConv2D,_FusedMatMul". Contractions are not fused into them, so that
+// fusions measured to be slower on a given device can be turned off.
+absl::flat_hash_set<string> DisabledFusions() {
+  std::vector<string> fused_ops;
+  TF_CHECK_OK(ReadStringsFromEnvVar("TF_REMAPPER_DISABLED_FUSIONS",
+                                    /*default_val=*/"", &fused_ops));
+  return absl::flat_hash_set<string>(fused_ops.begin(), fused_ops.end());
+}
+
 struct RemapperContext {
   explicit RemapperContext(GrapplerItem* item, Status* status,
                            RewriterConfig::CpuLayout cpu_layout_conversion,
@@ -117,7 +135,8 @@ struct RemapperContext {
         inferred_graph_properties(false),
         cpu_layout_conversion(cpu_layout_conversion),
         xla_auto_clustering_on(xla_auto_clustering_on),
-        xla_cpu_jit_disable_fusion(xla_cpu_jit_disable_fusion) {}
+        xla_cpu_jit_disable_fusion(xla_cpu_jit_disable_fusion),
+        disabled_fusions(DisabledFusions()) {}
 
   std::unordered_set<string> nodes_to_preserve;
   utils::MutableGraphView graph_view;
@@ -126,6 +145,7 @@ struct RemapperContext {
   RewriterConfig::CpuLayout cpu_layout_conversion;
   bool xla_auto_clustering_on;
   bool xla_cpu_jit_disable_fusion;
+  absl::flat_hash_set<string> disabled_fusions;
 };
 
 // FusedBatchNorm that can be replaced with a cheaper set of primitives.
@@ -170,6 +190,31 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// StringToHashBucketFast whose buckets are the indices of a SparseSegmentSum,
+// SparseSegmentMean or SparseSegmentSqrtN, i.e. a hashed embedding lookup.
+struct HashedSparseSegmentReduction {
+  HashedSparseSegmentReduction() = default;
+  HashedSparseSegmentReduction(int string_to_hash_bucket,
+                               int sparse_segment_reduction)
+      : string_to_hash_bucket(string_to_hash_bucket),
+        sparse_segment_reduction(sparse_segment_reduction) {}
+
+  int string_to_hash_bucket = kMissingIndex;
+  int sparse_segment_reduction = kMissingIndex;
+};
+
+// Chain of elementwise ops with results of the same shape, each one consuming
+// the result of the previous one, that is evaluated in one pass.
+struct FusedElementwise {
+  // The ops of the chain, from the first one to the root.
+  std::vector<int> ops;
+  // The regular fanin of each op that is the previous op of the chain, or
+  // kMissingIndex for the first op.
+  std::vector<int> chained_fanins;
+  // A regular fanin of the first op with the shape of the result.
+  int full_fanin = kMissingIndex;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -623,6 +668,10 @@ bool IsGpuCompatible(const RemapperContext& ctx,
 template <typename Pattern>
 bool IsDeviceCompatible(const RemapperContext& ctx, Pattern& matched,
                         Cluster* cluster = nullptr) {
+  const NodeDef& contraction =
+      ctx.graph_view.graph()->node(matched.contraction);
+  const string fused_op = absl::StrCat("_Fused", contraction.op());
+  if (ctx.disabled_fusions.contains(fused_op)) return false;
   return IsCpuCompatible(ctx, matched) ||
          IsGpuCompatible(ctx, matched, cluster);
 }
@@ -2705,6 +2754,168 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool FindHashedSparseSegmentReduction(const RemapperContext& ctx,
+                                      int node_index,
+                                      HashedSparseSegmentReduction* matched) {
+  // Root of the pattern must be a SparseSegmentSum/Mean/SqrtN on CPU.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  const string& op = node_def->op();
+  if ((op != "SparseSegmentSum" && op != "SparseSegmentMean" &&
+       op != "SparseSegmentSqrtN") ||
+      !NodeIsOnCpu(node_def) || HasControlFaninOrFanout(*node_view) ||
+      node_view->NumRegularFanins() != 3) {
+    return false;
+  }
+  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_DOUBLE)) {
+    return false;
+  }
+
+  // The indices must be the buckets of a StringToHashBucketFast that has no
+  // other consumer, e.g. the gradient of the reduction.
+  const auto& regular_fanin_1 = node_view->GetRegularFanin(1);
+  const auto* hash_node_view = regular_fanin_1.node_view();
+  const auto* hash_node_def = hash_node_view->node();
+  if (!IsStringToHashBucketFast(*hash_node_def) ||
+      HasControlFaninOrFanout(*hash_node_view) ||
+      !HasAtMostOneFanoutAtPort0(*hash_node_view) ||
+      IsInPreserveSet(ctx, hash_node_def)) {
+    return false;
+  }
+
+  *matched = HashedSparseSegmentReduction(hash_node_view->node_index(),
+                                          node_index);
+  return true;
+}
+
+// Returns the number of operands of `node` if it is an elementwise op that
+// _FusedElementwise evaluates, or 0 otherwise.
+int FusedElementwiseArity(const NodeDef& node) {
+  static const auto* const kUnaryOps = new absl::flat_hash_set<string>(
+      {"Abs", "Exp", "Log", "Neg", "Relu", "Rsqrt", "Sigmoid", "Sqrt",
+       "Square", "Tanh"});
+  static const auto* const kBinaryOps = new absl::flat_hash_set<string>(
+      {"Add", "AddV2", "Div", "Maximum", "Minimum", "Mul", "RealDiv",
+       "SquaredDifference", "Sub"});
+  if (kUnaryOps->contains(node.op())) return 1;
+  if (kBinaryOps->contains(node.op())) return 2;
+  return 0;
+}
+
+bool IsFusedElementwiseCandidate(const utils::MutableNodeView& node_view) {
+  const auto* node_def = node_view.node();
+  const int arity = FusedElementwiseArity(*node_def);
+  return arity > 0 && node_view.NumRegularFanins() == arity &&
+         NodeIsOnCpu(node_def) && !HasControlFaninOrFanout(node_view) &&
+         (HasDataType(node_def, DT_HALF) ||
+          HasDataType(node_def, DT_BFLOAT16) ||
+          HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_DOUBLE));
+}
+
+// Returns whether an operand of shape `shape` broadcasts to `result_shape` the
+// way _FusedElementwise broadcasts its args: it has a single element, or the
+// shape of the innermost dimensions of the result.
+bool IsFusedElementwiseBroadcast(const TensorShapeProto& shape,
+                                 const TensorShapeProto& result_shape) {
+  if (shape.unknown_rank() || result_shape.unknown_rank()) return false;
+  const int offset = result_shape.dim_size() - shape.dim_size();
+  if (offset < 0) return false;
+  bool is_scalar = true;
+  bool is_innermost = true;
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    const int64_t size = shape.dim(i).size();
+    is_scalar &= size == 1;
+    is_innermost &= size >= 0 && size == result_shape.dim(offset + i).size();
+  }
+  return is_scalar || is_innermost;
+}
+
+bool FindFusedElementwise(const RemapperContext& ctx, int node_index,
+                          FusedElementwise* matched) {
+  // XLA fuses elementwise ops itself, and does not know _FusedElementwise.
+  if (ctx.xla_auto_clustering_on ||
+      ctx.disabled_fusions.contains(kFusedElementwise)) {
+    return false;
+  }
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+  if (!IsFusedElementwiseCandidate(*node_view)) return false;
+  const auto& props =
+      ctx.graph_properties.GetOutputProperties(node_def->name());
+  if (props.empty() || props[0].shape().unknown_rank()) return false;
+  const TensorShapeProto& shape = props[0].shape();
+
+  // Checks that the operands of `op_view` broadcast to the result, and finds
+  // the one that can be the previous op of the chain: an op of the same type
+  // with no other consumer and a result of the same shape.
+  const auto find_chained_fanin = [&](const utils::MutableNodeView& op_view,
+                                      int* chained_fanin) -> bool {
+    const auto& input_props =
+        ctx.graph_properties.GetInputProperties(op_view.node()->name());
+    if (input_props.size() != op_view.NumRegularFanins()) return false;
+    *chained_fanin = kMissingIndex;
+    for (int i = 0; i < input_props.size(); ++i) {
+      const TensorShapeProto& fanin_shape = input_props[i].shape();
+      const bool is_full = ShapesSymbolicallyEqual(fanin_shape, shape);
+      if (!is_full && !IsFusedElementwiseBroadcast(fanin_shape, shape)) {
+        return false;
+      }
+      if (!is_full || *chained_fanin != kMissingIndex) continue;
+      const auto& fanin = op_view.GetRegularFanin(i);
+      const auto* fanin_view = fanin.node_view();
+      if (fanin.index() == 0 && IsFusedElementwiseCandidate(*fanin_view) &&
+          HaveSameDataType(node_def, fanin_view->node()) &&
+          HasAtMostOneFanoutAtPort0(*fanin_view) &&
+          !IsInPreserveSet(ctx, fanin_view->node())) {
+        *chained_fanin = i;
+      }
+    }
+    return true;
+  };
+
+  // Walks up the chain from the root.
+  FusedElementwise pattern;
+  int chained_fanin;
+  if (!find_chained_fanin(*node_view, &chained_fanin)) return false;
+  pattern.ops.push_back(node_index);
+  pattern.chained_fanins.push_back(chained_fanin);
+  while (chained_fanin != kMissingIndex &&
+         pattern.ops.size() < kMaxFusedElementwiseOps) {
+    const auto* fanin_view = ctx.graph_view.GetNode(pattern.ops.back())
+                                 ->GetRegularFanin(chained_fanin)
+                                 .node_view();
+    if (!find_chained_fanin(*fanin_view, &chained_fanin)) break;
+    pattern.ops.push_back(fanin_view->node_index());
+    pattern.chained_fanins.push_back(chained_fanin);
+  }
+  pattern.chained_fanins.back() = kMissingIndex;
+
+  // The result of the fused op has the shape of its first arg, an operand of
+  // the first op. If there is none, the chain starts after that op.
+  const auto find_full_fanin = [&](int op_index) {
+    const auto& input_props = ctx.graph_properties.GetInputProperties(
+        ctx.graph_view.GetNode(op_index)->node()->name());
+    for (int i = 0; i < input_props.size(); ++i) {
+      if (ShapesSymbolicallyEqual(input_props[i].shape(), shape)) return i;
+    }
+    return kMissingIndex;
+  };
+  pattern.full_fanin = find_full_fanin(pattern.ops.back());
+  if (pattern.full_fanin == kMissingIndex) {
+    pattern.ops.pop_back();
+    pattern.chained_fanins.pop_back();
+    if (pattern.ops.empty()) return false;
+    pattern.full_fanin = pattern.chained_fanins.back();
+    pattern.chained_fanins.back() = kMissingIndex;
+  }
+  if (pattern.ops.size() < 2) return false;
+
+  std::reverse(pattern.ops.begin(), pattern.ops.end());
+  std::reverse(pattern.chained_fanins.begin(), pattern.chained_fanins.end());
+  *matched = std::move(pattern);
+  return true;
+}
+
 // clang-format off
 // HardSwish pattern
 //                        input     Const (value: 3)
@@ -4336,6 +4547,110 @@ Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return absl::OkStatus();
 }
 
+Status AddHashedSparseSegmentReductionNode(
+    RemapperContext* ctx, const HashedSparseSegmentReduction& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& string_to_hash_bucket =
+      graph->node(matched.string_to_hash_bucket);
+  const NodeDef& sparse_segment_reduction =
+      graph->node(matched.sparse_segment_reduction);
+  VLOG(2) << "Fuse StringToHashBucketFast with "
+          << sparse_segment_reduction.op()
+          << ": string_to_hash_bucket=" << string_to_hash_bucket.name()
+          << " sparse_segment_reduction=" << sparse_segment_reduction.name();
+
+  NodeDef fused_op;
+  fused_op.set_name(sparse_segment_reduction.name());
+  fused_op.set_device(sparse_segment_reduction.device());
+  fused_op.add_input(sparse_segment_reduction.input(0));  // 0: data
+  fused_op.add_input(string_to_hash_bucket.input(0));     // 1: input
+  fused_op.add_input(sparse_segment_reduction.input(2));  // 2: segment_ids
+  fused_op.set_op(kHashedSparseSegmentReduction);
+
+  auto* attr = fused_op.mutable_attr();
+  const auto& src_attr = sparse_segment_reduction.attr();
+  (*attr)["T"] = src_attr.at("T");
+  if (src_attr.count("Tsegmentids")) {
+    (*attr)["Tsegmentids"] = src_attr.at("Tsegmentids");
+  } else {
+    SetAttrValue(DT_INT32, &(*attr)["Tsegmentids"]);
+  }
+  (*attr)["num_buckets"] = string_to_hash_bucket.attr().at("num_buckets");
+  const string& op = sparse_segment_reduction.op();
+  SetAttrValue(op == "SparseSegmentSum"    ? "sum"
+               : op == "SparseSegmentMean" ? "mean"
+                                           : "sqrtn",
+               &(*attr)["combiner"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.sparse_segment_reduction] = true;
+  (*nodes_to_delete)[matched.string_to_hash_bucket] = true;
+
+  return absl::OkStatus();
+}
+
+Status AddFusedElementwiseNode(RemapperContext* ctx,
+                               const FusedElementwise& matched,
+                               std::vector<bool>* invalidated_nodes,
+                               std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& first = graph->node(matched.ops.front());
+  const NodeDef& root = graph->node(matched.ops.back());
+  VLOG(2) << "Fuse " << matched.ops.size()
+          << " elementwise ops into _FusedElementwise: first=" << first.name()
+          << " root=" << root.name();
+
+  // The operands from outside of the chain become the args of the fused op,
+  // starting with one that has the shape of the result.
+  std::vector<string> args = {first.input(matched.full_fanin)};
+  std::vector<string> fused_ops;
+  std::vector<int> operands;
+  for (int i = 0; i < matched.ops.size(); ++i) {
+    const NodeDef& node = graph->node(matched.ops[i]);
+    fused_ops.push_back(node.op());
+    for (int j = 0; j < FusedElementwiseArity(node); ++j) {
+      if (j == matched.chained_fanins[i]) {
+        operands.push_back(-1);  // The result of the previous op.
+        continue;
+      }
+      const auto arg = std::find(args.begin(), args.end(), node.input(j));
+      operands.push_back(arg - args.begin());
+      if (arg == args.end()) args.push_back(node.input(j));
+    }
+  }
+
+  NodeDef fused_op;
+  fused_op.set_name(root.name());
+  fused_op.set_op(kFusedElementwise);
+  fused_op.set_device(root.device());
+  for (const string& arg : args) fused_op.add_input(arg);
+
+  auto* attr = fused_op.mutable_attr();
+  (*attr)["T"] = root.attr().at("T");
+  SetAttrValue(static_cast<int>(args.size()), &(*attr)["N"]);
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+  SetAttrValue(operands, &(*attr)["operands"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.ops.back()] = true;
+  for (int i = 0; i + 1 < matched.ops.size(); ++i) {
+    (*nodes_to_delete)[matched.ops[i]] = true;
+  }
+
+  return absl::OkStatus();
+}
+
 Status AddFusedBatchMatMul(RemapperContext* ctx,
                            const std::map<string, int>& matched_nodes_map,
                            const std::set<int>& remove_node_indices,
@@ -4822,6 +5137,51 @@ bool RequiresInferredShapes(const RemapperContext& ctx, int node_index,
          is_act_biasadd_matmul_candidate();
 }
 
+// Fuses the chains of elementwise ops left after the other fusions, so that
+// they do not take the ops those fuse, e.g. the activation of a contraction.
+Status FuseElementwiseChains(RemapperContext* ctx, bool assume_valid_feeds) {
+  TF_RETURN_IF_ERROR(
+      ctx->graph_view.SortTopologically(/*ignore_cycles=*/false, {}));
+
+  const int num_nodes = ctx->graph_view.NumNodes();
+  std::vector<bool> invalidated_nodes(num_nodes);
+  std::vector<bool> nodes_to_delete(num_nodes);
+  for (int i = num_nodes - 1; i >= 0; --i) {
+    if (invalidated_nodes[i] || nodes_to_delete[i]) continue;
+
+    // Infer properties lazily, for a chain of at least two candidates.
+    const auto* node_view = ctx->graph_view.GetNode(i);
+    if (!ctx->inferred_graph_properties &&
+        IsFusedElementwiseCandidate(*node_view) &&
+        std::any_of(node_view->GetRegularFanins().begin(),
+                    node_view->GetRegularFanins().end(),
+                    [](const auto& fanin) {
+                      return IsFusedElementwiseCandidate(*fanin.node_view());
+                    })) {
+      TF_RETURN_IF_ERROR(ctx->graph_properties.InferStatically(
+          assume_valid_feeds,
+          /*aggressive_shape_inference=*/false,
+          /*include_input_tensor_values=*/true,
+          /*include_output_tensor_values=*/false));
+      ctx->inferred_graph_properties = true;
+    }
+
+    FusedElementwise fused_elementwise;
+    if (FindFusedElementwise(*ctx, i, &fused_elementwise)) {
+      TF_RETURN_IF_ERROR(AddFusedElementwiseNode(
+          ctx, fused_elementwise, &invalidated_nodes, &nodes_to_delete));
+    }
+  }
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  for (int i = 0; i < num_nodes; ++i) {
+    if (nodes_to_delete[i]) {
+      mutation->RemoveNode(ctx->graph_view.GetNode(i));
+    }
+  }
+  return mutation->Apply();
+}
+
 inline bool IsXlaCpuGlobalJitOn() {
   std::vector<string> tf_xla_flags;
   const std::string tf_xla_cpu_global_jit = "--tf_xla_cpu_global_jit";
@@ -5182,6 +5542,18 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap StringToHashBucketFast+SparseSegmentSum/Mean/SqrtN into the
+    // _HashedSparseSegmentReduction.
+    HashedSparseSegmentReduction hashed_sparse_segment_reduction;
+    if (allow_non_differentiable_rewrites &&
+        FindHashedSparseSegmentReduction(ctx, i,
+                                         &hashed_sparse_segment_reduction)) {
+      TF_RETURN_IF_ERROR(AddHashedSparseSegmentReductionNode(
+          &ctx, hashed_sparse_segment_reduction, &invalidated_nodes,
+          &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
@@ -5200,6 +5572,11 @@ Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
   }
   TF_RETURN_IF_ERROR(mutation->Apply());
 
+  if (allow_non_differentiable_rewrites) {
+    TF_RETURN_IF_ERROR(FuseElementwiseChains(
+        &ctx, /*assume_valid_feeds=*/opt_level_ == RewriterConfig::AGGRESSIVE));
+  }
+
   *optimized_graph = std::move(mutable_item.graph);
 
   return absl::OkStatus();
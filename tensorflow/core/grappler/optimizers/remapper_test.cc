@@ -1767,6 +1767,197 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+class RemapperHashedSparseSegmentReductionTest : public RemapperTest {
+ public:
+  void RunTest(const string& combiner) {
+    using ::tensorflow::ops::Placeholder;
+
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+    const int num_buckets = 16;
+    auto data = Placeholder(s.WithOpName("data"), DT_FLOAT,
+                            ops::Placeholder::Shape({num_buckets, 8}));
+    auto ids = Placeholder(s.WithOpName("ids"), DT_STRING,
+                           ops::Placeholder::Shape({6}));
+    auto segment_ids =
+        ops::Const(s.WithOpName("segment_ids"), {0, 0, 1, 1, 1, 3}, {6});
+    auto to_bucket = ops::StringToHashBucketFast(s.WithOpName("to_bucket"),
+                                                 ids, num_buckets);
+    Output reduction;
+    if (combiner == "sum") {
+      reduction = ops::SparseSegmentSum(s.WithOpName("reduction"), data,
+                                        to_bucket, segment_ids);
+    } else if (combiner == "mean") {
+      reduction = ops::SparseSegmentMean(s.WithOpName("reduction"), data,
+                                         to_bucket, segment_ids);
+    } else {
+      reduction = ops::SparseSegmentSqrtN(s.WithOpName("reduction"), data,
+                                          to_bucket, segment_ids);
+    }
+    auto fetch = ops::Identity(s.WithOpName("fetch"), reduction);
+
+    auto data_t = GenerateRandomTensor<DT_FLOAT>({num_buckets, 8});
+    auto ids_t = test::AsTensor<tstring>({"a", "b", "c", "d", "e", "f"});
+
+    GrapplerItem item;
+    item.fetch = {"fetch"};
+    item.feed = {{"data", data_t}, {"ids", ids_t}};
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+    // The fused kernel is only available on CPU.
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    int found = 0;
+    for (const NodeDef& node : output.node()) {
+      EXPECT_NE(node.name(), "to_bucket");
+      if (node.name() == "reduction") {
+        EXPECT_EQ(node.op(), "_HashedSparseSegmentReduction");
+        ASSERT_EQ(node.input_size(), 3);
+        EXPECT_EQ(node.input(0), "data");
+        EXPECT_EQ(node.input(1), "ids");
+        EXPECT_EQ(node.input(2), "segment_ids");
+        EXPECT_EQ(node.attr().at("num_buckets").i(), num_buckets);
+        EXPECT_EQ(node.attr().at("combiner").s(), combiner);
+        found++;
+      }
+    }
+    EXPECT_EQ(found, 1);
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 1);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 1);
+    test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-5);
+  }
+};
+
+TEST_F(RemapperHashedSparseSegmentReductionTest, Sum) { RunTest("sum"); }
+
+TEST_F(RemapperHashedSparseSegmentReductionTest, Mean) { RunTest("mean"); }
+
+TEST_F(RemapperHashedSparseSegmentReductionTest, SqrtN) { RunTest("sqrtn"); }
+
+TEST_F(RemapperTest, FuseElementwiseChain) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto x = Placeholder(s.WithOpName("x"), DT_FLOAT,
+                       ops::Placeholder::Shape({4, 8}));
+  auto bias = Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                          ops::Placeholder::Shape({8}));
+  auto scale = ops::Const(s.WithOpName("scale"), 0.5f);
+  // The operand with the shape of the result is not the first one.
+  auto add = ops::AddV2(s.WithOpName("add"), bias, x);
+  auto mul = ops::Mul(s.WithOpName("mul"), add, scale);
+  auto relu = ops::Relu(s.WithOpName("relu"), mul);
+  auto tanh = ops::Tanh(s.WithOpName("tanh"), relu);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), tanh);
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>({4, 8});
+  auto bias_t = GenerateRandomTensor<DT_FLOAT>({8});
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  item.feed = {{"x", x_t}, {"bias", bias_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  // The fused kernel is only available on CPU.
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "add");
+    EXPECT_NE(node.name(), "mul");
+    EXPECT_NE(node.name(), "relu");
+    if (node.name() == "tanh") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      ASSERT_EQ(node.input_size(), 3);
+      EXPECT_EQ(node.input(0), "x");
+      EXPECT_EQ(node.input(1), "bias");
+      EXPECT_EQ(node.input(2), "scale");
+      const auto& fused_ops = node.attr().at("fused_ops").list().s();
+      EXPECT_EQ(std::vector<string>(fused_ops.begin(), fused_ops.end()),
+                std::vector<string>({"AddV2", "Mul", "Relu", "Tanh"}));
+      const auto& operands = node.attr().at("operands").list().i();
+      EXPECT_EQ(std::vector<int64_t>(operands.begin(), operands.end()),
+                std::vector<int64_t>({1, 0, -1, 2, -1, -1}));
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 1);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 1);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 1);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+}
+
+TEST_F(RemapperTest, FuseElementwiseChainStopsAtSharedResults) {
+  using ::tensorflow::ops::Placeholder;
+
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto x = Placeholder(s.WithOpName("x"), DT_FLOAT,
+                       ops::Placeholder::Shape({16}));
+  auto exp = ops::Exp(s.WithOpName("exp"), x);
+  auto neg = ops::Neg(s.WithOpName("neg"), exp);
+  auto sigmoid = ops::Sigmoid(s.WithOpName("sigmoid"), neg);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), sigmoid);
+  auto other = ops::Identity(s.WithOpName("other"), exp);
+
+  auto x_t = GenerateRandomTensor<DT_FLOAT>({16});
+
+  GrapplerItem item;
+  item.fetch = {"fetch", "other"};
+  item.feed = {{"x", x_t}};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    EXPECT_NE(node.name(), "neg");
+    if (node.name() == "exp") {
+      EXPECT_EQ(node.op(), "Exp");
+      found++;
+    }
+    if (node.name() == "sigmoid") {
+      EXPECT_EQ(node.op(), "_FusedElementwise");
+      ASSERT_EQ(node.input_size(), 1);
+      EXPECT_EQ(node.input(0), "exp");
+      found++;
+    }
+  }
+  EXPECT_EQ(found, 2);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+  ASSERT_EQ(tensors_expected.size(), 2);
+  auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+  ASSERT_EQ(tensors.size(), 2);
+  test::ExpectTensorNear<float>(tensors[0], tensors_expected[0], 1e-6);
+  test::ExpectTensorNear<float>(tensors[1], tensors_expected[1], 1e-6);
+}
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
@@ -1871,6 +2062,46 @@ TEST_F(RemapperFuseMatMulWithBiasTest, Bf16) {
   RunTest<DT_BFLOAT16>();  // NOLINT
 }
 
+TEST_F(RemapperTest, DisabledFusions) {
+  using ::tensorflow::ops::Placeholder;
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+  auto lhs = Placeholder(s.WithOpName("lhs"), DT_FLOAT,
+                         ops::Placeholder::Shape({8, 32}));
+  auto rhs = Placeholder(s.WithOpName("rhs"), DT_FLOAT,
+                         ops::Placeholder::Shape({32, 64}));
+  auto bias = Placeholder(s.WithOpName("bias"), DT_FLOAT,
+                          ops::Placeholder::Shape({64}));
+  auto matmul = ops::MatMul(s.WithOpName("matmul"), lhs, rhs);
+  auto bias_add = ops::BiasAdd(s.WithOpName("bias_add"), matmul, bias);
+  auto fetch = ops::Identity(s.WithOpName("fetch"), bias_add);
+
+  GrapplerItem item;
+  item.fetch = {"fetch"};
+  TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+  for (int i = 0; i < item.graph.node_size(); ++i) {
+    item.graph.mutable_node(i)->set_device("/device:CPU:0");
+  }
+
+  const auto bias_add_op = [](const GraphDef& graph) {
+    for (const NodeDef& node : graph.node()) {
+      if (node.name() == "bias_add") return node.op();
+    }
+    return string();
+  };
+
+  Remapper optimizer(RewriterConfig::ON);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_EQ(bias_add_op(output), "_FusedMatMul");
+
+  setenv("TF_REMAPPER_DISABLED_FUSIONS", "_FusedConv2D,_FusedMatMul",
+         1 /* replace */);
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  unsetenv("TF_REMAPPER_DISABLED_FUSIONS");
+  EXPECT_EQ(bias_add_op(output), "BiasAdd");
+}
+
 // TODO(b/161005848): Fix flaky test.
 TEST_F(RemapperTest, DISABLED_FuseConv2DWithBiasAndActivationOnGPU) {
 #if !(GOOGLE_CUDA)
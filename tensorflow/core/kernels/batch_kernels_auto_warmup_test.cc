@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batch_kernels.h"
 #include "tensorflow/core/kernels/batching_util/warmup.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/test.h"
@@ -276,6 +278,45 @@ TEST_P(BatchFunctionKernelParallelWarmupTest, AutoBatchWorks) {
   }
 }
 
+TEST(WarmupStateRegistryTest, PersistsAutotuneMaps) {
+  serving::WarmupStateRegistry::Key key("autotune_model", 1);
+  const std::string autotune_maps_path =
+      io::JoinPath(testing::TmpDir(), "autotune_model_autotune_maps");
+
+  {
+    auto per_model_data = std::make_unique<PerModelData>();
+    per_model_data->warmup_all_batch_sizes = true;
+    per_model_data->autotune_maps_path = autotune_maps_path;
+    auto handle = serving::GetGlobalWarmupStateRegistry().Register(
+        key, std::move(per_model_data));
+    TF_ASSERT_OK(handle.status());
+    EXPECT_FALSE(Env::Default()->FileExists(autotune_maps_path).ok());
+  }
+  // The autotune maps are written when the model leaves the warm-up state.
+  TF_EXPECT_OK(Env::Default()->FileExists(autotune_maps_path));
+
+  {
+    // The persisted autotune maps are loaded by the next registration.
+    auto per_model_data = std::make_unique<PerModelData>();
+    per_model_data->autotune_maps_path = autotune_maps_path;
+    auto handle = serving::GetGlobalWarmupStateRegistry().Register(
+        key, std::move(per_model_data));
+    TF_ASSERT_OK(handle.status());
+  }
+
+  {
+    // An unreadable file does not prevent the warm-up.
+    TF_ASSERT_OK(WriteStringToFile(Env::Default(), autotune_maps_path,
+                                   "not autotune maps"));
+    auto per_model_data = std::make_unique<PerModelData>();
+    per_model_data->autotune_maps_path = autotune_maps_path;
+    auto handle = serving::GetGlobalWarmupStateRegistry().Register(
+        key, std::move(per_model_data));
+    TF_ASSERT_OK(handle.status());
+    EXPECT_TRUE(serving::GetGlobalWarmupStateRegistry().Lookup(key));
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(BatchFunctionKernelParallelWarmupTestSuite,
                          BatchFunctionKernelParallelWarmupTest,
                          ::testing::Bool());
@@ -50,7 +50,6 @@ limitations under the License.
 #include "tensorflow/core/framework/ops_util.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
-#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
@@ -665,6 +664,30 @@ int BatchResourceBase::RoundToLowestAllowedBatchSize(
                                  batcher_queue_options_.disable_padding);
 }
 
+/*static*/ Tensor BatchResourceBase::RowSplits(
+    const BatchT& batch,
+    const std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks) {
+  if (batch.num_tasks() == 0 || batch.task(0).forced_warmup_batch_size > 0) {
+    Tensor row_splits(DT_INT64, TensorShape({1}));
+    row_splits.vec<int64_t>()(0) = 0;
+    return row_splits;
+  }
+  const int num_tasks = batch.num_tasks() + unbatched_tasks.size();
+  Tensor row_splits(DT_INT64, TensorShape({num_tasks + 1}));
+  auto row_splits_vec = row_splits.vec<int64_t>();
+  int64_t num_rows = 0;
+  row_splits_vec(0) = num_rows;
+  for (int i = 0; i < batch.num_tasks(); ++i) {
+    num_rows += batch.task(i).size();
+    row_splits_vec(i + 1) = num_rows;
+  }
+  for (int i = 0; i < unbatched_tasks.size(); ++i) {
+    num_rows += unbatched_tasks[i]->size();
+    row_splits_vec(batch.num_tasks() + i + 1) = num_rows;
+  }
+  return row_splits;
+}
+
 Status BatchResourceBase::ConcatInputTensors(
     const BatchT& batch,
     const std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks,
@@ -750,6 +773,13 @@ Status BatchResourceBase::ConcatInputTensors(
       }
     }
 
+    // A batch made of a single task without padding is passed through as is,
+    // which saves copying it.
+    if (to_concatenate.size() == 1) {
+      concatenated_tensors->push_back(std::move(to_concatenate[0]));
+      continue;
+    }
+
     Tensor concatenated_tensor;
     Status concat_status =
         Concat(context, to_concatenate, &concatenated_tensor);
@@ -789,10 +819,14 @@ Status BatchResourceBase::ConcatInputTensors(
           for (int j = 0; j < output->size(); ++j) {
             to_concatenate.push_back(std::move((*output)[j][i]));
           }
-          const auto concat_status =
-              Concat(op_kernel_context, to_concatenate, &output_tensor);
-          if (!concat_status.ok()) {
-            status->Update(concat_status);
+          if (to_concatenate.size() == 1) {
+            output_tensor = std::move(to_concatenate[0]);
+          } else {
+            const auto concat_status =
+                Concat(op_kernel_context, to_concatenate, &output_tensor);
+            if (!concat_status.ok()) {
+              status->Update(concat_status);
+            }
           }
           if (forced_warmup_batch_size == 0) {
             op_kernel_context->set_output(i, std::move(output_tensor));
@@ -907,9 +941,12 @@ Status BatchResourceBase::SplitOutputTensors(
           "the 0th dimension sizes of the input tensors");
     }
 
+    // Where the rows of the batched output are aligned, each task gets a slice
+    // of it rather than a copy.
     std::vector<Tensor> split_tensor;
-    const Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
+    const Status split_status =
+        Split(batch->task(0).context, output_tensor,
+              task_sizes_plus_optional_padding, &split_tensor);
     DCHECK(split_status.ok()) << split_status;
     if (!split_status.ok()) {
       return errors::Internal("Tensor split operation failed: ",
@@ -976,6 +1013,7 @@ void BatchResourceBase::ProcessFuncBatch(
   const CostMeasurement::Context batching_context{/*is_per_query=*/false};
   std::vector<std::unique_ptr<CostMeasurement>> batch_cost_measurements =
       CreateCostMeasurements(batching_context);
+  const uint64 batch_start_time_ns = EnvTime::NowNanos();
 
   auto& last_task = batch->task(batch->num_tasks() - 1);
   OpKernelContext* last_task_context = last_task.context;
@@ -997,7 +1035,7 @@ void BatchResourceBase::ProcessFuncBatch(
     // unbatched tasks.
     SplitBatchCostsAndRecordMetrics(
         /* model_name= */ model_name, /* op_name= */ op_name,
-        batch_cost_measurements, processed_size, *batch);
+        batch_cost_measurements, processed_size, *batch, batch_start_time_ns);
     // Clear the measurements before unblocking the batch task, as measurements
     // are associated with the task's thread context.
     batch_cost_measurements.clear();
@@ -1029,6 +1067,9 @@ void BatchResourceBase::ProcessFuncBatch(
   std::vector<Tensor> combined_outputs;
   std::vector<Tensor> args(concatenated_tensors.begin(),
                            concatenated_tensors.end());
+  if (pass_row_splits_) {
+    args.push_back(RowSplits(*batch, unbatched_tasks));
+  }
   const auto& captured_inputs =
       batch->task(batch->num_tasks() - 1).captured_inputs;
   args.insert(args.end(), captured_inputs.begin(), captured_inputs.end());
@@ -1084,6 +1125,7 @@ void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
   const CostMeasurement::Context batching_context{/*is_per_query=*/false};
   std::vector<std::unique_ptr<CostMeasurement>> batch_cost_measurements =
       CreateCostMeasurements(batching_context);
+  const uint64 batch_start_time_ns = EnvTime::NowNanos();
 
   int64_t processed_size = batch->size();
 
@@ -1097,7 +1139,7 @@ void BatchResourceBase::ProcessBatch(std::unique_ptr<BatchT> batch) const {
   auto batch_cost_cleanup = gtl::MakeCleanup([&] {
     SplitBatchCostsAndRecordMetrics(
         /* model_name= */ model_name, /* op_name= */ op_name,
-        batch_cost_measurements, processed_size, *batch);
+        batch_cost_measurements, processed_size, *batch, batch_start_time_ns);
   });
 
   OP_REQUIRES_OK_ASYNC(last_task_context, ValidateBatch(*batch),
@@ -1208,6 +1250,7 @@ Status BatchResourceBase::LookupOrCreateBatcherQueue(const string& queue_name,
     BatcherT::QueueOptions batcher_queue_options = batcher_queue_options_;
     batcher_queue_options.model_batch_stats = &GlobalBatchStatsRegistry().model(
         /* model_name= */ model_name, /* op_name= */ op_name);
+    batcher_queue_options.name = absl::StrCat(model_name, "/", op_name);
 
     TF_RETURN_IF_ERROR(batcher_->AddQueue(
         batcher_queue_options,
@@ -1233,7 +1276,8 @@ void BatchResourceBase::SplitBatchCostsAndRecordMetrics(
     const std::string& model_name, const std::string& op_name,
     const std::vector<std::unique_ptr<CostMeasurement>>&
         batch_cost_measurements,
-    const int64_t processed_size, BatchT& batch) {
+    const int64_t processed_size, BatchT& batch,
+    const uint64 batch_start_time_ns) {
   absl::flat_hash_map<std::string, absl::Duration> batch_costs;
   // 1. Split the batch costs to each task.
   for (const auto& batch_cost_measurement : batch_cost_measurements) {
@@ -1302,6 +1346,12 @@ void BatchResourceBase::SplitBatchCostsAndRecordMetrics(
     request_cost->RecordBatchMetrics(RequestCost::BatchMetrics{
         processed_size, static_cast<int64_t>(batch.task(i).size()),
         padding_size, batch_costs});
+    if (batch_start_time_ns > batch.task(i).start_time) {
+      request_cost->RecordCost(
+          {{kBatchQueueingDelayCostName,
+            absl::Nanoseconds(batch_start_time_ns -
+                              batch.task(i).start_time)}});
+    }
   }
 }
 
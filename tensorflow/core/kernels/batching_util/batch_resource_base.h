@@ -186,6 +186,17 @@ class BatchResourceBase : public ResourceBase {
 
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
+  // If true, the batch processing function receives the row splits of the
+  // batch (see RowSplits() below) right after the batched inputs, which tells
+  // it which rows belong to which task. Inputs of variable length, e.g. the
+  // tokens of sequences of different lengths, can then be packed along the 0th
+  // dimension instead of each being padded to the longest one. Large batch
+  // splitting should be disabled if the rows of a task must be processed
+  // together. Must be set before any input is registered.
+  void set_pass_row_splits(bool pass_row_splits) {
+    pass_row_splits_ = pass_row_splits;
+  }
+
   using CreateBatchTaskFn =
       std::function<StatusOr<std::unique_ptr<BatchTask>>()>;
 
@@ -268,11 +279,23 @@ class BatchResourceBase : public ResourceBase {
   //   1) the batch size;
   //   2) the input size from this task;
   //   3) the padding amount.
+  // - If `batch_start_time_ns` is not 0, the time each task waited from its
+  //   start_time until then is recorded as its kBatchQueueingDelayCostName
+  //   cost.
   static void SplitBatchCostsAndRecordMetrics(
       const std::string& model_name, const std::string& op_name,
       const std::vector<std::unique_ptr<CostMeasurement>>&
           batch_cost_measurements,
-      int64_t processed_size, BatchT& batch);
+      int64_t processed_size, BatchT& batch, uint64 batch_start_time_ns = 0);
+
+  // Returns the row splits of the inputs of the tasks in 'batch' followed by
+  // 'unbatched_tasks', as concatenated by ConcatInputTensors(): an int64
+  // vector whose i-th element is the first row of the i-th task, and whose
+  // last element is the number of rows that are not padding. A warm-up batch,
+  // which holds no task inputs, has row splits [0].
+  static Tensor RowSplits(
+      const BatchT& batch,
+      const std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks);
 
  private:
   // Implementation of calling the process batch function.
@@ -353,6 +376,8 @@ class BatchResourceBase : public ResourceBase {
 
   // True if user specified a batch processing function for this resource.
   const bool has_process_batch_function_;
+  // Whether the batch processing function receives the row splits of batches.
+  bool pass_row_splits_ = false;
   // A batch scheduler, and options for creating queues.
   std::shared_ptr<BatcherT> batcher_;
   BatcherT::QueueOptions batcher_queue_options_;
@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -37,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
@@ -321,6 +323,30 @@ TEST(SplitBatchCostsAndRecordMetricsTest, SplitOnlyNonZeroCostTypes) {
           UnorderedElementsAre(Pair("test_tpu", absl::Milliseconds(100))))));
 }
 
+TEST(SplitBatchCostsAndRecordMetricsTest, RecordsQueueingDelay) {
+  BatchResourceBase::BatchT batch;
+  RequestCost cost1, cost2;
+  auto task1 = MakeBatchTask(/*task_size=*/1, &cost1);
+  task1->start_time = 1000000;
+  auto task2 = MakeBatchTask(/*task_size=*/1, &cost2);
+  task2->start_time = 4000000;
+  batch.AddTask(std::move(task1));
+  batch.AddTask(std::move(task2));
+  batch.Close();
+
+  std::vector<std::unique_ptr<CostMeasurement>> batch_cost_measurements;
+  BatchResourceBase::SplitBatchCostsAndRecordMetrics(
+      "model_name", "op_name", batch_cost_measurements, /*processed_size=*/2,
+      batch, /*batch_start_time_ns=*/5000000);
+
+  EXPECT_THAT(batch.task(0).request_cost->GetCosts(),
+              UnorderedElementsAre(Pair(kBatchQueueingDelayCostName,
+                                        absl::Milliseconds(4))));
+  EXPECT_THAT(batch.task(1).request_cost->GetCosts(),
+              UnorderedElementsAre(Pair(kBatchQueueingDelayCostName,
+                                        absl::Milliseconds(1))));
+}
+
 TEST(SplitBatchCostsAndRecordMetricsTest, UpdatesGlobalBatchStats) {
   // Create batch_cost_measurements with one TPU cost.
   class FakeTpuCostMeasurement : public CostMeasurement {
@@ -418,6 +444,30 @@ TEST(SplitBatchCostsAndRecordMetricsTest, GlobalBatchStatsProcessedSize) {
             original_cumulative_processed_size + 4);
 }
 
+TEST(RowSplitsTest, CoversBatchedAndUnbatchedTasks) {
+  BatchResourceBase::BatchT batch;
+  batch.AddTask(MakeBatchTask(/* task_size= */ 3, nullptr));
+  batch.AddTask(MakeBatchTask(/* task_size= */ 1, nullptr));
+  batch.Close();
+  std::vector<std::unique_ptr<BatchResourceBase::BatchTask>> unbatched_tasks;
+  unbatched_tasks.push_back(MakeBatchTask(/* task_size= */ 2, nullptr));
+
+  test::ExpectTensorEqual<int64_t>(
+      BatchResourceBase::RowSplits(batch, unbatched_tasks),
+      test::AsTensor<int64_t>({0, 3, 4, 6}));
+}
+
+TEST(RowSplitsTest, WarmupBatchHasNoRows) {
+  BatchResourceBase::BatchT batch;
+  auto task = MakeBatchTask(/* task_size= */ 1, nullptr);
+  task->forced_warmup_batch_size = 4;
+  batch.AddTask(std::move(task));
+  batch.Close();
+
+  test::ExpectTensorEqual<int64_t>(BatchResourceBase::RowSplits(batch, {}),
+                                   test::AsTensor<int64_t>({0}));
+}
+
 class BatchResourceBaseTest : public ::testing::Test {
  protected:
   // Like BatchResourceBase but overrides abstract methods, one of which
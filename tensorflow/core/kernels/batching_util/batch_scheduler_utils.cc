@@ -16,9 +16,13 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -67,5 +71,58 @@ int32 GetPrevAllowedBatchSize(int batch_size,
   return *result;
 }
 
+std::optional<LatencyTargetBatching> ChooseBatchingForLatencyTarget(
+    int64_t target_latency_micros, int64_t max_batch_timeout_micros,
+    const std::vector<int32>& allowed_batch_sizes, int max_batch_size,
+    ModelBatchStats& model_batch_stats) {
+  std::optional<double> rate_per_micro =
+      model_batch_stats.arrival_rate().rate_per_micro();
+  if (!rate_per_micro.has_value()) {
+    return std::nullopt;
+  }
+
+  std::vector<int32> candidates = allowed_batch_sizes;
+  if (candidates.empty()) {
+    candidates.push_back(max_batch_size);
+  }
+  DCHECK(absl::c_is_sorted(candidates));
+
+  std::optional<LatencyTargetBatching> result;
+  std::optional<absl::Duration> last_known_cost;
+  int32 last_known_cost_size = 0;
+  for (int32 batch_size : candidates) {
+    if (batch_size > max_batch_size) break;
+
+    std::optional<absl::Duration> cost =
+        model_batch_stats.batch_size(batch_size).tpu_cost().mean();
+    if (cost.has_value()) {
+      last_known_cost = cost;
+      last_known_cost_size = batch_size;
+    } else if (last_known_cost.has_value()) {
+      cost = *last_known_cost * batch_size / last_known_cost_size;
+    } else {
+      continue;
+    }
+
+    const int64_t slack_micros =
+        target_latency_micros - absl::ToInt64Microseconds(*cost);
+    const LatencyTargetBatching batching = {
+        batch_size, std::clamp<int64_t>(slack_micros, 0,
+                                        max_batch_timeout_micros)};
+    // The first task opens the batch, so the rest of it has to arrive before
+    // the batch is full.
+    const bool fits = *rate_per_micro > 0 &&
+                      (batch_size - 1) / *rate_per_micro <= slack_micros;
+    if (!fits) {
+      // Larger batches take longer to fill and cost more, so they do not fit
+      // either.
+      if (!result.has_value()) result = batching;
+      break;
+    }
+    result = batching;
+  }
+  return result;
+}
+
 }  // namespace serving
 }  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_SCHEDULER_UTILS_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_SCHEDULER_UTILS_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -43,6 +44,37 @@ int GetPrevAllowedBatchSize(int batch_size,
                             const std::vector<int32>& allowed_batch_sizes,
                             bool disable_padding);
 
+// The batching parameters chosen by ChooseBatchingForLatencyTarget.
+struct LatencyTargetBatching {
+  // The size at which the open batch is closed without waiting for the
+  // timeout.
+  int batch_size;
+
+  // The time after which the open batch is closed even if it has not reached
+  // `batch_size`.
+  int64_t batch_timeout_micros;
+};
+
+// Chooses the largest batch size that is expected to fill up and finish
+// processing within `target_latency_micros` of the arrival of its first task,
+// given the arrival rate and the mean cost of each batch size recorded in
+// `model_batch_stats`. The candidates are `allowed_batch_sizes` up to
+// `max_batch_size`, or just `max_batch_size` if there are no allowed sizes.
+//
+// A batch size with no recorded cost is assumed to cost as much as the largest
+// smaller batch size with a recorded cost, scaled linearly with the size. If
+// even the smallest candidate cannot meet the target, it is chosen with a zero
+// timeout.
+//
+// The returned timeout is the part of the target not taken by the cost of the
+// chosen batch size, capped at `max_batch_timeout_micros`.
+//
+// Returns std::nullopt if the arrival rate or all batch costs are unknown.
+std::optional<LatencyTargetBatching> ChooseBatchingForLatencyTarget(
+    int64_t target_latency_micros, int64_t max_batch_timeout_micros,
+    const std::vector<int32>& allowed_batch_sizes, int max_batch_size,
+    ModelBatchStats& model_batch_stats);
+
 // Constants containing possible values for the batch_padding_policy argument
 // of MaybeBatchDown. This argument specifies the policy that a batch scheduler
 // is using when deciding what to do when, say, 18 requests need to be batched,
@@ -16,7 +16,9 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -275,6 +277,97 @@ TEST(MaybeBatchDownTest, MinimizeTpuCostPerRequestDoesPadUpWhenNoModelStats) {
   EXPECT_EQ(batch.size(), 3);
 }
 
+// Registers arrivals of `rate_per_micro` units of task size per microsecond
+// over one full window.
+void RegisterArrivalRate(ModelBatchStats& model_batch_stats,
+                         double rate_per_micro) {
+  model_batch_stats.arrival_rate().Register(
+      /* size= */ static_cast<int64_t>(rate_per_micro *
+                                        ArrivalRateTracker::kWindowMicros),
+      /* now_micros= */ 0);
+  model_batch_stats.arrival_rate().Register(
+      /* size= */ 0, /* now_micros= */ ArrivalRateTracker::kWindowMicros);
+}
+
+void RegisterBatchCosts(ModelBatchStats& model_batch_stats) {
+  model_batch_stats.batch_size(1).tpu_cost().Register(absl::Milliseconds(1));
+  model_batch_stats.batch_size(8).tpu_cost().Register(absl::Milliseconds(2));
+  model_batch_stats.batch_size(32).tpu_cost().Register(absl::Milliseconds(5));
+  // Not adding costs for batch 128, which is estimated as 20ms.
+}
+
+TEST(ChooseBatchingForLatencyTargetTest, PicksLargestBatchThatMeetsTarget) {
+  ModelBatchStats model_batch_stats;
+  RegisterArrivalRate(model_batch_stats, /* rate_per_micro= */ 0.01);
+  RegisterBatchCosts(model_batch_stats);
+
+  std::optional<LatencyTargetBatching> batching =
+      ChooseBatchingForLatencyTarget(
+          /* target_latency_micros= */ 10000,
+          /* max_batch_timeout_micros= */ 50000,
+          /* allowed_batch_sizes= */ {1, 8, 32, 128},
+          /* max_batch_size= */ 128, model_batch_stats);
+
+  // 32 tasks arrive in ~3.1ms and cost 5ms, leaving 5ms of timeout.
+  ASSERT_TRUE(batching.has_value());
+  EXPECT_EQ(batching->batch_size, 32);
+  EXPECT_EQ(batching->batch_timeout_micros, 5000);
+}
+
+TEST(ChooseBatchingForLatencyTargetTest, PicksSmallBatchAtLowTraffic) {
+  ModelBatchStats model_batch_stats;
+  RegisterArrivalRate(model_batch_stats, /* rate_per_micro= */ 0.0001);
+  RegisterBatchCosts(model_batch_stats);
+
+  std::optional<LatencyTargetBatching> batching =
+      ChooseBatchingForLatencyTarget(
+          /* target_latency_micros= */ 10000,
+          /* max_batch_timeout_micros= */ 50000,
+          /* allowed_batch_sizes= */ {1, 8, 32, 128},
+          /* max_batch_size= */ 128, model_batch_stats);
+
+  ASSERT_TRUE(batching.has_value());
+  EXPECT_EQ(batching->batch_size, 1);
+  EXPECT_EQ(batching->batch_timeout_micros, 9000);
+}
+
+TEST(ChooseBatchingForLatencyTargetTest, CapsTimeout) {
+  ModelBatchStats model_batch_stats;
+  RegisterArrivalRate(model_batch_stats, /* rate_per_micro= */ 0.01);
+  RegisterBatchCosts(model_batch_stats);
+
+  std::optional<LatencyTargetBatching> batching =
+      ChooseBatchingForLatencyTarget(
+          /* target_latency_micros= */ 10000,
+          /* max_batch_timeout_micros= */ 1000,
+          /* allowed_batch_sizes= */ {1, 8, 32, 128},
+          /* max_batch_size= */ 128, model_batch_stats);
+
+  ASSERT_TRUE(batching.has_value());
+  EXPECT_EQ(batching->batch_size, 32);
+  EXPECT_EQ(batching->batch_timeout_micros, 1000);
+}
+
+TEST(ChooseBatchingForLatencyTargetTest, NoDecisionWithoutStats) {
+  ModelBatchStats no_rate;
+  RegisterBatchCosts(no_rate);
+  EXPECT_EQ(ChooseBatchingForLatencyTarget(
+                /* target_latency_micros= */ 10000,
+                /* max_batch_timeout_micros= */ 50000,
+                /* allowed_batch_sizes= */ {1, 8, 32, 128},
+                /* max_batch_size= */ 128, no_rate),
+            std::nullopt);
+
+  ModelBatchStats no_costs;
+  RegisterArrivalRate(no_costs, /* rate_per_micro= */ 0.01);
+  EXPECT_EQ(ChooseBatchingForLatencyTarget(
+                /* target_latency_micros= */ 10000,
+                /* max_batch_timeout_micros= */ 50000,
+                /* allowed_batch_sizes= */ {1, 8, 32, 128},
+                /* max_batch_size= */ 128, no_costs),
+            std::nullopt);
+}
+
 }  // namespace
 
 }  // namespace serving
@@ -115,6 +115,51 @@ class CostTracker {
   absl::Duration sample_sum_ TF_GUARDED_BY(mu_);
 };
 
+// Tracks the rate at which work arrives, in units of task size per
+// microsecond, as an exponentially-decaying average over fixed-length windows.
+//
+// Thread-safe.
+class ArrivalRateTracker {
+ public:
+  // The length of the window over which arrivals are counted before they are
+  // folded into the average.
+  static constexpr int64_t kWindowMicros = 100 * 1000;
+
+  // Registers the arrival of a task of the given size at the given time.
+  void Register(int64_t size, int64_t now_micros) {
+    mutex_lock l(mu_);
+    if (window_start_micros_ < 0) {
+      window_start_micros_ = now_micros;
+    } else if (now_micros - window_start_micros_ >= kWindowMicros) {
+      // A window that saw no arrivals for a long time yields a low rate, so
+      // the average follows traffic down as well as up.
+      double sample = static_cast<double>(window_size_) /
+                      (now_micros - window_start_micros_);
+      rate_per_micro_ = rate_per_micro_.has_value()
+                            ? (*rate_per_micro_ + sample) / 2
+                            : sample;
+      window_start_micros_ = now_micros;
+      window_size_ = 0;
+    }
+    window_size_ += size;
+  }
+
+  // Returns the average arrival rate in units of task size per microsecond.
+  //
+  // Returns std::nullopt until a full window has been observed.
+  std::optional<double> rate_per_micro() const {
+    mutex_lock l(mu_);
+    return rate_per_micro_;
+  }
+
+ private:
+  mutable mutex mu_;
+
+  int64_t window_start_micros_ TF_GUARDED_BY(mu_) = -1;
+  int64_t window_size_ TF_GUARDED_BY(mu_) = 0;
+  std::optional<double> rate_per_micro_ TF_GUARDED_BY(mu_);
+};
+
 // Tracks statistics for a particular model and batch size.
 //
 // Thread-safe.
@@ -188,6 +233,9 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  // Returns the tracker of the rate at which tasks arrive for this model.
+  ArrivalRateTracker& arrival_rate() { return arrival_rate_; }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +260,9 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  // The rate at which tasks arrive for this model.
+  ArrivalRateTracker arrival_rate_;
 };
 
 // Tracks batch statistics for all models.
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
 
+#include <optional>
 #include <tuple>
 
 #include <gmock/gmock.h>
@@ -137,6 +138,28 @@ TEST(BatchStatsTest, BatchTimeoutIsCorrect) {
   ASSERT_EQ(stats.batch_timeout_micros(), 100);
 }
 
+TEST(BatchStatsTest, ArrivalRateTrackerStartsWithNoRate) {
+  ArrivalRateTracker tracker;
+  ASSERT_EQ(tracker.rate_per_micro(), std::nullopt);
+
+  // A single arrival does not complete a window.
+  tracker.Register(/* size= */ 10, /* now_micros= */ 0);
+  ASSERT_EQ(tracker.rate_per_micro(), std::nullopt);
+}
+
+TEST(BatchStatsTest, ArrivalRateTrackerAveragesWindows) {
+  ArrivalRateTracker tracker;
+
+  // 1000 units arrive in the first window.
+  tracker.Register(/* size= */ 1000, /* now_micros= */ 0);
+  tracker.Register(/* size= */ 10, /* now_micros= */ 100000);
+  ASSERT_DOUBLE_EQ(*tracker.rate_per_micro(), 0.01);
+
+  // 10 units arrive in the second window, which is averaged with the first.
+  tracker.Register(/* size= */ 10, /* now_micros= */ 200000);
+  ASSERT_DOUBLE_EQ(*tracker.rate_per_micro(), (0.01 + 0.0001) / 2);
+}
+
 TEST(BatchStatsTest, NumBatchThreadsIsCorrect) {
   ModelBatchStats stats;
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include <functional>
 #include <list>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -39,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
@@ -90,7 +92,11 @@ namespace serving {
 // down over the lifetime of a server.
 //
 // The batch thread pool round-robins through the queues, running one batch
-// from a queue and then moving to the next queue. Each queue behaves like a
+// (or, see `QueueOptions::scheduling_share`, a few batches) from a queue and
+// then moving to the next queue. A queue may also bound how long its batches
+// wait for a thread, see `QueueOptions::max_scheduling_delay_micros`; queues
+// whose batches waited longer are served ahead of the round-robin order. Each
+// queue behaves like a
 // BasicBatchScheduler instance, in the sense that it has maximum batch size and
 // timeout parameters, which govern when a batch is eligible to be processed.
 //
@@ -110,11 +116,6 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
-// TODO(b/26539183): Support queue servicing policies other than round-robin.
-// E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
-// and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
-//
-//
 // PERFORMANCE TUNING: See README.md.
 //
 template <typename TaskType>
@@ -176,6 +177,19 @@ class SharedBatchScheduler
     // avoid latency spikes.
     int64_t batch_timeout_micros = 0;
 
+    // If positive, the queue chooses its batch timeout, and the batch size at
+    // which it closes a batch without waiting for the timeout, as tasks arrive.
+    // The aim is the largest batches whose tasks still finish, i.e. wait in the
+    // queue and get processed, within this many microseconds. A typical value
+    // is the p99 latency target of the model.
+    //
+    // The choice is based on the arrival rate of tasks and on the batch costs
+    // recorded in `model_batch_stats`, which is required; see
+    // ChooseBatchingForLatencyTarget for details. `batch_timeout_micros` bounds
+    // the chosen timeout, and is used as is until the arrival rate and some
+    // batch cost are known.
+    int64_t target_latency_micros = 0;
+
     // The maximum allowable number of enqueued (accepted by Schedule() but
     // not yet being processed on a batch thread) tasks in terms of batches.
     // If this limit is reached, Schedule() will return an UNAVAILABLE error.
@@ -266,6 +280,27 @@ class SharedBatchScheduler
     // effective only when enable_priority_queue is true.
     MixedPriorityBatchingPolicy mixed_priority_batching_policy =
         MixedPriorityBatchingPolicy::kLowPriorityPaddingWithMaxBatchSize;
+
+    // The number of batches the batch threads take from this queue in a row,
+    // as long as it has schedulable batches, before moving on to the next
+    // queue. E.g. with queues A and B having shares 1 and 2 respectively, the
+    // servicing pattern is ABBABB... Must be positive.
+    int scheduling_share = 1;
+
+    // If positive, a high priority batch of this queue that has been waiting
+    // for longer than this many microseconds since its first task was enqueued
+    // and is schedulable, is taken by the next available batch thread ahead of
+    // the round-robin order. If several queues have such batches, the one that
+    // has exceeded its bound the most is served first. Use it to protect the
+    // latency of models in a high SLO tier from the other models sharing the
+    // scheduler.
+    int64_t max_scheduling_delay_micros = 0;
+
+    // If non-empty, the time high priority batches of this queue wait for a
+    // batch thread, measured from the arrival of their first task, is exported
+    // under this name in the /tensorflow/serving/batching/scheduling_delay_us
+    // metric.
+    string name;
   };
   // This method is marked virtual for testing purposes only.
   virtual Status AddQueue(const QueueOptions& options,
@@ -293,6 +328,11 @@ class SharedBatchScheduler
 
   static bool BatchExists(const BatchTaskUniquePtr& batch_to_process);
 
+  // Returns the queue whose schedulable batch has exceeded its
+  // `max_scheduling_delay_micros` the most, or nullptr if there is none.
+  internal::Queue<TaskType>* GetMostOverdueQueue_Locked()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   const Options options_;
 
   mutex mu_;
@@ -311,6 +351,9 @@ class SharedBatchScheduler
   // available batch thread should grab work.
   typename QueueList::iterator next_queue_to_schedule_ TF_GUARDED_BY(mu_);
 
+  // The number of batches taken in a row from '*next_queue_to_schedule_'.
+  int num_batches_from_next_queue_ TF_GUARDED_BY(mu_) = 0;
+
   // Used by idle batch threads to wait for work to enter the system. Notified
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
@@ -327,6 +370,20 @@ class SharedBatchScheduler
 
 namespace internal {
 
+// Records the time a batch of the queue named `queue_name` waited for a batch
+// thread, measured from the arrival of its first task.
+inline void RecordSchedulingDelayUs(int64_t scheduling_delay_us,
+                                    const string& queue_name) {
+  static auto* cell = monitoring::Sampler<1>::New(
+      {"/tensorflow/serving/batching/scheduling_delay_us",
+       "Tracks the time (in microseconds) batches wait for a batch thread, "
+       "from the arrival of their first task, by queue_name.",
+       "queue_name"},
+      // Buckets from 1us to about 10s.
+      monitoring::Buckets::Exponential(1, 1.5, 40));
+  cell->GetCell(queue_name)->Add(static_cast<double>(scheduling_delay_us));
+}
+
 // A task queue for SharedBatchScheduler. Accepts tasks and accumulates them
 // into batches, and dispenses those batches to be processed via a "pull"
 // interface. The queue's behavior is governed by maximum batch size, timeout
@@ -413,6 +470,19 @@ class Queue {
 
   bool closed() const TF_NO_THREAD_SAFETY_ANALYSIS { return closed_.load(); }
 
+  // Returns the number of batches to take from this queue in a row.
+  int scheduling_share() const { return options_.scheduling_share; }
+
+  // Returns true iff `max_scheduling_delay_micros` is set for this queue.
+  bool has_max_scheduling_delay() const {
+    return options_.max_scheduling_delay_micros > 0;
+  }
+
+  // If the front-most high priority batch is schedulable and has waited
+  // longer than `max_scheduling_delay_micros` at `now_micros`, returns by how
+  // many microseconds. Returns nullopt otherwise.
+  std::optional<int64_t> OverdueMicros(uint64 now_micros) const;
+
  private:
   // Computes the max_execution_batch_size of the queue based on queue options.
   static size_t GetMaxExecutionBatchSize(
@@ -436,6 +506,12 @@ class Queue {
   // Returns true iff the task is a low priority task based on the queue option.
   bool IsLowPriorityTask(std::unique_ptr<TaskType>* task);
 
+  // Registers the arrival of a high priority task of the given size and, if
+  // `options_.target_latency_micros` is set, updates 'batch_timeout_micros_'
+  // and 'target_batch_size_' accordingly.
+  void UpdateBatchingForLatencyTarget(int64_t task_size)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Implementation of Schedule above. Enqueues `task` as it
   // is or split it inline (eagerly) to form batches to be processed by
   // `Queue<TaskType>::ProcessBatch`
@@ -560,6 +636,17 @@ class Queue {
   // might contain an approximate value.
   uint64 open_batch_start_time_micros_ TF_GUARDED_BY(mu_);
 
+  // The times at which the first task was added to each of the closed batches
+  // in 'high_priority_batches_', front to back.
+  std::deque<uint64> closed_batch_start_times_micros_ TF_GUARDED_BY(mu_);
+
+  // The timeout, and the size, at which the open batch in
+  // 'high_priority_batches_' becomes schedulable. Taken from the queue options
+  // unless `target_latency_micros` is set, in which case they are updated in
+  // UpdateBatchingForLatencyTarget().
+  int64_t batch_timeout_micros_ TF_GUARDED_BY(mu_);
+  size_t target_batch_size_ TF_GUARDED_BY(mu_);
+
   // Whether this queue contains a batch that is eligible to be scheduled.
   // Used to keep track of when to call 'schedulable_batch_callback_'.
   bool schedulable_batch_ TF_GUARDED_BY(mu_) = false;
@@ -672,11 +759,32 @@ Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         "batch_timeout_micros must be non-negative; was ",
         options.batch_timeout_micros);
   }
+  if (options.scheduling_share < 1) {
+    return errors::InvalidArgument("scheduling_share must be positive; was ",
+                                   options.scheduling_share);
+  }
+  if (options.max_scheduling_delay_micros < 0) {
+    return errors::InvalidArgument(
+        "max_scheduling_delay_micros must be non-negative; was ",
+        options.max_scheduling_delay_micros);
+  }
   if (options.max_enqueued_batches == 0) {
     return errors::InvalidArgument(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.target_latency_micros < 0) {
+    return errors::InvalidArgument(
+        "target_latency_micros must be non-negative; was ",
+        options.target_latency_micros);
+  }
+  if (options.target_latency_micros > 0 &&
+      options.model_batch_stats == nullptr) {
+    return errors::InvalidArgument(
+        "model_batch_stats must be specified when target_latency_micros is "
+        "set: ",
+        options.target_latency_micros);
+  }
 
   if (options.enable_large_batch_splitting &&
       options.split_input_task_func == nullptr) {
@@ -739,12 +847,41 @@ bool SharedBatchScheduler<TaskType>::BatchExists(
   return batch_to_process != nullptr;
 }
 
+template <typename TaskType>
+internal::Queue<TaskType>*
+SharedBatchScheduler<TaskType>::GetMostOverdueQueue_Locked() {
+  internal::Queue<TaskType>* most_overdue_queue = nullptr;
+  int64_t max_overdue_micros = 0;
+  const uint64 now_micros = options_.env->NowMicros();
+  for (const auto& queue : queues_) {
+    std::optional<int64_t> overdue_micros = queue->OverdueMicros(now_micros);
+    if (overdue_micros.has_value() && *overdue_micros > max_overdue_micros) {
+      most_overdue_queue = queue.get();
+      max_overdue_micros = *overdue_micros;
+    }
+  }
+  return most_overdue_queue;
+}
+
 template <typename TaskType>
 void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     internal::Queue<TaskType>** queue_for_batch_out,
     BatchTaskUniquePtr* batch_to_process_out) {
   BatchTaskUniquePtr batch_to_process;
   internal::Queue<TaskType>* queue_for_batch = nullptr;
+
+  // A queue whose batch waited longer than it allows is served first, without
+  // affecting the round-robin order.
+  if (internal::Queue<TaskType>* overdue_queue = GetMostOverdueQueue_Locked();
+      overdue_queue != nullptr) {
+    batch_to_process = overdue_queue->ScheduleBatch();
+    if (BatchExists(batch_to_process)) {
+      *queue_for_batch_out = overdue_queue;
+      *batch_to_process_out = std::move(batch_to_process);
+      return;
+    }
+  }
+
   const int num_queues = queues_.size();
   for (int num_queues_tried = 0;
        !BatchExists(batch_to_process) && num_queues_tried < num_queues;
@@ -762,9 +899,15 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
 
     if (BatchExists(batch_to_process)) {
       queue_for_batch = next_queue_to_schedule_->get();
+      // Stay on the queue until it has been served its share of batches.
+      if (++num_batches_from_next_queue_ <
+          queue_for_batch->scheduling_share()) {
+        break;
+      }
     }
 
     // Advance 'next_queue_to_schedule_'.
+    num_batches_from_next_queue_ = 0;
     if (queue_closed && (*next_queue_to_schedule_)->IsEmpty() &&
         !BatchExists(batch_to_process)) {
       // We've encountered a closed queue with no work to do. Drop it.
@@ -825,6 +968,8 @@ Queue<TaskType>::Queue(
   // the same traceme_context_id_counter_.
   traceme_context_id_counter_ = (absl::GetCurrentTimeNanos() & 0xFFFFFFFF)
                                 << 32;
+  batch_timeout_micros_ = options_.batch_timeout_micros;
+  target_batch_size_ = max_execution_batch_size_;
   GetBatches().emplace_back(new Batch<TaskType>);
 }
 
@@ -855,6 +1000,27 @@ bool Queue<TaskType>::IsLowPriorityTask(std::unique_ptr<TaskType>* task) {
   return false;
 }
 
+template <typename TaskType>
+void Queue<TaskType>::UpdateBatchingForLatencyTarget(int64_t task_size) {
+  if (options_.target_latency_micros <= 0) {
+    return;
+  }
+  ModelBatchStats& model_batch_stats = *options_.model_batch_stats;
+  model_batch_stats.arrival_rate().Register(task_size, env_->NowMicros());
+
+  std::optional<LatencyTargetBatching> batching =
+      ChooseBatchingForLatencyTarget(
+          options_.target_latency_micros, options_.batch_timeout_micros,
+          options_.allowed_batch_sizes, max_execution_batch_size(),
+          model_batch_stats);
+  if (!batching.has_value()) {
+    return;
+  }
+  batch_timeout_micros_ = batching->batch_timeout_micros;
+  target_batch_size_ = batching->batch_size;
+  model_batch_stats.SetBatchTimeoutMicros(batch_timeout_micros_);
+}
+
 template <typename TaskType>
 Status Queue<TaskType>::ScheduleWithoutOrEagerSplitImpl(
     std::unique_ptr<TaskType>* task) {
@@ -923,7 +1089,9 @@ Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
       TF_RETURN_IF_ERROR(ValidateLowPriorityTaskQueueCapacity(**task));
       low_priority_tasks_.AddTask(std::move(*task), env_->NowMicros());
     } else {
+      const int64_t task_size = (*task)->size();
       TF_RETURN_IF_ERROR(ScheduleWithoutOrEagerSplitImpl(task));
+      UpdateBatchingForLatencyTarget(task_size);
     }
 
     // Check if the batch queue has a schedulable batch and mark it schedulable
@@ -1055,6 +1223,9 @@ Queue<TaskType>::ScheduleBatch() {
   // The batch to schedule, which we may populate below. (If left as nullptr,
   // that means we are electing not to schedule a batch at this time.)
   std::unique_ptr<Batch<TaskType>> batch_to_schedule;
+  // The time the scheduled batch waited since its first task was enqueued, if
+  // it is a high priority batch.
+  std::optional<int64_t> scheduling_delay_micros;
 
   {
     mutex_lock l(mu_);
@@ -1109,6 +1280,9 @@ Queue<TaskType>::ScheduleBatch() {
       // There is at least one closed batch that is ready to be scheduled.
       batch_to_schedule = std::move(batches.front());
       batches.pop_front();
+      scheduling_delay_micros =
+          env_->NowMicros() - closed_batch_start_times_micros_.front();
+      closed_batch_start_times_micros_.pop_front();
     }
 
     if (batch_to_schedule == nullptr) {
@@ -1127,9 +1301,38 @@ Queue<TaskType>::ScheduleBatch() {
     // Otherwise, increment the counter and return the batch.
     ++num_batches_being_processed_;
   }
+  if (scheduling_delay_micros.has_value() && !options_.name.empty()) {
+    RecordSchedulingDelayUs(*scheduling_delay_micros, options_.name);
+  }
   return batch_to_schedule;
 }
 
+template <typename TaskType>
+std::optional<int64_t> Queue<TaskType>::OverdueMicros(uint64 now_micros) const {
+  if (!has_max_scheduling_delay()) {
+    return std::nullopt;
+  }
+  mutex_lock l(mu_);
+  uint64 start_time_micros;
+  if (!closed_batch_start_times_micros_.empty()) {
+    start_time_micros = closed_batch_start_times_micros_.front();
+  } else if (IsOpenBatchSchedulable()) {
+    start_time_micros = open_batch_start_time_micros_;
+  } else {
+    return std::nullopt;
+  }
+  if (now_micros <= start_time_micros) {
+    return std::nullopt;
+  }
+  const int64_t overdue_micros =
+      static_cast<int64_t>(now_micros - start_time_micros) -
+      options_.max_scheduling_delay_micros;
+  if (overdue_micros <= 0) {
+    return std::nullopt;
+  }
+  return overdue_micros;
+}
+
 template <typename TaskType>
 std::vector<std::unique_ptr<TaskType>> Queue<TaskType>::GetLowPriorityTasks(
     size_t size) {
@@ -1232,6 +1435,9 @@ bool Queue<TaskType>::IsEmptyInternal() const {
 template <typename TaskType>
 void Queue<TaskType>::StartNewBatch() {
   std::deque<std::unique_ptr<Batch<TaskType>>>& batches = GetBatches();
+  closed_batch_start_times_micros_.push_back(batches.back()->empty()
+                                                 ? env_->NowMicros()
+                                                 : open_batch_start_time_micros_);
   batches.back()->Close();
   batches.emplace_back(new Batch<TaskType>(++traceme_context_id_counter_));
 }
@@ -1253,9 +1459,9 @@ bool Queue<TaskType>::IsOpenBatchSchedulable() const {
   if (open_batch->empty()) {
     return false;
   }
-  return closed_ || open_batch->size() >= max_execution_batch_size() ||
+  return closed_ || open_batch->size() >= target_batch_size_ ||
          env_->NowMicros() >=
-             open_batch_start_time_micros_ + options_.batch_timeout_micros;
+             open_batch_start_time_micros_ + batch_timeout_micros_;
 }
 
 template <typename TaskType>
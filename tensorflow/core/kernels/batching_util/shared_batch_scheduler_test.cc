@@ -38,6 +38,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
@@ -799,6 +800,132 @@ TEST_P(SharedBatchSchedulerTest, Fairness) {
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, ServesQueuesAccordingToSchedulingShare) {
+  mutex mu;
+  std::vector<int> processed_queues;
+  Notification first_batch_scheduled, first_batch_proceed;
+  auto callback_for_queue = [&](int queue_index) {
+    return [&, queue_index](std::unique_ptr<Batch<FakeTask>> batch) {
+      {
+        mutex_lock l(mu);
+        processed_queues.push_back(queue_index);
+      }
+      if (!first_batch_scheduled.HasBeenNotified()) {
+        first_batch_scheduled.Notify();
+        first_batch_proceed.WaitForNotification();
+      }
+    };
+  };
+
+  auto scheduler = CreateSharedBatchScheduler(1);
+  QueueOptions queue_options = CreateQueueOptions(
+      10 /* max_execution_batch_size */, 10 /* input_batch_size_limit */,
+      1000 * 1000 /* batch_timeout_micros */, 10 /* max_enqueued_batches */);
+  queue_options.scheduling_share = 2;
+  std::unique_ptr<Queue> queue_0 =
+      CreateQueue(scheduler, queue_options, callback_for_queue(0));
+  queue_options.scheduling_share = 1;
+  std::unique_ptr<Queue> queue_1 =
+      CreateQueue(scheduler, queue_options, callback_for_queue(1));
+
+  // Block the batch thread on a batch of queue 0 while batches of both queues
+  // are enqueued.
+  TF_ASSERT_OK(ScheduleTask(10, queue_0.get()));
+  first_batch_scheduled.WaitForNotification();
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(ScheduleTask(10, queue_0.get()));
+    TF_ASSERT_OK(ScheduleTask(10, queue_1.get()));
+  }
+  first_batch_proceed.Notify();
+
+  // Wait for all batches to be processed.
+  queue_0.reset();
+  queue_1.reset();
+
+  mutex_lock l(mu);
+  EXPECT_THAT(processed_queues, ::testing::ElementsAre(0, 0, 1, 0, 0, 1, 1));
+}
+
+TEST_P(SharedBatchSchedulerTest, ServesOverdueQueueFirst) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    mutex mu;
+    std::vector<int> processed_queues;
+    Notification first_batch_scheduled, first_batch_proceed;
+    auto callback_for_queue = [&](int queue_index) {
+      return [&, queue_index](std::unique_ptr<Batch<FakeTask>> batch) {
+        {
+          mutex_lock l(mu);
+          processed_queues.push_back(queue_index);
+        }
+        if (!first_batch_scheduled.HasBeenNotified()) {
+          first_batch_scheduled.Notify();
+          first_batch_proceed.WaitForNotification();
+        }
+      };
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions queue_options = CreateQueueOptions(
+        10 /* max_execution_batch_size */, 10 /* input_batch_size_limit */,
+        1000 * 1000 /* batch_timeout_micros */, 10 /* max_enqueued_batches */);
+    queue_options.scheduling_share = 3;
+    std::unique_ptr<Queue> queue_0 =
+        CreateQueue(scheduler, queue_options, callback_for_queue(0));
+    queue_options.scheduling_share = 1;
+    queue_options.max_scheduling_delay_micros = 1000;
+    std::unique_ptr<Queue> queue_1 =
+        CreateQueue(scheduler, queue_options, callback_for_queue(1));
+
+    // Block the batch thread on a batch of queue 0, which is owed two more
+    // batches, and let a batch of queue 1 exceed its scheduling delay.
+    TF_ASSERT_OK(ScheduleTask(10, queue_0.get()));
+    first_batch_scheduled.WaitForNotification();
+    TF_ASSERT_OK(ScheduleTask(10, queue_0.get()));
+    TF_ASSERT_OK(ScheduleTask(10, queue_0.get()));
+    TF_ASSERT_OK(ScheduleTask(10, queue_1.get()));
+    env.AdvanceByMicroseconds(2000);
+    first_batch_proceed.Notify();
+
+    // Shut everything down.
+    start_teardown.Notify();
+    queue_0.reset();
+    queue_1.reset();
+
+    mutex_lock l(mu);
+    EXPECT_THAT(processed_queues, ::testing::ElementsAre(0, 1, 0, 0));
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, InvalidSchedulingOptions) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {
+    // do nothing.
+  };
+  auto scheduler = CreateSharedBatchScheduler(1);
+  std::unique_ptr<Queue> queue;
+
+  QueueOptions queue_options = CreateQueueOptions(
+      10 /* max_execution_batch_size */, 10 /* input_batch_size_limit */,
+      0 /* batch_timeout_micros */, 10 /* max_enqueued_batches */);
+  queue_options.scheduling_share = 0;
+  EXPECT_THAT(scheduler->AddQueue(queue_options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                "scheduling_share must be positive; was 0"));
+
+  queue_options.scheduling_share = 1;
+  queue_options.max_scheduling_delay_micros = -1;
+  EXPECT_THAT(
+      scheduler->AddQueue(queue_options, callback, &queue),
+      testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          "max_scheduling_delay_micros must be non-negative; was -1"));
+}
+
 TEST_P(SharedBatchSchedulerTest, ConstMethods) {
   for (const int max_enqueued_batches : {1, 2, 5}) {
     Notification processing, proceed;
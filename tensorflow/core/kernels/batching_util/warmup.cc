@@ -16,16 +16,59 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
 #include "tsl/platform/logging.h"
 
 namespace tensorflow {
 namespace serving {
+namespace {
+
+// Loads the autotune maps serialized in the file at `path`, if it exists.
+void MaybeLoadAutotuneMaps(const std::string& path) {
+  if (path.empty() || !Env::Default()->FileExists(path).ok()) {
+    return;
+  }
+  std::string serialized_autotune_maps;
+  absl::Status status =
+      ReadFileToString(Env::Default(), path, &serialized_autotune_maps);
+  if (status.ok()) {
+    status = LoadSerializedAutotuneMaps(serialized_autotune_maps);
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to load autotune maps from " << path << ": "
+                 << status;
+    return;
+  }
+  VLOG(1) << "Loaded autotune maps from " << path;
+}
+
+// Serializes the autotune maps to the file at `path`.
+void MaybeSaveAutotuneMaps(const std::string& path) {
+  if (path.empty()) {
+    return;
+  }
+  std::string serialized_autotune_maps;
+  absl::Status status = SerializeAutotuneMaps(&serialized_autotune_maps);
+  if (status.ok()) {
+    status = WriteStringToFile(Env::Default(), path, serialized_autotune_maps);
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to save autotune maps to " << path << ": "
+                 << status;
+    return;
+  }
+  VLOG(1) << "Saved autotune maps to " << path;
+}
+
+}  // namespace
 
 void WarmupStateRegistry::Handle::Release() {
   if (!key_.has_value()) {
@@ -38,23 +81,42 @@ void WarmupStateRegistry::Handle::Release() {
 
 absl::StatusOr<WarmupStateRegistry::Handle> WarmupStateRegistry::Register(
     const Key& model_key, std::unique_ptr<PerModelData> per_model_data) {
-  absl::MutexLock l(&mu_);
-  VLOG(1) << "Registering model " << model_key.name << ":" << model_key.version
-          << " to warm-up registry";
-  if (!states_.insert(std::pair(model_key, std::move(per_model_data))).second) {
-    return absl::AlreadyExistsError(
-        absl::StrCat("Model ", model_key.name, ":", model_key.version,
-                     " already exists in the warm-up registry"));
+  std::string autotune_maps_path;
+  {
+    absl::MutexLock l(&mu_);
+    VLOG(1) << "Registering model " << model_key.name << ":"
+            << model_key.version << " to warm-up registry";
+    if (per_model_data != nullptr) {
+      autotune_maps_path = per_model_data->autotune_maps_path;
+    }
+    if (!states_.insert(std::pair(model_key, std::move(per_model_data)))
+             .second) {
+      return absl::AlreadyExistsError(
+          absl::StrCat("Model ", model_key.name, ":", model_key.version,
+                       " already exists in the warm-up registry"));
+    }
   }
+  MaybeLoadAutotuneMaps(autotune_maps_path);
   return Handle(model_key, this);
 }
 
 void WarmupStateRegistry::Unregister(const Key& model_key) {
-  absl::MutexLock l(&mu_);
+  std::string autotune_maps_path;
+  {
+    absl::MutexLock l(&mu_);
 
-  VLOG(1) << "Unregistering model " << model_key.name << ":"
-          << model_key.version << " from warm-up registry";
-  states_.erase(model_key);
+    VLOG(1) << "Unregistering model " << model_key.name << ":"
+            << model_key.version << " from warm-up registry";
+    auto it = states_.find(model_key);
+    if (it == states_.end()) {
+      return;
+    }
+    if (it->second != nullptr) {
+      autotune_maps_path = it->second->autotune_maps_path;
+    }
+    states_.erase(it);
+  }
+  MaybeSaveAutotuneMaps(autotune_maps_path);
 }
 
 const WarmupStateRegistry::PerModelData* WarmupStateRegistry::Lookup(
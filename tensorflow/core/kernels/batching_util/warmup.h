@@ -59,6 +59,14 @@ class WarmupStateRegistry {
     // for all `allowed_batch_sizes` of that batch op. This removes the
     // need to issue separate warmup requests for each batch size.
     bool warmup_all_batch_sizes = false;
+
+    // If non-empty, the path of a file holding serialized autotune maps (see
+    // tensorflow/core/util/autotune_maps/autotune_serialize.h). They are loaded
+    // when the model is registered, if the file exists, and the autotune maps
+    // are written back to it when the model is unregistered. Combined with
+    // `warmup_all_batch_sizes`, this lets later loads of the model skip the
+    // autotuning done for each batch size during warm-up.
+    std::string autotune_maps_path;
   };
 
   // RAII handle for registered models.
@@ -663,6 +663,15 @@ BM_FusedConv2DWithBatchNormAndRelu(16, 32, 32, 128, 3, 3, 1024, cpu,
 BM_FusedConv2DWithBatchNormAndRelu(32, 32, 32, 128, 3, 3, 1024, cpu,
                                    "3x3 /b 32");
 
+// -------------------------------------------------------------------------- //
+// 3x3 Convolution with few channels (run with TF_USE_DIRECT_CONV2D=1 to
+// benchmark DirectConv2D)
+// -------------------------------------------------------------------------- //
+
+BM_Conv2D(8, 224, 224, 3, 3, 3, 32, cpu, "3x3 3->32 /b 8");
+BM_Conv2D(8, 112, 112, 1, 3, 3, 16, cpu, "3x3 1->16 /b 8");
+BM_Conv2D(8, 112, 112, 4, 3, 3, 64, cpu, "3x3 4->64 /b 8");
+
 #if GOOGLE_CUDA
 // -------------------------------------------------------------------------- //
 // 1x1 Convolution
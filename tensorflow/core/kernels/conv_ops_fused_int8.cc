@@ -19,6 +19,7 @@ limitations under the License.
 #if GOOGLE_CUDA
 #include "tensorflow/core/kernels/numeric_options_utils.h"
 #include "tensorflow/core/protobuf/autotuning.pb.h"
+#include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
 #endif  // GOOGLE_CUDA
 #include "tensorflow/core/kernels/autotune_conv_impl.h"
 #include "tensorflow/core/kernels/conv_ops_fused_impl.h"
@@ -573,6 +574,7 @@ void operator()(
 
   const bool use_cudnn_frontend = CudnnUseFrontend();
   AutotuneEntry<se::dnn::FusedConvOp> autotune_entry;
+  MaybeLoadPersistedAutotuneMaps();
   if (!FusedConvAutotuneMap::GetInstance()->Find(fused_conv_parameters,
                                                  &autotune_entry)) {
     VLOG(2) << "Autotuning fused convolution (use_frontend="
@@ -660,6 +662,7 @@ void operator()(
 
     FusedConvAutotuneMap::GetInstance()->Insert(fused_conv_parameters,
                                                 autotune_entry);
+    MaybePersistAutotuneMaps();
   }
 
   DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx);
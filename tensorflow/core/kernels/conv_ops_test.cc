@@ -473,12 +473,47 @@ class ConvOpTest : public OpsTestBase {
     const Tensor& output = *GetOutput(0);
     test::ExpectTensorNear<float>(expected, output, 1e-5);
   }
+
+  // Runs a convolution with few channels, with and without DirectConv2D.
+  void DirectConvComparative(int stride, const string& padding) {
+    Tensor image(DT_FLOAT, {2, 9, 11, 3});
+    image.flat<float>().setRandom();
+    Tensor filter(DT_FLOAT, {3, 3, 3, 16});
+    filter.flat<float>().setRandom();
+
+    Tensor outputs[2];
+    for (int use_direct_conv2d = 0; use_direct_conv2d < 2;
+         ++use_direct_conv2d) {
+      setenv("TF_USE_DIRECT_CONV2D", use_direct_conv2d ? "1" : "0", 1);
+      TF_EXPECT_OK(NodeDefBuilder("conv_op", "Conv2D")
+                       .Input(FakeInput(DT_FLOAT))
+                       .Input(FakeInput(DT_FLOAT))
+                       .Attr("T", DT_FLOAT)
+                       .Attr("strides", {1, stride, stride, 1})
+                       .Attr("padding", padding)
+                       .Finalize(node_def()));
+      TF_EXPECT_OK(InitOp());
+      inputs_.clear();
+      AddInputFromArray<float>(image.shape(), image.flat<float>());
+      AddInputFromArray<float>(filter.shape(), filter.flat<float>());
+      TF_ASSERT_OK(RunOpKernel());
+      outputs[use_direct_conv2d] = *GetOutput(0);
+    }
+    unsetenv("TF_USE_DIRECT_CONV2D");
+    test::ExpectTensorNear<float>(outputs[0], outputs[1], 1e-4);
+  }
 };
 
 TEST_F(ConvOpTest, HandwrittenConv) { HandwrittenConv(); }
 
 TEST_F(ConvOpTest, AnisotropicStride) { AnisotropicStrides(); }
 
+TEST_F(ConvOpTest, DirectConvSame) { DirectConvComparative(1, "SAME"); }
+
+TEST_F(ConvOpTest, DirectConvValid) { DirectConvComparative(1, "VALID"); }
+
+TEST_F(ConvOpTest, DirectConvStridedSame) { DirectConvComparative(2, "SAME"); }
+
 template <typename T>
 class FusedConv2DOpTest : public OpsTestBase {
  protected:
@@ -212,6 +212,9 @@ class BatchDatasetOp::Dataset : public DatasetBase {
           *end_of_sequence = true;
           return absl::OkStatus();
         }
+        if (ctx->index_mapper() == nullptr && input_impl_->SupportsBlocks()) {
+          return GetNextBlockFromInput(ctx, out_tensors, end_of_sequence);
+        }
         batch_elements.reserve(dataset()->reserve_size_);
         *end_of_sequence = false;
         IteratorContextWithIndexMapper ctx_with_index_mapper(ctx, this);
@@ -255,6 +258,31 @@ class BatchDatasetOp::Dataset : public DatasetBase {
       return absl::OkStatus();
     }
 
+    // Gets the batch as a single block of elements from the input, which
+    // already holds the elements stacked the way they are batched.
+    Status GetNextBlockFromInput(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      int64_t num_elements;
+      TF_RETURN_IF_ERROR(input_impl_->GetNextBlock(ctx, dataset()->batch_size_,
+                                                   out_tensors, &num_elements,
+                                                   end_of_sequence));
+      if (*end_of_sequence) {
+        input_impl_.reset();
+        return absl::OkStatus();
+      }
+      if (num_elements < dataset()->batch_size_) {
+        // The input has ended.
+        input_impl_.reset();
+        if (dataset()->drop_remainder_) {
+          out_tensors->clear();
+          *end_of_sequence = true;
+        }
+      }
+      return absl::OkStatus();
+    }
+
     IndexMapperFn GetIndexMapper(
         IndexMapperFn parent_index_mapper) const override {
       int64_t batch_size = dataset()->batch_size_;
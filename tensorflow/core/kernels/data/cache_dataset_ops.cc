@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_dataset_ops.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -22,8 +23,13 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
+#include "tensorflow/core/data/hash_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -37,7 +43,10 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/file_statistics.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
@@ -76,6 +85,118 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+constexpr char kPassThrough[] = "pass_through";
+constexpr char kSharedCacheDirEnvVar[] = "TF_DATA_SHARED_CACHE_DIR";
+constexpr char kSharedCacheMaxBytesEnvVar[] = "TF_DATA_SHARED_CACHE_MAX_BYTES";
+constexpr char kSharedCachePrefix[] = "tfdata_cache_";
+constexpr char kAccessFileSuffix[] = ".access";
+// Length of `kSharedCachePrefix` followed by a 16 digit hex fingerprint.
+constexpr size_t kSharedCacheKeyLength = 29;
+
+// Returns the prefix of the cache files of `input` in the host-wide shared
+// cache directory, if the `TF_DATA_SHARED_CACHE_DIR` environment variable is
+// set, or an empty string otherwise. Pipelines with the same fingerprint,
+// e.g. the trials of a hyperparameter sweep over the same preprocessed data,
+// get the same prefix, so that the first of them to finish an epoch caches
+// the data for all of the others.
+absl::StatusOr<std::string> SharedCacheFilename(OpKernelContext* ctx,
+                                                const DatasetBase* input) {
+  std::string dir;
+  TF_RETURN_IF_ERROR(ReadStringFromEnvVar(kSharedCacheDirEnvVar, "", &dir));
+  if (dir.empty()) {
+    return std::string();
+  }
+  GraphDef graph_def;
+  SerializationContext::Params params(ctx);
+  std::vector<std::pair<string, Tensor>> input_list;
+  params.input_list = &input_list;
+  params.external_state_policy = ExternalStatePolicy::POLICY_IGNORE;
+  TF_RETURN_IF_ERROR(
+      AsGraphDef(input, SerializationContext(params), &graph_def));
+  uint64 hash;
+  TF_RETURN_IF_ERROR(HashGraph(graph_def, &hash));
+  TF_RETURN_IF_ERROR(ctx->env()->RecursivelyCreateDir(dir));
+  return io::JoinPath(
+      dir, absl::StrCat(kSharedCachePrefix, absl::Hex(hash, absl::kZeroPad16)));
+}
+
+// Records that the shared cache with prefix `filename` is in use, for LRU
+// eviction.
+void TouchSharedCache(Env* env, const std::string& filename) {
+  Status s = WriteStringToFile(env, absl::StrCat(filename, kAccessFileSuffix),
+                               absl::StrCat(EnvTime::NowSeconds()));
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to record the use of shared cache " << filename
+                 << ": " << s;
+  }
+}
+
+// If the complete caches in the shared cache directory of `filename` take
+// more than `TF_DATA_SHARED_CACHE_MAX_BYTES`, deletes the least recently used
+// ones, other than `filename`, until they fit. Caches which are being written
+// are never deleted.
+Status EvictSharedCaches(Env* env, const std::string& filename) {
+  int64_t max_bytes;
+  TF_RETURN_IF_ERROR(
+      ReadInt64FromEnvVar(kSharedCacheMaxBytesEnvVar, 0, &max_bytes));
+  if (max_bytes <= 0) {
+    return absl::OkStatus();
+  }
+  struct Cache {
+    std::vector<std::string> files;
+    uint64 bytes = 0;
+    int64_t last_use_nsec = 0;
+    bool complete = false;
+    bool locked = false;
+  };
+  const std::string dir(io::Dirname(filename));
+  std::vector<string> children;
+  TF_RETURN_IF_ERROR(env->GetChildren(dir, &children));
+  absl::flat_hash_map<std::string, Cache> caches;
+  for (const string& child : children) {
+    if (!absl::StartsWith(child, kSharedCachePrefix) ||
+        child.size() < kSharedCacheKeyLength) {
+      continue;
+    }
+    const std::string path = io::JoinPath(dir, child);
+    FileStatistics stat;
+    if (!env->Stat(path, &stat).ok()) {
+      continue;  // Deleted concurrently.
+    }
+    const std::string key = child.substr(0, kSharedCacheKeyLength);
+    Cache& cache = caches[key];
+    cache.files.push_back(path);
+    cache.bytes += stat.length;
+    cache.last_use_nsec = std::max(cache.last_use_nsec, stat.mtime_nsec);
+    cache.complete |= child == MetaFilename(key);
+    cache.locked |= absl::EndsWith(child, kLockFileSuffix);
+  }
+  uint64 total_bytes = 0;
+  std::vector<const Cache*> evictable;
+  for (const auto& [key, cache] : caches) {
+    if (!cache.complete) {
+      continue;
+    }
+    total_bytes += cache.bytes;
+    if (!cache.locked && io::JoinPath(dir, key) != filename) {
+      evictable.push_back(&cache);
+    }
+  }
+  std::sort(evictable.begin(), evictable.end(),
+            [](const Cache* a, const Cache* b) {
+              return a->last_use_nsec < b->last_use_nsec;
+            });
+  for (const Cache* cache : evictable) {
+    if (total_bytes <= static_cast<uint64>(max_bytes)) {
+      break;
+    }
+    for (const std::string& file : cache->files) {
+      TF_RETURN_IF_ERROR(env->DeleteFile(file));
+    }
+    total_bytes -= cache->bytes;
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 class DatasetRandomAccessCache {
@@ -168,10 +289,11 @@ class IteratorRandomAccessCache {
 class CacheDatasetOp::FileDatasetBase : public DatasetBase {
  public:
   FileDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
-                  string filename, Env* env)
+                  string filename, Env* env, bool shared = false)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         filename_(std::move(filename)),
+        shared_(shared),
         env_(env),
         num_tensors_(input->output_dtypes().size()),
         tensor_index_padding_size_(StringPaddingSize(num_tensors_)),
@@ -223,6 +345,15 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
  protected:
   const DatasetBase* const input_;
   const tstring filename_;
+  // Whether the cache is in the host-wide shared cache directory, and may be
+  // written and read by other jobs. Then, instead of failing, an iterator
+  // passes through its input while another job writes the cache.
+  const bool shared_;
+
+  // A shared cache is serialized as an in-memory cache, as it was created.
+  tstring SerializedFilename() const {
+    return shared_ ? tstring("") : filename_;
+  }
 
  private:
   static size_t StringPaddingSize(size_t num_tensors) {
@@ -242,6 +373,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
               ->FileExists(MetaFilename(params.dataset->filename_))
               .ok()) {
         mode_ = Mode::read;
+        if (params.dataset->shared_) {
+          TouchSharedCache(params.dataset->env_, params.dataset->filename_);
+        }
       } else {
         mode_ = Mode::write;
       }
@@ -328,6 +462,11 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
             iteration_completed_(false) {}
 
       ~FileWriterIterator() override {
+        mutex_lock l(mu_);
+        if (dataset()->shared_ && !wrote_cache_) {
+          // The cache files, if any, belong to another job.
+          return;
+        }
         if (!dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
           LOG(WARNING) << kIncompleteCacheErrorMessage;
           std::vector<string> cache_files;
@@ -361,6 +500,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           return absl::OkStatus();
         }
+        if (pass_through_) {
+          return input_impl_->GetNext(ctx, out_tensors, end_of_sequence);
+        }
         TF_RETURN_IF_ERROR(writer_->status());
         if (cur_index_ >= kMaxItems) {
           // As a courtesy, close the [truncated] cache file.
@@ -417,6 +559,10 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
               writer->WriteScalar(prefix(), kIterationCompleted, ""));
           return absl::OkStatus();
         }
+        if (pass_through_) {
+          TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kPassThrough, ""));
+          return SaveInput(ctx, writer, input_impl_);
+        }
 
         // lockfile is created on the first call to GetNextInternal. The
         // absence of a lockfile means that GetNextInternal was not called
@@ -462,6 +608,10 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         }
 
         TF_RETURN_IF_ERROR(RestoreInput(ctx, reader, input_impl_));
+        if (reader->Contains(prefix(), kPassThrough)) {
+          pass_through_ = true;
+          return absl::OkStatus();
+        }
 
         // TODO(b/78048575): Update this when saving size_t tensors directly
         // is supported.
@@ -485,13 +635,24 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
           *end_of_sequence = true;
           return absl::OkStatus();
         }
-        if (lockfile_created_) {
+        if (lockfile_created_ || pass_through_) {
           return absl::OkStatus();
         }
 
         // Perform rudimentary locking to help catch concurrent writes to the
         // same cache files.
 
+        // 0. A shared cache is written by whichever job gets to it first.
+        if (dataset()->shared_ &&
+            (dataset()->env_->FileExists(MetaFilename(filename_)).ok() ||
+             dataset()->env_->FileExists(lockfile_).ok())) {
+          LOG(INFO) << "Shared cache " << dataset()->filename_
+                    << " is being written by another job. Reading the input "
+                    << "without caching it.";
+          pass_through_ = true;
+          return absl::OkStatus();
+        }
+
         // 1. Check that a checkpoint for the shard has not already been
         // written.
         if (dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
@@ -538,6 +699,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         // BundleWriter in another Session.
         writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
         lockfile_created_ = true;
+        wrote_cache_ = true;
         return absl::OkStatus();
       }
 
@@ -567,6 +729,13 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
           TF_RETURN_IF_ERROR(dataset()->env_->DeleteFile(
               strings::StrCat(dataset()->filename_, "_", i, kLockFileSuffix)));
         }
+        if (dataset()->shared_) {
+          TouchSharedCache(dataset()->env_, dataset()->filename_);
+          Status s = EvictSharedCaches(dataset()->env_, dataset()->filename_);
+          if (!s.ok()) {
+            LOG(WARNING) << "Failed to evict shared caches: " << s;
+          }
+        }
         return absl::OkStatus();
       }
 
@@ -583,6 +752,12 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       string lockfile_ TF_GUARDED_BY(mu_);
       bool lockfile_created_ TF_GUARDED_BY(mu_);
       bool iteration_completed_ TF_GUARDED_BY(mu_);
+      // Whether this iterator has written any cache files. Unlike
+      // `lockfile_created_`, it is not reset when a new shard is started.
+      bool wrote_cache_ TF_GUARDED_BY(mu_) = false;
+      // Whether another job is writing the shared cache, so that this
+      // iterator only passes through its input.
+      bool pass_through_ TF_GUARDED_BY(mu_) = false;
     };  // FileWriterIterator
 
     class FileReaderIterator : public DatasetIterator<FileDatasetBase> {
@@ -724,7 +899,7 @@ class CacheDatasetOp::FileDataset : public CacheDatasetOp::FileDatasetBase {
     Node* input_graph = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph));
     Node* filename = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(filename_, &filename));
+    TF_RETURN_IF_ERROR(b->AddScalar(SerializedFilename(), &filename));
     TF_RETURN_IF_ERROR(b->AddDataset(this, {input_graph, filename}, output));
     return absl::OkStatus();
   }
@@ -734,8 +909,8 @@ class CacheDatasetOp::FileDatasetV2 : public CacheDatasetOp::FileDatasetBase {
  public:
   explicit FileDatasetV2(OpKernelContext* ctx, const DatasetBase* input,
                          string filename, Env* env,
-                         const Tensor& resource_handle)
-      : FileDatasetBase(ctx, input, filename, env),
+                         const Tensor& resource_handle, bool shared = false)
+      : FileDatasetBase(ctx, input, filename, env, shared),
         resource_handle_(resource_handle) {}
 
  protected:
@@ -745,7 +920,7 @@ class CacheDatasetOp::FileDatasetV2 : public CacheDatasetOp::FileDatasetBase {
     Node* input_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_node));
     Node* filename_node = nullptr;
-    TF_RETURN_IF_ERROR(b->AddScalar(filename_, &filename_node));
+    TF_RETURN_IF_ERROR(b->AddScalar(SerializedFilename(), &filename_node));
     Node* resource_handle_node = nullptr;
     TF_RETURN_IF_ERROR(b->AddTensor(resource_handle_, &resource_handle_node));
     TF_RETURN_IF_ERROR(b->AddDataset(
@@ -1183,6 +1358,22 @@ void CacheDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
   tstring filename;
   OP_REQUIRES_OK(ctx, ParseScalarArgument<tstring>(ctx, kFileName, &filename));
   if (filename.empty()) {
+    absl::StatusOr<std::string> shared_filename =
+        SharedCacheFilename(ctx, input);
+    if (!shared_filename.ok()) {
+      LOG(WARNING) << "Failed to share the cache of " << input->DebugString()
+                   << ", caching it in memory instead: "
+                   << shared_filename.status();
+    } else if (!shared_filename->empty()) {
+      if (op_version_ == 2) {
+        *output = new FileDatasetV2(ctx, input, *shared_filename, ctx->env(),
+                                    ctx->input(2), /*shared=*/true);
+      } else {
+        *output = new FileDataset(ctx, input, *shared_filename, ctx->env(),
+                                  /*shared=*/true);
+      }
+      return;
+    }
     static std::atomic<int64_t> resource_id_counter(0);
     const string& container = ctx->resource_manager()->default_container();
     auto name = strings::StrCat(ctx->op_kernel().name(), "/", kMemoryCache, "_",
@@ -12,6 +12,9 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <array>
+#include <cstring>
+
 #include "tensorflow/core/framework/common_shape_fns.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op.h"
@@ -184,7 +187,13 @@ class CSVDatasetOp : public DatasetOpKernel {
           op_version_(op_version),
           use_compression_(!compression_type.empty()),
           compression_type_(std::move(compression_type)),
-          options_(options) {}
+          options_(options) {
+      unquoted_field_stops_.fill(false);
+      unquoted_field_stops_[static_cast<unsigned char>(delim_)] = true;
+      unquoted_field_stops_['\n'] = true;
+      unquoted_field_stops_['\r'] = true;
+      if (use_quote_delim_) unquoted_field_stops_['"'] = true;
+    }
 
     std::unique_ptr<IteratorBase> MakeIteratorInternal(
         const string& prefix) const override {
@@ -508,7 +517,7 @@ class CSVDatasetOp : public DatasetOpKernel {
         pos_++;  // Starting quotation mark
 
         Status parse_result;
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter finds a quote, filling buffer if necessary
           if (pos_ >= buffer_.size()) {
             Status s = SaveAndFillBuffer(&earlier_pieces, &start, include);
             if (errors::IsOutOfRange(s)) {
@@ -520,8 +529,15 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
-          char ch = buffer_[pos_];
-          if (ch == '"') {
+          // Only a quote can end a quoted field, so skip to the next one with
+          // memchr rather than testing the characters one by one.
+          const char* data = static_cast<const tstring&>(buffer_).data();
+          const char* quote = static_cast<const char*>(
+              memchr(data + pos_, '"', buffer_.size() - pos_));
+          if (quote == nullptr) {
+            pos_ = buffer_.size();
+          } else {
+            pos_ = quote - data;
             // When we encounter a quote, we look ahead to the next character to
             // decide what to do
             pos_++;
@@ -560,9 +576,6 @@ class CSVDatasetOp : public DatasetOpKernel {
               parse_result.Update(errors::InvalidArgument(
                   "Quote inside a string has to be escaped by another quote"));
             }
-
-          } else {
-            pos_++;
           }
         }
       }
@@ -641,7 +654,7 @@ class CSVDatasetOp : public DatasetOpKernel {
         size_t start = pos_;
         Status parse_result;
 
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter scans to a stop, filling buffer if needed
           if (pos_ >= buffer_.size()) {
             Status s = SaveAndFillBuffer(&earlier_pieces, &start, include);
             // Handle errors
@@ -657,6 +670,17 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          // Skip the characters that can't end the field, with a table lookup
+          // per character.
+          const auto& stops = dataset()->unquoted_field_stops_;
+          const char* data = static_cast<const tstring&>(buffer_).data();
+          const size_t size = buffer_.size();
+          while (pos_ < size &&
+                 !stops[static_cast<unsigned char>(data[pos_])]) {
+            pos_++;
+          }
+          if (pos_ >= buffer_.size()) continue;
+
           char ch = buffer_[pos_];
 
           if (ch == dataset()->delim_) {
@@ -682,7 +706,7 @@ class CSVDatasetOp : public DatasetOpKernel {
             parse_result.Update(errors::InvalidArgument(
                 "Unquoted fields cannot have quotes inside"));
           }
-          // Otherwise, go to next character
+          // Otherwise, go past the quote
           pos_++;
         }
       }
@@ -920,6 +944,9 @@ class CSVDatasetOp : public DatasetOpKernel {
     const bool use_compression_;
     const tstring compression_type_;
     const io::ZlibCompressionOptions options_;
+    // The characters at which the scan of an unquoted field stops: the
+    // delimiter, line breaks and (invalid) quotes.
+    std::array<bool, 256> unquoted_field_stops_;
   };  // class Dataset
 
   const int op_version_;
@@ -33,6 +33,7 @@ limitations under the License.
 #include "absl/time/time.h"
 #include "xla/tsl/framework/allocator.h"
 #include "tensorflow/core/data/captured_function.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/service/client/common.h"
@@ -709,9 +710,12 @@ void DataServiceDatasetOp::MakeDataset(OpKernelContext* ctx,
         DisableCompressionAtRuntime(data_transfer_protocol_,
                                     config->deployment_mode());
     OP_REQUIRES_OK(ctx, disable_compression_at_runtime.status());
+    // Compressing elements that do not shrink only costs worker and client
+    // CPU time.
     absl::StatusOr<bool> compression_disabled_at_runtime =
-        CompressionDisabledAtRuntime(dataset_id, address, protocol,
-                                     *disable_compression_at_runtime);
+        CompressionDisabledAtRuntime(
+            dataset_id, address, protocol,
+            *disable_compression_at_runtime || IsIncompressible(output_types_));
     OP_REQUIRES_OK(ctx, compression_disabled_at_runtime.status());
     metrics::RecordTFDataServiceRuntimeCompressionDecision(
         *compression_disabled_at_runtime);
@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/util/batch_util.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/status.h"
@@ -50,6 +51,36 @@ using tsl::strings::StrCat;
 
 constexpr char kInputImplEmpty[] = "input_impl_empty";
 
+// Whether the elements alias the buffers of their input batches instead of
+// being copied out of them. This saves a copy per element, but an element that
+// is retained (e.g. by a downstream shuffle buffer) keeps its whole batch
+// alive, so it is opt-in.
+bool AliasSlices() {
+  static const bool alias_slices = []() {
+    bool alias_slices;
+    Status s = ReadBoolFromEnvVar("TF_DATA_UNBATCH_ALIAS_SLICES",
+                                  /*default_val=*/false, &alias_slices);
+    return s.ok() && alias_slices;
+  }();
+  return alias_slices;
+}
+
+// Appends the `index`-th slice of `parent` to `out_tensors`.
+Status AppendSlice(Allocator* allocator, Tensor* parent,
+                   const TensorShape& element_shape, int64_t index,
+                   std::vector<Tensor>* out_tensors) {
+  if (AliasSlices()) {
+    Tensor slice = parent->SubSlice(index);
+    if (slice.IsAligned()) {
+      out_tensors->push_back(std::move(slice));
+      return absl::OkStatus();
+    }
+  }
+  out_tensors->emplace_back(allocator, parent->dtype(), element_shape);
+  return batch_util::MaybeMoveSliceToElement(parent, &out_tensors->back(),
+                                             index);
+}
+
 class UnbatchDatasetOp : public UnaryDatasetOpKernel {
  public:
   explicit UnbatchDatasetOp(OpKernelConstruction* ctx)
@@ -139,13 +170,11 @@ class UnbatchDatasetOp : public UnaryDatasetOpKernel {
       std::vector<Tensor> input_tensors;
       TF_RETURN_IF_ERROR(input_->Get(ctx, input_index, &input_tensors));
       for (int64_t i = 0; i < input_tensors.size(); ++i) {
-        const DataType& dtype = input_tensors[i].dtype();
         TensorShape shape = input_tensors[i].shape();
         shape.RemoveDim(0);
-
-        out_tensors->emplace_back(ctx->get_allocator({}), dtype, shape);
-        TF_RETURN_IF_ERROR(batch_util::MaybeMoveSliceToElement(
-            &input_tensors[i], &out_tensors->back(), input_offset));
+        TF_RETURN_IF_ERROR(AppendSlice(ctx->get_allocator({}),
+                                       &input_tensors[i], shape, input_offset,
+                                       out_tensors));
       }
       return absl::OkStatus();
     }
@@ -194,10 +223,9 @@ class UnbatchDatasetOp : public UnaryDatasetOpKernel {
             for (int i = 0; i < tensors_.size(); ++i) {
               // TODO(b/201790899): Investigate why using MaybeCopySubSlice
               // may lead to a memory leak.
-              out_tensors->emplace_back(ctx->allocator({}), tensors_[i].dtype(),
-                                        shapes_[i]);
-              TF_RETURN_IF_ERROR(batch_util::MaybeMoveSliceToElement(
-                  &tensors_[i], &out_tensors->back(), current_index_));
+              TF_RETURN_IF_ERROR(AppendSlice(ctx->allocator({}), &tensors_[i],
+                                             shapes_[i], current_index_,
+                                             out_tensors));
             }
             ++current_index_;
             *end_of_sequence = false;
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <functional>
 #include <utility>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/data/metric_utils.h"
 #include "tensorflow/core/data/root_dataset.h"
 #include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/profiler/lib/traceme.h"
 #include "tsl/profiler/lib/traceme_encode.h"
 
@@ -63,6 +66,60 @@ struct HostBufferElement {
 using MultiDeviceIteratorCallback =
     std::function<void(const HostBufferElement&)>;
 
+// Returns an allocator of pinned host memory, if any of `devices` is a GPU and
+// `host_device` can allocate pinned memory, and nullptr otherwise.
+//
+// Elements are copied into pinned memory by the background thread, so that the
+// host-to-device copies that consume them don't have to stage them first.
+Allocator* GetPinnedHostAllocator(DeviceBase* host_device,
+                                  const std::vector<string>& devices) {
+  bool pin_buffers;
+  Status s = ReadBoolFromEnvVar("TF_DATA_PIN_MULTI_DEVICE_ITERATOR_BUFFERS",
+                                /*default_val=*/true, &pin_buffers);
+  if (!s.ok() || !pin_buffers || host_device == nullptr) {
+    return nullptr;
+  }
+  bool has_gpu = false;
+  for (const string& device : devices) {
+    DeviceNameUtils::ParsedName parsed_name;
+    if (DeviceNameUtils::ParseFullName(device, &parsed_name) &&
+        parsed_name.has_type && parsed_name.type == DEVICE_GPU) {
+      has_gpu = true;
+      break;
+    }
+  }
+  if (!has_gpu) {
+    return nullptr;
+  }
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  attr.set_gpu_compatible(true);
+  Allocator* allocator = host_device->GetAllocator(attr);
+  if (allocator == nullptr ||
+      allocator->GetMemoryType() != AllocatorMemoryType::kHostPinned) {
+    return nullptr;
+  }
+  return allocator;
+}
+
+// Copies the components of `element` that are in pageable memory into memory
+// from `allocator`. Components that can't be copied are left as they are.
+void CopyToPinnedMemory(Allocator* allocator, std::vector<Tensor>* element) {
+  for (Tensor& tensor : *element) {
+    if (!DataTypeCanUseMemcpy(tensor.dtype()) || tensor.TotalBytes() == 0 ||
+        tensor.GetMemoryType() != AllocatorMemoryType::kHostPageable) {
+      continue;
+    }
+    Tensor pinned(allocator, tensor.dtype(), tensor.shape());
+    if (!pinned.IsInitialized()) {
+      // Pinned memory is exhausted; the copy to the device stages the tensor.
+      return;
+    }
+    std::memcpy(pinned.data(), tensor.data(), tensor.TotalBytes());
+    tensor = std::move(pinned);
+  }
+}
+
 // MultiDeviceIterator provides the ability for multiple devices to fetch from
 // one iterator in a roundrobin sequence, which is deterministic. This means
 // that, for exmaple, starting from the beginning GetNextFromShard(0) always
@@ -94,7 +151,9 @@ class MultiDeviceIterator : public ResourceBase {
         flib_def_(std::move(flib_def)),
         flr_(flr),
         pflr_(std::move(pflr)),
-        function_handle_cache_(std::move(function_handle_cache)) {
+        function_handle_cache_(std::move(function_handle_cache)),
+        pinned_host_allocator_(
+            flr ? GetPinnedHostAllocator(flr->device(), devices) : nullptr) {
     DCHECK(flr_ != nullptr);
     VLOG(2) << "Creating multi-device iterator.";
   }
@@ -379,6 +438,8 @@ class MultiDeviceIterator : public ResourceBase {
 
         if (elem.status.ok() && elem.end_of_sequence) {
           end_of_iterator = true;
+        } else if (elem.status.ok() && parent_->pinned_host_allocator_) {
+          CopyToPinnedMemory(parent_->pinned_host_allocator_, &elem.value);
         }
 
         std::shared_ptr<HostBuffer::CallbackContainer> callback_container;
@@ -473,6 +534,8 @@ class MultiDeviceIterator : public ResourceBase {
   FunctionLibraryRuntime* const flr_ = nullptr;  // not owned.
   const std::unique_ptr<ProcessFunctionLibraryRuntime> pflr_;
   const std::unique_ptr<FunctionHandleCache> function_handle_cache_;
+  // Not owned. If not null, buffered elements are copied into pinned memory.
+  Allocator* const pinned_host_allocator_;
   ResourceMgr resource_mgr_;
   CancellationManager cancellation_manager_;
 
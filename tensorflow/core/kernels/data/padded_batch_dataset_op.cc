@@ -17,6 +17,7 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -288,6 +289,8 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
                      std::vector<Tensor>* out_tensors) {
       const size_t num_tuple_components = batch_elements[0].size();
       const int64_t num_batch_elements = batch_elements.size();
+      int64_t num_values = 0;
+      int64_t num_element_values = 0;
       for (size_t component_index = 0; component_index < num_tuple_components;
            ++component_index) {
         // 1. Determine the shape of the padded tensor.
@@ -342,6 +345,11 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
                                   output_dtypes()[component_index],
                                   batch_component_shape);
         Tensor& batch_component = out_tensors->back();
+        num_values += batch_component.NumElements();
+        for (int64_t i = 0; i < num_batch_elements; ++i) {
+          num_element_values +=
+              batch_elements[i][component_index].NumElements();
+        }
         TF_RETURN_IF_ERROR(batch_util::SetElementZero(
             &batch_component, dataset()->padding_values_[component_index]));
 
@@ -403,6 +411,8 @@ class PaddedBatchDatasetOp::Dataset : public DatasetBase {
           }
         }
       }
+      metrics::RecordTFDataPaddedBatch(num_values,
+                                       num_values - num_element_values);
       return absl::OkStatus();
     }
 
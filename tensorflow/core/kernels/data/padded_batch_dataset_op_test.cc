@@ -12,6 +12,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/padded_batch_dataset_op.h"
 
 #include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
 
 namespace tensorflow {
 namespace data {
@@ -721,6 +722,22 @@ TEST_F(PaddedBatchDatasetOpTest, ShortPadding) {
       tensorflow::error::DATA_LOSS);
 }
 
+TEST_F(PaddedBatchDatasetOpTest, RecordsPaddingValues) {
+  monitoring::testing::CellReader<int64_t> values(
+      "/tensorflow/data/padded_batch_values");
+  // Three batches of two elements with 2 values, padded to 3 values each.
+  auto dataset_params = PaddedBatchDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  while (!end_of_sequence) {
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+  }
+  EXPECT_EQ(values.Delta("data"), 12);
+  EXPECT_EQ(values.Delta("padding"), 6);
+}
+
 TEST_F(PaddedBatchDatasetOpTest, InvalidPaddedShapes) {
   auto dataset_params = PaddedBatchDatasetParamsWithInvalidPaddingShape();
   TF_ASSERT_OK(Initialize(dataset_params));
@@ -120,6 +120,13 @@ constexpr int kDefaultCyclePrefetchFactor = 2;
 // match the behavior of the original implementation.
 constexpr double kDefaultPerIteratorPrefetchFactor = 2.0L;
 
+// When `buffer_output_elements` is autotuned, the results buffer of an input
+// element that the consumer had to wait on is doubled, up to
+// `kMaxPerIteratorPrefetchFactor` times the default size. This lets slow
+// inputs (e.g. larger files) buffer further ahead than fast ones, reducing
+// head-of-line blocking when input element sizes are skewed.
+constexpr int64_t kMaxPerIteratorPrefetchFactor = 4;
+
 // Period between reporting dataset statistics.
 constexpr int kStatsReportingPeriodMillis = 1000;
 
@@ -211,6 +218,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         block_length_(block_length),
         buffer_output_elements_(
             ComputeBufferOutputElements(buffer_output_elements, block_length)),
+        max_buffer_output_elements_(
+            buffer_output_elements == model::kAutotune
+                ? kMaxPerIteratorPrefetchFactor * buffer_output_elements_
+                : buffer_output_elements_),
         prefetch_input_elements_(ComputePrefetchInputElements(
             prefetch_input_elements, cycle_length_)),
         num_parallel_calls_(num_parallel_calls),
@@ -485,9 +496,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
                                           deterministic_ ? 1.0 : 0.0),
            model::MakeNonTunableParameter(
                kMaxBufferedElements,
-               ComputeMaxBufferedElements(dataset()->prefetch_input_elements_,
-                                          dataset()->buffer_output_elements_,
-                                          dataset()->cycle_length_))});
+               ComputeMaxBufferedElements(
+                   dataset()->prefetch_input_elements_,
+                   dataset()->max_buffer_output_elements_,
+                   dataset()->cycle_length_))});
     }
 
     Status SaveInternal(SerializationContext* ctx,
@@ -656,6 +668,11 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       // Buffer for storing the outputs of `iterator`.
       std::deque<std::shared_ptr<Result>> TF_GUARDED_BY(
           &ParallelInterleaveIterator::mu_) results;
+      // The number of results to buffer for the element.
+      int64_t buffer_size TF_GUARDED_BY(&ParallelInterleaveIterator::mu_) = 0;
+      // Whether the consumer waited on the element since it last consumed a
+      // result from it.
+      bool waited_on TF_GUARDED_BY(&ParallelInterleaveIterator::mu_) = false;
       // The element's index in the cycle, if it is in the current cycle.
       // -1 if the element is not in the current cycle.
       int64_t cycle_index TF_GUARDED_BY(&ParallelInterleaveIterator::mu_) = -1;
@@ -676,9 +693,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           TF_EXCLUSIVE_LOCKS_REQUIRED(&ParallelInterleaveIterator::mu_) {
         return absl::StrFormat(
             "Element(id: %d, iterator_null: %d, results_size: %d, "
-            "cycle_index: %d, active: %d, initialized: %d, no_input: %d)",
-            id, iterator == nullptr, results.size(), cycle_index, active,
-            initialized, no_input);
+            "buffer_size: %d, cycle_index: %d, active: %d, initialized: %d, "
+            "no_input: %d)",
+            id, iterator == nullptr, results.size(), buffer_size, cycle_index,
+            active, initialized, no_input);
       }
     };
 
@@ -801,6 +819,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           // We found a result.
           std::swap(*result, element->results.front());
           element->results.pop_front();
+          element->waited_on = false;
           if (!element->active) {
             elements_to_process_.push_back(cycle_index_);
             current_workers_cond_var_.notify_one();
@@ -810,6 +829,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         }
         if (!element->initialized || element->iterator) {
           // The element is still producing results, so we wait.
+          if (deterministic_ && element->initialized && !element->waited_on) {
+            // Results are returned in order, so the element is blocking the
+            // whole cycle. Let it buffer further ahead from now on.
+            element->waited_on = true;
+            element->buffer_size =
+                std::min(2 * element->buffer_size,
+                         dataset()->max_buffer_output_elements_);
+          }
           return false;
         }
         // We've consumed all results from the element. Get a new element from
@@ -860,6 +887,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       }
       auto element = std::make_shared<Element>();
       element->id = element_id_counter_++;
+      element->buffer_size = dataset()->buffer_output_elements_;
       InitializeInput(ctx, *element);
       return element;
     }
@@ -1109,7 +1137,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         mutex_lock l(*mu_);
         element->results.push_back(std::move(result));
         NotifyElementUpdate(*element);
-        if (element->results.size() == dataset()->buffer_output_elements_) {
+        if (element->results.size() >= element->buffer_size) {
           break;
         }
       }
@@ -1203,7 +1231,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         return true;
       }
       return element->iterator &&
-             element->results.size() < dataset()->buffer_output_elements_;
+             element->results.size() < element->buffer_size;
     }
 
     inline void IncrementCurrentWorkers() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -1416,6 +1444,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       auto element = std::make_shared<Element>();
       {
         mutex_lock l(*mu_);
+        element->buffer_size = dataset()->buffer_output_elements_;
         int64_t results_size;
         TF_RETURN_IF_ERROR(reader->ReadScalar(
             key_prefix, absl::StrCat(kResultsSuffix, kSizeSuffix),
@@ -1744,6 +1773,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
   const int64_t cycle_length_;
   const int64_t block_length_;
   const int64_t buffer_output_elements_;
+  // The size up to which the results buffers of input elements may grow.
+  const int64_t max_buffer_output_elements_;
   const int64_t prefetch_input_elements_;
   const int64_t num_parallel_calls_;
   const DeterminismPolicy deterministic_;
@@ -42,8 +42,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringprintf.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
@@ -92,6 +95,18 @@ constexpr int kStatsReportingPeriodMillis = 1000;
 // large values for the parallelism, e.g. creating 300k threads.
 constexpr int kUnboundedThreadpoolAutotuningFactor = 10;
 
+// Returns the NUMA node of the calling thread: the node it is pinned to, if
+// any, and otherwise the node holding its stack, which the kernel allocates
+// on the node the thread runs on.
+int CurrentNUMANode() {
+  const int node = port::NUMAGetThreadNodeAffinity();
+  if (node != port::kNUMANoAffinity) {
+    return node;
+  }
+  const char stack_byte = 0;
+  return port::NUMAGetMemAffinity(&stack_byte);
+}
+
 }  // namespace
 
 class ParallelMapDatasetOp::Dataset : public DatasetBase {
@@ -294,6 +309,8 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
         unbounded_thread_pool_ = std::make_unique<UnboundedThreadPool>(
             ctx->env(), "tf_data_map_unbounded_thread_pool");
       }
+      numa_affinity_ = !use_unbounded_threadpool_ && ctx->options() &&
+                       ctx->options()->threading_options().numa_affinity();
       if (num_parallel_calls_->value == model::kAutotune) {
         num_parallel_calls_->value = GetAutotuneDefaultParallelism(ctx);
       }
@@ -481,6 +498,8 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       result.push_back(
           std::make_pair("use_unbounded_threadpool",
                          use_unbounded_threadpool_ ? "true" : "false"));
+      result.push_back(
+          std::make_pair("numa_affinity", numa_affinity_ ? "true" : "false"));
       result.push_back(std::make_pair(
           "parallelism",
           parallelism == -1
@@ -520,6 +539,19 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     void EnsureThreadsStarted(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
       if (!runner_thread_) {
+        if (numa_affinity_) {
+          // Unless warm-starting, the first call comes from the consuming
+          // thread. The functions and the runner thread are pinned to its
+          // NUMA node, so that the input and output elements are allocated
+          // (first touched) on that node.
+          ThreadOptions thread_options;
+          thread_options.numa_node = CurrentNUMANode();
+          numa_thread_pool_ = std::make_unique<thread::ThreadPool>(
+              ctx->env(), thread_options, "tf_data_map_numa_thread_pool",
+              port::MaxParallelism(thread_options.numa_node),
+              /*low_latency_hint=*/false);
+          numa_node_ = thread_options.numa_node;
+        }
         auto ctx_copy = std::make_shared<IteratorContext>(*ctx);
         runner_thread_ = ctx->StartThread(
             "tf_data_parallel_map",
@@ -578,11 +610,12 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
             model_node());
       } else if (dataset()->captured_func_->use_inter_op_parallelism()) {
         instantiated_captured_func_->RunAsync(
-            ctx.get(), std::move(input_element), &result->return_values,
-            std::move(done), model_node());
+            Runner(ctx.get()), ctx->cancellation_manager(),
+            ctx->collective_executor(), std::move(input_element),
+            &result->return_values, std::move(done), model_node());
       } else {
         // In this case, the function will be executed using single-threaded
-        // executor. We schedule it using `ctx->runner()` to enable concurrent
+        // executor. We schedule it using `Runner()` to enable concurrent
         // application of the function over different input elements.
         auto fn = std::bind(
             [this, ctx, result](std::vector<Tensor> input_element) {
@@ -591,7 +624,7 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
                   model_node());
             },
             std::move(input_element));
-        (*ctx->runner())(
+        Runner(ctx.get())(
             [this, ctx, fn = std::move(fn), done = std::move(done)]() {
               Status s;
               // Check whether we are already recording to prevent invalid
@@ -608,6 +641,17 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
       }
     }
 
+    // Returns the runner to apply the function with: the NUMA-local thread
+    // pool if there is one, and otherwise `ctx->runner()`.
+    std::function<void(std::function<void()>)> Runner(IteratorContext* ctx) {
+      if (numa_thread_pool_) {
+        return [pool = numa_thread_pool_.get()](std::function<void()> fn) {
+          pool->Schedule(std::move(fn));
+        };
+      }
+      return *ctx->runner();
+    }
+
     Status ProcessResult(IteratorContext* ctx,
                          const std::shared_ptr<InvocationResult>& result,
                          std::vector<Tensor>* out_tensors,
@@ -640,6 +684,10 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
 
     void RunnerThread(const std::shared_ptr<IteratorContext>& ctx)
         TF_LOCKS_EXCLUDED(*mu_) {
+      if (numa_node_ != port::kNUMANoAffinity) {
+        // Input elements are produced on this thread.
+        port::NUMASetThreadNodeAffinity(numa_node_);
+      }
       RecordStart(ctx.get());
       auto cleanup = gtl::MakeCleanup([this, ctx] { RecordStop(ctx.get()); });
       std::vector<std::shared_ptr<InvocationResult>> new_calls;
@@ -802,6 +850,12 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     std::unique_ptr<Thread> runner_thread_ TF_GUARDED_BY(*mu_);
     std::unique_ptr<Thread> stats_thread_ TF_GUARDED_BY(*mu_);
     std::unique_ptr<UnboundedThreadPool> unbounded_thread_pool_;
+    // Whether to run the function on threads pinned to the NUMA node of the
+    // consumer, from the `numa_affinity` threading option.
+    bool numa_affinity_ = false;
+    // Set before the runner thread starts, and then not modified.
+    std::unique_ptr<thread::ThreadPool> numa_thread_pool_;
+    int numa_node_ = port::kNUMANoAffinity;
 
     // Method for deregistering the cancellation callback.
     std::function<void()> deregister_fn_;
@@ -451,6 +451,24 @@ ITERATOR_SAVE_AND_RESTORE_TEST_P(ParallelMapDatasetOpTest,
                                  ParallelMapDatasetParams,
                                  IteratorSaveAndRestoreTestCases())
 
+TEST_F(ParallelMapDatasetOpTest, NUMAAffinity) {
+  auto dataset_params = ParallelMapDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  Options options;
+  options.mutable_threading_options()->set_numa_affinity(true);
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.options = &options;
+  IteratorContext iterator_ctx(std::move(params));
+  std::unique_ptr<IteratorBase> iterator;
+  TF_ASSERT_OK(dataset_->MakeIterator(&iterator_ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator));
+  TF_EXPECT_OK(CheckIteratorGetNext(
+      iterator.get(), &iterator_ctx,
+      CreateTensors<int64_t>(TensorShape{}, {{0}, {12}, {24}, {36}}),
+      /*compare_order=*/true));
+}
+
 TEST_F(ParallelMapDatasetOpTest, InvalidNumParallelCalls) {
   auto dataset_params = ParallelMapDatasetParamsWithInvalidNumParallelCalls();
   EXPECT_EQ(Initialize(dataset_params).code(),
@@ -19,6 +19,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -69,6 +70,32 @@ Status ConvertOutputTypes(const tensorflow::DataTypeVector& output_dtypes,
   return absl::OkStatus();
 }
 
+// Like `ConvertOutputTypes()`, for a block of values.
+Status ConvertOutputTypes(const tensorflow::DataTypeVector& output_dtypes,
+                          Allocator* allocator,
+                          const std::vector<int64_t>& values,
+                          std::vector<Tensor>* out_tensors) {
+  Tensor block(allocator, output_dtypes[0],
+               TensorShape({static_cast<int64_t>(values.size())}));
+  switch (output_dtypes[0]) {
+#define HANDLE_TYPE(type)                             \
+  case DataTypeToEnum<type>::value: {                 \
+    auto flat = block.flat<type>();                   \
+    for (size_t i = 0; i < values.size(); ++i) {      \
+      flat(i) = static_cast<type>(values[i]);         \
+    }                                                 \
+    break;                                            \
+  }
+    TF_CALL_NUMBER_TYPES(HANDLE_TYPE);
+#undef HANDLE_TYPE
+    default:
+      return errors::InvalidArgument("Unsupported data type: ",
+                                     DataTypeString(output_dtypes[0]));
+  }
+  out_tensors->push_back(std::move(block));
+  return absl::OkStatus();
+}
+
 int64_t sgn(int64_t val) { return (0 < val) - (val < 0); }
 
 int64_t RangeCardinality(int64_t start, int64_t stop, int64_t step) {
@@ -312,6 +339,43 @@ class RangeDatasetOp::Dataset : public DatasetBase {
       return ConvertOutputTypes(output_dtypes(), out_tensors, value);
     }
 
+    bool SupportsBlocks() const override { return true; }
+
+    Status GetNextBlockInternal(IteratorContext* ctx, int64_t max_elements,
+                                std::vector<Tensor>* out_tensors,
+                                int64_t* num_elements,
+                                bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return errors::FailedPrecondition(
+            "Blocks of elements are not supported with global shuffling.");
+      }
+      std::vector<int64_t> values;
+      values.reserve(max_elements);
+      bool end_of_range = false;
+      while (static_cast<int64_t>(values.size()) < max_elements) {
+        int64_t value;
+        if (split_provider_ != nullptr) {
+          Tensor split;
+          TF_RETURN_IF_ERROR(split_provider_->GetNext(&split, &end_of_range));
+          value = end_of_range ? 0 : split.scalar<int64_t>()();
+        } else {
+          value = counter_->GetNext(&end_of_range);
+        }
+        if (end_of_range) {
+          break;
+        }
+        values.push_back(value);
+      }
+      if (values.empty()) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+      *num_elements = values.size();
+      *end_of_sequence = false;
+      return ConvertOutputTypes(output_dtypes(), ctx->allocator({}), values,
+                                out_tensors);
+    }
+
    protected:
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
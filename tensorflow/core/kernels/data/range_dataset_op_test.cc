@@ -192,6 +192,39 @@ TEST_F(RangeDatasetOpTest, SplitProviderEmpty) {
       CreateTensors<int64_t>(TensorShape({}), {})));
 }
 
+TEST_F(RangeDatasetOpTest, GetNextBlock) {
+  auto params = RangeDatasetParams(/*start=*/10, /*stop=*/0, /*step=*/-2,
+                                   /*output_dtypes=*/{DT_INT32});
+  TF_ASSERT_OK(Initialize(params));
+  ASSERT_TRUE(iterator_->SupportsBlocks());
+  std::vector<Tensor> block;
+  int64_t num_elements;
+  bool end_of_sequence;
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_FALSE(end_of_sequence);
+  EXPECT_EQ(num_elements, 3);
+  ASSERT_EQ(block.size(), 1);
+  TF_EXPECT_OK(ExpectEqual(block[0], CreateTensor<int32>(TensorShape({3}),
+                                                         {10, 8, 6})));
+
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_FALSE(end_of_sequence);
+  EXPECT_EQ(num_elements, 2);
+  ASSERT_EQ(block.size(), 1);
+  TF_EXPECT_OK(
+      ExpectEqual(block[0], CreateTensor<int32>(TensorShape({2}), {4, 2})));
+
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+  EXPECT_TRUE(block.empty());
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
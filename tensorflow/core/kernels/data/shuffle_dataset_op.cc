@@ -25,13 +25,16 @@ limitations under the License.
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/data/random_seed_ops.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/random/philox_random.h"
@@ -202,6 +205,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     bool SymbolicCheckpointCompatible() const override { return true; }
 
     Status Initialize(IteratorContext* ctx) override {
+      compress_buffer_ =
+          ctx->options() && ctx->options()->compress_shuffle_buffer();
       mutex_lock l(mu_);
       seed_generator_->GenerateSeeds(&seed_, &seed2_);
       ResetRngs();
@@ -217,38 +222,55 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     Status GetNextInternal(IteratorContext* ctx,
                            std::vector<Tensor>* out_tensors,
                            bool* end_of_sequence) override {
-      mutex_lock l(mu_);
-      TF_RETURN_IF_ERROR(FillBuffer(ctx));
-      if (num_elements_ == 0) {
-        DCHECK(input_impl_ == nullptr);
-        *end_of_sequence = true;
-        return absl::OkStatus();
-      }
+      {
+        mutex_lock l(mu_);
+        TF_RETURN_IF_ERROR(FillBuffer(ctx));
+        if (num_elements_ == 0) {
+          DCHECK(input_impl_ == nullptr);
+          *end_of_sequence = true;
+          return absl::OkStatus();
+        }
 
-      *end_of_sequence = false;
-      ClearEmptySlices();
-      DCHECK(!slices_.empty());
-      // Choose an element to produce uniformly at random from the first
-      // slice, and then remove the element from the slice.
-      int64_t offset =
-          Random() % (slices_.front()->end - slices_.front()->start);
-      int64_t index = (slices_.front()->start + offset) % buffer_->size();
-      *out_tensors = std::move(buffer_->at(index));
-      this->RecordBufferDequeue(ctx, *out_tensors);
-      std::swap(buffer_->at(index),
-                buffer_->at(slices_.front()->start % buffer_->size()));
-      checkpoint_indices_.insert(index);
-      checkpoint_indices_.insert(slices_.front()->start % buffer_->size());
-      slices_.front()->start++;
-      num_elements_--;
+        *end_of_sequence = false;
+        ClearEmptySlices();
+        DCHECK(!slices_.empty());
+        // Choose an element to produce uniformly at random from the first
+        // slice, and then remove the element from the slice.
+        int64_t offset =
+            Random() % (slices_.front()->end - slices_.front()->start);
+        int64_t index = (slices_.front()->start + offset) % buffer_->size();
+        *out_tensors = std::move(buffer_->at(index));
+        this->RecordBufferDequeue(ctx, *out_tensors);
+        std::swap(buffer_->at(index),
+                  buffer_->at(slices_.front()->start % buffer_->size()));
+        checkpoint_indices_.insert(index);
+        checkpoint_indices_.insert(slices_.front()->start % buffer_->size());
+        slices_.front()->start++;
+        num_elements_--;
+      }
+      // Elements are uncompressed outside of `mu_`, so that concurrent calls
+      // don't wait for each other.
+      if (compress_buffer_) {
+        TF_RETURN_IF_ERROR(UncompressBufferedElement(out_tensors));
+      }
       return absl::OkStatus();
     }
 
    protected:
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
-      return model::MakeKnownRatioNode(std::move(args),
-                                       /*ratio=*/1);
+      if (dataset()->buffer_size_ == kUnknownCardinality) {
+        return model::MakeKnownRatioNode(std::move(args),
+                                         /*ratio=*/1);
+      }
+      // The buffer size is not tuned, but it lets the model charge the
+      // shuffle buffer against the RAM budget.
+      return model::MakeKnownRatioNode(
+          std::move(args),
+          /*ratio=*/1,
+          {model::MakeNonTunableParameter(
+              model::kBufferSize,
+              static_cast<double>(dataset()->buffer_size_))});
     }
 
     void ResetRngs() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -463,7 +485,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           slices_.back()->reached_end_of_sequence = true;
         }
         if (!end_of_input_sequence) {
-          AddToShuffleBuffer(ctx, std::move(input_element));
+          TF_RETURN_IF_ERROR(AddToShuffleBuffer(ctx, std::move(input_element)));
           continue;
         }
         input_impl_.reset();
@@ -520,13 +542,17 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return absl::OkStatus();
     }
 
-    void AddToShuffleBuffer(IteratorContext* ctx, std::vector<Tensor>&& element)
+    Status AddToShuffleBuffer(IteratorContext* ctx,
+                              std::vector<Tensor>&& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       data_produced_ = true;
       if (num_elements_ == 0) {
         VLOG(1) << "Starting to fill up shuffle buffer of size: "
                 << BufferSizeString();
       }
+      if (compress_buffer_) {
+        TF_RETURN_IF_ERROR(CompressBufferedElement(&element));
+      }
       this->RecordBufferEnqueue(ctx, element);
       if (num_elements_ == buffer_->size()) {
         DCHECK(IsShuffleAll());
@@ -539,6 +565,35 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       }
       num_elements_++;
       slices_.back()->end++;
+      return absl::OkStatus();
+    }
+
+    // Replaces `element` with a scalar variant tensor holding its compressed
+    // components.
+    static Status CompressBufferedElement(std::vector<Tensor>* element) {
+      CompressedElement compressed;
+      TF_RETURN_IF_ERROR(CompressElement(*element, &compressed));
+      Tensor tensor(DT_VARIANT, TensorShape({}));
+      tensor.scalar<Variant>()() = std::move(compressed);
+      element->clear();
+      element->push_back(std::move(tensor));
+      return absl::OkStatus();
+    }
+
+    // Inverse of `CompressBufferedElement`.
+    static Status UncompressBufferedElement(std::vector<Tensor>* element) {
+      const CompressedElement* compressed =
+          element->size() == 1 && element->front().dtype() == DT_VARIANT
+              ? element->front().scalar<Variant>()().get<CompressedElement>()
+              : nullptr;
+      if (compressed == nullptr) {
+        return errors::Internal(
+            "Expected a compressed element in the shuffle buffer.");
+      }
+      std::vector<Tensor> components;
+      TF_RETURN_IF_ERROR(UncompressElement(*compressed, &components));
+      *element = std::move(components);
+      return absl::OkStatus();
     }
 
     void ClearEmptySlices() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -556,6 +611,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return absl::StrCat(dataset()->buffer_size_);
     }
 
+    // Whether the elements in `buffer_` are compressed. Set in `Initialize()`.
+    bool compress_buffer_ = false;
     mutex mu_;
     SeedGenerator* const seed_generator_ TF_GUARDED_BY(mu_);  // Not owned.
     std::unique_ptr<std::vector<std::vector<Tensor>>> buffer_
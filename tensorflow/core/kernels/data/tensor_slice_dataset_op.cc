@@ -14,8 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tensor_slice_dataset_op.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "tensorflow/core/data/dataset_utils.h"
@@ -198,6 +200,65 @@ class TensorSliceDatasetOp::Dataset : public DatasetBase {
       return absl::OkStatus();
     }
 
+    bool SupportsBlocks() const override { return true; }
+
+    Status GetNextBlockInternal(IteratorContext* ctx, int64_t max_elements,
+                                std::vector<Tensor>* out_tensors,
+                                int64_t* num_elements,
+                                bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return errors::FailedPrecondition(
+            "Blocks of elements are not supported with global shuffling.");
+      }
+      // Splits the indices of the block into runs of consecutive indices, each
+      // of which is copied at once.
+      std::vector<std::pair<int64_t, int64_t>> runs;
+      int64_t num_indices = 0;
+      while (num_indices < max_elements) {
+        Tensor split;
+        bool end_of_splits;
+        TF_RETURN_IF_ERROR(split_provider_->GetNext(&split, &end_of_splits));
+        if (end_of_splits) {
+          break;
+        }
+        int64_t index = split.scalar<int64_t>()();
+        if (!runs.empty() && runs.back().first + runs.back().second == index) {
+          ++runs.back().second;
+        } else {
+          runs.emplace_back(index, 1);
+        }
+        ++num_indices;
+      }
+      if (num_indices == 0) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+      out_tensors->reserve(dataset()->tensors_.size());
+      for (const Tensor& component : dataset()->tensors_) {
+        if (runs.size() == 1) {
+          // Like `MaybeCopySubSlice()`, avoids the copy of a single run.
+          Tensor slice = component.Slice(runs[0].first,
+                                         runs[0].first + runs[0].second);
+          out_tensors->push_back(slice.IsAligned() ? slice
+                                                   : tensor::DeepCopy(slice));
+          continue;
+        }
+        TensorShape shape = component.shape();
+        shape.set_dim(0, num_indices);
+        Tensor block(ctx->allocator({}), component.dtype(), shape);
+        int64_t offset = 0;
+        for (const auto& [start, length] : runs) {
+          TF_RETURN_IF_ERROR(batch_util::CopyContiguousSlices(
+              component, start, offset, length, &block));
+          offset += length;
+        }
+        out_tensors->push_back(std::move(block));
+      }
+      *num_elements = num_indices;
+      *end_of_sequence = false;
+      return absl::OkStatus();
+    }
+
    protected:
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
@@ -350,6 +350,51 @@ TEST_F(TensorSliceDatasetOpTest, SplitProviderEmpty) {
       CreateTensors<int64_t>(TensorShape({}), {})));
 }
 
+TEST_F(TensorSliceDatasetOpTest, GetNextBlock) {
+  auto params = TensorSliceDatasetParams(
+      {CreateTensor<int64_t>(TensorShape({5}), {1, 2, 3, 4, 5}),
+       CreateTensor<tstring>(TensorShape({5, 1}), {"a", "b", "c", "d", "e"})},
+      kNodeName);
+  TF_ASSERT_OK(Initialize(params));
+  ASSERT_TRUE(iterator_->SupportsBlocks());
+  std::vector<Tensor> block;
+  int64_t num_elements;
+  bool end_of_sequence;
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_FALSE(end_of_sequence);
+  EXPECT_EQ(num_elements, 3);
+  ASSERT_EQ(block.size(), 2);
+  TF_EXPECT_OK(ExpectEqual(
+      block[0], CreateTensor<int64_t>(TensorShape({3}), {1, 2, 3})));
+  TF_EXPECT_OK(ExpectEqual(
+      block[1], CreateTensor<tstring>(TensorShape({3, 1}), {"a", "b", "c"})));
+
+  // Elements are also available one at a time.
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &element, &end_of_sequence));
+  EXPECT_FALSE(end_of_sequence);
+  TF_EXPECT_OK(
+      ExpectEqual(element[0], CreateTensor<int64_t>(TensorShape({}), {4})));
+
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_FALSE(end_of_sequence);
+  EXPECT_EQ(num_elements, 1);
+  ASSERT_EQ(block.size(), 2);
+  TF_EXPECT_OK(
+      ExpectEqual(block[0], CreateTensor<int64_t>(TensorShape({1}), {5})));
+
+  TF_ASSERT_OK(iterator_->GetNextBlock(iterator_ctx_.get(),
+                                       /*max_elements=*/3, &block,
+                                       &num_elements, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+  EXPECT_TRUE(block.empty());
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -14,11 +14,23 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
+#include <algorithm>
 #include <cstdint>
-
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/global_shuffle_utils.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/readahead_file.h"
+#include "tensorflow/core/data/tfrecord_index.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
@@ -28,6 +40,10 @@ limitations under the License.
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tsl/platform/statusor.h"
 
 namespace tensorflow {
 namespace data {
@@ -50,6 +66,19 @@ constexpr int64_t kUnspecifiedBufferSize = -1;
 constexpr int64_t kDefaultBufferSize = 256LL << 10;  // 256KB
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+// Blocks read ahead from remote files are at most `kMaxReadaheadBlockSize`,
+// so that large buffer sizes are still read with concurrent requests.
+constexpr int64_t kMaxReadaheadBlockSize = 16LL << 20;  // 16MB
+constexpr int64_t kDefaultReadahead = 4;
+constexpr int64_t kMaxReadahead = 16;
+
+// Returns whether `filename` is on a remote filesystem, e.g. GCS or S3, whose
+// reads are bounded by round-trips.
+bool IsRemoteFile(const std::string& filename) {
+  StringPiece scheme, host, path;
+  io::ParseURI(filename, &scheme, &host, &path);
+  return !scheme.empty() && scheme != "file";
+}
 
 bool is_cloud_tpu_gcs_fs() {
 #if (defined(PLATFORM_CLOUD_TPU) && defined(TPU_GCS_FS)) || \
@@ -74,6 +103,9 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
+    use_readahead_ =
+        options_.buffer_size > 0 && !filenames_.empty() &&
+        std::all_of(filenames_.begin(), filenames_.end(), IsRemoteFile);
   }
 
   std::unique_ptr<IteratorBase> MakeIteratorInternal(
@@ -107,6 +139,40 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
   Status CheckExternalState() const override { return absl::OkStatus(); }
 
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    // Counting the records takes reading the index of each file.
+    if (options.compute_level() <
+        CardinalityOptions::CARDINALITY_COMPUTE_MODERATE) {
+      return kUnknownCardinality;
+    }
+    absl::StatusOr<const IndexedTFRecordReader*> reader = GetIndexedReader();
+    return reader.ok() ? (*reader)->num_records() : kUnknownCardinality;
+  }
+
+  Status Get(OpKernelContext* ctx, int64 index,
+             std::vector<Tensor>* out_tensors) const override {
+    return Get(AnyContext(ctx), index, out_tensors);
+  }
+
+  Status Get(AnyContext ctx, int64 index,
+             std::vector<Tensor>* out_tensors) const override {
+    TF_RETURN_IF_ERROR(CheckRandomAccessCompatible(index));
+    TF_ASSIGN_OR_RETURN(const IndexedTFRecordReader* reader,
+                        GetIndexedReader());
+    out_tensors->clear();
+    out_tensors->emplace_back(ctx.allocator, DT_STRING, TensorShape({}));
+    TF_RETURN_IF_ERROR(
+        reader->ReadRecord(index, &out_tensors->back().scalar<tstring>()()));
+    static monitoring::CounterCell* bytes_counter =
+        metrics::GetTFDataBytesReadCounter(kDatasetType);
+    bytes_counter->IncrementBy(out_tensors->back().scalar<tstring>()().size());
+    return absl::OkStatus();
+  }
+
+  absl::Status RandomIndexingCompatible() const override {
+    return GetIndexedReader().status();
+  }
+
  protected:
   Status AsGraphDefInternal(SerializationContext* ctx,
                             DatasetGraphDefBuilder* b,
@@ -128,13 +194,29 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   class Iterator : public DatasetIterator<Dataset> {
    public:
     explicit Iterator(const Params& params)
-        : DatasetIterator<Dataset>(params) {}
+        : DatasetIterator<Dataset>(params),
+          readahead_(std::make_shared<model::SharedState>(
+              model::kAutotune, std::make_shared<mutex>(),
+              std::make_shared<condition_variable>())),
+          global_shuffle_iterator_(dataset()) {}
 
     bool SymbolicCheckpointCompatible() const override { return true; }
 
+    Status Initialize(IteratorContext* ctx) override {
+      mutex_lock l(*readahead_->mu);
+      if (readahead_->value == model::kAutotune) {
+        readahead_->value = kDefaultReadahead;
+      }
+      return absl::OkStatus();
+    }
+
     Status GetNextInternal(IteratorContext* ctx,
                            std::vector<Tensor>* out_tensors,
                            bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return global_shuffle_iterator_.GetNext(ctx, out_tensors,
+                                                end_of_sequence);
+      }
       out_tensors->reserve(1);
       mutex_lock l(mu_);
       do {
@@ -174,7 +256,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           return absl::OkStatus();
         }
 
-        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx));
       } while (true);
     }
 
@@ -215,14 +297,22 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           return absl::OkStatus();
         }
 
-        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx));
       } while (true);
     }
 
    protected:
     std::shared_ptr<model::Node> CreateNode(
         IteratorContext* ctx, model::Node::Args args) const override {
-      return model::MakeSourceNode(std::move(args));
+      if (!dataset()->use_readahead_) {
+        return model::MakeSourceNode(std::move(args));
+      }
+      // The blocks read ahead are modeled as a buffer, filled by as many
+      // concurrent reads.
+      return model::MakeAsyncKnownRatioNode(
+          std::move(args), /*ratio=*/0,
+          {model::MakeParameter(model::kParallelism, readahead_, /*min=*/1,
+                                /*max=*/kMaxReadahead)});
     }
 
     Status SaveInternal(SerializationContext* ctx,
@@ -235,11 +325,15 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         TF_RETURN_IF_ERROR(
             writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
       }
+      TF_RETURN_IF_ERROR(global_shuffle_iterator_.Save(prefix(), ctx, writer));
       return absl::OkStatus();
     }
 
     Status RestoreInternal(IteratorContext* ctx,
                            IteratorStateReader* reader) override {
+      if (ctx->restored_element_count().has_value()) {
+        return global_shuffle_iterator_.Restore(prefix(), ctx, reader);
+      }
       mutex_lock l(mu_);
       ResetStreamsLocked();
       int64_t current_file_index;
@@ -249,7 +343,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       if (reader->Contains(prefix(), kOffset)) {
         int64_t offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kOffset, &offset));
-        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
+        TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx));
         TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
       }
       return absl::OkStatus();
@@ -257,7 +351,8 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
 
    private:
     // Sets up reader streams to read from the file at `current_file_index_`.
-    Status SetupStreamsLocked(Env* env) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Status SetupStreamsLocked(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (current_file_index_ >= dataset()->filenames_.size()) {
         return errors::InvalidArgument(
             "current_file_index_:", current_file_index_,
@@ -265,9 +360,18 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       }
 
       // Actually move on to next file.
-      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
+      TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(
           TranslateFileName(dataset()->filenames_[current_file_index_]),
           &file_));
+      if (dataset()->use_readahead_) {
+        file_ = std::make_unique<ReadaheadFile>(
+            std::move(file_),
+            std::min(dataset()->options_.buffer_size, kMaxReadaheadBlockSize),
+            *ctx->runner(), [readahead = readahead_]() -> int64_t {
+              mutex_lock l(*readahead->mu);
+              return readahead->value;
+            });
+      }
       reader_ = std::make_unique<io::SequentialRecordReader>(
           file_.get(), dataset()->options_);
       if (!dataset()->byte_offsets_.empty()) {
@@ -290,13 +394,66 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+
+    // Number of blocks read ahead of `reader_`, if the dataset reads ahead.
+    const std::shared_ptr<model::SharedState> readahead_;
+    GlobalShuffleIterator global_shuffle_iterator_;
   };
 
+  // Returns a reader of arbitrary records, if every file has an index. The
+  // indexes are only read on the first call, since sequential iteration does
+  // not need them.
+  absl::StatusOr<const IndexedTFRecordReader*> GetIndexedReader() const {
+    mutex_lock l(indexed_reader_mu_);
+    if (!indexed_reader_.has_value()) {
+      indexed_reader_ = OpenIndexedReader();
+    }
+    if (!indexed_reader_->ok()) {
+      return indexed_reader_->status();
+    }
+    return indexed_reader_->value().get();
+  }
+
+  absl::StatusOr<std::unique_ptr<IndexedTFRecordReader>> OpenIndexedReader()
+      const {
+    if (options_.compression_type != io::RecordReaderOptions::NONE ||
+        !byte_offsets_.empty()) {
+      return absl::FailedPreconditionError(
+          "TFRecordDataset only supports random access to uncompressed files "
+          "without `byte_offsets`.");
+    }
+    std::vector<std::string> filenames;
+    filenames.reserve(filenames_.size());
+    for (const string& filename : filenames_) {
+      filenames.push_back(TranslateFileName(filename));
+    }
+    // Random reads would discard most of a read-ahead buffer.
+    io::RecordReaderOptions options = options_;
+    options.buffer_size = 0;
+    absl::StatusOr<std::unique_ptr<IndexedTFRecordReader>> reader =
+        IndexedTFRecordReader::Open(Env::Default(), filenames, options);
+    if (absl::IsNotFound(reader.status())) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "TFRecordDataset only supports random access to files with an "
+          "index, written by `TFRecordIndexBuilder` or `BuildTFRecordIndex`: ",
+          reader.status().message()));
+    }
+    return reader;
+  }
+
   const std::vector<string> filenames_;
   const tstring compression_type_;
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
   const int op_version_;
+  // Whether files are read through a `ReadaheadFile`, which overlaps the
+  // round-trips to remote filesystems.
+  bool use_readahead_;
+
+  mutable mutex indexed_reader_mu_;
+  mutable std::optional<
+      absl::StatusOr<std::unique_ptr<IndexedTFRecordReader>>>
+      indexed_reader_ TF_GUARDED_BY(indexed_reader_mu_);
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
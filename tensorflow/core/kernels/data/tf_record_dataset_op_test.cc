@@ -23,7 +23,9 @@ limitations under the License.
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/tfrecord_index.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset_options.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -352,6 +354,65 @@ TEST_F(TFRecordDatasetOpTest, InvalidByteOffsetsToSeek) {
       absl::StatusCode::kDataLoss);
 }
 
+// Uncompressed files, optionally with an index, for testing random access.
+TFRecordDatasetParams IndexedTFRecordDatasetParams(bool build_index) {
+  const std::string prefix = absl::StrCat(
+      testing::TmpDir(), build_index ? "/tf_record_INDEXED" : "/tf_record_RAW");
+  std::vector<tstring> filenames = {absl::StrCat(prefix, "_1"),
+                                    absl::StrCat(prefix, "_2")};
+  std::vector<std::vector<string>> contents = {{"1", "22", "333"},
+                                               {"a", "bb"}};
+  CompressionType compression_type = CompressionType::UNCOMPRESSED;
+  if (!CreateTestFiles(filenames, contents, compression_type).ok()) {
+    LOG(WARNING) << "Failed to create the test files: "
+                 << absl::StrJoin(filenames, ", ");
+  }
+  for (const tstring& filename : filenames) {
+    if (build_index && !BuildTFRecordIndex(Env::Default(), filename).ok()) {
+      LOG(WARNING) << "Failed to build the index of " << filename;
+    }
+  }
+  return TFRecordDatasetParams(filenames,
+                               /*compression_type=*/compression_type,
+                               /*buffer_size=*/10,
+                               /*byte_offsets=*/{},
+                               /*node_name=*/kNodeName);
+}
+
+TEST_F(TFRecordDatasetOpTest, RandomAccessRequiresIndex) {
+  auto dataset_params = IndexedTFRecordDatasetParams(/*build_index=*/false);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  CardinalityOptions options;
+  options.set_compute_level(CardinalityOptions::CARDINALITY_COMPUTE_MODERATE);
+  EXPECT_EQ(dataset_->Cardinality(options), kUnknownCardinality);
+  EXPECT_EQ(dataset_->RandomIndexingCompatible().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(TFRecordDatasetOpTest, RandomAccessWithIndex) {
+  auto dataset_params = IndexedTFRecordDatasetParams(/*build_index=*/true);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(dataset_->RandomIndexingCompatible());
+  CardinalityOptions options;
+  options.set_compute_level(CardinalityOptions::CARDINALITY_COMPUTE_MODERATE);
+  EXPECT_EQ(dataset_->Cardinality(options), 5);
+  // Reads no index at the default compute level.
+  TF_ASSERT_OK(CheckDatasetCardinality(kUnknownCardinality));
+
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(
+      dataset_->Get(AnyContext(iterator_ctx_.get()), 3, &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors[0],
+                           CreateTensor<tstring>(TensorShape({}), {"a"})));
+  TF_ASSERT_OK(
+      dataset_->Get(AnyContext(iterator_ctx_.get()), 2, &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors[0],
+                           CreateTensor<tstring>(TensorShape({}), {"333"})));
+  EXPECT_EQ(
+      dataset_->Get(AnyContext(iterator_ctx_.get()), 5, &out_tensors).code(),
+      absl::StatusCode::kOutOfRange);
+}
+
 std::vector<IteratorSaveAndRestoreTestCase<TFRecordDatasetParams>>
 IteratorSaveAndRestoreTestCases() {
   return {
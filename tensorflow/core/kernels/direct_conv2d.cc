@@ -0,0 +1,132 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/direct_conv2d.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+// DirectConv2D computes each output pixel as the sum over the filter taps of
+// the input pixel (a vector of 'in_depth' values) times the filter tap (an
+// 'in_depth' x 'out_depth' matrix). For each input value, the row of the filter
+// tap is accumulated into the output pixel in Eigen packets, and the
+// accumulator of 'out_depth' values stays in registers for small 'out_depth'.
+//
+// The contraction based implementation reads the same input values once per
+// filter tap covering them, through image patches of depth
+// 'filter_rows * filter_cols * in_depth'. With few input and output channels,
+// that depth and the number of output channels are too small to amortize the
+// packing of the patches, and the direct loops are faster.
+//
+// Flop cost is the same for both implementations:
+//
+//   filter_rows * filter_cols * in_depth * out_depth * out_rows * out_cols
+
+// Channel counts up to which DirectConv2D is used.
+static constexpr int kMaxInDepth = 4;
+static constexpr int kMaxOutDepth = 64;
+
+bool CanUseDirectConv2D(int stride_rows, int stride_cols, int dilation_rows,
+                        int dilation_cols, int in_depth, int out_depth) {
+  if (dilation_rows != 1 || dilation_cols != 1 || in_depth > kMaxInDepth ||
+      out_depth > kMaxOutDepth) {
+    return false;
+  }
+  // Check if direct convolution is enabled by environment variable.
+  bool use_direct_conv2d = false;
+  TF_CHECK_OK(
+      ReadBoolFromEnvVar("TF_USE_DIRECT_CONV2D", false, &use_direct_conv2d));
+  return use_direct_conv2d;
+}
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+namespace functor {
+
+template <typename T>
+struct DirectConv2D<CPUDevice, T> {
+  void operator()(OpKernelContext* ctx, const Conv2DArgs& args,
+                  int stride_rows, int stride_cols, const T* input,
+                  const T* filter, T* output) {
+    const int64_t in_depth = args.in_depth;
+    const int64_t out_depth = args.out_depth;
+    const int64_t filter_tap_size = in_depth * out_depth;
+
+    // Computes the output rows [start, limit) of the batch * out_rows rows.
+    auto compute_rows = [&](int64_t start, int64_t limit) {
+      using ConstVector =
+          Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>;
+      using Vector = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>;
+      for (int64_t row = start; row < limit; ++row) {
+        const int64_t b = row / args.out_rows;
+        const int64_t out_r = row % args.out_rows;
+        const int64_t in_r_start = out_r * stride_rows - args.pad_rows;
+        const int64_t fr_start = std::max<int64_t>(0, -in_r_start);
+        const int64_t fr_limit = std::min<int64_t>(
+            args.filter_rows, args.in_rows - in_r_start);
+        const T* input_image = input + b * args.in_rows * args.in_cols *
+                                           in_depth;
+        T* output_row = output + row * args.out_cols * out_depth;
+
+        for (int64_t out_c = 0; out_c < args.out_cols; ++out_c) {
+          const int64_t in_c_start = out_c * stride_cols - args.pad_cols;
+          const int64_t fc_start = std::max<int64_t>(0, -in_c_start);
+          const int64_t fc_limit = std::min<int64_t>(
+              args.filter_cols, args.in_cols - in_c_start);
+
+          Vector out(output_row + out_c * out_depth, out_depth);
+          out.setZero();
+          for (int64_t fr = fr_start; fr < fr_limit; ++fr) {
+            const T* input_pixels =
+                input_image + (in_r_start + fr) * args.in_cols * in_depth;
+            const T* filter_taps = filter + fr * args.filter_cols *
+                                                filter_tap_size;
+            for (int64_t fc = fc_start; fc < fc_limit; ++fc) {
+              const T* input_pixel =
+                  input_pixels + (in_c_start + fc) * in_depth;
+              const T* filter_tap = filter_taps + fc * filter_tap_size;
+              for (int64_t d = 0; d < in_depth; ++d) {
+                out += input_pixel[d] *
+                       ConstVector(filter_tap + d * out_depth, out_depth);
+              }
+            }
+          }
+        }
+      }
+    };
+
+    const int64_t shard_cost = args.out_cols * args.filter_rows *
+                               args.filter_cols * in_depth * out_depth;
+    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers,
+          static_cast<int64_t>(args.batch) * args.out_rows, shard_cost,
+          compute_rows);
+  }
+};
+
+template struct DirectConv2D<CPUDevice, float>;
+
+}  // namespace functor
+
+}  // namespace tensorflow
@@ -0,0 +1,53 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_DIRECT_CONV2D_H_
+#define TENSORFLOW_CORE_KERNELS_DIRECT_CONV2D_H_
+
+#include "tensorflow/core/kernels/deep_conv2d.h"
+
+namespace tensorflow {
+
+class OpKernelContext;
+
+// DirectConv2D is a Conv2D implementation for convolutions with few input and
+// output channels (e.g. the first layer of an image model), which computes
+// each output pixel directly from the input instead of contracting image
+// patches, whose depth (filter_rows * filter_cols * in_depth) is too small for
+// the contraction to be efficient.
+
+// Returns true if convolution operation specified by function arguments
+// can use DirectConv2D implementation, and false otherwise.
+// May return false based on parameters, or whether feature is disabled.
+bool CanUseDirectConv2D(int stride_rows, int stride_cols, int dilation_rows,
+                        int dilation_cols, int in_depth, int out_depth);
+
+namespace functor {
+
+// Calls DirectConv2D implementation (see direct_conv2d.cc for details).
+// `args.pad_rows` and `args.pad_cols` are the paddings before the input, the
+// input is implicitly padded after as needed by the output size.
+template <typename Device, typename T>
+struct DirectConv2D {
+  void operator()(OpKernelContext* ctx, const Conv2DArgs& args,
+                  int stride_rows, int stride_cols, const T* input,
+                  const T* filter, T* output);
+};
+
+}  // namespace functor
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DIRECT_CONV2D_H_
@@ -15,7 +15,10 @@ limitations under the License.
 
 // See docs in ../ops/parsing_ops.cc.
 
+#include <algorithm>
+#include <memory>
 #include <numeric>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -30,7 +33,9 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 #include "tensorflow/core/util/example_proto_helper.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
@@ -89,13 +94,16 @@ class ParseExampleOp : public OpKernel {
 
     example::FastParseExampleConfig config =
         MakeConfig(dense_keys_t, sparse_keys_t, ragged_keys_t, dense_defaults);
+    std::shared_ptr<const example::FastParseExampleConfigIndex> config_index;
+    OP_REQUIRES_OK(ctx, GetConfigIndex(config, &config_index));
 
     example::Result result;
     if (TensorShapeUtils::IsVector(serialized->shape())) {
-      OP_REQUIRES_OK(
-          ctx, ParseExampleVector(config, serialized, names, ctx, &result));
+      OP_REQUIRES_OK(ctx, ParseExampleVector(config, *config_index, serialized,
+                                             names, ctx, &result));
     } else {
-      OP_REQUIRES_OK(ctx, ParseExampleScalar(config, serialized, ctx, &result));
+      OP_REQUIRES_OK(ctx, ParseExampleScalar(config, *config_index,
+                                             serialized, ctx, &result));
     }
     OP_REQUIRES_OK(ctx, WriteOutput(result, ctx));
   }
@@ -234,25 +242,64 @@ class ParseExampleOp : public OpKernel {
     return config;
   }
 
+  // Returns the index of the feature names of `config`. The keys are inputs
+  // but rarely change between steps, so the index is rebuilt only when they
+  // differ from the keys of the last index built.
+  Status GetConfigIndex(
+      const example::FastParseExampleConfig& config,
+      std::shared_ptr<const example::FastParseExampleConfigIndex>* index)
+      TF_LOCKS_EXCLUDED(mu_) {
+    std::vector<StringPiece> keys;
+    keys.reserve(config.dense.size() + config.sparse.size() +
+                 config.ragged.size());
+    for (const auto& dense : config.dense) keys.push_back(dense.feature_name);
+    for (const auto& sparse : config.sparse) {
+      keys.push_back(sparse.feature_name);
+    }
+    for (const auto& ragged : config.ragged) {
+      keys.push_back(ragged.feature_name);
+    }
+    {
+      tf_shared_lock l(mu_);
+      if (config_index_ != nullptr &&
+          std::equal(keys.begin(), keys.end(), config_index_keys_.begin(),
+                     config_index_keys_.end())) {
+        *index = config_index_;
+        return absl::OkStatus();
+      }
+    }
+    auto new_index = std::make_shared<example::FastParseExampleConfigIndex>();
+    TF_RETURN_IF_ERROR(new_index->Init(config));
+    mutex_lock l(mu_);
+    config_index_keys_.assign(keys.begin(), keys.end());
+    config_index_ = new_index;
+    *index = std::move(new_index);
+    return absl::OkStatus();
+  }
+
   // Parses a single example.
-  Status ParseExampleScalar(const example::FastParseExampleConfig& config,
-                            const Tensor* serialized, OpKernelContext* ctx,
-                            example::Result* result) const {
+  Status ParseExampleScalar(
+      const example::FastParseExampleConfig& config,
+      const example::FastParseExampleConfigIndex& config_index,
+      const Tensor* serialized, OpKernelContext* ctx,
+      example::Result* result) const {
     const tstring& serialized_proto = serialized->scalar<tstring>()();
-    return FastParseSingleExample(config, serialized_proto, result);
+    return FastParseSingleExample(config, config_index, serialized_proto,
+                                  result);
   }
 
   // Parses a vector of examples.
-  Status ParseExampleVector(const example::FastParseExampleConfig& config,
-                            const Tensor* serialized, const Tensor* names,
-                            OpKernelContext* ctx,
-                            example::Result* result) const {
+  Status ParseExampleVector(
+      const example::FastParseExampleConfig& config,
+      const example::FastParseExampleConfigIndex& config_index,
+      const Tensor* serialized, const Tensor* names, OpKernelContext* ctx,
+      example::Result* result) const {
     auto serialized_t = serialized->flat<tstring>();
     auto names_t = names->flat<tstring>();
     absl::Span<const tstring> slice(serialized_t.data(), serialized_t.size());
     absl::Span<const tstring> names_slice(names_t.data(), names_t.size());
     return FastParseExample(
-        config, slice, names_slice,
+        config, config_index, slice, names_slice,
         ctx->device()->tensorflow_cpu_worker_threads()->workers, result);
   }
 
@@ -290,6 +337,12 @@ class ParseExampleOp : public OpKernel {
   ParseExampleAttrs attrs_;
   int op_version_;
   absl::once_flag flag_;
+
+  mutex mu_;
+  // Feature names of `config_index_`, in the order of MakeConfig.
+  std::vector<std::string> config_index_keys_ TF_GUARDED_BY(mu_);
+  std::shared_ptr<const example::FastParseExampleConfigIndex> config_index_
+      TF_GUARDED_BY(mu_);
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseExample").Device(DEVICE_CPU),
@@ -96,6 +96,9 @@ absl::Status DuccFftImpl(const Eigen::ThreadPoolDevice& device,
   }
   double scale = forward ? 1.0 : 1.0 / inv_scale;
 
+  // DUCC caches the plans of recently used transform lengths, and splits the
+  // batch and the transforms of large lengths across the threads of the pool,
+  // so neither needs to be done here.
   Eigen::ThreadPoolInterface* thread_pool = device.getPool();
 
   if (in.dtype() == DT_COMPLEX128 && out->dtype() == DT_COMPLEX128) {
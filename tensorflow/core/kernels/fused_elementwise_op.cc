@@ -0,0 +1,339 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// CPU kernel for _FusedElementwise, the fusion of a chain of elementwise ops
+// created by the remapper. The output is evaluated a tile at a time: every op
+// of the chain runs over the tile before moving on to the next one, so the
+// intermediate results stay in L1 instead of being written to memory.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/kernels/cwise_ops.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of elements of the output evaluated at a time.
+constexpr int64_t kTileSize = 1024;
+
+// Rough cost of evaluating one op of the chain for one element.
+constexpr int64_t kCostPerElementPerOp = 10;
+
+// Operand of an op that is the result of the previous op of the chain.
+constexpr int kPreviousResult = -1;
+
+// The unary ops come first.
+enum class ElementwiseOp {
+  kAbs,
+  kExp,
+  kLog,
+  kNeg,
+  kRelu,
+  kRsqrt,
+  kSigmoid,
+  kSqrt,
+  kSquare,
+  kTanh,
+  kAdd,
+  kDiv,
+  kMaximum,
+  kMinimum,
+  kMul,
+  kSquaredDifference,
+  kSub,
+};
+
+int Arity(ElementwiseOp op) { return op < ElementwiseOp::kAdd ? 1 : 2; }
+
+Status ParseElementwiseOp(const string& name, ElementwiseOp* op) {
+  static constexpr std::pair<const char*, ElementwiseOp> kOps[] = {
+      {"Abs", ElementwiseOp::kAbs},
+      {"Exp", ElementwiseOp::kExp},
+      {"Log", ElementwiseOp::kLog},
+      {"Neg", ElementwiseOp::kNeg},
+      {"Relu", ElementwiseOp::kRelu},
+      {"Rsqrt", ElementwiseOp::kRsqrt},
+      {"Sigmoid", ElementwiseOp::kSigmoid},
+      {"Sqrt", ElementwiseOp::kSqrt},
+      {"Square", ElementwiseOp::kSquare},
+      {"Tanh", ElementwiseOp::kTanh},
+      {"Add", ElementwiseOp::kAdd},
+      {"AddV2", ElementwiseOp::kAdd},
+      {"Div", ElementwiseOp::kDiv},
+      {"RealDiv", ElementwiseOp::kDiv},
+      {"Maximum", ElementwiseOp::kMaximum},
+      {"Minimum", ElementwiseOp::kMinimum},
+      {"Mul", ElementwiseOp::kMul},
+      {"SquaredDifference", ElementwiseOp::kSquaredDifference},
+      {"Sub", ElementwiseOp::kSub},
+  };
+  for (const auto& [op_name, value] : kOps) {
+    if (name == op_name) {
+      *op = value;
+      return absl::OkStatus();
+    }
+  }
+  return errors::InvalidArgument("Unsupported fused elementwise op: ", name);
+}
+
+template <typename Functor, typename T>
+void Unary(const T* x, T* out, int64_t n) {
+  typename TTypes<T>::UnalignedFlat result(out, n);
+  result = typename TTypes<T>::UnalignedConstFlat(x, n).unaryExpr(
+      typename Functor::func());
+}
+
+template <typename Functor, typename T>
+void Binary(const T* x, const T* y, T* out, int64_t n) {
+  typename TTypes<T>::UnalignedFlat result(out, n);
+  result = typename TTypes<T>::UnalignedConstFlat(x, n).binaryExpr(
+      typename TTypes<T>::UnalignedConstFlat(y, n), typename Functor::func());
+}
+
+template <typename T>
+void Relu(const T* x, T* out, int64_t n) {
+  typename TTypes<T>::UnalignedFlat result(out, n);
+  result = typename TTypes<T>::UnalignedConstFlat(x, n)
+               .template cwiseMax<Eigen::PropagateNaN>(static_cast<T>(0));
+}
+
+// Evaluates `op` over `n` elements. `out` may alias the operands.
+template <typename T>
+void Evaluate(ElementwiseOp op, const T* x, const T* y, T* out, int64_t n) {
+  switch (op) {
+    case ElementwiseOp::kAbs:
+      return Unary<functor::abs<T>>(x, out, n);
+    case ElementwiseOp::kExp:
+      return Unary<functor::exp<T>>(x, out, n);
+    case ElementwiseOp::kLog:
+      return Unary<functor::log<T>>(x, out, n);
+    case ElementwiseOp::kNeg:
+      return Unary<functor::neg<T>>(x, out, n);
+    case ElementwiseOp::kRelu:
+      return Relu(x, out, n);
+    case ElementwiseOp::kRsqrt:
+      return Unary<functor::rsqrt<T>>(x, out, n);
+    case ElementwiseOp::kSigmoid:
+      return Unary<functor::sigmoid<T>>(x, out, n);
+    case ElementwiseOp::kSqrt:
+      return Unary<functor::sqrt<T>>(x, out, n);
+    case ElementwiseOp::kSquare:
+      return Unary<functor::square<T>>(x, out, n);
+    case ElementwiseOp::kTanh:
+      return Unary<functor::tanh<T>>(x, out, n);
+    case ElementwiseOp::kAdd:
+      return Binary<functor::add<T>>(x, y, out, n);
+    case ElementwiseOp::kDiv:
+      return Binary<functor::div<T>>(x, y, out, n);
+    case ElementwiseOp::kMaximum:
+      return Binary<functor::maximum<T>>(x, y, out, n);
+    case ElementwiseOp::kMinimum:
+      return Binary<functor::minimum<T>>(x, y, out, n);
+    case ElementwiseOp::kMul:
+      return Binary<functor::mul<T>>(x, y, out, n);
+    case ElementwiseOp::kSquaredDifference:
+      return Binary<functor::squared_difference<T>>(x, y, out, n);
+    case ElementwiseOp::kSub:
+      return Binary<functor::sub<T>>(x, y, out, n);
+  }
+}
+
+// Returns whether `shape` is the shape of the innermost dimensions of
+// `output_shape`, i.e. it broadcasts to it by repeating along the outer ones.
+bool IsInnermostShape(const TensorShape& shape,
+                      const TensorShape& output_shape) {
+  const int offset = output_shape.dims() - shape.dims();
+  if (offset < 0) return false;
+  for (int i = 0; i < shape.dims(); ++i) {
+    if (shape.dim_size(i) != output_shape.dim_size(offset + i)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+template <typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    int num_args;
+    OP_REQUIRES_OK(context, context->GetAttr("N", &num_args));
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    std::vector<int32> operands;
+    OP_REQUIRES_OK(context, context->GetAttr("operands", &operands));
+    OP_REQUIRES(context, !fused_ops.empty(),
+                errors::InvalidArgument("fused_ops must not be empty"));
+
+    int next_operand = 0;
+    for (int i = 0; i < fused_ops.size(); ++i) {
+      Step step;
+      OP_REQUIRES_OK(context, ParseElementwiseOp(fused_ops[i], &step.op));
+      const int arity = Arity(step.op);
+      OP_REQUIRES(context, next_operand + arity <= operands.size(),
+                  errors::InvalidArgument("Expected more than ",
+                                          operands.size(), " operands for ",
+                                          fused_ops.size(), " fused ops"));
+      for (int j = 0; j < arity; ++j) {
+        const int operand = operands[next_operand++];
+        OP_REQUIRES(
+            context,
+            (operand == kPreviousResult && i > 0) ||
+                (operand >= 0 && operand < num_args),
+            errors::InvalidArgument("Invalid operand ", operand,
+                                    " of fused op ", i, " (", fused_ops[i],
+                                    ") with ", num_args, " args"));
+        step.operands[j] = operand;
+      }
+      steps_.push_back(step);
+    }
+    OP_REQUIRES(context, next_operand == operands.size(),
+                errors::InvalidArgument("Expected ", next_operand,
+                                        " operands for ", fused_ops.size(),
+                                        " fused ops, got ", operands.size()));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    OpInputList args;
+    OP_REQUIRES_OK(context, context->input_list("args", &args));
+    const TensorShape& shape = args[0].shape();
+    const int64_t size = shape.num_elements();
+
+    // Args with the shape of the output are read in place. The others are
+    // repeated every `periods[k]` elements of the output, and are copied into
+    // a tile of their own.
+    std::vector<int64_t> periods(args.size(), 0);
+    std::vector<int> forwardable_args;
+    for (int k = 0; k < args.size(); ++k) {
+      const TensorShape& arg_shape = args[k].shape();
+      if (arg_shape == shape) {
+        forwardable_args.push_back(k);
+      } else if ((arg_shape.num_elements() == 1 &&
+                  arg_shape.dims() <= shape.dims()) ||
+                 IsInnermostShape(arg_shape, shape)) {
+        periods[k] = arg_shape.num_elements();
+      } else {
+        OP_REQUIRES(context, false,
+                    errors::InvalidArgument(
+                        "Arg ", k, " of shape ", arg_shape.DebugString(),
+                        " does not broadcast to ", shape.DebugString()));
+      }
+    }
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
+                                forwardable_args, 0, shape, &output));
+    if (size == 0) return;
+    T* const out = output->flat<T>().data();
+
+    const auto evaluate_tiles = [&](int64_t begin_tile, int64_t end_tile) {
+      // The result of the previous op, followed by the broadcast args.
+      std::vector<T> buffer(kTileSize);
+      std::vector<int64_t> tile_offsets(args.size(), 0);
+      for (int k = 0; k < args.size(); ++k) {
+        if (periods[k] == 0) continue;
+        tile_offsets[k] = buffer.size();
+        buffer.resize(buffer.size() + kTileSize);
+      }
+      T* const result = buffer.data();
+
+      // Copies the elements of arg `k` under the tile starting at element
+      // `start` of the output.
+      const auto fill_tile = [&](int k, int64_t start, int64_t n) {
+        const T* const arg = args[k].flat<T>().data();
+        T* const tile = result + tile_offsets[k];
+        int64_t offset = start % periods[k];
+        for (int64_t i = 0; i < n;) {
+          const int64_t count = std::min(n - i, periods[k] - offset);
+          std::copy_n(arg + offset, count, tile + i);
+          i += count;
+          offset = 0;
+        }
+      };
+      // Tiles start at a multiple of kTileSize, so the tile of an arg whose
+      // period divides it is the same for every tile.
+      for (int k = 0; k < args.size(); ++k) {
+        if (periods[k] != 0 && kTileSize % periods[k] == 0) {
+          fill_tile(k, 0, kTileSize);
+        }
+      }
+
+      for (int64_t tile = begin_tile; tile < end_tile; ++tile) {
+        const int64_t start = tile * kTileSize;
+        const int64_t n = std::min(kTileSize, size - start);
+        for (int k = 0; k < args.size(); ++k) {
+          if (periods[k] != 0 && kTileSize % periods[k] != 0) {
+            fill_tile(k, start, n);
+          }
+        }
+        const auto operand = [&](int code) -> const T* {
+          if (code == kPreviousResult) return result;
+          if (periods[code] != 0) return result + tile_offsets[code];
+          return args[code].flat<T>().data() + start;
+        };
+        for (int i = 0; i < steps_.size(); ++i) {
+          const Step& step = steps_[i];
+          T* const dst = i + 1 == steps_.size() ? out + start : result;
+          Evaluate(step.op, operand(step.operands[0]),
+                   Arity(step.op) == 2 ? operand(step.operands[1]) : nullptr,
+                   dst, n);
+        }
+      }
+    };
+
+    const int64_t num_tiles = (size + kTileSize - 1) / kTileSize;
+    const int64_t cost_per_tile =
+        kTileSize * kCostPerElementPerOp * steps_.size();
+    const auto& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, num_tiles,
+          cost_per_tile, evaluate_tiles);
+  }
+
+ private:
+  struct Step {
+    ElementwiseOp op;
+    int operands[2] = {kPreviousResult, kPreviousResult};
+  };
+
+  std::vector<Step> steps_;
+};
+
+#define REGISTER_CPU_KERNEL(T)                                             \
+  REGISTER_KERNEL_BUILDER(                                                 \
+      Name("_FusedElementwise").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedElementwiseOp<T>);
+
+TF_CALL_half(REGISTER_CPU_KERNEL);
+TF_CALL_bfloat16(REGISTER_CPU_KERNEL);
+TF_CALL_float(REGISTER_CPU_KERNEL);
+TF_CALL_double(REGISTER_CPU_KERNEL);
+
+#undef REGISTER_CPU_KERNEL
+
+}  // namespace tensorflow
@@ -0,0 +1,110 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  Status MakeOp(int num_args, const std::vector<string>& fused_ops,
+                const std::vector<int>& operands) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("fused_op", "_FusedElementwise")
+                           .Input(FakeInput(num_args, DT_FLOAT))
+                           .Attr("fused_ops", fused_ops)
+                           .Attr("operands", operands)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(FusedElementwiseOpTest, EvaluatesChainWithBroadcastArgs) {
+  // relu((x + bias) * scale)
+  TF_ASSERT_OK(MakeOp(3, {"AddV2", "Mul", "Relu"}, {0, 1, -1, 2, -1}));
+  AddInputFromArray<float>(TensorShape({2, 3}), {1, -2, 3, -4, 5, -6});
+  AddInputFromArray<float>(TensorShape({3}), {1, 1, -1});
+  AddInputFromArray<float>(TensorShape({}), {2});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&expected, {4, 0, 4, 0, 12, 0});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, RepeatsBroadcastArgsAcrossTiles) {
+  // sqrt(squared_difference(x, mean)) over more than one tile, with a period
+  // that does not divide the tile size.
+  constexpr int kRows = 500;
+  constexpr int kCols = 7;
+  TF_ASSERT_OK(MakeOp(2, {"SquaredDifference", "Sqrt"}, {0, 1, -1}));
+  std::vector<float> x(kRows * kCols);
+  for (int i = 0; i < x.size(); ++i) x[i] = i % 13;
+  std::vector<float> mean(kCols);
+  for (int j = 0; j < kCols; ++j) mean[j] = j;
+  AddInputFromArray<float>(TensorShape({kRows, kCols}), x);
+  AddInputFromArray<float>(TensorShape({kCols}), mean);
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({kRows, kCols}));
+  auto expected_flat = expected.flat<float>();
+  for (int i = 0; i < x.size(); ++i) {
+    expected_flat(i) = std::abs(x[i] - mean[i % kCols]);
+  }
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(FusedElementwiseOpTest, UsesArgsMoreThanOnce) {
+  // x * sigmoid(x)
+  TF_ASSERT_OK(MakeOp(1, {"Sigmoid", "Mul"}, {0, 0, -1}));
+  AddInputFromArray<float>(TensorShape({4}), {-2, -1, 0, 3});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({4}));
+  auto expected_flat = expected.flat<float>();
+  const std::vector<float> x = {-2, -1, 0, 3};
+  for (int i = 0; i < x.size(); ++i) {
+    expected_flat(i) = x[i] / (1 + std::exp(-x[i]));
+  }
+  test::ExpectTensorNear<float>(expected, *GetOutput(0), 1e-5);
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsArgsThatDoNotBroadcast) {
+  TF_ASSERT_OK(MakeOp(2, {"Add", "Neg"}, {0, 1, -1}));
+  AddInputFromArray<float>(TensorShape({2, 3}), {1, 2, 3, 4, 5, 6});
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  EXPECT_TRUE(errors::IsInvalidArgument(RunOpKernel()));
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsInvalidOperands) {
+  // The first op has no previous result.
+  EXPECT_TRUE(errors::IsInvalidArgument(MakeOp(1, {"Neg", "Exp"}, {-1, -1})));
+  EXPECT_TRUE(errors::IsInvalidArgument(MakeOp(1, {"Add"}, {0, 1})));
+  EXPECT_TRUE(errors::IsInvalidArgument(MakeOp(1, {"Neg"}, {0, 0})));
+  EXPECT_TRUE(errors::IsInvalidArgument(MakeOp(1, {"Erf"}, {0})));
+}
+
+}  // namespace
+}  // namespace tensorflow
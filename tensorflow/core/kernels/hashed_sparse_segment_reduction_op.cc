@@ -0,0 +1,196 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// CPU kernel for _HashedSparseSegmentReduction, the fusion of
+// StringToHashBucketFast into SparseSegmentSum/Mean/SqrtN created by the
+// remapper. Hashing, gathering and combining happen in one pass over each
+// segment, so neither the bucket ids nor the gathered rows are materialized.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/prefetch.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+template <typename T, typename SegmentId>
+class HashedSparseSegmentReductionOp : public OpKernel {
+ public:
+  explicit HashedSparseSegmentReductionOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("num_buckets", &num_buckets_));
+    string combiner;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("combiner", &combiner));
+    is_mean_ = combiner == "mean";
+    is_sqrtn_ = combiner == "sqrtn";
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& data = context->input(0);
+    const Tensor& input = context->input(1);
+    const Tensor& segment_ids = context->input(2);
+
+    OP_REQUIRES(context, TensorShapeUtils::IsVectorOrHigher(data.shape()),
+                errors::InvalidArgument("Data must be at least a vector, got ",
+                                        data.shape().DebugString()));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input.shape()),
+                errors::InvalidArgument("Input should be a vector, got ",
+                                        input.shape().DebugString()));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(segment_ids.shape()),
+                errors::InvalidArgument("Segment_ids should be a vector, got ",
+                                        segment_ids.shape().DebugString()));
+    const int64_t num_ids = input.NumElements();
+    OP_REQUIRES(context, num_ids == segment_ids.NumElements(),
+                errors::InvalidArgument(
+                    "segment_ids and input should have same size."));
+
+    const auto ids = input.vec<tstring>();
+    const auto segment_vec = segment_ids.vec<SegmentId>();
+
+    // Finds where each segment starts. The segment ids must be sorted, as for
+    // the unfused SparseSegment reductions.
+    std::vector<int64_t> segment_starts;
+    std::vector<SegmentId> segment_rows;
+    for (int64_t i = 0; i < num_ids; ++i) {
+      const SegmentId segment = internal::SubtleMustCopy(segment_vec(i));
+      if (i == 0) {
+        OP_REQUIRES(context, segment >= 0,
+                    errors::InvalidArgument("segment ids must be >= 0"));
+      } else if (segment == segment_rows.back()) {
+        continue;
+      } else {
+        OP_REQUIRES(context, segment > segment_rows.back(),
+                    errors::InvalidArgument("segment ids are not increasing"));
+      }
+      segment_starts.push_back(i);
+      segment_rows.push_back(segment);
+    }
+    segment_starts.push_back(num_ids);
+    const int64_t num_segments = segment_rows.size();
+    const int64_t output_rows =
+        num_segments > 0 ? static_cast<int64_t>(segment_rows.back()) + 1 : 0;
+
+    TensorShape output_shape = data.shape();
+    OP_REQUIRES_OK(context, output_shape.SetDimWithStatus(
+                                /*d=*/0, /*size=*/output_rows));
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, output_shape, &output));
+    if (output_rows == 0) return;
+
+    const auto data_flat = data.flat_outer_dims<T>();
+    auto output_flat = output->flat_outer_dims<T>();
+    const int64_t num_rows = data_flat.dimension(0);
+    const int64_t num_cols = data_flat.dimension(1);
+    // Rows without ids keep the default value of the unfused ops.
+    output_flat.setZero();
+
+    std::atomic<int64_t> bad_id(-1);
+    auto reduce_segments = [&](int64_t begin, int64_t end) {
+      int64_t buckets[kTileSize];
+      for (int64_t s = begin; s < end; ++s) {
+        typename TTypes<T>::UnalignedFlat out(&output_flat(segment_rows[s], 0),
+                                              num_cols);
+        for (int64_t tile = segment_starts[s]; tile < segment_starts[s + 1];
+             tile += kTileSize) {
+          const int64_t tile_size =
+              std::min(kTileSize, segment_starts[s + 1] - tile);
+          // Hashes the tile first and prefetches its rows, so that the rows
+          // are loaded while the following ids are hashed.
+          for (int64_t k = 0; k < tile_size; ++k) {
+            const int64_t bucket = Bucket(ids(tile + k));
+            if (bucket >= num_rows) {
+              bad_id = tile + k;
+              return;
+            }
+            buckets[k] = bucket;
+            port::prefetch<port::PREFETCH_HINT_T0>(&data_flat(bucket, 0));
+          }
+          for (int64_t k = 0; k < tile_size; ++k) {
+            out += typename TTypes<T>::UnalignedConstFlat(
+                &data_flat(buckets[k], 0), num_cols);
+          }
+        }
+        const int64_t num = segment_starts[s + 1] - segment_starts[s];
+        if (is_mean_) {
+          out = out / static_cast<T>(num);
+        } else if (is_sqrtn_) {
+          out = out / static_cast<T>(std::sqrt(num));
+        }
+      }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64_t cost_per_segment =
+        (num_ids / num_segments + 1) * (num_cols + kHashCost);
+    Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+          cost_per_segment, reduce_segments);
+
+    const int64_t bad = bad_id;
+    OP_REQUIRES(context, bad < 0,
+                errors::InvalidArgument(
+                    "Bad: indices[", bad, "] == ", Bucket(ids(bad)),
+                    " out of range [0, ", num_rows, ")"));
+  }
+
+ private:
+  // Same as StringToHashBucketFast.
+  int64_t Bucket(const tstring& id) const {
+    return static_cast<int64_t>(Fingerprint64(id) %
+                                static_cast<uint64>(num_buckets_));
+  }
+
+  // Number of ids hashed, and whose rows are prefetched, at a time.
+  static constexpr int64_t kTileSize = 16;
+  // Rough cost of hashing an id, in the units of adding one element.
+  static constexpr int64_t kHashCost = 20;
+
+  int64_t num_buckets_;
+  bool is_mean_;
+  bool is_sqrtn_;
+
+  HashedSparseSegmentReductionOp(const HashedSparseSegmentReductionOp&) =
+      delete;
+  void operator=(const HashedSparseSegmentReductionOp&) = delete;
+};
+
+#define REGISTER_CPU_KERNELS(type, segment_id_type)                      \
+  REGISTER_KERNEL_BUILDER(                                               \
+      Name("_HashedSparseSegmentReduction")                              \
+          .Device(DEVICE_CPU)                                            \
+          .TypeConstraint<type>("T")                                     \
+          .TypeConstraint<segment_id_type>("Tsegmentids"),               \
+      HashedSparseSegmentReductionOp<type, segment_id_type>);
+
+REGISTER_CPU_KERNELS(float, int32);
+REGISTER_CPU_KERNELS(float, int64_t);
+REGISTER_CPU_KERNELS(double, int32);
+REGISTER_CPU_KERNELS(double, int64_t);
+
+#undef REGISTER_CPU_KERNELS
+
+}  // namespace tensorflow
@@ -0,0 +1,134 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kNumRows = 4;
+constexpr int kNumCols = 3;
+
+class HashedSparseSegmentReductionOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(int num_buckets, const string& combiner) {
+    TF_ASSERT_OK(NodeDefBuilder("op", "_HashedSparseSegmentReduction")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("num_buckets", num_buckets)
+                     .Attr("combiner", combiner)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void AddData() {
+    std::vector<float> data(kNumRows * kNumCols);
+    for (int i = 0; i < data.size(); ++i) data[i] = i;
+    AddInputFromArray<float>(TensorShape({kNumRows, kNumCols}), data);
+  }
+
+  // Computes StringToHashBucketFast followed by a sparse segment reduction
+  // of the data added by AddData.
+  Tensor Expected(const std::vector<tstring>& ids,
+                  const std::vector<int32>& segment_ids,
+                  const string& combiner) {
+    const int num_segments = segment_ids.back() + 1;
+    Tensor expected(DT_FLOAT, TensorShape({num_segments, kNumCols}));
+    auto expected_matrix = expected.matrix<float>();
+    expected_matrix.setZero();
+    std::vector<int> counts(num_segments, 0);
+    for (int i = 0; i < ids.size(); ++i) {
+      const int row = Fingerprint64(ids[i]) % kNumRows;
+      for (int j = 0; j < kNumCols; ++j) {
+        expected_matrix(segment_ids[i], j) += row * kNumCols + j;
+      }
+      ++counts[segment_ids[i]];
+    }
+    for (int s = 0; s < num_segments; ++s) {
+      if (counts[s] == 0) continue;
+      const float scale = combiner == "mean"    ? counts[s]
+                          : combiner == "sqrtn" ? std::sqrt(counts[s])
+                                                : 1.0f;
+      for (int j = 0; j < kNumCols; ++j) expected_matrix(s, j) /= scale;
+    }
+    return expected;
+  }
+
+  void RunCombiner(const string& combiner) {
+    MakeOp(kNumRows, combiner);
+    const std::vector<tstring> ids = {"a", "b", "c", "d", "e", "f"};
+    const std::vector<int32> segment_ids = {0, 0, 2, 2, 2, 4};
+    AddData();
+    AddInputFromArray<tstring>(TensorShape({6}), ids);
+    AddInputFromArray<int32>(TensorShape({6}), segment_ids);
+    TF_ASSERT_OK(RunOpKernel());
+    test::ExpectTensorNear<float>(*GetOutput(0),
+                                  Expected(ids, segment_ids, combiner), 1e-5);
+  }
+};
+
+TEST_F(HashedSparseSegmentReductionOpTest, Sum) { RunCombiner("sum"); }
+
+TEST_F(HashedSparseSegmentReductionOpTest, Mean) { RunCombiner("mean"); }
+
+TEST_F(HashedSparseSegmentReductionOpTest, SqrtN) { RunCombiner("sqrtn"); }
+
+TEST_F(HashedSparseSegmentReductionOpTest, EmptyInput) {
+  MakeOp(kNumRows, "sum");
+  AddData();
+  AddInputFromArray<tstring>(TensorShape({0}), {});
+  AddInputFromArray<int32>(TensorShape({0}), {});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(GetOutput(0)->shape(), TensorShape({0, kNumCols}));
+}
+
+TEST_F(HashedSparseSegmentReductionOpTest, BucketOutOfRange) {
+  // Twice as many buckets as rows, with an id hashed past the last row.
+  MakeOp(2 * kNumRows, "sum");
+  tstring id = "a";
+  while (Fingerprint64(id) % (2 * kNumRows) < kNumRows) id.append("a");
+  AddData();
+  AddInputFromArray<tstring>(TensorShape({1}), {id});
+  AddInputFromArray<int32>(TensorShape({1}), {0});
+  const Status status = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_TRUE(absl::StrContains(status.message(), "out of range"));
+}
+
+TEST_F(HashedSparseSegmentReductionOpTest, SegmentIdsNotIncreasing) {
+  MakeOp(kNumRows, "sum");
+  AddData();
+  AddInputFromArray<tstring>(TensorShape({2}), {"a", "b"});
+  AddInputFromArray<int32>(TensorShape({2}), {1, 0});
+  const Status status = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(status));
+  EXPECT_TRUE(absl::StrContains(status.message(), "not increasing"));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,444 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/image_ops.cc
+
+#define EIGEN_USE_THREADS
+
+#include "tensorflow/core/kernels/image/decode_and_resize_jpeg_op.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/stringpiece.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace {
+
+// Returns the largest DCT scaling denominator that decodes a crop of
+// `crop_height` x `crop_width` pixels at no less than `out_height` x
+// `out_width`, so that the resize never upsamples what a full decode would
+// have downsampled.
+int ChooseRatio(int crop_height, int crop_width, int out_height,
+                int out_width) {
+  for (const int ratio : {8, 4, 2}) {
+    if (crop_height >= int64_t{out_height} * ratio &&
+        crop_width >= int64_t{out_width} * ratio) {
+      return ratio;
+    }
+  }
+  return 1;
+}
+
+// Source pixels and weight of one output coordinate of a bilinear resize.
+struct Interpolation {
+  int lower;
+  int upper;
+  float lerp;
+};
+
+std::vector<Interpolation> ComputeInterpolation(int out_size, int crop_offset,
+                                                int crop_size, int ratio,
+                                                int decoded_offset,
+                                                int decoded_size) {
+  std::vector<Interpolation> interpolation(out_size);
+  for (int i = 0; i < out_size; ++i) {
+    const float in = DecodedCoordinate(i, out_size, crop_offset, crop_size,
+                                       ratio, decoded_offset, decoded_size);
+    const int lower = static_cast<int>(in);
+    interpolation[i].lower = lower;
+    interpolation[i].upper = std::min(lower + 1, decoded_size - 1);
+    interpolation[i].lerp = in - lower;
+  }
+  return interpolation;
+}
+
+// Resizes the pixels decoded with `geometry` into `output`.
+void ResizeDecodedJpeg(const uint8* image, const DecodedJpegGeometry& geometry,
+                       int out_height, int out_width, int channels,
+                       float* output) {
+  const std::vector<Interpolation> ys = ComputeInterpolation(
+      out_height, geometry.crop_y, geometry.crop_height, geometry.ratio,
+      geometry.decoded_y, geometry.decoded_height);
+  const std::vector<Interpolation> xs = ComputeInterpolation(
+      out_width, geometry.crop_x, geometry.crop_width, geometry.ratio,
+      geometry.decoded_x, geometry.decoded_width);
+  const int64_t row_size = static_cast<int64_t>(geometry.decoded_width) *
+                           channels;
+  for (int y = 0; y < out_height; ++y) {
+    const uint8* top = image + ys[y].lower * row_size;
+    const uint8* bottom = image + ys[y].upper * row_size;
+    const float y_lerp = ys[y].lerp;
+    for (int x = 0; x < out_width; ++x) {
+      const int64_t left = xs[x].lower * channels;
+      const int64_t right = xs[x].upper * channels;
+      const float x_lerp = xs[x].lerp;
+      for (int c = 0; c < channels; ++c) {
+        const float top_value =
+            top[left + c] + (top[right + c] - top[left + c]) * x_lerp;
+        const float bottom_value =
+            bottom[left + c] + (bottom[right + c] - bottom[left + c]) * x_lerp;
+        *output++ = top_value + (bottom_value - top_value) * y_lerp;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+// Decodes the images of a batch in parallel on the intra-op pool. Subclasses
+// resize them on their device.
+class DecodeAndResizeJpegOpBase : public OpKernel {
+ public:
+  explicit DecodeAndResizeJpegOpBase(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("channels", &channels_));
+    OP_REQUIRES(context, channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 1 or 3, got ",
+                                        channels_));
+    OP_REQUIRES_OK(context, context->GetAttr("fancy_upscaling",
+                                             &flags_.fancy_upscaling));
+    string dct_method;
+    OP_REQUIRES_OK(context, context->GetAttr("dct_method", &dct_method));
+    OP_REQUIRES(
+        context,
+        (dct_method.empty() || dct_method == "INTEGER_FAST" ||
+         dct_method == "INTEGER_ACCURATE"),
+        errors::InvalidArgument("dct_method must be one of "
+                                "{'', 'INTEGER_FAST', 'INTEGER_ACCURATE'}"));
+    flags_.dct_method =
+        dct_method == "INTEGER_ACCURATE" ? JDCT_ISLOW : JDCT_IFAST;
+    flags_.components = channels_;
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents = context->input(0);
+    const Tensor& crop_windows = context->input(1);
+    const Tensor& size = context->input(2);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents.shape()),
+                errors::InvalidArgument("contents must be 1-D, got shape ",
+                                        contents.shape().DebugString()));
+    const int64_t batch = contents.NumElements();
+    OP_REQUIRES(context,
+                crop_windows.dims() == 2 && crop_windows.dim_size(1) == 4 &&
+                    (crop_windows.dim_size(0) == batch ||
+                     crop_windows.dim_size(0) == 0),
+                errors::InvalidArgument(
+                    "crop_windows must have shape [", batch, ", 4] or [0, 4]",
+                    ", got shape ", crop_windows.shape().DebugString()));
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(size.shape()) &&
+                    size.NumElements() == 2,
+                errors::InvalidArgument("size must be 1-D with 2 elements, "
+                                        "got shape ",
+                                        size.shape().DebugString()));
+    const int out_height = size.vec<int32>()(0);
+    const int out_width = size.vec<int32>()(1);
+    OP_REQUIRES(context, out_height > 0 && out_width > 0,
+                errors::InvalidArgument("size must be positive, got [",
+                                        out_height, ", ", out_width, "]"));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            0, TensorShape({batch, out_height, out_width, channels_}),
+            &output));
+    if (batch == 0) return;
+
+    auto contents_flat = contents.flat<tstring>();
+    const bool has_crop_windows = crop_windows.dim_size(0) > 0;
+    auto crop_windows_matrix = crop_windows.matrix<int32>();
+    std::vector<Status> statuses(batch);
+    DecodeImages(
+        context, batch, out_height, out_width,
+        [&](int64_t i, std::vector<uint8>* decoded,
+            DecodedJpegGeometry* geometry) {
+          const int32* crop_window =
+              has_crop_windows ? &crop_windows_matrix(i, 0) : nullptr;
+          statuses[i] = Decode(contents_flat(i), crop_window, out_height,
+                               out_width, decoded, geometry);
+          return statuses[i].ok();
+        },
+        output);
+    for (int64_t i = 0; i < batch; ++i) {
+      OP_REQUIRES(context, statuses[i].ok(),
+                  errors::CreateWithUpdatedMessage(
+                      statuses[i], absl::StrCat("Image ", i, ": ",
+                                                statuses[i].message())));
+    }
+  }
+
+ protected:
+  // Decodes image `i` of the batch into `decoded`, and returns whether it
+  // succeeded.
+  using DecodeFn = std::function<bool(int64_t i, std::vector<uint8>* decoded,
+                                      DecodedJpegGeometry* geometry)>;
+
+  // Decodes the `batch` images with `decode` and resizes them into `output`.
+  virtual void DecodeImages(OpKernelContext* context, int64_t batch,
+                            int out_height, int out_width,
+                            const DecodeFn& decode, Tensor* output) = 0;
+
+  // Runs `fn(start, limit)` over the images of the batch on the intra-op
+  // pool.
+  void ShardImages(OpKernelContext* context, int64_t batch,
+                   int64_t output_image_size,
+                   const std::function<void(int64_t, int64_t)>& fn) const {
+    // Decoding dominates, at tens of cycles per compressed byte.
+    const Tensor& contents = context->input(0);
+    auto contents_flat = contents.flat<tstring>();
+    int64_t total_bytes = 0;
+    for (int64_t i = 0; i < batch; ++i) total_bytes += contents_flat(i).size();
+    const int64_t cost_per_image =
+        50 * (total_bytes / batch) + 10 * output_image_size;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads.num_threads, worker_threads.workers, batch,
+          cost_per_image, fn);
+  }
+
+  int channels_;
+
+ private:
+  // Decodes `input`, cropped to `crop_window` ([y, x, height, width] or null
+  // for the whole image), into `decoded` at the smallest DCT scale no
+  // smaller than the output.
+  Status Decode(StringPiece input, const int32* crop_window, int out_height,
+                int out_width, std::vector<uint8>* decoded,
+                DecodedJpegGeometry* geometry) const {
+    if (input.size() > std::numeric_limits<int>::max()) {
+      return errors::InvalidArgument("JPEG contents are too large for int: ",
+                                     input.size());
+    }
+    int image_width, image_height;
+    if (!jpeg::GetImageInfo(input.data(), input.size(), &image_width,
+                            &image_height, nullptr)) {
+      return errors::InvalidArgument("Invalid JPEG data, size ", input.size());
+    }
+    int crop_y = 0, crop_x = 0;
+    int crop_height = image_height, crop_width = image_width;
+    if (crop_window != nullptr) {
+      crop_y = crop_window[0];
+      crop_x = crop_window[1];
+      crop_height = crop_window[2];
+      crop_width = crop_window[3];
+      if (crop_y < 0 || crop_x < 0 || crop_height <= 0 || crop_width <= 0 ||
+          int64_t{crop_y} + crop_height > image_height ||
+          int64_t{crop_x} + crop_width > image_width) {
+        return errors::InvalidArgument(
+            "Invalid crop window [", crop_y, ", ", crop_x, ", ", crop_height,
+            ", ", crop_width, "] for a ", image_height, "x", image_width,
+            " image");
+      }
+    }
+
+    // libjpeg crops in the coordinates of the scaled image, whose sizes are
+    // rounded up.
+    jpeg::UncompressFlags flags = flags_;
+    flags.ratio = ChooseRatio(crop_height, crop_width, out_height, out_width);
+    const int ratio = flags.ratio;
+    const int scaled_height = (image_height + ratio - 1) / ratio;
+    const int scaled_width = (image_width + ratio - 1) / ratio;
+    const int decoded_y = crop_y / ratio;
+    const int decoded_x = crop_x / ratio;
+    const int decoded_height =
+        std::min((crop_y + crop_height + ratio - 1) / ratio, scaled_height) -
+        decoded_y;
+    const int decoded_width =
+        std::min((crop_x + crop_width + ratio - 1) / ratio, scaled_width) -
+        decoded_x;
+    if (decoded_height != scaled_height || decoded_width != scaled_width) {
+      flags.crop = true;
+      flags.crop_y = decoded_y;
+      flags.crop_x = decoded_x;
+      flags.crop_height = decoded_height;
+      flags.crop_width = decoded_width;
+    }
+
+    int width = 0, height = 0;
+    const uint8* image = jpeg::Uncompress(
+        input.data(), input.size(), flags, nullptr,
+        [&](int w, int h, int components) -> uint8* {
+          if (components != channels_) return nullptr;
+          width = w;
+          height = h;
+          decoded->resize(static_cast<size_t>(w) * h * components);
+          return decoded->data();
+        });
+    if (image == nullptr) {
+      return errors::InvalidArgument(
+          "jpeg::Uncompress failed. Invalid JPEG data or crop window.");
+    }
+    if (height != decoded_height || width != decoded_width) {
+      return errors::Internal("Decoded a ", height, "x", width,
+                              " image instead of ", decoded_height, "x",
+                              decoded_width);
+    }
+
+    geometry->offset = 0;
+    geometry->crop_y = crop_y;
+    geometry->crop_x = crop_x;
+    geometry->crop_height = crop_height;
+    geometry->crop_width = crop_width;
+    geometry->ratio = ratio;
+    geometry->decoded_y = decoded_y;
+    geometry->decoded_x = decoded_x;
+    geometry->decoded_height = decoded_height;
+    geometry->decoded_width = decoded_width;
+    return absl::OkStatus();
+  }
+
+  jpeg::UncompressFlags flags_;
+};
+
+template <typename Device>
+class DecodeAndResizeJpegOp;
+
+// Decodes and resizes each image in the same shard.
+template <>
+class DecodeAndResizeJpegOp<CPUDevice> : public DecodeAndResizeJpegOpBase {
+ public:
+  using DecodeAndResizeJpegOpBase::DecodeAndResizeJpegOpBase;
+
+ protected:
+  void DecodeImages(OpKernelContext* context, int64_t batch, int out_height,
+                    int out_width, const DecodeFn& decode,
+                    Tensor* output) override {
+    auto output_tensor = output->tensor<float, 4>();
+    const int64_t image_size =
+        static_cast<int64_t>(out_height) * out_width * channels_;
+    ShardImages(context, batch, image_size, [&](int64_t start, int64_t limit) {
+      std::vector<uint8> decoded;
+      DecodedJpegGeometry geometry;
+      for (int64_t i = start; i < limit; ++i) {
+        if (!decode(i, &decoded, &geometry)) continue;
+        ResizeDecodedJpeg(decoded.data(), geometry, out_height, out_width,
+                          channels_, &output_tensor(i, 0, 0, 0));
+      }
+    });
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpeg").Device(DEVICE_CPU),
+                        DecodeAndResizeJpegOp<CPUDevice>);
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// Decodes the images on the host, copies the decoded pixels of the batch to
+// the device in one transfer, and resizes them there. After DCT scaling the
+// decoded images are rarely more than twice the output size in each
+// dimension, and their pixels are a quarter of the size of float pixels, so
+// this moves about as little data as copying the resized images would,
+// without resizing on the host.
+template <>
+class DecodeAndResizeJpegOp<GPUDevice> : public DecodeAndResizeJpegOpBase {
+ public:
+  using DecodeAndResizeJpegOpBase::DecodeAndResizeJpegOpBase;
+
+ protected:
+  void DecodeImages(OpKernelContext* context, int64_t batch, int out_height,
+                    int out_width, const DecodeFn& decode,
+                    Tensor* output) override {
+    std::vector<std::vector<uint8>> decoded(batch);
+    std::vector<DecodedJpegGeometry> geometry(batch);
+    std::atomic<bool> ok = true;
+    const int64_t image_size =
+        static_cast<int64_t>(out_height) * out_width * channels_;
+    ShardImages(context, batch, image_size, [&](int64_t start, int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        if (!decode(i, &decoded[i], &geometry[i])) ok.store(false);
+      }
+    });
+    if (!ok) return;
+
+    // Packs the decoded pixels and their geometry into pinned host memory.
+    int64_t total_bytes = 0;
+    for (int64_t i = 0; i < batch; ++i) {
+      geometry[i].offset = total_bytes;
+      total_bytes += decoded[i].size();
+    }
+    const int64_t geometry_bytes = batch * sizeof(DecodedJpegGeometry);
+    AllocatorAttributes host_attr;
+    host_attr.set_on_host(true);
+    host_attr.set_gpu_compatible(true);
+    Tensor host_pixels, host_geometry;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_UINT8, TensorShape({total_bytes}),
+                                          &host_pixels, host_attr));
+    OP_REQUIRES_OK(context, context->allocate_temp(
+                                DT_UINT8, TensorShape({geometry_bytes}),
+                                &host_geometry, host_attr));
+    uint8* pixels = host_pixels.flat<uint8>().data();
+    for (int64_t i = 0; i < batch; ++i) {
+      std::memcpy(pixels + geometry[i].offset, decoded[i].data(),
+                  decoded[i].size());
+    }
+    std::memcpy(host_geometry.flat<uint8>().data(), geometry.data(),
+                geometry_bytes);
+
+    Tensor device_pixels, device_geometry;
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_UINT8, host_pixels.shape(),
+                                          &device_pixels));
+    OP_REQUIRES_OK(context,
+                   context->allocate_temp(DT_UINT8, host_geometry.shape(),
+                                          &device_geometry));
+    DeviceContext* device_context = context->op_device_context();
+    Device* device = static_cast<Device*>(context->device());
+    OP_REQUIRES_OK(context, device_context->CopyCPUTensorToDeviceSync(
+                                &host_pixels, device, &device_pixels));
+    OP_REQUIRES_OK(context, device_context->CopyCPUTensorToDeviceSync(
+                                &host_geometry, device, &device_geometry));
+    OP_REQUIRES_OK(
+        context,
+        functor::ResizeDecodedJpegs<GPUDevice>()(
+            context->eigen_device<GPUDevice>(),
+            device_pixels.flat<uint8>().data(),
+            reinterpret_cast<const DecodedJpegGeometry*>(
+                device_geometry.flat<uint8>().data()),
+            output->tensor<float, 4>()));
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("DecodeAndResizeJpeg")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("contents")
+                            .HostMemory("crop_windows")
+                            .HostMemory("size"),
+                        DecodeAndResizeJpegOp<GPUDevice>);
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+}  // namespace tensorflow
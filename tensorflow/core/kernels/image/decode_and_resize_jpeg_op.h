@@ -0,0 +1,74 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_IMAGE_DECODE_AND_RESIZE_JPEG_OP_H_
+#define TENSORFLOW_CORE_KERNELS_IMAGE_DECODE_AND_RESIZE_JPEG_OP_H_
+
+#include <cstdint>
+
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Where the pixels of an image decoded by DecodeAndResizeJpeg come from. The
+// image is decoded at 1/`ratio` scale, and only within a window of the scaled
+// image that covers the crop window of the original image.
+struct DecodedJpegGeometry {
+  // Offset of the decoded pixels in the buffer of the batch.
+  int64_t offset;
+  int32 crop_y;
+  int32 crop_x;
+  int32 crop_height;
+  int32 crop_width;
+  int32 ratio;
+  int32 decoded_y;
+  int32 decoded_x;
+  int32 decoded_height;
+  int32 decoded_width;
+};
+
+// Returns the coordinate in the decoded pixels of output pixel `out_index`
+// along one dimension: the center of the output pixel is mapped to the crop
+// window of the original image, then to the scaled image. Clamped to the
+// decoded pixels.
+EIGEN_DEVICE_FUNC inline float DecodedCoordinate(int out_index, int out_size,
+                                                 int crop_offset,
+                                                 int crop_size, int ratio,
+                                                 int decoded_offset,
+                                                 int decoded_size) {
+  const float original =
+      crop_offset + (out_index + 0.5f) * crop_size / out_size;
+  const float in = original / ratio - decoded_offset - 0.5f;
+  return Eigen::numext::mini(Eigen::numext::maxi(in, 0.0f),
+                             static_cast<float>(decoded_size - 1));
+}
+
+namespace functor {
+
+// Resizes the images decoded into `decoded`, laid out as described by
+// `geometry` (one per image), into `images` with bilinear interpolation.
+template <typename Device>
+struct ResizeDecodedJpegs {
+  Status operator()(const Device& d, const uint8* decoded,
+                    const DecodedJpegGeometry* geometry,
+                    typename TTypes<float, 4>::Tensor images);
+};
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_IMAGE_DECODE_AND_RESIZE_JPEG_OP_H_
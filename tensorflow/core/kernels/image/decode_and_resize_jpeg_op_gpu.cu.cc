@@ -0,0 +1,96 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#define EIGEN_USE_GPU
+
+#include "tensorflow/core/framework/tensor_types.h"
+#include "tensorflow/core/kernels/image/decode_and_resize_jpeg_op.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/gpu_kernel_helper.h"
+
+namespace tensorflow {
+
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace {
+
+__global__ void ResizeDecodedJpegsKernel(
+    const int64_t nthreads, const uint8* __restrict__ decoded,
+    const DecodedJpegGeometry* __restrict__ geometry, const int out_height,
+    const int out_width, const int channels, float* __restrict__ images) {
+  GPU_1D_KERNEL_LOOP(index, nthreads) {
+    int64_t n = index;
+    const int c = n % channels;
+    n /= channels;
+    const int out_x = n % out_width;
+    n /= out_width;
+    const int out_y = n % out_height;
+    n /= out_height;
+
+    const DecodedJpegGeometry& g = geometry[n];
+    const float in_y =
+        DecodedCoordinate(out_y, out_height, g.crop_y, g.crop_height, g.ratio,
+                          g.decoded_y, g.decoded_height);
+    const float in_x =
+        DecodedCoordinate(out_x, out_width, g.crop_x, g.crop_width, g.ratio,
+                          g.decoded_x, g.decoded_width);
+    const int top = static_cast<int>(in_y);
+    const int bottom = min(top + 1, g.decoded_height - 1);
+    const float y_lerp = in_y - top;
+    const int left = static_cast<int>(in_x);
+    const int right = min(left + 1, g.decoded_width - 1);
+    const float x_lerp = in_x - left;
+
+    const uint8* image = decoded + g.offset;
+    const int64_t row_size = static_cast<int64_t>(g.decoded_width) * channels;
+    const uint8* top_row = image + top * row_size;
+    const uint8* bottom_row = image + bottom * row_size;
+    const float top_left = top_row[left * channels + c];
+    const float top_right = top_row[right * channels + c];
+    const float bottom_left = bottom_row[left * channels + c];
+    const float bottom_right = bottom_row[right * channels + c];
+    const float top_value = top_left + (top_right - top_left) * x_lerp;
+    const float bottom_value =
+        bottom_left + (bottom_right - bottom_left) * x_lerp;
+    images[index] = top_value + (bottom_value - top_value) * y_lerp;
+  }
+}
+
+}  // namespace
+
+namespace functor {
+
+template <>
+Status ResizeDecodedJpegs<GPUDevice>::operator()(
+    const GPUDevice& d, const uint8* decoded,
+    const DecodedJpegGeometry* geometry,
+    typename TTypes<float, 4>::Tensor images) {
+  const int64_t output_size = images.size();
+  if (output_size == 0) return absl::OkStatus();
+  GpuLaunchConfig config = GetGpuLaunchConfig(output_size, d);
+  return GpuLaunchKernel(ResizeDecodedJpegsKernel, config.block_count,
+                         config.thread_per_block, 0, d.stream(),
+                         config.virtual_thread_count, decoded, geometry,
+                         static_cast<int>(images.dimension(1)),
+                         static_cast<int>(images.dimension(2)),
+                         static_cast<int>(images.dimension(3)), images.data());
+}
+
+}  // namespace functor
+}  // namespace tensorflow
+
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
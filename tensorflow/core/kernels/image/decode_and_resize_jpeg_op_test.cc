@@ -0,0 +1,116 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kHeight = 64;
+constexpr int kWidth = 96;
+
+// Encodes an RGB image whose left half is red and right half is blue.
+tstring EncodeHalvesJpeg() {
+  std::vector<uint8> pixels(kHeight * kWidth * 3, 0);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      pixels[(y * kWidth + x) * 3 + (x < kWidth / 2 ? 0 : 2)] = 255;
+    }
+  }
+  jpeg::CompressFlags flags;
+  flags.format = jpeg::FORMAT_RGB;
+  flags.quality = 100;
+  flags.chroma_downsampling = false;
+  return jpeg::Compress(pixels.data(), kWidth, kHeight, flags);
+}
+
+class DecodeAndResizeJpegOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("decode_op", "DecodeAndResizeJpeg")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT32))
+                     .Input(FakeInput(DT_INT32))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Expects pixel (y, x) of image `b` of the output to be `rgb`, up to
+  // compression artifacts.
+  void ExpectPixel(int b, int y, int x, const std::vector<float>& rgb) {
+    auto images = GetOutput(0)->tensor<float, 4>();
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_NEAR(images(b, y, x, c), rgb[c], 8) << b << " " << y << " " << x;
+    }
+  }
+};
+
+TEST_F(DecodeAndResizeJpegOpTest, ResizesWholeImages) {
+  MakeOp();
+  const tstring jpeg = EncodeHalvesJpeg();
+  AddInputFromArray<tstring>(TensorShape({2}), {jpeg, jpeg});
+  AddInputFromArray<int32>(TensorShape({0, 4}), {});
+  // Decoded at 1/8 scale.
+  AddInputFromArray<int32>(TensorShape({2}), {kHeight / 8, kWidth / 8});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_EQ(GetOutput(0)->shape(),
+            TensorShape({2, kHeight / 8, kWidth / 8, 3}));
+  for (int b = 0; b < 2; ++b) {
+    ExpectPixel(b, 0, 0, {255, 0, 0});
+    ExpectPixel(b, kHeight / 8 - 1, kWidth / 8 - 1, {0, 0, 255});
+  }
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, CropsBeforeResizing) {
+  MakeOp();
+  const tstring jpeg = EncodeHalvesJpeg();
+  AddInputFromArray<tstring>(TensorShape({2}), {jpeg, jpeg});
+  // The red half of the first image and the blue half of the second one.
+  AddInputFromArray<int32>(TensorShape({2, 4}),
+                           {0, 0, kHeight, kWidth / 2,  //
+                            0, kWidth / 2, kHeight, kWidth / 2});
+  AddInputFromArray<int32>(TensorShape({2}), {16, 16});
+  TF_ASSERT_OK(RunOpKernel());
+  // Away from the edges of the halves, where the colors bleed.
+  for (int y = 4; y < 12; y += 3) {
+    for (int x = 4; x < 12; x += 3) {
+      ExpectPixel(0, y, x, {255, 0, 0});
+      ExpectPixel(1, y, x, {0, 0, 255});
+    }
+  }
+}
+
+TEST_F(DecodeAndResizeJpegOpTest, RejectsCropWindowsOutsideTheImage) {
+  MakeOp();
+  AddInputFromArray<tstring>(TensorShape({1}), {EncodeHalvesJpeg()});
+  AddInputFromArray<int32>(TensorShape({1, 4}), {0, 1, kHeight, kWidth});
+  AddInputFromArray<int32>(TensorShape({2}), {8, 8});
+  const Status status = RunOpKernel();
+  EXPECT_TRUE(errors::IsInvalidArgument(status));
+  EXPECT_TRUE(absl::StrContains(status.message(), "Invalid crop window"));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -46,10 +46,9 @@ namespace tensorflow {
 //
 // Returns the log of the absolute value of the determinant, and its sign in
 // 'sign'.
-template <class Scalar>
+template <class Scalar, int N>
 static typename Eigen::NumTraits<Scalar>::Real SLogDet(
-    const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& inputs,
-    Scalar* sign) {
+    const Eigen::Matrix<Scalar, N, N>& inputs, Scalar* sign) {
   using RealScalar = typename Eigen::NumTraits<Scalar>::Real;
   RealScalar log_abs_det = 0;
   *sign = 1;
@@ -57,9 +56,8 @@ static typename Eigen::NumTraits<Scalar>::Real SLogDet(
   // (https://en.wikipedia.org/wiki/Determinant)
   if (inputs.size() > 0) {
     // Compute the log determinant through a Partially Pivoted LU decomposition
-    using Eigen::Dynamic;
-    Eigen::PartialPivLU<Eigen::Matrix<Scalar, Dynamic, Dynamic>> lu(inputs);
-    Eigen::Matrix<Scalar, Dynamic, Dynamic> LU = lu.matrixLU();
+    Eigen::PartialPivLU<Eigen::Matrix<Scalar, N, N>> lu(inputs);
+    Eigen::Matrix<Scalar, N, N> LU = lu.matrixLU();
     *sign = lu.permutationP().determinant();
     auto diag = LU.diagonal().array().eval();
     auto abs_diag = diag.cwiseAbs().eval();
@@ -69,6 +67,27 @@ static typename Eigen::NumTraits<Scalar>::Real SLogDet(
   return log_abs_det;
 }
 
+// Calls SLogDet with fixed-size matrices for small inputs, which do not
+// allocate and whose decomposition is fully unrolled, and with dynamic-size
+// matrices otherwise.
+template <class Scalar, class MatrixMap>
+static typename Eigen::NumTraits<Scalar>::Real SLogDet(const MatrixMap& inputs,
+                                                       Scalar* sign) {
+  switch (inputs.rows()) {
+    case 1:
+      return SLogDet(Eigen::Matrix<Scalar, 1, 1>(inputs), sign);
+    case 2:
+      return SLogDet(Eigen::Matrix<Scalar, 2, 2>(inputs), sign);
+    case 3:
+      return SLogDet(Eigen::Matrix<Scalar, 3, 3>(inputs), sign);
+    case 4:
+      return SLogDet(Eigen::Matrix<Scalar, 4, 4>(inputs), sign);
+    default:
+      return SLogDet(
+          Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>(inputs), sign);
+  }
+}
+
 template <class Scalar>
 class LogDeterminantOp : public LinearAlgebraOp<Scalar> {
  public:
@@ -84,9 +103,7 @@ class LogDeterminantOp : public LinearAlgebraOp<Scalar> {
   void ComputeMatrix(OpKernelContext* context, const ConstMatrixMaps& inputs,
                      MatrixMaps* outputs) final {
     Scalar sign;
-    const RealScalar log_abs_det = SLogDet(
-        Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>(inputs[0]),
-        &sign);
+    const RealScalar log_abs_det = SLogDet(inputs[0], &sign);
 
     outputs->at(0)(0, 0) = sign;
     outputs->at(1)(0, 0) = log_abs_det;
@@ -108,9 +125,7 @@ class DeterminantOp : public LinearAlgebraOp<Scalar> {
   void ComputeMatrix(OpKernelContext* context, const ConstMatrixMaps& inputs,
                      MatrixMaps* outputs) final {
     Scalar sign;
-    const RealScalar log_abs_det = SLogDet(
-        Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>(inputs[0]),
-        &sign);
+    const RealScalar log_abs_det = SLogDet(inputs[0], &sign);
     outputs->at(0)(0, 0) = sign * std::exp(log_abs_det);
   }
 };
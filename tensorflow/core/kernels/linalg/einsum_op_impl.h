@@ -21,6 +21,7 @@ limitations under the License.
 #define EIGEN_USE_GPU
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_split.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -416,6 +417,19 @@ struct EinsumHelper {
     return absl::OkStatus();
   }
 
+  // Returns true if the output lists the free labels of the second operand
+  // before those of the first one. Contracting the operands in swapped order
+  // then computes the output in that layout directly, instead of transposing
+  // the contraction result afterwards.
+  static bool ShouldSwapOperands(const OperandLabels& free_labels,
+                                 const Labels& output_labels) {
+    if (free_labels[0].empty() || free_labels[1].empty()) return false;
+    const auto position = [&output_labels](int label) {
+      return absl::c_find(output_labels, label) - output_labels.begin();
+    };
+    return position(free_labels[1].front()) < position(free_labels[0].front());
+  }
+
   // Reshapes a Tensor of shape [b0,b1...bk,N,M] to [prod(b0,b1...bk),N,M].
   static Status ReshapeToRank3(const Tensor& input, int batch_size,
                                Tensor* output) {
@@ -523,6 +537,16 @@ class EinsumOp : public OpKernel {
                          &swap_free_and_contract[i], &inputs_reduced[i]));
     }
 
+    // The contraction output has the free dimensions of the first operand
+    // before those of the second one. Swap the operands if that avoids
+    // transposing it into the output layout.
+    if (num_inputs == 2 &&
+        EinsumHelper::ShouldSwapOperands(free_labels, output_labels)) {
+      std::swap(inputs_reduced[0], inputs_reduced[1]);
+      std::swap(swap_free_and_contract[0], swap_free_and_contract[1]);
+      std::swap(free_labels[0], free_labels[1]);
+    }
+
     // After reduction, the inputs should be reshaped to Tensors suitable for
     // contraction. If num_inputs is 1, the reduced input is simply forwarded to
     // the output.
@@ -51,11 +51,33 @@ class MatrixInverseOp : public LinearAlgebraOp<Scalar> {
   void ComputeMatrix(OpKernelContext* context, const ConstMatrixMaps& inputs,
                      MatrixMaps* outputs) final {
     const ConstMatrixMap& input = inputs[0];
-    if (input.rows() == 0) {
-      // By definition, an empty matrix's inverse is an empty matrix.
-      return;
+    // Small matrices are inverted with fixed-size decompositions, which do not
+    // allocate and are fully unrolled, as their cost is otherwise dominated by
+    // the overhead of the dynamic-size ones.
+    switch (input.rows()) {
+      case 0:
+        // By definition, an empty matrix's inverse is an empty matrix.
+        return;
+      case 1:
+        return ComputeInverse<1>(context, input, &outputs->at(0));
+      case 2:
+        return ComputeInverse<2>(context, input, &outputs->at(0));
+      case 3:
+        return ComputeInverse<3>(context, input, &outputs->at(0));
+      case 4:
+        return ComputeInverse<4>(context, input, &outputs->at(0));
+      default:
+        return ComputeInverse<Eigen::Dynamic>(context, input,
+                                              &outputs->at(0));
     }
-    Eigen::PartialPivLU<Matrix> lu_decomposition;
+  }
+
+ private:
+  template <int N>
+  void ComputeInverse(OpKernelContext* context, const ConstMatrixMap& input,
+                      MatrixMap* output) {
+    Eigen::PartialPivLU<Eigen::Matrix<Scalar, N, N, Eigen::RowMajor>>
+        lu_decomposition;
     if (adjoint_) {
       // TODO(rmlarsen): For Eigen 3.2, this creates a temporary copy.
       // Make sure to backport: https://bitbucket.org/eigen/eigen/commits/
@@ -74,10 +96,9 @@ class MatrixInverseOp : public LinearAlgebraOp<Scalar> {
         lu_decomposition.matrixLU().diagonal().cwiseAbs().minCoeff();
     OP_REQUIRES(context, min_abs_pivot > RealScalar(0),
                 errors::InvalidArgument("Input is not invertible."));
-    outputs->at(0).noalias() = lu_decomposition.inverse();
+    output->noalias() = lu_decomposition.inverse();
   }
 
- private:
   bool adjoint_;
 
   MatrixInverseOp(const MatrixInverseOp&) = delete;
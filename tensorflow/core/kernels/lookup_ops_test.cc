@@ -19,7 +19,9 @@ limitations under the License.
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
@@ -100,5 +102,63 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+class MutableHashTableWithAdmissionTest : public OpsTestBase {
+ protected:
+  // Creates the table and returns it in `table_`.
+  void MakeTable(int64_t admission_threshold, int64_t max_bytes) {
+    TF_ASSERT_OK(NodeDefBuilder("table", "MutableHashTableWithAdmission")
+                     .Attr("key_dtype", DT_INT64)
+                     .Attr("value_dtype", DT_FLOAT)
+                     .Attr("value_shape", TensorShape({2}))
+                     .Attr("admission_threshold", admission_threshold)
+                     .Attr("max_bytes", max_bytes)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    TF_ASSERT_OK(RunOpKernel());
+    TF_ASSERT_OK(LookupResource(
+        context_.get(), GetOutput(0)->scalar<ResourceHandle>()(), &table_));
+  }
+
+  void Insert(int64_t key) {
+    TF_ASSERT_OK(table_->Insert(context_.get(), test::AsTensor<int64_t>({key}),
+                                test::AsTensor<float>({1.0f, 2.0f}, {1, 2})));
+  }
+
+  lookup::LookupInterface::AdmissionStats Stats() {
+    lookup::LookupInterface::AdmissionStats stats;
+    TF_EXPECT_OK(table_->GetAdmissionStats(&stats));
+    return stats;
+  }
+
+  core::RefCountPtr<lookup::LookupInterface> table_;
+};
+
+TEST_F(MutableHashTableWithAdmissionTest, AdmitsFrequentKeys) {
+  MakeTable(/*admission_threshold=*/2, /*max_bytes=*/0);
+  Insert(1);
+  EXPECT_EQ(table_->size(), 0);
+  Insert(1);
+  Insert(1);
+  Insert(2);
+  EXPECT_EQ(table_->size(), 1);
+  EXPECT_EQ(Stats().num_admitted, 1);
+  EXPECT_EQ(Stats().num_rejected, 2);
+  EXPECT_EQ(Stats().num_evicted, 0);
+
+  Tensor values(DT_FLOAT, TensorShape({2, 2}));
+  TF_ASSERT_OK(table_->Find(context_.get(), test::AsTensor<int64_t>({1, 2}),
+                            &values, test::AsTensor<float>({0.0f, 0.0f})));
+  test::ExpectTensorEqual<float>(
+      values, test::AsTensor<float>({1.0f, 2.0f, 0.0f, 0.0f}, {2, 2}));
+}
+
+TEST_F(MutableHashTableWithAdmissionTest, EvictsOverMaxBytes) {
+  MakeTable(/*admission_threshold=*/1, /*max_bytes=*/1);
+  for (int64_t key = 0; key < 3; ++key) Insert(key);
+  EXPECT_EQ(table_->size(), 0);
+  EXPECT_EQ(Stats().num_admitted, 3);
+  EXPECT_EQ(Stats().num_evicted, 3);
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -16,17 +16,27 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -41,6 +51,8 @@ std::string UniqueNodeName(const std::string& base) {
 // required, use MutableHashTableOfTensors.
 //
 // This table is mutable and thread safe - Insert can be called at any time.
+// The keys are striped over shards with their own mutex, so that lookups and
+// inserts from different threads only contend when they touch the same shard.
 //
 // Sample use case:
 //
@@ -56,8 +68,12 @@ class MutableHashTableOfScalars final : public LookupInterface {
   MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
 
   size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.table.size();
+    }
+    return size;
   }
 
   Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
@@ -70,17 +86,22 @@ class MutableHashTableOfScalars final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      // is_full_size_default is true:
-      //   Each key has an independent default value, key_values(i)
-      //   corresponding uses default_flat(i) as its default value.
-      //
-      // is_full_size_default is false:
-      //   All keys will share the default_flat(0) as default value.
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)),
-          is_full_size_default ? default_flat(i) : default_flat(0));
+    ShardedKeys sharded_keys(key_values);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (sharded_keys.empty(s)) continue;
+      const Shard& shard = shards_[s];
+      tf_shared_lock l(shard.mu);
+      for (int64_t i : sharded_keys.indices(s)) {
+        // is_full_size_default is true:
+        //   Each key has an independent default value, key_values(i)
+        //   corresponding uses default_flat(i) as its default value.
+        //
+        // is_full_size_default is false:
+        //   All keys will share the default_flat(0) as default value.
+        value_values(i) = gtl::FindWithDefault(
+            shard.table, SubtleMustCopyIfIntegral(key_values(i)),
+            is_full_size_default ? default_flat(i) : default_flat(0));
+      }
     }
 
     return absl::OkStatus();
@@ -90,13 +111,24 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
+    ShardedKeys sharded_keys(key_values);
     if (clear) {
-      table_.clear();
+      // Imports replace the whole table, so no reader may see a mix of the
+      // old and new contents.
+      gtl::InlinedVector<mutex_lock, kNumShards> locks;
+      for (Shard& shard : shards_) locks.emplace_back(shard.mu);
+      ReplaceLocked(key_values, value_values, sharded_keys);
+      return absl::OkStatus();
     }
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
+    for (int s = 0; s < kNumShards; ++s) {
+      if (sharded_keys.empty(s)) continue;
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      for (int64_t i : sharded_keys.indices(s)) {
+        gtl::InsertOrUpdate(&shard.table,
+                            SubtleMustCopyIfIntegral(key_values(i)),
+                            SubtleMustCopyIfIntegral(value_values(i)));
+      }
     }
     return absl::OkStatus();
   }
@@ -109,9 +141,14 @@ class MutableHashTableOfScalars final : public LookupInterface {
   Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
+    ShardedKeys sharded_keys(key_values);
+    for (int s = 0; s < kNumShards; ++s) {
+      if (sharded_keys.empty(s)) continue;
+      Shard& shard = shards_[s];
+      mutex_lock l(shard.mu);
+      for (int64_t i : sharded_keys.indices(s)) {
+        shard.table.erase(SubtleMustCopyIfIntegral(key_values(i)));
+      }
     }
     return absl::OkStatus();
   }
@@ -122,8 +159,9 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    gtl::InlinedVector<tf_shared_lock, kNumShards> locks;
+    for (const Shard& shard : shards_) locks.emplace_back(shard.mu);
+    int64_t size = SizeLocked();
 
     Tensor* keys;
     Tensor* values;
@@ -145,21 +183,24 @@ class MutableHashTableOfScalars final : public LookupInterface {
 
   int64_t MemoryUsed() const override {
     int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      for (unsigned i = 0; i < shard.table.bucket_count(); ++i) {
+        size_t bucket_size = shard.table.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
       }
     }
     return sizeof(MutableHashTableOfScalars) + ret;
   }
 
   Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    gtl::InlinedVector<tf_shared_lock, kNumShards> locks;
+    for (const Shard& shard : shards_) locks.emplace_back(shard.mu);
+    int64_t size = SizeLocked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size}));
     ExportKeysAndValues(&keys, &values);
@@ -195,21 +236,97 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
  private:
+  static constexpr int kLog2NumShards = 4;
+  static constexpr int kNumShards = 1 << kLog2NumShards;
+
+  struct Shard {
+    mutable mutex mu;
+    std::unordered_map<K, V> table TF_GUARDED_BY(mu);
+  };
+
+  // Returns the shard holding `key`. std::hash is the identity for integers
+  // in common standard libraries, so it is mixed before taking the top bits,
+  // which also keeps the shard independent of the bucket within the shard.
+  static int ShardIndex(const K& key) {
+    const uint64 hash = static_cast<uint64>(std::hash<K>()(key));
+    return (hash * 0x9E3779B97F4A7C15ull) >> (64 - kLog2NumShards);
+  }
+
+  // The indices of a batch of keys grouped by shard, so that each shard is
+  // locked once per batch rather than once per key.
+  class ShardedKeys {
+   public:
+    template <typename KeyFlat>
+    explicit ShardedKeys(const KeyFlat& keys) : indices_(keys.size()) {
+      std::vector<uint8_t> shard_indices(keys.size());
+      std::array<int64_t, kNumShards + 1> counts = {};
+      for (int64_t i = 0; i < keys.size(); ++i) {
+        shard_indices[i] = ShardIndex(SubtleMustCopyIfIntegral(keys(i)));
+        ++counts[shard_indices[i] + 1];
+      }
+      for (int s = 0; s < kNumShards; ++s) {
+        begin_[s] = counts[s] + (s > 0 ? begin_[s - 1] : 0);
+      }
+      begin_[kNumShards] = keys.size();
+      std::array<int64_t, kNumShards> next;
+      std::copy(begin_.begin(), begin_.end() - 1, next.begin());
+      for (int64_t i = 0; i < keys.size(); ++i) {
+        indices_[next[shard_indices[i]]++] = i;
+      }
+    }
+
+    bool empty(int shard) const { return begin_[shard] == begin_[shard + 1]; }
+
+    absl::Span<const int64_t> indices(int shard) const {
+      return absl::MakeConstSpan(indices_.data() + begin_[shard],
+                                 begin_[shard + 1] - begin_[shard]);
+    }
+
+   private:
+    std::vector<int64_t> indices_;
+    std::array<int64_t, kNumShards + 1> begin_;
+  };
+
+  // Callers hold all the shards, which the analysis cannot follow through
+  // the vectors of locks.
+  template <typename KeyFlat, typename ValueFlat>
+  void ReplaceLocked(const KeyFlat& key_values, const ValueFlat& value_values,
+                     const ShardedKeys& sharded_keys)
+      TF_NO_THREAD_SAFETY_ANALYSIS {
+    for (int s = 0; s < kNumShards; ++s) {
+      Shard& shard = shards_[s];
+      shard.table.clear();
+      for (int64_t i : sharded_keys.indices(s)) {
+        gtl::InsertOrUpdate(&shard.table,
+                            SubtleMustCopyIfIntegral(key_values(i)),
+                            SubtleMustCopyIfIntegral(value_values(i)));
+      }
+    }
+  }
+
+  // Callers hold all the shards.
+  int64_t SizeLocked() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    int64_t size = 0;
+    for (const Shard& shard : shards_) size += shard.table.size();
+    return size;
+  }
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
+  // must point to tensors of size `SizeLocked()`.
   void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+      TF_NO_THREAD_SAFETY_ANALYSIS {
     auto keys_data = keys->flat<K>();
     auto values_data = values->flat<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
+    for (const Shard& shard : shards_) {
+      for (auto it = shard.table.begin(); it != shard.table.end(); ++it, ++i) {
+        keys_data(i) = it->first;
+        values_data(i) = it->second;
+      }
     }
   }
 
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
+  std::array<Shard, kNumShards> shards_;
 };
 
 // Lookup table that wraps an unordered_map. Behaves identical to
@@ -408,6 +525,358 @@ class MutableHashTableOfTensors final : public LookupInterface {
   std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
 };
 
+// Count-min sketch estimating how many times each key hash was added. Uses
+// conservative update, i.e. only the smallest counters of a key are
+// incremented, which reduces the overestimates caused by hash collisions.
+class CountMinSketch {
+ public:
+  CountMinSketch(int64_t width, int64_t depth)
+      : width_(width), depth_(depth), counters_(width * depth, 0) {}
+
+  // Adds one occurrence of `hash` and returns its estimated count, including
+  // this occurrence.
+  uint32 Add(uint64 hash) {
+    // Double hashing derives the counter of each row from two halves of the
+    // hash.
+    const uint64 h1 = hash & 0xffffffff;
+    const uint64 h2 = (hash >> 32) | 1;
+    gtl::InlinedVector<uint32*, 8> counters;
+    uint32 estimate = std::numeric_limits<uint32>::max();
+    for (int64_t row = 0; row < depth_; ++row) {
+      counters.push_back(&counters_[row * width_ + (h1 + row * h2) % width_]);
+      estimate = std::min(estimate, *counters.back());
+    }
+    if (estimate == std::numeric_limits<uint32>::max()) return estimate;
+    for (uint32* counter : counters) {
+      if (*counter == estimate) ++*counter;
+    }
+    return estimate + 1;
+  }
+
+  int64_t MemoryUsed() const { return counters_.size() * sizeof(uint32); }
+
+ private:
+  const int64_t width_;
+  const int64_t depth_;
+  std::vector<uint32> counters_;
+};
+
+// Lookup table of vector values like MutableHashTableOfTensors, which bounds
+// its memory for keys that are not known in advance, e.g. the ids of an
+// online-learning embedding.
+//
+// Insert counts new keys in a count-min sketch and only adds them once they
+// were inserted `admission_threshold` times, so that rare keys do not take
+// space. When the entries exceed `max_bytes`, Insert evicts the least recently
+// ("lru") or least frequently ("lfu") used entry out of a few sampled ones
+// until the table fits again. Find and Insert both count as a use.
+//
+// Import restores entries without admission, and the sketch is not part of
+// the exported state: keys rejected before a restore start counting again.
+template <class K, class V>
+class MutableHashTableWithAdmission final : public LookupInterface {
+ public:
+  MutableHashTableWithAdmission(OpKernelContext* ctx, OpKernel* kernel)
+      : generator_(random::New64()) {
+    OP_REQUIRES_OK(ctx,
+                   GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
+    OP_REQUIRES(
+        ctx, TensorShapeUtils::IsVector(value_shape_),
+        errors::InvalidArgument("Default value must be a vector, got shape ",
+                                value_shape_.DebugString()));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "admission_threshold",
+                                    &admission_threshold_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "sketch_width",
+                                    &sketch_width_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "sketch_depth",
+                                    &sketch_depth_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "max_bytes", &max_bytes_));
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "eviction_policy",
+                                    &eviction_policy_));
+    evict_lfu_ = eviction_policy_ == "lfu";
+    sketch_ = std::make_unique<CountMinSketch>(sketch_width_, sketch_depth_);
+  }
+
+  size_t size() const override {
+    tf_shared_lock l(mu_);
+    return table_.size();
+  }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override {
+    const auto default_flat = default_value.flat_inner_dims<V, 2>();
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat_inner_dims<V, 2>();
+    const int64_t value_dim = value_shape_.dim_size(0);
+    const bool is_full_size_default =
+        value_values.size() == default_flat.size();
+
+    tf_shared_lock l(mu_);
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      const Entry* entry =
+          gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
+      if (entry != nullptr) {
+        Touch(*entry);
+        for (int64_t j = 0; j < value_dim; j++) {
+          value_values(i, j) = entry->value[j];
+        }
+      } else {
+        for (int64_t j = 0; j < value_dim; j++) {
+          value_values(i, j) =
+              is_full_size_default ? default_flat(i, j) : default_flat(0, j);
+        }
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                const Tensor& values) override {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat_inner_dims<V, 2>();
+
+    mutex_lock l(mu_);
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto it = table_.find(key);
+      if (it == table_.end()) {
+        const uint32 count = sketch_->Add(KeyHash(key));
+        if (count < admission_threshold_) {
+          ++stats_.num_rejected;
+          continue;
+        }
+        it = table_.try_emplace(key).first;
+        // The count of the sketch carries over the uses before admission.
+        it->second.frequency.store(count - 1, std::memory_order_relaxed);
+        bytes_used_ += EntryBytes(key);
+        ++stats_.num_admitted;
+      }
+      Touch(it->second);
+      SetValue(value_values, i, &it->second);
+    }
+    EvictToFit();
+    return absl::OkStatus();
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+
+    mutex_lock l(mu_);
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      auto it = table_.find(SubtleMustCopyIfIntegral(key_values(i)));
+      if (it == table_.end()) continue;
+      bytes_used_ -= EntryBytes(it->first);
+      table_.erase(it);
+    }
+    return absl::OkStatus();
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat_inner_dims<V, 2>();
+
+    mutex_lock l(mu_);
+    table_.clear();
+    bytes_used_ = 0;
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      const K key = SubtleMustCopyIfIntegral(key_values(i));
+      auto [it, inserted] = table_.try_emplace(key);
+      if (inserted) bytes_used_ += EntryBytes(key);
+      Touch(it->second);
+      SetValue(value_values, i, &it->second);
+    }
+    EvictToFit();
+    return absl::OkStatus();
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override {
+    tf_shared_lock l(mu_);
+    int64_t size = table_.size();
+    int64_t value_dim = value_shape_.dim_size(0);
+
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(ctx->allocate_output(
+        "values", TensorShape({size, value_dim}), &values));
+    ExportKeysAndValues(keys, values);
+    return absl::OkStatus();
+  }
+
+  Status GetAdmissionStats(AdmissionStats* stats) const override {
+    tf_shared_lock l(mu_);
+    *stats = stats_;
+    return absl::OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return value_shape_; }
+
+  int64_t MemoryUsed() const override {
+    tf_shared_lock l(mu_);
+    return sizeof(MutableHashTableWithAdmission) + bytes_used_ +
+           table_.bucket_count() * sizeof(void*) + sketch_->MemoryUsed();
+  }
+
+  Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    tf_shared_lock l(mu_);
+    int64_t size = table_.size();
+    Tensor keys(key_dtype(), TensorShape({size}));
+    Tensor values(value_dtype(), TensorShape({size, value_shape_.dim_size(0)}));
+    ExportKeysAndValues(&keys, &values);
+
+    // As for MutableHashTableOfTensors, use_node_name_sharing with a unique
+    // node name lets the resource outlive the kernel.
+    Node* table = ops::SourceOp(
+        "MutableHashTableWithAdmission",
+        builder->opts()
+            .WithName(UniqueNodeName("MutableHashTableWithAdmission"))
+            .WithAttr("use_node_name_sharing", true)
+            .WithAttr("key_dtype", key_dtype())
+            .WithAttr("value_dtype", value_dtype())
+            .WithAttr("value_shape", value_shape_)
+            .WithAttr("admission_threshold", admission_threshold_)
+            .WithAttr("sketch_width", sketch_width_)
+            .WithAttr("sketch_depth", sketch_depth_)
+            .WithAttr("max_bytes", max_bytes_)
+            .WithAttr("eviction_policy", eviction_policy_));
+    Node* keys_node = ops::SourceOp(
+        "Const",
+        builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
+    Node* values_node =
+        ops::SourceOp("Const", builder->opts()
+                                   .WithAttr("dtype", value_dtype())
+                                   .WithAttr("value", values));
+    Node* import_table =
+        ops::TernaryOp("LookupTableImportV2", table, keys_node, values_node,
+                       builder->opts()
+                           .WithAttr("Tin", key_dtype())
+                           .WithAttr("Tout", value_dtype()));
+    *out = ops::UnaryOp("Identity", table,
+                        builder->opts().WithControlInput(import_table));
+    return absl::OkStatus();
+  }
+
+ private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+
+  struct Entry {
+    ValueArray value;
+    // Updated by Find under the shared lock, hence atomic.
+    mutable std::atomic<int64_t> last_use{0};
+    mutable std::atomic<int64_t> frequency{0};
+  };
+
+  static uint64 KeyHash(const K& key) {
+    if constexpr (std::is_same<K, tstring>::value) {
+      return Hash64(key);
+    } else {
+      return Hash64(reinterpret_cast<const char*>(&key), sizeof(key));
+    }
+  }
+
+  // Approximate bytes held by the entry of `key`: the map node with the key
+  // and the value, and the value elements that are not inlined.
+  int64_t EntryBytes(const K& key) const {
+    int64_t bytes = sizeof(K) + sizeof(Entry) + kNodeOverheadBytes;
+    if (value_shape_.dim_size(0) > ValueArray().capacity()) {
+      bytes += value_shape_.dim_size(0) * sizeof(V);
+    }
+    if constexpr (std::is_same<K, tstring>::value) bytes += key.size();
+    return bytes;
+  }
+
+  void Touch(const Entry& entry) const {
+    entry.last_use.store(clock_.fetch_add(1, std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+    entry.frequency.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template <typename Values>
+  void SetValue(const Values& values, int64_t i, Entry* entry) const {
+    const int64_t value_dim = value_shape_.dim_size(0);
+    entry->value.resize(value_dim);
+    for (int64_t j = 0; j < value_dim; j++) {
+      entry->value[j] = values(i, j);
+    }
+  }
+
+  // Evicts entries until they fit in max_bytes_. Each victim is the least
+  // recently or frequently used of the entries in a few random buckets, which
+  // approximates LRU or LFU without keeping the entries ordered.
+  void EvictToFit() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    while (max_bytes_ > 0 && bytes_used_ > max_bytes_ && !table_.empty()) {
+      const K* victim = nullptr;
+      int64_t victim_score = 0;
+      int num_samples = 0;
+      for (int attempt = 0; attempt < kMaxEvictionAttempts &&
+                            num_samples < kNumEvictionSamples;
+           ++attempt) {
+        const size_t bucket = generator_() % table_.bucket_count();
+        for (auto it = table_.cbegin(bucket); it != table_.cend(bucket);
+             ++it, ++num_samples) {
+          const int64_t score =
+              (evict_lfu_ ? it->second.frequency : it->second.last_use)
+                  .load(std::memory_order_relaxed);
+          if (victim == nullptr || score < victim_score) {
+            victim = &it->first;
+            victim_score = score;
+          }
+        }
+      }
+      auto it = victim != nullptr ? table_.find(*victim) : table_.begin();
+      bytes_used_ -= EntryBytes(it->first);
+      table_.erase(it);
+      ++stats_.num_evicted;
+    }
+  }
+
+  // Writes all keys and values into `keys` and `values`. `keys` and `values`
+  // must point to tensors of size `table_.size()`.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
+      TF_SHARED_LOCKS_REQUIRED(mu_) {
+    int64_t value_dim = value_shape_.dim_size(0);
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->matrix<V>();
+    int64_t i = 0;
+    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
+      keys_data(i) = it->first;
+      for (int64_t j = 0; j < value_dim; j++) {
+        values_data(i, j) = it->second.value[j];
+      }
+    }
+  }
+
+  // Rough size of the next pointer and cached hash of a map node.
+  static constexpr int64_t kNodeOverheadBytes = 2 * sizeof(void*);
+  // Entries compared to pick each victim, and buckets drawn to find them.
+  static constexpr int kNumEvictionSamples = 16;
+  static constexpr int kMaxEvictionAttempts = 64;
+
+  TensorShape value_shape_;
+  int64_t admission_threshold_;
+  int64_t sketch_width_;
+  int64_t sketch_depth_;
+  int64_t max_bytes_;
+  string eviction_policy_;
+  bool evict_lfu_;
+  mutable mutex mu_;
+  std::unordered_map<K, Entry> table_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<CountMinSketch> sketch_ TF_GUARDED_BY(mu_);
+  std::mt19937_64 generator_ TF_GUARDED_BY(mu_);
+  int64_t bytes_used_ TF_GUARDED_BY(mu_) = 0;
+  AdmissionStats stats_ TF_GUARDED_BY(mu_);
+  // Logical time of the last use of the entries.
+  mutable std::atomic<int64_t> clock_{0};
+};
+
 namespace {
 
 template <typename T>
@@ -511,16 +980,13 @@ class MutableDenseHashTable final : public LookupInterface {
     const auto key_matrix = key.shaped<K, 2>({num_elements, key_size});
     auto value_matrix = value->shaped<V, 2>({num_elements, value_size});
     const auto default_flat = default_value.flat<V>();
-
-    tf_shared_lock l(mu_);
-    const auto key_buckets_matrix = key_buckets_.template matrix<K>();
-    const auto value_buckets_matrix = value_buckets_.template matrix<V>();
     const auto empty_key_matrix =
         empty_key_.template shaped<K, 2>({1, key_size});
     const auto deleted_key_matrix =
         deleted_key_.template shaped<K, 2>({1, key_size});
-    const int64_t bit_mask = num_buckets_ - 1;
-    // TODO(andreasst): parallelize using work_sharder
+
+    // Hashing only reads the keys, so it is done before taking the lock.
+    std::vector<uint64> key_hashes(num_elements);
     for (int64_t i = 0; i < num_elements; ++i) {
       const uint64 key_hash = HashKey(key_matrix, i);
       if (empty_key_hash_ == key_hash &&
@@ -533,32 +999,72 @@ class MutableDenseHashTable final : public LookupInterface {
         return errors::InvalidArgument(
             "Using the deleted_key as a table key is not allowed");
       }
-      int64_t bucket_index = key_hash & bit_mask;
-      int64_t num_probes = 0;
-      while (true) {
-        if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            // TODO(andreasst): check if we can get rid of SubtleMustCopy
-            // here and elsewhere in this file.
-            value_matrix(i, j) =
-                SubtleMustCopyIfIntegral(value_buckets_matrix(bucket_index, j));
-          }
-          break;
+      key_hashes[i] = key_hash;
+    }
+
+    tf_shared_lock l(mu_);
+    const auto key_buckets_matrix = key_buckets_.template matrix<K>();
+    const auto value_buckets_matrix = value_buckets_.template matrix<V>();
+    const int64_t num_buckets = num_buckets_;
+    const int64_t bit_mask = num_buckets - 1;
+    std::atomic<bool> probe_overflow(false);
+    auto find_range = [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        // The first probe of a key in a large table is usually a cache miss,
+        // so the home buckets of the following keys are fetched while this
+        // one is probed.
+        if (i + kPrefetchDistance < end) {
+          const int64_t next_index =
+              key_hashes[i + kPrefetchDistance] & bit_mask;
+          port::prefetch<port::PREFETCH_HINT_T0>(
+              &key_buckets_matrix(next_index, 0));
+          port::prefetch<port::PREFETCH_HINT_T0>(
+              &value_buckets_matrix(next_index, 0));
         }
-        if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix, 0)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            value_matrix(i, j) = SubtleMustCopyIfIntegral(default_flat(j));
+        int64_t bucket_index = key_hashes[i] & bit_mask;
+        int64_t num_probes = 0;
+        while (true) {
+          if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
+            for (int64_t j = 0; j < value_size; ++j) {
+              // TODO(andreasst): check if we can get rid of SubtleMustCopy
+              // here and elsewhere in this file.
+              value_matrix(i, j) = SubtleMustCopyIfIntegral(
+                  value_buckets_matrix(bucket_index, j));
+            }
+            break;
+          }
+          if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix,
+                         0)) {
+            for (int64_t j = 0; j < value_size; ++j) {
+              value_matrix(i, j) = SubtleMustCopyIfIntegral(default_flat(j));
+            }
+            break;
+          }
+          ++num_probes;
+          bucket_index =
+              (bucket_index + num_probes) & bit_mask;  // quadratic probing
+          if (num_probes >= num_buckets) {
+            probe_overflow = true;
+            return;
           }
-          break;
-        }
-        ++num_probes;
-        bucket_index =
-            (bucket_index + num_probes) & bit_mask;  // quadratic probing
-        if (num_probes >= num_buckets_) {
-          return errors::Internal(
-              "Internal error in MutableDenseHashTable lookup");
         }
       }
+    };
+    // Readers share the lock, so large batches are split over the intra-op
+    // threads while it is held.
+    const DeviceBase::CpuWorkerThreads* worker_threads =
+        ctx != nullptr && ctx->device() != nullptr
+            ? ctx->device()->tensorflow_cpu_worker_threads()
+            : nullptr;
+    if (worker_threads != nullptr && num_elements >= kMinParallelFindSize) {
+      const int64_t cost_per_key = 10 * (key_size + value_size);
+      Shard(worker_threads->num_threads, worker_threads->workers, num_elements,
+            cost_per_key, find_range);
+    } else {
+      find_range(0, num_elements);
+    }
+    if (probe_overflow) {
+      return errors::Internal("Internal error in MutableDenseHashTable lookup");
     }
     return absl::OkStatus();
   }
@@ -864,6 +1370,12 @@ class MutableDenseHashTable final : public LookupInterface {
     return true;
   }
 
+  // Number of keys ahead of the one being probed whose buckets Find
+  // prefetches.
+  static constexpr int64_t kPrefetchDistance = 8;
+  // Batches smaller than this are looked up on the calling thread.
+  static constexpr int64_t kMinParallelFindSize = 4096;
+
   TensorShape key_shape_;
   TensorShape value_shape_;
   float max_load_factor_;
@@ -1076,6 +1588,33 @@ REGISTER_KERNEL_BUILDER(Name("LookupTableImport").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(Name("LookupTableImportV2").Device(DEVICE_CPU),
                         LookupTableImportOp);
 
+// Op that returns the admission and eviction counters of a table.
+class LookupTableAdmissionStatsOp : public LookupTableOpKernel {
+ public:
+  using LookupTableOpKernel::LookupTableOpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    lookup::LookupInterface* table;
+    OP_REQUIRES_OK(ctx, GetTable(ctx, &table));
+    core::ScopedUnref unref_me(table);
+
+    lookup::LookupInterface::AdmissionStats stats;
+    OP_REQUIRES_OK(ctx, table->GetAdmissionStats(&stats));
+    const std::pair<const char*, int64_t> outputs[] = {
+        {"num_admitted", stats.num_admitted},
+        {"num_rejected", stats.num_rejected},
+        {"num_evicted", stats.num_evicted}};
+    for (const auto& [name, value] : outputs) {
+      Tensor* out;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(name, TensorShape({}), &out));
+      out->scalar<int64_t>()() = value;
+    }
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("LookupTableAdmissionStats").Device(DEVICE_CPU),
+                        LookupTableAdmissionStatsOp);
+
 // Register the HashTable op with the currently supported key and value types.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                           \
   REGISTER_KERNEL_BUILDER(                                                \
@@ -1201,6 +1740,31 @@ REGISTER_KERNEL(tstring, int64_t);
 
 #undef REGISTER_KERNEL
 
+// Register the MutableHashTableWithAdmission op.
+#define REGISTER_KERNEL(key_dtype, value_dtype)                              \
+  REGISTER_KERNEL_BUILDER(                                                   \
+      Name("MutableHashTableWithAdmission")                                  \
+          .Device(DEVICE_CPU)                                                \
+          .TypeConstraint<key_dtype>("key_dtype")                            \
+          .TypeConstraint<value_dtype>("value_dtype"),                       \
+      LookupTableOp<                                                         \
+          lookup::MutableHashTableWithAdmission<key_dtype, value_dtype>,     \
+          key_dtype, value_dtype>)
+
+REGISTER_KERNEL(int32, double);
+REGISTER_KERNEL(int32, float);
+REGISTER_KERNEL(int32, int32);
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(int64_t, int32);
+REGISTER_KERNEL(int64_t, int64_t);
+REGISTER_KERNEL(tstring, double);
+REGISTER_KERNEL(tstring, float);
+REGISTER_KERNEL(tstring, int32);
+REGISTER_KERNEL(tstring, int64_t);
+
+#undef REGISTER_KERNEL
+
 // Register the MutableDenseHashTable op.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                             \
   REGISTER_KERNEL_BUILDER(                                                  \
@@ -775,5 +775,30 @@ BM_BatchMatmul(1, 1, 200, 10000, true, true);
 BM_BatchMatmul(8, 1, 200, 10000, true, true);
 BM_BatchMatmul(32, 1, 200, 10000, true, true);
 
+// The bfloat16 CPU kernels convert to float around the float contraction, so
+// compare both types on the shapes of transformer inference.
+#define BM_BatchMatmulFloatAndBF16(B, M, K, N, TA, TB)           \
+  BM_BatchMatmulDev(B, M, K, N, TA, TB, float, DT_FLOAT, cpu); \
+  BM_BatchMatmulDev(B, M, K, N, TA, TB, bfloat16, DT_BFLOAT16, cpu);
+
+// Projections and feed-forward layers, for 1 (decoding), 32 and 128 tokens.
+BM_BatchMatmulFloatAndBF16(1, 1, 768, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 32, 768, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 128, 768, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 1, 768, 3072, false, false);
+BM_BatchMatmulFloatAndBF16(1, 32, 768, 3072, false, false);
+BM_BatchMatmulFloatAndBF16(1, 128, 768, 3072, false, false);
+BM_BatchMatmulFloatAndBF16(1, 1, 3072, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 32, 3072, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 128, 3072, 768, false, false);
+BM_BatchMatmulFloatAndBF16(1, 1, 4096, 4096, false, false);
+BM_BatchMatmulFloatAndBF16(1, 32, 4096, 4096, false, false);
+
+// Attention scores and values, for 12 heads of size 64 over 128 tokens.
+BM_BatchMatmulFloatAndBF16(12, 128, 64, 128, false, true);
+BM_BatchMatmulFloatAndBF16(12, 128, 128, 64, false, false);
+BM_BatchMatmulFloatAndBF16(12, 1, 64, 128, false, true);
+BM_BatchMatmulFloatAndBF16(12, 1, 128, 64, false, false);
+
 }  // namespace
 }  // namespace tensorflow
@@ -422,6 +422,7 @@ class RandomBinomialOp : public OpKernel {
     auto philox = GetPhiloxRandomFromMem(var_data);
     UpdateMemWithPhiloxRandom(
         philox, num_batches * 2 * 100 * (samples_per_batch + 3) / 4, var_data);
+    var->RecordUpdate();
 
     auto binomial_functor = functor::RandomBinomialFunctor<Device, T, U>();
     binomial_functor(ctx, ctx->eigen_device<Device>(), num_batches,
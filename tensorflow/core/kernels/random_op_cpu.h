@@ -72,6 +72,51 @@ struct FillPhiloxRandom {
   }
 };
 
+// A generator returning groups of samples that were generated ahead of time.
+class PhiloxBlockSamples {
+ public:
+  using ResultType = PhiloxRandom::ResultType;
+  using ResultElementType = PhiloxRandom::ResultElementType;
+  static constexpr int kResultElementCount = PhiloxRandom::kResultElementCount;
+
+  explicit PhiloxBlockSamples(const ResultType* samples) : next_(samples) {}
+
+  ResultType operator()() { return *next_++; }
+
+ private:
+  const ResultType* next_;
+};
+
+// The number of groups of samples generated at a time for the distributions
+// that have a `PhiloxBlockDistribution`.
+constexpr int kPhiloxBlockSize = 8;
+
+// Maps the stateless distributions that turn each group of samples of the
+// generator into one group of outputs to the same distribution over
+// `PhiloxBlockSamples`. Their samples are generated in blocks, which is
+// bit-exact with generating them one group at a time, but lets the Philox
+// rounds vectorize across the groups of a block.
+template <class Distribution>
+struct PhiloxBlockDistribution {
+  static constexpr bool kEnabled = false;
+};
+
+#define REGISTER_PHILOX_BLOCK_DISTRIBUTION(DISTRIBUTION, TYPE)             \
+  template <>                                                              \
+  struct PhiloxBlockDistribution<DISTRIBUTION<PhiloxRandom, TYPE>> {       \
+    static constexpr bool kEnabled = true;                                 \
+    using Type = DISTRIBUTION<PhiloxBlockSamples, TYPE>;                   \
+  }
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::UniformDistribution, Eigen::half);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::UniformDistribution, bfloat16);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::UniformDistribution, float);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::UniformDistribution, double);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::NormalDistribution, Eigen::half);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::NormalDistribution, bfloat16);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::NormalDistribution, float);
+REGISTER_PHILOX_BLOCK_DISTRIBUTION(random::NormalDistribution, double);
+#undef REGISTER_PHILOX_BLOCK_DISTRIBUTION
+
 // A class to fill a specified range of random groups
 template <class Distribution, bool VariableSamplesPerOutput>
 struct FillPhiloxRandomTask;
@@ -90,7 +135,22 @@ struct FillPhiloxRandomTask<Distribution, false> {
 
     // First fill all the full-size groups
     int64_t limit_group_full = std::min(limit_group, size / kGroupSize);
-    for (int64_t index = start_group; index < limit_group_full; ++index) {
+    int64_t index = start_group;
+    if constexpr (PhiloxBlockDistribution<Distribution>::kEnabled) {
+      typename PhiloxBlockDistribution<Distribution>::Type block_dist;
+      PhiloxRandom::ResultType block[kPhiloxBlockSize];
+      for (; index + kPhiloxBlockSize <= limit_group_full;
+           index += kPhiloxBlockSize) {
+        gen.GenerateBlocks<kPhiloxBlockSize>(block);
+        PhiloxBlockSamples block_samples(block);
+        for (int i = 0; i < kPhiloxBlockSize; ++i) {
+          auto samples = block_dist(&block_samples);
+          std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
+          offset += kGroupSize;
+        }
+      }
+    }
+    for (; index < limit_group_full; ++index) {
       auto samples = dist(&gen);
       std::copy(&samples[0], &samples[0] + kGroupSize, data + offset);
       offset += kGroupSize;
@@ -116,6 +116,23 @@ void BM_PhiloxRandom(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PhiloxRandom);
 
+void BM_PhiloxRandomBlocks(::testing::benchmark::State& state) {
+  // Fill 2M random numbers
+  int count = 2 << 20;
+  random::PhiloxRandom gen(0x12345);
+
+  for (auto s : state) {
+    for (int j = 0; j < count; j += 4 * 8) {
+      /// each invocation of GenerateBlocks() returns 8 128-bit samples
+      random::PhiloxRandom::ResultType samples[8];
+      gen.GenerateBlocks<8>(samples);
+      tensorflow::testing::DoNotOptimize(samples);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * count);
+}
+BENCHMARK(BM_PhiloxRandomBlocks);
+
 void BM_StdMTRandom(::testing::benchmark::State& state) {
   // Fill 2M random numbers
   int count = 2 << 20;
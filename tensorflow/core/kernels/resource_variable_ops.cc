@@ -86,6 +86,7 @@ limitations under the License.
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/determinism.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
 
 namespace tensorflow {
@@ -141,6 +142,40 @@ Status CopyVariable(int output_idx, OpKernelContext* ctx, const Tensor* t) {
   return absl::OkStatus();
 }
 
+// Whether dense reads of variables in copy-on-read mode keep their copy as a
+// snapshot of the variable, which is aliased until the variable is updated.
+bool SnapshotCopyOnReadVariables() {
+  static const bool snapshot = [] {
+    bool snapshot;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SNAPSHOT_COPY_ON_READ_VARIABLES",
+                                   /*default_val=*/false, &snapshot));
+    return snapshot;
+  }();
+  return snapshot;
+}
+
+// Outputs a copy of `variable`, which is in copy-on-read mode, or its
+// snapshot. The shared lock of the variable must be held.
+Status ReadCopyOnReadVariable(int output_idx, OpKernelContext* ctx,
+                              Var* variable) {
+  if (!SnapshotCopyOnReadVariables()) {
+    return CopyVariable(output_idx, ctx, variable->tensor());
+  }
+  Tensor snapshot;
+  if (variable->GetSnapshot(&snapshot)) {
+    ctx->set_output(output_idx, snapshot);
+    return absl::OkStatus();
+  }
+  const uint64 version = variable->version();
+  TF_RETURN_IF_ERROR(CopyVariable(output_idx, ctx, variable->tensor()));
+  // Sparse updates may run concurrently under the shared lock, so the copy is
+  // only a consistent snapshot if none of them completed during the copy.
+  if (variable->version() == version) {
+    variable->SetSnapshot(*ctx->mutable_output(output_idx), version);
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 void ReadVariableOp::Compute(OpKernelContext* ctx) {
@@ -168,7 +203,7 @@ void ReadVariableOp::Compute(OpKernelContext* ctx) {
             DataTypeString(dtype_), " got ", DataTypeString(t->dtype())));
     ctx->set_output(0, *t);
   } else {
-    OP_REQUIRES_OK(ctx, CopyVariable(0, ctx, t));
+    OP_REQUIRES_OK(ctx, ReadCopyOnReadVariable(0, ctx, variable.get()));
   }
 }
 
@@ -216,7 +251,7 @@ void ReadVariablesOp::Compute(OpKernelContext* ctx) {
                     " with wrong dtype. Expected ", DataTypeString(dtypes_[i]),
                     " got ", DataTypeString(variables[i]->tensor()->dtype())));
     if (variables[i]->copy_on_read_mode.load()) {
-      OP_REQUIRES_OK(ctx, CopyVariable(i, ctx, variables[i]->tensor()));
+      OP_REQUIRES_OK(ctx, ReadCopyOnReadVariable(i, ctx, variables[i].get()));
     } else {
       const Tensor& t = *variables[i]->tensor();
       ctx->set_output(i, t);
@@ -475,6 +510,7 @@ class AssignVariableOp : public OpKernel {
       *variable->tensor() = value;
     }
     variable->is_initialized = true;
+    variable->RecordUpdate();
   }
 
  private:
@@ -530,6 +566,7 @@ class AssignVariableOp<Device, Variant> : public OpKernel {
                     DataTypeString(DT_VARIANT)));
     variable->is_initialized = true;
     *variable->tensor() = Tensor(DT_VARIANT, value.shape());
+    variable->RecordUpdate();
 
     if (input_alias) {
       *variable->tensor() = *input_alias;
@@ -550,6 +587,7 @@ class AssignVariableOp<Device, Variant> : public OpKernel {
     for (int64_t i = 0; i < elements_in.size(); ++i) {
       elements_out(i) = elements_in(i);
     }
+    variable->RecordUpdate();
   }
 
  private:
@@ -627,6 +665,7 @@ class AssignUpdateVariableOp : public OpKernel {
     functor::DenseUpdate<Device, T, Op> update_functor;
     update_functor(context->eigen_device<Device>(), var_tensor->flat<T>(),
                    value.flat<T>());
+    variable->RecordUpdate();
   }
 };
 
@@ -1129,10 +1168,12 @@ class ResourceScatterUpdateOp : public OpKernel {
     if (is_non_pod_dtype || use_exclusive_lock_) {
       mutex_lock ml(*v->mu());
       DoCompute(c, v.get());
+      v->RecordUpdate();
     } else {
       // For POD dtypes, we can safely run the update without the mutex.
       tf_shared_lock ml(*v->mu());
       DoCompute(c, v.get());
+      v->RecordUpdate();
     }
   }
 
@@ -33,6 +33,8 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -251,6 +253,40 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 
+// Whether restored tensors are deduplicated through the process-wide
+// SharedTensorStore, so that sessions restoring the same values (e.g. several
+// versions of one SavedModel) share their buffers.
+bool ShareRestoredTensors() {
+  static const bool share_restored_tensors = [] {
+    bool flag;
+    Status status = ReadBoolFromEnvVar("TF_SHARE_RESTORED_TENSORS",
+                                       /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "ShareRestoredTensors: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return share_restored_tensors;
+}
+
+// Whether restored tensors alias read-only memory mappings of the checkpoint
+// data files where possible, instead of being copied. See
+// BundleReader::LookupMapped().
+bool MapRestoredTensors() {
+  static const bool map_restored_tensors = [] {
+    bool flag;
+    Status status = ReadBoolFromEnvVar("TF_MMAP_RESTORED_TENSORS",
+                                       /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "MapRestoredTensors: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return map_restored_tensors;
+}
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -301,11 +337,22 @@ struct RestoreOp {
 
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
+    if (shape_and_slice.empty() && MapRestoredTensors()) {
+      Tensor mapped_tensor;
+      bool is_mapped;
+      TF_RETURN_IF_ERROR(
+          reader->LookupMapped(tensor_name, &mapped_tensor, &is_mapped));
+      if (is_mapped) {
+        context->set_output(idx, mapped_tensor);
+        VLOG(1) << "Mapped tensor " << idx << " : " << tensor_name << " : "
+                << restored_full_shape.num_elements();
+        return absl::OkStatus();
+      }
+    }
     Tensor* restored_tensor;
     if (shape_and_slice.empty()) {
       // Lookup the full tensor.
-      TF_RETURN_IF_ERROR(
-          context->allocate_output(idx, restored_full_shape, &restored_tensor));
+      TF_RETURN_IF_ERROR(allocate(restored_full_shape, &restored_tensor));
       TF_RETURN_IF_ERROR(reader->Lookup(tensor_name, restored_tensor));
     } else {
       // Lookup the slice.
@@ -324,30 +371,50 @@ struct RestoreOp {
             " does not match the shape stored in checkpoint: ",
             restored_full_shape.DebugString());
       }
-      TF_RETURN_IF_ERROR(
-          context->allocate_output(idx, parsed_slice_shape, &restored_tensor));
+      TF_RETURN_IF_ERROR(allocate(parsed_slice_shape, &restored_tensor));
       TF_RETURN_IF_ERROR(
           reader->LookupSlice(tensor_name, parsed_slice, restored_tensor));
     }
+    finish(*restored_tensor);
+    return absl::OkStatus();
+  }
+
+  // Allocates the tensor to restore into. When sharing restored tensors, it
+  // is a temporary, which finish() replaces with the shared tensor with the
+  // same contents.
+  Status allocate(const TensorShape& shape, Tensor** restored_tensor) {
+    share = ShareRestoredTensors() && SharedTensorStore::CanDeduplicate(dtype);
+    if (!share) {
+      return context->allocate_output(idx, shape, restored_tensor);
+    }
+    *restored_tensor = &unshared_tensor;
+    return context->allocate_temp(dtype, shape, &unshared_tensor);
+  }
+
+  // Sets the output, once "restored_tensor" (from allocate()) has been read.
+  void finish(const Tensor& restored_tensor) {
     if (VLOG_IS_ON(5)) {
-      if (restored_tensor->dtype() == DT_FLOAT) {
-        const float* t_data = restored_tensor->flat<float>().data();
+      if (restored_tensor.dtype() == DT_FLOAT) {
+        const float* t_data = restored_tensor.flat<float>().data();
         float min = std::numeric_limits<float>::infinity();
         float max = -std::numeric_limits<float>::infinity();
         double avg = 0.0;
-        for (int i = 0; i < restored_tensor->NumElements(); ++i) {
+        for (int i = 0; i < restored_tensor.NumElements(); ++i) {
           if (t_data[i] < min) min = t_data[i];
           if (t_data[i] > max) max = t_data[i];
           avg += t_data[i];
         }
         VLOG(5) << " min " << min << " max " << max << " avg "
-                << avg / restored_tensor->NumElements() << " total elts "
-                << restored_tensor->NumElements();
+                << avg / restored_tensor.NumElements() << " total elts "
+                << restored_tensor.NumElements();
       }
     }
+    if (share) {
+      context->set_output(
+          idx, SharedTensorStore::Global()->Deduplicate(unshared_tensor));
+    }
     VLOG(1) << "Done restoring tensor " << idx << " : " << tensor_name << " : "
-            << restored_full_shape.num_elements();
-    return absl::OkStatus();
+            << restored_tensor.NumElements();
   }
 
   OpKernelContext* context;
@@ -357,6 +424,9 @@ struct RestoreOp {
   string reader_prefix;
   DataType dtype;
 
+  bool share = false;
+  Tensor unshared_tensor;
+
   ::tensorflow::Status status;
 };
 
@@ -456,9 +526,36 @@ Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
       }
     }
 
-    // Read small tensors from the op thread.
+    // Read small tensors from the op thread. Full tensors are looked up
+    // together, so that reads of adjacent tensors are coalesced and issued
+    // concurrently.
+    std::vector<RestoreOp*> batched_ops;
+    std::vector<string> batched_names;
+    std::vector<Tensor*> batched_tensors;
     for (auto* op : small_restore_ops) {
-      TF_RETURN_IF_ERROR(op->run(&default_reader));
+      if (!op->shape_and_slice.empty() || MapRestoredTensors()) {
+        TF_RETURN_IF_ERROR(op->run(&default_reader));
+        continue;
+      }
+      TensorShape restored_full_shape;
+      TF_RETURN_IF_ERROR(default_reader.LookupTensorShape(
+          op->tensor_name, &restored_full_shape));
+      Tensor* restored_tensor;
+      TF_RETURN_IF_ERROR(op->allocate(restored_full_shape, &restored_tensor));
+      batched_ops.push_back(op);
+      batched_names.push_back(op->tensor_name);
+      batched_tensors.push_back(restored_tensor);
+    }
+    if (!batched_ops.empty()) {
+      if (!reader_pool) {
+        reader_pool.reset(
+            new thread::ThreadPool(Env::Default(), "restore_tensors", 8));
+      }
+      TF_RETURN_IF_ERROR(default_reader.LookupMany(
+          batched_names, batched_tensors, reader_pool.get()));
+      for (int i = 0; i < batched_ops.size(); ++i) {
+        batched_ops[i]->finish(*batched_tensors[i]);
+      }
     }
 
     // Wait for all scheduled work to finish and check the status of all
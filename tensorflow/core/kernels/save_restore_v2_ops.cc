@@ -15,24 +15,34 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/strcat.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
@@ -42,6 +52,9 @@ namespace tensorflow {
 
 namespace {
 
+// Shards of a SaveV2 are at least this large.
+constexpr int64_t kMinShardBytes = 8 << 20;
+
 // Shared validations of the inputs to the SaveV2 and RestoreV2 ops.
 void ValidateInputs(bool is_save_op, OpKernelContext* context,
                     const Tensor& prefix, const Tensor& tensor_names,
@@ -90,12 +103,83 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// The SaveV2 ops writing in the background, by checkpoint prefix.
+class BackgroundSaves {
+ public:
+  static BackgroundSaves* Global() {
+    static BackgroundSaves* saves = new BackgroundSaves;
+    return saves;
+  }
+
+  // Records a save to `prefix`, after the previous one finished.
+  void Start(const string& prefix) {
+    mutex_lock l(mu_);
+    WaitLocked(prefix, &l).IgnoreError();
+    saves_[prefix] = {/*done=*/false, absl::OkStatus()};
+  }
+
+  void Finish(const string& prefix, const Status& status) {
+    mutex_lock l(mu_);
+    if (status.ok()) {
+      saves_.erase(prefix);
+    } else {
+      LOG(ERROR) << "Failed to save checkpoint " << prefix << ": " << status;
+      saves_[prefix] = {/*done=*/true, status};
+    }
+    done_.notify_all();
+  }
+
+  // Waits for the save to `prefix`, if any, and returns its status.
+  Status Wait(const string& prefix) {
+    mutex_lock l(mu_);
+    return WaitLocked(prefix, &l);
+  }
+
+ private:
+  struct Save {
+    bool done;
+    Status status;
+  };
+
+  Status WaitLocked(const string& prefix, mutex_lock* l)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto it = saves_.find(prefix);
+    while (it != saves_.end() && !it->second.done) {
+      done_.wait(*l);
+      it = saves_.find(prefix);
+    }
+    if (it == saves_.end()) return absl::OkStatus();
+    Status status = it->second.status;
+    saves_.erase(it);
+    return status;
+  }
+
+  mutex mu_;
+  condition_variable done_;
+  absl::flat_hash_map<string, Save> saves_ TF_GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
+//
+// With TF_SAVE_V2_IN_BACKGROUND=true, the tensors are written from a
+// background thread after the op returns, so the step does not wait for the
+// checkpoint to be written. The tensors of resource variables are copied on
+// write, so holding on to them is enough to snapshot the variables; the
+// tensors of reference variables are copied. MergeV2Checkpoints, RestoreV2 and
+// later saves to the same prefix wait for the background save, and all but
+// later background saves report its errors.
 class SaveV2 : public OpKernel {
  public:
-  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, ReadBoolFromEnvVar("TF_SAVE_V2_IN_BACKGROUND",
+                                               /*default_val=*/false,
+                                               &save_in_background_));
+    OP_REQUIRES_OK(context, ReadInt64FromEnvVar("TF_SAVE_V2_NUM_SHARDS",
+                                                /*default_val=*/1,
+                                                &max_shards_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& prefix = context->input(0);
@@ -111,34 +195,109 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<TensorToSave> tensors(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
+      TensorToSave& to_save = tensors[i];
+      to_save.name = tensor_names_flat(i);
+      to_save.tensor = context->input(i + kFixedInputs);
+      if (save_in_background_ && context->input_is_ref(i + kFixedInputs)) {
+        to_save.tensor = tensor::DeepCopy(to_save.tensor);
+      }
 
       if (!shape_and_slices_flat(i).empty()) {
         const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
         TensorShape slice_shape;
+        to_save.slice = TensorSlice(to_save.tensor.dims());
 
         OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
-        OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
+                                    shape_spec, &to_save.shape, &to_save.slice,
+                                    &slice_shape));
+        const TensorShape& tensor_shape = to_save.tensor.shape();
+        OP_REQUIRES(context, slice_shape.IsSameSize(tensor_shape),
                     errors::InvalidArgument("Slice in shape_and_slice "
                                             "specification does not match the "
                                             "shape of the tensor to  save: ",
                                             shape_spec, ", tensor: ",
-                                            tensor.shape().DebugString()));
+                                            tensor_shape.DebugString()));
+        to_save.is_slice = true;
+      }
+    }
+
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager =
+        nullptr;
+    ResourceMgr* resource_manager = context->resource_manager();
+    if (resource_manager != nullptr) {
+      OP_REQUIRES_OK(
+          context,
+          resource_manager
+              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
+                  resource_manager->default_container(),
+                  std::string(
+                      checkpoint::kCheckpointCallbackManagerResourceName),
+                  &checkpoint_callback_manager,
+                  [](checkpoint::CheckpointCallbackManager** out) {
+                    *out = new checkpoint::CheckpointCallbackManager();
+                    return absl::OkStatus();
+                  }));
+    }
+
+    if (!save_in_background_) {
+      // A save that is still running in the background would race with this
+      // one.
+      Status status = BackgroundSaves::Global()->Wait(prefix_string);
+      if (status.ok()) {
+        status = WriteTensors(prefix_string, tensors, max_shards_);
+      }
+      if (status.ok() && checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Save(prefix_string);
+      }
+      if (checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Unref();
+      }
+      OP_REQUIRES_OK(context, status);
+      return;
+    }
+
+    BackgroundSaves::Global()->Start(prefix_string);
+    Env::Default()->SchedClosure([prefix_string,
+                                  tensors = std::move(tensors),
+                                  max_shards = max_shards_,
+                                  checkpoint_callback_manager]() {
+      Status status = WriteTensors(prefix_string, tensors, max_shards);
+      if (status.ok() && checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Save(prefix_string);
+      }
+      if (checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Unref();
+      }
+      BackgroundSaves::Global()->Finish(prefix_string, status);
+    });
+  }
+
+ private:
+  struct TensorToSave {
+    string name;
+    Tensor tensor;
+    // Whether the tensor is the `slice` of a tensor of shape `shape`.
+    bool is_slice = false;
+    TensorShape shape;
+    TensorSlice slice;
+  };
+
+  static Status WriteBundle(const string& prefix_string,
+                            const std::vector<TensorToSave>& tensors) {
+    BundleWriter writer(Env::Default(), prefix_string);
+    TF_RETURN_IF_ERROR(writer.status());
+    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
 
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
+    for (const TensorToSave& to_save : tensors) {
+      const Tensor& tensor = to_save.tensor;
+      VLOG(2) << "Starting save of " << to_save.name;
+      if (to_save.is_slice) {
+        TF_RETURN_IF_ERROR(writer.AddSlice(to_save.name, to_save.shape,
+                                           to_save.slice, tensor));
       } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
+        TF_RETURN_IF_ERROR(writer.Add(to_save.name, tensor));
       }
 
       if (VLOG_IS_ON(5)) {
@@ -158,30 +317,75 @@ class SaveV2 : public OpKernel {
         }
       }
 
-      VLOG(2) << "Done save of " << tensor_name;
+      VLOG(2) << "Done save of " << to_save.name;
     }
-    OP_REQUIRES_OK(context, writer.Finish());
+    TF_RETURN_IF_ERROR(writer.Finish());
     VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
+    return absl::OkStatus();
+  }
 
-    ResourceMgr* resource_manager = context->resource_manager();
-    if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
-      OP_REQUIRES_OK(
-          context,
-          resource_manager
-              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
-                  resource_manager->default_container(),
-                  std::string(
-                      checkpoint::kCheckpointCallbackManagerResourceName),
-                  &checkpoint_callback_manager,
-                  [](checkpoint::CheckpointCallbackManager** out) {
-                    *out = new checkpoint::CheckpointCallbackManager();
-                    return absl::OkStatus();
-                  }));
-      checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
+  // Writes `tensors` to up to `max_shards` bundles in parallel, which are
+  // then merged into one bundle under `prefix_string`. Large tensor lists are
+  // written as fast as the storage allows rather than as fast as one thread
+  // writes.
+  static Status WriteTensors(const string& prefix_string,
+                             const std::vector<TensorToSave>& tensors,
+                             int64_t max_shards) {
+    // Slices of a tensor are kept together, sharded by their total size.
+    std::map<string, std::vector<int>> names;
+    int64_t total_bytes = 0;
+    for (int i = 0; i < tensors.size(); ++i) {
+      names[tensors[i].name].push_back(i);
+      total_bytes += tensors[i].tensor.TotalBytes();
+    }
+    const int num_shards = std::min<int64_t>(
+        {max_shards, total_bytes / kMinShardBytes,
+         static_cast<int64_t>(names.size())});
+    if (num_shards <= 1) return WriteBundle(prefix_string, tensors);
+
+    std::vector<std::pair<int64_t, const std::vector<int>*>> groups;
+    for (const auto& [name, indices] : names) {
+      int64_t bytes = 0;
+      for (int i : indices) bytes += tensors[i].tensor.TotalBytes();
+      groups.push_back({bytes, &indices});
     }
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first > b.first;
+                     });
+    std::vector<std::vector<TensorToSave>> shards(num_shards);
+    std::vector<int64_t> shard_bytes(num_shards, 0);
+    for (const auto& [bytes, indices] : groups) {
+      const int shard =
+          std::min_element(shard_bytes.begin(), shard_bytes.end()) -
+          shard_bytes.begin();
+      shard_bytes[shard] += bytes;
+      for (int i : *indices) shards[shard].push_back(tensors[i]);
+    }
+
+    std::vector<tstring> shard_prefixes(num_shards);
+    for (int i = 0; i < num_shards; ++i) {
+      shard_prefixes[i] =
+          strings::StrCat(prefix_string, "_temp_part-", i, "-of-", num_shards);
+    }
+    std::vector<Status> statuses(num_shards);
+    BlockingCounter counter(num_shards - 1);
+    for (int i = 1; i < num_shards; ++i) {
+      Env::Default()->SchedClosure([&, i]() {
+        statuses[i] = WriteBundle(shard_prefixes[i], shards[i]);
+        counter.DecrementCount();
+      });
+    }
+    statuses[0] = WriteBundle(shard_prefixes[0], shards[0]);
+    counter.Wait();
+    for (const Status& status : statuses) TF_RETURN_IF_ERROR(status);
+    VLOG(1) << "Merging " << num_shards << " shards into " << prefix_string;
+    return MergeBundles(Env::Default(), shard_prefixes, prefix_string,
+                        /*allow_missing_files=*/false);
   }
+
+  bool save_in_background_;
+  int64_t max_shards_;
 };
 REGISTER_KERNEL_BUILDER(Name("SaveV2").Device(DEVICE_CPU), SaveV2);
 
@@ -205,6 +409,7 @@ class RestoreV2 : public OpKernel {
     if (!context->status().ok()) return;
 
     const string& prefix_string = prefix.scalar<tstring>()();
+    OP_REQUIRES_OK(context, BackgroundSaves::Global()->Wait(prefix_string));
 
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
@@ -285,6 +490,9 @@ class MergeV2Checkpoints : public OpKernel {
 
     const absl::Span<const tstring> input_prefixes =
         absl::Span<const tstring>(checkpoint_prefixes.flat<tstring>());
+    for (const tstring& input_prefix : input_prefixes) {
+      OP_REQUIRES_OK(context, BackgroundSaves::Global()->Wait(input_prefix));
+    }
     Env* env = Env::Default();
     const string& merged_prefix = destination_prefix.scalar<tstring>()();
     OP_REQUIRES_OK(context,
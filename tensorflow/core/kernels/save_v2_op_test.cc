@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
@@ -29,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
@@ -340,5 +342,75 @@ TEST_F(SaveV2OpTest, Simple) {
   }
 }
 
+TEST_F(SaveV2OpTest, SavesInBackground) {
+  tensorflow::setenv("TF_SAVE_V2_IN_BACKGROUND", "true", 1 /* replace */);
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_background");
+  TF_ASSERT_OK(NodeDefBuilder("save", "SaveV2")
+                   .Input(FakeInput())            // prefix
+                   .Input(FakeInput())            // tensor_names
+                   .Input(FakeInput())            // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT}))  // tensors
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  tensorflow::unsetenv("TF_SAVE_V2_IN_BACKGROUND");
+  AddInputFromArray<tstring>(TensorShape({}), {prefix});
+  AddInputFromArray<tstring>(TensorShape({1}), {"tensor_float"});
+  AddInputFromArray<tstring>(TensorShape({1}), {""});
+  AddInputFromArray<float>(TensorShape({4}), {1, 2, 3, 4});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Restoring waits for the save to finish.
+  inputs_.clear();
+  TF_ASSERT_OK(NodeDefBuilder("restore", "RestoreV2")
+                   .Input(FakeInput())  // prefix
+                   .Input(FakeInput())  // tensor_names
+                   .Input(FakeInput())  // shape_and_slices
+                   .Attr("dtypes", {DT_FLOAT})
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<tstring>(TensorShape({}), {prefix});
+  AddInputFromArray<tstring>(TensorShape({1}), {"tensor_float"});
+  AddInputFromArray<tstring>(TensorShape({1}), {""});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({4}));
+  test::FillValues<float>(&expected, {1, 2, 3, 4});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(SaveV2OpTest, WritesShardsInParallel) {
+  tensorflow::setenv("TF_SAVE_V2_NUM_SHARDS", "4", 1 /* replace */);
+  const string prefix = io::JoinPath(testing::TmpDir(), "tensor_sharded");
+  TF_ASSERT_OK(NodeDefBuilder("save", "SaveV2")
+                   .Input(FakeInput())                      // prefix
+                   .Input(FakeInput())                      // tensor_names
+                   .Input(FakeInput())                      // shape_and_slices
+                   .Input(FakeInput({DT_FLOAT, DT_FLOAT}))  // tensors
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  tensorflow::unsetenv("TF_SAVE_V2_NUM_SHARDS");
+  // Two tensors of 8MB, large enough for one shard each.
+  constexpr int kNumElements = 2 << 20;
+  AddInputFromArray<tstring>(TensorShape({}), {prefix});
+  AddInputFromArray<tstring>(TensorShape({2}), {"a", "b"});
+  AddInputFromArray<tstring>(TensorShape({2}), {"", ""});
+  AddInput<float>(TensorShape({kNumElements}),
+                  [](int x) -> float { return x; });
+  AddInput<float>(TensorShape({kNumElements}),
+                  [](int x) -> float { return -x; });
+  TF_ASSERT_OK(RunOpKernel());
+
+  TF_EXPECT_OK(Env::Default()->FileExists(DataFilename(prefix, 1, 2)));
+  BundleReader reader(Env::Default(), prefix);
+  TF_ASSERT_OK(reader.status());
+  Tensor a, b;
+  TF_ASSERT_OK(reader.Lookup("a", &a));
+  TF_ASSERT_OK(reader.Lookup("b", &b));
+  for (int i = 0; i < kNumElements; i += 4099) {
+    EXPECT_EQ(a.flat<float>()(i), i);
+    EXPECT_EQ(b.flat<float>()(i), -i);
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow
@@ -51,8 +51,11 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/bfloat16.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -618,17 +621,12 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
-    // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
-    // accumulation. We create a temp tensor to perform this accumulation for
-    // every segment.
-    Tensor temp;
-    if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
-      TensorShape temp_shape = output_shape;
-      OP_REQUIRES_OK(context, temp_shape.SetDimWithStatus(/*d=*/0, /*size=*/1));
-      temp = tensorflow::Tensor(DT_FLOAT, temp_shape);
-    }
-    auto temp_flat = temp.flat_outer_dims<float>();
-
+    // Finds the segments first, filling the gaps between them with the
+    // default value, so that the segments can then be reduced in parallel.
+    // segment_starts[s] is the position in `indices` of the first index of
+    // the s-th segment, which is reduced into output row segment_rows[s].
+    std::vector<int64_t> segment_starts;
+    std::vector<SegmentId> segment_rows;
     int64_t start = 0, end = 1;
     // Index from which the output is not initialized.
     SegmentId uninitialized_index = 0;
@@ -666,15 +664,8 @@ class SparseSegmentReductionOpBase : public OpKernel {
         gap_slice.setConstant(default_value_);
       }
 
-      auto out = output_flat.template chip<0>(out_index);
-      auto temp = temp_flat.template chip<0>(0);
-      const int bad_offset = Reduce<T, Index>(input_flat, indices_vec, start,
-                                              end - start, out, temp);
-      OP_REQUIRES(context, bad_offset < 0,
-                  errors::InvalidArgument(
-                      "Bad: indices[", start + bad_offset,
-                      "] == ", indices_vec(start + bad_offset),
-                      " out of range [0, ", input_flat.dimension(0), ")"));
+      segment_starts.push_back(start);
+      segment_rows.push_back(out_index);
 
       start = end;
       ++end;
@@ -682,6 +673,47 @@ class SparseSegmentReductionOpBase : public OpKernel {
       out_index = next_index;
       if (end > num_indices) break;
     }
+    segment_starts.push_back(num_indices);
+
+    // Each segment is reduced by one thread, so the result does not depend on
+    // the sharding.
+    mutex bad_offset_mu;
+    int64_t bad_offset = num_indices;
+    auto reduce_segments = [&](int64_t begin_segment, int64_t end_segment) {
+      // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
+      // accumulation. We create a temp tensor to perform this accumulation
+      // for every segment.
+      Tensor temp_tensor;
+      if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
+        temp_tensor = tensorflow::Tensor(DT_FLOAT, TensorShape({1, num_col}));
+      }
+      auto temp_flat = temp_tensor.flat_outer_dims<float>();
+      for (int64_t s = begin_segment; s < end_segment; ++s) {
+        auto out = output_flat.template chip<0>(segment_rows[s]);
+        auto temp = temp_flat.template chip<0>(0);
+        const int64_t segment_start = segment_starts[s];
+        const int64_t offset =
+            Reduce<T, Index>(input_flat, indices_vec, segment_start,
+                             segment_starts[s + 1] - segment_start, out, temp);
+        if (offset >= 0) {
+          mutex_lock l(bad_offset_mu);
+          bad_offset = std::min(bad_offset, segment_start + offset);
+          return;
+        }
+      }
+    };
+    const int64_t num_segments = segment_rows.size();
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int64_t cost_per_segment =
+        (num_indices / num_segments + 1) * num_col * sizeof(T);
+    Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+          cost_per_segment, reduce_segments);
+    OP_REQUIRES(context, bad_offset == num_indices,
+                errors::InvalidArgument(
+                    "Bad: indices[", bad_offset, "] == ",
+                    indices_vec(bad_offset), " out of range [0, ",
+                    input_flat.dimension(0), ")"));
 
     // Fill the gap at the end with the default value.
     if (uninitialized_index < output_rows) {
@@ -719,6 +751,59 @@ class SparseSegmentReductionOpBase : public OpKernel {
     return input_flat.template chip<0>(index).template cast<float>();
   }
 
+  // Sums the `num` rows of `input_flat` starting at `first`.
+  template <typename Tin, EnableIfNotBfloat16OrHalf<Tin> = 0>
+  EIGEN_ALWAYS_INLINE auto sum_rows(
+      const typename TTypes<Tin>::ConstMatrix& input_flat, int64_t first,
+      int64_t num) {
+    const Eigen::DSizes<Eigen::DenseIndex, 2> offsets(first, 0);
+    const Eigen::DSizes<Eigen::DenseIndex, 2> extents(num,
+                                                      input_flat.dimension(1));
+    return input_flat.slice(offsets, extents)
+        .sum(Eigen::array<Eigen::DenseIndex, 1>({0}));
+  }
+
+  template <typename Tin, EnableIfBfloat16OrHalf<Tin> = 0>
+  EIGEN_ALWAYS_INLINE auto sum_rows(
+      const typename TTypes<Tin>::ConstMatrix& input_flat, int64_t first,
+      int64_t num) {
+    const Eigen::DSizes<Eigen::DenseIndex, 2> offsets(first, 0);
+    const Eigen::DSizes<Eigen::DenseIndex, 2> extents(num,
+                                                      input_flat.dimension(1));
+    return input_flat.slice(offsets, extents)
+        .template cast<float>()
+        .sum(Eigen::array<Eigen::DenseIndex, 1>({0}));
+  }
+
+  // Returns whether the indices of a segment are consecutive rows, as when
+  // sorted unique indices cover a contiguous range.
+  template <typename Tindex>
+  static bool IsConsecutive(
+      const typename TTypes<Tindex>::ConstVec& indices_vec, int64_t start,
+      int64_t num) {
+    const Tindex first = indices_vec(start);
+    for (int64_t i = 1; i < num; ++i) {
+      if (indices_vec(start + i) != first + i) return false;
+    }
+    return true;
+  }
+
+  // Prefetches the first cache line of the rows of `num` indices, leaving the
+  // rest of each row to the hardware prefetcher.
+  template <typename Tin, typename Tindex>
+  static void PrefetchRows(
+      const typename TTypes<Tin>::ConstMatrix& input_flat,
+      const typename TTypes<Tindex>::ConstVec& indices_vec, int64_t start,
+      int64_t num) {
+    if (input_flat.dimension(1) == 0) return;
+    for (int64_t i = 0; i < num; ++i) {
+      const Tindex index = indices_vec(start + i);
+      if (FastBoundsCheck(index, input_flat.dimension(0))) {
+        port::prefetch<port::PREFETCH_HINT_T0>(&input_flat(index, 0));
+      }
+    }
+  }
+
   template <typename Tout>
   EIGEN_ALWAYS_INLINE Tout get_scaling_factor(int64_t num) {
     Tout m(1);
@@ -767,6 +852,23 @@ class SparseSegmentReductionOpBase : public OpKernel {
 
 #define L(n) fetch_val<Tin, Tindex>(input_flat, index##n)
 
+    // Consecutive rows are summed as one block, which reads them
+    // sequentially instead of gathering them one by one.
+    if (num > 1 && IsConsecutive<Tindex>(indices_vec, start, num)) {
+      const Tindex first = indices_vec(start);
+      if (!FastBoundsCheck(first, input_flat.dimension(0))) return 0;
+      const int64_t num_in_range = input_flat.dimension(0) - first;
+      if (num > num_in_range) return num_in_range;
+      out = sum_rows<Tin>(input_flat, first, num) * scaling_factor;
+      if (is_mean_ && num >= 10) {
+        out = out / static_cast<Tout>(num);
+      }
+      if (is_sqrtn_ && num >= 10) {
+        out = out / static_cast<Tout>(sqrt(num));
+      }
+      return -1;
+    }
+
     if (num == 1) {
       INDEX(0, 0);
       out = L(0);
@@ -856,6 +958,9 @@ class SparseSegmentReductionOpBase : public OpKernel {
         }
       }
       for (; r < num; r += 8) {
+        // Fetches the rows of the next iteration while these are summed.
+        PrefetchRows<Tin, Tindex>(input_flat, indices_vec, start + r + 8,
+                                  std::min<int64_t>(8, num - r - 8));
         INDEX(0, r);
         INDEX(1, r + 1);
         INDEX(2, r + 2);
@@ -290,4 +290,91 @@ BENCHMARK(BM_SparseSegmentMeanGrad_High_FP16)
     ->Arg(1000)
     ->Arg(100000);
 
+
+// Embedding lookups: gathers kNumIndices rows of a table with num_cols
+// columns into segments of kSegmentSize rows. The rows are either scattered
+// over the table or, as for sorted unique indices, consecutive.
+template <DataType T>
+static void SparseSegmentReductionHelper(::testing::benchmark::State& state,
+                                         const string& op, bool consecutive,
+                                         int num_cols) {
+  typedef typename EnumToDataType<T>::Type DT;
+  Graph* g = new Graph(OpRegistry::Global());
+
+  const int kNumRows = 1 << 16;
+  const int kNumIndices = 1 << 14;
+  const int kSegmentSize = 16;
+  Tensor input(T, TensorShape({kNumRows, num_cols}));
+  input.flat<DT>().setRandom();
+  Tensor indices(DT_INT32, TensorShape({kNumIndices}));
+  auto indices_flat = indices.flat<int32>();
+  Tensor segments(DT_INT32, TensorShape({kNumIndices}));
+  auto segments_flat = segments.flat<int32>();
+  for (int i = 0; i < kNumIndices; ++i) {
+    indices_flat(i) = consecutive ? i : (i * 7919) % kNumRows;
+    segments_flat(i) = i / kSegmentSize;
+  }
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), op)
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, indices))
+                  .Input(test::graph::Constant(g, segments))
+                  .Attr("T", T)
+                  .Finalize(g, &node));
+
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          kNumIndices * num_cols * sizeof(DT));
+}
+
+static void BM_SparseSegmentSum_Scattered_FP32(
+    ::testing::benchmark::State& state) {
+  SparseSegmentReductionHelper<DT_FLOAT>(state, "SparseSegmentSum",
+                                         /*consecutive=*/false, state.range(0));
+}
+
+static void BM_SparseSegmentSum_Consecutive_FP32(
+    ::testing::benchmark::State& state) {
+  SparseSegmentReductionHelper<DT_FLOAT>(state, "SparseSegmentSum",
+                                         /*consecutive=*/true, state.range(0));
+}
+
+static void BM_SparseSegmentMean_Scattered_FP32(
+    ::testing::benchmark::State& state) {
+  SparseSegmentReductionHelper<DT_FLOAT>(state, "SparseSegmentMean",
+                                         /*consecutive=*/false, state.range(0));
+}
+
+static void BM_SparseSegmentSum_Scattered_BF16(
+    ::testing::benchmark::State& state) {
+  SparseSegmentReductionHelper<DT_BFLOAT16>(
+      state, "SparseSegmentSum", /*consecutive=*/false, state.range(0));
+}
+
+BENCHMARK(BM_SparseSegmentSum_Scattered_FP32)
+    ->UseRealTime()
+    ->Arg(64)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
+BENCHMARK(BM_SparseSegmentSum_Consecutive_FP32)
+    ->UseRealTime()
+    ->Arg(64)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
+BENCHMARK(BM_SparseSegmentMean_Scattered_FP32)
+    ->UseRealTime()
+    ->Arg(64)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
+BENCHMARK(BM_SparseSegmentSum_Scattered_BF16)
+    ->UseRealTime()
+    ->Arg(64)
+    ->Arg(128)
+    ->Arg(256)
+    ->Arg(512);
+
 }  // namespace tensorflow
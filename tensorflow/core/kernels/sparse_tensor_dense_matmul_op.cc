@@ -19,12 +19,16 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/sparse_tensor_dense_matmul_op.h"
 
+#include <vector>
+
 #include "Eigen/Core"  // from @eigen_archive
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/kernels/fill_functor.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/prefetch.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -322,6 +326,116 @@ Status SparseTensorDenseMatMulImpl(
   }
   return absl::OkStatus();
 }
+
+// Products with fewer multiply-adds than this are computed serially.
+constexpr int64_t kMinParallelMultiplyAdds = 1 << 18;
+
+// Computes the same `out` as SparseTensorDenseMatMulImpl on the CPU worker
+// threads. The nonzeros of `a` are grouped by output row, keeping their input
+// order within a row: that is the compressed sparse row layout of `a` (or of
+// its adjoint). Panels of output rows are then computed in parallel, each row
+// summing its products in the same order as the serial loop does.
+template <typename T, typename Tsum, typename Tindices, bool ADJ_A, bool ADJ_B>
+Status ParallelSparseTensorDenseMatMulImpl(
+    OpKernelContext* ctx, typename TTypes<Tsum>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  const std::size_t nnz = a_values.size();
+  const std::size_t rhs_right = (ADJ_B ? b.dimension(0) : b.dimension(1));
+  const std::size_t lhs_right = (ADJ_B ? b.dimension(1) : b.dimension(0));
+  const int lhs_index_a = ADJ_A ? 1 : 0;
+  const int rhs_index_a = ADJ_A ? 0 : 1;
+  const int64_t num_rows = out.dimension(0);
+
+  // Check the indices in the same order as the serial loop, so that the same
+  // error is reported, and count the nonzeros of each output row.
+  std::vector<Tindices> rows(nnz);
+  std::vector<Tindices> cols(nnz);
+  std::vector<int64_t> row_starts(num_rows + 1, 0);
+  for (std::size_t i = 0; i < nnz; ++i) {
+    const Tindices m = internal::SubtleMustCopy(a_indices(i, lhs_index_a));
+    const Tindices k = internal::SubtleMustCopy(a_indices(i, rhs_index_a));
+    if (!FastBoundsCheck(k, lhs_right)) {
+      return KOutOfBoundsError(k, i, rhs_index_a, lhs_right);
+    }
+    if (!FastBoundsCheck(m, num_rows)) {
+      return MOutOfBoundsError(m, i, lhs_index_a, num_rows);
+    }
+    rows[i] = m;
+    cols[i] = k;
+    ++row_starts[m + 1];
+  }
+  for (int64_t m = 0; m < num_rows; ++m) {
+    row_starts[m + 1] += row_starts[m];
+  }
+  // The columns and values of the nonzeros of each row, in input order.
+  std::vector<Tindices> row_cols(nnz);
+  std::vector<Tsum> row_values(nnz);
+  {
+    std::vector<int64_t> next(row_starts.begin(), row_starts.end() - 1);
+    for (std::size_t i = 0; i < nnz; ++i) {
+      const int64_t p = next[rows[i]]++;
+      row_cols[p] = cols[i];
+      row_values[p] =
+          static_cast<Tsum>(ADJ_A ? MaybeConj(a_values(i)) : a_values(i));
+    }
+  }
+
+  // Rows of the (adjoint of the) right-hand side, contiguous in memory.
+  Eigen::Tensor<T, 2, Eigen::RowMajor> adjoint_b;
+  const T* b_data = b.data();
+  if (ADJ_B) {
+    Eigen::array<int, 2> shuffle{1, 0};
+    adjoint_b = Eigen::Tensor<T, 2, Eigen::RowMajor>(lhs_right, rhs_right);
+    adjoint_b.device(ctx->eigen_device<CPUDevice>()) =
+        b.shuffle(shuffle).conjugate();
+    b_data = adjoint_b.data();
+  }
+
+  auto compute_rows = [&](int64_t start, int64_t limit) {
+    for (int64_t m = start; m < limit; ++m) {
+      Tsum* out_row = &out(m, 0);
+      for (int64_t p = row_starts[m]; p < row_starts[m + 1]; ++p) {
+        // Fetch the row of the next nonzero while this one is accumulated.
+        if (p + 1 < row_starts[m + 1]) {
+          port::prefetch<port::PREFETCH_HINT_T0>(b_data +
+                                                 row_cols[p + 1] * rhs_right);
+        }
+        const T* b_row = b_data + row_cols[p] * rhs_right;
+        const Tsum a_value = row_values[p];
+        for (std::size_t n = 0; n < rhs_right; ++n) {
+          out_row[n] += a_value * static_cast<Tsum>(b_row[n]);
+        }
+      }
+    }
+  };
+  const int64_t cost_per_row =
+      2 * static_cast<int64_t>(nnz * rhs_right) / num_rows + 1;
+  const DeviceBase::CpuWorkerThreads& worker_threads =
+      *ctx->device()->tensorflow_cpu_worker_threads();
+  Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+        cost_per_row, compute_rows);
+  return absl::OkStatus();
+}
+
+// Computes `out` serially or, for large enough products, in parallel.
+template <typename T, typename Tsum, typename Tindices, bool ADJ_A, bool ADJ_B>
+Status SparseTensorDenseMatMulOnCPU(
+    OpKernelContext* ctx, typename TTypes<Tsum>::Matrix out,
+    typename TTypes<Tindices>::ConstMatrix a_indices,
+    typename TTypes<T>::ConstVec a_values, typename TTypes<T>::ConstMatrix b) {
+  const int64_t rhs_right = ADJ_B ? b.dimension(0) : b.dimension(1);
+  const int num_threads =
+      ctx->device()->tensorflow_cpu_worker_threads()->num_threads;
+  if (num_threads > 1 && out.dimension(0) > 1 &&
+      a_values.size() * rhs_right >= kMinParallelMultiplyAdds) {
+    return ParallelSparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A,
+                                               ADJ_B>(ctx, out, a_indices,
+                                                      a_values, b);
+  }
+  return SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+      out, a_indices, a_values, b);
+}
 }  // namespace
 
 template <typename T, typename Tindices, bool ADJ_A, bool ADJ_B>
@@ -339,8 +453,8 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
       auto temp_out = temp_out_t.matrix<Tsum>();
       temp_out.setZero();
       TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              temp_out, a_indices, a_values, b));
+          SparseTensorDenseMatMulOnCPU<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+              ctx, temp_out, a_indices, a_values, b));
       out = temp_out.template cast<T>();
     } else {
       out.setZero();
@@ -349,8 +463,8 @@ struct SparseTensorDenseMatMulFunctor<CPUDevice, T, Tindices, ADJ_A, ADJ_B> {
       auto out_workaround =
           *reinterpret_cast<typename TTypes<Tsum>::Matrix*>(&out);
       TF_RETURN_IF_ERROR(
-          SparseTensorDenseMatMulImpl<T, Tsum, Tindices, ADJ_A, ADJ_B>(
-              out_workaround, a_indices, a_values, b));
+          SparseTensorDenseMatMulOnCPU<T, Tsum, Tindices, ADJ_A, ADJ_B>(
+              ctx, out_workaround, a_indices, a_values, b));
     }
     return absl::OkStatus();
   }
@@ -64,6 +64,50 @@ Tensor GetTestTensor(int batch) {
   return t;
 }
 
+class StringSplitOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(bool skip_empty) {
+    TF_ASSERT_OK(NodeDefBuilder("string_split_op", "StringSplit")
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_STRING))
+                     .Attr("skip_empty", skip_empty)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(StringSplitOpTest, SplitsOnEachCharacterOfTheDelimiter) {
+  MakeOp(/*skip_empty=*/false);
+  AddInputFromArray<tstring>(TensorShape({2}), {"a b,c", "d\xe9" "e,,"});
+  AddInputFromArray<tstring>(TensorShape({}), {" ,\xe9"});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({0, 0, 0, 1, 0, 2, 1, 0, 1, 1, 1, 2, 1, 3},
+                              TensorShape({7, 2})));
+  test::ExpectTensorEqual<tstring>(
+      *GetOutput(1),
+      test::AsTensor<tstring>({"a", "b", "c", "d", "e", "", ""}));
+  test::ExpectTensorEqual<int64_t>(*GetOutput(2),
+                                   test::AsTensor<int64_t>({2, 4}));
+}
+
+TEST_F(StringSplitOpTest, SkipsEmptyTokens) {
+  MakeOp(/*skip_empty=*/true);
+  AddInputFromArray<tstring>(TensorShape({3}), {",a,,b,", "", ",,"});
+  AddInputFromArray<tstring>(TensorShape({}), {",;"});
+  TF_ASSERT_OK(RunOpKernel());
+
+  test::ExpectTensorEqual<int64_t>(
+      *GetOutput(0),
+      test::AsTensor<int64_t>({0, 0, 0, 1}, TensorShape({2, 2})));
+  test::ExpectTensorEqual<tstring>(*GetOutput(1),
+                                   test::AsTensor<tstring>({"a", "b"}));
+  test::ExpectTensorEqual<int64_t>(*GetOutput(2),
+                                   test::AsTensor<int64_t>({3, 2}));
+}
+
 Graph* SetupStringSplitGraph(const Tensor& input) {
   Graph* g = new Graph(OpRegistry::Global());
   Tensor delim(DT_STRING, TensorShape({}));
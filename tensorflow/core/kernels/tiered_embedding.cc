@@ -0,0 +1,124 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/tiered_embedding.h"
+
+#include <algorithm>
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+TieredEmbeddingCache::TieredEmbeddingCache(int64_t num_slots)
+    : row_of_slot_(num_slots, -1),
+      dirty_(num_slots, false),
+      referenced_(num_slots, false),
+      last_batch_(num_slots, 0) {}
+
+Status TieredEmbeddingCache::Lookup(absl::Span<const int64_t> rows,
+                                    Batch* batch) {
+  const absl::flat_hash_set<int64_t> distinct_rows(rows.begin(), rows.end());
+  if (static_cast<int64_t>(distinct_rows.size()) > num_slots()) {
+    return errors::ResourceExhausted(
+        "A batch of ", distinct_rows.size(),
+        " distinct rows does not fit in a cache of ", num_slots(), " rows");
+  }
+
+  ++batch_;
+  batch->slots.resize(rows.size());
+  for (int64_t i = 0; i < rows.size(); ++i) {
+    const int64_t row = rows[i];
+    int32 slot;
+    auto it = slot_of_row_.find(row);
+    if (it != slot_of_row_.end()) {
+      slot = it->second;
+    } else {
+      slot = NextVictim();
+      const int64_t victim_row = row_of_slot_[slot];
+      if (victim_row >= 0) {
+        if (dirty_[slot]) {
+          batch->write_back_rows.push_back(victim_row);
+          batch->write_back_slots.push_back(slot);
+        }
+        slot_of_row_.erase(victim_row);
+      }
+      row_of_slot_[slot] = row;
+      dirty_[slot] = false;
+      slot_of_row_[row] = slot;
+      batch->load_rows.push_back(row);
+      batch->load_slots.push_back(slot);
+    }
+    referenced_[slot] = true;
+    last_batch_[slot] = batch_;
+    batch->slots[i] = slot;
+  }
+  return absl::OkStatus();
+}
+
+int32 TieredEmbeddingCache::NextVictim() {
+  // Terminates within two turns of the hand, as Lookup checked that some
+  // slots are not used by the batch.
+  while (true) {
+    const int32 slot = hand_;
+    hand_ = (hand_ + 1) % num_slots();
+    if (last_batch_[slot] == batch_) continue;
+    if (row_of_slot_[slot] < 0 || !referenced_[slot]) return slot;
+    referenced_[slot] = false;
+  }
+}
+
+void TieredEmbeddingCache::MarkDirty(absl::Span<const int32> slots) {
+  for (const int32 slot : slots) dirty_[slot] = true;
+}
+
+void TieredEmbeddingCache::TakeDirty(Batch* batch) {
+  for (int32 slot = 0; slot < num_slots(); ++slot) {
+    if (!dirty_[slot]) continue;
+    batch->write_back_rows.push_back(row_of_slot_[slot]);
+    batch->write_back_slots.push_back(slot);
+    dirty_[slot] = false;
+  }
+}
+
+void TieredEmbeddingCache::Clear() {
+  std::fill(row_of_slot_.begin(), row_of_slot_.end(), -1);
+  std::fill(dirty_.begin(), dirty_.end(), false);
+  std::fill(referenced_.begin(), referenced_.end(), false);
+  slot_of_row_.clear();
+}
+
+TieredEmbedding::TieredEmbedding(DataType dtype, const TensorShape& shape,
+                                 int64_t cache_rows)
+    : dtype_(dtype),
+      shape_(shape),
+      host_table_(cpu_allocator(), dtype, shape),
+      cache_slots_(cache_rows) {}
+
+std::string TieredEmbedding::DebugString() const {
+  return absl::StrCat("TieredEmbedding(", DataTypeString(dtype_), ", ",
+                      shape_.DebugString(), ")");
+}
+
+int64_t TieredEmbedding::MemoryUsed() const {
+  tf_shared_lock l(mu_);
+  return host_table_.AllocatedBytes() +
+         (cache_.IsInitialized() ? cache_.AllocatedBytes() : 0);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,134 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_TIERED_EMBEDDING_H_
+#define TENSORFLOW_CORE_KERNELS_TIERED_EMBEDDING_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/resource_base.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Maps the rows of an embedding table to the slots of a smaller cache of hot
+// rows. Slots are reused with the CLOCK approximation of LRU, and never for
+// rows of the batch being looked up. Not thread safe.
+class TieredEmbeddingCache {
+ public:
+  explicit TieredEmbeddingCache(int64_t num_slots);
+
+  // Slots assigned to a batch of rows, and the rows moved between the tiers
+  // to assign them.
+  struct Batch {
+    // Slot of each row of the batch.
+    std::vector<int32> slots;
+    // Rows to load from the host table, and the slots to load them into.
+    std::vector<int64_t> load_rows;
+    std::vector<int32> load_slots;
+    // Updated rows evicted from the cache, and the slots that held them.
+    // They must be written back to the host table before the loads.
+    std::vector<int64_t> write_back_rows;
+    std::vector<int32> write_back_slots;
+  };
+
+  // Assigns a slot to each of `rows`. Returns ResourceExhausted, and changes
+  // nothing, if the batch has more distinct rows than the cache has slots.
+  Status Lookup(absl::Span<const int64_t> rows, Batch* batch);
+
+  // Marks the rows in `slots` as updated in the cache.
+  void MarkDirty(absl::Span<const int32> slots);
+
+  // Fills the write-back fields of `batch` with all the updated rows, and
+  // marks them clean.
+  void TakeDirty(Batch* batch);
+
+  // Drops all the rows from the cache without writing them back.
+  void Clear();
+
+  int64_t num_slots() const { return row_of_slot_.size(); }
+
+ private:
+  // Returns the next slot to reuse.
+  int32 NextVictim();
+
+  // Row held by each slot, or -1.
+  std::vector<int64_t> row_of_slot_;
+  std::vector<bool> dirty_;
+  // CLOCK reference bits.
+  std::vector<bool> referenced_;
+  // Last batch that used each slot.
+  std::vector<int64_t> last_batch_;
+  absl::flat_hash_map<int64_t, int32> slot_of_row_;
+  int32 hand_ = 0;
+  int64_t batch_ = 0;
+};
+
+// Embedding variable whose rows live in host memory, with a cache of hot rows
+// in the memory of the device that runs its kernels. Kernels on the device
+// gather from and add to the cached rows; missed rows are loaded and updated
+// rows evicted from the cache are written back in one transfer per kernel.
+// On CPU, the kernels use the host table directly.
+class TieredEmbedding : public ResourceBase {
+ public:
+  TieredEmbedding(DataType dtype, const TensorShape& shape,
+                  int64_t cache_rows);
+
+  std::string DebugString() const override;
+  int64_t MemoryUsed() const override;
+
+  DataType dtype() const { return dtype_; }
+  const TensorShape& shape() const { return shape_; }
+  mutex* mu() TF_LOCK_RETURNED(mu_) { return &mu_; }
+
+  bool is_initialized() const TF_SHARED_LOCKS_REQUIRED(mu_) {
+    return is_initialized_;
+  }
+  void set_initialized() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    is_initialized_ = true;
+  }
+
+  // The full table, in host memory.
+  Tensor* host_table() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return &host_table_;
+  }
+  // The cached rows, in device memory. Uninitialized until the first kernel
+  // on the device allocates it.
+  Tensor* cache() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return &cache_; }
+  TieredEmbeddingCache* cache_slots() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return &cache_slots_;
+  }
+
+ private:
+  const DataType dtype_;
+  const TensorShape shape_;
+  mutable mutex mu_;
+  bool is_initialized_ TF_GUARDED_BY(mu_) = false;
+  Tensor host_table_ TF_GUARDED_BY(mu_);
+  Tensor cache_ TF_GUARDED_BY(mu_);
+  TieredEmbeddingCache cache_slots_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_TIERED_EMBEDDING_H_
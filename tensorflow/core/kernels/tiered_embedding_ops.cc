@@ -0,0 +1,438 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Kernels of the TieredEmbedding variable. See tiered_embedding.h.
+
+#define EIGEN_USE_THREADS
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#define EIGEN_USE_GPU
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/bounds_check.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/gather_functor.h"
+#include "tensorflow/core/kernels/scatter_functor.h"
+#include "tensorflow/core/kernels/tiered_embedding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+typedef Eigen::GpuDevice GPUDevice;
+
+namespace {
+
+template <typename T>
+Status CheckDtype(TieredEmbedding* table) {
+  if (table->dtype() != DataTypeToEnum<T>::v()) {
+    return errors::InvalidArgument(
+        "Trying to access a tiered embedding with wrong dtype. Expected ",
+        DataTypeString(table->dtype()), " got ",
+        DataTypeString(DataTypeToEnum<T>::v()));
+  }
+  return absl::OkStatus();
+}
+
+// Reads the rows of `indices`, and checks that they are in the table.
+template <typename Index>
+Status GetRows(const Tensor& indices, int64_t num_rows,
+               std::vector<int64_t>* rows) {
+  const auto indices_flat = indices.flat<Index>();
+  rows->resize(indices_flat.size());
+  for (int64_t i = 0; i < indices_flat.size(); ++i) {
+    const Index row = internal::SubtleMustCopy(indices_flat(i));
+    if (!FastBoundsCheck(row, num_rows)) {
+      return errors::InvalidArgument("indices[", i, "] = ", row,
+                                     " is not in [0, ", num_rows, ")");
+    }
+    (*rows)[i] = row;
+  }
+  return absl::OkStatus();
+}
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+// Copies `values` to a new int32 tensor on the device of `ctx`.
+Status CopySlotsToDevice(OpKernelContext* ctx, const std::vector<int32>& values,
+                         Tensor* device_values) {
+  const TensorShape shape({static_cast<int64_t>(values.size())});
+  AllocatorAttributes host_attr;
+  host_attr.set_on_host(true);
+  host_attr.set_gpu_compatible(true);
+  Tensor host_values;
+  TF_RETURN_IF_ERROR(
+      ctx->allocate_temp(DT_INT32, shape, &host_values, host_attr));
+  std::copy(values.begin(), values.end(), host_values.flat<int32>().data());
+  TF_RETURN_IF_ERROR(ctx->allocate_temp(DT_INT32, shape, device_values));
+  return ctx->op_device_context()->CopyCPUTensorToDeviceSync(
+      &host_values, static_cast<Device*>(ctx->device()), device_values);
+}
+
+// Moves the rows of `batch` between the tiers of `table`: writes the evicted
+// updated rows back to the host table, then loads the missed rows into the
+// cache. Each direction is one transfer between staging tensors, so that the
+// cost of a batch does not depend on the number of rows it moves.
+template <typename T>
+Status MoveRows(OpKernelContext* ctx, TieredEmbedding* table,
+                const TieredEmbeddingCache::Batch& batch)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(*table->mu()) {
+  DeviceContext* device_context = ctx->op_device_context();
+  Device* device = static_cast<Device*>(ctx->device());
+  Tensor* cache = table->cache();
+  const int64_t cache_rows = cache->dim_size(0);
+  const int64_t dim = cache->dim_size(1);
+  auto host_table = table->host_table()->matrix<T>();
+  AllocatorAttributes host_attr;
+  host_attr.set_on_host(true);
+  host_attr.set_gpu_compatible(true);
+
+  if (!batch.write_back_slots.empty()) {
+    const int64_t num_rows = batch.write_back_slots.size();
+    Tensor slots;
+    TF_RETURN_IF_ERROR(
+        CopySlotsToDevice(ctx, batch.write_back_slots, &slots));
+    Tensor rows;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                          TensorShape({num_rows, dim}), &rows));
+    const Tensor& cache_params = *cache;
+    functor::GatherFunctor<GPUDevice, T, int32> gather;
+    gather(ctx, cache_params.shaped<T, 3>({1, cache_rows, dim}),
+           std::as_const(slots).flat<int32>(),
+           rows.shaped<T, 3>({1, num_rows, dim}));
+    Tensor host_rows;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(
+        DataTypeToEnum<T>::v(), rows.shape(), &host_rows, host_attr));
+    TF_RETURN_IF_ERROR(device_context->CopyDeviceTensorToCPUSync(
+        &rows, "TieredEmbeddingWriteBack", device, &host_rows));
+    const auto host_rows_matrix = host_rows.matrix<T>();
+    for (int64_t i = 0; i < num_rows; ++i) {
+      std::copy_n(&host_rows_matrix(i, 0), dim,
+                  &host_table(batch.write_back_rows[i], 0));
+    }
+  }
+
+  if (!batch.load_slots.empty()) {
+    const int64_t num_rows = batch.load_slots.size();
+    Tensor host_rows;
+    TF_RETURN_IF_ERROR(ctx->allocate_temp(DataTypeToEnum<T>::v(),
+                                          TensorShape({num_rows, dim}),
+                                          &host_rows, host_attr));
+    auto host_rows_matrix = host_rows.matrix<T>();
+    for (int64_t i = 0; i < num_rows; ++i) {
+      std::copy_n(&host_table(batch.load_rows[i], 0), dim,
+                  &host_rows_matrix(i, 0));
+    }
+    Tensor rows;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_temp(DataTypeToEnum<T>::v(), host_rows.shape(), &rows));
+    TF_RETURN_IF_ERROR(
+        device_context->CopyCPUTensorToDeviceSync(&host_rows, device, &rows));
+    Tensor slots;
+    TF_RETURN_IF_ERROR(CopySlotsToDevice(ctx, batch.load_slots, &slots));
+    functor::ScatterFunctor<GPUDevice, T, int32, scatter_op::UpdateOp::ASSIGN>
+        scatter;
+    scatter(ctx, ctx->eigen_device<GPUDevice>(), cache->matrix<T>(),
+            std::as_const(rows).matrix<T>(),
+            std::as_const(slots).flat<int32>());
+  }
+  return absl::OkStatus();
+}
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+// Looks up the table of input 0 and the rows of input 1. On devices, makes
+// sure that the rows are cached, and returns their slots in device memory.
+template <typename Device, typename T, typename Index>
+Status PrepareBatch(OpKernelContext* ctx, TieredEmbedding* table,
+                    std::vector<int64_t>* rows,
+                    TieredEmbeddingCache::Batch* batch, Tensor* device_slots)
+    TF_EXCLUSIVE_LOCKS_REQUIRED(*table->mu()) {
+  TF_RETURN_IF_ERROR(CheckDtype<T>(table));
+  if (!table->is_initialized()) {
+    return errors::FailedPrecondition(
+        "Attempting to use an uninitialized tiered embedding: ",
+        HandleFromInput(ctx, 0).name());
+  }
+  TF_RETURN_IF_ERROR(
+      GetRows<Index>(ctx->input(1), table->shape().dim_size(0), rows));
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  if constexpr (std::is_same<Device, GPUDevice>::value) {
+    Tensor* cache = table->cache();
+    if (!cache->IsInitialized()) {
+      TF_RETURN_IF_ERROR(ctx->allocate_temp(
+          table->dtype(),
+          TensorShape({table->cache_slots()->num_slots(),
+                       table->shape().dim_size(1)}),
+          cache));
+    }
+    TF_RETURN_IF_ERROR(table->cache_slots()->Lookup(*rows, batch));
+    TF_RETURN_IF_ERROR(MoveRows<T>(ctx, table, *batch));
+    TF_RETURN_IF_ERROR(CopySlotsToDevice(ctx, batch->slots, device_slots));
+  }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+class TieredEmbeddingVarHandleOp : public OpKernel {
+ public:
+  explicit TieredEmbeddingVarHandleOp(OpKernelConstruction* ctx)
+      : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("dtype", &dtype_));
+    PartialTensorShape shape;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("shape", &shape));
+    OP_REQUIRES(ctx, shape.dims() == 2 && shape.AsTensorShape(&shape_),
+                errors::InvalidArgument(
+                    "Tiered embeddings must have a fully defined matrix "
+                    "shape, got ",
+                    shape.DebugString()));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("cache_rows", &cache_rows_));
+    OP_REQUIRES(ctx, cache_rows_ <= std::numeric_limits<int32>::max(),
+                errors::InvalidArgument("cache_rows is too large: ",
+                                        cache_rows_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    ContainerInfo cinfo;
+    OP_REQUIRES_OK(ctx, cinfo.Init(ctx->resource_manager(), def(),
+                                   /*use_node_name_as_default=*/true));
+    TieredEmbedding* table = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->resource_manager()->LookupOrCreate<TieredEmbedding>(
+                 cinfo.container(), cinfo.name(), &table,
+                 [this](TieredEmbedding** ret) {
+                   *ret = new TieredEmbedding(dtype_, shape_, cache_rows_);
+                   return absl::OkStatus();
+                 }));
+    core::ScopedUnref unref(table);
+    Tensor* handle;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({}), &handle));
+    handle->scalar<ResourceHandle>()() = MakeResourceHandle<TieredEmbedding>(
+        ctx, cinfo.container(), cinfo.name(),
+        std::vector<DtypeAndPartialTensorShape>{
+            {dtype_, PartialTensorShape(shape_.dim_sizes())}});
+  }
+
+ private:
+  DataType dtype_;
+  TensorShape shape_;
+  int64_t cache_rows_;
+};
+
+template <typename Device, typename T>
+class AssignTieredEmbeddingOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<TieredEmbedding> table;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &table));
+    OP_REQUIRES_OK(ctx, CheckDtype<T>(table.get()));
+    const Tensor& value = ctx->input(1);
+    OP_REQUIRES(ctx, value.shape() == table->shape(),
+                errors::InvalidArgument(
+                    "Trying to assign a value of shape ",
+                    value.shape().DebugString(), " to a tiered embedding of ",
+                    "shape ", table->shape().DebugString()));
+    mutex_lock l(*table->mu());
+    table->host_table()->flat<T>() = value.flat<T>();
+    table->cache_slots()->Clear();
+    table->set_initialized();
+  }
+};
+
+template <typename Device, typename T>
+class ReadTieredEmbeddingOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<TieredEmbedding> table;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &table));
+    OP_REQUIRES_OK(ctx, CheckDtype<T>(table.get()));
+    mutex_lock l(*table->mu());
+    OP_REQUIRES(ctx, table->is_initialized(),
+                errors::FailedPrecondition(
+                    "Attempting to read an uninitialized tiered embedding: ",
+                    HandleFromInput(ctx, 0).name()));
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    if constexpr (std::is_same<Device, GPUDevice>::value) {
+      if (table->cache()->IsInitialized()) {
+        TieredEmbeddingCache::Batch batch;
+        table->cache_slots()->TakeDirty(&batch);
+        OP_REQUIRES_OK(ctx, MoveRows<T>(ctx, table.get(), batch));
+      }
+    }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    Tensor* value;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, table->shape(), &value));
+    value->flat<T>() = table->host_table()->flat<T>();
+  }
+};
+
+template <typename Device, typename T, typename Index>
+class TieredEmbeddingGatherOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<TieredEmbedding> table;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &table));
+    const Tensor& indices = ctx->input(1);
+    const int64_t dim = table->shape().dim_size(1);
+    TensorShape output_shape = indices.shape();
+    OP_REQUIRES_OK(ctx, output_shape.AddDimWithStatus(dim));
+    Tensor* output;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(0, output_shape, &output));
+    const int64_t num_rows = indices.NumElements();
+    if (num_rows == 0) return;
+
+    mutex_lock l(*table->mu());
+    std::vector<int64_t> rows;
+    TieredEmbeddingCache::Batch batch;
+    Tensor slots;
+    OP_REQUIRES_OK(ctx, (PrepareBatch<Device, T, Index>(ctx, table.get(),
+                                                        &rows, &batch,
+                                                        &slots)));
+    auto out = output->shaped<T, 3>({1, num_rows, dim});
+    if constexpr (std::is_same<Device, CPUDevice>::value) {
+      const Tensor& params = *table->host_table();
+      functor::GatherFunctor<CPUDevice, T, Index> gather;
+      gather(ctx, params.shaped<T, 3>({1, table->shape().dim_size(0), dim}),
+             indices.flat<Index>(), out);
+    }
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    if constexpr (std::is_same<Device, GPUDevice>::value) {
+      const Tensor& cache = *table->cache();
+      functor::GatherFunctor<GPUDevice, T, int32> gather;
+      gather(ctx, cache.shaped<T, 3>({1, cache.dim_size(0), dim}),
+             std::as_const(slots).flat<int32>(), out);
+    }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  }
+};
+
+template <typename Device, typename T, typename Index>
+class TieredEmbeddingScatterAddOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void Compute(OpKernelContext* ctx) override {
+    core::RefCountPtr<TieredEmbedding> table;
+    OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &table));
+    const Tensor& indices = ctx->input(1);
+    const Tensor& updates = ctx->input(2);
+    const int64_t dim = table->shape().dim_size(1);
+    const int64_t num_rows = indices.NumElements();
+    OP_REQUIRES(ctx, updates.NumElements() == num_rows * dim,
+                errors::InvalidArgument(
+                    "updates must have shape indices.shape + [", dim,
+                    "], got ", updates.shape().DebugString()));
+    if (num_rows == 0) return;
+
+    mutex_lock l(*table->mu());
+    std::vector<int64_t> rows;
+    TieredEmbeddingCache::Batch batch;
+    Tensor slots;
+    OP_REQUIRES_OK(ctx, (PrepareBatch<Device, T, Index>(ctx, table.get(),
+                                                        &rows, &batch,
+                                                        &slots)));
+    const auto updates_matrix = updates.shaped<T, 2>({num_rows, dim});
+    if constexpr (std::is_same<Device, CPUDevice>::value) {
+      functor::ScatterFunctor<CPUDevice, T, Index, scatter_op::UpdateOp::ADD>
+          scatter;
+      scatter(ctx, ctx->eigen_device<CPUDevice>(),
+              table->host_table()->matrix<T>(), updates_matrix,
+              indices.flat<Index>());
+    }
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    if constexpr (std::is_same<Device, GPUDevice>::value) {
+      functor::ScatterFunctor<GPUDevice, T, int32, scatter_op::UpdateOp::ADD>
+          scatter;
+      scatter(ctx, ctx->eigen_device<GPUDevice>(), table->cache()->matrix<T>(),
+              updates_matrix, std::as_const(slots).flat<int32>());
+      table->cache_slots()->MarkDirty(batch.slots);
+    }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("TieredEmbeddingVarHandleOp").Device(DEVICE_CPU),
+                        TieredEmbeddingVarHandleOp);
+
+#define REGISTER_KERNELS_INDEX(dev, type, index_type)                   \
+  REGISTER_KERNEL_BUILDER(Name("TieredEmbeddingGather")                 \
+                              .Device(DEVICE_##dev)                     \
+                              .HostMemory("resource")                   \
+                              .HostMemory("indices")                    \
+                              .TypeConstraint<type>("dtype")            \
+                              .TypeConstraint<index_type>("Tindices"),  \
+                          TieredEmbeddingGatherOp<dev##Device, type,    \
+                                                  index_type>);         \
+  REGISTER_KERNEL_BUILDER(Name("TieredEmbeddingScatterAdd")             \
+                              .Device(DEVICE_##dev)                     \
+                              .HostMemory("resource")                   \
+                              .HostMemory("indices")                    \
+                              .TypeConstraint<type>("dtype")            \
+                              .TypeConstraint<index_type>("Tindices"),  \
+                          TieredEmbeddingScatterAddOp<dev##Device, type, \
+                                                      index_type>);
+
+#define REGISTER_KERNELS(dev, type)                                     \
+  REGISTER_KERNEL_BUILDER(Name("AssignTieredEmbedding")                 \
+                              .Device(DEVICE_##dev)                     \
+                              .HostMemory("resource")                   \
+                              .HostMemory("value")                      \
+                              .TypeConstraint<type>("dtype"),           \
+                          AssignTieredEmbeddingOp<dev##Device, type>);  \
+  REGISTER_KERNEL_BUILDER(Name("ReadTieredEmbedding")                   \
+                              .Device(DEVICE_##dev)                     \
+                              .HostMemory("resource")                   \
+                              .HostMemory("value")                      \
+                              .TypeConstraint<type>("dtype"),           \
+                          ReadTieredEmbeddingOp<dev##Device, type>);    \
+  REGISTER_KERNELS_INDEX(dev, type, int32);                             \
+  REGISTER_KERNELS_INDEX(dev, type, int64_t);
+
+REGISTER_KERNELS(CPU, float);
+REGISTER_KERNELS(CPU, double);
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+REGISTER_KERNEL_BUILDER(Name("TieredEmbeddingVarHandleOp")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("resource"),
+                        TieredEmbeddingVarHandleOp);
+
+REGISTER_KERNELS(GPU, float);
+REGISTER_KERNELS(GPU, double);
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+#undef REGISTER_KERNELS
+#undef REGISTER_KERNELS_INDEX
+
+}  // namespace tensorflow
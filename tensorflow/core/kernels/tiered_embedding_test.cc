@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/tiered_embedding.h"
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(TieredEmbeddingCacheTest, LoadsMissedRowsOnce) {
+  TieredEmbeddingCache cache(/*num_slots=*/4);
+  TieredEmbeddingCache::Batch batch;
+  TF_ASSERT_OK(cache.Lookup({7, 3, 7}, &batch));
+  EXPECT_EQ(batch.slots[0], batch.slots[2]);
+  EXPECT_NE(batch.slots[0], batch.slots[1]);
+  EXPECT_THAT(batch.load_rows, ElementsAre(7, 3));
+  EXPECT_THAT(batch.load_slots, ElementsAre(batch.slots[0], batch.slots[1]));
+
+  TieredEmbeddingCache::Batch hit;
+  TF_ASSERT_OK(cache.Lookup({3}, &hit));
+  EXPECT_THAT(hit.slots, ElementsAre(batch.slots[1]));
+  EXPECT_THAT(hit.load_rows, IsEmpty());
+}
+
+TEST(TieredEmbeddingCacheTest, WritesBackDirtyRowsOnEviction) {
+  TieredEmbeddingCache cache(/*num_slots=*/2);
+  TieredEmbeddingCache::Batch batch;
+  TF_ASSERT_OK(cache.Lookup({0, 1}, &batch));
+  cache.MarkDirty({batch.slots[0]});
+
+  // The rows of the batch are not evicted for each other.
+  TieredEmbeddingCache::Batch evicting;
+  TF_ASSERT_OK(cache.Lookup({2, 3}, &evicting));
+  EXPECT_THAT(evicting.load_rows, ElementsAre(2, 3));
+  EXPECT_THAT(evicting.write_back_rows, ElementsAre(0));
+  EXPECT_THAT(evicting.write_back_slots, ElementsAre(batch.slots[0]));
+}
+
+TEST(TieredEmbeddingCacheTest, EvictsLeastRecentlyUsedRows) {
+  TieredEmbeddingCache cache(/*num_slots=*/3);
+  TieredEmbeddingCache::Batch batch;
+  TF_ASSERT_OK(cache.Lookup({0, 1, 2}, &batch));
+  TieredEmbeddingCache::Batch other;
+  TF_ASSERT_OK(cache.Lookup({3}, &other));
+  EXPECT_THAT(other.slots, ElementsAre(batch.slots[0]));
+  TF_ASSERT_OK(cache.Lookup({1}, &other));
+
+  // Row 2 is the only row not used since the first batch.
+  TieredEmbeddingCache::Batch evicting;
+  TF_ASSERT_OK(cache.Lookup({4}, &evicting));
+  EXPECT_THAT(evicting.slots, ElementsAre(batch.slots[2]));
+}
+
+TEST(TieredEmbeddingCacheTest, TakesDirtyRows) {
+  TieredEmbeddingCache cache(/*num_slots=*/4);
+  TieredEmbeddingCache::Batch batch;
+  TF_ASSERT_OK(cache.Lookup({5, 6}, &batch));
+  cache.MarkDirty({batch.slots[1]});
+  TieredEmbeddingCache::Batch dirty;
+  cache.TakeDirty(&dirty);
+  EXPECT_THAT(dirty.write_back_rows, ElementsAre(6));
+  EXPECT_THAT(dirty.write_back_slots, ElementsAre(batch.slots[1]));
+  dirty = TieredEmbeddingCache::Batch();
+  cache.TakeDirty(&dirty);
+  EXPECT_THAT(dirty.write_back_rows, IsEmpty());
+}
+
+TEST(TieredEmbeddingCacheTest, RejectsBatchesLargerThanTheCache) {
+  TieredEmbeddingCache cache(/*num_slots=*/2);
+  TieredEmbeddingCache::Batch batch;
+  EXPECT_TRUE(
+      absl::IsResourceExhausted(cache.Lookup({0, 1, 2, 1}, &batch)));
+  EXPECT_THAT(batch.load_rows, IsEmpty());
+  TF_ASSERT_OK(cache.Lookup({0, 1, 0}, &batch));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <memory>
 #include <numeric>
 #include <vector>
 
@@ -127,6 +128,125 @@ class TopK : public OpKernel {
   bool sorted_;
 };
 
+namespace {
+
+// Rows shorter than this are not split into chunks selected in parallel.
+constexpr int64_t kMinColsPerChunk = 16 * 1024;
+
+// Returns a comparator that orders the columns of `input_data` by decreasing
+// value, breaking ties by increasing column.
+template <typename T, typename Tidx>
+auto StableColumnComparator(const T* input_data) {
+  return [input_data](const Tidx a, const Tidx b) {
+    if (input_data[b] < input_data[a]) {
+      return true;
+    } else if (input_data[b] > input_data[a]) {
+      return false;
+    } else {
+      return a < b;
+    }
+  };
+}
+
+// Pushes the columns [start, limit) of `input_data` to `filter`, which keeps
+// the top k. Once `filter` is full, blocks of columns whose values are all
+// below its bottom are skipped after a branch-free scan, which the compiler
+// can vectorize; only the blocks that may hold a better column are pushed.
+template <typename T, typename Tidx, typename Filter>
+void PushColumns(const T* input_data, Tidx start, Tidx limit, int k,
+                 Filter* filter) {
+  static constexpr Tidx kBlockSize = 16;
+  Tidx c = start;
+  for (; c < limit && filter->size() < static_cast<size_t>(k); ++c) {
+    filter->push(c);
+  }
+  for (; limit - c >= kBlockSize; c += kBlockSize) {
+    const T threshold = input_data[filter->peek_bottom()];
+    bool any_candidate = false;
+    for (Tidx j = 0; j < kBlockSize; ++j) {
+      any_candidate |= !(input_data[c + j] < threshold);
+    }
+    if (any_candidate) {
+      for (Tidx j = 0; j < kBlockSize; ++j) {
+        filter->push(c + j);
+      }
+    }
+  }
+  for (; c < limit; ++c) {
+    filter->push(c);
+  }
+}
+
+// Selects the top k columns of rows too few to keep the worker threads busy:
+// each row is split into `num_chunks` chunks whose top k are selected in
+// parallel, then the top k of each row are selected among those of its
+// chunks. Ties are broken by column, so the result is the same as selecting
+// over the whole row.
+template <typename T, typename Tidx>
+void TopKInRowChunks(const DeviceBase::CpuWorkerThreads& worker_threads,
+                     bool sorted, int k,
+                     const typename TTypes<T, 2>::ConstTensor& input,
+                     int64_t num_rows, int64_t num_cols, int64_t num_chunks,
+                     typename TTypes<T, 2>::Tensor values,
+                     typename TTypes<Tidx, 2>::Tensor indices) {
+  using Comparator = decltype(StableColumnComparator<T, Tidx>(nullptr));
+  const int64_t chunk_size = (num_cols + num_chunks - 1) / num_chunks;
+  const double cmp_cost = 3 * Eigen::TensorOpCost::AddCost<Tidx>() +
+                          Eigen::TensorOpCost::AddCost<T>();
+  const double log_k = Eigen::numext::log2(static_cast<float>(k + 1));
+
+  // The top k columns of each chunk of each row, unsorted.
+  std::vector<Tidx> candidates(num_rows * num_chunks * k);
+  std::vector<int64_t> num_candidates(num_rows * num_chunks);
+  Shard(worker_threads.num_threads, worker_threads.workers,
+        num_rows * num_chunks,
+        static_cast<int64_t>(cmp_cost * chunk_size * log_k),
+        [&](int64_t start, int64_t limit) {
+          for (int64_t i = start; i < limit; ++i) {
+            const int64_t row = i / num_chunks;
+            const int64_t begin =
+                std::min(num_cols, (i % num_chunks) * chunk_size);
+            const int64_t end = std::min(num_cols, begin + chunk_size);
+            const T* input_data = &input(row, 0);
+            gtl::TopN<Tidx, Comparator> filter(
+                k, StableColumnComparator<T, Tidx>(input_data));
+            PushColumns(input_data, static_cast<Tidx>(begin),
+                        static_cast<Tidx>(end), k, &filter);
+            num_candidates[i] = filter.size();
+            std::copy(filter.unsorted_begin(), filter.unsorted_end(),
+                      &candidates[i * k]);
+          }
+        });
+
+  Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
+        static_cast<int64_t>(cmp_cost * num_chunks * k * log_k),
+        [&](int64_t start, int64_t limit) {
+          for (int64_t row = start; row < limit; ++row) {
+            gtl::TopN<Tidx, Comparator> filter(
+                k, StableColumnComparator<T, Tidx>(&input(row, 0)));
+            filter.reserve(num_chunks * k);
+            for (int64_t i = row * num_chunks; i < (row + 1) * num_chunks;
+                 ++i) {
+              for (int64_t j = 0; j < num_candidates[i]; ++j) {
+                filter.push(candidates[i * k + j]);
+              }
+            }
+            if (sorted) {
+              std::unique_ptr<std::vector<Tidx>> top_k(filter.Extract());
+              std::copy(top_k->begin(), top_k->end(), &indices(row, 0));
+            } else {
+              std::copy(filter.unsorted_begin(), filter.unsorted_end(),
+                        &indices(row, 0));
+            }
+            std::transform(
+                &indices(row, 0), &indices(row, k), &values(row, 0),
+                [row, &input](const Tidx loc) { return input(row, loc); });
+          }
+        });
+}
+
+}  // namespace
+
 namespace functor {
 
 template <typename T, typename Tidx>
@@ -161,6 +281,20 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
       return absl::OkStatus();
     }
 
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+    // With fewer rows than threads, split long rows so that all the threads
+    // take part. Each chunk keeps at least 4 * k columns, so that selecting
+    // among the top k of the chunks stays cheap next to selecting within them.
+    const int64_t num_chunks = std::min<int64_t>(
+        worker_threads.num_threads,
+        num_cols / std::max<int64_t>(kMinColsPerChunk, 4 * int64_t{k}));
+    if (k < num_cols && num_rows < worker_threads.num_threads &&
+        num_chunks > 1) {
+      TopKInRowChunks<T, Tidx>(worker_threads, sorted, k, input, num_rows,
+                               num_cols, num_chunks, values, indices);
+      return absl::OkStatus();
+    }
+
     auto SortIndices = [&](int64_t start_batch, int64_t limit_batch) {
       for (int32_t b = start_batch; b < limit_batch; ++b) {
         const T* input_data = &input(b, 0);
@@ -208,9 +342,8 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
           // Use the TopN heap object to sort.
           gtl::TopN<Tidx, decltype(stable_comp)> filter(k, stable_comp);
           filter.reserve(num_cols);
-          for (Tidx c = 0; c < num_cols; ++c) {
-            filter.push(c);
-          }
+          PushColumns(input_data, Tidx{0}, static_cast<Tidx>(num_cols), k,
+                      &filter);
 
           int32_t i = 0;
           if (sorted) {
@@ -247,7 +380,6 @@ struct TopKFunctor<CPUDevice, T, Tidx> {
     const int64_t final_cost = (total_cost >= static_cast<double>(kint64max))
                                    ? kint64max
                                    : static_cast<int64_t>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
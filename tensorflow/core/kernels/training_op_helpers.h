@@ -120,6 +120,10 @@ class VariableInputLockHolder {
         shared_locks_(std::move(other.shared_locks_)) {}
 
   ~VariableInputLockHolder() {
+    // The variables were updated while the locks were held.
+    for (Var* var : vars_) {
+      var->RecordUpdate();
+    }
     // Release the locks before unrefing the Vars, because each lock
     // is potentially borrowed from a Var in vars_.
     locks_.reset();
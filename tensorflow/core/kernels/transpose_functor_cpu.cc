@@ -15,12 +15,13 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <complex>
+#include <type_traits>
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/tensor.h"
-#include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/kernels/transpose_functor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
@@ -31,41 +32,273 @@ typedef Eigen::ThreadPoolDevice CPUDevice;
 namespace tensorflow {
 namespace {
 
+using internal::ReduceTransposeDimensions;
+using internal::TransposeDimsVec;
+using internal::TransposePermsVec;
+
+// Elements along each side of the blocks of the 2D transposes: a block and its
+// transpose fit in L1 together.
+constexpr int64_t kTileSize = 32;
+
+// Longest part of a row copied at a time when rows are copied whole.
+constexpr int64_t kRowSegmentSize = 16 * 1024;
+
+// The floating point type whose Eigen packets hold the bits of T, for the
+// in-register transposes of the packets of a block, or void if there is none.
+template <typename T>
+struct PacketTransposeScalar {
+  using type = void;
+};
+template <>
+struct PacketTransposeScalar<uint32> {
+  using type = float;
+};
+template <>
+struct PacketTransposeScalar<uint64> {
+  using type = double;
+};
+
+template <typename T>
+constexpr bool HasPacketTranspose() {
+  using Scalar = typename PacketTransposeScalar<T>::type;
+  if constexpr (std::is_void_v<Scalar>) {
+    return false;
+  } else {
+    using Packet = typename Eigen::internal::packet_traits<Scalar>::type;
+    return Eigen::internal::packet_traits<Scalar>::Vectorizable &&
+           Eigen::internal::unpacket_traits<Packet>::size > 1 &&
+           kTileSize % Eigen::internal::unpacket_traits<Packet>::size == 0;
+  }
+}
+
+// Transposes a square block of one packet per row of `in` into `out`, in
+// registers.
+template <typename Scalar>
+void TransposePacketBlock(const Scalar* in, int64_t in_stride, Scalar* out,
+                          int64_t out_stride) {
+  using Packet = typename Eigen::internal::packet_traits<Scalar>::type;
+  constexpr int kSize = Eigen::internal::unpacket_traits<Packet>::size;
+  Eigen::internal::PacketBlock<Packet, kSize> block;
+  for (int i = 0; i < kSize; ++i) {
+    block.packet[i] = Eigen::internal::ploadu<Packet>(in + i * in_stride);
+  }
+  Eigen::internal::ptranspose(block);
+  for (int i = 0; i < kSize; ++i) {
+    Eigen::internal::pstoreu<Scalar>(out + i * out_stride, block.packet[i]);
+  }
+}
+
+// Writes the transpose of the `num_rows` x `num_cols` block of `in` into
+// `out`: out[c * out_stride + r] = in[r * in_stride + c].
 template <typename T, bool conjugate>
-void TransposeSimple(const CPUDevice& device, const Tensor& in,
-                     const absl::Span<const int32> perm, Tensor* out) {
-  const int ndims = in.dims();
-  absl::InlinedVector<int64_t, 8UL> in_strides =
-      ComputeStride<int64_t>(in.shape());
-  absl::InlinedVector<int64_t, 8UL> out_strides =
-      ComputeStride<int64_t>(out->shape());
-  const T* p = reinterpret_cast<const T*>(in.tensor_data().data());
-  T* q = reinterpret_cast<T*>(const_cast<char*>((out->tensor_data().data())));
-  auto transpose_fn = [=, &in_strides, &out_strides, &perm](int64_t begin,
-                                                            int64_t end) {
-    for (int64_t o_idx = begin; o_idx < end; ++o_idx) {
-      int64_t i_idx = 0;
-      int64_t t = o_idx;
-      for (int i = 0; i < ndims; ++i) {
-        const int64_t ratio = t / out_strides[i];
-        t -= ratio * out_strides[i];
-        i_idx += ratio * in_strides[perm[i]];
+void TransposeBlock(const T* in, int64_t in_stride, T* out, int64_t out_stride,
+                    int64_t num_rows, int64_t num_cols) {
+  // The rows and columns transposed a packet block at a time.
+  int64_t packet_rows = 0;
+  int64_t packet_cols = 0;
+  if constexpr (!conjugate && HasPacketTranspose<T>()) {
+    using Scalar = typename PacketTransposeScalar<T>::type;
+    using Packet = typename Eigen::internal::packet_traits<Scalar>::type;
+    constexpr int kSize = Eigen::internal::unpacket_traits<Packet>::size;
+    packet_rows = num_rows - num_rows % kSize;
+    packet_cols = num_cols - num_cols % kSize;
+    for (int64_t r = 0; r < packet_rows; r += kSize) {
+      for (int64_t c = 0; c < packet_cols; c += kSize) {
+        TransposePacketBlock(
+            reinterpret_cast<const Scalar*>(in + r * in_stride + c), in_stride,
+            reinterpret_cast<Scalar*>(out + c * out_stride + r), out_stride);
       }
+    }
+  }
+  for (int64_t c = 0; c < num_cols; ++c) {
+    T* out_row = out + c * out_stride;
+    for (int64_t r = c < packet_cols ? packet_rows : 0; r < num_rows; ++r) {
       if (conjugate) {
-        q[o_idx] = Eigen::numext::conj(p[i_idx]);
+        out_row[r] = Eigen::numext::conj(in[r * in_stride + c]);
       } else {
-        q[o_idx] = p[i_idx];
+        out_row[r] = in[r * in_stride + c];
+      }
+    }
+  }
+}
+
+TransposeDimsVec RowMajorStrides(const TransposeDimsVec& dims) {
+  TransposeDimsVec strides(dims.size());
+  int64_t stride = 1;
+  for (int i = dims.size() - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= dims[i];
+  }
+  return strides;
+}
+
+// Transposes by copying rows, when the innermost dimension of the input stays
+// innermost. Long rows are copied in segments, so that they are distributed
+// over the threads too. `dims` and `perm` have collapsed dimensions, see
+// CollapseDimensions.
+template <typename T, bool conjugate>
+void TransposeRows(const CPUDevice& device, const T* in, T* out,
+                   const TransposeDimsVec& dims,
+                   const TransposePermsVec& perm) {
+  const int ndims = dims.size();
+  const int64_t row_size = dims[ndims - 1];
+  const TransposeDimsVec in_strides = RowMajorStrides(dims);
+  // The outer dimensions of the output, and the strides of the input along
+  // them.
+  TransposeDimsVec outer_dims(ndims - 1);
+  TransposeDimsVec outer_in_strides(ndims - 1);
+  int64_t num_rows = 1;
+  for (int i = 0; i < ndims - 1; ++i) {
+    outer_dims[i] = dims[perm[i]];
+    outer_in_strides[i] = in_strides[perm[i]];
+    num_rows *= outer_dims[i];
+  }
+
+  const int64_t segment_size = std::min(row_size, kRowSegmentSize);
+  const int64_t row_segments = (row_size + segment_size - 1) / segment_size;
+  auto copy_segments = [&](int64_t begin, int64_t end) {
+    for (int64_t segment = begin; segment < end; ++segment) {
+      const int64_t row = segment / row_segments;
+      const int64_t start = (segment % row_segments) * segment_size;
+      const int64_t size = std::min(segment_size, row_size - start);
+      int64_t in_offset = start;
+      int64_t t = row;
+      for (int i = ndims - 2; i >= 0; --i) {
+        in_offset += (t % outer_dims[i]) * outer_in_strides[i];
+        t /= outer_dims[i];
+      }
+      const T* from = in + in_offset;
+      T* to = out + row * row_size + start;
+      if (conjugate) {
+        for (int64_t j = 0; j < size; ++j) {
+          to[j] = Eigen::numext::conj(from[j]);
+        }
+      } else {
+        std::copy_n(from, size, to);
       }
     }
   };
-  double cycles_per_element =
-      (conjugate ? 1 : 0) +
+  const double cycles_per_segment =
+      (conjugate ? segment_size : 0) +
+      ndims * (Eigen::TensorOpCost::DivCost<int64_t>() +
+               Eigen::TensorOpCost::MulCost<int64_t>() +
+               Eigen::TensorOpCost::AddCost<int64_t>());
+  Eigen::TensorOpCost cost(/*bytes_loaded=*/segment_size * sizeof(T),
+                           /*bytes_stored=*/segment_size * sizeof(T),
+                           cycles_per_segment);
+  device.parallelFor(num_rows * row_segments, cost, std::move(copy_segments));
+}
+
+// Transposes by 2D transposes of tiles, when the innermost dimension of the
+// input moves. Each plane spanned by the input dimensions that become the
+// innermost ones of the input and of the output is transposed a block of
+// kTileSize x kTileSize elements at a time, and the blocks are distributed
+// over the threads. `dims` and `perm` have collapsed dimensions, see
+// CollapseDimensions.
+template <typename T, bool conjugate>
+void TransposeTiles(const CPUDevice& device, const T* in, T* out,
+                    const TransposeDimsVec& dims,
+                    const TransposePermsVec& perm) {
+  const int ndims = dims.size();
+  TransposeDimsVec out_dims(ndims);
+  for (int i = 0; i < ndims; ++i) out_dims[i] = dims[perm[i]];
+  const TransposeDimsVec in_strides = RowMajorStrides(dims);
+  const TransposeDimsVec out_strides = RowMajorStrides(out_dims);
+
+  // The rows of the planes are along the input dimension that becomes the
+  // innermost one of the output, and their columns along the innermost
+  // dimension of the input, in position `col_dim` of the output.
+  const int row_dim = perm[ndims - 1];
+  const int col_dim =
+      std::find(perm.begin(), perm.end(), ndims - 1) - perm.begin();
+  const int64_t num_rows = dims[row_dim];
+  const int64_t num_cols = dims[ndims - 1];
+  const int64_t in_row_stride = in_strides[row_dim];
+  const int64_t out_row_stride = out_strides[col_dim];
+
+  // The other dimensions, in the order of the output.
+  TransposeDimsVec outer_dims;
+  TransposeDimsVec outer_in_strides;
+  TransposeDimsVec outer_out_strides;
+  int64_t num_planes = 1;
+  for (int i = 0; i < ndims - 1; ++i) {
+    if (i == col_dim) continue;
+    outer_dims.push_back(out_dims[i]);
+    outer_in_strides.push_back(in_strides[perm[i]]);
+    outer_out_strides.push_back(out_strides[i]);
+    num_planes *= out_dims[i];
+  }
+
+  const int64_t row_tiles = (num_rows + kTileSize - 1) / kTileSize;
+  const int64_t col_tiles = (num_cols + kTileSize - 1) / kTileSize;
+  auto transpose_tiles = [&](int64_t begin, int64_t end) {
+    for (int64_t tile = begin; tile < end; ++tile) {
+      // Consecutive tiles fill the rows of the output in order.
+      int64_t t = tile;
+      const int64_t row = (t % row_tiles) * kTileSize;
+      t /= row_tiles;
+      const int64_t col = (t % col_tiles) * kTileSize;
+      t /= col_tiles;
+      int64_t in_offset = row * in_row_stride + col;
+      int64_t out_offset = col * out_row_stride + row;
+      for (int i = outer_dims.size() - 1; i >= 0; --i) {
+        const int64_t index = t % outer_dims[i];
+        t /= outer_dims[i];
+        in_offset += index * outer_in_strides[i];
+        out_offset += index * outer_out_strides[i];
+      }
+      TransposeBlock<T, conjugate>(in + in_offset, in_row_stride,
+                                   out + out_offset, out_row_stride,
+                                   std::min(kTileSize, num_rows - row),
+                                   std::min(kTileSize, num_cols - col));
+    }
+  };
+  const int64_t tile_elements = std::min(kTileSize, num_rows) *
+                                std::min(kTileSize, num_cols);
+  const double cycles_per_tile =
+      (conjugate ? tile_elements : 0) +
       ndims * (Eigen::TensorOpCost::DivCost<int64_t>() +
                2 * Eigen::TensorOpCost::MulCost<int64_t>() +
                2 * Eigen::TensorOpCost::AddCost<int64_t>());
-  Eigen::TensorOpCost cost(/*bytes_loaded=*/sizeof(T),
-                           /*bytes_stored=*/sizeof(T), cycles_per_element);
-  device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
+  Eigen::TensorOpCost cost(/*bytes_loaded=*/tile_elements * sizeof(T),
+                           /*bytes_stored=*/tile_elements * sizeof(T),
+                           cycles_per_tile);
+  device.parallelFor(num_planes * row_tiles * col_tiles, cost,
+                     std::move(transpose_tiles));
+}
+
+// Drops the dimensions of size 1 of `shape`, and merges the dimensions that
+// stay next to each other in the same order, so that e.g. a transpose from
+// NHWC to NCHW becomes one from [N, H * W, C] to [N, C, H * W].
+void CollapseDimensions(const TensorShape& shape,
+                        const absl::Span<const int32> perm,
+                        TransposeDimsVec* dims, TransposePermsVec* new_perm) {
+  TransposePermsVec new_index(shape.dims(), -1);
+  TensorShape squeezed;
+  for (int i = 0; i < shape.dims(); ++i) {
+    if (shape.dim_size(i) == 1) continue;
+    new_index[i] = squeezed.dims();
+    squeezed.AddDim(shape.dim_size(i));
+  }
+  TransposePermsVec squeezed_perm;
+  for (const int32 d : perm) {
+    if (new_index[d] >= 0) squeezed_perm.push_back(new_index[d]);
+  }
+  if (squeezed.dims() <= 1) {
+    // Nothing moves.
+    *dims = {squeezed.num_elements()};
+    *new_perm = {0};
+    return;
+  }
+  // ReduceTransposeDimensions returns the position in the output of each
+  // dimension of the input, i.e. the inverse permutation.
+  TransposePermsVec output_positions;
+  dims->resize(squeezed.dims());
+  ReduceTransposeDimensions(squeezed, squeezed_perm, &output_positions, dims);
+  new_perm->resize(output_positions.size());
+  for (int i = 0; i < output_positions.size(); ++i) {
+    (*new_perm)[output_positions[i]] = i;
+  }
 }
 
 }  // namespace
@@ -74,38 +307,16 @@ template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const absl::Span<const int32> perm, Tensor* out) {
-    switch (in.dims()) {
-      case 2:
-        internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 3:
-        internal::TransposeUsingEigen<CPUDevice, T, 3>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 4:
-        internal::TransposeUsingEigen<CPUDevice, T, 4>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 5:
-        internal::TransposeUsingEigen<CPUDevice, T, 5>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 6:
-        internal::TransposeUsingEigen<CPUDevice, T, 6>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 7:
-        internal::TransposeUsingEigen<CPUDevice, T, 7>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      case 8:
-        internal::TransposeUsingEigen<CPUDevice, T, 8>(d, in, perm, conjugate,
-                                                       out);
-        break;
-      default:
-        TransposeSimple<T, conjugate>(d, in, perm, out);
-        break;
+    if (in.NumElements() == 0) return;
+    TransposeDimsVec dims;
+    TransposePermsVec collapsed_perm;
+    CollapseDimensions(in.shape(), perm, &dims, &collapsed_perm);
+    const T* p = reinterpret_cast<const T*>(in.tensor_data().data());
+    T* q = reinterpret_cast<T*>(const_cast<char*>((out->tensor_data().data())));
+    if (collapsed_perm.back() == dims.size() - 1) {
+      TransposeRows<T, conjugate>(d, p, q, dims, collapsed_perm);
+    } else {
+      TransposeTiles<T, conjugate>(d, p, q, dims, collapsed_perm);
     }
   }
 };
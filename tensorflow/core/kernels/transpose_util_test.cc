@@ -13,10 +13,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#define EIGEN_USE_THREADS
+
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/kernels/transpose_functor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 
@@ -130,4 +138,162 @@ TEST_F(TransposeUtilTest, NonSingletonDimensionAlignment) {
                                                      {0, 1, 2, 5, 4, 3}));
 }
 
+TensorShape TransposedShape(const TensorShape& shape,
+                            const std::vector<int32>& perm) {
+  TensorShape transposed;
+  for (const int32 d : perm) transposed.AddDim(shape.dim_size(d));
+  return transposed;
+}
+
+// Transposes `in` one element at a time.
+template <typename T>
+Tensor ReferenceTranspose(const Tensor& in, const std::vector<int32>& perm,
+                          bool conjugate) {
+  Tensor out(in.dtype(), TransposedShape(in.shape(), perm));
+  const int ndims = in.dims();
+  std::vector<int64_t> in_strides(ndims, 1);
+  for (int i = ndims - 2; i >= 0; --i) {
+    in_strides[i] = in_strides[i + 1] * in.dim_size(i + 1);
+  }
+  auto in_flat = in.flat<T>();
+  auto out_flat = out.flat<T>();
+  for (int64_t o = 0; o < out.NumElements(); ++o) {
+    int64_t i = 0;
+    int64_t t = o;
+    for (int d = ndims - 1; d >= 0; --d) {
+      i += (t % out.dim_size(d)) * in_strides[perm[d]];
+      t /= out.dim_size(d);
+    }
+    out_flat(o) = conjugate ? Eigen::numext::conj(in_flat(i)) : in_flat(i);
+  }
+  return out;
+}
+
+template <typename T>
+Tensor Iota(DataType dtype, const TensorShape& shape) {
+  Tensor t(dtype, shape);
+  auto flat = t.flat<T>();
+  for (int64_t i = 0; i < t.NumElements(); ++i) {
+    flat(i) = static_cast<T>(i % 127);
+  }
+  return t;
+}
+
+class TransposeCpuTest : public ::testing::Test {
+ protected:
+  TransposeCpuTest() : pool_(4), device_(&pool_, 4) {}
+
+  template <typename T>
+  void Run(DataType dtype, const TensorShape& shape,
+           const std::vector<int32>& perm, bool conjugate = false) {
+    Tensor in = Iota<T>(dtype, shape);
+    Tensor out(dtype, TransposedShape(shape, perm));
+    if (conjugate) {
+      TF_ASSERT_OK(DoConjugateTranspose(device_, in, perm, &out));
+    } else {
+      TF_ASSERT_OK(DoTranspose(device_, in, perm, &out));
+    }
+    test::ExpectTensorEqual<T>(ReferenceTranspose<T>(in, perm, conjugate),
+                               out);
+  }
+
+  template <typename T>
+  void RunAll(DataType dtype, bool conjugate = false) {
+    // Tiles with partial packets and partial tiles.
+    Run<T>(dtype, {67, 45}, {1, 0}, conjugate);
+    // NHWC to NCHW and back, and with 3 channels.
+    Run<T>(dtype, {2, 9, 11, 40}, {0, 3, 1, 2}, conjugate);
+    Run<T>(dtype, {2, 40, 9, 11}, {0, 2, 3, 1}, conjugate);
+    Run<T>(dtype, {3, 33, 35, 3}, {0, 3, 1, 2}, conjugate);
+    // Row copies, some of them longer than the copied segments.
+    Run<T>(dtype, {2, 7, 3, 20}, {0, 2, 1, 3}, conjugate);
+    Run<T>(dtype, {3, 2, 20000}, {1, 0, 2}, conjugate);
+    // Singleton dimensions, and more dimensions than Eigen shuffles.
+    Run<T>(dtype, {5, 1, 7, 33}, {2, 1, 3, 0}, conjugate);
+    Run<T>(dtype, {2, 3, 1, 2, 3, 2, 3, 2, 3}, {8, 2, 6, 0, 4, 1, 7, 3, 5},
+           conjugate);
+    Run<T>(dtype, {1, 1}, {1, 0}, conjugate);
+    Run<T>(dtype, {0, 5}, {1, 0}, conjugate);
+  }
+
+  Eigen::ThreadPool pool_;
+  Eigen::ThreadPoolDevice device_;
+};
+
+TEST_F(TransposeCpuTest, Int8) { RunAll<int8>(DT_INT8); }
+
+TEST_F(TransposeCpuTest, Int16) { RunAll<int16>(DT_INT16); }
+
+TEST_F(TransposeCpuTest, Float) { RunAll<float>(DT_FLOAT); }
+
+TEST_F(TransposeCpuTest, Double) { RunAll<double>(DT_DOUBLE); }
+
+TEST_F(TransposeCpuTest, Complex64) {
+  RunAll<complex64>(DT_COMPLEX64);
+  RunAll<complex64>(DT_COMPLEX64, /*conjugate=*/true);
+}
+
+TEST_F(TransposeCpuTest, Complex128) {
+  RunAll<complex128>(DT_COMPLEX128, /*conjugate=*/true);
+}
+
+TEST_F(TransposeCpuTest, String) {
+  Tensor in(DT_STRING, {3, 4});
+  auto flat = in.flat<tstring>();
+  for (int i = 0; i < 12; ++i) flat(i) = std::to_string(i);
+  Tensor out(DT_STRING, {4, 3});
+  TF_ASSERT_OK(DoTranspose(device_, in, {1, 0}, &out));
+  test::ExpectTensorEqual<tstring>(
+      test::AsTensor<tstring>(
+          {"0", "4", "8", "1", "5", "9", "2", "6", "10", "3", "7", "11"},
+          {4, 3}),
+      out);
+}
+
+void RunTransposeBenchmark(::testing::benchmark::State& state,
+                           const TensorShape& shape,
+                           const std::vector<int32>& perm) {
+  const int num_threads = port::MaxParallelism();
+  Eigen::ThreadPool pool(num_threads);
+  Eigen::ThreadPoolDevice device(&pool, num_threads);
+  Tensor in(DT_FLOAT, shape);
+  in.flat<float>().setRandom();
+  Tensor out(DT_FLOAT, TransposedShape(shape, perm));
+  for (auto s : state) {
+    TF_CHECK_OK(DoTranspose(device, in, perm, &out));
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * in.TotalBytes());
+}
+
+void BM_TransposeMatrix(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {4096, 4096}, {1, 0});
+}
+BENCHMARK(BM_TransposeMatrix)->UseRealTime();
+
+void BM_TransposeNHWCToNCHW(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {32, 56, 56, 64}, {0, 3, 1, 2});
+}
+BENCHMARK(BM_TransposeNHWCToNCHW)->UseRealTime();
+
+void BM_TransposeNCHWToNHWC(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {32, 64, 56, 56}, {0, 2, 3, 1});
+}
+BENCHMARK(BM_TransposeNCHWToNHWC)->UseRealTime();
+
+void BM_TransposeRgbToChannelsFirst(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {64, 224, 224, 3}, {0, 3, 1, 2});
+}
+BENCHMARK(BM_TransposeRgbToChannelsFirst)->UseRealTime();
+
+// [batch, sequence, heads, head size] to [batch, heads, sequence, head size].
+void BM_TransposeAttentionHeads(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {32, 128, 12, 64}, {0, 2, 1, 3});
+}
+BENCHMARK(BM_TransposeAttentionHeads)->UseRealTime();
+
+void BM_TransposeReverse3D(::testing::benchmark::State& state) {
+  RunTransposeBenchmark(state, {64, 1000, 24}, {2, 1, 0});
+}
+BENCHMARK(BM_TransposeReverse3D)->UseRealTime();
+
 }  // namespace tensorflow
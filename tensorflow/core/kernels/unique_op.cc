@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -68,6 +72,180 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Inputs of integers whose values span at most this many times their number
+// of elements are uniquified with a table indexed by value instead of a hash
+// map.
+constexpr int64_t kMaxDenseRangePerElement = 4;
+
+// Inputs of integers with at least this many elements are uniquified in
+// parallel.
+constexpr int64_t kMinParallelUniqueSize = 1 << 16;
+
+// Returns whether the values of `in` span a range small enough to be
+// uniquified with UniqueInDenseRange(), and if so sets `*min` and `*range`.
+template <typename T>
+bool IsDenseRange(const T* in, int64_t n, T* min, uint64* range) {
+  if (n == 0) return false;
+  T lo = in[0];
+  T hi = in[0];
+  for (int64_t i = 1; i < n; ++i) {
+    lo = std::min(lo, in[i]);
+    hi = std::max(hi, in[i]);
+  }
+  // Computed modulo 2^64, which is exact for every integer type up to 64 bits.
+  const uint64 span = static_cast<uint64>(hi) - static_cast<uint64>(lo);
+  if (span >= static_cast<uint64>(kMaxDenseRangePerElement * n)) return false;
+  *min = lo;
+  *range = span + 1;
+  return true;
+}
+
+// Uniquifies `in` with a table indexed by value, whose values span `range`
+// from `min`. Unique values are numbered in order of first occurrence, as with
+// a hash map.
+template <typename T, typename TIndex>
+void UniqueInDenseRange(const T* in, int64_t n, T min, uint64 range,
+                        TIndex* idx, std::vector<T>* uniq) {
+  std::vector<TIndex> slots(range, -1);
+  for (int64_t i = 0; i < n; ++i) {
+    TIndex& slot = slots[static_cast<uint64>(in[i]) - static_cast<uint64>(min)];
+    if (slot < 0) {
+      slot = static_cast<TIndex>(uniq->size());
+      uniq->push_back(in[i]);
+    }
+    idx[i] = slot;
+  }
+}
+
+// Uniquifies `in` on the CPU worker threads. The elements are partitioned by
+// a hash of their value, so that each partition is uniquified independently
+// with its own hash map; the unique values of all partitions are then
+// numbered in order of first occurrence, as with a single hash map.
+template <typename T, typename TIndex>
+void ParallelUnique(const DeviceBase::CpuWorkerThreads& worker_threads,
+                    const T* in, int64_t n, TIndex* idx,
+                    std::vector<T>* uniq) {
+  // Roughly the cost of a hash map insertion.
+  static constexpr int64_t kCostPerElement = 100;
+  int log2_partitions = 0;
+  while ((1 << log2_partitions) < 4 * worker_threads.num_threads &&
+         log2_partitions < 8) {
+    ++log2_partitions;
+  }
+  const int num_partitions = 1 << log2_partitions;
+  auto partition_of = [log2_partitions](T value) -> uint8 {
+    if (log2_partitions == 0) return 0;
+    return static_cast<uint8>((static_cast<uint64>(value) *
+                               0x9E3779B97F4A7C15ULL) >>
+                              (64 - log2_partitions));
+  };
+
+  const int64_t num_blocks = std::min<int64_t>(
+      worker_threads.num_threads, std::max<int64_t>(n / 4096, 1));
+  const int64_t block_size = (n + num_blocks - 1) / num_blocks;
+  auto for_each_block = [&](int64_t cost_per_element,
+                            const std::function<void(int64_t, int64_t,
+                                                     int64_t)>& fn) {
+    Shard(worker_threads.num_threads, worker_threads.workers, num_blocks,
+          block_size * cost_per_element, [&](int64_t start, int64_t limit) {
+            for (int64_t b = start; b < limit; ++b) {
+              fn(b, b * block_size, std::min(n, (b + 1) * block_size));
+            }
+          });
+  };
+
+  // Count the elements of each partition in each block.
+  std::vector<uint8> partition(n);
+  std::vector<int64_t> offsets(num_blocks * num_partitions, 0);
+  for_each_block(4, [&](int64_t b, int64_t start, int64_t limit) {
+    int64_t* counts = &offsets[b * num_partitions];
+    for (int64_t i = start; i < limit; ++i) {
+      partition[i] = partition_of(in[i]);
+      ++counts[partition[i]];
+    }
+  });
+
+  // Lay out the elements partition by partition, block by block within a
+  // partition, so that each partition lists its elements in input order.
+  std::vector<int64_t> partition_starts(num_partitions + 1, 0);
+  int64_t offset = 0;
+  for (int p = 0; p < num_partitions; ++p) {
+    partition_starts[p] = offset;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      const int64_t count = offsets[b * num_partitions + p];
+      offsets[b * num_partitions + p] = offset;
+      offset += count;
+    }
+  }
+  partition_starts[num_partitions] = offset;
+  std::vector<int64_t> order(n);
+  for_each_block(4, [&](int64_t b, int64_t start, int64_t limit) {
+    int64_t* next = &offsets[b * num_partitions];
+    for (int64_t i = start; i < limit; ++i) {
+      order[next[partition[i]]++] = i;
+    }
+  });
+
+  // Uniquify each partition, numbering its unique values locally in `idx`
+  // and marking their first occurrences.
+  std::vector<uint8> is_first(n, 0);
+  Shard(worker_threads.num_threads, worker_threads.workers, num_partitions,
+        (n / num_partitions + 1) * kCostPerElement,
+        [&](int64_t start, int64_t limit) {
+          for (int64_t p = start; p < limit; ++p) {
+            typename UniqueOpHashMap<T, TIndex>::map_type local;
+            local.reserve(partition_starts[p + 1] - partition_starts[p]);
+            for (int64_t k = partition_starts[p]; k < partition_starts[p + 1];
+                 ++k) {
+              const int64_t i = order[k];
+              auto it = local.emplace(in[i], local.size());
+              idx[i] = it.first->second;
+              is_first[i] = it.second;
+            }
+          }
+        });
+
+  // Number the unique values of all partitions in order of first occurrence.
+  // A partition meets its first occurrences in input order too, so the local
+  // number of each is its position among those of its partition.
+  std::vector<std::vector<TIndex>> global_ids(num_partitions);
+  for (int64_t i = 0; i < n; ++i) {
+    if (is_first[i]) {
+      global_ids[partition[i]].push_back(static_cast<TIndex>(uniq->size()));
+      uniq->push_back(in[i]);
+    }
+  }
+  for_each_block(2, [&](int64_t b, int64_t start, int64_t limit) {
+    for (int64_t i = start; i < limit; ++i) {
+      idx[i] = global_ids[partition[i]][idx[i]];
+    }
+  });
+}
+
+// Uniquifies the integers `in` with UniqueInDenseRange(), or with
+// ParallelUnique() when `on_cpu`, if either applies, and returns whether it
+// did. Otherwise leaves it to a single hash map.
+template <typename T, typename TIndex>
+bool UniqueIntegers(OpKernelContext* context, bool on_cpu, const T* in,
+                    int64_t n, TIndex* idx, std::vector<T>* uniq) {
+  if constexpr (!std::is_integral<T>::value || std::is_same<T, bool>::value) {
+    return false;
+  } else {
+    T min;
+    uint64 range;
+    if (IsDenseRange(in, n, &min, &range)) {
+      UniqueInDenseRange(in, n, min, range, idx, uniq);
+      return true;
+    }
+    if (!on_cpu || n < kMinParallelUniqueSize) return false;
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    if (worker_threads.num_threads <= 1) return false;
+    ParallelUnique(worker_threads, in, n, idx, uniq);
+    return true;
+  }
+}
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -76,7 +254,9 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
 template <typename T, typename TIndex>
 class UniqueOp : public OpKernel {
  public:
-  explicit UniqueOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit UniqueOp(OpKernelConstruction* context)
+      : OpKernel(context),
+        on_cpu_(context->device_type() == DeviceType(DEVICE_CPU)) {}
 
   void Compute(OpKernelContext* context) override {
     const Tensor& input = context->input(0);
@@ -150,6 +330,21 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64_t N = static_cast<int64_t>(Tin.size());
 
+      std::vector<T> uniq_values;
+      if (UniqueIntegers(context, on_cpu_, Tin.data(), N, idx_vec.data(),
+                         &uniq_values)) {
+        uniq_size = static_cast<int64_t>(uniq_values.size());
+        TensorShape output_shape(input.shape());
+        output_shape.set_dim(axis, uniq_size);
+        Tensor* output = nullptr;
+        OP_REQUIRES_OK(context,
+                       context->allocate_output(0, output_shape, &output));
+        std::copy(uniq_values.begin(), uniq_values.end(),
+                  output->flat<T>().data());
+        OutputCounts(context, idx_vec, uniq_size);
+        return;
+      }
+
       typename UniqueOpHashMap<T, TIndex>::map_type uniq;
       uniq.reserve(2 * N);
       for (Eigen::Index i = 0, j = 0; i < N; ++i) {
@@ -225,6 +420,14 @@ class UniqueOp : public OpKernel {
       }
     }
 
+    OutputCounts(context, idx_vec, uniq_size);
+  }
+
+ private:
+  // Outputs the number of occurrences of each unique value for
+  // UniqueWithCounts.
+  void OutputCounts(OpKernelContext* context,
+                    typename TTypes<TIndex>::Vec idx_vec, int64_t uniq_size) {
     if (num_outputs() > 2) {
       Tensor* output = nullptr;
       OP_REQUIRES_OK(context, context->allocate_output(
@@ -237,6 +440,10 @@ class UniqueOp : public OpKernel {
       }
     }
   }
+
+  // Whether the CPU worker threads are available, which they are not to the
+  // host memory kernels registered for other devices.
+  const bool on_cpu_;
 };
 
 #define REGISTER_UNIQUE(type)                                      \
@@ -15,10 +15,15 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -64,6 +69,67 @@ TensorProto GetRandomInt32TensorProtoWithRepeat(int dim, int repeat,
   return tensor_proto;
 }
 
+class UniqueWithCountsOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("unique_op", "UniqueWithCounts")
+                     .Input(FakeInput(DT_INT64))
+                     .Attr("out_idx", DT_INT64)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Runs the op on `input` and expects the unique values in order of first
+  // occurrence, the index of each element among them and their counts.
+  void ExpectUnique(const std::vector<int64_t>& input) {
+    const int64_t n = input.size();
+    AddInputFromArray<int64_t>(TensorShape({n}), input);
+    TF_ASSERT_OK(RunOpKernel());
+
+    std::vector<int64_t> values;
+    std::vector<int64_t> idx;
+    std::vector<int64_t> counts;
+    absl::flat_hash_map<int64_t, int64_t> index;
+    for (const int64_t x : input) {
+      auto it = index.emplace(x, values.size());
+      if (it.second) {
+        values.push_back(x);
+        counts.push_back(0);
+      }
+      idx.push_back(it.first->second);
+      ++counts[it.first->second];
+    }
+    const int64_t num_values = values.size();
+    test::ExpectTensorEqual<int64_t>(
+        *GetOutput(0), test::AsTensor<int64_t>(values, {num_values}));
+    test::ExpectTensorEqual<int64_t>(*GetOutput(1),
+                                     test::AsTensor<int64_t>(idx, {n}));
+    test::ExpectTensorEqual<int64_t>(
+        *GetOutput(2), test::AsTensor<int64_t>(counts, {num_values}));
+  }
+};
+
+TEST_F(UniqueWithCountsOpTest, DenseRange) {
+  MakeOp();
+  std::vector<int64_t> input;
+  for (int i = 0; i < 1000; ++i) {
+    input.push_back(-100 + (i * 37) % 500);
+  }
+  ExpectUnique(input);
+}
+
+TEST_F(UniqueWithCountsOpTest, LargeSparseInput) {
+  MakeOp();
+  // Large enough to be uniquified in parallel, with values too sparse to
+  // index a table.
+  const int64_t n = 200000;
+  std::vector<int64_t> input;
+  for (int64_t i = 0; i < n; ++i) {
+    input.push_back(((i * 7919) % (n / 3)) * 1000003 - (int64_t{1} << 40));
+  }
+  ExpectUnique(input);
+}
+
 void BM_Unique_INT32(::testing::benchmark::State& state) {
   const int dim = state.range(0);
   const int max_int = state.range(1);
@@ -17,9 +17,11 @@ limitations under the License.
 
 #include <atomic>
 #include <optional>
+#include <vector>
 
 #include "absl/synchronization/barrier.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/optional.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/env.h"
@@ -64,6 +66,34 @@ TEST(ThreadPool, DoWork) {
   }
 }
 
+TEST(ThreadPool, ScheduleWithPriority) {
+  ThreadPool pool(Env::Default(), "test", 1);
+  // Keep the only thread busy until all the prioritized tasks are queued.
+  absl::Notification queued;
+  pool.Schedule([&queued]() { queued.WaitForNotification(); });
+
+  mutex mu;
+  std::vector<int> order;
+  absl::BlockingCounter done(4);
+  auto record = [&](int i) {
+    return [&, i]() {
+      {
+        mutex_lock l(mu);
+        order.push_back(i);
+      }
+      done.DecrementCount();
+    };
+  };
+  pool.Schedule(record(0), ThreadPool::Priority::kLow);
+  pool.Schedule(record(1), ThreadPool::Priority::kNormal);
+  pool.Schedule(record(2), ThreadPool::Priority::kHigh);
+  pool.Schedule(record(3), ThreadPool::Priority::kHigh);
+  queued.Notify();
+  done.Wait();
+
+  EXPECT_THAT(order, ::testing::ElementsAre(2, 3, 1, 0));
+}
+
 void RunWithFixedBlockSize(int64_t block_size, int64_t total,
                            ThreadPool* threads) {
   mutex mu;
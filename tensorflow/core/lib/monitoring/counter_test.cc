@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/lib/monitoring/counter.h"
 
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
 namespace monitoring {
@@ -76,6 +78,25 @@ TEST(UnlabeledCounterTest, GetCell) {
   EXPECT_EQ(100, same_cell->value());
 }
 
+auto* concurrent_counter = Counter<0>::New(
+    "/tensorflow/test/concurrent_counter",
+    "Counter without any labels incremented from many threads.");
+
+TEST(UnlabeledCounterTest, ConcurrentIncrements) {
+  auto* cell = concurrent_counter->GetCell();
+  constexpr int kNumThreads = 16;
+  constexpr int kNumIncrements = 1000;
+  {
+    thread::ThreadPool pool(Env::Default(), "test", kNumThreads);
+    for (int i = 0; i < kNumThreads; ++i) {
+      pool.Schedule([cell]() {
+        for (int j = 0; j < kNumIncrements; ++j) cell->IncrementBy(2);
+      });
+    }
+  }
+  EXPECT_EQ(2 * kNumThreads * kNumIncrements, cell->value());
+}
+
 auto* dead_counter_without_labels = Counter<0>::New(
     "/tensorflow/test/dead_counter_without_labels",
     "Counter without any labels which goes on to die on decrement.");
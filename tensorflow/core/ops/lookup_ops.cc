@@ -237,6 +237,20 @@ REGISTER_OP("LookupTableSizeV2")
     .SetShapeFn(ScalarAndTwoElementVectorInputsAndScalarOutputs);
 ALLOW_STATEFUL_OP_FOR_DATASET_FUNCTIONS("LookupTableSizeV2");
 
+REGISTER_OP("LookupTableAdmissionStats")
+    .Input("table_handle: resource")
+    .Output("num_admitted: int64")
+    .Output("num_rejected: int64")
+    .Output("num_evicted: int64")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle handle;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &handle));
+      for (int i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->Scalar());
+      }
+      return absl::OkStatus();
+    });
+
 REGISTER_OP("LookupTableExport")
     .Input("table_handle: Ref(string)")
     .Output("keys: Tkeys")
@@ -441,6 +455,22 @@ REGISTER_OP("AnonymousMutableHashTableOfTensors")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
+REGISTER_OP("MutableHashTableWithAdmission")
+    .Output("table_handle: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Attr("use_node_name_sharing: bool = false")
+    .Attr("key_dtype: {int32, int64, string}")
+    .Attr("value_dtype: {int32, int64, float, double}")
+    .Attr("value_shape: shape = {}")
+    .Attr("admission_threshold: int >= 1 = 1")
+    .Attr("sketch_width: int >= 1 = 65536")
+    .Attr("sketch_depth: int >= 1 = 4")
+    .Attr("max_bytes: int >= 0 = 0")
+    .Attr("eviction_policy: {'lru', 'lfu'} = 'lru'")
+    .SetIsStateful()
+    .SetShapeFn(MutableHashTableOfTensorsShapeFn);
+
 REGISTER_OP("MutableDenseHashTable")
     .Input("empty_key: key_dtype")
     .Output("table_handle: Ref(string)")
@@ -1473,6 +1473,48 @@ REGISTER_OP("SparseSegmentSqrtNGradV2")
     .Attr("Tsegmentids: {int32, int64} = DT_INT32")
     .SetShapeFn(SparseSegmentReductionGradV2ShapeFn);
 
+REGISTER_OP("_HashedSparseSegmentReduction")
+    .Input("data: T")
+    .Input("input: string")
+    .Input("segment_ids: Tsegmentids")
+    .Output("output: T")
+    .Attr("T: {float, double}")
+    .Attr("Tsegmentids: {int32, int64} = DT_INT32")
+    .Attr("num_buckets: int >= 1")
+    .Attr("combiner: {'sum', 'mean', 'sqrtn'}")
+    .SetShapeFn(SparseSegmentReductionShapeFn)
+    .Doc(R"doc(
+Internal operation which is a composition of hashing strings into buckets
+(StringToHashBucketFast) and using the buckets as the indices of a sparse
+segment reduction (SparseSegmentSum, SparseSegmentMean or SparseSegmentSqrtN,
+selected by `combiner`): reserved for internal use.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
+REGISTER_OP("_FusedElementwise")
+    .Input("args: N * T")
+    .Output("output: T")
+    .Attr("T: {half, bfloat16, float, double}")
+    .Attr("N: int >= 1")
+    .Attr("fused_ops: list(string)")
+    .Attr("operands: list(int)")
+    .SetShapeFn(shape_inference::UnchangedShape)
+    .Doc(R"doc(
+Internal operation which is a composition of a chain of elementwise ops
+(`fused_ops`), each one consuming the result of the previous one, evaluated in
+a single pass over the output: reserved for internal use.
+
+`operands` lists the operands of each op in turn: -1 is the result of the
+previous op and k >= 0 is `args[k]`. `args[0]` has the shape of the output, and
+the other args have either that shape, a single element or the shape of the
+innermost dimensions of the output.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
 REGISTER_OP("All")
     .Input("input: bool")
     .Input("reduction_indices: Tidx")
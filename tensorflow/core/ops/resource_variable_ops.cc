@@ -410,6 +410,69 @@ REGISTER_OP("ResourceScatterUpdate")
     .Attr("Tindices: {int32, int64}")
     .SetShapeFn(ResourceScatterUpdateShape);
 
+REGISTER_OP("TieredEmbeddingVarHandleOp")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Attr("dtype: {float, double}")
+    .Attr("shape: shape")
+    .Attr("cache_rows: int >= 1")
+    .Output("resource: resource")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      DataType t;
+      TF_RETURN_IF_ERROR(c->GetAttr("dtype", &t));
+      PartialTensorShape p;
+      TF_RETURN_IF_ERROR(c->GetAttr("shape", &p));
+      ShapeHandle s;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromPartialTensorShape(p, &s));
+      TF_RETURN_IF_ERROR(c->WithRank(s, 2, &s));
+      c->set_output_handle_shapes_and_types(0,
+                                            std::vector<ShapeAndType>{{s, t}});
+      return absl::OkStatus();
+    });
+
+REGISTER_OP("AssignTieredEmbedding")
+    .Input("resource: resource")
+    .Input("value: dtype")
+    .Attr("dtype: {float, double}")
+    .SetShapeFn(CreateAssignShapeFn);
+
+REGISTER_OP("ReadTieredEmbedding")
+    .Input("resource: resource")
+    .Output("value: dtype")
+    .Attr("dtype: {float, double}")
+    .SetShapeFn(ReadVariableShapeFn);
+
+REGISTER_OP("TieredEmbeddingGather")
+    .Input("resource: resource")
+    .Input("indices: Tindices")
+    .Output("output: dtype")
+    .Attr("dtype: {float, double}")
+    .Attr("Tindices: {int32, int64}")
+    .SetShapeFn([](InferenceContext* c) {
+      std::vector<ShapeAndType> handle_shape_and_type;
+      TF_RETURN_IF_ERROR(shape_inference::ValidateVariableResourceHandle(
+          c, &handle_shape_and_type));
+      ShapeHandle table_shape;
+      TF_RETURN_IF_ERROR(
+          c->WithRank(handle_shape_and_type[0].shape, 2, &table_shape));
+      ShapeHandle row_shape;
+      TF_RETURN_IF_ERROR(c->Subshape(table_shape, 1, &row_shape));
+      ShapeHandle out;
+      TF_RETURN_IF_ERROR(c->Concatenate(c->input(1), row_shape, &out));
+      c->set_output(0, out);
+      return absl::OkStatus();
+    });
+
+REGISTER_OP("TieredEmbeddingScatterAdd")
+    .Input("resource: resource")
+    .Input("indices: Tindices")
+    .Input("updates: dtype")
+    .Attr("dtype: {float, double}")
+    .Attr("Tindices: {int32, int64}")
+    .SetShapeFn(ResourceScatterUpdateShape);
+
 REGISTER_OP("MutexV2")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
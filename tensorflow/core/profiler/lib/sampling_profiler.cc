@@ -0,0 +1,108 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/sampling_profiler.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/profiler/convert/xplane_to_op_stats.h"
+#include "tensorflow/core/profiler/protobuf/op_metrics.pb.h"
+#include "tsl/profiler/lib/profiler_session.h"
+#include "tsl/profiler/protobuf/profiler_options.pb.h"
+#include "tsl/profiler/protobuf/xplane.pb.h"
+#include "tsl/profiler/utils/xplane_schema.h"
+#include "tsl/profiler/utils/xplane_utils.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+auto* sampled_op_self_time = monitoring::Counter<1>::New(
+    "/tensorflow/profiler/sampled_op_self_time_us",
+    "The self time of the host ops recorded by the sampling profiler.",
+    "category");
+
+// Drops the events of the host threads shorter than `min_duration_ps`.
+void DropShortEvents(int64_t min_duration_ps, XSpace* space) {
+  XPlane* plane = tsl::profiler::FindMutablePlaneWithName(
+      space, tsl::profiler::kHostThreadsPlaneName);
+  if (plane == nullptr) return;
+  for (XLine& line : *plane->mutable_lines()) {
+    absl::flat_hash_set<const XEvent*> short_events;
+    for (const XEvent& event : line.events()) {
+      if (event.duration_ps() < min_duration_ps) short_events.insert(&event);
+    }
+    if (!short_events.empty()) {
+      tsl::profiler::RemoveEvents(&line, short_events);
+    }
+  }
+}
+
+}  // namespace
+
+SamplingProfiler::SamplingProfiler(const Options& options, Sink sink)
+    : options_(options), sink_(std::move(sink)) {
+  thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "sampling_profiler", [this]() {
+        while (!stop_.WaitForNotificationWithTimeout(options_.period)) {
+          absl::Status status = RecordWindow();
+          if (!status.ok()) {
+            VLOG(1) << "Skipped a sampling profiler window: " << status;
+          }
+        }
+      }));
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  stop_.Notify();
+  thread_.reset();
+}
+
+absl::Status SamplingProfiler::RecordWindow() {
+  ProfileOptions profile_options = tsl::ProfilerSession::DefaultOptions();
+  profile_options.set_host_tracer_level(options_.host_tracer_level);
+  profile_options.set_device_tracer_level(0);
+  profile_options.set_enable_hlo_proto(false);
+  std::unique_ptr<tsl::ProfilerSession> session =
+      tsl::ProfilerSession::Create(profile_options);
+  TF_RETURN_IF_ERROR(session->Status());
+  stop_.WaitForNotificationWithTimeout(options_.window);
+
+  XSpace space;
+  TF_RETURN_IF_ERROR(session->CollectData(&space));
+  session.reset();
+  DropShortEvents(absl::ToInt64Nanoseconds(options_.min_event_duration) * 1000,
+                  &space);
+  OpStatsOptions op_stats_options;
+  op_stats_options.generate_op_metrics_db = true;
+  sink_(ConvertXSpaceToOpStats(space, op_stats_options));
+  return absl::OkStatus();
+}
+
+void SamplingProfiler::ExportToMonitoring(const OpStats& op_stats) {
+  for (const OpMetrics& metrics :
+       op_stats.host_op_metrics_db().metrics_db()) {
+    sampled_op_self_time->GetCell(metrics.category())
+        ->IncrementBy(metrics.self_time_ps() / 1000000);
+  }
+}
+
+}  // namespace profiler
+}  // namespace tensorflow
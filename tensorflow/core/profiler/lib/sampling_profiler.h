@@ -0,0 +1,71 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
+#define TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
+
+#include <functional>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/profiler/protobuf/op_stats.pb.h"
+
+namespace tensorflow {
+namespace profiler {
+
+// Profiles the host continuously at a low overhead, so that performance
+// regressions can be diagnosed in production without an on-demand capture.
+//
+// Every `period`, the host tracer records the TraceMe events of a `window`, in
+// its per-thread buffers. Events shorter than `min_event_duration` are dropped
+// and the rest are aggregated into the OpStats of the window, which are passed
+// to the sink. A window is skipped while another profiler session is active,
+// and on-demand profiler sessions fail while a window is being recorded.
+class SamplingProfiler {
+ public:
+  struct Options {
+    absl::Duration period = absl::Minutes(1);
+    absl::Duration window = absl::Milliseconds(200);
+    absl::Duration min_event_duration = absl::Microseconds(10);
+    // The TraceMe level recorded, see tsl::profiler::TraceMeLevel.
+    int host_tracer_level = 2;
+  };
+
+  using Sink = std::function<void(const OpStats& op_stats)>;
+
+  // Starts recording a window every `options.period` until destroyed.
+  SamplingProfiler(const Options& options, Sink sink);
+  ~SamplingProfiler();
+
+  // Records a window now and passes its OpStats to the sink.
+  absl::Status RecordWindow();
+
+  // A sink adding the self time of the host ops of each window to the
+  // /tensorflow/profiler/sampled_op_self_time_us counter, by op category.
+  static void ExportToMonitoring(const OpStats& op_stats);
+
+ private:
+  const Options options_;
+  const Sink sink_;
+  absl::Notification stop_;
+  std::unique_ptr<Thread> thread_;
+};
+
+}  // namespace profiler
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_PROFILER_LIB_SAMPLING_PROFILER_H_
@@ -0,0 +1,70 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/profiler/lib/sampling_profiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/profiler/protobuf/op_metrics.pb.h"
+#include "tsl/profiler/lib/traceme.h"
+
+namespace tensorflow {
+namespace profiler {
+namespace {
+
+TEST(SamplingProfilerTest, RecordsLongOps) {
+  std::vector<std::string> categories;
+  SamplingProfiler::Options options;
+  options.period = absl::Hours(1);
+  options.window = absl::Milliseconds(200);
+  options.min_event_duration = absl::Milliseconds(5);
+  SamplingProfiler profiler(options, [&](const OpStats& op_stats) {
+    for (const OpMetrics& metrics :
+         op_stats.host_op_metrics_db().metrics_db()) {
+      categories.push_back(metrics.category());
+    }
+  });
+
+  absl::Notification stop;
+  std::unique_ptr<Thread> ops(
+      Env::Default()->StartThread(ThreadOptions(), "ops", [&]() {
+        while (!stop.HasBeenNotified()) {
+          {
+            tsl::profiler::TraceMe long_op("long_op:LongOp");
+            Env::Default()->SleepForMicroseconds(20000);
+          }
+          tsl::profiler::TraceMe short_op("short_op:ShortOp");
+        }
+      }));
+  TF_ASSERT_OK(profiler.RecordWindow());
+  stop.Notify();
+  ops.reset();
+
+  EXPECT_NE(std::find(categories.begin(), categories.end(), "LongOp"),
+            categories.end());
+  EXPECT_EQ(std::find(categories.begin(), categories.end(), "ShortOp"),
+            categories.end());
+}
+
+}  // namespace
+}  // namespace profiler
+}  // namespace tensorflow
@@ -24,12 +24,21 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/util/events_writer.h"
 
 namespace tensorflow {
 namespace {
 
+auto* blocked_time_usecs = monitoring::Counter<0>::New(
+    "/tensorflow/core/summary_file_writer/blocked_time_usecs",
+    "The time summary writes spent waiting for the events file to be flushed, "
+    "in microseconds.");
+
+// Writes the events to the events file in a background thread, so that summary
+// ops do not wait for the file system (e.g. GCS). Writers only block when
+// another max_queue events are queued while a flush is in progress.
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
   SummaryFileWriter(int max_queue, int flush_millis, Env* env)
@@ -63,6 +72,9 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    flush_thread_.reset(env_->StartThread(ThreadOptions(),
+                                          "summary_file_writer",
+                                          [this]() { FlushLoop(); }));
     return absl::OkStatus();
   }
 
@@ -71,11 +83,22 @@ class SummaryFileWriter : public SummaryWriterInterface {
     if (!is_initialized_) {
       return errors::FailedPrecondition("Class was not properly initialized.");
     }
-    return InternalFlush();
+    const int64_t flush = ++flushes_requested_;
+    flush_cv_.notify_all();
+    while (flushes_done_ < flush) {
+      flush_cv_.wait(ml);
+    }
+    return ConsumeFlushStatus();
   }
 
   ~SummaryFileWriter() override {
     (void)Flush();  // Ignore errors.
+    {
+      mutex_lock ml(mu_);
+      stopping_ = true;
+      flush_cv_.notify_all();
+    }
+    flush_thread_.reset();
   }
 
   Status WriteTensor(int64_t global_step, Tensor t, const string& tag,
@@ -152,12 +175,24 @@ class SummaryFileWriter : public SummaryWriterInterface {
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
     mutex_lock ml(mu_);
+    if (queue_.size() > max_queue_ && flushes_done_ < flushes_requested_) {
+      const uint64 start_micros = env_->NowMicros();
+      while (queue_.size() > max_queue_ &&
+             flushes_done_ < flushes_requested_) {
+        flush_cv_.wait(ml);
+      }
+      blocked_time_usecs->GetCell()->IncrementBy(env_->NowMicros() -
+                                                 start_micros);
+    }
     queue_.emplace_back(std::move(event));
-    if (queue_.size() > max_queue_ ||
-        env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+    if (flushes_done_ == flushes_requested_ &&
+        (queue_.size() > max_queue_ ||
+         env_->NowMicros() - last_flush_ > 1000 * flush_millis_)) {
+      ++flushes_requested_;
+      flush_cv_.notify_all();
     }
-    return absl::OkStatus();
+    // Errors of the background flushes are returned by the next write.
+    return ConsumeFlushStatus();
   }
 
   string DebugString() const override { return "SummaryFileWriter"; }
@@ -167,14 +202,42 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return static_cast<double>(env_->NowMicros()) / 1.0e6;
   }
 
-  Status InternalFlush() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    for (const std::unique_ptr<Event>& e : queue_) {
+  Status ConsumeFlushStatus() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    Status status = flush_status_;
+    flush_status_ = absl::OkStatus();
+    return status;
+  }
+
+  // Writes the queued events to the events file whenever a flush is requested,
+  // until the writer is destroyed.
+  void FlushLoop() {
+    while (true) {
+      std::vector<std::unique_ptr<Event>> events;
+      int64_t flush;
+      {
+        mutex_lock ml(mu_);
+        while (!stopping_ && flushes_done_ == flushes_requested_) {
+          flush_cv_.wait(ml);
+        }
+        if (flushes_done_ == flushes_requested_) return;
+        flush = flushes_requested_;
+        events.swap(queue_);
+      }
+      const Status status = WriteAndFlush(events);
+      mutex_lock ml(mu_);
+      flushes_done_ = flush;
+      flush_status_.Update(status);
+      last_flush_ = env_->NowMicros();
+      flush_cv_.notify_all();
+    }
+  }
+
+  Status WriteAndFlush(const std::vector<std::unique_ptr<Event>>& events) {
+    for (const std::unique_ptr<Event>& e : events) {
       events_writer_->WriteEvent(*e);
     }
-    queue_.clear();
     TF_RETURN_WITH_CONTEXT_IF_ERROR(events_writer_->Flush(),
                                     "Could not flush events file.");
-    last_flush_ = env_->NowMicros();
     return absl::OkStatus();
   }
 
@@ -184,9 +247,18 @@ class SummaryFileWriter : public SummaryWriterInterface {
   uint64 last_flush_;
   Env* env_;
   mutex mu_;
+  condition_variable flush_cv_;
   std::vector<std::unique_ptr<Event>> queue_ TF_GUARDED_BY(mu_);
-  // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ TF_GUARDED_BY(mu_);
+  // Flushes requested so far, and requested flushes done by the flush thread.
+  int64_t flushes_requested_ TF_GUARDED_BY(mu_) = 0;
+  int64_t flushes_done_ TF_GUARDED_BY(mu_) = 0;
+  // First error of the flushes since it was last returned.
+  Status flush_status_ TF_GUARDED_BY(mu_);
+  bool stopping_ TF_GUARDED_BY(mu_) = false;
+  // A pointer to allow deferred construction. Only used by the flush thread
+  // once initialized.
+  std::unique_ptr<EventsWriter> events_writer_;
+  std::unique_ptr<Thread> flush_thread_;
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       TF_GUARDED_BY(mu_);
 };
@@ -259,6 +259,46 @@ TEST_F(SummaryFileWriterTest, WallTime) {
       [](const Event& e) { EXPECT_EQ(e.wall_time(), 7.023); }));
 }
 
+TEST_F(SummaryFileWriterTest, ManyEventsAreWrittenInOrder) {
+  // Keep unique with all other test names in this file.
+  const string test_name = "many_events_test";
+  const int num_events = 100;
+  SummaryWriterInterface* writer;
+  TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(), test_name,
+                                      &env_, &writer));
+  for (int i = 0; i < num_events; ++i) {
+    std::unique_ptr<Event> e{new Event};
+    e->set_step(i);
+    TF_CHECK_OK(writer->WriteEvent(std::move(e)));
+  }
+  // Destroying the writer flushes the queued events.
+  writer->Unref();
+
+  std::vector<string> files;
+  TF_CHECK_OK(env_.GetChildren(testing::TmpDir(), &files));
+  int num_files = 0;
+  for (const string& f : files) {
+    if (!absl::StrContains(f, test_name)) continue;
+    ++num_files;
+    std::unique_ptr<RandomAccessFile> read_file;
+    TF_CHECK_OK(env_.NewRandomAccessFile(io::JoinPath(testing::TmpDir(), f),
+                                         &read_file));
+    io::RecordReader reader(read_file.get(), io::RecordReaderOptions());
+    tstring record;
+    uint64 offset = 0;
+    TF_CHECK_OK(reader.ReadRecord(&offset,
+                                  &record));  // The first event is irrelevant
+    for (int i = 0; i < num_events; ++i) {
+      TF_CHECK_OK(reader.ReadRecord(&offset, &record));
+      Event e;
+      e.ParseFromString(record);
+      EXPECT_EQ(e.step(), i);
+    }
+    EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+  }
+  EXPECT_EQ(num_files, 1);
+}
+
 TEST_F(SummaryFileWriterTest, AvoidFilenameCollision) {
   // Keep unique with all other test names in this file.
   string test_name = "avoid_filename_collision_test";
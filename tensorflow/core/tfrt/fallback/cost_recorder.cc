@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 #include <string>
 
@@ -73,5 +76,28 @@ size_t CostRecorder::size() const {
   return op_cost_map_.size();
 }
 
+double CostRecorder::MaxRelativeCostChange(const CostRecorder& baseline) const {
+  // Copy the records of `baseline` so that the two recorders are never locked
+  // at the same time.
+  absl::flat_hash_map<int64_t, std::pair<uint64_t, uint64_t>> baseline_map;
+  {
+    tf_shared_lock l(baseline.op_cost_map_mutex_);
+    baseline_map = baseline.op_cost_map_;
+  }
+
+  double max_change = 0;
+  tf_shared_lock l(op_cost_map_mutex_);
+  for (const auto& [op_key, op_cost] : op_cost_map_) {
+    const auto iter = baseline_map.find(op_key);
+    if (iter == baseline_map.end()) continue;
+    const double cost = std::max<uint64_t>(1, op_cost.first / op_cost.second);
+    const double baseline_cost =
+        std::max<uint64_t>(1, iter->second.first / iter->second.second);
+    max_change =
+        std::max(max_change, std::abs(cost - baseline_cost) / baseline_cost);
+  }
+  return max_change;
+}
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -49,6 +49,11 @@ class CostRecorder {
 
   size_t size() const;
 
+  // Returns the largest relative change of the cost of an op from its cost in
+  // `baseline`, eg. 0.5 if an op became 50% more expensive or 50% cheaper. Ops
+  // recorded in only one of the recorders are ignored.
+  double MaxRelativeCostChange(const CostRecorder& baseline) const;
+
   static const char* MesuredCostPathEnvVarName() {
     return "TF_TFRT_MEASURED_COST_PATH";
   }
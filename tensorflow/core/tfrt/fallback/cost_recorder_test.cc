@@ -98,6 +98,23 @@ TEST(CostRecorderTest, ProtoRecordsTest) {
             kTestAvgCost);
 }
 
+TEST(CostRecorderTest, MaxRelativeCostChangeTest) {
+  CostRecorder baseline;
+  baseline.RecordCost(kTestOpKey, 100);
+  baseline.RecordCost(kTestOpKey + 1, 200);
+
+  CostRecorder recorder;
+  EXPECT_EQ(recorder.MaxRelativeCostChange(baseline), 0);
+
+  recorder.RecordCost(kTestOpKey, 150);
+  recorder.RecordCost(kTestOpKey + 1, 180);
+  // Ops that are not in the baseline are ignored.
+  recorder.RecordCost(kTestOpKey + 2, 1000);
+
+  EXPECT_DOUBLE_EQ(recorder.MaxRelativeCostChange(baseline), 0.5);
+  EXPECT_DOUBLE_EQ(baseline.MaxRelativeCostChange(recorder), 1.0 / 3);
+}
+
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -18,6 +18,7 @@ limitations under the License.
 #include <utility>
 
 #include "absl/status/status.h"
+#include "xla/tsl/framework/serving_device_selector.h"
 #include "xla/tsl/framework/serving_device_selector_policies.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_serving_device_selector.h"
 #include "tensorflow/core/platform/status.h"
@@ -30,7 +31,15 @@ namespace gpu {
 
 Status InitTfrtGpu(const GpuRunnerOptions& options,
                    tensorflow::tfrt_stub::Runtime& runtime) {
-  auto policy = std::make_unique<tsl::RoundRobinPolicy>();
+  std::unique_ptr<tsl::ServingDeviceSelector::Policy> policy;
+  switch (options.serving_selector_policy) {
+    case tsl::ServingDeviceSelectorPolicy::kRoundRobin:
+      policy = std::make_unique<tsl::RoundRobinPolicy>();
+      break;
+    case tsl::ServingDeviceSelectorPolicy::kEarliestCompletion:
+      policy = std::make_unique<tsl::EarliestCompletionPolicy>();
+      break;
+  }
   auto serving_device_selector =
       std::make_unique<tensorflow::gpu::GpuServingDeviceSelector>(
           options.num_gpu_streams, std::move(policy));
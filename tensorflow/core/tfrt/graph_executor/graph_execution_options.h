@@ -96,6 +96,13 @@ struct GraphExecutionOptions {
     // Number of times to record costs before resetting Op cost estimates.
     // However, a reset always occurs after the first execution.
     int updates_per_interval = 1;
+
+    // If positive, at a reset the executable is only recompiled if the cost
+    // of some op changed by more than this fraction (eg. 0.2 for 20%) since
+    // the costs the executable was last compiled with. This avoids redoing
+    // the stream assignment while the op costs are stable. Only used with
+    // `kPeriodic`.
+    double recompilation_cost_change_threshold = 0;
   };
 
   CostAnalysisOptions cost_analysis_options;
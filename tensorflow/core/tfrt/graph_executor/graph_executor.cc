@@ -653,14 +653,17 @@ tensorflow::Status GraphExecutor::Run(
       &req_deadline_tracker_, loaded_client_graph.stream_callback_id(),
       cost_recorder));
 
-  if (do_recompilation) {
+  bool recompiled = false;
+  if (do_recompilation && loaded_client_graph.ShouldRecompile(*cost_recorder)) {
     TF_RETURN_IF_ERROR(
         loaded_client_graph.UpdateCost(*cost_recorder, runtime()));
+    recompiled = true;
     tensorflow::mutex_lock l(num_recompilations_mu_);
     num_recompilations_ += 1;
   }
   if (cost_recorder != nullptr) {
-    loaded_client_graph.UpdateCostAnalysisData(now, do_recompilation);
+    loaded_client_graph.UpdateCostAnalysisData(now, do_recompilation,
+                                               recompiled);
   }
   // Create the outputs from the actual function results, which are sorted
   // according to the output tensor names.
@@ -1058,6 +1061,19 @@ CostRecorder* GraphExecutor::LoadedClientGraph::MaybeGetCostRecorder(
   return nullptr;
 }
 
+bool GraphExecutor::LoadedClientGraph::ShouldRecompile(
+    const CostRecorder& cost_recorder) const {
+  const auto& options = graph_executor_->options().cost_analysis_options;
+  if (options.recompilation_cost_change_threshold <= 0) return true;
+  tensorflow::mutex_lock l(cost_analysis_data_.mu);
+  if (cost_analysis_data_.compiled_cost_recorder == nullptr) return true;
+  const double cost_change = cost_recorder.MaxRelativeCostChange(
+      *cost_analysis_data_.compiled_cost_recorder);
+  VLOG(1) << "TFRT max op cost change of loaded client graph (" << this
+          << ") " << name_ << ": " << cost_change;
+  return cost_change > options.recompilation_cost_change_threshold;
+}
+
 Status GraphExecutor::LoadedClientGraph::UpdateCost(
     const CostRecorder& cost_recorder, const Runtime& runtime) {
   LOG(INFO) << "TFRT updating op costs of loaded client graph (" << this << ") "
@@ -1161,7 +1177,7 @@ GraphExecutor::LoadedClientGraph::LoadedClientGraph(
 }
 
 void GraphExecutor::LoadedClientGraph::UpdateCostAnalysisData(
-    absl::Time now, bool do_recompilation) {
+    absl::Time now, bool do_recompilation, bool recompiled) {
   tensorflow::mutex_lock lock(cost_analysis_data_.mu);
   if (!do_recompilation) {
     cost_analysis_data_.num_cost_updates += 1;
@@ -1176,7 +1192,12 @@ void GraphExecutor::LoadedClientGraph::UpdateCostAnalysisData(
     cost_analysis_data_.tf_mlir_with_op_keys = nullptr;
     cost_analysis_data_.cost_recorder = nullptr;
   } else {
-    // Update cost analysis data.
+    // Update cost analysis data. The recorded costs become the baseline for
+    // the next recompilation if the executable was recompiled with them.
+    if (recompiled) {
+      cost_analysis_data_.compiled_cost_recorder =
+          std::move(cost_analysis_data_.cost_recorder);
+    }
     cost_analysis_data_.cost_recorder = std::make_unique<CostRecorder>();
     cost_analysis_data_.is_available = true;
     cost_analysis_data_.start_time = now;
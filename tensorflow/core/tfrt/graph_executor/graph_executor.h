@@ -166,13 +166,19 @@ class GraphExecutor {
     // in order to provide thread-safety. If do_recompilation becomes `true`,
     // then recompiles using updated costs occurs.
     CostRecorder* MaybeGetCostRecorder(absl::Time now, bool* do_recompilation);
+    // Returns true if the op costs in `cost_recorder` changed enough from the
+    // costs the executable was last compiled with to recompile it. See
+    // `CostAnalysisOptions::recompilation_cost_change_threshold`.
+    bool ShouldRecompile(const CostRecorder& cost_recorder) const;
     // Updates the op cost values in this `LoadedClientGraph` with records from
     // `cost_recorder`.
     Status UpdateCost(const CostRecorder& cost_recorder,
                       const Runtime& runtime);
     // Updates `cost_analysis_data_` to make it accurate for the next execution.
-    // Assumes a cost update occurred this cycle.
-    void UpdateCostAnalysisData(absl::Time now, bool do_recompilation);
+    // Assumes a cost update occurred this cycle. `recompiled` is true if the
+    // executable was recompiled with the recorded costs.
+    void UpdateCostAnalysisData(absl::Time now, bool do_recompilation,
+                                bool recompiled);
     // Getters.
     std::shared_ptr<ExecutableContext> executable_context() const {
       tensorflow::mutex_lock lock(executable_context_mu_);
@@ -212,6 +218,8 @@ class GraphExecutor {
       bool is_available TF_GUARDED_BY(mu) = false;
       // Maintains the book-keeping of op costs.
       std::unique_ptr<CostRecorder> cost_recorder;
+      // The costs the executable was last recompiled with, if any.
+      std::unique_ptr<CostRecorder> compiled_cost_recorder TF_GUARDED_BY(mu);
       // For recompilation in MLRT, TFRT respectively.
       mlir::OwningOpRef<mlir::ModuleOp> tf_mlir_with_op_keys;
       mlir::OwningOpRef<mlir::ModuleOp> tfrt_mlir;
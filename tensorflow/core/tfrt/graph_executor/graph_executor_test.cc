@@ -228,6 +228,52 @@ TEST_P(GraphExecutorTest, OnlineCostAnalysisEveryTime) {
   }
 }
 
+TEST_P(GraphExecutorTest, OnlineCostAnalysisRecompilesOnCostChange) {
+  GraphDef graph_def;
+  TF_ASSERT_OK(GetSimpleGraphDef(graph_def));
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  GraphExecutor::Options options(runtime.get());
+  options.cost_analysis_options.version =
+      GraphExecutionOptions::CostAnalysisOptions::kPeriodic;
+  options.cost_analysis_options.reset_interval = absl::ZeroDuration();
+  options.cost_analysis_options.updates_per_interval = 1;
+  // The op costs never change that much, so only the first run recompiles.
+  options.cost_analysis_options.recompilation_cost_change_threshold = 1e9;
+  options.enable_mlrt = GetParam();
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto fallback_state,
+      tensorflow::tfrt_stub::FallbackState::Create(
+          CreateDefaultSessionOptions(options), graph_def.library()));
+  auto resource_context = std::make_unique<tfrt::ResourceContext>();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto graph_executor_base,
+      GraphExecutor::Create(std::move(options), std::move(fallback_state),
+                            std::move(resource_context), graph_def,
+                            GetKernelRegistry()));
+  auto graph_executor = std::unique_ptr<GraphExecutorForTestingCostAnalysis>(
+      static_cast<GraphExecutorForTestingCostAnalysis*>(
+          graph_executor_base.release()));
+
+  // Set input 'x' to [[1, 1, 1]]
+  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  inputs.push_back({"input", CreateTfTensor<int32_t>(
+                                 /*shape=*/{1, 3}, /*data=*/{1, 1, 1})});
+
+  std::vector<tensorflow::Tensor> outputs;
+
+  for (int i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                     /*output_tensor_names=*/{"rank"},
+                                     /*target_tensor_names=*/{}, &outputs));
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+                ::testing::ElementsAreArray({2}));
+    EXPECT_EQ(graph_executor->num_recompilations(), 1);
+  }
+}
+
 TEST_P(GraphExecutorTest, OnlineCostAnalysisDisabled) {
   GraphDef graph_def;
   TF_ASSERT_OK(GetSimpleGraphDef(graph_def));
@@ -226,14 +226,12 @@ absl::StatusOr<tsl::RCReference<xla::ifrt::Array>>
 IfrtServingExecutable::ConvertTensorToArray(
     const tensorflow::Tensor& tensor,
     const tsl::RCReference<xla::ifrt::DeviceList>& device_list,
-    const xla::OpSharding& sharding) {
+    const xla::HloSharding& hlo_sharding) {
   xla::ifrt::Shape input_shape = ToIfrtShape(tensor.shape());
   VLOG(2) << "Converting tensor of shape " << input_shape;
 
-  TF_ASSIGN_OR_RETURN(auto hlo_sharding, xla::HloSharding::FromProto(sharding));
-
-  return MakeArrayFromTensor(*ifrt_client_, tensor, device_list,
-                             std::move(hlo_sharding), thread_pool_);
+  return MakeArrayFromTensor(*ifrt_client_, tensor, device_list, hlo_sharding,
+                             thread_pool_);
 }
 
 absl::StatusOr<std::vector<tensorflow::FunctionDef>> BuildFunctionDef(
@@ -452,6 +450,22 @@ IfrtServingExecutable::CreateExecutableSynchronously(
       std::move(tf2hlo_result.compile_metadata);
   executable_bundle->host_callbacks = std::move(tf_host_callbacks);
 
+  const auto& final_compile_metadata = executable_bundle->compile_metadata;
+  executable_bundle->arg_hlo_shardings.reserve(
+      final_compile_metadata.args().size());
+  for (const auto& arg : final_compile_metadata.args()) {
+    TF_ASSIGN_OR_RETURN(xla::HloSharding hlo_sharding,
+                        xla::HloSharding::FromProto(arg.sharding()));
+    executable_bundle->arg_hlo_shardings.push_back(std::move(hlo_sharding));
+  }
+  executable_bundle->retval_hlo_shardings.reserve(
+      final_compile_metadata.retvals().size());
+  for (const auto& retval : final_compile_metadata.retvals()) {
+    TF_ASSIGN_OR_RETURN(xla::HloSharding hlo_sharding,
+                        xla::HloSharding::FromProto(retval.sharding()));
+    executable_bundle->retval_hlo_shardings.push_back(std::move(hlo_sharding));
+  }
+
   return executable_bundle;
 }
 
@@ -592,42 +606,43 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
 
   VLOG(2) << "Completed AsyncLoadIfrtArray";
 
-  std::vector<tsl::RCReference<xla::ifrt::Array>> args;
-  args.reserve(inputs.size());
+  std::vector<int> device_ids;
+  device_ids.reserve(device_list->size());
+  for (xla::ifrt::Device* device : device_list->devices()) {
+    device_ids.push_back(device->Id().value());
+  }
+
+  // All the input transfers are started before waiting for any loaded
+  // variable, so that they overlap with the loading of the variables.
+  std::vector<tsl::RCReference<xla::ifrt::Array>> args(inputs.size());
+  std::vector<
+      std::pair<int, xla::ifrt::Future<tsl::RCReference<xla::ifrt::Array>>>>
+      variable_arrays;
+  variable_arrays.reserve(variable_arg_indices.size());
   int variable_index = 0;
   for (int i = 0; i < inputs.size(); i++) {
+    const xla::HloSharding& hlo_sharding =
+        executable_bundle->arg_hlo_shardings[i];
     if (variable_index < variable_arg_indices.size() &&
         i == variable_arg_indices[variable_index]) {
-      std::vector<int> device_ids;
-      device_ids.reserve(device_list->size());
-      for (xla::ifrt::Device* device : device_list->devices()) {
-        device_ids.push_back(device->Id().value());
-      }
-      TF_ASSIGN_OR_RETURN(
-          xla::HloSharding hlo_sharding,
-          xla::HloSharding::FromProto(
-              executable_bundle->compile_metadata.args()[i].sharding()));
       IfrtLoadedVariableRegistry::Key key{
-          .device_ids = std::move(device_ids),
+          .device_ids = device_ids,
           .input_name = inputs[i].scalar<tsl::tstring>()(),
-          .hlo_sharding = std::move(hlo_sharding),
+          .hlo_sharding = hlo_sharding,
       };
       TF_ASSIGN_OR_RETURN(
           auto loaded_variable,
           ifrt_loaded_variable_registry_.GetLoadedVariable(key));
-      TF_ASSIGN_OR_RETURN(tsl::RCReference<xla::ifrt::Array> single_array,
-                          loaded_variable.array.Await());
-      args.push_back(std::move(single_array));
+      variable_arrays.push_back({i, std::move(loaded_variable.array)});
       variable_index++;
     } else {
       TF_ASSIGN_OR_RETURN(
-          auto single_array,
-          ConvertTensorToArray(
-              inputs[i], device_list,
-              executable_bundle->compile_metadata.args()[i].sharding()));
-      args.push_back(single_array);
+          args[i], ConvertTensorToArray(inputs[i], device_list, hlo_sharding));
     }
   }
+  for (auto& [i, array] : variable_arrays) {
+    TF_ASSIGN_OR_RETURN(args[i], array.Await());
+  }
   DCHECK_EQ(args.size(), dtypes_and_shapes.size());
 
   VLOG(2) << "Start Execution";
@@ -661,18 +676,15 @@ absl::StatusOr<std::vector<tensorflow::Tensor>> IfrtServingExecutable::Execute(
     tensorflow::TensorShape tensor_shape;
     const tsl::RCReference<xla::ifrt::Array>& array_for_copy =
         execution_result.outputs[i];
-    const tpu::TPUCompileMetadataProto::Retval& metadata_retval =
-        executable_bundle->compile_metadata.retvals()[i];
 
     // IFRT's return does not contain sufficient information; so we use
     // sharding spec from metadata.
     VLOG(2) << "Output sharding: " << array_for_copy->sharding().DebugString();
 
-    TF_ASSIGN_OR_RETURN(auto hlo_sharding, xla::HloSharding::FromProto(
-                                               metadata_retval.sharding()));
-    output_futures.push_back(MakeTensorFromArray(*ifrt_client_, *array_for_copy,
-                                                 hlo_sharding, device_list,
-                                                 thread_pool_));
+    output_futures.push_back(MakeTensorFromArray(
+        *ifrt_client_, *array_for_copy,
+        executable_bundle->retval_hlo_shardings[i], device_list,
+        thread_pool_));
   }
 
   std::vector<tensorflow::Tensor> outputs;
@@ -700,12 +712,8 @@ absl::Status IfrtServingExecutable::AsyncLoadIfrtArray(
     }
     std::string runtime_name = inputs[i].scalar<tsl::tstring>()();
     // TODO(b/339521818): Add test cases for OpSharding on variables.
-    TF_ASSIGN_OR_RETURN(
-        xla::HloSharding hlo_sharding,
-        xla::HloSharding::FromProto(
-            executable_bundle.compile_metadata.args()[i].sharding()));
     VariableDeviceShardingConfig sharding_config{
-        .hlo_sharding = std::move(hlo_sharding),
+        .hlo_sharding = executable_bundle.arg_hlo_shardings[i],
     };
     for (xla::ifrt::Device* device : devices->devices()) {
       sharding_config.device_ids.push_back(device->Id().value());
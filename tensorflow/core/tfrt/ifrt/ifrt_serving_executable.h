@@ -34,6 +34,7 @@ limitations under the License.
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
 #include "tensorflow/compiler/mlir/tfrt/transforms/ifrt/ifrt_types.h"
 #include "tensorflow/compiler/tf2xla/xla_helpers.h"
+#include "xla/hlo/ir/hlo_sharding.h"
 #include "xla/python/ifrt/array.h"
 #include "xla/python/ifrt/client.h"
 #include "xla/python/ifrt/device.h"
@@ -121,6 +122,11 @@ class IfrtServingExecutable {
     std::unique_ptr<xla::ifrt::LoadedExecutable> ifrt_executable;
     tensorflow::tpu::TPUCompileMetadataProto compile_metadata;
     std::vector<std::unique_ptr<TfHostCallback>> host_callbacks;
+    // The shardings of the arguments and return values in
+    // `compile_metadata`, parsed once per compilation rather than per
+    // execution.
+    std::vector<xla::HloSharding> arg_hlo_shardings;
+    std::vector<xla::HloSharding> retval_hlo_shardings;
 
     CachedExecutableBundle() = default;
     // Move only
@@ -204,7 +210,7 @@ class IfrtServingExecutable {
   absl::StatusOr<tsl::RCReference<xla::ifrt::Array>> ConvertTensorToArray(
       const tensorflow::Tensor& tensor,
       const tsl::RCReference<xla::ifrt::DeviceList>& device_list,
-      const xla::OpSharding& sharding);
+      const xla::HloSharding& hlo_sharding);
 
   xla::ifrt::Future<SharedCachedExecutableBundle> LookUpOrCreateExecutable(
       const tensorflow::tpu::TPUCompileMetadataProto& compile_metadata,
@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/lib/core/threadpool_interface.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/context.h"
 #include "tensorflow/core/platform/denormal.h"
@@ -48,6 +49,12 @@ namespace {
 typedef typename internal::RunHandlerEnvironment::Task Task;
 typedef Eigen::RunQueue<Task, 1024> Queue;
 
+auto* request_queueing_delay_us = tensorflow::monitoring::Sampler<0>::New(
+    {"/tensorflow/tfrt/run_handler/request_queueing_delay_us",
+     "Total time the tasks of a request waited to be run, in microseconds."},
+    // Scale of 10, power of 1.8 with bucket count 33 (~20 minutes).
+    tensorflow::monitoring::Buckets::Exponential(10, 1.8, 33));
+
 }  // namespace
 
 namespace internal {
@@ -82,6 +89,7 @@ RunHandlerEnvironment::Task RunHandlerEnvironment::CreateTask(TaskFunction f) {
           std::move(f),
           tensorflow::Context(tensorflow::ContextKind::kThread),
           id,
+          tensorflow::EnvTime::NowMicros(),
       }),
   };
 }
@@ -140,6 +148,7 @@ ThreadWorkSource::ThreadWorkSource()
       blocking_inflight_(0),
       non_blocking_inflight_(0),
       pending_tasks_(0),
+      queueing_delay_us_(0),
       traceme_id_(0),
       version_(0),
       sub_thread_pool_waiter_(nullptr) {
@@ -327,6 +336,18 @@ void ThreadWorkSource::DecrementPendingTaskCount() {
   pending_tasks_.fetch_sub(1, std::memory_order_release);
 }
 
+void ThreadWorkSource::AddQueueingDelay(uint64_t delay_us) {
+  queueing_delay_us_.fetch_add(delay_us, std::memory_order_relaxed);
+}
+
+uint64_t ThreadWorkSource::GetQueueingDelayUs() {
+  return queueing_delay_us_.load(std::memory_order_relaxed);
+}
+
+void ThreadWorkSource::ResetQueueingDelay() {
+  queueing_delay_us_.store(0, std::memory_order_relaxed);
+}
+
 unsigned ThreadWorkSource::NonBlockingWorkShardingFactor() {
   return non_blocking_work_sharding_factor_;
 }
@@ -356,6 +377,8 @@ RunHandlerThreadPool::RunHandlerThreadPool(
       blocking_thread_max_waiting_time_(
           options.blocking_threads_max_sleep_time_micro_sec),
       enable_wake_up_(options.enable_wake_up),
+      enable_request_affinity_(options.enable_request_affinity),
+      steal_in_priority_order_(options.steal_in_priority_order),
       thread_data_(num_threads_),
       env_(env, thread_options, name),
       name_(name),
@@ -482,9 +505,14 @@ Task RunHandlerThreadPool::FindTask(
     int sub_thread_pool_id, int max_blocking_inflight,
     bool may_steal_blocking_work,
     const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
-    bool* task_from_blocking_queue, ThreadWorkSource** tws) {
+    bool* task_from_blocking_queue, ThreadWorkSource** tws,
+    bool in_priority_order) {
   Task t;
-  int current_index = thread_data_[thread_id].current_index;
+  // In priority order, the search always starts from the request with the
+  // highest priority, and the round robin position of the thread is kept.
+  int current_index = in_priority_order
+                          ? searching_range_start
+                          : thread_data_[thread_id].current_index;
   *task_from_blocking_queue = false;
 
   for (int i = 0; i < searching_range_end - searching_range_start; ++i) {
@@ -495,26 +523,38 @@ Task RunHandlerThreadPool::FindTask(
     *tws = thread_work_sources[current_index];
     ++current_index;
 
-    // For blocking thread, search for blocking tasks first.
-    if (may_steal_blocking_work &&
-        (*tws)->GetInflightTaskCount(true) < max_blocking_inflight) {
-      t = (*tws)->PopBlockingTask();
-      if (t.f) {
-        *task_from_blocking_queue = true;
-        break;
-      }
-    }
-
-    // Search for non-blocking tasks.
-    t = (*tws)->PopNonBlockingTask(thread_id, true);
+    t = PopTask(*tws, thread_id, max_blocking_inflight, may_steal_blocking_work,
+                task_from_blocking_queue);
     if (t.f) {
       break;
     }
   }
-  thread_data_[thread_id].current_index = current_index;
+  if (!in_priority_order) {
+    thread_data_[thread_id].current_index = current_index;
+  }
   return t;
 }
 
+Task RunHandlerThreadPool::PopTask(ThreadWorkSource* tws, int thread_id,
+                                   int max_blocking_inflight,
+                                   bool may_steal_blocking_work,
+                                   bool* task_from_blocking_queue) {
+  Task t;
+  *task_from_blocking_queue = false;
+  // For blocking thread, search for blocking tasks first.
+  if (may_steal_blocking_work &&
+      tws->GetInflightTaskCount(true) < max_blocking_inflight) {
+    t = tws->PopBlockingTask();
+    if (t.f) {
+      *task_from_blocking_queue = true;
+      return t;
+    }
+  }
+
+  // Search for non-blocking tasks.
+  return tws->PopNonBlockingTask(thread_id, true);
+}
+
 // Main worker thread loop.
 void RunHandlerThreadPool::WorkerLoop(int thread_id,
                                       bool may_steal_blocking_work) {
@@ -543,7 +583,20 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
         thread_data_[thread_id].current_thread_work_sources.get();
     sub_thread_pool_id = thread_data_[thread_id].sub_thread_pool_id;
     int active_requests = thread_work_sources->size();
-    if (may_steal_blocking_work) {
+    ThreadData& thread_data = thread_data_[thread_id];
+    // Go back to the request the thread last ran a task of. The version check
+    // guarantees the request is still in the current thread work sources.
+    if (enable_request_affinity_ &&
+        thread_data.last_thread_work_source != nullptr &&
+        thread_data.last_thread_work_source_version ==
+            thread_data.current_version) {
+      tws = thread_data.last_thread_work_source;
+      t = PopTask(tws, thread_id, kMaxBlockingInflight, may_steal_blocking_work,
+                  &task_from_blocking_queue);
+    }
+    if (t.f) {
+      // Found a task of the request the thread last ran.
+    } else if (may_steal_blocking_work) {
       // Each thread will first look for tasks from requests that belongs to
       // its sub thread pool.
       int search_range_start =
@@ -568,7 +621,8 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
         t = FindTask(0, active_requests, thread_id, sub_thread_pool_id,
                      kMaxBlockingInflight,
                      /*may_steal_blocking_work=*/true, *thread_work_sources,
-                     &task_from_blocking_queue, &tws);
+                     &task_from_blocking_queue, &tws,
+                     /*in_priority_order=*/steal_in_priority_order_);
       }
     } else {
       // For non-blocking threads, it will always search from all pending
@@ -581,6 +635,15 @@ void RunHandlerThreadPool::WorkerLoop(int thread_id,
     if (t.f) {
       VLOG(2) << "Running " << (task_from_blocking_queue ? "inter" : "intra")
               << " work from " << tws->GetTracemeId();
+      if (enable_request_affinity_) {
+        thread_data.last_thread_work_source = tws;
+        thread_data.last_thread_work_source_version =
+            thread_data.current_version;
+      }
+      uint64_t now = tensorflow::EnvTime::NowMicros();
+      if (now > t.f->create_time_us) {
+        tws->AddQueueingDelay(now - t.f->create_time_us);
+      }
       tws->IncrementInflightTaskCount(task_from_blocking_queue);
       env_.ExecuteTask(t);
       tws->DecrementInflightTaskCount(task_from_blocking_queue);
@@ -724,17 +787,8 @@ class RunHandlerPool::Impl {
         waiters_mu_(options.num_sub_thread_pool),
         queue_waiters_(options.num_sub_thread_pool),
         run_handler_thread_pool_(new internal::RunHandlerThreadPool(
-            internal::RunHandlerThreadPool::Options(
-                options.num_inter_op_threads, options.num_intra_op_threads,
-                options.wait_if_no_active_request,
-                options.non_blocking_threads_sleep_time_micro_sec,
-                options.blocking_threads_max_sleep_time_micro_sec,
-                options.use_adaptive_waiting_time, options.enable_wake_up,
-                options.max_concurrent_handler,
-                options.num_threads_in_sub_thread_pool,
-                options.sub_thread_request_percentage),
-            tensorflow::Env::Default(), tensorflow::ThreadOptions(),
-            "tf_run_handler_pool", &waiters_mu_, &queue_waiters_)),
+            ThreadPoolOptions(options), tensorflow::Env::Default(),
+            tensorflow::ThreadOptions(), "tf_run_handler_pool", &waiters_mu_, &queue_waiters_)),
         iterations_(0),
         version_(0),
         wait_if_no_active_request_(options.wait_if_no_active_request),
@@ -842,6 +896,8 @@ class RunHandlerPool::Impl {
     uint64_t now = tensorflow::EnvTime::NowMicros();
     double elapsed = (now - handler->start_time_us()) / 1000.0;
     time_hist_.Add(elapsed);
+    request_queueing_delay_us->GetCell()->Add(
+        handler->tws()->GetQueueingDelayUs());
 
     // Erase from and update sorted_active_handlers_. Add it to the end of
     // free_handlers_.
@@ -903,6 +959,23 @@ class RunHandlerPool::Impl {
   }
 
  private:
+  static internal::RunHandlerThreadPool::Options ThreadPoolOptions(
+      const Options& options) {
+    internal::RunHandlerThreadPool::Options thread_pool_options(
+        options.num_inter_op_threads, options.num_intra_op_threads,
+        options.wait_if_no_active_request,
+        options.non_blocking_threads_sleep_time_micro_sec,
+        options.blocking_threads_max_sleep_time_micro_sec,
+        options.use_adaptive_waiting_time, options.enable_wake_up,
+        options.max_concurrent_handler, options.num_threads_in_sub_thread_pool,
+        options.sub_thread_request_percentage);
+    thread_pool_options.enable_request_affinity =
+        options.enable_request_affinity;
+    thread_pool_options.steal_in_priority_order =
+        options.steal_in_priority_order;
+    return thread_pool_options;
+  }
+
   void RecomputePoolStats(
       int num_active_requests, uint64_t version,
       const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
@@ -1016,6 +1089,7 @@ void RunHandler::Impl::Reset(int64_t step_id,
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
+  tws_.ResetQueueingDelay();
 }
 
 int RunHandler::Impl::RunHandlerEigenThreadPool::NumThreads() const {
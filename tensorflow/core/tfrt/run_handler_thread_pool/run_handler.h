@@ -108,6 +108,17 @@ class RunHandlerPool {
 
     // If true, threads will be waken up by new tasks.
     bool enable_wake_up = true;
+
+    // If true, a thread first looks for work in the request it last ran a task
+    // of, as long as the set of active requests has not changed since, so that
+    // the continuations of a request run where its data is already cached.
+    bool enable_request_affinity = false;
+
+    // If true, a thread that finds no work in the requests of its sub thread
+    // pool steals from all requests in priority order, i.e. from the highest
+    // priority and then the oldest request first, rather than round robin, so
+    // that the requests closest to their deadline are helped first.
+    bool steal_in_priority_order = false;
   };
   explicit RunHandlerPool(Options options);
   ~RunHandlerPool();
@@ -182,6 +193,9 @@ class RunHandlerEnvironment {
     TaskFunction f;
     tensorflow::Context context;
     uint64_t trace_id;
+    // The time (in microseconds) at which the task was created, right before
+    // it is enqueued.
+    uint64_t create_time_us;
   };
   tensorflow::Env* const env_;
   const tensorflow::ThreadOptions thread_options_;
@@ -253,6 +267,16 @@ class ThreadWorkSource {
 
   void DecrementPendingTaskCount();
 
+  // Adds the time a task of this request waited to be run to the queueing
+  // delay of the request.
+  void AddQueueingDelay(uint64_t delay_us);
+
+  // Returns the total time the tasks of this request waited to be run since
+  // the last call to ResetQueueingDelay().
+  uint64_t GetQueueingDelayUs();
+
+  void ResetQueueingDelay();
+
   unsigned NonBlockingWorkShardingFactor();
 
   std::string ToString();
@@ -274,6 +298,9 @@ class ThreadWorkSource {
   // The number of tasks that are enqueued and not finished.
   std::atomic<int64_t> pending_tasks_;
 
+  // The total time tasks waited to be run.
+  std::atomic<uint64_t> queueing_delay_us_;
+
   Queue blocking_work_queue_;
   tensorflow::mutex blocking_queue_op_mu_;
   char pad_[128];
@@ -301,6 +328,9 @@ class RunHandlerThreadPool {
     int max_concurrent_handler;
     std::vector<int> num_threads_in_sub_thread_pool;
     std::vector<double> sub_thread_request_percentage;
+    // See RunHandlerPool::Options.
+    bool enable_request_affinity = false;
+    bool steal_in_priority_order = false;
     Options(int num_blocking_threads, int num_non_blocking_threads,
             bool wait_if_no_active_request,
             int non_blocking_threads_sleep_time_micro_sec,
@@ -362,12 +392,23 @@ class RunHandlerThreadPool {
   // Search tasks from Requets range searching_range_start to
   // searching_range_end. If there is no tasks in the search range and
   // may_steal_blocking_work is true, then search from all requests.
+  //
+  // The requests are searched round robin, starting after the request the
+  // thread last searched, or from searching_range_start if in_priority_order
+  // is true.
   Task FindTask(
       int searching_range_start, int searching_range_end, int thread_id,
       int sub_thread_pool_id, int max_blocking_inflight,
       bool may_steal_blocking_work,
       const Eigen::MaxSizeVector<ThreadWorkSource*>& thread_work_sources,
-      bool* task_from_blocking_queue, ThreadWorkSource** tws);
+      bool* task_from_blocking_queue, ThreadWorkSource** tws,
+      bool in_priority_order = false);
+
+  // Pops a task of the request 'tws', looking for a blocking task first if
+  // may_steal_blocking_work is true and the request has fewer than
+  // max_blocking_inflight blocking tasks running.
+  Task PopTask(ThreadWorkSource* tws, int thread_id, int max_blocking_inflight,
+               bool may_steal_blocking_work, bool* task_from_blocking_queue);
 
   void WaitForWorkInSubThreadPool(int thread_id, bool is_blocking,
                                   int sub_thread_pool_id);
@@ -388,6 +429,11 @@ class RunHandlerThreadPool {
     std::unique_ptr<Eigen::MaxSizeVector<ThreadWorkSource*>>
         current_thread_work_sources;
 
+    // The request the thread last ran a task of, and the version of the
+    // thread work sources at that time. Should only be accessed by one thread.
+    ThreadWorkSource* last_thread_work_source = nullptr;
+    uint64_t last_thread_work_source_version = 0;
+
     int sub_thread_pool_id;
   };
 
@@ -399,6 +445,8 @@ class RunHandlerThreadPool {
   const int non_blocking_thread_sleep_time_;
   const int blocking_thread_max_waiting_time_;
   const bool enable_wake_up_;
+  const bool enable_request_affinity_;
+  const bool steal_in_priority_order_;
   Eigen::MaxSizeVector<ThreadData> thread_data_;
   internal::RunHandlerEnvironment env_;
   std::atomic<bool> cancelled_;
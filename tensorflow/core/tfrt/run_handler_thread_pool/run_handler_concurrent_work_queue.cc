@@ -56,6 +56,8 @@ RunHandlerThreadWorkQueue::RunHandlerThreadWorkQueue(const Options& options)
   pool_options.enable_wake_up = options.enable_wake_up;
   pool_options.wait_if_no_active_request = options.wait_if_no_active_request;
   pool_options.use_adaptive_waiting_time = options.use_adaptive_waiting_time;
+  pool_options.enable_request_affinity = options.enable_request_affinity;
+  pool_options.steal_in_priority_order = options.steal_in_priority_order;
   handler_pool_ = std::make_unique<RunHandlerPool>(pool_options);
 }
 
@@ -126,7 +128,11 @@ std::ostream& operator<<(std::ostream& strm,
               << options.use_adaptive_waiting_time
               << ", wait_if_no_active_request = "
               << options.wait_if_no_active_request
-              << ", enable_wake_up = " << options.enable_wake_up << "}";
+              << ", enable_wake_up = " << options.enable_wake_up
+              << ", enable_request_affinity = "
+              << options.enable_request_affinity
+              << ", steal_in_priority_order = "
+              << options.steal_in_priority_order << "}";
 }
 
 }  // namespace tf
@@ -79,6 +79,14 @@ class RunHandlerThreadWorkQueue
 
     // If true, threads will be waken up by new tasks.
     bool enable_wake_up = true;
+
+    // If true, threads first look for work in the request they last ran a
+    // task of.
+    bool enable_request_affinity = false;
+
+    // If true, idle threads steal work from the requests in priority order
+    // rather than round robin.
+    bool steal_in_priority_order = false;
   };
 
   explicit RunHandlerThreadWorkQueue(const Options& options);
@@ -192,6 +192,16 @@ TEST_P(RunHandlerThreadPoolTest, EnqueueTask) {
   EXPECT_TRUE(absl::StrContains(tws.ToString(), "traceme_id = 0"));
 }
 
+TEST(ThreadWorkSourceTest, QueueingDelay) {
+  internal::ThreadWorkSource tws;
+  EXPECT_EQ(tws.GetQueueingDelayUs(), 0);
+  tws.AddQueueingDelay(10);
+  tws.AddQueueingDelay(5);
+  EXPECT_EQ(tws.GetQueueingDelayUs(), 15);
+  tws.ResetQueueingDelay();
+  EXPECT_EQ(tws.GetQueueingDelayUs(), 0);
+}
+
 TEST_P(RunHandlerThreadPoolTest, FindTask) {
   Eigen::MaxSizeVector<tensorflow::mutex> waiters_mu(2);
   waiters_mu.resize(2);
@@ -269,6 +279,48 @@ TEST_P(RunHandlerThreadPoolTest, FindTask) {
     EXPECT_EQ(result, 3);
   }
 
+  {
+    // In priority order, the thread always searches from the start of the
+    // range.
+    int result = -1;
+    run_handler_thread_pool.AddWorkToQueue(
+        thread_work_sources[2],
+        /*is_blocking=*/true, TaskFunction([&result] { result = 2; }));
+    run_handler_thread_pool.AddWorkToQueue(
+        thread_work_sources[2],
+        /*is_blocking=*/true, TaskFunction([&result] { result = 2; }));
+    run_handler_thread_pool.AddWorkToQueue(
+        thread_work_sources[3],
+        /*is_blocking=*/true, TaskFunction([&result] { result = 3; }));
+
+    const auto find_blocking_task_in_priority_order =
+        [&](bool* task_from_blocking_queue, internal::Task* t) {
+          internal::ThreadWorkSource* tws;
+          *t = run_handler_thread_pool.FindTask(
+              /*searching_range_start=*/0, /*searching_range_end=*/5,
+              /*thread_id=*/0,
+              /*sub_thread_pool_id=*/0, /*max_blocking_inflight=*/10,
+              /*may_steal_blocking_work=*/true, thread_work_sources,
+              task_from_blocking_queue, &tws, /*in_priority_order=*/true);
+        };
+    bool task_from_blocking_queue;
+    internal::Task t;
+    find_blocking_task_in_priority_order(&task_from_blocking_queue, &t);
+    EXPECT_EQ(task_from_blocking_queue, true);
+    t.f->f();
+    EXPECT_EQ(result, 2);
+
+    find_blocking_task_in_priority_order(&task_from_blocking_queue, &t);
+    EXPECT_EQ(task_from_blocking_queue, true);
+    t.f->f();
+    EXPECT_EQ(result, 2);
+
+    find_blocking_task_in_priority_order(&task_from_blocking_queue, &t);
+    EXPECT_EQ(task_from_blocking_queue, true);
+    t.f->f();
+    EXPECT_EQ(result, 3);
+  }
+
   {
     // Task out of searching range cannot be found.
     int result = -1;
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -470,6 +471,44 @@ void UpdateCompileOptions(SavedModel::Options& options) {
       !options.graph_execution_options.enable_mlrt;
 }
 
+bool UseCompilationCache(const SavedModel::Options& options) {
+  const auto& compile_options = options.graph_execution_options.compile_options;
+  return !options.compilation_cache_dir.empty() && !options.aot_generation &&
+         compile_options.device_target == TfrtDeviceInfraTarget::kCpu &&
+         compile_options.backend_compiler == nullptr &&
+         !options.graph_execution_options.use_ifrt;
+}
+
+// Returns the content of the compilation cache entry at `path`, or an empty
+// string if there is no usable entry.
+std::string ReadCompilationCacheEntry(const std::string& path) {
+  std::string data;
+  if (!tensorflow::Env::Default()->FileExists(path).ok()) {
+    LOG(INFO) << "TFRT compilation cache miss: " << path;
+    return data;
+  }
+  absl::Status status =
+      tensorflow::ReadFileToString(tensorflow::Env::Default(), path, &data);
+  if (!status.ok()) {
+    LOG(WARNING) << "TFRT failed to read compilation cache entry " << path
+                 << ": " << status;
+    data.clear();
+    return data;
+  }
+  LOG(INFO) << "TFRT compilation cache hit: " << path;
+  return data;
+}
+
+void MaybeWriteCompilationCacheEntry(const std::string& path,
+                                     absl::string_view data) {
+  if (path.empty()) return;
+  absl::Status status = WriteCompilationCacheEntry(path, data);
+  if (!status.ok()) {
+    LOG(WARNING) << "TFRT failed to write compilation cache entry " << path
+                 << ": " << status;
+  }
+}
+
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<SavedModel>> SavedModelImpl::LoadSavedModel(
@@ -678,19 +717,48 @@ absl::StatusOr<std::unique_ptr<SavedModel>> SavedModelImpl::LoadSavedModel(
     tensorflow::tf_mlrt::RegisterTfMlrtKernels(*kernel_registry);
     tensorflow::tf_mlrt::RegisterTfMlrtBatchKernels(*kernel_registry);
 
+    const auto& compile_options =
+        options.graph_execution_options.compile_options;
+    std::string cache_path;
+    std::string cached;
+    if (UseCompilationCache(options)) {
+      cache_path = GetCompilationCachePath(
+          options.compilation_cache_dir, meta_graph_def, compile_options,
+          absl::StrCat("enable_lazy_loading = ", options.enable_lazy_loading,
+                       ", run_placer_grappler_on_functions = ",
+                       options.graph_execution_options
+                           .run_placer_grappler_on_functions),
+          options.graph_execution_options.enable_mlrt ? "mlrt" : "bef");
+      cached = ReadCompilationCacheEntry(cache_path);
+    }
+
     if (options.graph_execution_options.enable_mlrt) {
-      ASSIGN_OR_RETURN_IN_COMPILE(
-          bytecode, tensorflow::mlrt_compiler::ConvertTfMlirToBytecode(
-                        options.graph_execution_options.compile_options,
-                        *fallback_state, mlir_module.get(), model_context));
+      if (!cached.empty()) {
+        mlrt::bc::Allocator allocator(&bytecode);
+        allocator.Allocate(cached.size(), alignof(char));
+        std::memcpy(bytecode.data(), cached.data(), cached.size());
+      } else {
+        ASSIGN_OR_RETURN_IN_COMPILE(
+            bytecode, tensorflow::mlrt_compiler::ConvertTfMlirToBytecode(
+                          compile_options, *fallback_state, mlir_module.get(),
+                          model_context));
+        MaybeWriteCompilationCacheEntry(
+            cache_path, absl::string_view(bytecode.data(), bytecode.size()));
+      }
     } else {
-      RETURN_IF_ERROR_IN_COMPILE(tensorflow::ConvertTfMlirToBef(
-          options.graph_execution_options.compile_options, mlir_module.get(),
-          &bef, model_context, fallback_state.get()));
-      if (options.graph_execution_options.compile_options
-              .serialize_bef_to_aot_packages) {
-        TF_RETURN_IF_ERROR(SerializeBEF(
-            bef, options.graph_execution_options.compile_options.aot_bef_file));
+      if (!cached.empty()) {
+        bef.assign(cached.begin(), cached.end());
+      } else {
+        RETURN_IF_ERROR_IN_COMPILE(tensorflow::ConvertTfMlirToBef(
+            compile_options, mlir_module.get(), &bef, model_context,
+            fallback_state.get()));
+        MaybeWriteCompilationCacheEntry(
+            cache_path,
+            absl::string_view(reinterpret_cast<const char*>(bef.data()),
+                              bef.size()));
+      }
+      if (compile_options.serialize_bef_to_aot_packages) {
+        TF_RETURN_IF_ERROR(SerializeBEF(bef, compile_options.aot_bef_file));
       }
     }
   }
@@ -810,7 +878,38 @@ SavedModelImpl::SavedModelImpl(
   if (!options_.enable_lazy_loading) {
     bytecode_ = std::move(bytecode);
     loaded_executable_ = std::move(loaded_executable);
+  } else if (!options_.lazy_loading_use_graph_executor &&
+             !options_.lazy_loading_prefetch_signatures.empty()) {
+    prefetch_thread_.reset(tensorflow::Env::Default()->StartThread(
+        tensorflow::ThreadOptions(), "tfrt_saved_model_prefetch",
+        [this]() { PrefetchSignatures(); }));
+  }
+}
+
+SavedModelImpl::~SavedModelImpl() {
+  // Stop prefetching before anything the prefetching thread uses is destroyed.
+  // A signature that is being loaded is finished first.
+  prefetch_cancelled_.store(true);
+  prefetch_thread_.reset();
+}
+
+void SavedModelImpl::PrefetchSignatures() {
+  const auto start_time = absl::Now();
+  for (const auto& name : options_.lazy_loading_prefetch_signatures) {
+    if (prefetch_cancelled_.load()) return;
+    if (!signatures_.contains(name)) {
+      LOG(WARNING) << "TFRT cannot prefetch signature " << name
+                   << ": the signature is not found in the saved model.";
+      continue;
+    }
+    auto loading_result = GetOrCreateLoadingResult(RunOptions(), {name});
+    if (!loading_result.ok()) {
+      LOG(WARNING) << "TFRT failed to prefetch signature " << name << ": "
+                   << loading_result.status();
+    }
   }
+  LOG(INFO) << "TFRT finished prefetching signatures. Took "
+            << absl::ToInt64Milliseconds(absl::Now() - start_time) << " ms.";
 }
 
 std::vector<std::string> SavedModelImpl::GetFunctionNames() const {
@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_TFRT_SAVED_MODEL_SAVED_MODEL_H_
 #define TENSORFLOW_CORE_TFRT_SAVED_MODEL_SAVED_MODEL_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -31,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
@@ -107,6 +109,21 @@ class SavedModel {
     // TODO(b/216379787): Remove this option once b/279197040 is unblocked.
     bool lazy_loading_use_graph_executor = false;
 
+    // The signatures that are loaded in the background right after the saved
+    // model is loaded, if lazy loading is enabled, so that the first
+    // invocations of these (hot) signatures do not pay for their loading. The
+    // other signatures are still loaded on their first invocation. Ignored if
+    // `lazy_loading_use_graph_executor` is true.
+    std::vector<std::string> lazy_loading_prefetch_signatures;
+
+    // If non-empty, the MLRT bytecode or BEF the saved model is compiled to is
+    // cached in this directory, keyed by the model and the compile options, and
+    // later loads of the same model with the same options skip compilation.
+    // Only used for CPU models compiled without a backend compiler, whose
+    // compilation has no side effect on the runtime state. Entries are never
+    // evicted.
+    std::string compilation_cache_dir;
+
     // True if and only if SavedModel is being loaded to generate AOT results.
     bool aot_generation = false;
 
@@ -228,7 +245,7 @@ class SavedModelImpl final : public SavedModel {
       std::unique_ptr<tfd::FallbackResourceArray> resource_array,
       std::unique_ptr<GraphExecutor> graph_executor);
 
-  ~SavedModelImpl() override = default;
+  ~SavedModelImpl() override;
 
   SavedModelImpl(const SavedModelImpl&) = delete;
   SavedModelImpl& operator=(const SavedModelImpl&) = delete;
@@ -300,6 +317,10 @@ class SavedModelImpl final : public SavedModel {
                            absl::Span<const std::string> names)
       TF_LOCKS_EXCLUDED(loading_result_cache_mu_);
 
+  // Loads the signatures in `options_.lazy_loading_prefetch_signatures` one at
+  // a time, until all are loaded or `prefetch_cancelled_` is set.
+  void PrefetchSignatures();
+
   SymbolUids symbol_uids_;
   // `meta_graph_def_` only contains metadata of the model. The graph_def field
   // is removed.
@@ -324,6 +345,11 @@ class SavedModelImpl final : public SavedModel {
   absl::flat_hash_map<std::string /*joined_name*/,
                       std::unique_ptr<LoadingResult>>
       loading_result_cache_ TF_GUARDED_BY(loading_result_cache_mu_);
+
+  std::atomic<bool> prefetch_cancelled_ = false;
+  // The thread running PrefetchSignatures(), if any. It is declared last so
+  // that it is joined before any other member is destroyed.
+  std::unique_ptr<tensorflow::Thread> prefetch_thread_;
 };
 
 class SavedModelMiraImpl;
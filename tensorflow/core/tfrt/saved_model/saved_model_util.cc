@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <iterator>
+#include <sstream>
 #include <optional>
 #include <string>
 #include <unordered_set>
@@ -28,6 +29,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -52,10 +54,13 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/protobuf/meta_graph.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
+#include "tensorflow/core/public/version.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/mlrt/bytecode/bytecode.h"
 #include "tensorflow/core/tfrt/saved_model/saved_model_import_input.h"
@@ -389,5 +394,36 @@ void RegisterTfrtDialectsForAot(mlir::DialectRegistry& registry) {
   tensorflow::RegisterGpuDialects(&registry);
 }
 
+std::string GetCompilationCachePath(
+    absl::string_view cache_dir, const tensorflow::MetaGraphDef& meta_graph_def,
+    const TfrtCompileOptions& options, absl::string_view extra_key,
+    absl::string_view extension) {
+  std::ostringstream options_str;
+  options_str << options;
+  const uint64_t key = tsl::Fingerprint64(absl::StrCat(
+      DeterministicProtoHash64(meta_graph_def), ";", options_str.str(), ";",
+      extra_key, ";", TF_VERSION_STRING));
+  return tsl::io::JoinPath(
+      cache_dir, absl::StrCat(absl::Hex(key, absl::kZeroPad16), ".", extension));
+}
+
+absl::Status WriteCompilationCacheEntry(const std::string& path,
+                                        absl::string_view data) {
+  tsl::Env* env = tsl::Env::Default();
+  TF_RETURN_IF_ERROR(
+      env->RecursivelyCreateDir(std::string(tsl::io::Dirname(path))));
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return absl::InternalError(
+        absl::StrCat("Failed to create a temporary file name for ", path));
+  }
+  TF_RETURN_IF_ERROR(tsl::WriteStringToFile(env, tmp_path, data));
+  absl::Status status = env->RenameFile(tmp_path, path);
+  if (!status.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+  }
+  return status;
+}
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -146,6 +146,21 @@ CallableOptions CombineSignatureDefs(
 
 void RegisterTfrtDialectsForAot(mlir::DialectRegistry& registry);
 
+// Returns the path of the file in `cache_dir` that caches the compilation
+// result (ie. MLRT bytecode or BEF) of `meta_graph_def` with `options`. The
+// key is a hash of the model, the compile options, `extra_key` for any other
+// setting that changes the compilation result, and the TensorFlow version, as
+// the bytecode formats are not stable across versions.
+std::string GetCompilationCachePath(
+    absl::string_view cache_dir, const tensorflow::MetaGraphDef& meta_graph_def,
+    const TfrtCompileOptions& options, absl::string_view extra_key,
+    absl::string_view extension);
+
+// Writes `data` to `path` through a temporary file that is then renamed, so
+// that a concurrent load of the same model never reads a partial cache entry.
+absl::Status WriteCompilationCacheEntry(const std::string& path,
+                                        absl::string_view data);
+
 }  // namespace tfrt_stub
 }  // namespace tensorflow
 
@@ -38,6 +38,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/resource_loader.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/graph_executor/test_config.pb.h"
@@ -1071,6 +1073,86 @@ TEST(SavedModelTest, DisableCompilation) {
   TF_ASSERT_OK((*saved_model)->Run(run_options, "toy", inputs, &outputs));
 }
 
+TEST(SavedModelTest, LazyLoadingPrefetchSignatures) {
+  // SavedModel toy contains a graph of a single 'tf.AddV2' op. It is generated
+  // using the following python code:
+  //  x = tf.placeholder(tf.int32, shape=(3))
+  //  y = tf.compat.v1.get_variable(name='y', initializer=[1, 2, 3])
+  //  r = tf.matmul(x, y)
+  std::string saved_model_dir = tensorflow::GetDataDependencyFilepath(
+      "tensorflow/core/tfrt/saved_model/tests/toy_v1/1");
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  auto options = DefaultSavedModelOptions(runtime.get());
+  options.enable_lazy_loading = true;
+  // Unknown signatures are skipped.
+  options.lazy_loading_prefetch_signatures = {"unknown", "toy"};
+
+  auto saved_model = SavedModelImpl::LoadSavedModel(options, saved_model_dir,
+                                                    /*tags=*/{"serve"});
+  TF_CHECK_OK(saved_model.status());
+
+  // Set input 'x' to [[1, 1, 1]]
+  std::vector<tensorflow::Tensor> inputs;
+  inputs.push_back(
+      CreateTfTensor<int32_t>(/*shape=*/{1, 3}, /*data=*/{1, 1, 1}));
+
+  std::vector<tensorflow::Tensor> outputs;
+
+  // Once prefetched, the signature runs without compilation.
+  tfrt::SavedModel::RunOptions run_options;
+  run_options.disable_compilation = true;
+
+  absl::Status status;
+  for (int i = 0; i < 600; ++i) {
+    status = (*saved_model)->Run(run_options, "toy", inputs, &outputs);
+    if (status.ok()) break;
+    absl::SleepFor(absl::Milliseconds(100));
+  }
+  TF_ASSERT_OK(status);
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+              ::testing::ElementsAreArray({6}));
+}
+
+TEST(SavedModelTest, CompilationCache) {
+  // SavedModel toy contains a graph of a single 'tf.AddV2' op. It is generated
+  // using the following python code:
+  //  x = tf.placeholder(tf.int32, shape=(3))
+  //  y = tf.compat.v1.get_variable(name='y', initializer=[1, 2, 3])
+  //  r = tf.matmul(x, y)
+  std::string saved_model_dir = tensorflow::GetDataDependencyFilepath(
+      "tensorflow/core/tfrt/saved_model/tests/toy_v1/1");
+  const std::string cache_dir =
+      tensorflow::io::JoinPath(::testing::TempDir(), "compilation_cache");
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  auto options = DefaultSavedModelOptions(runtime.get());
+  options.compilation_cache_dir = cache_dir;
+
+  // Set input 'x' to [[1, 1, 1]]
+  std::vector<tensorflow::Tensor> inputs;
+  inputs.push_back(
+      CreateTfTensor<int32_t>(/*shape=*/{1, 3}, /*data=*/{1, 1, 1}));
+
+  // The first load populates the cache and the second one reads from it.
+  for (int i = 0; i < 2; ++i) {
+    auto saved_model = SavedModelImpl::LoadSavedModel(options, saved_model_dir,
+                                                      /*tags=*/{"serve"});
+    TF_ASSERT_OK(saved_model.status());
+
+    std::vector<std::string> entries;
+    TF_ASSERT_OK(tensorflow::Env::Default()->GetChildren(cache_dir, &entries));
+    EXPECT_EQ(entries.size(), 1);
+
+    std::vector<tensorflow::Tensor> outputs;
+    TF_ASSERT_OK((*saved_model)->Run({}, "toy", inputs, &outputs));
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+                ::testing::ElementsAreArray({6}));
+  }
+}
+
 TEST(SavedModelTest, CustomModelConfig) {
   // SavedModel toy contains a graph of a single 'tf.AddV2' op. It is generated
   // using the following python code:
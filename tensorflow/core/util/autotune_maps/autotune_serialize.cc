@@ -16,23 +16,30 @@ limitations under the License.
 // For Google-internal use only.
 #include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
 
+#include <atomic>
 #include <map>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/base/call_once.h"
+#include "absl/strings/str_cat.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/dnn.h"
 #include "xla/stream_executor/gpu/gpu_init.h"
 #include "xla/stream_executor/platform_manager.h"
 #include "xla/tsl/lib/strings/proto_serialization.h"
 #include "xla/tsl/protobuf/dnn.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/str_util.h"
 #include "tensorflow/core/util/activation_mode.h"
 #include "tensorflow/core/util/autotune_maps/autotune_map.pb.h"
 #include "tensorflow/core/util/autotune_maps/conv_autotune_maps.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.h"
 #include "tensorflow/core/util/autotune_maps/conv_parameters.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -170,9 +177,69 @@ Status PopulateConvMap(
   return OkStatus();
 }
 
+// Adds the entries of `from` whose key is not in `to` to `to`, except those
+// with a version different from the runtime's, which could not be loaded.
+Status MergeConvMapProto(const ConvMapProto &from, ConvMapProto *to) {
+  std::set<std::string> keys;
+  std::string serialized_params;
+  for (const ConvMapProto::Entry &kv : to->kv_pairs()) {
+    TF_RET_CHECK(
+        tsl::SerializeToStringDeterministic(kv.key(), &serialized_params));
+    keys.insert(serialized_params);
+  }
+  for (const ConvMapProto::Entry &kv : from.kv_pairs()) {
+    if (kv.key().version() != ConvParameters::kVersion) {
+      continue;
+    }
+    TF_RET_CHECK(
+        tsl::SerializeToStringDeterministic(kv.key(), &serialized_params));
+    if (keys.insert(serialized_params).second) {
+      *to->add_kv_pairs() = kv;
+    }
+  }
+  return OkStatus();
+}
+
+// Returns the file in `dir` holding the autotune maps for the GPU driver and
+// DNN library versions of this process. The GPU model is part of the key of
+// every entry.
+StatusOr<std::string> PersistedAutotuneMapsPath(const std::string &dir) {
+  TF_ASSIGN_OR_RETURN(
+      se::Platform * platform,
+      se::PlatformManager::PlatformWithName(se::GpuPlatformName()));
+  TF_ASSIGN_OR_RETURN(se::StreamExecutor * stream_exec,
+                      platform->ExecutorForDevice(0));
+  std::string dnn_version = "none";
+  if (auto *dnn = stream_exec->AsDnn()) {
+    TF_ASSIGN_OR_RETURN(se::dnn::VersionInfo version, dnn->GetVersion());
+    dnn_version = absl::StrCat(version.major_version(), ".",
+                               version.minor_version(), ".", version.patch());
+  }
+  return io::JoinPath(
+      dir, absl::StrCat(
+               "autotune_maps_driver_",
+               stream_exec->GetDeviceDescription().driver_version().ToString(),
+               "_dnn_", dnn_version, ".pb"));
+}
+
 }  // namespace
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
+namespace {
+
+// The directory the autotune maps are persisted to, from TF_AUTOTUNE_MAPS_DIR.
+const std::string &PersistedAutotuneMapsDir() {
+  static const std::string *dir = [] {
+    std::string dir;
+    TF_CHECK_OK(ReadStringFromEnvVar("TF_AUTOTUNE_MAPS_DIR",
+                                     /*default_val=*/"", &dir));
+    return new std::string(std::move(dir));
+  }();
+  return *dir;
+}
+
+}  // namespace
+
 Status SerializeAutotuneMaps(std::string *output) {
   AutotuneMapsProto proto;
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -211,4 +278,98 @@ void ResetAutotuneMaps() {
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+Status LoadAutotuneMapsFromDir(const std::string &dir) {
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(std::string path, PersistedAutotuneMapsPath(dir));
+  Env *env = Env::Default();
+  if (!env->FileExists(path).ok()) {
+    return absl::OkStatus();
+  }
+  std::string serialized;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, path, &serialized));
+  TF_RETURN_IF_ERROR(LoadSerializedAutotuneMaps(serialized));
+  VLOG(1) << "Loaded autotune maps from " << path;
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  return absl::OkStatus();
+}
+
+Status PersistAutotuneMapsToDir(const std::string &dir) {
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(std::string path, PersistedAutotuneMapsPath(dir));
+  AutotuneMapsProto proto;
+  TF_ASSIGN_OR_RETURN(*proto.mutable_conv_map(),
+                      ConvMapToProto(*ConvAutotuneMap::GetInstance()));
+  TF_ASSIGN_OR_RETURN(*proto.mutable_fused_conv_map(),
+                      ConvMapToProto(*FusedConvAutotuneMap::GetInstance()));
+
+  // Keeps the entries other processes persisted since this one loaded them.
+  Env *env = Env::Default();
+  std::string serialized;
+  if (env->FileExists(path).ok()) {
+    TF_RETURN_IF_ERROR(ReadFileToString(env, path, &serialized));
+    AutotuneMapsProto persisted;
+    if (persisted.ParseFromString(serialized)) {
+      TF_RETURN_IF_ERROR(
+          MergeConvMapProto(persisted.conv_map(), proto.mutable_conv_map()));
+      TF_RETURN_IF_ERROR(MergeConvMapProto(persisted.fused_conv_map(),
+                                           proto.mutable_fused_conv_map()));
+    } else {
+      LOG(WARNING) << "Replacing the unreadable autotune maps in " << path;
+    }
+  }
+  TF_RET_CHECK(tsl::SerializeToStringDeterministic(proto, &serialized));
+
+  // Writes to a file of this process first, so that processes sharing `dir`
+  // only ever see complete files.
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(dir));
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return errors::Internal("Failed to create a temporary file for ", path);
+  }
+  TF_RETURN_IF_ERROR(WriteStringToFile(env, tmp_path, serialized));
+  Status status = env->RenameFile(tmp_path, path);
+  if (!status.ok()) {
+    env->DeleteFile(tmp_path).IgnoreError();
+    return status;
+  }
+  VLOG(1) << "Persisted autotune maps to " << path;
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  return absl::OkStatus();
+}
+
+void MaybeLoadPersistedAutotuneMaps() {
+  static absl::once_flag once;
+  absl::call_once(once, [] {
+    const std::string &dir = PersistedAutotuneMapsDir();
+    if (dir.empty()) {
+      return;
+    }
+    Status status = LoadAutotuneMapsFromDir(dir);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to load the autotune maps persisted in " << dir
+                   << ": " << status;
+    }
+  });
+}
+
+void MaybePersistAutotuneMaps() {
+  const std::string &dir = PersistedAutotuneMapsDir();
+  if (dir.empty()) {
+    return;
+  }
+  // Results inserted while a write is scheduled are written by that one.
+  static std::atomic<bool> *pending = new std::atomic<bool>(false);
+  if (pending->exchange(true)) {
+    return;
+  }
+  Env::Default()->SchedClosure([dir] {
+    pending->store(false);
+    Status status = PersistAutotuneMapsToDir(dir);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to persist the autotune maps to " << dir << ": "
+                   << status;
+    }
+  });
+}
+
 }  // namespace tensorflow
@@ -43,6 +43,26 @@ Status SerializeAutotuneMaps(std::string* output);
 // Resets all autotune maps. For test use only.
 void ResetAutotuneMaps();
 
+// Loads the autotune maps persisted in `dir` by PersistAutotuneMapsToDir for
+// the GPU driver and DNN library versions of this process, if any.
+Status LoadAutotuneMapsFromDir(const std::string& dir);
+
+// Persists the autotune maps to `dir`, keeping the entries persisted there by
+// other processes meanwhile. Entries are keyed by GPU model, and the file by
+// the GPU driver and DNN library versions. The file is replaced atomically,
+// so processes sharing `dir` never read a partial one, although concurrent
+// writers may drop each other's new entries until they persist again.
+Status PersistAutotuneMapsToDir(const std::string& dir);
+
+// Loads the autotune maps persisted in the directory named by
+// TF_AUTOTUNE_MAPS_DIR, once per process. Does nothing if it is unset.
+void MaybeLoadPersistedAutotuneMaps();
+
+// Persists the autotune maps to the directory named by TF_AUTOTUNE_MAPS_DIR in
+// the background, to be called after new results are inserted. Does nothing if
+// it is unset.
+void MaybePersistAutotuneMaps();
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_UTIL_AUTOTUNE_MAPS_AUTOTUNE_SERIALIZE_H_
@@ -18,6 +18,7 @@ limitations under the License.
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 #include "xla/stream_executor/gpu/gpu_init.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/util/autotune_maps/autotune_serialize.h"
@@ -176,6 +177,62 @@ TEST(AutotuneSerializeTest, VersionControl) {
                HasSubstr("Aborted because the loaded autotune results")));
   EXPECT_EQ(ConvAutotuneMap::GetInstance()->GetMap().size(), 0);
 }
+
+// Tests that persisting to a directory keeps the entries persisted there
+// before, as another process sharing it would have, and that loading from it
+// restores all of them.
+TEST(AutotuneSerializeTest, PersistToDir) {
+  const std::string dir =
+      io::JoinPath(testing::TmpDir(), "autotune_serialize_persist_to_dir");
+  ConvParameters conv_params_example_a = {
+      GetStreamExec(),
+      /*batch=*/1,
+      /*in_depths=*/1,
+      /*in=*/{{1, 1}},
+      /*data_format=*/TensorFormat::FORMAT_NCHW,
+      /*out_depths=*/1,
+      /*filter=*/{{1, 1}},
+      /*dilation=*/{{1, 1}},
+      /*stride=*/{{1, 1}},
+      /*padding=*/{{1, 1}},
+      /*dtype=*/DataType::DT_INT8,
+      /*group_count=*/1};
+  ConvParameters conv_params_example_b = {
+      GetStreamExec(),
+      /*batch=*/2,
+      /*in_depths=*/1,
+      /*in=*/{{1, 1}},
+      /*data_format=*/TensorFormat::FORMAT_NCHW,
+      /*out_depths=*/1,
+      /*filter=*/{{1, 1}},
+      /*dilation=*/{{1, 1}},
+      /*stride=*/{{1, 1}},
+      /*padding=*/{{1, 1}},
+      /*dtype=*/DataType::DT_INT8,
+      /*group_count=*/1};
+  AlgorithmDesc algorithm(/*algo_id=*/1, /*use_tensor_ops=*/true);
+  AlgorithmDesc algorithm_no_scratch(/*algo_id=*/1, /*use_tensor_ops=*/true);
+  AutotuneEntry<se::dnn::ConvOp> example(algorithm, algorithm_no_scratch);
+
+  ResetAutotuneMaps();
+  ConvAutotuneMap::GetInstance()->Insert(conv_params_example_a, example);
+  TF_CHECK_OK(PersistAutotuneMapsToDir(dir));
+
+  ResetAutotuneMaps();
+  ConvAutotuneMap::GetInstance()->Insert(conv_params_example_b, example);
+  TF_CHECK_OK(PersistAutotuneMapsToDir(dir));
+
+  ResetAutotuneMaps();
+  TF_CHECK_OK(LoadAutotuneMapsFromDir(dir));
+  EXPECT_EQ(ConvAutotuneMap::GetInstance()->GetMap().size(), 2);
+  AutotuneEntry<se::dnn::ConvOp> entry;
+  EXPECT_TRUE(
+      ConvAutotuneMap::GetInstance()->Find(conv_params_example_a, &entry));
+  EXPECT_EQ(entry, example);
+  EXPECT_TRUE(
+      ConvAutotuneMap::GetInstance()->Find(conv_params_example_b, &entry));
+  EXPECT_EQ(entry, example);
+}
 }  // namespace
 }  // namespace tensorflow
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
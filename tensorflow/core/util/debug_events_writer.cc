@@ -267,14 +267,9 @@ Status DebugEventsWriter::WriteGraphExecutionTrace(
     DebugEvent debug_event;
     MaybeSetDebugEventTimestamp(&debug_event, env_);
     debug_event.set_allocated_graph_execution_trace(graph_execution_trace);
-    string serialized;
-    debug_event.SerializeToString(&serialized);
-
-    mutex_lock l(graph_execution_trace_buffer_mu_);
-    graph_execution_trace_buffer_.emplace_back(std::move(serialized));
-    if (graph_execution_trace_buffer_.size() > circular_buffer_size_) {
-      graph_execution_trace_buffer_.pop_front();
-    }
+    GraphExecutionTraceBufferEntry entry;
+    debug_event.SerializeToString(&entry.serialized_debug_event);
+    AppendToGraphExecutionTraceBuffer(std::move(entry));
     return absl::OkStatus();
   }
 }
@@ -295,6 +290,19 @@ Status DebugEventsWriter::WriteGraphExecutionTrace(
     trace->set_tensor_debug_mode(TensorDebugMode(tensor_debug_mode));
   }
   trace->set_device_name(device_name);
+  // In circular-buffer mode, most traces are evicted before they are flushed,
+  // so defer serializing the tensor value. This is only safe if no one else
+  // holds (and may later modify) the buffer of the tensor.
+  if (circular_buffer_size_ > 0 && tensor_value.RefCountIsOne()) {
+    TF_RETURN_IF_ERROR(Init());
+    GraphExecutionTraceBufferEntry entry;
+    entry.debug_event = std::make_unique<DebugEvent>();
+    MaybeSetDebugEventTimestamp(entry.debug_event.get(), env_);
+    entry.debug_event->set_allocated_graph_execution_trace(trace.release());
+    entry.tensor_value = tensor_value;
+    AppendToGraphExecutionTraceBuffer(std::move(entry));
+    return absl::OkStatus();
+  }
   tensor_value.AsProtoTensorContent(trace->mutable_tensor_proto());
   return WriteGraphExecutionTrace(trace.release());
 }
@@ -309,18 +317,12 @@ void DebugEventsWriter::WriteSerializedNonExecutionDebugEvent(
 void DebugEventsWriter::WriteSerializedExecutionDebugEvent(
     const string& debug_event_str, DebugEventFileType type) {
   const std::unique_ptr<SingleDebugEventFileWriter>* writer = nullptr;
-  std::deque<string>* buffer = nullptr;
-  mutex* mu = nullptr;
   switch (type) {
     case EXECUTION:
       writer = &execution_writer_;
-      buffer = &execution_buffer_;
-      mu = &execution_buffer_mu_;
       break;
     case GRAPH_EXECUTION_TRACES:
       writer = &graph_execution_traces_writer_;
-      buffer = &graph_execution_trace_buffer_;
-      mu = &graph_execution_trace_buffer_mu_;
       break;
     default:
       return;
@@ -329,13 +331,26 @@ void DebugEventsWriter::WriteSerializedExecutionDebugEvent(
   if (circular_buffer_size_ <= 0) {
     // No cyclic-buffer behavior.
     (*writer)->WriteSerializedDebugEvent(debug_event_str);
-  } else {
+  } else if (type == EXECUTION) {
     // Circular buffer behavior.
-    mutex_lock l(*mu);
-    buffer->push_back(debug_event_str);
-    if (buffer->size() > circular_buffer_size_) {
-      buffer->pop_front();
+    mutex_lock l(execution_buffer_mu_);
+    execution_buffer_.push_back(debug_event_str);
+    if (execution_buffer_.size() > circular_buffer_size_) {
+      execution_buffer_.pop_front();
     }
+  } else {
+    GraphExecutionTraceBufferEntry entry;
+    entry.serialized_debug_event = debug_event_str;
+    AppendToGraphExecutionTraceBuffer(std::move(entry));
+  }
+}
+
+void DebugEventsWriter::AppendToGraphExecutionTraceBuffer(
+    GraphExecutionTraceBufferEntry entry) {
+  mutex_lock l(graph_execution_trace_buffer_mu_);
+  graph_execution_trace_buffer_.push_back(std::move(entry));
+  if (graph_execution_trace_buffer_.size() > circular_buffer_size_) {
+    graph_execution_trace_buffer_.pop_front();
   }
 }
 
@@ -391,8 +406,16 @@ Status DebugEventsWriter::FlushExecutionFiles() {
       // Write out all the content in the circular buffers.
       mutex_lock l(graph_execution_trace_buffer_mu_);
       while (!graph_execution_trace_buffer_.empty()) {
+        GraphExecutionTraceBufferEntry& entry =
+            graph_execution_trace_buffer_.front();
+        if (entry.debug_event != nullptr) {
+          entry.tensor_value.AsProtoTensorContent(
+              entry.debug_event->mutable_graph_execution_trace()
+                  ->mutable_tensor_proto());
+          entry.debug_event->SerializeToString(&entry.serialized_debug_event);
+        }
         graph_execution_traces_writer_->WriteSerializedDebugEvent(
-            graph_execution_trace_buffer_.front());
+            entry.serialized_debug_event);
         graph_execution_trace_buffer_.pop_front();
       }
     }
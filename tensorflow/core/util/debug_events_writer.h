@@ -167,6 +167,9 @@ class DebugEventsWriter {
   //   tensor(s)
   //     that this trace is concerned with. The semantics of this tensor value
   //     depends on the value of `tensor_debug_mode`.
+  // In circular-buffer mode, if `tensor_value` is its buffer's only reference,
+  // the buffer is kept and serialized only when flushed, so the caller must
+  // not modify it after this call.
   Status WriteGraphExecutionTrace(const string& tfdbg_context_id,
                                   const string& device_name,
                                   const string& op_name, int32_t output_slot,
@@ -230,6 +233,19 @@ class DebugEventsWriter {
   // Initialize the TFRecord writer for non-metadata file type.
   Status InitNonMetadataFile(DebugEventFileType type);
 
+  // An event in the graph execution traces circular buffer. The tensor value
+  // of a trace written from a Tensor is serialized only when the buffer is
+  // flushed, so that the events evicted from the buffer are never serialized.
+  struct GraphExecutionTraceBufferEntry {
+    string serialized_debug_event;
+    // If set, the event is yet to be serialized with `tensor_value` as the
+    // tensor_proto of its graph execution trace.
+    std::unique_ptr<DebugEvent> debug_event;
+    Tensor tensor_value;
+  };
+
+  void AppendToGraphExecutionTraceBuffer(GraphExecutionTraceBufferEntry entry);
+
   Status SerializeAndWriteDebugEvent(DebugEvent* debug_event,
                                      DebugEventFileType type);
 
@@ -249,7 +265,7 @@ class DebugEventsWriter {
   const int64_t circular_buffer_size_;
   std::deque<string> execution_buffer_ TF_GUARDED_BY(execution_buffer_mu_);
   mutex execution_buffer_mu_;
-  std::deque<string> graph_execution_trace_buffer_
+  std::deque<GraphExecutionTraceBufferEntry> graph_execution_trace_buffer_
       TF_GUARDED_BY(graph_execution_trace_buffer_mu_);
   mutex graph_execution_trace_buffer_mu_;
 
@@ -798,6 +798,50 @@ TEST_F(DebugEventsWriterTest, WriteGrahExecutionTraceWithCyclicBufferFlush) {
   EXPECT_EQ(actuals.size(), 0);
 }
 
+TEST_F(DebugEventsWriterTest, WriteGraphExecutionTraceTensorWithCyclicBuffer) {
+  const size_t kCyclicBufferSize = 10;
+  DebugEventsWriter* writer = DebugEventsWriter::GetDebugEventsWriter(
+      dump_root_, tfdbg_run_id_, kCyclicBufferSize);
+  TF_ASSERT_OK(writer->Init());
+
+  // Tensors that are not shared are serialized when the buffer is flushed,
+  // and the other ones when they are written.
+  Tensor shared(DT_FLOAT, TensorShape({1}));
+  shared.flat<float>()(0) = -1.0f;
+  for (size_t i = 0; i < kCyclicBufferSize * 2; ++i) {
+    if (i % 2 == 0) {
+      Tensor tensor(DT_FLOAT, TensorShape({1}));
+      tensor.flat<float>()(0) = static_cast<float>(i);
+      TF_ASSERT_OK(writer->WriteGraphExecutionTrace(
+          "context", "/device:CPU:0", strings::Printf("op_%.2ld", i), 0,
+          /*tensor_debug_mode=*/1, tensor));
+    } else {
+      Tensor shared_ref = shared;
+      TF_ASSERT_OK(writer->WriteGraphExecutionTrace(
+          "context", "/device:CPU:0", strings::Printf("op_%.2ld", i), 0,
+          /*tensor_debug_mode=*/1, shared_ref));
+    }
+  }
+  TF_ASSERT_OK(writer->FlushExecutionFiles());
+
+  std::vector<DebugEvent> actuals;
+  ReadDebugEventProtos(writer, DebugEventFileType::GRAPH_EXECUTION_TRACES,
+                       &actuals);
+  ASSERT_EQ(actuals.size(), kCyclicBufferSize);
+  for (size_t i = 0; i < kCyclicBufferSize; ++i) {
+    const size_t index = i + kCyclicBufferSize;
+    const GraphExecutionTrace& trace = actuals[i].graph_execution_trace();
+    EXPECT_GT(actuals[i].wall_time(), 0);
+    EXPECT_EQ(trace.op_name(), strings::Printf("op_%.2ld", index));
+    Tensor tensor;
+    ASSERT_TRUE(tensor.FromProto(trace.tensor_proto()));
+    EXPECT_EQ(tensor.flat<float>()(0),
+              index % 2 == 0 ? static_cast<float>(index) : -1.0f);
+  }
+
+  TF_ASSERT_OK(writer->Close());
+}
+
 TEST_F(DebugEventsWriterTest, RegisterDeviceAndGetIdTrace) {
   DebugEventsWriter* writer = DebugEventsWriter::GetDebugEventsWriter(
       dump_root_, tfdbg_run_id_, DebugEventsWriter::kDefaultCyclicBufferSize);
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -22,6 +23,7 @@ limitations under the License.
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
 #include "absl/status/status.h"
 #include "absl/strings/substitute.h"
 #include "tensorflow/core/example/example.pb.h"
@@ -119,6 +121,59 @@ constexpr uint8 kVarintTag(uint32 tag) { return (tag << 3) | 0; }
 constexpr uint8 kDelimitedTag(uint32 tag) { return (tag << 3) | 2; }
 constexpr uint8 kFixed32Tag(uint32 tag) { return (tag << 3) | 5; }
 
+// Returns the number of varints ending in [begin, end). Every varint ends
+// with its only byte that has the high bit clear, so this counts those
+// bytes eight at a time.
+size_t CountVarints(const uint8* begin, const uint8* end) {
+  constexpr uint64 kHighBits = 0x8080808080808080ULL;
+  size_t count = 0;
+  const uint8* p = begin;
+  for (; end - p >= 8; p += 8) {
+    uint64 word;
+    std::memcpy(&word, p, sizeof(word));
+    count += absl::popcount(~word & kHighBits);
+  }
+  for (; p < end; ++p) count += *p < 0x80;
+  return count;
+}
+
+// Decodes the packed varints in [begin, end) into `out`, dropping those past
+// the first `max_out`. Returns false if a varint is longer than ten bytes or
+// runs past `end`.
+bool DecodeVarints(const uint8* begin, const uint8* end, int64_t* out,
+                   size_t max_out) {
+  size_t i = 0;
+  const uint8* p = begin;
+  while (p < end) {
+    uint64 value = *p++;
+    if (value >= 0x80) {
+      value &= 0x7f;
+      for (int shift = 7;; shift += 7) {
+        if (p == end || shift > 63) return false;
+        const uint8 byte = *p++;
+        value |= static_cast<uint64>(byte & 0x7f) << shift;
+        if (byte < 0x80) break;
+      }
+    }
+    if (i < max_out) out[i] = static_cast<int64_t>(value);
+    ++i;
+  }
+  return true;
+}
+
+// Returns the bytes of `stream` up to its current limit, and skips them.
+// With aliasing enabled on an array, these are all in the direct buffer.
+bool ReadRawUntilLimit(protobuf::io::CodedInputStream* stream,
+                       const uint8** begin, const uint8** end) {
+  const void* data = nullptr;
+  int size = 0;
+  if (!stream->GetDirectBufferPointer(&data, &size)) size = 0;
+  if (size != stream->BytesUntilLimit()) return false;
+  *begin = static_cast<const uint8*>(data);
+  *end = *begin + size;
+  return stream->Skip(size);
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -307,10 +362,17 @@ class Feature {
         if (!stream.ReadVarint32(&packed_length)) return false;
         auto packed_limit = stream.PushLimit(packed_length);
 
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        // Counts the values first to resize the output once, then decodes
+        // them without the bounds checks of the stream.
+        const uint8* begin;
+        const uint8* end;
+        if (!ReadRawUntilLimit(&stream, &begin, &end)) return false;
+        const size_t initial_size = int64_list->size();
+        int64_list->resize(initial_size + CountVarints(begin, end));
+        // The size may be less than requested for a LimitedArraySlice.
+        if (!DecodeVarints(begin, end, int64_list->data() + initial_size,
+                           int64_list->size() - initial_size)) {
+          return false;
         }
 
         stream.PopLimit(packed_limit);
@@ -544,7 +606,7 @@ void ParallelFor(const std::function<void(size_t)>& f, size_t n,
 // Enumeration for distinguishing feature types.
 // Note: FastParseSequenceExample constructs a map that includes Type values,
 // and relies on the fact that they are default-initialized to Dense.
-enum class Type { Dense, Sparse, Ragged };
+using Type = FastParseExampleConfigIndex::Type;
 
 // Note: We use SparseBuffer for sparse, ragged, and dense_varlen features.
 struct SparseBuffer {
@@ -592,8 +654,8 @@ void LogSparseFeatureDataLoss(StringPiece feature_name) {
 Status FastParseSerializedExample(
     const tstring& serialized_example, const tstring& example_name,
     const size_t example_index, const Config& config,
-    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    const FastParseExampleConfigIndex& config_index,
+    std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     std::vector<SparseBuffer>* output_ragged,
@@ -630,8 +692,7 @@ Status FastParseSerializedExample(
     parsed::Feature& feature = name_and_feature.second;
 
     std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    if (!config_index.Find(feature_name, &d_and_type)) continue;
 
     size_t d = d_and_type.first;
     bool is_dense = d_and_type.second == Type::Dense;
@@ -639,7 +700,6 @@ Status FastParseSerializedExample(
 
     {
       // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
       const tstring& config_feature_name =
           is_dense ? config.dense[d].feature_name
                    : (is_ragged ? config.ragged[d].feature_name
@@ -1133,48 +1193,69 @@ void CopySparseBufferToTensor(DataType dtype, size_t offset, SparseBuffer* src,
 
 }  // namespace
 
-Status FastParseExample(const Config& config,
-                        absl::Span<const tstring> serialized,
-                        absl::Span<const tstring> example_names,
-                        thread::ThreadPool* thread_pool, Result* result) {
-  DCHECK(result != nullptr);
-  // Check config so we can safely CHECK(false) in switches on config.*.dtype
-  TF_RETURN_IF_ERROR(CheckConfigDataTypes(config));
-
-  if (config.collect_feature_stats) {
-    result->feature_stats.resize(serialized.size());
-  }
-
-  size_t config_size =
+Status FastParseExampleConfigIndex::Init(const FastParseExampleConfig& config) {
+  const size_t config_size =
       config.dense.size() + config.sparse.size() + config.ragged.size();
   SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
+  index_.Clear(config_size);
   bool ok = true;
   for (size_t i = 0; i < 1000; ++i) {
     for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
+      ok &= index_.InsertUnique(hasher(config.dense[d].feature_name),
+                                {d, Type::Dense});
     }
     for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
+      ok &= index_.InsertUnique(hasher(config.sparse[d].feature_name),
+                                {d, Type::Sparse});
     }
     for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
+      ok &= index_.InsertUnique(hasher(config.ragged[d].feature_name),
+                                {d, Type::Ragged});
     }
     if (ok) break;
     LOG(WARNING) << "Collision found. This should happen only if you have "
                     "around 2^32 entries in your config.";
     hasher.seed++;
-    config_index.Clear(config_size);
+    index_.Clear(config_size);
     ok = true;
   }
   if (!ok) {
     return errors::Internal(
         "Could not avoid collision. This should not happen.");
   }
+  seed_ = hasher.seed;
+  return absl::OkStatus();
+}
+
+bool FastParseExampleConfigIndex::Find(
+    StringPiece feature_name, std::pair<size_t, Type>* d_and_type) const {
+  return index_.Find(Hash64(feature_name.data(), feature_name.size(), seed_),
+                     d_and_type);
+}
+
+Status FastParseExample(const Config& config,
+                        absl::Span<const tstring> serialized,
+                        absl::Span<const tstring> example_names,
+                        thread::ThreadPool* thread_pool, Result* result) {
+  FastParseExampleConfigIndex config_index;
+  TF_RETURN_IF_ERROR(config_index.Init(config));
+  return FastParseExample(config, config_index, serialized, example_names,
+                          thread_pool, result);
+}
+
+Status FastParseExample(const Config& config,
+                        const FastParseExampleConfigIndex& config_index,
+                        absl::Span<const tstring> serialized,
+                        absl::Span<const tstring> example_names,
+                        thread::ThreadPool* thread_pool, Result* result) {
+  DCHECK(result != nullptr);
+  // Check config so we can safely CHECK(false) in switches on config.*.dtype
+  TF_RETURN_IF_ERROR(CheckConfigDataTypes(config));
+
+  if (config.collect_feature_stats) {
+    result->feature_stats.resize(serialized.size());
+  }
+
 
   // Allocate dense output for fixed length dense values
   // (variable-length dense and sparse and ragged have to be buffered).
@@ -1245,7 +1326,7 @@ Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
+          config_index, &fixed_dense_values,
           &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch],
           &ragged_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
@@ -1449,6 +1530,14 @@ Status FastParseExample(const Config& config,
 
 Status FastParseSingleExample(const Config& config, StringPiece serialized,
                               Result* result) {
+  FastParseExampleConfigIndex config_index;
+  TF_RETURN_IF_ERROR(config_index.Init(config));
+  return FastParseSingleExample(config, config_index, serialized, result);
+}
+
+Status FastParseSingleExample(const Config& config,
+                              const FastParseExampleConfigIndex& config_index,
+                              StringPiece serialized, Result* result) {
   DCHECK(result != nullptr);
   // Check config so we can safely CHECK(false) in switches on config.*.dtype
   TF_RETURN_IF_ERROR(CheckConfigDataTypes(config));
@@ -1459,38 +1548,6 @@ Status FastParseSingleExample(const Config& config, StringPiece serialized,
     stats = &result->feature_stats.back();
   }
 
-  // TODO(mrry): Cache the construction of this map at Op construction time.
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return errors::Internal(
-        "Could not avoid collision. This should not happen.");
-  }
-
   result->sparse_indices.reserve(config.sparse.size());
   result->sparse_values.reserve(config.sparse.size());
   result->sparse_shapes.reserve(config.sparse.size());
@@ -1559,8 +1616,7 @@ Status FastParseSingleExample(const Config& config, StringPiece serialized,
     parsed::Feature& feature = name_and_feature.second;
 
     std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    if (!config_index.Find(feature_name, &d_and_type)) continue;
 
     size_t d = d_and_type.first;
     bool is_dense = d_and_type.second == Type::Dense;
@@ -1568,7 +1624,6 @@ Status FastParseSingleExample(const Config& config, StringPiece serialized,
 
     {
       // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
       const tstring& config_feature_name =
           is_dense ? config.dense[d].feature_name
                    : (is_sparse ? config.sparse[d].feature_name
@@ -1981,15 +2036,14 @@ inline int ParseInt64Feature(protobuf::io::CodedInputStream* stream,
         return -1;
       }
       auto packed_limit = stream->PushLimit(packed_length);
-      while (!stream->ExpectAtEnd()) {
-        protobuf_uint64 n;  // There is no API for int64
-        if (!stream->ReadVarint64(&n)) {
-          return -1;
-        }
-        if (out != nullptr) {
-          *out++ = n;
-        }
-        num_elements++;
+      const uint8* begin;
+      const uint8* end;
+      if (!ReadRawUntilLimit(stream, &begin, &end)) {
+        return -1;
+      }
+      num_elements = CountVarints(begin, end);
+      if (out != nullptr && !DecodeVarints(begin, end, out, num_elements)) {
+        return -1;
       }
       stream->PopLimit(packed_limit);
     } else if (peek_tag == kVarintTag(1)) {
@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/presized_cuckoo_map.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
 namespace tensorflow {
@@ -98,6 +99,34 @@ struct FastParseExampleConfig {
   bool collect_feature_stats = false;
 };
 
+// Index from the feature names of a FastParseExampleConfig to its
+// sub-configs. FastParse[Single]Example build one on each call unless they
+// are given one, so callers parsing many batches with the same feature names
+// should build it once and reuse it.
+class FastParseExampleConfigIndex {
+ public:
+  enum class Type { Dense, Sparse, Ragged };
+
+  FastParseExampleConfigIndex() : index_(0) {}
+
+  // Indexes the feature names of `config`. Sub-configs are identified by
+  // their position in `config.dense`, `config.sparse` or `config.ragged`.
+  Status Init(const FastParseExampleConfig& config);
+
+  // Looks up the sub-config that `feature_name` may belong to. Hashes of
+  // names outside the config can collide with it, so callers must compare
+  // `feature_name` with the name of the sub-config found.
+  bool Find(StringPiece feature_name,
+            std::pair<size_t, Type>* d_and_type) const;
+
+ private:
+  uint64 seed_ = 0;
+  PresizedCuckooMap<std::pair<size_t, Type>> index_;
+
+  FastParseExampleConfigIndex(const FastParseExampleConfigIndex&) = delete;
+  void operator=(const FastParseExampleConfigIndex&) = delete;
+};
+
 // Statistics about the features in each example passed to
 // `FastParse[Single]Example()`.
 //
@@ -139,12 +168,23 @@ Status FastParseExample(const FastParseExampleConfig& config,
                         absl::Span<const tstring> example_names,
                         thread::ThreadPool* thread_pool, Result* result);
 
-// TODO(mrry): Move the hash table construction into the config object.
+// As above, with `config_index` built by `config_index.Init(config)`.
+Status FastParseExample(const FastParseExampleConfig& config,
+                        const FastParseExampleConfigIndex& config_index,
+                        absl::Span<const tstring> serialized,
+                        absl::Span<const tstring> example_names,
+                        thread::ThreadPool* thread_pool, Result* result);
+
 typedef FastParseExampleConfig FastParseSingleExampleConfig;
 
 Status FastParseSingleExample(const FastParseSingleExampleConfig& config,
                               StringPiece serialized, Result* result);
 
+// As above, with `config_index` built by `config_index.Init(config)`.
+Status FastParseSingleExample(const FastParseSingleExampleConfig& config,
+                              const FastParseExampleConfigIndex& config_index,
+                              StringPiece serialized, Result* result);
+
 // Parses a batch of serialized SequenceExample protos and converts them into
 // result according to given config.
 // Given example names have to either be empty or the same size as serialized.
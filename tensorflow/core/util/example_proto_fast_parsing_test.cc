@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <limits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -219,6 +220,27 @@ TEST(FastParse, SingleInt64) {
   TestCorrectness(Serialize(example));
 }
 
+// Values whose varints take every length from one to ten bytes.
+static std::vector<int64_t> Int64sOfEveryWidth() {
+  std::vector<int64_t> values = {std::numeric_limits<int64_t>::min(), -1};
+  for (int64_t v = 1; v > 0 && v <= std::numeric_limits<int64_t>::max() / 2;
+       v *= 2) {
+    values.push_back(v - 1);
+    values.push_back(v);
+  }
+  values.push_back(std::numeric_limits<int64_t>::max());
+  return values;
+}
+
+TEST(FastParse, PackedInt64sOfEveryWidth) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["ids"]
+          .mutable_int64_list();
+  for (const int64_t v : Int64sOfEveryWidth()) int64_list->add_value(v);
+  TestCorrectness(Serialize(example));
+}
+
 static string ExampleWithSomeFeatures() {
   Example example;
 
@@ -277,6 +299,55 @@ static void AddSparseFeature(const char* feature_name, DataType dtype,
   new_feature.dtype = dtype;
 }
 
+TEST(FastParse, DensePackedInt64s) {
+  const std::vector<int64_t> values = Int64sOfEveryWidth();
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["ids"]
+          .mutable_int64_list();
+  for (const int64_t v : values) int64_list->add_value(v);
+  const std::vector<tstring> serialized = {Serialize(example)};
+
+  const int64_t num_values = values.size();
+  FastParseExampleConfig config;
+  AddDenseFeature("ids", DT_INT64, {num_values}, false, num_values, &config);
+  Result result;
+  TF_CHECK_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  const auto parsed = result.dense_values[0].flat<int64_t>();
+  ASSERT_EQ(parsed.size(), num_values);
+  for (int64_t i = 0; i < num_values; ++i) EXPECT_EQ(parsed(i), values[i]);
+
+  FastParseExampleConfig short_config;
+  AddDenseFeature("ids", DT_INT64, {num_values - 1}, false, num_values - 1,
+                  &short_config);
+  Result short_result;
+  EXPECT_TRUE(absl::IsInvalidArgument(FastParseExample(
+      short_config, serialized, {}, nullptr, &short_result)));
+}
+
+TEST(FastParse, ReusesConfigIndex) {
+  const std::vector<tstring> serialized = {ExampleWithSomeFeatures()};
+  FastParseExampleConfig config;
+  AddDenseFeature("int64_list", DT_INT64, {3}, false, 3, &config);
+  AddSparseFeature("float_list", DT_FLOAT, &config);
+  FastParseExampleConfigIndex config_index;
+  TF_CHECK_OK(config_index.Init(config));
+
+  for (int i = 0; i < 2; ++i) {
+    Result result;
+    TF_CHECK_OK(FastParseExample(config, config_index, serialized, {},
+                                 nullptr, &result));
+    EXPECT_EQ(result.dense_values[0].flat<int64_t>()(1), 270);
+    EXPECT_EQ(result.sparse_values[0].NumElements(), 2);
+
+    Result single_result;
+    TF_CHECK_OK(FastParseSingleExample(config, config_index, serialized[0],
+                                       &single_result));
+    EXPECT_EQ(single_result.dense_values[0].flat<int64_t>()(1), 270);
+    EXPECT_EQ(single_result.sparse_values[0].NumElements(), 2);
+  }
+}
+
 TEST(FastParse, StatsCollection) {
   const size_t kNumExamples = 13;
   std::vector<tstring> serialized(kNumExamples, ExampleWithSomeFeatures());
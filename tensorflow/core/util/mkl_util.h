@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_MKL_UTIL_H_
 #ifdef INTEL_MKL
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <string>
@@ -25,6 +26,7 @@ limitations under the License.
 #include <vector>
 
 #include "dnnl.hpp"
+#include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -1879,12 +1881,15 @@ class LRUCache {
     return it->second.op;
   }
 
-  void SetOp(const string& key, T* op) {
+  // Returns whether the least recently accessed entry was evicted to make
+  // room for `op`.
+  bool SetOp(const string& key, T* op) {
 #if defined(DNNL_AARCH64_USE_ACL) && defined(ENABLE_ONEDNN_OPENMP)
     mutex_lock lock(lru_mu_);
 #endif
+    bool evicted = false;
     if (lru_list_.size() >= capacity_) {
-      Delete();
+      evicted = Delete();
     }
 
     // Insert an entry to the front of the LRU list
@@ -1894,6 +1899,7 @@ class LRUCache {
 #if defined(DNNL_AARCH64_USE_ACL) && defined(ENABLE_ONEDNN_OPENMP)
     FinishedAllocation(key);
 #endif
+    return evicted;
   }
 
   void Clear() {
@@ -1990,7 +1996,9 @@ class MklPrimitiveFactory {
   MklPrimitive* GetOp(const string& key) {
 #if !defined(DNNL_AARCH64_USE_ACL) || !defined(ENABLE_ONEDNN_OPENMP)
     auto& lru_cache = MklPrimitiveFactory<T>::GetLRUCache();
-    return lru_cache.GetOp(key);
+    MklPrimitive* primitive = lru_cache.GetOp(key);
+    metrics::RecordMklPrimitiveCacheLookup(/*hit=*/primitive != nullptr);
+    return primitive;
 #else
     while (true) {
       // TODO(milpuz01): Consider if it is possible to narrow scope to be
@@ -2001,6 +2009,7 @@ class MklPrimitiveFactory {
       // Check to see whether primitive already exists.
       MklPrimitive* primitive = lru_cache.GetOp(key);
       if (primitive != nullptr) {
+        metrics::RecordMklPrimitiveCacheLookup(/*hit=*/true);
         return primitive;
       }
 
@@ -2008,6 +2017,7 @@ class MklPrimitiveFactory {
       if (!lru_cache.IsAllocating(key)) {
         // This thread is going to pick it up and create the primitive.
         lru_cache.Allocate(key);
+        metrics::RecordMklPrimitiveCacheLookup(/*hit=*/false);
         return nullptr;
         // Now we release lock as primitive creation might take long time.
       }
@@ -2026,12 +2036,12 @@ class MklPrimitiveFactory {
   void SetOp(const string& key, MklPrimitive* op) {
 #if !defined(DNNL_AARCH64_USE_ACL) || !defined(ENABLE_ONEDNN_OPENMP)
     auto& lru_cache = MklPrimitiveFactory<T>::GetLRUCache();
-    lru_cache.SetOp(key, op);
+    if (lru_cache.SetOp(key, op)) metrics::RecordMklPrimitiveCacheEviction();
 #else
     {
       mutex_lock lock(primitive_creation_mu_);
       auto& lru_cache = MklPrimitiveFactory<T>::GetLRUCache();
-      lru_cache.SetOp(key, op);
+      if (lru_cache.SetOp(key, op)) metrics::RecordMklPrimitiveCacheEviction();
     }
 
     // Now we can inform all waiting threads that primitive is created.
@@ -2072,12 +2082,25 @@ class MklPrimitiveFactory {
 #endif
 
  private:
+  // Capacity of the cache of each factory (and thread, unless the cache is
+  // shared), from TF_MKL_PRIMITIVE_CACHE_CAPACITY. Serving many shapes needs a
+  // larger one to not keep recreating the primitives.
+  static inline size_t GetLRUCacheCapacity() {
+    static const size_t capacity = [] {
+      int64_t value;
+      TF_CHECK_OK(ReadInt64FromEnvVar("TF_MKL_PRIMITIVE_CACHE_CAPACITY",
+                                      /*default_val=*/1024, &value));
+      return static_cast<size_t>(std::max<int64_t>(value, 1));
+    }();
+    return capacity;
+  }
+
   static inline LRUCache<MklPrimitive>& GetLRUCache() {
-    static const int kCapacity = 1024;  // cache capacity
 #if !defined(DNNL_AARCH64_USE_ACL) || !defined(ENABLE_ONEDNN_OPENMP)
-    static thread_local LRUCache<MklPrimitive> lru_cache_(kCapacity);
+    static thread_local LRUCache<MklPrimitive> lru_cache_(
+        GetLRUCacheCapacity());
 #else
-    static LRUCache<MklPrimitive> lru_cache_(kCapacity);
+    static LRUCache<MklPrimitive> lru_cache_(GetLRUCacheCapacity());
 #endif
     return lru_cache_;
   }
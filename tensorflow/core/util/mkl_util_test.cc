@@ -60,9 +60,10 @@ TEST(MklUtilTest, LRUCacheTest) {
   size_t num_objects = capacity + 10;
   LRUCache<int> lru_cache(capacity);
 
-  // Test SetOp: be able to set more ops than the capacity
+  // Test SetOp: be able to set more ops than the capacity, evicting the least
+  // recently accessed ones once full.
   for (int k = 0; k < num_objects; k++) {
-    lru_cache.SetOp(std::to_string(k), new int(k));
+    EXPECT_EQ(lru_cache.SetOp(std::to_string(k), new int(k)), k >= capacity);
   }
 
   // Test GetOp and capacity:
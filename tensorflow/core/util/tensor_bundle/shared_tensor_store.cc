@@ -0,0 +1,137 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+
+// Aliases the buffer of the first tensor added with its contents, and removes
+// itself from the store when the last tensor referring to it is destroyed.
+class SharedTensorStore::SharedBuffer : public TensorBuffer {
+ public:
+  SharedBuffer(SharedTensorStore* store, uint64_t fingerprint,
+               const Tensor& tensor)
+      : TensorBuffer(const_cast<char*>(tensor.tensor_data().data())),
+        store_(store),
+        fingerprint_(fingerprint),
+        tensor_(tensor) {}
+
+  ~SharedBuffer() override { store_->Remove(fingerprint_, this); }
+
+  size_t size() const override { return tensor_.TotalBytes(); }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size());
+    proto->set_allocator_name("SharedTensorStore");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // Tensor::RefCountIsOne() returns false for buffers that don't own their
+  // memory, so shared buffers are never forwarded to outputs or updated in
+  // place, even while they have a single reference.
+  bool OwnsMemory() const override { return false; }
+
+  // Takes a reference, unless the last one was already dropped.
+  bool TryRef() const { return TensorBuffer::TryRef(); }
+
+  bool Matches(const Tensor& tensor) const {
+    return tensor.dtype() == tensor_.dtype() &&
+           tensor.shape() == tensor_.shape() &&
+           tensor.tensor_data() == tensor_.tensor_data();
+  }
+
+ private:
+  SharedTensorStore* const store_;
+  const uint64_t fingerprint_;
+  const Tensor tensor_;
+};
+
+SharedTensorStore* SharedTensorStore::Global() {
+  static SharedTensorStore* store = new SharedTensorStore;
+  return store;
+}
+
+SharedTensorStore::~SharedTensorStore() {
+  mutex_lock l(mu_);
+  DCHECK_EQ(size_, 0) << "Tensors from a SharedTensorStore outlived it";
+}
+
+bool SharedTensorStore::CanDeduplicate(DataType dtype) {
+  return DataTypeCanUseMemcpy(dtype);
+}
+
+Tensor SharedTensorStore::Deduplicate(const Tensor& tensor) {
+  if (!CanDeduplicate(tensor.dtype()) || !tensor.IsInitialized() ||
+      tensor.TotalBytes() == 0) {
+    return tensor;
+  }
+  const StringPiece data = tensor.tensor_data();
+  uint64_t fingerprint = Hash64Combine(Hash64(data.data(), data.size()),
+                                       static_cast<uint64_t>(tensor.dtype()));
+  for (const int64_t dim_size : tensor.shape().dim_sizes()) {
+    fingerprint = Hash64Combine(fingerprint, dim_size);
+  }
+
+  mutex_lock l(mu_);
+  std::vector<SharedBuffer*>& buffers = buffers_[fingerprint];
+  SharedBuffer* shared_buffer = nullptr;
+  for (SharedBuffer* buffer : buffers) {
+    // A buffer whose last reference was just dropped is waiting on `mu_` to
+    // remove itself, and must not be revived.
+    if (buffer->Matches(tensor) && buffer->TryRef()) {
+      shared_buffer = buffer;
+      break;
+    }
+  }
+  if (shared_buffer == nullptr) {
+    shared_buffer = new SharedBuffer(this, fingerprint, tensor);
+    buffers.push_back(shared_buffer);
+    ++size_;
+  }
+  Tensor shared(tensor.dtype(), tensor.shape(), shared_buffer);
+  // The reference from TryRef() or the constructor is now held by `shared`.
+  shared_buffer->Unref();
+  return shared;
+}
+
+size_t SharedTensorStore::size() const {
+  mutex_lock l(mu_);
+  return size_;
+}
+
+void SharedTensorStore::Remove(uint64_t fingerprint, SharedBuffer* buffer) {
+  mutex_lock l(mu_);
+  auto it = buffers_.find(fingerprint);
+  DCHECK(it != buffers_.end());
+  std::vector<SharedBuffer*>& buffers = it->second;
+  buffers.erase(std::find(buffers.begin(), buffers.end(), buffer));
+  if (buffers.empty()) {
+    buffers_.erase(it);
+  }
+  --size_;
+}
+
+}  // namespace tensorflow
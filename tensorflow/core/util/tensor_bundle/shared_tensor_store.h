@@ -0,0 +1,78 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
+#define TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// A process-wide, content-addressed store of restored tensors. When several
+// sessions in one process restore the same values (e.g. several versions or
+// replicas of one SavedModel), each distinct value is held in a single
+// buffer, shared by all of the sessions.
+//
+// Shared buffers are read-only: Tensor::RefCountIsOne() is false for them, so
+// variable updates copy them first (copy-on-write), and ops never forward
+// them to their outputs.
+//
+// The store does not keep tensors alive: an entry is dropped as soon as the
+// last tensor referring to it is destroyed.
+class SharedTensorStore {
+ public:
+  static SharedTensorStore* Global();
+
+  SharedTensorStore() = default;
+  ~SharedTensorStore();
+
+  // Returns a tensor with the same dtype, shape and contents as `tensor`. If
+  // the store holds such a tensor, it is returned, and `tensor`'s buffer can
+  // be released by the caller; otherwise `tensor` is added to the store.
+  //
+  // Returns `tensor` itself if its dtype can't be shared (e.g. DT_STRING or
+  // DT_VARIANT).
+  Tensor Deduplicate(const Tensor& tensor);
+
+  // Returns whether tensors of `dtype` can be deduplicated.
+  static bool CanDeduplicate(DataType dtype);
+
+  // Returns the number of distinct tensors in the store.
+  size_t size() const;
+
+ private:
+  class SharedBuffer;
+
+  void Remove(uint64_t fingerprint, SharedBuffer* buffer);
+
+  mutable mutex mu_;
+  // Keyed by a fingerprint of the dtype, shape and contents, so buffers are
+  // compared byte-wise only on a fingerprint match. Not owned: a buffer
+  // removes itself when it is destroyed.
+  absl::flat_hash_map<uint64_t, std::vector<SharedBuffer*>> buffers_
+      TF_GUARDED_BY(mu_);
+  size_t size_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
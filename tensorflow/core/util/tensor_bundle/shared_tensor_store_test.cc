@@ -0,0 +1,82 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(SharedTensorStoreTest, SharesEqualTensors) {
+  SharedTensorStore store;
+  {
+    Tensor a = test::AsTensor<float>({1, 2, 3, 4}, TensorShape({2, 2}));
+    Tensor b = test::AsTensor<float>({1, 2, 3, 4}, TensorShape({2, 2}));
+    Tensor shared_a = store.Deduplicate(a);
+    Tensor shared_b = store.Deduplicate(b);
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_EQ(shared_a.data(), a.data());
+    EXPECT_EQ(shared_b.data(), a.data());
+    test::ExpectTensorEqual<float>(shared_b, b);
+
+    // Shared tensors are never updated in place.
+    EXPECT_FALSE(shared_a.RefCountIsOne());
+  }
+  EXPECT_EQ(store.size(), 0);
+}
+
+TEST(SharedTensorStoreTest, DistinguishesContentsDtypesAndShapes) {
+  SharedTensorStore store;
+  Tensor a = store.Deduplicate(
+      test::AsTensor<float>({1, 2, 3, 4}, TensorShape({2, 2})));
+  Tensor b = store.Deduplicate(
+      test::AsTensor<float>({1, 2, 3, 5}, TensorShape({2, 2})));
+  Tensor c = store.Deduplicate(
+      test::AsTensor<float>({1, 2, 3, 4}, TensorShape({4})));
+  Tensor d = store.Deduplicate(
+      test::AsTensor<int32>({1, 2, 3, 4}, TensorShape({2, 2})));
+  EXPECT_EQ(store.size(), 4);
+  EXPECT_NE(a.data(), b.data());
+  EXPECT_NE(a.data(), c.data());
+  test::ExpectTensorEqual<float>(
+      b, test::AsTensor<float>({1, 2, 3, 5}, TensorShape({2, 2})));
+}
+
+TEST(SharedTensorStoreTest, DropsUnusedTensors) {
+  SharedTensorStore store;
+  Tensor a = test::AsTensor<float>({1, 2, 3, 4});
+  store.Deduplicate(a);
+  EXPECT_EQ(store.size(), 0);
+
+  // A new tensor with the same contents is added again.
+  Tensor shared = store.Deduplicate(test::AsTensor<float>({1, 2, 3, 4}));
+  EXPECT_EQ(store.size(), 1);
+  EXPECT_NE(shared.data(), a.data());
+}
+
+TEST(SharedTensorStoreTest, DoesNotShareStrings) {
+  SharedTensorStore store;
+  Tensor a = test::AsTensor<tstring>({"a", "b"});
+  Tensor shared = store.Deduplicate(a);
+  EXPECT_EQ(store.size(), 0);
+  EXPECT_EQ(shared.data(), a.data());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -20,10 +20,14 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/call_once.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "xla/tsl/util/byte_swap_array.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -42,6 +46,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/table_builder.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/cord.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mem.h"
@@ -81,9 +86,41 @@ const int64_t kLargeTensorThreshold = static_cast<int64_t>(1) << 32;
 const int kMaxFileReadThreads = 8;
 // Minimum size of a file section handled by each thread.
 const int64_t kMinSectionSize = static_cast<int64_t>(1) << 31;
+// Maximum size of a read that coalesces several entries in LookupMany().
+const int64_t kMaxCoalescedReadSize = 16 << 20;
+// Maximum gap (e.g. alignment padding) between two entries that are coalesced
+// into a single read.
+const int64_t kMaxCoalescedReadGap = 64 << 10;
 
 namespace {
 
+// A tensor buffer that aliases a tensor's bytes in a memory-mapped data file.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     uint64 offset, size_t size)
+      : TensorBuffer(const_cast<char*>(
+            static_cast<const char*>(region->data()) + offset)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("MappedTensorBundle");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // The mapping is read-only, so tensors with this buffer must never be
+  // forwarded or updated in place.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 // Reads "num_elements" string elements from file[offset, offset+size) into the
 // length-N "destination".  Discards the original content of "destination".
 //
@@ -1033,6 +1070,189 @@ Status BundleReader::Lookup(StringPiece key, Tensor* val) {
   }
 }
 
+Status BundleReader::LookupMany(absl::Span<const std::string> keys,
+                                absl::Span<Tensor* const> vals,
+                                thread::ThreadPool* pool) {
+  CHECK_EQ(keys.size(), vals.size());
+  struct EntryRead {
+    BundleEntryProto entry;
+    Tensor* val;
+  };
+  std::vector<EntryRead> entry_reads;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    CHECK(vals[i] != nullptr);
+    BundleEntryProto entry;
+    TF_RETURN_IF_ERROR(GetBundleEntryProto(keys[i], &entry));
+    if (!entry.slices().empty()) {
+      TF_RETURN_IF_ERROR(GetSliceValue(
+          keys[i], entry,
+          /* a full slice */ TensorSlice(TensorShape(entry.shape()).dims()),
+          vals[i]));
+    } else if (!DataTypeCanUseMemcpy(entry.dtype()) ||
+               vals[i]->NumElements() == 0) {
+      TF_RETURN_IF_ERROR(GetValue(entry, vals[i]));
+    } else if (entry.size() != vals[i]->TotalBytes()) {
+      return errors::DataLoss("Invalid size in bundle entry: key ", keys[i],
+                              "; stored size ", entry.size(),
+                              "; expected size ", vals[i]->TotalBytes());
+    } else {
+      entry_reads.push_back({std::move(entry), vals[i]});
+    }
+  }
+  absl::c_sort(entry_reads, [](const EntryRead& a, const EntryRead& b) {
+    if (a.entry.shard_id() != b.entry.shard_id()) {
+      return a.entry.shard_id() < b.entry.shard_id();
+    }
+    return a.entry.offset() < b.entry.offset();
+  });
+
+  // Coalesces runs of entries that are (nearly) adjacent in a data file.
+  struct CoalescedRead {
+    int32_t shard_id;
+    int64_t offset;
+    int64_t size;
+    std::vector<const EntryRead*> entry_reads;
+  };
+  std::vector<CoalescedRead> reads;
+  for (const EntryRead& entry_read : entry_reads) {
+    const BundleEntryProto& entry = entry_read.entry;
+    if (!reads.empty()) {
+      CoalescedRead& read = reads.back();
+      const int64_t end = read.offset + read.size;
+      if (read.shard_id == entry.shard_id() && entry.offset() >= end &&
+          entry.offset() - end <= kMaxCoalescedReadGap &&
+          entry.offset() + entry.size() - read.offset <=
+              kMaxCoalescedReadSize) {
+        read.size = entry.offset() + entry.size() - read.offset;
+        read.entry_reads.push_back(&entry_read);
+        continue;
+      }
+    }
+    reads.push_back({entry.shard_id(), entry.offset(),
+                     static_cast<int64_t>(entry.size()), {&entry_read}});
+  }
+
+  auto run_read = [this](const CoalescedRead& read) -> Status {
+    RandomAccessFile* file = nullptr;
+    TF_RETURN_IF_ERROR(cache_->GetFile(
+        DataFilename(prefix_, read.shard_id, num_shards_), &file));
+    // A single entry is read straight into its tensor.
+    std::unique_ptr<char[]> scratch;
+    char* buffer;
+    if (read.entry_reads.size() == 1) {
+      buffer = const_cast<char*>(
+          read.entry_reads[0]->val->tensor_data().data());
+    } else {
+      scratch.reset(new char[read.size]);
+      buffer = scratch.get();
+    }
+    StringPiece sp;
+    TF_RETURN_IF_ERROR(file->Read(read.offset, read.size, &sp, buffer));
+    if (sp.size() != read.size) {
+      return errors::DataLoss("TensorBundle at ", prefix_, " shard ",
+                              read.shard_id, ": requested ", read.size,
+                              " bytes at offset ", read.offset, ", read ",
+                              sp.size());
+    }
+    for (const EntryRead* entry_read : read.entry_reads) {
+      const BundleEntryProto& entry = entry_read->entry;
+      char* backing_buffer =
+          const_cast<char*>(entry_read->val->tensor_data().data());
+      const char* data = sp.data() + (entry.offset() - read.offset);
+      if (data != backing_buffer) {
+        memmove(backing_buffer, data, entry.size());
+      }
+      // As in GetValue(), the checksum is on the bytes in file order.
+      const uint32 actual_crc32c = crc32c::Value(backing_buffer, entry.size());
+      if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+        return errors::DataLoss(
+            "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+            entry.size(), " bytes): Checksum does not match: stored ",
+            strings::Printf("%08u", crc32c::Unmask(entry.crc32c())),
+            " vs. calculated on the restored bytes ", actual_crc32c);
+      }
+      if (need_to_swap_bytes_) {
+        TF_RETURN_IF_ERROR(ByteSwapTensor(entry_read->val));
+      }
+    }
+    return absl::OkStatus();
+  };
+
+  if (pool == nullptr || reads.size() <= 1) {
+    for (const CoalescedRead& read : reads) {
+      TF_RETURN_IF_ERROR(run_read(read));
+    }
+    return absl::OkStatus();
+  }
+  std::vector<Status> statuses(reads.size());
+  BlockingCounter counter(reads.size());
+  for (size_t i = 0; i < reads.size(); ++i) {
+    pool->Schedule([&, i]() {
+      statuses[i] = run_read(reads[i]);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+Status BundleReader::LookupMapped(StringPiece key, Tensor* val,
+                                  bool* is_mapped) {
+  CHECK(val != nullptr);
+  *is_mapped = false;
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  const TensorShape shape(entry.shape());
+  if (!entry.slices().empty() || !DataTypeCanUseMemcpy(entry.dtype()) ||
+      need_to_swap_bytes_ || shape.num_elements() == 0 ||
+      entry.offset() % Allocator::kAllocatorAlignment != 0) {
+    return absl::OkStatus();
+  }
+  const size_t expected_size =
+      shape.num_elements() * DataTypeSize(entry.dtype());
+  if (entry.size() != expected_size) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key,
+                            "; stored size ", entry.size(),
+                            "; expected size ", expected_size);
+  }
+
+  auto it = mapped_data_.find(entry.shard_id());
+  if (it == mapped_data_.end()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    const Status s = env_->NewReadOnlyMemoryRegionFromFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+    if (!s.ok()) {
+      VLOG(1) << "Unable to map data file " << entry.shard_id() << " of "
+              << prefix_ << ", falling back to reading it: " << s;
+    }
+    it = mapped_data_.emplace(entry.shard_id(), std::move(region)).first;
+  }
+  const std::shared_ptr<ReadOnlyMemoryRegion>& region = it->second;
+  if (region == nullptr) {
+    return absl::OkStatus();
+  }
+  if (entry.offset() + entry.size() > region->length()) {
+    return errors::DataLoss("TensorBundle at ", prefix_, " shard ",
+                            entry.shard_id(), ": entry ", key, " at offset ",
+                            entry.offset(), " of ", entry.size(),
+                            " bytes is past the end of the file");
+  }
+  if (reinterpret_cast<uintptr_t>(region->data()) %
+          Allocator::kAllocatorAlignment !=
+      0) {
+    return absl::OkStatus();
+  }
+
+  auto* buffer = new MappedTensorBuffer(region, entry.offset(), entry.size());
+  *val = Tensor(entry.dtype(), shape, buffer);
+  buffer->Unref();
+  *is_mapped = true;
+  return absl::OkStatus();
+}
+
 Status BundleReader::ReadCurrent(Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
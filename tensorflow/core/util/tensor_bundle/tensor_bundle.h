@@ -72,10 +72,12 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
@@ -291,6 +293,41 @@ class BundleReader {
                      const TensorSlice& slice_spec,
                      Tensor* val) TF_MUST_USE_RESULT;
 
+  // Looks up the tensors keyed by "keys" into "vals", with the same
+  // requirements and checks as Lookup().
+  //
+  // Reads the data of non-partitioned, memcpy-able tensors with few large
+  // reads: their entries are sorted by shard and offset, and entries that are
+  // (nearly) adjacent in a data file are coalesced into a single read. If
+  // "pool" is not null, the coalesced reads are issued concurrently on it.
+  // Other tensors are read one at a time, as by Lookup().
+  //
+  // On error, "vals" may contain nonsense data.
+  // REQUIRES: status().ok()
+  Status LookupMany(absl::Span<const std::string> keys,
+                    absl::Span<Tensor* const> vals,
+                    thread::ThreadPool* pool = nullptr) TF_MUST_USE_RESULT;
+
+  // Looks up the tensor keyed by "key" without copying its contents: on
+  // success, sets "*is_mapped" to true and "*val" to a tensor whose buffer
+  // aliases a read-only memory mapping of the data file. The mapping lives as
+  // long as any tensor refers to it, and is shared with other processes
+  // through the page cache. Such tensors are never updated in place (see
+  // Tensor::RefCountIsOne()), so variables restored from them are copied on
+  // their first write.
+  //
+  // Sets "*is_mapped" to false and leaves "*val" untouched if the tensor
+  // can't be mapped: if it is partitioned, not memcpy-able, of another
+  // endianness, not aligned in the data file (see
+  // BundleWriter::Options::data_alignment), or if the file system doesn't
+  // support mapping files.
+  //
+  // Unlike Lookup(), does not validate the checksum, since that would read
+  // every page of the tensor.
+  // REQUIRES: status().ok()
+  Status LookupMapped(absl::string_view key, Tensor* val,
+                      bool* is_mapped) TF_MUST_USE_RESULT;
+
   // Seeks to the first position in the bundle whose key is no less than "key".
   // REQUIRES: status().ok()
   void Seek(absl::string_view key) { return iter_->Seek(key); }
@@ -344,6 +381,11 @@ class BundleReader {
   // Owned InputBuffer objects. cache_ owns the underlying RandomAccessFiles.
   std::unordered_map<int32_t, io::InputBuffer*> data_;
 
+  // Memory mappings of the data files, shared with the tensors returned by
+  // LookupMapped(). Null if the file can't be mapped.
+  std::unordered_map<int32_t, std::shared_ptr<ReadOnlyMemoryRegion>>
+      mapped_data_;
+
   // Maps each partitioned tensor's key to its stored slices (represented in a
   // TensorSliceSet).  Populated on-demand.
   std::unordered_map<std::string, checkpoint::TensorSliceSet*> tensor_slices_;
@@ -24,6 +24,7 @@ limitations under the License.
 #endif  // _WIN32
 
 #include "absl/status/status.h"
+#include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -954,6 +955,117 @@ TEST(TensorBundleTest, SortForSequentialAccess) {
                           "tensor-1-2", "tensor-1-1", "tensor-1-0"));
 }
 
+TEST(TensorBundleTest, LookupMany) {
+  const string kPrefix = Prefix("lookup_many");
+  {
+    // Pads the entries, so some coalesced reads skip over gaps.
+    BundleWriter::Options opts;
+    opts.data_alignment = 32;
+    BundleWriter writer(Env::Default(), kPrefix, opts);
+    for (int i = 0; i < 10; ++i) {
+      TF_EXPECT_OK(writer.Add(strings::StrCat("float-", i),
+                              Constant(static_cast<float>(i),
+                                       TensorShape({i + 1, 3}))));
+    }
+    TF_EXPECT_OK(writer.Add("int", Constant_100x100<int32>(7)));
+    TF_EXPECT_OK(writer.Add("string", Constant_2x3<tstring>("hello")));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  BundleReader reader(Env::Default(), kPrefix);
+  TF_ASSERT_OK(reader.status());
+  // Not in file order, to exercise the sorting.
+  std::vector<string> keys = {"string", "int"};
+  for (int i = 9; i >= 0; --i) {
+    keys.push_back(strings::StrCat("float-", i));
+  }
+  thread::ThreadPool pool(Env::Default(), "lookup_many", 4);
+  for (thread::ThreadPool* p : {static_cast<thread::ThreadPool*>(nullptr),
+                                &pool}) {
+    std::vector<Tensor> vals;
+    for (const string& key : keys) {
+      DataType dtype;
+      TensorShape shape;
+      TF_ASSERT_OK(reader.LookupDtypeAndShape(key, &dtype, &shape));
+      vals.emplace_back(dtype, shape);
+    }
+    std::vector<Tensor*> val_ptrs;
+    for (Tensor& val : vals) {
+      val_ptrs.push_back(&val);
+    }
+    TF_ASSERT_OK(reader.LookupMany(keys, val_ptrs, p));
+
+    test::ExpectTensorEqual<tstring>(vals[0], Constant_2x3<tstring>("hello"));
+    test::ExpectTensorEqual<int32>(vals[1], Constant_100x100<int32>(7));
+    for (int i = 0; i < 10; ++i) {
+      test::ExpectTensorEqual<float>(
+          vals[11 - i],
+          Constant(static_cast<float>(i), TensorShape({i + 1, 3})));
+    }
+  }
+
+  Tensor val(DT_FLOAT, TensorShape({1, 3}));
+  EXPECT_TRUE(errors::IsNotFound(reader.LookupMany({"missing"}, {&val})));
+}
+
+TEST(TensorBundleTest, LookupMapped) {
+  const string kPrefix = Prefix("lookup_mapped");
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = Allocator::kAllocatorAlignment;
+    BundleWriter writer(Env::Default(), kPrefix, opts);
+    TF_EXPECT_OK(writer.Add("float", Constant_2x3<float>(1.5)));
+    TF_EXPECT_OK(writer.Add("int", Constant_100x100<int32>(7)));
+    TF_EXPECT_OK(writer.Add("string", Constant_2x3<tstring>("hello")));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  Tensor mapped_float;
+  Tensor mapped_int;
+  {
+    BundleReader reader(Env::Default(), kPrefix);
+    TF_ASSERT_OK(reader.status());
+    bool is_mapped;
+    TF_ASSERT_OK(reader.LookupMapped("float", &mapped_float, &is_mapped));
+    EXPECT_TRUE(is_mapped);
+    TF_ASSERT_OK(reader.LookupMapped("int", &mapped_int, &is_mapped));
+    EXPECT_TRUE(is_mapped);
+
+    Tensor string_val;
+    TF_ASSERT_OK(reader.LookupMapped("string", &string_val, &is_mapped));
+    EXPECT_FALSE(is_mapped);
+    EXPECT_FALSE(string_val.IsInitialized());
+
+    EXPECT_TRUE(
+        errors::IsNotFound(reader.LookupMapped("missing", &string_val,
+                                               &is_mapped)));
+  }
+
+  // The mapped tensors outlive the reader, and are never updated in place.
+  test::ExpectTensorEqual<float>(mapped_float, Constant_2x3<float>(1.5));
+  test::ExpectTensorEqual<int32>(mapped_int, Constant_100x100<int32>(7));
+  EXPECT_FALSE(mapped_float.RefCountIsOne());
+}
+
+TEST(TensorBundleTest, LookupMappedUnaligned) {
+  const string kPrefix = Prefix("lookup_mapped_unaligned");
+  {
+    BundleWriter writer(Env::Default(), kPrefix);
+    TF_EXPECT_OK(writer.Add("a", Constant(1.f, TensorShape({3}))));
+    TF_EXPECT_OK(writer.Add("b", Constant(2.f, TensorShape({3}))));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  BundleReader reader(Env::Default(), kPrefix);
+  TF_ASSERT_OK(reader.status());
+  // "b" starts 12 bytes into the data file.
+  Tensor val;
+  bool is_mapped;
+  TF_ASSERT_OK(reader.LookupMapped("b", &val, &is_mapped));
+  EXPECT_FALSE(is_mapped);
+  Expect<float>(&reader, "b", Constant(2.f, TensorShape({3})));
+}
+
 TEST(TensorBundleTest, Error) {
   {  // Dup keys.
     BundleWriter writer(Env::Default(), Prefix("dup"));
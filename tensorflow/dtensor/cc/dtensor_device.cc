@@ -2174,6 +2174,27 @@ void DTensorDevice::ExecuteRegularOperation(
                                    inputs.size(), step_id, status);
   }
 
+  // Dispatch the functions on single-device meshes before joining any mesh,
+  // so that they run concurrently with the functions launched above rather
+  // than after the meshes preceding them are joined.
+  std::vector<std::vector<std::unique_ptr<TensorWithLayout>>>
+      single_device_outputs(function_list.size());
+  std::vector<Status> single_device_statuses(function_list.size());
+  if (!multi_device_mode) {
+    for (int i = 0; i < function_list.size(); ++i) {
+      const TranslatedFunction& function = function_list[i];
+      if (!function.function_mesh.IsSingleDevice() ||
+          excluded_fn_names.contains(function.translated_function_name)) {
+        continue;
+      }
+      std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> eager_status(
+          TF_NewStatus(), TF_DeleteStatus);
+      ExecuteEagerOperation(context, attributes, function, inputs_tf,
+                            single_device_outputs[i], eager_status.get());
+      single_device_statuses[i] = StatusFromTF_Status(eager_status.get());
+    }
+  }
+
   *num_outputs = num_global_outputs;
   std::vector<std::unique_ptr<TensorWithLayout>> typed_outputs;
   typed_outputs.resize(num_global_outputs);
@@ -2182,8 +2203,9 @@ void DTensorDevice::ExecuteRegularOperation(
   // TODO(b/177932563): Expose cancel logic to handle failures.
   std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> join_status(
       TF_NewStatus(), TF_DeleteStatus);
-  for (const TranslatedFunction& function :
-       execution_functions->function_list) {
+  for (int function_index = 0; function_index < function_list.size();
+       ++function_index) {
+    const TranslatedFunction& function = function_list[function_index];
     // Skip execution for a function when it's excluded.
     if (excluded_fn_names.contains(function.translated_function_name)) {
       continue;
@@ -2202,8 +2224,9 @@ void DTensorDevice::ExecuteRegularOperation(
       ExecuteMultiDeviceOperation(context, attributes, function, inputs_tf,
                                   typed_outputs, status);
     } else if (mesh.IsSingleDevice()) {
-      ExecuteEagerOperation(context, attributes, function, inputs_tf,
-                            output_with_layout, status);
+      output_with_layout = std::move(single_device_outputs[function_index]);
+      Set_TF_Status_from_Status(status,
+                                single_device_statuses[function_index]);
     } else if (is_remote_mesh(mesh)) {
       // Create dummy outputs on a remote mesh.
       for (int i = 0; i < function.output_index_map.size(); ++i) {
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <iterator>
 #include <memory>
@@ -21,6 +22,7 @@ limitations under the License.
 #include <queue>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -1416,6 +1418,77 @@ Status CompareMergedLayouts(const llvm::DenseMap<mlir::Value, Layout>& merged_a,
 }
 
 // MLIR pass that propagates layout for all ops the module.
+// Estimates the bytes each device receives to relayout `value` from
+// `src_layout` to `tgt_layout`, as for an all-gather over the mesh dimensions
+// that shard a tensor dimension in `src_layout` but not in `tgt_layout`.
+// Returns 0 for values without a static shape or numeric element type.
+int64_t EstimateRelayoutBytes(mlir::Value value, const Layout& src_layout,
+                              const Layout& tgt_layout) {
+  auto type = mlir::dyn_cast<mlir::RankedTensorType>(value.getType());
+  if (!type || !type.hasStaticShape() ||
+      !type.getElementType().isIntOrFloat() ||
+      type.getRank() != src_layout.rank() ||
+      type.getRank() != tgt_layout.rank())
+    return 0;
+  int64_t local_num_elements = type.getNumElements();
+  int64_t num_gathered_shards = 1;
+  for (int i = 0; i < src_layout.rank(); ++i) {
+    const std::string& spec = src_layout.sharding_spec(i);
+    if (!Layout::IsShardedDimension(spec)) continue;
+    const int64_t num_shards = src_layout.num_shards_for_dim(i);
+    local_num_elements /= num_shards;
+    if (spec != tgt_layout.sharding_spec(i)) num_gathered_shards *= num_shards;
+  }
+  return local_num_elements * (num_gathered_shards - 1) *
+         type.getElementTypeBitWidth() / 8;
+}
+
+// Logs the operands whose consumer requested a layout different from the one
+// propagation settled on, since SPMD expansion relayouts these operands. The
+// consuming ops are summarized by the estimated communication volume.
+void LogRelayouts(
+    const llvm::DenseMap<mlir::Value, mlir::DenseMap<mlir::OpOperand*, Layout>>&
+        consumer_requests,
+    const llvm::DenseMap<mlir::Value, Layout>& merged_layouts) {
+  struct RelayoutStats {
+    int64_t count = 0;
+    int64_t bytes = 0;
+  };
+  absl::flat_hash_map<std::string, RelayoutStats> stats_by_op;
+  for (const auto& value_and_requests : consumer_requests) {
+    const mlir::Value value = value_and_requests.getFirst();
+    auto merged = merged_layouts.find(value);
+    if (merged == merged_layouts.end()) continue;
+    const Layout& layout = merged->getSecond();
+    for (const auto& operand_and_layout : value_and_requests.getSecond()) {
+      mlir::OpOperand* operand = operand_and_layout.getFirst();
+      const Layout& requested = operand_and_layout.getSecond();
+      if (requested.mesh() != layout.mesh() ||
+          requested.IsEquivalentIgnoringType(layout))
+        continue;
+      const int64_t bytes = EstimateRelayoutBytes(value, layout, requested);
+      const std::string op_name = OpName(operand->getOwner());
+      VLOG(2) << "Operand " << operand->getOperandNumber() << " of " << op_name
+              << " requests layout " << requested.ToString() << " but has "
+              << layout.ToString() << " (~" << bytes << " bytes per device)";
+      RelayoutStats& stats = stats_by_op[op_name];
+      ++stats.count;
+      stats.bytes += bytes;
+    }
+  }
+  std::vector<std::pair<std::string, RelayoutStats>> sorted_stats(
+      stats_by_op.begin(), stats_by_op.end());
+  std::sort(sorted_stats.begin(), sorted_stats.end(),
+            [](const auto& a, const auto& b) {
+              return a.second.bytes > b.second.bytes;
+            });
+  for (const auto& [op_name, stats] : sorted_stats) {
+    VLOG(1) << op_name << " induces " << stats.count
+            << " relayout(s), receiving ~" << stats.bytes
+            << " bytes per device";
+  }
+}
+
 struct DLayoutPropagationPassV2
     : public impl::DTensorLayoutPropagationV2Base<DLayoutPropagationPassV2> {
   void getDependentDialects(mlir::DialectRegistry& registry) const override {
@@ -1587,6 +1660,8 @@ struct DLayoutPropagationPassV2
       LogLayoutsAndOps(stage, -1, merged_layouts, module);
     }
 
+    if (VLOG_IS_ON(1)) LogRelayouts(consumer_requests, merged_layouts);
+
     if (!AllOpResultsHaveLayouts(&module, tf_dialect, merged_layouts))
       return signalPassFailure();
 
@@ -211,6 +211,7 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   nodes_to_tensors_.clear();
   nodes_to_tensors_.resize(
       std::max(graph_info_->num_execution_nodes(), (size_t)1), {});
+  IdentifyConcurrentNodeGroups();
 
   // Keeps track of references to each tensor.
   refcounts_.assign(num_tensors, 0);
@@ -336,6 +337,40 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   return kTfLiteOk;
 }
 
+void ArenaPlanner::IdentifyConcurrentNodeGroups() {
+  concurrent_group_first_node_.clear();
+  concurrent_group_last_node_.clear();
+  const std::vector<int> groups = graph_info_->concurrent_node_groups();
+  if (groups.size() < 2 ||
+      groups.back() != static_cast<int>(graph_info_->num_execution_nodes())) {
+    return;
+  }
+  concurrent_group_first_node_.resize(groups.back());
+  concurrent_group_last_node_.resize(groups.back());
+  for (size_t i = 0; i + 1 < groups.size(); ++i) {
+    for (int node = groups[i]; node < groups[i + 1]; ++node) {
+      concurrent_group_first_node_[node] = groups[i];
+      concurrent_group_last_node_[node] = groups[i + 1] - 1;
+    }
+  }
+}
+
+void ArenaPlanner::GetAllocationInterval(int32_t tensor_index,
+                                         int32_t* first_node,
+                                         int32_t* last_node) const {
+  *first_node = alloc_node_[tensor_index];
+  *last_node = dealloc_node_[tensor_index];
+  // Nodes of the same group may run at the same time, so a tensor must stay
+  // allocated while any node of the groups it is used by runs.
+  const int32_t num_grouped_nodes = concurrent_group_first_node_.size();
+  if (*first_node >= 0 && *first_node < num_grouped_nodes) {
+    *first_node = concurrent_group_first_node_[*first_node];
+  }
+  if (*last_node >= 0 && *last_node < num_grouped_nodes) {
+    *last_node = concurrent_group_last_node_[*last_node];
+  }
+}
+
 TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   // Grow the size of `allocs_` if necessary. This allows allocating temporary
   // tensors in op's `prepare` function.
@@ -413,7 +448,13 @@ TfLiteStatus ArenaPlanner::AcquireNonPersistentMemory() {
 }
 
 bool ArenaPlanner::HasNonPersistentMemory() {
-  return has_nonpersistent_memory_;
+  // Tensor pointers are stale if another planner moved a shared arena buffer.
+  return has_nonpersistent_memory_ && !arena_.BufferMovedSinceCommit();
+}
+
+void ArenaPlanner::SetSharedArenaBuffer(
+    std::shared_ptr<ResizableAlignedBuffer> buffer) {
+  arena_.SetSharedBuffer(std::move(buffer));
 }
 
 void ArenaPlanner::DumpDebugInfo(const std::vector<int>& execution_plan) const {
@@ -471,6 +512,129 @@ void ArenaPlanner::CreateTensorAllocationVector(
             tensor_compare);
 }
 
+void ArenaPlanner::CreateTensorAllocationVectorByBreadth(
+    std::vector<int32_t>* tensors_to_allocate) {
+  const TfLiteTensor* tensors = this->graph_info_->tensors();
+  const int num_nodes = static_cast<int>(graph_info_->num_execution_nodes());
+  if (num_nodes == 0) {
+    return;
+  }
+  auto last_live_node = [&](int32_t tensor_index) {
+    return std::min(dealloc_node_[tensor_index], num_nodes - 1);
+  };
+
+  // Total size of the tensors live during the execution of each node.
+  std::vector<size_t> breadth(num_nodes, 0);
+  for (int32_t tensor_index : *tensors_to_allocate) {
+    if (tensors[tensor_index].allocation_type != kTfLiteArenaRw ||
+        SharesTensorBuffer(tensor_index)) {
+      continue;
+    }
+    for (int i = alloc_node_[tensor_index]; i <= last_live_node(tensor_index);
+         ++i) {
+      breadth[i] += tensors[tensor_index].bytes;
+    }
+  }
+  std::vector<int32_t> nodes_by_breadth(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    nodes_by_breadth[i] = i;
+  }
+  std::stable_sort(nodes_by_breadth.begin(), nodes_by_breadth.end(),
+                   [&](int32_t node1, int32_t node2) {
+                     return breadth[node1] > breadth[node2];
+                   });
+  std::vector<int32_t> node_rank(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    node_rank[nodes_by_breadth[i]] = i;
+  }
+
+  // A tensor is ordered with the widest node it is live at.
+  std::vector<int32_t> tensor_rank(graph_info_->num_tensors(), num_nodes);
+  for (int32_t tensor_index : *tensors_to_allocate) {
+    for (int i = alloc_node_[tensor_index]; i <= last_live_node(tensor_index);
+         ++i) {
+      tensor_rank[tensor_index] =
+          std::min(tensor_rank[tensor_index], node_rank[i]);
+    }
+  }
+  // As in CreateTensorAllocationVector, tensors that live through the whole
+  // inference go first.
+  auto whole_lifetime = [&](int32_t tensor_index) {
+    return alloc_node_[tensor_index] == 0 &&
+           dealloc_node_[tensor_index] == kNodeNotAssigned;
+  };
+  std::sort(tensors_to_allocate->begin(), tensors_to_allocate->end(),
+            [&](int32_t idx1, int32_t idx2) {
+              if (whole_lifetime(idx1) != whole_lifetime(idx2)) {
+                return whole_lifetime(idx1);
+              }
+              if (whole_lifetime(idx1)) {
+                return idx1 < idx2;
+              }
+              if (tensor_rank[idx1] != tensor_rank[idx2]) {
+                return tensor_rank[idx1] < tensor_rank[idx2];
+              }
+              if (tensors[idx1].bytes != tensors[idx2].bytes) {
+                return tensors[idx1].bytes > tensors[idx2].bytes;
+              }
+              return idx1 < idx2;
+            });
+}
+
+bool ArenaPlanner::SharesTensorBuffer(int32_t tensor_index) const {
+  auto it = actual_tensor_id_.find(tensor_index);
+  if (it == actual_tensor_id_.end()) {
+    return false;
+  }
+  // Mirrors the checks made in CalculateAllocations before skipping a tensor.
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  return tensors[it->second].allocation_type == kTfLiteArenaRw &&
+         tensors[it->second].bytes == tensors[it->first].bytes;
+}
+
+TfLiteStatus ArenaPlanner::CalculateArenaSize(
+    const std::vector<int32_t>& tensors_to_allocate, size_t* arena_size) {
+  // The scratch arena never commits, so it doesn't allocate any memory.
+  SimpleMemoryArena scratch_arena(kDefaultArenaAlignment);
+  const TfLiteTensor* tensors = graph_info_->tensors();
+  ArenaAllocWithUsageInterval alloc;
+  for (int32_t tensor_index : tensors_to_allocate) {
+    const TfLiteTensor& tensor = tensors[tensor_index];
+    if (tensor.allocation_type != kTfLiteArenaRw ||
+        SharesTensorBuffer(tensor_index)) {
+      continue;
+    }
+    int32_t first_node, last_node;
+    GetAllocationInterval(tensor_index, &first_node, &last_node);
+    TF_LITE_ENSURE_STATUS(scratch_arena.Allocate(
+        context_, tensor_alignment_, tensor.bytes, tensor_index, first_node,
+        last_node, &alloc));
+  }
+  *arena_size = scratch_arena.RequiredBufferSize();
+  return kTfLiteOk;
+}
+
+TfLiteStatus ArenaPlanner::ChooseTensorAllocationOrder(
+    std::vector<int32_t>* tensors_to_allocate) {
+  // Neither greedy ordering dominates the other: sorting by size does best
+  // when a few large tensors dominate, sorting by breadth when many tensors of
+  // similar sizes are live at the peak. Plan both and keep the smaller one.
+  std::vector<int32_t> by_breadth = *tensors_to_allocate;
+  CreateTensorAllocationVectorByBreadth(&by_breadth);
+  if (by_breadth == *tensors_to_allocate) {
+    return kTfLiteOk;
+  }
+  size_t by_size_arena_size = 0;
+  TF_LITE_ENSURE_STATUS(
+      CalculateArenaSize(*tensors_to_allocate, &by_size_arena_size));
+  size_t by_breadth_arena_size = 0;
+  TF_LITE_ENSURE_STATUS(CalculateArenaSize(by_breadth, &by_breadth_arena_size));
+  if (by_breadth_arena_size < by_size_arena_size) {
+    *tensors_to_allocate = std::move(by_breadth);
+  }
+  return kTfLiteOk;
+}
+
 std::vector<int32_t> ArenaPlanner::GetTensorsToAllocate(int first_node,
                                                         int last_node) {
   int num_tensors = static_cast<int>(graph_info_->num_tensors());
@@ -509,15 +673,21 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     last_active_node_ = last_node;
     return kTfLiteOk;
   }
+  bool arena_reset = false;
   if (first_node < last_active_node_) {
     arena_.ResetAllocs();
     last_active_node_ = first_node;
+    arena_reset = true;
   } else {
     // NOMUTANTS -- This function has no impact on the results, it only makes
     // exection faster.
     arena_.PurgeActiveAllocs(first_node);
   }
   CreateTensorAllocationVector(tensors_allocated);
+  if (arena_reset) {
+    // Alternative orderings can only be compared when planning from scratch.
+    TF_LITE_ENSURE_STATUS(ChooseTensorAllocationOrder(tensors_allocated));
+  }
   // Vector of ids of already allocated tensors, ordered by offset.
   for (const auto& tensor_index : *tensors_allocated) {
     TfLiteTensor& tensor = tensors[tensor_index];
@@ -541,10 +711,12 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
     if (tensor.allocation_type == kTfLiteArenaRw) {
+      int32_t alloc_first_node, alloc_last_node;
+      GetAllocationInterval(tensor_index, &alloc_first_node, &alloc_last_node);
       TF_LITE_ENSURE_STATUS(
           arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
-                          tensor_index, alloc_node_[tensor_index],
-                          dealloc_node_[tensor_index], &allocs_[tensor_index]));
+                          tensor_index, alloc_first_node, alloc_last_node,
+                          &allocs_[tensor_index]));
     }
     // Check allocs_[].size to prevent from reallocation of persistent tensors.
     // Only allocate ArenaRwPersistent tensors which own their buffer.
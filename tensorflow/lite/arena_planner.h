@@ -72,6 +72,12 @@ class ArenaPlanner : public MemoryPlanner {
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
 
+  // Places non-persistent tensors in `buffer`, which may be shared with the
+  // planners of other subgraphs that never run at the same time as this one.
+  // See SimpleMemoryArena::SetSharedBuffer(). Must be called before
+  // ExecuteAllocations().
+  void SetSharedArenaBuffer(std::shared_ptr<ResizableAlignedBuffer> buffer);
+
  private:
   // Check whether the input tensor's memory may be shared the output tensor.
   // tensor_changed: true if the output tensor modifies the tensor data. For
@@ -95,6 +101,38 @@ class ArenaPlanner : public MemoryPlanner {
   // first goes first.
   void CreateTensorAllocationVector(std::vector<int32_t>* tensors_to_allocate);
 
+  // Sorts `tensors_to_allocate` greedily by breadth: nodes are visited from
+  // the one with the largest total size of live tensors to the smallest, and
+  // the not yet ordered tensors live at each node are appended from largest
+  // to smallest.
+  void CreateTensorAllocationVectorByBreadth(
+      std::vector<int32_t>* tensors_to_allocate);
+
+  // Replaces `tensors_to_allocate`, which must be sorted by
+  // CreateTensorAllocationVector, with its breadth ordering if that leads to a
+  // smaller arena. Only valid when `arena_` holds no active allocations.
+  TfLiteStatus ChooseTensorAllocationOrder(
+      std::vector<int32_t>* tensors_to_allocate);
+
+  // Computes the size of the non-persistent arena needed to allocate
+  // `tensors_to_allocate` in order into an empty arena, without changing
+  // `arena_`.
+  TfLiteStatus CalculateArenaSize(
+      const std::vector<int32_t>& tensors_to_allocate, size_t* arena_size);
+
+  // Returns true if `tensor_index` will share the buffer of another tensor
+  // instead of being allocated in the arena.
+  bool SharesTensorBuffer(int32_t tensor_index) const;
+
+  // Caches the first and last node of the group of concurrent nodes of each
+  // node, as reported by GraphInfo::concurrent_node_groups().
+  void IdentifyConcurrentNodeGroups();
+
+  // Returns the interval of nodes during which `tensor_index` must stay
+  // allocated, widened to whole groups of concurrent nodes.
+  void GetAllocationInterval(int32_t tensor_index, int32_t* first_node,
+                             int32_t* last_node) const;
+
   // Returns vector containing the indices of all tensors allocated between
   // `first_node` and `last_node`.
   std::vector<int32_t> GetTensorsToAllocate(int first_node, int last_node);
@@ -138,6 +176,11 @@ class ArenaPlanner : public MemoryPlanner {
   // the node's operation.
   std::vector<int32_t> dealloc_node_;
 
+  // First and last node of the group of concurrent nodes of each node. Empty
+  // if the nodes run one at a time.
+  std::vector<int32_t> concurrent_group_first_node_;
+  std::vector<int32_t> concurrent_group_last_node_;
+
   // Raw memory buffer that is allocated for all temporary and graph outputs
   // that are declared kTfLiteArenaRw.
   SimpleMemoryArena arena_;
@@ -144,10 +144,18 @@ class TestGraph {
     return registrations_;
   }
 
+  const std::vector<int>& concurrent_node_groups() {
+    return concurrent_node_groups_;
+  }
+
   void SetVariables(const std::vector<int>& variables) {
     variables_ = variables;
   }
 
+  void SetConcurrentNodeGroups(const std::vector<int>& groups) {
+    concurrent_node_groups_ = groups;
+  }
+
   void Swap(TestGraph* other) {
     std::swap(nodes_, other->nodes_);
     std::swap(tensors_, other->tensors_);
@@ -163,6 +171,7 @@ class TestGraph {
   std::vector<int> inputs_;
   std::vector<int> outputs_;
   std::vector<int> variables_;
+  std::vector<int> concurrent_node_groups_;
 };
 
 // The GraphInfo for a TestGraph.
@@ -189,6 +198,9 @@ class TestGraphInfo : public GraphInfo {
   const std::vector<int>& variables() const override {
     return graph_->variables();
   }
+  std::vector<int> concurrent_node_groups() const override {
+    return graph_->concurrent_node_groups();
+  }
 
  private:
   TestGraph* graph_;
@@ -1046,6 +1058,70 @@ TEST_F(ArenaPlannerTest, GraphWithIntermediates) {
   EXPECT_EQ(GetOffset(2), GetOffsetAfter(5));
 }
 
+TEST_F(ArenaPlannerTest, GraphWithSmallerBreadthFirstPlan) {
+  TestGraph graph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {1}, {}},
+                      {{1}, {2}, {}},
+                      {{2}, {3, 4}, {}},
+                      {{3, 4}, {5}, {}},
+                  },
+                  {5});
+  (*graph.tensors())[0].bytes = 4;
+  (*graph.tensors())[1].bytes = 24;
+  (*graph.tensors())[2].bytes = 20;
+  (*graph.tensors())[3].bytes = 16;
+  (*graph.tensors())[4].bytes = 20;
+  (*graph.tensors())[5].bytes = 4;
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  // Placing tensors from largest to smallest needs 64 bytes. Placing the
+  // tensors of the widest node (#0, #3, #4 and #5) first needs only its 60
+  // bytes, which is the lower bound.
+  size_t arena_size = 0;
+  size_t arena_persist_size = 0;
+  planner_->GetAllocInfo(&arena_size, &arena_persist_size);
+  EXPECT_EQ(arena_size, 60);
+  EXPECT_EQ(GetOffset(0), 0);
+  EXPECT_TRUE(GetOffset(1) >= GetOffsetAfter(2) ||
+              GetOffset(2) >= GetOffsetAfter(1));
+  EXPECT_TRUE(GetOffset(3) >= GetOffsetAfter(4) ||
+              GetOffset(4) >= GetOffsetAfter(3));
+}
+
+TEST_F(ArenaPlannerTest, GraphWithConcurrentNodes) {
+  TestGraph graph({0},
+                  {
+                      /* in, out, tmp */
+                      {{0}, {1}, {}},
+                      {{1}, {2}, {5}},
+                      {{1}, {3}, {6}},
+                      {{2, 3}, {4}, {}},
+                  },
+                  {4});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  // Temporaries of nodes run one after the other share memory.
+  EXPECT_EQ(GetOffset(5), GetOffset(6));
+
+  // Nodes #1 and #2 may run at the same time.
+  graph.SetConcurrentNodeGroups({0, 1, 3, 4});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+
+  EXPECT_TRUE(GetOffset(5) >= GetOffsetAfter(6) ||
+              GetOffset(6) >= GetOffsetAfter(5));
+  EXPECT_TRUE(GetOffset(1) >= GetOffsetAfter(6) ||
+              GetOffset(6) >= GetOffsetAfter(1));
+  EXPECT_TRUE(GetOffset(2) >= GetOffsetAfter(6) ||
+              GetOffset(6) >= GetOffsetAfter(2));
+  EXPECT_TRUE(GetOffset(3) >= GetOffsetAfter(5) ||
+              GetOffset(5) >= GetOffsetAfter(3));
+}
+
 TEST_F(ArenaPlannerTest, DebugTensors) {
   TestGraph graph({0, 1},
                   {
@@ -0,0 +1,301 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/async/cpu_backend_async_kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/async/c/task.h"
+#include "tensorflow/lite/async/c/types.h"
+#include "tensorflow/lite/async/interop/c/attribute_map.h"
+#include "tensorflow/lite/async/interop/c/constants.h"
+#include "tensorflow/lite/async/interop/c/types.h"
+#include "tensorflow/lite/c/c_api_opaque.h"
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+namespace delegates {
+
+namespace {
+
+// Returns true if `attrs` does not name a buffer type, or names the CPU one.
+bool IsCpuBuffer(const TfLiteAttributeMap* attrs) {
+  const char* type_name = nullptr;
+  if (!TfLiteAttributeMapGetStringBufferAttr(
+          attrs, kTfLiteBufferAttrKeyResourceTypeName, &type_name)) {
+    return true;
+  }
+  return std::strcmp(type_name, kCpuBufferTypeName) == 0;
+}
+
+}  // namespace
+
+CpuBackendAsyncKernel::CpuBackendAsyncKernel()
+    : worker_([this] { WorkerLoop(); }) {}
+
+CpuBackendAsyncKernel::~CpuBackendAsyncKernel() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  job_queued_.notify_all();
+  worker_.join();
+}
+
+TfLiteStatus CpuBackendAsyncKernel::RegisterBuffer(
+    TfLiteOpaqueContext* context, TfLiteIoType io_type,
+    const TfLiteBackendBuffer* buffer, const TfLiteAttributeMap* attrs,
+    TfLiteBufferHandle handle) {
+  const char* type_name = nullptr;
+  if (!TfLiteAttributeMapGetStringBufferAttr(
+          attrs, kTfLiteBufferAttrKeyResourceTypeName, &type_name) ||
+      std::strcmp(type_name, kCpuBufferTypeName) != 0) {
+    TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(context, "Buffer type is not \"%s\".",
+                                    kCpuBufferTypeName);
+    return kTfLiteError;
+  }
+  Buffer registered;
+  registered.data = TfLiteBackendBufferGetPtr(buffer);
+  if (registered.data == nullptr ||
+      !TfLiteAttributeMapGetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                            &registered.size)) {
+    TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(
+        context, "CPU buffers need a data pointer and a size attribute.");
+    return kTfLiteError;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!buffers_.emplace(handle, registered).second) return kTfLiteError;
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::RegisterBufferSlice(
+    TfLiteOpaqueContext* context, TfLiteBufferHandle buffer_pool,
+    const TfLiteAttributeMap* attrs, TfLiteBufferHandle handle) {
+  if (!IsCpuBuffer(attrs)) return kTfLiteError;
+  size_t offset = 0;
+  size_t size = 0;
+  TfLiteAttributeMapGetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeyOffset,
+                                       &offset);
+  if (!TfLiteAttributeMapGetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                            &size)) {
+    TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(context,
+                                    "Buffer slices need a size attribute.");
+    return kTfLiteError;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto pool = buffers_.find(buffer_pool);
+  if (pool == buffers_.end() || offset > pool->second.size ||
+      size > pool->second.size - offset) {
+    TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(context,
+                                    "Buffer slice is out of its pool.");
+    return kTfLiteError;
+  }
+  Buffer slice;
+  slice.data = static_cast<uint8_t*>(pool->second.data) + offset;
+  slice.size = size;
+  if (!buffers_.emplace(handle, slice).second) return kTfLiteError;
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::UnregisterBuffer(
+    TfLiteOpaqueContext* context, TfLiteBufferHandle handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return buffers_.erase(handle) == 1 ? kTfLiteOk : kTfLiteError;
+}
+
+const std::vector<const char*>& CpuBackendAsyncKernel::SupportedBufferTypes(
+    TfLiteIoType io_type) const {
+  static const std::vector<const char*>* const kBufferTypes =
+      new std::vector<const char*>{kCpuBufferTypeName};
+  return *kBufferTypes;
+}
+
+const std::vector<const char*>&
+CpuBackendAsyncKernel::SupportedSynchronizations(TfLiteIoType io_type) const {
+  static const std::vector<const char*>* const kSyncTypes =
+      new std::vector<const char*>{kTfLiteSyncTypeNoSyncObj};
+  return *kSyncTypes;
+}
+
+bool CpuBackendAsyncKernel::ReconcileRestrictions(
+    const TfLiteOpaqueContext* context, const TfLiteOpaqueNode* node,
+    int tensor_index, const TfLiteAttributeMap* user_provided_attributes,
+    TfLiteAttributeMap* merged, TfLiteAttributeMap* conflict) const {
+  if (!TfLiteAttributeMapIsBufferAttributeMap(user_provided_attributes)) {
+    return true;
+  }
+  if (!IsCpuBuffer(user_provided_attributes)) {
+    if (conflict != nullptr) {
+      TfLiteAttributeMapSetStringBufferAttr(
+          conflict, kTfLiteBufferAttrKeyResourceTypeName, kCpuBufferTypeName);
+    }
+    return false;
+  }
+  TfLiteAttributeMapCopy(user_provided_attributes, merged);
+  TfLiteAttributeMapSetStringBufferAttr(
+      merged, kTfLiteBufferAttrKeyResourceTypeName, kCpuBufferTypeName);
+  const TfLiteOpaqueTensor* tensor =
+      TfLiteOpaqueContextGetOpaqueTensor(context, tensor_index);
+  if (tensor != nullptr) {
+    size_t size = 0;
+    TfLiteAttributeMapGetSizeTBufferAttr(user_provided_attributes,
+                                         kTfLiteBufferAttrKeySize, &size);
+    const size_t tensor_size = TfLiteOpaqueTensorByteSize(tensor);
+    if (tensor_size > size) {
+      TfLiteAttributeMapSetSizeTBufferAttr(merged, kTfLiteBufferAttrKeySize,
+                                           tensor_size);
+    }
+  }
+  return true;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::SetAttributes(
+    TfLiteOpaqueContext* context, TfLiteOpaqueNode* node, int tensor_index,
+    const TfLiteAttributeMap* attrs) {
+  if (TfLiteAttributeMapIsBufferAttributeMap(attrs) && !IsCpuBuffer(attrs)) {
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::SetBufferAttributes(
+    const TfLiteBackendBuffer* buffer, const TfLiteAttributeMap* attrs) {
+  return kTfLiteDelegateError;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::GetBufferAttributes(
+    const TfLiteBackendBuffer* buffer, TfLiteAttributeMap* attrs) {
+  const void* data = TfLiteBackendBufferGetPtr(buffer);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [handle, registered] : buffers_) {
+    if (registered.data == data) {
+      TfLiteAttributeMapSetStringBufferAttr(
+          attrs, kTfLiteBufferAttrKeyResourceTypeName, kCpuBufferTypeName);
+      TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                           registered.size);
+      return kTfLiteOk;
+    }
+  }
+  return kTfLiteDelegateError;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::Prepare(TfLiteOpaqueContext* context,
+                                            TfLiteOpaqueNode* node) {
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::BindBuffers(
+    TfLiteOpaqueContext* context, TfLiteExecutionTask* task,
+    const int* tensors, int num_tensors, std::vector<void*>& data) const {
+  for (int i = 0; i < num_tensors; ++i) {
+    const TfLiteBufferHandle handle =
+        TfLiteExecutionTaskGetBufferByIndex(task, tensors[i]);
+    auto buffer = buffers_.find(handle);
+    if (buffer == buffers_.end()) {
+      TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(
+          context, "No registered buffer is bound to tensor %d.", tensors[i]);
+      return kTfLiteError;
+    }
+    const TfLiteOpaqueTensor* tensor =
+        TfLiteOpaqueContextGetOpaqueTensor(context, tensors[i]);
+    if (tensor != nullptr &&
+        buffer->second.size < TfLiteOpaqueTensorByteSize(tensor)) {
+      TF_LITE_OPAQUE_MAYBE_KERNEL_LOG(
+          context, "The buffer bound to tensor %d is too small.", tensors[i]);
+      return kTfLiteError;
+    }
+    data.push_back(buffer->second.data);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::Eval(TfLiteOpaqueContext* context,
+                                         TfLiteOpaqueNode* node,
+                                         TfLiteExecutionTask* task) {
+  const int* inputs = nullptr;
+  const int* outputs = nullptr;
+  int num_inputs = 0;
+  int num_outputs = 0;
+  TF_LITE_ENSURE_STATUS(TfLiteOpaqueNodeInputs(node, &inputs, &num_inputs));
+  TF_LITE_ENSURE_STATUS(
+      TfLiteOpaqueNodeOutputs(node, &outputs, &num_outputs));
+
+  Job job;
+  job.context = context;
+  job.node = node;
+  job.task = task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TF_LITE_ENSURE_STATUS(
+        BindBuffers(context, task, inputs, num_inputs, job.inputs));
+    TF_LITE_ENSURE_STATUS(
+        BindBuffers(context, task, outputs, num_outputs, job.outputs));
+    TaskState& state = tasks_[task];
+    if (state.pending) return kTfLiteError;
+    state.pending = true;
+    state.status = kTfLiteOk;
+    jobs_.push_back(std::move(job));
+  }
+  job_queued_.notify_one();
+  return kTfLiteOk;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::WaitLocked(
+    std::unique_lock<std::mutex>& lock, TfLiteExecutionTask* task) {
+  auto state = tasks_.find(task);
+  if (state == tasks_.end()) return kTfLiteOk;
+  job_done_.wait(lock, [&] { return !state->second.pending; });
+  return state->second.status;
+}
+
+TfLiteStatus CpuBackendAsyncKernel::Wait(TfLiteOpaqueContext* context,
+                                         TfLiteExecutionTask* task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return WaitLocked(lock, task);
+}
+
+TfLiteStatus CpuBackendAsyncKernel::Finish(TfLiteOpaqueContext* context,
+                                           TfLiteExecutionTask* task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  WaitLocked(lock, task);
+  tasks_.erase(task);
+  return kTfLiteOk;
+}
+
+void CpuBackendAsyncKernel::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    job_queued_.wait(lock, [this] { return shutdown_ || !jobs_.empty(); });
+    if (jobs_.empty()) return;
+    Job job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+    const TfLiteStatus status =
+        Compute(job.context, job.node, job.inputs, job.outputs);
+    lock.lock();
+    TaskState& state = tasks_[job.task];
+    state.pending = false;
+    state.status = status;
+    job_done_.notify_all();
+  }
+}
+
+}  // namespace delegates
+}  // namespace tflite
@@ -0,0 +1,156 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_ASYNC_CPU_BACKEND_ASYNC_KERNEL_H_
+#define TENSORFLOW_LITE_ASYNC_CPU_BACKEND_ASYNC_KERNEL_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/async/backend_async_kernel_interface.h"
+#include "tensorflow/lite/async/c/types.h"
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+namespace delegates {
+
+// Buffer type name of host memory buffers. The pointer held by the
+// TfLiteBackendBuffer is the address of the buffer data.
+inline constexpr char kCpuBufferTypeName[] = "cpu";
+
+// WARNING: Experimental interface, subject to change.
+//
+// A BackendAsyncKernelInterface for backends that compute on the CPU.
+//
+// `Eval` binds the host memory buffers of the task to the node inputs and
+// outputs, queues the computation and returns. The computations run in
+// submission order on a worker thread owned by the kernel, so the
+// application can fill the input buffers of the next task while the
+// previous one is being computed. `Wait` blocks until the computation of the
+// task is done.
+//
+// Only buffers of type `kCpuBufferTypeName` and the `kTfLiteSyncTypeNoSyncObj`
+// synchronization are supported.
+//
+// Subclasses implement `Compute`.
+class CpuBackendAsyncKernel : public BackendAsyncKernelInterface {
+ public:
+  CpuBackendAsyncKernel();
+  // Stops the worker thread. All tasks must be finished before the kernel
+  // is destroyed, as `Compute` can't run once the subclass is gone.
+  ~CpuBackendAsyncKernel() override;
+
+  TfLiteStatus RegisterBuffer(TfLiteOpaqueContext* context,
+                              TfLiteIoType io_type,
+                              const TfLiteBackendBuffer* buffer,
+                              const TfLiteAttributeMap* attrs,
+                              TfLiteBufferHandle handle) override;
+  TfLiteStatus RegisterBufferSlice(TfLiteOpaqueContext* context,
+                                   TfLiteBufferHandle buffer_pool,
+                                   const TfLiteAttributeMap* attrs,
+                                   TfLiteBufferHandle handle) override;
+  TfLiteStatus UnregisterBuffer(TfLiteOpaqueContext* context,
+                                TfLiteBufferHandle handle) override;
+
+  const std::vector<const char*>& SupportedBufferTypes(
+      TfLiteIoType io_type) const override;
+  const std::vector<const char*>& SupportedSynchronizations(
+      TfLiteIoType io_type) const override;
+
+  bool ReconcileRestrictions(const TfLiteOpaqueContext* context,
+                             const TfLiteOpaqueNode* node, int tensor_index,
+                             const TfLiteAttributeMap* user_provided_attributes,
+                             TfLiteAttributeMap* merged,
+                             TfLiteAttributeMap* conflict) const override;
+  TfLiteStatus SetAttributes(TfLiteOpaqueContext* context,
+                             TfLiteOpaqueNode* node, int tensor_index,
+                             const TfLiteAttributeMap* attrs) override;
+  TfLiteStatus SetBufferAttributes(const TfLiteBackendBuffer* buffer,
+                                   const TfLiteAttributeMap* attrs) override;
+  TfLiteStatus GetBufferAttributes(const TfLiteBackendBuffer* buffer,
+                                   TfLiteAttributeMap* attrs) override;
+
+  TfLiteStatus Prepare(TfLiteOpaqueContext* context,
+                       TfLiteOpaqueNode* node) override;
+
+  TfLiteStatus Eval(TfLiteOpaqueContext* context, TfLiteOpaqueNode* node,
+                    TfLiteExecutionTask* task) override;
+  TfLiteStatus Wait(TfLiteOpaqueContext* context,
+                    TfLiteExecutionTask* task) override;
+  TfLiteStatus Finish(TfLiteOpaqueContext* context,
+                      TfLiteExecutionTask* task) override;
+
+ protected:
+  // Computes `node` on the worker thread. `inputs` and `outputs` hold the
+  // data addresses of the node input and output tensors, in node order.
+  // `context` and `node` must only be read.
+  virtual TfLiteStatus Compute(TfLiteOpaqueContext* context,
+                               TfLiteOpaqueNode* node,
+                               const std::vector<void*>& inputs,
+                               const std::vector<void*>& outputs) = 0;
+
+ private:
+  struct Buffer {
+    void* data = nullptr;
+    size_t size = 0;
+  };
+
+  struct Job {
+    TfLiteOpaqueContext* context = nullptr;
+    TfLiteOpaqueNode* node = nullptr;
+    TfLiteExecutionTask* task = nullptr;
+    std::vector<void*> inputs;
+    std::vector<void*> outputs;
+  };
+
+  struct TaskState {
+    bool pending = false;
+    TfLiteStatus status = kTfLiteOk;
+  };
+
+  // Looks up the buffers bound by `task` to `tensors` and appends their data
+  // addresses to `data`. Requires `mutex_`.
+  TfLiteStatus BindBuffers(TfLiteOpaqueContext* context,
+                           TfLiteExecutionTask* task, const int* tensors,
+                           int num_tensors, std::vector<void*>& data) const;
+
+  // Blocks until `task` has no pending computation. Requires `lock` to hold
+  // `mutex_`.
+  TfLiteStatus WaitLocked(std::unique_lock<std::mutex>& lock,
+                          TfLiteExecutionTask* task);
+
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  // Signaled when a job is queued or the kernel is shutting down.
+  std::condition_variable job_queued_;
+  // Signaled when a job completes.
+  std::condition_variable job_done_;
+  std::map<TfLiteBufferHandle, Buffer> buffers_;
+  std::map<TfLiteExecutionTask*, TaskState> tasks_;
+  std::deque<Job> jobs_;
+  bool shutdown_ = false;
+  std::thread worker_;
+};
+
+}  // namespace delegates
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_ASYNC_CPU_BACKEND_ASYNC_KERNEL_H_
@@ -0,0 +1,229 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/async/cpu_backend_async_kernel.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/async/c/task.h"
+#include "tensorflow/lite/async/c/types.h"
+#include "tensorflow/lite/async/interop/c/attribute_map.h"
+#include "tensorflow/lite/async/interop/c/types.h"
+#include "tensorflow/lite/c/c_api_opaque.h"
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/core/async/async_signature_runner.h"
+#include "tensorflow/lite/core/async/testing/test_backend.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+
+namespace tflite::delegates {
+namespace {
+
+constexpr int kNumElements = 3;
+constexpr size_t kTensorSize = kNumElements * sizeof(float);
+
+// Computes ADD of the node on the CPU. The test model adds the input to
+// itself.
+class AddKernel : public CpuBackendAsyncKernel {
+ protected:
+  TfLiteStatus Compute(TfLiteOpaqueContext* context, TfLiteOpaqueNode* node,
+                       const std::vector<void*>& inputs,
+                       const std::vector<void*>& outputs) override {
+    const auto* lhs = static_cast<const float*>(inputs[0]);
+    const auto* rhs = static_cast<const float*>(inputs[1]);
+    auto* output = static_cast<float*>(outputs[0]);
+    for (int i = 0; i < kNumElements; ++i) {
+      output[i] = lhs[i] + rhs[i];
+    }
+    return kTfLiteOk;
+  }
+};
+
+class CpuBackendAsyncKernelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    backend_ = std::make_unique<async::testing::TestBackend>(kernel_.kernel());
+    interpreter_ = std::make_unique<Interpreter>();
+    interpreter_->AddTensors(2);
+    interpreter_->SetInputs({0});
+    interpreter_->SetOutputs({1});
+    TfLiteQuantizationParams quant;
+    interpreter_->SetTensorParametersReadWrite(0, kTfLiteFloat32, "x",
+                                               {kNumElements}, quant);
+    interpreter_->SetTensorParametersReadWrite(1, kTfLiteFloat32, "a",
+                                               {kNumElements}, quant);
+    auto* params =
+        static_cast<TfLiteAddParams*>(calloc(1, sizeof(TfLiteAddParams)));
+    interpreter_->AddNodeWithParameters({0, 0}, {1}, nullptr, 0, params,
+                                        ops::builtin::Register_ADD());
+    ASSERT_EQ(kTfLiteOk,
+              interpreter_->ModifyGraphWithDelegate(backend_->get_delegate()));
+    runner_ = interpreter_->GetAsyncSignatureRunner(nullptr);
+    ASSERT_NE(nullptr, runner_);
+    ASSERT_EQ(kTfLiteOk, runner_->PrepareBackends());
+  }
+
+  TfLiteStatus RegisterBuffer(TfLiteIoType io_type, const char* type_name,
+                              void* data, size_t size,
+                              TfLiteBufferHandle* handle) {
+    TfLiteBackendBuffer* buffer = TfLiteBackendBufferCreate();
+    TfLiteBackendBufferSetPtr(buffer, data);
+    TfLiteAttributeMap* attrs =
+        TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+    TfLiteAttributeMapSetStringBufferAttr(
+        attrs, kTfLiteBufferAttrKeyResourceTypeName, type_name);
+    TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                         size);
+    TfLiteStatus status =
+        runner_->RegisterBuffer(io_type, buffer, attrs, handle);
+    TfLiteAttributeMapDelete(attrs);
+    TfLiteBackendBufferDelete(buffer);
+    return status;
+  }
+
+  AddKernel kernel_;
+  std::unique_ptr<async::testing::TestBackend> backend_;
+  std::unique_ptr<Interpreter> interpreter_;
+  async::AsyncSignatureRunner* runner_ = nullptr;
+};
+
+TEST_F(CpuBackendAsyncKernelTest, RegistersOnlyCpuBuffers) {
+  float data[kNumElements];
+  TfLiteBufferHandle handle;
+  EXPECT_EQ(kTfLiteError, RegisterBuffer(kTfLiteIoTypeInput, "AHardwareBuffer",
+                                         data, kTensorSize, &handle));
+  EXPECT_EQ(kTfLiteError, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                         nullptr, kTensorSize, &handle));
+  EXPECT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                      data, kTensorSize, &handle));
+  EXPECT_EQ(kTfLiteOk, runner_->UnregisterBuffer(handle));
+  EXPECT_EQ(kTfLiteError, runner_->UnregisterBuffer(handle));
+}
+
+TEST_F(CpuBackendAsyncKernelTest, RegistersSlicesWithinPool) {
+  float data[2 * kNumElements];
+  TfLiteBufferHandle pool;
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                      data, sizeof(data), &pool));
+
+  TfLiteAttributeMap* attrs =
+      TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+  TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeyOffset,
+                                       kTensorSize);
+  TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                       kTensorSize);
+  TfLiteBufferHandle slice;
+  EXPECT_EQ(kTfLiteOk, runner_->RegisterBufferSlice(pool, attrs, &slice));
+  TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                       2 * kTensorSize);
+  EXPECT_EQ(kTfLiteError, runner_->RegisterBufferSlice(pool, attrs, &slice));
+  TfLiteAttributeMapDelete(attrs);
+}
+
+TEST_F(CpuBackendAsyncKernelTest, ReconcilesCpuBufferType) {
+  TfLiteAttributeMap* user = TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+  TfLiteAttributeMap* merged =
+      TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+  TfLiteAttributeMap* conflict =
+      TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+
+  EXPECT_TRUE(runner_->ReconcileRestrictions(runner_->inputs()[0], user,
+                                             merged, conflict));
+  const char* type_name = nullptr;
+  EXPECT_TRUE(TfLiteAttributeMapGetStringBufferAttr(
+      merged, kTfLiteBufferAttrKeyResourceTypeName, &type_name));
+  EXPECT_STREQ(kCpuBufferTypeName, type_name);
+  size_t size = 0;
+  EXPECT_TRUE(TfLiteAttributeMapGetSizeTBufferAttr(
+      merged, kTfLiteBufferAttrKeySize, &size));
+  EXPECT_EQ(kTensorSize, size);
+
+  TfLiteAttributeMapSetStringBufferAttr(
+      user, kTfLiteBufferAttrKeyResourceTypeName, "AHardwareBuffer");
+  EXPECT_FALSE(runner_->ReconcileRestrictions(runner_->inputs()[0], user,
+                                              merged, conflict));
+  EXPECT_TRUE(TfLiteAttributeMapGetStringBufferAttr(
+      conflict, kTfLiteBufferAttrKeyResourceTypeName, &type_name));
+  EXPECT_STREQ(kCpuBufferTypeName, type_name);
+
+  TfLiteAttributeMapDelete(user);
+  TfLiteAttributeMapDelete(merged);
+  TfLiteAttributeMapDelete(conflict);
+}
+
+TEST_F(CpuBackendAsyncKernelTest, ComputesBoundBuffers) {
+  float input[kNumElements] = {1.0f, 2.0f, 3.0f};
+  float output[kNumElements] = {};
+  TfLiteBufferHandle input_handle, output_handle;
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                      input, sizeof(input), &input_handle));
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeOutput, kCpuBufferTypeName,
+                                      output, sizeof(output), &output_handle));
+
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  TfLiteExecutionTaskSetBufferByIndex(task, runner_->inputs()[0],
+                                      input_handle);
+  TfLiteExecutionTaskSetBufferByIndex(task, runner_->outputs()[0],
+                                      output_handle);
+  for (int round = 0; round < 2; ++round) {
+    ASSERT_EQ(kTfLiteOk, runner_->InvokeAsync(task));
+    ASSERT_EQ(kTfLiteOk, runner_->Wait(task));
+    EXPECT_EQ(2.0f, output[0]);
+    EXPECT_EQ(4.0f, output[1]);
+    EXPECT_EQ(6.0f, output[2]);
+  }
+  EXPECT_EQ(kTfLiteOk, runner_->Finish(task));
+}
+
+TEST_F(CpuBackendAsyncKernelTest, FailsWithoutOutputBuffer) {
+  float input[kNumElements] = {};
+  TfLiteBufferHandle input_handle;
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                      input, sizeof(input), &input_handle));
+
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  TfLiteExecutionTaskSetBufferByIndex(task, runner_->inputs()[0],
+                                      input_handle);
+  EXPECT_EQ(kTfLiteError, runner_->InvokeAsync(task));
+  runner_->Wait(task);
+  EXPECT_EQ(kTfLiteOk, runner_->Finish(task));
+}
+
+TEST_F(CpuBackendAsyncKernelTest, FailsWithTooSmallBuffer) {
+  float input[kNumElements] = {};
+  float output[kNumElements - 1] = {};
+  TfLiteBufferHandle input_handle, output_handle;
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeInput, kCpuBufferTypeName,
+                                      input, sizeof(input), &input_handle));
+  ASSERT_EQ(kTfLiteOk, RegisterBuffer(kTfLiteIoTypeOutput, kCpuBufferTypeName,
+                                      output, sizeof(output), &output_handle));
+
+  TfLiteExecutionTask* task = runner_->CreateTask();
+  TfLiteExecutionTaskSetBufferByIndex(task, runner_->inputs()[0],
+                                      input_handle);
+  TfLiteExecutionTaskSetBufferByIndex(task, runner_->outputs()[0],
+                                      output_handle);
+  EXPECT_EQ(kTfLiteError, runner_->InvokeAsync(task));
+  runner_->Wait(task);
+  EXPECT_EQ(kTfLiteOk, runner_->Finish(task));
+}
+
+}  // namespace
+}  // namespace tflite::delegates
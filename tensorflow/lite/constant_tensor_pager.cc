@@ -0,0 +1,170 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/constant_tensor_pager.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+
+namespace tflite {
+namespace {
+
+bool IsMemoryMapped(const TfLiteTensor* tensor) {
+  if (tensor == nullptr || tensor->allocation_type != kTfLiteMmapRo ||
+      tensor->allocation == nullptr || tensor->bytes == 0) {
+    return false;
+  }
+  return static_cast<const Allocation*>(tensor->allocation)->type() ==
+         Allocation::Type::kMMap;
+}
+
+bool IsDelegateNode(const Subgraph& subgraph, int node_index) {
+  return subgraph.node_and_registration(node_index)->second.builtin_code ==
+         kTfLiteBuiltinDelegate;
+}
+
+#if defined(MADV_WILLNEED) && defined(MADV_DONTNEED)
+uintptr_t PageSize() {
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+// madvise requires a page aligned address. Rounds the range out, so that the
+// pages holding the ends of the tensor are read as well.
+void AdviseWillNeed(const TfLiteTensor* tensor) {
+  const uintptr_t begin =
+      reinterpret_cast<uintptr_t>(tensor->data.raw) / PageSize() * PageSize();
+  const uintptr_t end = reinterpret_cast<uintptr_t>(tensor->data.raw) +
+                        tensor->bytes;
+  madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
+
+// Rounds the range in, so that pages shared with neighbouring buffers, which
+// could be read by CPU kernels, are kept.
+void AdviseDontNeed(const TfLiteTensor* tensor) {
+  const uintptr_t begin =
+      (reinterpret_cast<uintptr_t>(tensor->data.raw) + PageSize() - 1) /
+      PageSize() * PageSize();
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(tensor->data.raw) +
+                         tensor->bytes) /
+                        PageSize() * PageSize();
+  if (begin < end) {
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+  }
+}
+#else
+void AdviseWillNeed(const TfLiteTensor* tensor) {}
+void AdviseDontNeed(const TfLiteTensor* tensor) {}
+#endif
+
+}  // namespace
+
+bool AdviseRandomAccess(const Allocation* allocation) {
+  if (allocation == nullptr || allocation->type() != Allocation::Type::kMMap) {
+    return false;
+  }
+#if defined(MADV_RANDOM)
+  const auto* mmap_allocation = static_cast<const MMAPAllocation*>(allocation);
+  return madvise(const_cast<void*>(mmap_allocation->mmapped_buffer()),
+                 mmap_allocation->mmapped_buffer_size(), MADV_RANDOM) == 0;
+#else
+  return false;
+#endif
+}
+
+ConstantTensorPager::ConstantTensorPager(const Interpreter* interpreter)
+    : interpreter_(interpreter) {}
+
+std::vector<int> ConstantTensorPager::CpuConstants(const Subgraph& subgraph,
+                                                   int begin, int end) {
+  const std::vector<int>& execution_plan = subgraph.execution_plan();
+  begin = std::max(begin, 0);
+  end = std::min(end, static_cast<int>(execution_plan.size()));
+  std::vector<int> constants;
+  std::vector<bool> seen(subgraph.tensors_size(), false);
+  for (int position = begin; position < end; ++position) {
+    const int node_index = execution_plan[position];
+    if (IsDelegateNode(subgraph, node_index)) continue;
+    const TfLiteNode& node = subgraph.node_and_registration(node_index)->first;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index < 0 || seen[tensor_index] ||
+          !IsMemoryMapped(subgraph.tensor(tensor_index))) {
+        continue;
+      }
+      seen[tensor_index] = true;
+      constants.push_back(tensor_index);
+    }
+  }
+  return constants;
+}
+
+size_t ConstantTensorPager::ReleaseDelegatedConstants() {
+  size_t released_bytes = 0;
+  for (size_t i = 0; i < interpreter_->subgraphs_size(); ++i) {
+    const Subgraph& subgraph = *interpreter_->subgraph(i);
+    std::vector<bool> read_on_cpu(subgraph.tensors_size(), false);
+    for (int tensor_index :
+         CpuConstants(subgraph, 0, subgraph.execution_plan().size())) {
+      read_on_cpu[tensor_index] = true;
+    }
+    // Subgraph outputs can be read by the caller or a control flow op.
+    for (int tensor_index : subgraph.outputs()) {
+      if (tensor_index >= 0) read_on_cpu[tensor_index] = true;
+    }
+    for (size_t tensor_index = 0; tensor_index < subgraph.tensors_size();
+         ++tensor_index) {
+      const TfLiteTensor* tensor = subgraph.tensor(tensor_index);
+      if (read_on_cpu[tensor_index] || !IsMemoryMapped(tensor)) continue;
+      AdviseDontNeed(tensor);
+      released_bytes += tensor->bytes;
+    }
+  }
+  return released_bytes;
+}
+
+size_t ConstantTensorPager::Prefetch(int subgraph_index, int begin, int end) {
+  const Subgraph* subgraph = interpreter_->subgraph(subgraph_index);
+  if (subgraph == nullptr) return 0;
+  size_t prefetched_bytes = 0;
+  for (int tensor_index : CpuConstants(*subgraph, begin, end)) {
+    const TfLiteTensor* tensor = subgraph->tensor(tensor_index);
+    AdviseWillNeed(tensor);
+    prefetched_bytes += tensor->bytes;
+  }
+  return prefetched_bytes;
+}
+
+size_t ConstantTensorPager::PrefetchInExecutionOrder() {
+  size_t prefetched_bytes = 0;
+  for (size_t i = 0; i < interpreter_->subgraphs_size(); ++i) {
+    prefetched_bytes += Prefetch(
+        i, 0, interpreter_->subgraph(i)->execution_plan().size());
+  }
+  return prefetched_bytes;
+}
+
+}  // namespace tflite
@@ -0,0 +1,86 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+/// \file
+///
+/// Paging hints for the constant tensors of a memory-mapped model.
+#ifndef TENSORFLOW_LITE_CONSTANT_TENSOR_PAGER_H_
+#define TENSORFLOW_LITE_CONSTANT_TENSOR_PAGER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+
+namespace tflite {
+
+/// Advises the OS not to read ahead around page faults in `allocation`, so
+/// that reading one buffer of the model does not page in its neighbours.
+/// Call it right after building the `FlatBufferModel` to load a large model
+/// lazily. Returns false if `allocation` is not memory-mapped or the hint is
+/// not supported.
+bool AdviseRandomAccess(const Allocation* allocation);
+
+/// Issues paging hints for the constant tensors of an interpreter whose model
+/// is memory-mapped. Constant tensors that are not memory-mapped are ignored.
+///
+/// The hints only affect residency, never correctness: a released page is
+/// read back from the model file on its next access.
+///
+/// A typical lazy load of a large model is:
+///
+///   auto model = FlatBufferModel::BuildFromFile(path);
+///   AdviseRandomAccess(model->allocation());
+///   InterpreterBuilder(*model, resolver)(&interpreter);
+///   interpreter->ModifyGraphWithDelegate(delegate);
+///   interpreter->AllocateTensors();
+///   ConstantTensorPager pager(interpreter.get());
+///   pager.ReleaseDelegatedConstants();
+///   pager.PrefetchInExecutionOrder();
+class ConstantTensorPager {
+ public:
+  /// `interpreter` must outlive the pager. Delegates must have been applied,
+  /// as the pager only inspects the current execution plans.
+  explicit ConstantTensorPager(const Interpreter* interpreter);
+
+  /// Releases the pages of the constant tensors that no CPU kernel reads,
+  /// typically because only delegate kernels reference them and the
+  /// delegates copied them during preparation. Returns the number of bytes
+  /// hinted.
+  size_t ReleaseDelegatedConstants();
+
+  /// Hints that the constant tensors read by the CPU kernels at positions
+  /// [`begin`, `end`) of the execution plan of subgraph `subgraph_index` are
+  /// needed soon. Returns the number of bytes hinted.
+  size_t Prefetch(int subgraph_index, int begin, int end);
+
+  /// Hints the constant tensors read by CPU kernels in all subgraphs, in the
+  /// order the kernels read them. Returns the number of bytes hinted.
+  size_t PrefetchInExecutionOrder();
+
+ private:
+  // Returns the memory-mapped constant tensors read by the CPU kernels at
+  // positions [`begin`, `end`) of the execution plan of `subgraph`, in order
+  // of first use.
+  static std::vector<int> CpuConstants(const Subgraph& subgraph, int begin,
+                                       int end);
+
+  const Interpreter* const interpreter_;  // not own the memory.
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CONSTANT_TENSOR_PAGER_H_
@@ -0,0 +1,124 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/constant_tensor_pager.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/delegates/delegate_test_util.h"
+#include "tensorflow/lite/stderr_reporter.h"
+
+namespace tflite {
+namespace {
+
+constexpr int kNumElements = 2048;
+constexpr size_t kWeightBytes = kNumElements * sizeof(float);
+
+class ConstantTensorPagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!MMAPAllocation::IsSupported()) {
+      GTEST_SKIP() << "mmap is not supported";
+    }
+    // Two weight buffers, one after the other in the file.
+    path_ = ::testing::TempDir() + "/constant_tensor_pager_weights.bin";
+    std::vector<float> weights(2 * kNumElements, 1.0f);
+    FILE* file = fopen(path_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(fwrite(weights.data(), sizeof(float), weights.size(), file),
+              weights.size());
+    fclose(file);
+    allocation_ =
+        std::make_unique<MMAPAllocation>(path_.c_str(), DefaultErrorReporter());
+    ASSERT_TRUE(allocation_->valid());
+
+    // 0 + 1 -> 2, then 2 + 3 -> 4, where 1 and 3 are the weights.
+    interpreter_.AddTensors(5);
+    interpreter_.SetInputs({0});
+    interpreter_.SetOutputs({4});
+    TfLiteQuantizationParams quant;
+    const char* base = static_cast<const char*>(allocation_->base());
+    for (int i : {0, 2, 4}) {
+      interpreter_.SetTensorParametersReadWrite(i, kTfLiteFloat32, "",
+                                                {kNumElements}, quant);
+    }
+    interpreter_.SetTensorParametersReadOnly(1, kTfLiteFloat32, "",
+                                             {kNumElements}, quant, base,
+                                             kWeightBytes, allocation_.get());
+    interpreter_.SetTensorParametersReadOnly(
+        3, kTfLiteFloat32, "", {kNumElements}, quant, base + kWeightBytes,
+        kWeightBytes, allocation_.get());
+    for (int i = 0; i < 2; ++i) {
+      auto* params =
+          reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+      params->activation = kTfLiteActNone;
+      interpreter_.AddNodeWithParameters({2 * i, 2 * i + 1}, {2 * i + 2},
+                                         nullptr, 0, params,
+                                         ops::builtin::Register_ADD());
+    }
+  }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::string path_;
+  std::unique_ptr<MMAPAllocation> allocation_;
+  Interpreter interpreter_;
+};
+
+TEST_F(ConstantTensorPagerTest, PrefetchesCpuConstants) {
+  ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  ConstantTensorPager pager(&interpreter_);
+  EXPECT_EQ(pager.ReleaseDelegatedConstants(), 0);
+  EXPECT_EQ(pager.Prefetch(/*subgraph_index=*/0, 0, 1), kWeightBytes);
+  EXPECT_EQ(pager.Prefetch(/*subgraph_index=*/0, 1, 5), kWeightBytes);
+  EXPECT_EQ(pager.Prefetch(/*subgraph_index=*/1, 0, 2), 0);
+  EXPECT_EQ(pager.PrefetchInExecutionOrder(), 2 * kWeightBytes);
+}
+
+TEST_F(ConstantTensorPagerTest, ReleasesDelegatedConstants) {
+  test_utils::SimpleDelegate delegate(
+      {1}, kTfLiteDelegateFlagsNone, /*fail_node_prepare=*/false,
+      /*min_ops_per_subset=*/0, /*fail_node_invoke=*/false,
+      /*automatic_shape_propagation=*/false, /*custom_op=*/false);
+  ASSERT_EQ(
+      interpreter_.ModifyGraphWithDelegate(delegate.get_tf_lite_delegate()),
+      kTfLiteOk);
+  ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  ConstantTensorPager pager(&interpreter_);
+  EXPECT_EQ(pager.ReleaseDelegatedConstants(), kWeightBytes);
+  EXPECT_EQ(pager.PrefetchInExecutionOrder(), kWeightBytes);
+  // The released weights are read back from the file.
+  EXPECT_EQ(interpreter_.typed_tensor<float>(3)[kNumElements - 1], 1.0f);
+}
+
+TEST_F(ConstantTensorPagerTest, AdvisesRandomAccessOnlyForMappedModels) {
+  EXPECT_TRUE(AdviseRandomAccess(allocation_.get()));
+  float data[4] = {};
+  MemoryAllocation memory(data, sizeof(data), DefaultErrorReporter());
+  EXPECT_FALSE(AdviseRandomAccess(&memory));
+  EXPECT_FALSE(AdviseRandomAccess(nullptr));
+}
+
+}  // namespace
+}  // namespace tflite
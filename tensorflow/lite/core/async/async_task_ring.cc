@@ -0,0 +1,80 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/async/async_task_ring.h"
+
+#include "tensorflow/lite/core/async/async_signature_runner.h"
+#include "tensorflow/lite/core/async/c/types.h"
+#include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/logger.h"
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite {
+namespace async {
+
+AsyncTaskRing::AsyncTaskRing(AsyncSignatureRunner* runner, int num_slots)
+    : runner_(runner), slots_(num_slots > 0 ? num_slots : 1) {
+  for (Slot& slot : slots_) {
+    slot.task = runner_->CreateTask();
+  }
+}
+
+AsyncTaskRing::~AsyncTaskRing() {
+  WaitAll();
+  for (Slot& slot : slots_) {
+    runner_->Finish(slot.task);
+  }
+}
+
+TfLiteStatus AsyncTaskRing::WaitSlot(Slot& slot) {
+  if (!slot.in_flight) return kTfLiteOk;
+  slot.in_flight = false;
+  return runner_->Wait(slot.task);
+}
+
+TfLiteExecutionTask* AsyncTaskRing::Acquire(TfLiteStatus* status) {
+  Slot& slot = slots_[next_];
+  next_ = (next_ + 1) % num_slots();
+  const TfLiteStatus wait_status = WaitSlot(slot);
+  if (status != nullptr) *status = wait_status;
+  return slot.task;
+}
+
+TfLiteStatus AsyncTaskRing::Submit(TfLiteExecutionTask* task) {
+  // The last acquired slot is the one before `next_`.
+  Slot& slot = slots_[(next_ + num_slots() - 1) % num_slots()];
+  if (slot.task != task || slot.in_flight) {
+    TFLITE_LOG(tflite::TFLITE_LOG_ERROR,
+               "Only the last acquired task of the ring can be submitted.");
+    return kTfLiteError;
+  }
+  const TfLiteStatus status = runner_->InvokeAsync(task);
+  // A failed InvokeAsync leaves the task scheduled, so it still needs a
+  // `Wait` to become idle again.
+  slot.in_flight = true;
+  return status;
+}
+
+TfLiteStatus AsyncTaskRing::WaitAll() {
+  TfLiteStatus status = kTfLiteOk;
+  for (int i = 0; i < num_slots(); ++i) {
+    const TfLiteStatus slot_status =
+        WaitSlot(slots_[(next_ + i) % num_slots()]);
+    if (status == kTfLiteOk) status = slot_status;
+  }
+  return status;
+}
+
+}  // namespace async
+}  // namespace tflite
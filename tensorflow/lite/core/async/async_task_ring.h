@@ -0,0 +1,102 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_ASYNC_ASYNC_TASK_RING_H_
+#define TENSORFLOW_LITE_CORE_ASYNC_ASYNC_TASK_RING_H_
+
+#include <vector>
+
+#include "tensorflow/lite/core/async/async_signature_runner.h"
+#include "tensorflow/lite/core/async/c/types.h"
+#include "tensorflow/lite/core/c/c_api_types.h"
+
+namespace tflite {
+namespace async {
+
+// WARNING: Experimental interface, subject to change
+//
+// A fixed ring of execution tasks of an AsyncSignatureRunner, for streaming
+// pipelines such as camera frames.
+//
+// Each task of the ring is a slot with its own I/O buffer bindings, so the
+// buffers are registered and bound once and frames flow without copies.
+// While the task of frame N is executing, the application acquires the next
+// slot, fills its input buffers with frame N+1 and schedules it. Acquiring a
+// slot that is still in flight waits for its execution, which bounds the
+// number of frames in flight to the number of slots.
+//
+// Typical usage:
+//
+//   AsyncTaskRing ring(runner, /*num_slots=*/2);
+//   // Bind the buffers of each slot, e.g. with TfLiteExecutionTaskSetBuffer.
+//   while (has_frame) {
+//     TfLiteStatus status;
+//     TfLiteExecutionTask* task = ring.Acquire(&status);
+//     // Consume the outputs of the previous execution of `task`, if any,
+//     // then fill its inputs with the next frame.
+//     ring.Submit(task);
+//   }
+//   ring.WaitAll();
+//
+// This class is not thread safe.
+class AsyncTaskRing {
+ public:
+  // Creates `num_slots` tasks with `runner`, which must have prepared its
+  // backends and must outlive the ring.
+  AsyncTaskRing(AsyncSignatureRunner* runner, int num_slots);
+
+  // Waits for all in-flight tasks and finishes all tasks.
+  ~AsyncTaskRing();
+
+  AsyncTaskRing(const AsyncTaskRing&) = delete;
+  AsyncTaskRing& operator=(const AsyncTaskRing&) = delete;
+
+  int num_slots() const { return static_cast<int>(slots_.size()); }
+
+  // Returns the task of slot `index`, e.g. to bind its buffers up front.
+  TfLiteExecutionTask* task(int index) const { return slots_[index].task; }
+
+  // Returns the task of the next slot. If that task is still in flight, waits
+  // for its execution first and stores its status to `status`, if provided;
+  // otherwise `status` is set to kTfLiteOk.
+  TfLiteExecutionTask* Acquire(TfLiteStatus* status = nullptr);
+
+  // Schedules the execution of `task`, which must be the task returned by the
+  // last call to `Acquire`.
+  TfLiteStatus Submit(TfLiteExecutionTask* task);
+
+  // Waits for all in-flight tasks, oldest first. Returns the first error, if
+  // any.
+  TfLiteStatus WaitAll();
+
+ private:
+  struct Slot {
+    TfLiteExecutionTask* task = nullptr;
+    bool in_flight = false;
+  };
+
+  // Waits for the execution of `slot` if it is in flight.
+  TfLiteStatus WaitSlot(Slot& slot);
+
+  // Not owned.
+  AsyncSignatureRunner* runner_;
+  std::vector<Slot> slots_;
+  // The slot that the next call to `Acquire` returns.
+  int next_ = 0;
+};
+
+}  // namespace async
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_ASYNC_ASYNC_TASK_RING_H_
@@ -0,0 +1,196 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/async/async_task_ring.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/synchronization/notification.h"
+#include "tensorflow/lite/async/cpu_backend_async_kernel.h"
+#include "tensorflow/lite/core/async/async_signature_runner.h"
+#include "tensorflow/lite/core/async/c/task.h"
+#include "tensorflow/lite/core/async/c/types.h"
+#include "tensorflow/lite/core/async/interop/c/attribute_map.h"
+#include "tensorflow/lite/core/async/interop/c/types.h"
+#include "tensorflow/lite/core/async/testing/test_backend.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+
+namespace tflite {
+namespace async {
+namespace {
+
+constexpr int kNumElements = 4;
+
+// Doubles the input of the ADD node on the CPU. The first computation blocks
+// until `release_first` is notified.
+class GatedAddKernel : public delegates::CpuBackendAsyncKernel {
+ public:
+  absl::Notification first_started;
+  absl::Notification release_first;
+
+ protected:
+  TfLiteStatus Compute(TfLiteOpaqueContext* context, TfLiteOpaqueNode* node,
+                       const std::vector<void*>& inputs,
+                       const std::vector<void*>& outputs) override {
+    if (!first_started.HasBeenNotified()) {
+      first_started.Notify();
+      release_first.WaitForNotification();
+    }
+    const auto* input = static_cast<const float*>(inputs[0]);
+    auto* output = static_cast<float*>(outputs[0]);
+    for (int i = 0; i < kNumElements; ++i) {
+      output[i] = 2.0f * input[i];
+    }
+    return kTfLiteOk;
+  }
+};
+
+class AsyncTaskRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    backend_ = std::make_unique<testing::TestBackend>(kernel_.kernel());
+    interpreter_ = std::make_unique<Interpreter>();
+    interpreter_->AddTensors(2);
+    interpreter_->SetInputs({0});
+    interpreter_->SetOutputs({1});
+    TfLiteQuantizationParams quant;
+    interpreter_->SetTensorParametersReadWrite(0, kTfLiteFloat32, "x",
+                                               {kNumElements}, quant);
+    interpreter_->SetTensorParametersReadWrite(1, kTfLiteFloat32, "a",
+                                               {kNumElements}, quant);
+    auto* params =
+        static_cast<TfLiteAddParams*>(calloc(1, sizeof(TfLiteAddParams)));
+    interpreter_->AddNodeWithParameters({0, 0}, {1}, nullptr, 0, params,
+                                        ops::builtin::Register_ADD());
+    ASSERT_EQ(kTfLiteOk,
+              interpreter_->ModifyGraphWithDelegate(backend_->get_delegate()));
+    runner_ = interpreter_->GetAsyncSignatureRunner(nullptr);
+    ASSERT_NE(nullptr, runner_);
+    ASSERT_EQ(kTfLiteOk, runner_->PrepareBackends());
+  }
+
+  TfLiteBufferHandle RegisterBuffer(TfLiteIoType io_type, float* data) {
+    TfLiteBackendBuffer* buffer = TfLiteBackendBufferCreate();
+    TfLiteBackendBufferSetPtr(buffer, data);
+    TfLiteAttributeMap* attrs =
+        TfLiteAttributeMapCreate(kTfLiteAttrMapTypeBuffer);
+    TfLiteAttributeMapSetStringBufferAttr(
+        attrs, kTfLiteBufferAttrKeyResourceTypeName,
+        delegates::kCpuBufferTypeName);
+    TfLiteAttributeMapSetSizeTBufferAttr(attrs, kTfLiteBufferAttrKeySize,
+                                         kNumElements * sizeof(float));
+    TfLiteBufferHandle handle = kTfLiteNullBufferHandle;
+    EXPECT_EQ(kTfLiteOk,
+              runner_->RegisterBuffer(io_type, buffer, attrs, &handle));
+    TfLiteAttributeMapDelete(attrs);
+    TfLiteBackendBufferDelete(buffer);
+    return handle;
+  }
+
+  // Gives every slot of `ring` its own input and output buffers.
+  void BindSlots(AsyncTaskRing& ring) {
+    inputs_.resize(ring.num_slots() * kNumElements);
+    outputs_.resize(ring.num_slots() * kNumElements);
+    for (int slot = 0; slot < ring.num_slots(); ++slot) {
+      TfLiteExecutionTaskSetBufferByIndex(
+          ring.task(slot), runner_->inputs()[0],
+          RegisterBuffer(kTfLiteIoTypeInput, &inputs_[slot * kNumElements]));
+      TfLiteExecutionTaskSetBufferByIndex(
+          ring.task(slot), runner_->outputs()[0],
+          RegisterBuffer(kTfLiteIoTypeOutput, &outputs_[slot * kNumElements]));
+    }
+  }
+
+  GatedAddKernel kernel_;
+  std::unique_ptr<testing::TestBackend> backend_;
+  std::unique_ptr<Interpreter> interpreter_;
+  AsyncSignatureRunner* runner_ = nullptr;
+  std::vector<float> inputs_;
+  std::vector<float> outputs_;
+};
+
+TEST_F(AsyncTaskRingTest, StreamsFramesThroughSlots) {
+  kernel_.release_first.Notify();
+  AsyncTaskRing ring(runner_, /*num_slots=*/3);
+  BindSlots(ring);
+
+  constexpr int kNumFrames = 10;
+  int consumed = 0;
+  for (int frame = 0; frame < kNumFrames + ring.num_slots(); ++frame) {
+    const int slot = frame % ring.num_slots();
+    TfLiteStatus status;
+    TfLiteExecutionTask* task = ring.Acquire(&status);
+    ASSERT_EQ(ring.task(slot), task);
+    ASSERT_EQ(kTfLiteOk, status);
+    if (frame >= ring.num_slots()) {
+      // The slot holds the result of the frame submitted `num_slots` ago.
+      const int previous = frame - ring.num_slots();
+      EXPECT_EQ(2.0f * previous, outputs_[slot * kNumElements]);
+      ++consumed;
+    }
+    if (frame >= kNumFrames) continue;
+    for (int i = 0; i < kNumElements; ++i) {
+      inputs_[slot * kNumElements + i] = frame;
+    }
+    ASSERT_EQ(kTfLiteOk, ring.Submit(task));
+  }
+  EXPECT_EQ(kNumFrames, consumed);
+  EXPECT_EQ(kTfLiteOk, ring.WaitAll());
+}
+
+TEST_F(AsyncTaskRingTest, NextFrameOverlapsExecution) {
+  AsyncTaskRing ring(runner_, /*num_slots=*/2);
+  BindSlots(ring);
+
+  TfLiteExecutionTask* first = ring.Acquire();
+  inputs_[0] = 1.0f;
+  ASSERT_EQ(kTfLiteOk, ring.Submit(first));
+  kernel_.first_started.WaitForNotification();
+
+  // The first frame is still executing, yet the second slot can be filled
+  // and scheduled.
+  TfLiteExecutionTask* second = ring.Acquire();
+  EXPECT_NE(first, second);
+  inputs_[kNumElements] = 2.0f;
+  ASSERT_EQ(kTfLiteOk, ring.Submit(second));
+
+  kernel_.release_first.Notify();
+  TfLiteStatus status;
+  EXPECT_EQ(first, ring.Acquire(&status));
+  EXPECT_EQ(kTfLiteOk, status);
+  EXPECT_EQ(2.0f, outputs_[0]);
+  EXPECT_EQ(kTfLiteOk, ring.WaitAll());
+  EXPECT_EQ(4.0f, outputs_[kNumElements]);
+}
+
+TEST_F(AsyncTaskRingTest, OnlySubmitsLastAcquiredTask) {
+  kernel_.release_first.Notify();
+  AsyncTaskRing ring(runner_, /*num_slots=*/2);
+  BindSlots(ring);
+
+  TfLiteExecutionTask* first = ring.Acquire();
+  ring.Acquire();
+  EXPECT_EQ(kTfLiteError, ring.Submit(first));
+}
+
+}  // namespace
+}  // namespace async
+}  // namespace tflite
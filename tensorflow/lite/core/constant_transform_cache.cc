@@ -0,0 +1,55 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/constant_transform_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+
+const void* ConstantTransformCache::GetOrCreate(
+    const Key& key, size_t bytes,
+    const std::function<TfLiteStatus(void*)>& transform) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it != results_.end()) return it->second.data;
+  if (bytes > capacity_bytes_ - size_bytes_) return nullptr;
+
+  Result result;
+  result.buffer.reset(new char[bytes + kDefaultTensorAlignment]);
+  const uintptr_t address = reinterpret_cast<uintptr_t>(result.buffer.get());
+  result.data = reinterpret_cast<void*>(
+      (address + kDefaultTensorAlignment - 1) / kDefaultTensorAlignment *
+      kDefaultTensorAlignment);
+  if (transform(result.data) != kTfLiteOk) return nullptr;
+  void* data = result.data;
+  results_.emplace(key, std::move(result));
+  size_bytes_ += bytes;
+  return data;
+}
+
+size_t ConstantTransformCache::size_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_bytes_;
+}
+
+}  // namespace tflite
@@ -0,0 +1,93 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_CONSTANT_TRANSFORM_CACHE_H_
+#define TENSORFLOW_LITE_CORE_CONSTANT_TRANSFORM_CACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <tuple>
+
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+
+// Transforms whose results can be shared through a ConstantTransformCache.
+enum class ConstantTransform {
+  kDequantize,
+  kCast,
+};
+
+// Results of transforms applied to constant tensors, e.g. the dequantized
+// weights of a model. Results are keyed by the identity of the constant
+// buffer, so that all the subgraphs and signatures of a model that transform
+// the same buffer share one result.
+//
+// Results are never evicted: the tensors that view them keep pointing to
+// them. Instead, results that would exceed the capacity are not cached, and
+// kernels fall back to computing them per node.
+//
+// WARNING: This is an experimental API and subject to change.
+class ConstantTransformCache {
+ public:
+  struct Key {
+    ConstantTransform transform;
+    // Address and size of the constant input buffer.
+    const void* data;
+    size_t bytes;
+    TfLiteType output_type;
+    // Serialized dims and quantization parameters of the input, as tensors
+    // viewing the same buffer may interpret it differently.
+    std::string params;
+
+    bool operator<(const Key& other) const {
+      return std::tie(transform, data, bytes, output_type, params) <
+             std::tie(other.transform, other.data, other.bytes,
+                      other.output_type, other.params);
+    }
+  };
+
+  explicit ConstantTransformCache(size_t capacity_bytes)
+      : capacity_bytes_(capacity_bytes) {}
+
+  // Returns the cached result for `key`, computing it with `transform` into
+  // a new buffer of `bytes` on a miss. Returns nullptr if the result would
+  // exceed the capacity or `transform` fails. Thread safe.
+  const void* GetOrCreate(const Key& key, size_t bytes,
+                          const std::function<TfLiteStatus(void*)>& transform);
+
+  // Returns the bytes held by cached results.
+  size_t size_bytes() const;
+  size_t capacity_bytes() const { return capacity_bytes_; }
+
+ private:
+  struct Result {
+    std::unique_ptr<char[]> buffer;
+    // `buffer` aligned to kDefaultTensorAlignment.
+    void* data;
+  };
+
+  const size_t capacity_bytes_;
+  mutable std::mutex mutex_;
+  std::map<Key, Result> results_;
+  size_t size_bytes_ = 0;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_CONSTANT_TRANSFORM_CACHE_H_
@@ -0,0 +1,178 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/constant_transform_cache.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/interpreter_options.h"
+#include "tensorflow/lite/interpreter_test_util.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+namespace {
+
+TEST(ConstantTransformCache, ComputesEachResultOnce) {
+  ConstantTransformCache cache(/*capacity_bytes=*/64);
+  const int8_t weights[4] = {1, 2, 3, 4};
+  const ConstantTransformCache::Key key = {
+      ConstantTransform::kDequantize, weights, sizeof(weights),
+      kTfLiteFloat32, ""};
+  int num_computes = 0;
+  auto transform = [&num_computes](void* data) {
+    ++num_computes;
+    std::memset(data, 0, 16);
+    return kTfLiteOk;
+  };
+  const void* result = cache.GetOrCreate(key, 16, transform);
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(result) % kDefaultTensorAlignment, 0);
+  EXPECT_EQ(cache.GetOrCreate(key, 16, transform), result);
+  EXPECT_EQ(num_computes, 1);
+  EXPECT_EQ(cache.size_bytes(), 16);
+
+  // The same buffer read with other parameters is a different result.
+  ConstantTransformCache::Key other_key = key;
+  other_key.params = "scale";
+  EXPECT_NE(cache.GetOrCreate(other_key, 16, transform), result);
+  EXPECT_EQ(num_computes, 2);
+}
+
+TEST(ConstantTransformCache, RespectsCapacity) {
+  ConstantTransformCache cache(/*capacity_bytes=*/16);
+  const int8_t weights[8] = {};
+  auto transform = [](void*) { return kTfLiteOk; };
+  EXPECT_EQ(cache.GetOrCreate({ConstantTransform::kCast, weights, 8,
+                               kTfLiteFloat32, ""},
+                              32, transform),
+            nullptr);
+  EXPECT_EQ(cache.size_bytes(), 0);
+  EXPECT_EQ(
+      cache.GetOrCreate({ConstantTransform::kCast, weights, 8, kTfLiteInt8, ""},
+                        8, [](void*) { return kTfLiteError; }),
+      nullptr);
+  EXPECT_EQ(cache.size_bytes(), 0);
+}
+
+// Two subgraphs computing dequantize(weights) + input from the same weights.
+class ConstantTransformCacheInterpreterTest : public InterpreterTest {
+ protected:
+  void BuildSubgraph(Subgraph* subgraph) {
+    subgraph->AddTensors(4);
+    subgraph->SetInputs({2});
+    subgraph->SetOutputs({3});
+    auto* affine = static_cast<TfLiteAffineQuantization*>(
+        malloc(sizeof(TfLiteAffineQuantization)));
+    affine->scale = TfLiteFloatArrayCreate(1);
+    affine->scale->data[0] = 0.5f;
+    affine->zero_point = TfLiteIntArrayCreate(1);
+    affine->zero_point->data[0] = 0;
+    affine->quantized_dimension = 0;
+    subgraph->SetTensorParametersReadOnly(
+        0, kTfLiteInt8, "weights", {4}, {kTfLiteAffineQuantization, affine},
+        reinterpret_cast<const char*>(weights_), sizeof(weights_));
+    for (int i = 1; i < 4; ++i) {
+      subgraph->SetTensorParametersReadWrite(i, kTfLiteFloat32, "", {4},
+                                             {kTfLiteNoQuantization, nullptr});
+    }
+    subgraph->AddNodeWithParameters({0}, {1}, {}, nullptr, 0, nullptr,
+                                    ops::builtin::Register_DEQUANTIZE());
+    auto* params =
+        static_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+    params->activation = kTfLiteActNone;
+    subgraph->AddNodeWithParameters({1, 2}, {3}, {}, nullptr, 0, params,
+                                    ops::builtin::Register_ADD());
+  }
+
+  void BuildAndInvoke(size_t cache_size) {
+    InterpreterOptions options;
+    options.SetConstantTransformCacheSize(cache_size);
+    ASSERT_EQ(interpreter_->ApplyOptions(&options), kTfLiteOk);
+    AddSubgraphs(1);
+    for (int i = 0; i < 2; ++i) {
+      Subgraph* subgraph = interpreter_->subgraph(i);
+      BuildSubgraph(subgraph);
+      AllocateAndInvoke(subgraph);
+    }
+  }
+
+  void AllocateAndInvoke(Subgraph* subgraph) {
+    ASSERT_EQ(subgraph->AllocateTensors(), kTfLiteOk);
+    // Invoke twice to check that results persist across invocations.
+    for (int invocation = 0; invocation < 2; ++invocation) {
+      float* input = subgraph->tensor(2)->data.f;
+      for (int j = 0; j < 4; ++j) input[j] = 1.0f + invocation;
+      ASSERT_EQ(subgraph->Invoke(), kTfLiteOk);
+      const float* output = subgraph->tensor(3)->data.f;
+      for (int j = 0; j < 4; ++j) {
+        EXPECT_EQ(output[j], 0.5f * weights_[j] + 1.0f + invocation);
+      }
+    }
+  }
+
+  const int8_t weights_[4] = {-4, 0, 4, 8};
+};
+
+TEST_F(ConstantTransformCacheInterpreterTest, SharesDequantizedWeights) {
+  BuildAndInvoke(/*cache_size=*/1024);
+  const TfLiteTensor* dequantized0 = interpreter_->subgraph(0)->tensor(1);
+  const TfLiteTensor* dequantized1 = interpreter_->subgraph(1)->tensor(1);
+  EXPECT_EQ(dequantized0->allocation_type, kTfLiteMmapRo);
+  EXPECT_EQ(dequantized0->data.raw, dequantized1->data.raw);
+}
+
+TEST_F(ConstantTransformCacheInterpreterTest, FallsBackWhenFull) {
+  BuildAndInvoke(/*cache_size=*/8);
+  const TfLiteTensor* dequantized0 = interpreter_->subgraph(0)->tensor(1);
+  const TfLiteTensor* dequantized1 = interpreter_->subgraph(1)->tensor(1);
+  EXPECT_EQ(dequantized0->allocation_type, kTfLiteArenaRwPersistent);
+  EXPECT_NE(dequantized0->data.raw, dequantized1->data.raw);
+}
+
+TEST_F(ConstantTransformCacheInterpreterTest, SharesCacheAcrossInterpreters) {
+  auto cache = std::make_shared<ConstantTransformCache>(1024);
+  InterpreterOptions options;
+  options.SetConstantTransformCache(cache);
+  // Takes precedence over the capacity.
+  options.SetConstantTransformCacheSize(0);
+  Interpreter other_interpreter;
+  for (Interpreter* interpreter : {interpreter_.get(), &other_interpreter}) {
+    ASSERT_EQ(interpreter->ApplyOptions(&options), kTfLiteOk);
+    BuildSubgraph(&interpreter->primary_subgraph());
+    AllocateAndInvoke(&interpreter->primary_subgraph());
+  }
+  const TfLiteTensor* dequantized0 = interpreter_->tensor(1);
+  const TfLiteTensor* dequantized1 = other_interpreter.tensor(1);
+  EXPECT_EQ(dequantized0->allocation_type, kTfLiteMmapRo);
+  EXPECT_EQ(dequantized0->data.raw, dequantized1->data.raw);
+  EXPECT_EQ(cache->size_bytes(), 4 * sizeof(float));
+}
+
+TEST_F(ConstantTransformCacheInterpreterTest, DisabledByDefault) {
+  BuildAndInvoke(/*cache_size=*/0);
+  EXPECT_EQ(interpreter_->subgraph(0)->tensor(1)->allocation_type,
+            kTfLiteArenaRwPersistent);
+}
+
+}  // namespace
+}  // namespace tflite
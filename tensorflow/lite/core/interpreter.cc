@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/core/constant_transform_cache.h"
 #include "tensorflow/lite/core/signature_runner.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/external_cpu_backend_context.h"
@@ -204,6 +205,7 @@ void Interpreter::AddSubgraphs(int subgraphs_to_add,
     Subgraph* subgraph = new Subgraph(
         error_reporter_, external_contexts_, &subgraphs_, &resources_,
         &resource_ids_, &initialization_status_map_, subgraphs_.size());
+    subgraph->SetConstantTransformCache(constant_transform_cache_.get());
     subgraphs_.emplace_back(subgraph);
   }
 }
@@ -494,9 +496,20 @@ TfLiteStatus Interpreter::ApplyOptionsImpl(InterpreterOptions* options) {
   }
   options_ = std::make_unique<InterpreterOptions>(*options);
 
+  // Tensors may already view cached results, so the cache is never replaced.
+  if (constant_transform_cache_ == nullptr) {
+    if (options_->GetConstantTransformCache() != nullptr) {
+      constant_transform_cache_ = options_->GetConstantTransformCache();
+    } else if (options_->GetConstantTransformCacheSize() > 0) {
+      constant_transform_cache_ = std::make_shared<ConstantTransformCache>(
+          options_->GetConstantTransformCacheSize());
+    }
+  }
+
   // Set InterpreterOptions object to SubGraph.
   for (auto& subgraph : subgraphs_) {
     subgraph->SetOptions(options_.get());
+    subgraph->SetConstantTransformCache(constant_transform_cache_.get());
   }
   return kTfLiteOk;
 }
@@ -46,6 +46,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/async/async_signature_runner.h"
 #include "tensorflow/lite/core/c/common.h"  // IWYU pragma: export
+#include "tensorflow/lite/core/constant_transform_cache.h"
 #include "tensorflow/lite/core/signature_runner.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
@@ -498,6 +499,20 @@ class Interpreter {
   /// invocation.
   TfLiteStatus ReleaseNonPersistentMemory();
 
+  /// \warning Experimental interface, subject to change. \n
+  /// \brief Places the non-persistent tensors of the primary subgraph in
+  /// `buffer`, so that interpreters that never run at the same time, e.g.
+  /// models run in strict sequence, reserve the memory of the largest of them
+  /// instead of their sum. The buffer, declared in simple_memory_arena.h, must
+  /// be aligned to at least `kDefaultTensorAlignment` bytes.
+  /// Interpreters bound to the same buffer must not run concurrently, and the
+  /// contents of their tensors, inputs and outputs included, do not survive
+  /// the run of another one: AllocateTensors() must be called again before
+  /// filling the inputs of each run. This must be called before the first
+  /// AllocateTensors().
+  TfLiteStatus SetSharedArenaBuffer(
+      std::shared_ptr<ResizableAlignedBuffer> buffer);
+
   /// Update allocations for all tensors. This will redim dependent tensors
   /// using the input tensor dimensionality as given. This is relatively
   /// expensive. This *must be* called after the interpreter has been created
@@ -964,6 +979,11 @@ class Interpreter {
   // multiple subgraphs.
   resource::InitializationStatusMap initialization_status_map_;
 
+  // Results of transforms applied to constant tensors. Shared by multiple
+  // subgraphs, and by other interpreters if set in the options. Null unless
+  // enabled by the options.
+  std::shared_ptr<ConstantTransformCache> constant_transform_cache_;
+
   // Indicating delegates that the TFLite interpreter will apply by default.
   // An empty one means there's no delegate to be applied by default or
   // delegates have been applied and doesn't need to be applied again.
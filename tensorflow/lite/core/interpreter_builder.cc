@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/flatbuffer_conversions.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/c/c_api_types.h"
 #include "tensorflow/lite/core/interpreter.h"
 #include "tensorflow/lite/core/macros.h"
@@ -308,6 +309,17 @@ std::vector<int> FlatBufferIntArrayToVector(T* flat_array) {
   return ret;
 }
 
+// Same as FlatBufferIntArrayToVector, but reuses the capacity of `vec` so that
+// parsing many nodes doesn't allocate their index arrays one by one.
+template <class T>
+void FlatBufferIntArrayToVector(T* flat_array, std::vector<int>* vec) {
+  if (flat_array == nullptr) {
+    vec->clear();
+    return;
+  }
+  vec->assign(flat_array->begin(), flat_array->end());
+}
+
 // Used to determine how the op data parsing function creates its working space.
 class MallocDataAllocator : public BuiltinDataAllocator {
  public:
@@ -338,6 +350,7 @@ TfLiteStatus InterpreterBuilder::ParseNodes(
 
   // Reduce the number of redundant allocations
   subgraph->ReserveNodes(operators->size());
+  std::vector<int> inputs, outputs, intermediates;
 
   for (int i = 0; i < operators->size(); ++i) {
     const auto* op = operators->Get(i);
@@ -394,11 +407,11 @@ TfLiteStatus InterpreterBuilder::ParseNodes(
       TF_LITE_ENSURE_STATUS(ParseOpData(op, op_type, error_reporter_,
                                         &malloc_allocator, &builtin_data));
     }
-    subgraph->AddNodeWithParameters(
-        FlatBufferIntArrayToVector(op->inputs()),
-        FlatBufferIntArrayToVector(op->outputs()),
-        FlatBufferIntArrayToVector(op->intermediates()), init_data,
-        init_data_size, builtin_data, registration);
+    FlatBufferIntArrayToVector(op->inputs(), &inputs);
+    FlatBufferIntArrayToVector(op->outputs(), &outputs);
+    FlatBufferIntArrayToVector(op->intermediates(), &intermediates);
+    subgraph->AddNodeWithParameters(inputs, outputs, intermediates, init_data,
+                                    init_data_size, builtin_data, registration);
   }
 
   return status;
@@ -856,11 +869,21 @@ TfLiteStatus InterpreterBuilder::operator()(
     // Finally setup nodes and tensors
     // Parse tensors before nodes as ParseNodes checks input tensors for the
     // nodes.
-    if (ParseTensors(buffers, tensors, modified_subgraph, subgraph_info) !=
-        kTfLiteOk)
-      return cleanup_and_error();
-    if (operators && ParseNodes(operators, modified_subgraph) != kTfLiteOk)
-      return cleanup_and_error();
+    // The profile events must end before the interpreter is deleted on error.
+    TfLiteStatus parse_status;
+    {
+      TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(modified_subgraph->GetProfiler(),
+                                           "InterpreterBuilder::ParseTensors");
+      parse_status =
+          ParseTensors(buffers, tensors, modified_subgraph, subgraph_info);
+    }
+    if (parse_status != kTfLiteOk) return cleanup_and_error();
+    if (operators) {
+      TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE(modified_subgraph->GetProfiler(),
+                                           "InterpreterBuilder::ParseNodes");
+      parse_status = ParseNodes(operators, modified_subgraph);
+    }
+    if (parse_status != kTfLiteOk) return cleanup_and_error();
 
     std::vector<int> variables;
     for (int i = 0; i < modified_subgraph->tensors_size(); ++i) {
@@ -896,7 +919,12 @@ TfLiteStatus InterpreterBuilder::operator()(
     (*interpreter)->ReportTelemetrySettings(kTelemetryBuilderEventName);
   }
 
-  TfLiteStatus status = ApplyDelegates(interpreter->get());
+  TfLiteStatus status;
+  {
+    TFLITE_SCOPED_TAGGED_DEFAULT_PROFILE((*interpreter)->GetProfiler(),
+                                         "InterpreterBuilder::ApplyDelegates");
+    status = ApplyDelegates(interpreter->get());
+  }
   if (status != kTfLiteOk) {
     interpreter->reset();
   }
@@ -46,6 +46,11 @@ TfLiteStatus Interpreter::ReleaseNonPersistentMemory() {
   return primary_subgraph().ReleaseNonPersistentMemory();
 }
 
+TfLiteStatus Interpreter::SetSharedArenaBuffer(
+    std::shared_ptr<ResizableAlignedBuffer> buffer) {
+  return primary_subgraph().SetSharedArenaBuffer(std::move(buffer));
+}
+
 TfLiteStatus Interpreter::ResetVariableTensors() {
   for (auto& subgraph : subgraphs_) {
     TF_LITE_ENSURE_STATUS(subgraph->ResetVariableTensors());
@@ -17,14 +17,18 @@ limitations under the License.
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
 #include <cstdarg>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -42,6 +46,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/logger.h"
 #include "tensorflow/lite/memory_planner.h"
@@ -109,6 +114,32 @@ void SetForbiddenContextFunction(FunctionType* func) {
   *func = reinterpret_cast<FunctionType>(ForbiddenContextFunction);
 }
 
+// Serializes what, besides its buffer, determines the value of a constant
+// tensor, for keying the ConstantTransformCache.
+std::string ConstantTensorParams(const TfLiteTensor& tensor) {
+  std::string params;
+  auto append = [&params](const void* data, size_t bytes) {
+    params.append(static_cast<const char*>(data), bytes);
+  };
+  auto append_array = [&append](const auto* array) {
+    const int size = array ? array->size : 0;
+    append(&size, sizeof(size));
+    if (size > 0) append(array->data, size * sizeof(array->data[0]));
+  };
+  append(&tensor.type, sizeof(tensor.type));
+  append_array(tensor.dims);
+  append(&tensor.params, sizeof(tensor.params));
+  if (tensor.quantization.type == kTfLiteAffineQuantization &&
+      tensor.quantization.params != nullptr) {
+    const auto* affine = static_cast<const TfLiteAffineQuantization*>(
+        tensor.quantization.params);
+    append(&affine->quantized_dimension, sizeof(affine->quantized_dimension));
+    append_array(affine->scale);
+    append_array(affine->zero_point);
+  }
+  return params;
+}
+
 // Returns true if at least one tensor in the given list is kTfLiteDynamic.
 template <typename TensorIntArray>
 bool HasDynamicTensorImpl(const TfLiteContext& context,
@@ -134,6 +165,12 @@ bool HasDynamicTensor(const TfLiteContext& context,
                               dynamic_tensor_index);
 }
 
+// CPU backend context used by the kernels run on the current thread in place
+// of the one of the interpreter, if not null. Set on the threads of
+// ConcurrentNodeRunner so that kernels running at the same time don't share
+// a CPU backend context.
+thread_local TfLiteExternalContext* cpu_backend_context_override = nullptr;
+
 // Gets the legacy TfLiteQuantizationParams from the current TfLiteQuantization.
 TfLiteQuantizationParams GetLegacyQuantization(
     const TfLiteQuantization& quantization) {
@@ -195,6 +232,95 @@ TfLiteStatus VerifyCustomAllocationForTensor(
 
 }  // namespace
 
+namespace internal {
+
+// Runs the nodes of groups of concurrent nodes on a fixed set of threads. The
+// calling thread takes part in the work, so `num_threads - 1` threads are
+// started. Each of them owns a CPU backend context.
+class ConcurrentNodeRunner {
+ public:
+  explicit ConcurrentNodeRunner(int num_threads)
+      : num_threads_(num_threads), cpu_backend_contexts_(num_threads - 1) {
+    threads_.reserve(num_threads - 1);
+    for (int i = 0; i < num_threads - 1; ++i) {
+      threads_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+
+  ~ConcurrentNodeRunner() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  int num_threads() const { return num_threads_; }
+
+  // Calls `fn(i)` for each `i` in [0, `size`) and returns once all calls are
+  // done.
+  void Run(int size, const std::function<void(int)>& fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      fn_ = &fn;
+      size_ = size;
+      next_.store(0, std::memory_order_relaxed);
+      num_busy_threads_ = threads_.size();
+      ++generation_;
+    }
+    work_cv_.notify_all();
+    RunItems(fn);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return num_busy_threads_ == 0; });
+    fn_ = nullptr;
+  }
+
+ private:
+  void RunItems(const std::function<void(int)>& fn) {
+    for (int i = next_.fetch_add(1); i < size_; i = next_.fetch_add(1)) {
+      fn(i);
+    }
+  }
+
+  void WorkerLoop(int thread_index) {
+    cpu_backend_context_override = &cpu_backend_contexts_[thread_index];
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_cv_.wait(lock, [this, generation] {
+        return stop_ || generation_ != generation;
+      });
+      if (stop_) return;
+      generation = generation_;
+      const std::function<void(int)>* fn = fn_;
+      lock.unlock();
+      RunItems(*fn);
+      lock.lock();
+      if (--num_busy_threads_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  const int num_threads_;
+  std::vector<ExternalCpuBackendContext> cpu_backend_contexts_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  bool stop_ = false;
+  uint64_t generation_ = 0;
+  const std::function<void(int)>* fn_ = nullptr;
+  int size_ = 0;
+  std::atomic<int> next_{0};
+  int num_busy_threads_ = 0;
+};
+
+}  // namespace internal
+
 // A trivial implementation of GraphInfo around the Interpreter.
 // NOTE: this interpreter info represents the subset of the
 // graph that is executed according to execution plan. Thus,
@@ -244,6 +370,10 @@ class InterpreterInfo : public GraphInfo {
     return subgraph_->variables();
   }
 
+  std::vector<int> concurrent_node_groups() const override {
+    return subgraph_->PlanConcurrentNodeGroups();
+  }
+
  public:
   Subgraph* subgraph_;
 };
@@ -618,6 +748,10 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
 
 TfLiteExternalContext* Subgraph::GetExternalContext(
     TfLiteExternalContextType type) {
+  if (type == kTfLiteCpuBackendContext &&
+      cpu_backend_context_override != nullptr) {
+    return cpu_backend_context_override;
+  }
   if (static_cast<int>(type) >= 0 && type < kTfLiteMaxExternalContexts) {
     return external_contexts_[type];
   }
@@ -1251,6 +1385,21 @@ TfLiteStatus Subgraph::ReleaseNonPersistentMemory() {
   return kTfLiteOk;
 }
 
+TfLiteStatus Subgraph::SetSharedArenaBuffer(
+    std::shared_ptr<ResizableAlignedBuffer> buffer) {
+#ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
+  ReportError("Shared arena buffers require the arena memory planner.");
+  return kTfLiteError;
+#else
+  if (memory_planner_) {
+    ReportError("SetSharedArenaBuffer must be called before AllocateTensors.");
+    return kTfLiteError;
+  }
+  shared_arena_buffer_ = std::move(buffer);
+  return kTfLiteOk;
+#endif
+}
+
 TfLiteStatus Subgraph::ReleaseMemory() {
   state_ = kStateUninvokable;
   ReleaseNonPersistentMemory();
@@ -1561,9 +1710,13 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
+    auto arena_planner = std::make_unique<ArenaPlanner>(
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_);
+    if (shared_arena_buffer_) {
+      arena_planner->SetSharedArenaBuffer(shared_arena_buffer_);
+    }
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
   }
@@ -1604,6 +1757,52 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   return kTfLiteOk;
 }
 
+bool Subgraph::ShareConstantTransform(
+    ConstantTransform transform, const TfLiteTensor* input,
+    TfLiteTensor* output,
+    const std::function<TfLiteStatus(TfLiteTensor*)>& compute) {
+  if (constant_transform_cache_ == nullptr ||
+      input->allocation_type != kTfLiteMmapRo ||
+      output->type == kTfLiteString) {
+    return false;
+  }
+  // Only a previous call of this kernel makes its output constant.
+  if (output->allocation_type == kTfLiteMmapRo) return true;
+  const int output_index = output - context_.tensors;
+  if (std::find(outputs_.begin(), outputs_.end(), output_index) !=
+      outputs_.end()) {
+    return false;
+  }
+  size_t bytes;
+  if (tflite::BytesRequired(output->type, input->dims->data,
+                            input->dims->size, &bytes,
+                            &context_) != kTfLiteOk) {
+    return false;
+  }
+
+  const ConstantTransformCache::Key key = {transform, input->data.raw,
+                                           input->bytes, output->type,
+                                           ConstantTensorParams(*input)};
+  TfLiteTensor result = *output;
+  result.dims = input->dims;
+  result.bytes = bytes;
+  const void* data = constant_transform_cache_->GetOrCreate(
+      key, bytes, [&result, &compute](void* buffer) {
+        result.data.raw = static_cast<char*>(buffer);
+        return compute(&result);
+      });
+  if (data == nullptr) return false;
+
+  TfLiteTensorDataFree(output);
+  TfLiteIntArrayFree(output->dims);
+  output->dims = TfLiteIntArrayCopy(input->dims);
+  output->data.raw = static_cast<char*>(const_cast<void*>(data));
+  output->bytes = bytes;
+  output->allocation_type = kTfLiteMmapRo;
+  output->allocation = nullptr;
+  return true;
+}
+
 TfLiteStatus Subgraph::RemoveUnusedInputs() {
   std::vector<int> input_tensors_count = GetInputTensorsCount();
   // Mark unused inputs as kTfLiteOptionalTensor.
@@ -1653,6 +1852,13 @@ TfLiteStatus Subgraph::InvokeImpl() {
       TF_LITE_ENSURE(&context_, next_execution_plan_index_to_prepare_ >=
                                     execution_plan_index);
     }
+    if (const int group_end = ConcurrentNodeGroupEnd(execution_plan_index);
+        group_end > execution_plan_index + 1) {
+      TF_LITE_ENSURE_STATUS(
+          InvokeConcurrentNodes(execution_plan_index, group_end));
+      execution_plan_index = group_end - 1;
+      continue;
+    }
     int node_index = execution_plan_[execution_plan_index];
     TfLiteNode& node = nodes_and_registration_[node_index].first;
     const TfLiteRegistration& registration =
@@ -1763,6 +1969,123 @@ TfLiteStatus Subgraph::InvokeImpl() {
   return status;
 }
 
+const std::vector<int>& Subgraph::PlanConcurrentNodeGroups() {
+  concurrent_node_groups_.clear();
+  if (options_ && options_->GetInterOpNumThreads() > 1) {
+    InterpreterInfo info(this);
+    concurrent_node_groups_ = PartitionIntoConcurrentNodeGroups(&info);
+  }
+  return concurrent_node_groups_;
+}
+
+int Subgraph::ConcurrentNodeGroupEnd(int execution_plan_index) {
+  const int next_index = execution_plan_index + 1;
+  // Profilers and dynamic tensors released after each node expect nodes to
+  // run one at a time.
+  if (concurrent_node_groups_.empty() ||
+      concurrent_node_groups_.back() !=
+          static_cast<int>(execution_plan_.size()) ||
+      profiler_ || ShouldReleaseDynamicTensors()) {
+    return next_index;
+  }
+  auto group_end =
+      std::upper_bound(concurrent_node_groups_.begin(),
+                       concurrent_node_groups_.end(), execution_plan_index);
+  if (group_end == concurrent_node_groups_.end() ||
+      *std::prev(group_end) != execution_plan_index ||
+      *group_end == next_index) {
+    return next_index;
+  }
+  // All nodes must be prepared and have their memory planned, with no output
+  // that may be resized while running.
+  if (*group_end > next_execution_plan_index_to_prepare_ ||
+      *group_end > next_execution_plan_index_to_plan_allocation_) {
+    return next_index;
+  }
+  for (int i = execution_plan_index; i < *group_end; ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    if (HasDynamicTensor(context_, node.outputs, nullptr) ||
+        HasDynamicTensor(context_, node.temporaries, nullptr)) {
+      return next_index;
+    }
+  }
+  return *group_end;
+}
+
+TfLiteStatus Subgraph::InvokeConcurrentNodes(int first_execution_plan_index,
+                                             int end_execution_plan_index) {
+  for (int execution_plan_index = first_execution_plan_index;
+       execution_plan_index < end_execution_plan_index;
+       ++execution_plan_index) {
+    const TfLiteNode& node =
+        nodes_and_registration_[execution_plan_[execution_plan_index]].first;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) {
+        continue;
+      }
+      TfLiteTensor* tensor = &tensors_[tensor_index];
+      if (tensor->delegate && tensor->data_is_stale) {
+        TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
+      }
+      if (tensor->data.raw == nullptr && tensor->bytes > 0) {
+        ReportError("Input tensor %d lacks data", tensor_index);
+        return kTfLiteError;
+      }
+    }
+  }
+
+  if (check_cancelled_func_ != nullptr &&
+      check_cancelled_func_(cancellation_data_)) {
+    ReportError("Client requested cancel during Invoke()");
+    return kTfLiteError;
+  }
+
+  if (continue_invocation_ && !continue_invocation_->test_and_set()) {
+    // `Cancel` is called and cancellation flag is flipped.
+    ReportError("Client requested cancel during Invoke()");
+    return kTfLiteCancelled;
+  }
+
+  const int num_threads = options_->GetInterOpNumThreads();
+  if (!concurrent_node_runner_ ||
+      concurrent_node_runner_->num_threads() != num_threads) {
+    concurrent_node_runner_.reset();
+    concurrent_node_runner_ =
+        std::make_shared<internal::ConcurrentNodeRunner>(num_threads);
+  }
+
+  EnsureTensorsVectorCapacity();
+  tensor_resized_since_op_invoke_ = false;
+  const int num_nodes = end_execution_plan_index - first_execution_plan_index;
+  std::vector<TfLiteStatus> statuses(num_nodes, kTfLiteOk);
+  concurrent_node_runner_->Run(num_nodes, [&](int i) {
+    const int node_index = execution_plan_[first_execution_plan_index + i];
+    TfLiteNode& node = nodes_and_registration_[node_index].first;
+    const TfLiteRegistration& registration =
+        nodes_and_registration_[node_index].second;
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tensorflow::profiler::TraceMe* trace_op = tflite::OnTfLiteOpInvoke(
+        GetTFLiteOpName(registration), subgraph_index_, node_index);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+    statuses[i] = OpInvoke(registration, &node);
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tflite::OnTfLiteOpInvokeEnd(trace_op);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+  });
+
+  for (int i = 0; i < num_nodes; ++i) {
+    if (statuses[i] != kTfLiteOk) {
+      const int node_index = execution_plan_[first_execution_plan_index + i];
+      auto err = ReportOpError(
+          &context_, nodes_and_registration_[node_index].first,
+          nodes_and_registration_[node_index].second, node_index,
+          "failed to invoke");
+      return statuses[i] == kTfLiteCancelled ? statuses[i] : err;
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
                                     TfLiteTensor* tensor,
                                     TfLiteIntArray* new_size) {
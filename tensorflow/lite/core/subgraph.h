@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -36,6 +37,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/constant_transform_cache.h"
 #include "tensorflow/lite/core/macros.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
@@ -70,6 +72,12 @@ class TestDelegate;  // Class for friend declarations.
 }  // namespace delegates
 #endif  // DOXYGEN_SKIP
 
+class ResizableAlignedBuffer;
+
+namespace internal {
+class ConcurrentNodeRunner;
+}  // namespace internal
+
 class Subgraph {
  public:
 #ifndef DOXYGEN_SKIP
@@ -281,6 +289,16 @@ class Subgraph {
   // AllocateTensors needs to be called before next invocation.
   TfLiteStatus ReleaseNonPersistentMemory();
 
+  // WARNING: Experimental interface, subject to change
+  // Places the non-persistent tensors of this subgraph in `buffer`, which may
+  // be shared with subgraphs of other interpreters. Subgraphs bound to the same
+  // buffer must never run at the same time, and their tensor data does not
+  // survive the run of another one: AllocateTensors() needs to be called before
+  // filling the inputs of each run. Must be called before the first
+  // AllocateTensors().
+  TfLiteStatus SetSharedArenaBuffer(
+      std::shared_ptr<ResizableAlignedBuffer> buffer);
+
   // WARNING: Experimental interface, subject to change
   // This API releases memory held by the given subgraph. This method is
   // designed to release memory of control flow subgraphs.
@@ -482,6 +500,29 @@ class Subgraph {
     return (options_ && (options_->GetDynamicAllocationForLargeTensors() > 0));
   }
 
+  // WARNING: This is an experimental API and subject to change.
+  // Set the cache of constant transforms shared by all subgraphs of the
+  // interpreter, or nullptr to disable it. Owned by the interpreter.
+  void SetConstantTransformCache(ConstantTransformCache* cache) {
+    constant_transform_cache_ = cache;
+  }
+
+  // WARNING: This is an experimental API and subject to change.
+  // Makes `output` a read-only view of `transform` applied to the constant
+  // `input`, computed by `compute` at most once per interpreter and shared
+  // with every subgraph that applies the same transform to the same buffer.
+  // `compute` writes the output of the transform to the tensor it is given,
+  // which has the type of `output` and the shape of `input`.
+  //
+  // Returns true if `output` views a shared result; its allocation type is
+  // then kTfLiteMmapRo, and it must not be resized. Returns false, leaving
+  // `output` unchanged, if there is no cache, `input` is not constant,
+  // `output` is an output of the subgraph, or the result does not fit.
+  bool ShareConstantTransform(
+      ConstantTransform transform, const TfLiteTensor* input,
+      TfLiteTensor* output,
+      const std::function<TfLiteStatus(TfLiteTensor*)>& compute);
+
   // WARNING: This is an experimental API and subject to change.
   // Remove unused inputs of the subgraph. It checks usage of inputs and mark it
   // as kTfLiteOptionalTensor if the input is not used in graph execution.
@@ -602,6 +643,7 @@ class Subgraph {
   friend class tflite::impl::InterpreterBuilder;
   friend class tflite::async::AsyncSubgraph;
   friend class TestDelegate;
+  friend class InterpreterInfo;
 #endif  // DOXYGEN_SKIP
   // SubgraphAwareProfiler wraps an actual TFLite profiler, such as a
   // BufferedProfiler instance, and takes care of event profiling/tracing in a
@@ -901,6 +943,22 @@ class Subgraph {
   // Ensures the memory required is planned and allocated.
   TfLiteStatus EnsureMemoryAllocations();
 
+  // Splits the execution plan into groups of nodes that may run concurrently
+  // if more than one inter-op thread is requested in the options, and caches
+  // them in `concurrent_node_groups_`. Called by the memory planner, which
+  // must not let the tensors of nodes of the same group share memory.
+  const std::vector<int>& PlanConcurrentNodeGroups();
+
+  // Returns the end of the group of concurrent nodes starting at
+  // `execution_plan_index` if its nodes are ready to run concurrently, or
+  // `execution_plan_index + 1` if the node must run on its own.
+  int ConcurrentNodeGroupEnd(int execution_plan_index);
+
+  // Invokes the nodes in [`first_execution_plan_index`,
+  // `end_execution_plan_index`) of the execution plan concurrently.
+  TfLiteStatus InvokeConcurrentNodes(int first_execution_plan_index,
+                                     int end_execution_plan_index);
+
   // Enables cancellation of in flight invocation with `Cancel` call.
   // Should only be called by the interpreter when building the subgraph.
   // `flag` should be nullptr otherwise cancellation is disabled.
@@ -1088,6 +1146,17 @@ class Subgraph {
 
   std::unique_ptr<MemoryPlanner> memory_planner_;
 
+  // Buffer shared with other subgraphs for the non-persistent arena, if any.
+  std::shared_ptr<ResizableAlignedBuffer> shared_arena_buffer_;
+
+  // Execution plan index of the first node of each group of concurrent nodes,
+  // followed by the size of the execution plan, as of the last memory
+  // planning. Empty if nodes run one at a time.
+  std::vector<int> concurrent_node_groups_;
+
+  // Threads running groups of concurrent nodes. Created on first use.
+  std::shared_ptr<internal::ConcurrentNodeRunner> concurrent_node_runner_;
+
   // Maps tensor index to custom allocation for all applicable tensors.
   std::map<int, TfLiteCustomAllocation> custom_allocations_;
 
@@ -1157,6 +1226,10 @@ class Subgraph {
   // `InterpreterOptions` object which is being used and owned by Interpreter.
   InterpreterOptions* options_;
 
+  // Cache of constant transforms shared by all subgraphs; owned by the
+  // Interpreter. Null when the cache is disabled.
+  ConstantTransformCache* constant_transform_cache_ = nullptr;
+
   // Control edges (i.e., dependencies between nodes in addition to their data
   // dependencies); can be nullptr. Will be initialized from metadata associated
   // with the owning interpreter; the pointee is owned by the owning
@@ -70,6 +70,30 @@ TEST(OptionalAndroidHardwareBufferTest, CanAcquireAndReleaseOnAndroid) {
   Instance().Release(buffer);  // To match Allocate
 }
 
+TEST(OptionalAndroidHardwareBufferTest, CanLockAndUnlockOnAndroid) {
+  EXPECT_EQ(Instance().Supported(), true);
+  AHardwareBuffer* buffer;
+  AHardwareBuffer_Desc description{};
+  description.width = 1600;
+  description.height = 1;
+  description.layers = 1;
+  description.rfu0 = 0;
+  description.rfu1 = 0;
+  description.stride = 1;
+  description.format = AHARDWAREBUFFER_FORMAT_BLOB;
+  description.usage = AHARDWAREBUFFER_USAGE_CPU_READ_OFTEN |
+                      AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN;
+  EXPECT_TRUE(Instance().IsSupported(&description));
+  EXPECT_EQ(Instance().Allocate(&description, &buffer), 0);
+  void* data = nullptr;
+  EXPECT_EQ(Instance().Lock(buffer, AHARDWAREBUFFER_USAGE_CPU_WRITE_OFTEN,
+                            /*fence=*/-1, /*rect=*/nullptr, &data),
+            0);
+  EXPECT_NE(data, nullptr);
+  EXPECT_EQ(Instance().Unlock(buffer, /*fence=*/nullptr), 0);
+  Instance().Release(buffer);
+}
+
 #endif  // defined(__ANDROID__)
 
 }  // namespace
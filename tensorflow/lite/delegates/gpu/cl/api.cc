@@ -962,6 +962,7 @@ class InferenceEnvironmentImpl : public InferenceEnvironment {
         CreateProfilingCommandQueue(device, context, &profiling_queue));
     environment_ = Environment(std::move(device), std::move(context),
                                std::move(queue), std::move(profiling_queue));
+    environment_.SetTuningDatabase(options_.tuning_database);
     return environment_.Init();
   }
 
@@ -985,6 +986,10 @@ class InferenceEnvironmentImpl : public InferenceEnvironment {
     RETURN_IF_ERROR(RunGraphTransformsForGpuModel(&model));
     InferenceContext context;
     CreateGpuModelInfo create_info = GetCreateInfo(environment_, options);
+    // The tuned work group sizes are stored with the serialized model and
+    // reused by every later load, so the exhaustive tuning pays off even when
+    // the options ask for a fast single answer.
+    create_info.hints.hints &= ~ModelHints::kFastTuning;
     RETURN_IF_ERROR(context.InitFromGraph(create_info, model, &environment_,
                                           serialized_model));
     return absl::OkStatus();
@@ -193,7 +193,26 @@ absl::Status ClOperation::RestoreDeserialized(const ProgramCache& program_cache,
 }
 
 absl::Status ClOperation::Tune(TuningType tuning_type, const GpuInfo& gpu_info,
-                               ProfilingCommandQueue* profiling_queue) {
+                               ProfilingCommandQueue* profiling_queue,
+                               TuningDatabase* database) {
+  // Only exhaustive results are worth sharing, and only they are worth
+  // skipping the search for.
+  const bool use_database =
+      database != nullptr && tuning_type == TuningType::kExhaustive;
+  std::string device_key;
+  if (use_database) {
+    device_key = TuningDatabase::GetDeviceKey(gpu_info);
+    int3 work_group_size;
+    if (database->Find(device_key, kernel_fingerprint_,
+                       operation_->GetRecalculatedGridSize(),
+                       &work_group_size) &&
+        work_group_size.x * work_group_size.y * work_group_size.z <=
+            kernel_.info_.max_work_group_size) {
+      operation_->work_group_size_ = work_group_size;
+      operation_->RecalculateWorkGroupsCount();
+      return absl::OkStatus();
+    }
+  }
   std::vector<GPUOperation::DispatchInfo> possible_dispatches;
   operation_->GetPossibleDispatches(tuning_type, gpu_info, kernel_.info_,
                                     &possible_dispatches);
@@ -218,6 +237,11 @@ absl::Status ClOperation::Tune(TuningType tuning_type, const GpuInfo& gpu_info,
         &best_work_group_index));
     operation_->work_group_size_ = work_group_sizes[best_work_group_index];
     operation_->RecalculateWorkGroupsCount();
+    if (use_database) {
+      database->Add(device_key, kernel_fingerprint_,
+                    operation_->GetRecalculatedGridSize(),
+                    operation_->work_group_size_);
+    }
     return absl::OkStatus();
   }
 }
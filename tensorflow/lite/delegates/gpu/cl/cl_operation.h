@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/cl/cl_kernel.h"
 #include "tensorflow/lite/delegates/gpu/cl/program_cache.h"
 #include "tensorflow/lite/delegates/gpu/cl/tensor.h"
+#include "tensorflow/lite/delegates/gpu/cl/tuning_database.h"
 #include "tensorflow/lite/delegates/gpu/common/task/gpu_operation.h"
 
 namespace tflite {
@@ -110,8 +111,11 @@ class ClOperation {
                                  operation_->work_group_size_, n, flush_period);
   }
 
+  // If `database` is not null, exhaustive tuning reuses the work group size
+  // recorded for this kernel and grid size, or records the one it finds.
   absl::Status Tune(TuningType tuning_type, const GpuInfo& gpu_info,
-                    ProfilingCommandQueue* profiling_queue);
+                    ProfilingCommandQueue* profiling_queue,
+                    TuningDatabase* database = nullptr);
 
   absl::Status Compile(const CreationContext& creation_context);
 
@@ -101,7 +101,8 @@ Environment::Environment(Environment&& environment)
       context_(std::move(environment.context_)),
       queue_(std::move(environment.queue_)),
       profiling_queue_(std::move(environment.profiling_queue_)),
-      program_cache_(std::move(environment.program_cache_)) {}
+      program_cache_(std::move(environment.program_cache_)),
+      tuning_database_(environment.tuning_database_) {}
 
 Environment& Environment::operator=(Environment&& environment) {
   if (this != &environment) {
@@ -110,6 +111,7 @@ Environment& Environment::operator=(Environment&& environment) {
     queue_ = std::move(environment.queue_);
     profiling_queue_ = std::move(environment.profiling_queue_);
     program_cache_ = std::move(environment.program_cache_);
+    tuning_database_ = environment.tuning_database_;
   }
   return *this;
 }
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/cl/cl_context.h"
 #include "tensorflow/lite/delegates/gpu/cl/cl_device.h"
 #include "tensorflow/lite/delegates/gpu/cl/program_cache.h"
+#include "tensorflow/lite/delegates/gpu/cl/tuning_database.h"
 #include "tensorflow/lite/delegates/gpu/common/data_type.h"
 #include "tensorflow/lite/delegates/gpu/common/gpu_info.h"
 #include "tensorflow/lite/delegates/gpu/common/precision.h"
@@ -51,6 +52,12 @@ class Environment {
   ProfilingCommandQueue* profiling_queue() { return &profiling_queue_; }
   ProgramCache* program_cache() { return &program_cache_; }
   const ProgramCache* program_cache() const { return &program_cache_; }
+  // Optional, not owned. Shared by the inference contexts built with this
+  // environment to reuse and record exhaustive tuning results.
+  TuningDatabase* tuning_database() const { return tuning_database_; }
+  void SetTuningDatabase(TuningDatabase* database) {
+    tuning_database_ = database;
+  }
 
   std::vector<CalculationsPrecision> GetSupportedPrecisions() const;
   bool IsSupported(CalculationsPrecision precision) const;
@@ -73,6 +80,7 @@ class Environment {
   CLCommandQueue queue_;
   ProfilingCommandQueue profiling_queue_;
   ProgramCache program_cache_;
+  TuningDatabase* tuning_database_ = nullptr;
 };
 
 TensorStorageType GetFastestStorageType(const GpuInfo& gpu_info);
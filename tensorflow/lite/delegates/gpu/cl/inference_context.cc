@@ -365,7 +365,8 @@ absl::Status InferenceContext::InitFromGpuModel(
     }
   }
   RETURN_IF_ERROR(
-      Tune(tuning_type, env->device().GetInfo(), env->profiling_queue()));
+      Tune(tuning_type, env->device().GetInfo(), env->profiling_queue(),
+           env->tuning_database()));
   if (external_mutable_tensors_.empty()) {
     // using recordable queue only when no mutable external tensors
     InitRecordableQueue(env);
@@ -761,7 +762,8 @@ absl::Status InferenceContext::Compile(
 
 absl::Status InferenceContext::Tune(TuningType tuning_type,
                                     const GpuInfo& gpu_info,
-                                    ProfilingCommandQueue* profiling_queue) {
+                                    ProfilingCommandQueue* profiling_queue,
+                                    TuningDatabase* database) {
   // Cache tuned CL operations. Multiple CL operations might share the
   // same kernel but use different inputs, which might require different working
   // group setups. Therefore, we store a vector of tuned cl operations for each
@@ -789,7 +791,8 @@ absl::Status InferenceContext::Tune(TuningType tuning_type,
       continue;
     }
     RETURN_IF_ERROR(
-        node.cl_operation.Tune(tuning_type, gpu_info, profiling_queue));
+        node.cl_operation.Tune(tuning_type, gpu_info, profiling_queue,
+                               database));
     tuned_ops[fingerprint].emplace_back(std::cref(node.cl_operation));
   }
   return absl::OkStatus();
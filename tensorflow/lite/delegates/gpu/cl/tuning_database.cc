@@ -0,0 +1,152 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/cl/tuning_database.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/lite/delegates/gpu/common/gpu_info.h"
+#include "tensorflow/lite/delegates/gpu/common/status.h"
+#include "tensorflow/lite/delegates/gpu/common/types.h"
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+namespace {
+
+// Each line holds the tab separated device key, kernel fingerprint, grid size
+// and work group size. The sizes are space separated x, y and z values.
+constexpr char kFieldSeparator = '\t';
+
+bool ParseInt3(absl::string_view text, int3* value) {
+  std::vector<absl::string_view> parts = absl::StrSplit(text, ' ');
+  return parts.size() == 3 && absl::SimpleAtoi(parts[0], &value->x) &&
+         absl::SimpleAtoi(parts[1], &value->y) &&
+         absl::SimpleAtoi(parts[2], &value->z);
+}
+
+std::string Int3ToString(const int3& value) {
+  return absl::StrCat(value.x, " ", value.y, " ", value.z);
+}
+
+}  // namespace
+
+std::string TuningDatabase::GetDeviceKey(const GpuInfo& gpu_info) {
+  // The key must not contain field separators.
+  std::string key = absl::StrCat(gpu_info.opencl_info.vendor_name, "/",
+                                 gpu_info.opencl_info.device_name, "/",
+                                 gpu_info.opencl_info.compute_units_count);
+  for (char& c : key) {
+    if (c == kFieldSeparator || c == '\n') c = ' ';
+  }
+  return key;
+}
+
+bool TuningDatabase::Find(const std::string& device_key,
+                          uint64_t kernel_fingerprint, const int3& grid_size,
+                          int3* work_group_size) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(Key(device_key, kernel_fingerprint, grid_size.x,
+                              grid_size.y, grid_size.z));
+  if (it == entries_.end()) return false;
+  *work_group_size = it->second;
+  return true;
+}
+
+void TuningDatabase::Add(const std::string& device_key,
+                         uint64_t kernel_fingerprint, const int3& grid_size,
+                         const int3& work_group_size) {
+  absl::MutexLock lock(&mutex_);
+  entries_[Key(device_key, kernel_fingerprint, grid_size.x, grid_size.y,
+               grid_size.z)] = work_group_size;
+}
+
+int TuningDatabase::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+absl::Status TuningDatabase::Import(absl::string_view data) {
+  std::vector<std::pair<Key, int3>> imported;
+  for (absl::string_view line : absl::StrSplit(data, '\n')) {
+    if (line.empty()) continue;
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(line, kFieldSeparator);
+    uint64_t fingerprint;
+    int3 grid_size;
+    int3 work_group_size;
+    if (fields.size() != 4 || !absl::SimpleAtoi(fields[1], &fingerprint) ||
+        !ParseInt3(fields[2], &grid_size) ||
+        !ParseInt3(fields[3], &work_group_size)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Malformed tuning database entry: ", line));
+    }
+    imported.emplace_back(Key(std::string(fields[0]), fingerprint,
+                              grid_size.x, grid_size.y, grid_size.z),
+                          work_group_size);
+  }
+  absl::MutexLock lock(&mutex_);
+  for (auto& entry : imported) {
+    entries_[std::move(entry.first)] = entry.second;
+  }
+  return absl::OkStatus();
+}
+
+std::string TuningDatabase::Export() const {
+  absl::MutexLock lock(&mutex_);
+  std::string data;
+  for (const auto& [key, work_group_size] : entries_) {
+    const auto& [device_key, fingerprint, x, y, z] = key;
+    absl::StrAppend(&data, device_key, std::string(1, kFieldSeparator),
+                    fingerprint, std::string(1, kFieldSeparator),
+                    Int3ToString(int3(x, y, z)),
+                    std::string(1, kFieldSeparator),
+                    Int3ToString(work_group_size), "\n");
+  }
+  return data;
+}
+
+absl::Status TuningDatabase::LoadFromFile(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return absl::NotFoundError(absl::StrCat("Failed to open ", path));
+  }
+  std::stringstream data;
+  data << file.rdbuf();
+  return Import(data.str());
+}
+
+absl::Status TuningDatabase::SaveToFile(const std::string& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  file << Export();
+  if (!file) {
+    return absl::UnavailableError(absl::StrCat("Failed to write ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
@@ -0,0 +1,81 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_GPU_CL_TUNING_DATABASE_H_
+#define TENSORFLOW_LITE_DELEGATES_GPU_CL_TUNING_DATABASE_H_
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/lite/delegates/gpu/common/gpu_info.h"
+#include "tensorflow/lite/delegates/gpu/common/status.h"
+#include "tensorflow/lite/delegates/gpu/common/types.h"
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+
+// Persistent store of the best work group sizes found by exhaustive tuning.
+//
+// Entries are keyed by GPU model, kernel fingerprint and grid size, so they
+// are shared by every model that uses the same kernel on the same grid.
+// Databases can be exported to and imported from a text format with one entry
+// per line, e.g. to ship tuning results collected on a fleet of devices with
+// an app. Thread-safe, so one database can serve several environments.
+class TuningDatabase {
+ public:
+  TuningDatabase() = default;
+  TuningDatabase(const TuningDatabase&) = delete;
+  TuningDatabase& operator=(const TuningDatabase&) = delete;
+
+  // Returns the key of the GPU model described by `gpu_info`.
+  static std::string GetDeviceKey(const GpuInfo& gpu_info);
+
+  // Returns true and sets `work_group_size` if the database has an entry for
+  // the kernel with `kernel_fingerprint` dispatched on `grid_size`.
+  bool Find(const std::string& device_key, uint64_t kernel_fingerprint,
+            const int3& grid_size, int3* work_group_size) const;
+
+  // Adds or replaces an entry.
+  void Add(const std::string& device_key, uint64_t kernel_fingerprint,
+           const int3& grid_size, const int3& work_group_size);
+
+  int size() const;
+
+  // Merges the entries of `data`, which was produced by Export. Imported
+  // entries replace existing ones. On error, no entry is imported.
+  absl::Status Import(absl::string_view data);
+  std::string Export() const;
+
+  absl::Status LoadFromFile(const std::string& path);
+  absl::Status SaveToFile(const std::string& path) const;
+
+ private:
+  using Key = std::tuple<std::string, uint64_t, int, int, int>;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, int3> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_GPU_CL_TUNING_DATABASE_H_
@@ -0,0 +1,82 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/cl/tuning_database.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/delegates/gpu/common/gpu_info.h"
+#include "tensorflow/lite/delegates/gpu/common/types.h"
+
+namespace tflite {
+namespace gpu {
+namespace cl {
+namespace {
+
+TEST(TuningDatabaseTest, FindsAddedEntries) {
+  TuningDatabase database;
+  database.Add("gpu", 42, int3(16, 8, 1), int3(8, 4, 1));
+
+  int3 work_group_size;
+  ASSERT_TRUE(database.Find("gpu", 42, int3(16, 8, 1), &work_group_size));
+  EXPECT_EQ(work_group_size, int3(8, 4, 1));
+  EXPECT_FALSE(database.Find("other", 42, int3(16, 8, 1), &work_group_size));
+  EXPECT_FALSE(database.Find("gpu", 43, int3(16, 8, 1), &work_group_size));
+  EXPECT_FALSE(database.Find("gpu", 42, int3(16, 8, 2), &work_group_size));
+
+  database.Add("gpu", 42, int3(16, 8, 1), int3(16, 2, 1));
+  ASSERT_TRUE(database.Find("gpu", 42, int3(16, 8, 1), &work_group_size));
+  EXPECT_EQ(work_group_size, int3(16, 2, 1));
+  EXPECT_EQ(database.size(), 1);
+}
+
+TEST(TuningDatabaseTest, ExportsAndImports) {
+  TuningDatabase source;
+  source.Add("vendor/gpu/4", 18446744073709551615ull, int3(64, 32, 4),
+             int3(8, 8, 1));
+  source.Add("vendor/gpu/4", 7, int3(1, 1, 1), int3(1, 1, 1));
+
+  TuningDatabase destination;
+  destination.Add("vendor/gpu/4", 7, int3(1, 1, 1), int3(4, 4, 1));
+  ASSERT_TRUE(destination.Import(source.Export()).ok());
+  EXPECT_EQ(destination.size(), 2);
+  int3 work_group_size;
+  ASSERT_TRUE(destination.Find("vendor/gpu/4", 18446744073709551615ull,
+                               int3(64, 32, 4), &work_group_size));
+  EXPECT_EQ(work_group_size, int3(8, 8, 1));
+  ASSERT_TRUE(
+      destination.Find("vendor/gpu/4", 7, int3(1, 1, 1), &work_group_size));
+  EXPECT_EQ(work_group_size, int3(1, 1, 1));
+}
+
+TEST(TuningDatabaseTest, RejectsMalformedData) {
+  TuningDatabase database;
+  EXPECT_FALSE(database.Import("gpu\t42\t16 8 1\t8 4 1\ngpu\t42\t16 8\n").ok());
+  EXPECT_FALSE(database.Import("gpu\tabc\t16 8 1\t8 4 1\n").ok());
+  // Nothing is imported from malformed data.
+  EXPECT_EQ(database.size(), 0);
+}
+
+TEST(TuningDatabaseTest, DeviceKeyHasNoSeparators) {
+  GpuInfo gpu_info;
+  gpu_info.opencl_info.vendor_name = "Vendor";
+  gpu_info.opencl_info.device_name = "GPU\tModel";
+  gpu_info.opencl_info.compute_units_count = 4;
+  EXPECT_EQ(TuningDatabase::GetDeviceKey(gpu_info), "Vendor/GPU Model/4");
+}
+
+}  // namespace
+}  // namespace cl
+}  // namespace gpu
+}  // namespace tflite
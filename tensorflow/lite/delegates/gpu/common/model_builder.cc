@@ -44,6 +44,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/common/object_reader.h"
 #include "tensorflow/lite/delegates/gpu/common/operation_parser.h"
 #include "tensorflow/lite/delegates/gpu/common/operations.h"
+#include "tensorflow/lite/delegates/gpu/common/partition_cost_model.h"
 #include "tensorflow/lite/delegates/gpu/common/shape.h"
 #include "tensorflow/lite/delegates/gpu/common/status.h"
 #include "tensorflow/lite/delegates/gpu/common/tensor.h"
@@ -3273,7 +3274,8 @@ std::unique_ptr<TFLiteOperationParser> NewOperationParser(
 TfLiteIntArray* GetOpsToReplace(
     TfLiteContext* context, bool allow_quant_ops, int max_delegated_partitions,
     const absl::flat_hash_set<TfLiteBuiltinOperator>* excluded_ops,
-    int start_node_index, int end_node_index) {
+    int start_node_index, int end_node_index,
+    const PartitionCostModel* cost_model) {
   delegates::IsNodeSupportedFn node_supported_fn =
       [=](TfLiteContext* context, TfLiteNode* node,
           TfLiteRegistration* registration,
@@ -3333,14 +3335,20 @@ TfLiteIntArray* GetOpsToReplace(
     return true;
   };
 
-  delegates::FP16GraphPartitionHelper partition_helper(context,
-                                                       node_supported_fn);
+  std::unique_ptr<delegates::FP16GraphPartitionHelper> partition_helper;
+  if (cost_model) {
+    partition_helper = std::make_unique<CostModelGraphPartitionHelper>(
+        context, node_supported_fn, *cost_model);
+  } else {
+    partition_helper = std::make_unique<delegates::FP16GraphPartitionHelper>(
+        context, node_supported_fn);
+  }
   std::set<std::string> unsupported_nodes_info;
 #ifndef TFLITE_DEBUG_DELEGATE
-  auto res = partition_helper.Partition(&unsupported_nodes_info);
+  auto res = partition_helper->Partition(&unsupported_nodes_info);
 #else
-  auto res = partition_helper.Partition(&unsupported_nodes_info,
-                                        start_node_index, end_node_index);
+  auto res = partition_helper->Partition(&unsupported_nodes_info,
+                                         start_node_index, end_node_index);
 #endif
   if (res != kTfLiteOk) {
     return TfLiteIntArrayCreate(0);
@@ -3349,11 +3357,11 @@ TfLiteIntArray* GetOpsToReplace(
   // By default, we simply get 1st largest partition as
   // 'max_delegate_partitions' is set to 1 by default.
   std::vector<int> ops_to_replace =
-      partition_helper.GetNodesOfFirstNLargestPartitions(
+      partition_helper->GetNodesOfFirstNLargestPartitions(
           max_delegated_partitions);
 
   if (!unsupported_nodes_info.empty() &&
-      partition_helper.num_total_nodes() > ops_to_replace.size()) {
+      partition_helper->num_total_nodes() > ops_to_replace.size()) {
     std::string unsupported = absl::StrJoin(unsupported_nodes_info, "\n");
     std::string error_message = absl::StrCat(
         "Following operations are not supported by GPU delegate:\n",
@@ -3362,11 +3370,11 @@ TfLiteIntArray* GetOpsToReplace(
       absl::StrAppend(
           &error_message, ops_to_replace.size(),
           " operations will run on the GPU, and the remaining ",
-          partition_helper.num_total_nodes() - ops_to_replace.size());
+          partition_helper->num_total_nodes() - ops_to_replace.size());
     } else {
       absl::StrAppend(&error_message,
                       "No operations will run on the GPU, and all ",
-                      partition_helper.num_total_nodes());
+                      partition_helper->num_total_nodes());
     }
     absl::StrAppend(&error_message, " operations will run on the CPU.");
     TF_LITE_KERNEL_LOG(context, error_message.c_str());
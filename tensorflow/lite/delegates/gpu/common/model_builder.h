@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/core/model.h"
 #include "tensorflow/lite/delegates/gpu/common/model.h"
+#include "tensorflow/lite/delegates/gpu/common/partition_cost_model.h"
 #include "tensorflow/lite/delegates/gpu/common/shape.h"
 #include "tensorflow/lite/delegates/gpu/common/status.h"
 #include "tensorflow/lite/delegates/gpu/common/tensor.h"
@@ -39,12 +40,16 @@ namespace gpu {
 // consists of a subset of ops) to be replaced.
 // 'excluded_ops', if not null, specifies a set of ops that should not be
 // replaced with GPU kernels.
+// 'cost_model', if not null, is used to keep the partitions that are predicted
+// to run slower on the GPU than on the CPU, once the cost of moving their data
+// is included, on the CPU.
 TfLiteIntArray* GetOpsToReplace(
     TfLiteContext* context, bool allow_quant_ops = false,
     int max_delegated_partitions = 1,
     const absl::flat_hash_set<TfLiteBuiltinOperator>* excluded_ops = nullptr,
     int start_node_index = 0,
-    int end_node_index = std::numeric_limits<int>::max());
+    int end_node_index = std::numeric_limits<int>::max(),
+    const PartitionCostModel* cost_model = nullptr);
 
 // Extracts TFLite delegate execution plan from the input TFLite context and
 // converts it into generic graph format.
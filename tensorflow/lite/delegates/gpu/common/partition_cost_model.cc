@@ -0,0 +1,191 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/common/partition_cost_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/context_util.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/delegates/gpu/common/flops_util.h"
+#include "tensorflow/lite/delegates/gpu/common/model_builder_helper.h"
+#include "tensorflow/lite/delegates/gpu/common/shape.h"
+#include "tensorflow/lite/delegates/utils.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite {
+namespace gpu {
+namespace {
+
+const TfLiteTensor* GetTensor(const TfLiteContext* context,
+                              const TfLiteIntArray* indices, int i) {
+  if (indices == nullptr || i >= indices->size ||
+      indices->data[i] == kTfLiteOptionalTensor) {
+    return nullptr;
+  }
+  return &context->tensors[indices->data[i]];
+}
+
+uint64_t NumElements(const TfLiteTensor* tensor) {
+  if (tensor == nullptr || tensor->dims == nullptr) return 0;
+  uint64_t elements = 1;
+  for (int i = 0; i < tensor->dims->size; ++i) {
+    elements *= std::max(tensor->dims->data[i], 0);
+  }
+  return elements;
+}
+
+// Returns the shape of a tensor of up to 4 dimensions as BHWC, with missing
+// leading dimensions set to 1.
+BHWC GetBHWC(const TfLiteTensor& tensor) {
+  int dims[4] = {1, 1, 1, 1};
+  const int rank = std::min(tensor.dims->size, 4);
+  for (int i = 0; i < rank; ++i) {
+    dims[4 - rank + i] = tensor.dims->data[tensor.dims->size - rank + i];
+  }
+  return BHWC(dims[0], dims[1], dims[2], dims[3]);
+}
+
+double FlopsToUs(uint64_t flops, double gflops) {
+  return flops / (gflops * 1e3);
+}
+
+}  // namespace
+
+uint64_t EstimateNodeFlops(const TfLiteContext* context, const TfLiteNode& node,
+                           const TfLiteRegistration& registration) {
+  const TfLiteTensor* output = GetTensor(context, node.outputs, 0);
+  const TfLiteTensor* weights = GetTensor(context, node.inputs, 1);
+  if (output == nullptr || output->dims == nullptr) return 0;
+  const bool has_weights = weights != nullptr && weights->dims != nullptr;
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinConv2d:
+      if (has_weights && weights->dims->size == 4) {
+        const TfLiteIntArray& w = *weights->dims;
+        return GetConvolutionFlops(
+            GetBHWC(*output),
+            OHWI(w.data[0], w.data[1], w.data[2], w.data[3]));
+      }
+      break;
+    case kTfLiteBuiltinDepthwiseConv2d:
+      if (has_weights && weights->dims->size == 4) {
+        const TfLiteIntArray& w = *weights->dims;
+        return GetDepthwiseConvolutionFlops(
+            GetBHWC(*output),
+            OHWI(w.data[3], w.data[1], w.data[2], w.data[0]));
+      }
+      break;
+    case kTfLiteBuiltinFullyConnected:
+      if (has_weights && weights->dims->size == 2) {
+        const TfLiteIntArray& w = *weights->dims;
+        return GetFullyConnectedFlops(GetBHWC(*output),
+                                      OHWI(w.data[0], 1, 1, w.data[1]));
+      }
+      break;
+    case kTfLiteBuiltinTransposeConv: {
+      // Inputs are the output shape, the weights and the source tensor.
+      const TfLiteTensor* src = GetTensor(context, node.inputs, 2);
+      if (has_weights && weights->dims->size == 4 && src != nullptr &&
+          src->dims != nullptr) {
+        const TfLiteIntArray& w = *weights->dims;
+        return GetConvolutionTransposedFlops(
+            GetBHWC(*src), OHWI(w.data[0], w.data[1], w.data[2], w.data[3]));
+      }
+      break;
+    }
+    case kTfLiteBuiltinBatchMatmul: {
+      const TfLiteTensor* lhs = GetTensor(context, node.inputs, 0);
+      if (lhs != nullptr && lhs->dims != nullptr && lhs->dims->size > 0) {
+        // 2 flops per multiply-add over the reduced dimension. Transposed
+        // operands are ignored by this estimate.
+        return NumElements(output) * lhs->dims->data[lhs->dims->size - 1] * 2;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return NumElements(output);
+}
+
+PartitionCost EstimatePartitionCost(TfLiteContext* context,
+                                    const TfLiteDelegateParams& partition,
+                                    const PartitionCostModel& model) {
+  PartitionCost cost;
+  for (int node_id : TfLiteIntArrayView(partition.nodes_to_replace)) {
+    auto measured = model.measured_latencies.find(node_id);
+    if (measured != model.measured_latencies.end()) {
+      cost.cpu_us += measured->second.cpu_us;
+      cost.gpu_us += measured->second.gpu_us;
+      continue;
+    }
+    TfLiteNode* node;
+    TfLiteRegistration* registration;
+    if (!GetNodeAndRegistration(context, node_id, &node, &registration).ok()) {
+      continue;
+    }
+    const uint64_t flops = EstimateNodeFlops(context, *node, *registration);
+    cost.cpu_us += FlopsToUs(flops, model.cpu_gflops);
+    cost.gpu_us +=
+        FlopsToUs(flops, model.gpu_gflops) + model.gpu_op_overhead_us;
+  }
+
+  // Constant inputs are uploaded once at initialization, all other inputs and
+  // outputs cross the CPU<->GPU boundary on every inference.
+  uint64_t transfer_bytes = 0;
+  for (int tensor_id : TfLiteIntArrayView(partition.input_tensors)) {
+    const TfLiteTensor& tensor = context->tensors[tensor_id];
+    if (!IsConstantOrPersistentTensor(&tensor)) transfer_bytes += tensor.bytes;
+  }
+  for (int tensor_id : TfLiteIntArrayView(partition.output_tensors)) {
+    transfer_bytes += context->tensors[tensor_id].bytes;
+  }
+  cost.transfer_us = model.partition_overhead_us +
+                     transfer_bytes / (model.transfer_gb_per_s * 1e3);
+  return cost;
+}
+
+TfLiteStatus CostModelGraphPartitionHelper::PartitionImpl(
+    std::set<std::string>* unsupported_nodes_info, int start_node_index,
+    int end_node_index) {
+  TF_LITE_ENSURE_STATUS(FP16GraphPartitionHelper::PartitionImpl(
+      unsupported_nodes_info, start_node_index, end_node_index));
+  num_rejected_partitions_ = 0;
+  auto last = std::remove_if(
+      partitions_.begin(), partitions_.end(),
+      [this](const TfLiteDelegateParams* partition) {
+        const PartitionCost cost =
+            EstimatePartitionCost(context_, *partition, cost_model_);
+        if (cost.IsProfitable()) return false;
+        TFLITE_LOG_PROD(TFLITE_LOG_INFO,
+                        "Keeping a partition of %d nodes on the CPU: estimated "
+                        "%.1fus on the CPU, %.1fus on the GPU plus %.1fus of "
+                        "transfers.",
+                        partition->nodes_to_replace->size, cost.cpu_us,
+                        cost.gpu_us, cost.transfer_us);
+        ++num_rejected_partitions_;
+        return true;
+      });
+  partitions_.erase(last, partitions_.end());
+  return kTfLiteOk;
+}
+
+}  // namespace gpu
+}  // namespace tflite
@@ -0,0 +1,109 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_GPU_COMMON_PARTITION_COST_MODEL_H_
+#define TENSORFLOW_LITE_DELEGATES_GPU_COMMON_PARTITION_COST_MODEL_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/delegates/utils.h"
+
+namespace tflite {
+namespace gpu {
+
+// Latency model used to decide whether a partition of a TFLite graph is worth
+// delegating to the GPU. Every partition boundary costs a CPU<->GPU sync and a
+// copy of the partition inputs and outputs, so small partitions between CPU
+// ops often run slower on the GPU than on the CPU.
+//
+// Op latencies are estimated from their flops unless measured latencies are
+// provided, e.g. from per-op profiles of the model run with and without the
+// delegate.
+struct PartitionCostModel {
+  struct NodeLatency {
+    double cpu_us = 0.0;
+    double gpu_us = 0.0;
+  };
+
+  // Throughputs used to estimate op latencies from their flops.
+  double cpu_gflops = 10.0;
+  double gpu_gflops = 100.0;
+  // Fixed GPU cost of every delegated op, e.g. of its kernel launch.
+  double gpu_op_overhead_us = 20.0;
+  // Fixed cost of every partition, i.e. of the sync at its boundaries.
+  double partition_overhead_us = 300.0;
+  // Bandwidth of the copies of partition inputs and outputs.
+  double transfer_gb_per_s = 2.0;
+
+  // Measured latencies keyed by node index. They replace the estimates of the
+  // nodes they are given for.
+  absl::flat_hash_map<int, NodeLatency> measured_latencies;
+};
+
+struct PartitionCost {
+  double cpu_us = 0.0;
+  double gpu_us = 0.0;
+  double transfer_us = 0.0;
+
+  // Returns true if the GPU speedup of the partition exceeds the cost of
+  // moving its data.
+  bool IsProfitable() const { return cpu_us - gpu_us > transfer_us; }
+};
+
+// Estimates the number of flops of a node from the shapes of its tensors.
+// Ops other than convolutions and matrix multiplications are assumed to take
+// one flop per output element.
+uint64_t EstimateNodeFlops(const TfLiteContext* context, const TfLiteNode& node,
+                           const TfLiteRegistration& registration);
+
+// Estimates the cost of running `partition` on the CPU and on the GPU.
+PartitionCost EstimatePartitionCost(TfLiteContext* context,
+                                    const TfLiteDelegateParams& partition,
+                                    const PartitionCostModel& model);
+
+// Partitioner that drops the partitions which the cost model predicts to run
+// slower on the GPU than on the CPU. The remaining partitions are ranked by
+// size as usual, so 'max_delegated_partitions' still caps their number.
+// Graphs without unsupported nodes are still delegated entirely.
+class CostModelGraphPartitionHelper
+    : public delegates::FP16GraphPartitionHelper {
+ public:
+  // `cost_model` must outlive the helper.
+  CostModelGraphPartitionHelper(
+      TfLiteContext* context, delegates::IsNodeSupportedFn is_node_supported_fn,
+      const PartitionCostModel& cost_model)
+      : FP16GraphPartitionHelper(context, std::move(is_node_supported_fn)),
+        cost_model_(cost_model) {}
+
+  int num_rejected_partitions() const { return num_rejected_partitions_; }
+
+ protected:
+  TfLiteStatus PartitionImpl(std::set<std::string>* unsupported_nodes_info,
+                             int start_node_index, int end_node_index) override;
+
+ private:
+  const PartitionCostModel& cost_model_;
+  int num_rejected_partitions_ = 0;
+};
+
+}  // namespace gpu
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_GPU_COMMON_PARTITION_COST_MODEL_H_
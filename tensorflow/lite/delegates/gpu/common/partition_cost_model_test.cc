@@ -0,0 +1,110 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/common/partition_cost_model.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/array.h"
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+namespace gpu {
+namespace {
+
+class PartitionCostModelTest : public ::testing::Test {
+ protected:
+  ~PartitionCostModelTest() override {
+    for (TfLiteTensor& tensor : tensors_) TfLiteIntArrayFree(tensor.dims);
+  }
+
+  // Adds a float32 tensor and returns its index.
+  int AddTensor(const std::vector<int>& shape,
+                TfLiteAllocationType allocation_type = kTfLiteArenaRw) {
+    TfLiteTensor tensor = {};
+    tensor.type = kTfLiteFloat32;
+    tensor.dims = ConvertVectorToTfLiteIntArray(shape);
+    tensor.allocation_type = allocation_type;
+    tensor.bytes = sizeof(float);
+    for (int dim : shape) tensor.bytes *= dim;
+    tensors_.push_back(tensor);
+    context_.tensors = tensors_.data();
+    context_.tensors_size = tensors_.size();
+    return tensors_.size() - 1;
+  }
+
+  TfLiteContext context_ = {};
+  std::vector<TfLiteTensor> tensors_;
+};
+
+TEST_F(PartitionCostModelTest, EstimatesConvolutionFlops) {
+  tensors_.reserve(3);
+  const int src = AddTensor({1, 8, 8, 4});
+  const int weights = AddTensor({16, 3, 3, 4}, kTfLiteMmapRo);
+  const int dst = AddTensor({1, 8, 8, 16});
+  IntArrayUniquePtr inputs = BuildTfLiteArray({src, weights});
+  IntArrayUniquePtr outputs = BuildTfLiteArray({dst});
+  TfLiteNode node = {};
+  node.inputs = inputs.get();
+  node.outputs = outputs.get();
+  TfLiteRegistration registration = {};
+
+  registration.builtin_code = kTfLiteBuiltinConv2d;
+  EXPECT_EQ(EstimateNodeFlops(&context_, node, registration),
+            uint64_t{8 * 8 * 16 * 3 * 3 * 4 * 2});
+  // Other ops take a flop per output element.
+  registration.builtin_code = kTfLiteBuiltinAdd;
+  EXPECT_EQ(EstimateNodeFlops(&context_, node, registration),
+            uint64_t{8 * 8 * 16});
+}
+
+TEST_F(PartitionCostModelTest, ChargesTransfersOfNonConstantTensors) {
+  tensors_.reserve(3);
+  const int src = AddTensor({1, 256});
+  const int weights = AddTensor({256, 256}, kTfLiteMmapRo);
+  const int dst = AddTensor({1, 256});
+  IntArrayUniquePtr nodes = BuildTfLiteArray({0});
+  IntArrayUniquePtr inputs = BuildTfLiteArray({src, weights});
+  IntArrayUniquePtr outputs = BuildTfLiteArray({dst});
+  TfLiteDelegateParams partition = {};
+  partition.nodes_to_replace = nodes.get();
+  partition.input_tensors = inputs.get();
+  partition.output_tensors = outputs.get();
+
+  PartitionCostModel model;
+  model.partition_overhead_us = 10.0;
+  model.transfer_gb_per_s = 1.0;
+  model.measured_latencies[0] = {/*cpu_us=*/100.0, /*gpu_us=*/20.0};
+
+  PartitionCost cost = EstimatePartitionCost(&context_, partition, model);
+  EXPECT_DOUBLE_EQ(cost.cpu_us, 100.0);
+  EXPECT_DOUBLE_EQ(cost.gpu_us, 20.0);
+  // 1KB in and 1KB out at 1GB/s, and the weights stay on the GPU.
+  EXPECT_DOUBLE_EQ(cost.transfer_us, 10.0 + 2048 / 1e3);
+  EXPECT_TRUE(cost.IsProfitable());
+
+  // A sync that costs more than the speedup makes the partition unprofitable.
+  model.partition_overhead_us = 100.0;
+  cost = EstimatePartitionCost(&context_, partition, model);
+  EXPECT_FALSE(cost.IsProfitable());
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace tflite
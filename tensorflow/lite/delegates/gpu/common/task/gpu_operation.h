@@ -136,6 +136,7 @@ class GPUOperation {
   }
   void RecalculateGridSize() { grid_size_ = GetGridSize(); }
   void RecalculateWorkGroupsCount();
+  const int3& GetRecalculatedGridSize() const { return grid_size_; }
 
   Arguments args_;
   std::string code_;
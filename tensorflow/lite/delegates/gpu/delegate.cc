@@ -29,6 +29,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT(build/c++11)
@@ -56,6 +57,7 @@ limitations under the License.
 #include "tensorflow/lite/delegates/gpu/cl/util.h"
 #include "tensorflow/lite/delegates/gpu/common/model_builder.h"
 #include "tensorflow/lite/delegates/gpu/common/model_builder_helper.h"
+#include "tensorflow/lite/delegates/gpu/common/partition_cost_model.h"
 #include "tensorflow/lite/delegates/gpu/common/quantization_util.h"
 #include "tensorflow/lite/delegates/gpu/delegate_options.h"
 #include "tensorflow/lite/delegates/gpu/tflite_profile.h"
@@ -266,6 +268,12 @@ class Delegate {
   int MaxDelegatedPartitions() const {
     return options_.max_delegated_partitions;
   }
+  const PartitionCostModel* partition_cost_model() const {
+    return options_.experimental_flags &
+                   TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_PARTITION_COST_MODEL
+               ? &partition_cost_model_
+               : nullptr;
+  }
   int num_delegate_kernels() const { return num_delegate_kernels_; }
   TfLiteTelemetryGpuDelegateSettings* telemetry_settings() {
     return telemetry_settings_.get();
@@ -274,6 +282,8 @@ class Delegate {
  private:
   TfLiteDelegate delegate_;
   TfLiteGpuDelegateOptionsV2 options_;
+  // Default latency model, used if enabled in `options_`.
+  PartitionCostModel partition_cost_model_;
   std::atomic<int> num_delegate_kernels_ = 0;
 
   std::unique_ptr<Serialization> serialization_;
@@ -1542,15 +1552,19 @@ TfLiteStatus DelegatePrepare(TfLiteContext* context, TfLiteDelegate* delegate) {
     excluded_ops.insert(kTfLiteBuiltinSplitV);
   }
 #ifndef TFLITE_DEBUG_DELEGATE
-  TfLiteIntArray* ops_to_replace =
-      GetOpsToReplace(context, gpu_delegate->IsQuantOpsAllowed(),
-                      gpu_delegate->MaxDelegatedPartitions(), &excluded_ops);
+  TfLiteIntArray* ops_to_replace = GetOpsToReplace(
+      context, gpu_delegate->IsQuantOpsAllowed(),
+      gpu_delegate->MaxDelegatedPartitions(), &excluded_ops,
+      /*start_node_index=*/0,
+      /*end_node_index=*/std::numeric_limits<int>::max(),
+      gpu_delegate->partition_cost_model());
 #else
   TfLiteIntArray* ops_to_replace =
       GetOpsToReplace(context, gpu_delegate->IsQuantOpsAllowed(),
                       gpu_delegate->MaxDelegatedPartitions(), &excluded_ops,
                       gpu_delegate->options().first_delegate_node_index,
-                      gpu_delegate->options().last_delegate_node_index);
+                      gpu_delegate->options().last_delegate_node_index,
+                      gpu_delegate->partition_cost_model());
 #endif
   const auto status = context->ReplaceNodeSubsetsWithDelegateKernels(
       context, kRegistration, ops_to_replace, delegate);
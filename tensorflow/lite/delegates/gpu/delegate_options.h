@@ -71,6 +71,11 @@ enum TfLiteGpuExperimentalFlags {
   // TfLiteGpuDelegateOptionsV2.
   // Currently works only if CL backend is used.
   TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_SERIALIZATION = 1 << 3,
+  // Keeps partitions on the CPU when a latency model predicts that their GPU
+  // speedup does not pay for the CPU<->GPU sync and copies at their
+  // boundaries. Useful for graphs that mix supported and unsupported ops,
+  // together with a larger max_delegated_partitions.
+  TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_PARTITION_COST_MODEL = 1 << 4,
 };
 
 // IMPORTANT: Always use TfLiteGpuDelegateOptionsV2Default() method to create
@@ -0,0 +1,108 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/serialization_warmup.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/interpreter_builder.h"
+#include "tensorflow/lite/delegates/gpu/delegate.h"
+#include "tensorflow/lite/delegates/gpu/delegate_options.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+namespace gpu {
+
+absl::Status SerializationWarmup::Start(
+    const FlatBufferModel& model, const OpResolver& resolver,
+    const TfLiteGpuDelegateOptionsV2& options,
+    std::unique_ptr<SerializationWarmup>* warmup) {
+  if (!(options.experimental_flags &
+        TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_SERIALIZATION) ||
+      options.serialization_dir == nullptr || options.model_token == nullptr) {
+    return absl::InvalidArgumentError(
+        "Serialization warmup needs serialization enabled with a "
+        "serialization dir and a model token.");
+  }
+  if (options.experimental_flags & TFLITE_GPU_EXPERIMENTAL_FLAGS_GL_ONLY) {
+    return absl::InvalidArgumentError(
+        "Only the OpenCL backend supports serialization.");
+  }
+  warmup->reset(new SerializationWarmup(model, resolver, options));
+  SerializationWarmup* started = warmup->get();
+  started->thread_ = std::thread([started] {
+    const absl::Status status = started->Run();
+    absl::MutexLock lock(&started->mutex_);
+    started->status_ = status;
+    started->done_ = true;
+  });
+  return absl::OkStatus();
+}
+
+SerializationWarmup::SerializationWarmup(
+    const FlatBufferModel& model, const OpResolver& resolver,
+    const TfLiteGpuDelegateOptionsV2& options)
+    : model_(model),
+      resolver_(resolver),
+      options_(options),
+      serialization_dir_(options.serialization_dir),
+      model_token_(options.model_token) {
+  options_.serialization_dir = serialization_dir_.c_str();
+  options_.model_token = model_token_.c_str();
+}
+
+SerializationWarmup::~SerializationWarmup() {
+  if (thread_.joinable()) thread_.join();
+}
+
+bool SerializationWarmup::IsDone() const {
+  absl::MutexLock lock(&mutex_);
+  return done_;
+}
+
+absl::Status SerializationWarmup::Wait() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(&done_));
+  return status_;
+}
+
+absl::Status SerializationWarmup::Run() {
+  std::unique_ptr<Interpreter> interpreter;
+  if (InterpreterBuilder(model_, resolver_)(&interpreter) != kTfLiteOk) {
+    return absl::InternalError("Failed to build the interpreter.");
+  }
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteGpuDelegateV2Delete)>
+      delegate(TfLiteGpuDelegateV2Create(&options_),
+               TfLiteGpuDelegateV2Delete);
+  // The delegate kernels compile, tune and save the serialized inference
+  // context while the graph is being delegated.
+  const TfLiteStatus status =
+      interpreter->ModifyGraphWithDelegate(delegate.get());
+  // The interpreter must release the delegate kernels before the delegate.
+  interpreter.reset();
+  if (status != kTfLiteOk) {
+    return absl::InternalError("Failed to apply the GPU delegate.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace gpu
+}  // namespace tflite
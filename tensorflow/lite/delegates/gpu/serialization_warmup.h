@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_DELEGATES_GPU_SERIALIZATION_WARMUP_H_
+#define TENSORFLOW_LITE_DELEGATES_GPU_SERIALIZATION_WARMUP_H_
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/delegates/gpu/delegate_options.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+namespace gpu {
+
+// Builds the serialized OpenCL inference context of a model on a background
+// thread, e.g. after the app is installed or when it first becomes idle.
+//
+// The serialized context holds the compiled programs and the tuned work group
+// sizes of every delegated partition. A GPU delegate created later with the
+// same options, serialization dir and model token restores it instead of
+// compiling and tuning on the calling thread.
+//
+// Usage:
+//
+//   TfLiteGpuDelegateOptionsV2 options = TfLiteGpuDelegateOptionsV2Default();
+//   options.experimental_flags |=
+//       TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_SERIALIZATION;
+//   options.serialization_dir = cache_dir;
+//   options.model_token = model_token;
+//   std::unique_ptr<SerializationWarmup> warmup;
+//   RETURN_IF_ERROR(
+//       SerializationWarmup::Start(model, resolver, options, &warmup));
+//   ...
+//   // Before creating the delegate for inference:
+//   warmup->Wait().IgnoreError();
+class SerializationWarmup {
+ public:
+  // Starts warming up the serialization data of `model`. `options` must
+  // enable serialization. `model` and `resolver` must outlive the returned
+  // warmup.
+  static absl::Status Start(const FlatBufferModel& model,
+                            const OpResolver& resolver,
+                            const TfLiteGpuDelegateOptionsV2& options,
+                            std::unique_ptr<SerializationWarmup>* warmup);
+
+  // Waits for the background thread.
+  ~SerializationWarmup();
+
+  // Returns true once the serialization data is written or failed to build.
+  bool IsDone() const;
+
+  // Blocks until the warmup is done and returns its status.
+  absl::Status Wait();
+
+ private:
+  SerializationWarmup(const FlatBufferModel& model, const OpResolver& resolver,
+                      const TfLiteGpuDelegateOptionsV2& options);
+
+  // Applies the GPU delegate to a throwaway interpreter, which builds and
+  // saves the serialization data.
+  absl::Status Run();
+
+  const FlatBufferModel& model_;
+  const OpResolver& resolver_;
+  TfLiteGpuDelegateOptionsV2 options_;
+  // Owned copies of the strings `options_` points to.
+  std::string serialization_dir_;
+  std::string model_token_;
+
+  mutable absl::Mutex mutex_;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+  std::thread thread_;
+};
+
+}  // namespace gpu
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_DELEGATES_GPU_SERIALIZATION_WARMUP_H_
@@ -0,0 +1,74 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/delegates/gpu/serialization_warmup.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorflow/lite/delegates/gpu/delegate_options.h"
+#include "tensorflow/lite/kernels/register.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+namespace gpu {
+namespace {
+
+class SerializationWarmupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = FlatBufferModel::BuildFromFile("tensorflow/lite/testdata/add.bin");
+    ASSERT_NE(model_, nullptr);
+    options_ = TfLiteGpuDelegateOptionsV2Default();
+    options_.experimental_flags |=
+        TFLITE_GPU_EXPERIMENTAL_FLAGS_ENABLE_SERIALIZATION;
+    options_.serialization_dir = "/tmp";
+    options_.model_token = "add";
+  }
+
+  std::unique_ptr<FlatBufferModel> model_;
+  ops::builtin::BuiltinOpResolver resolver_;
+  TfLiteGpuDelegateOptionsV2 options_;
+};
+
+TEST_F(SerializationWarmupTest, RequiresSerialization) {
+  std::unique_ptr<SerializationWarmup> warmup;
+  options_.experimental_flags = TFLITE_GPU_EXPERIMENTAL_FLAGS_NONE;
+  EXPECT_EQ(
+      SerializationWarmup::Start(*model_, resolver_, options_, &warmup).code(),
+      absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(warmup, nullptr);
+}
+
+TEST_F(SerializationWarmupTest, RequiresModelToken) {
+  std::unique_ptr<SerializationWarmup> warmup;
+  options_.model_token = nullptr;
+  EXPECT_EQ(
+      SerializationWarmup::Start(*model_, resolver_, options_, &warmup).code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(SerializationWarmupTest, RejectsOpenGlOnly) {
+  std::unique_ptr<SerializationWarmup> warmup;
+  options_.experimental_flags |= TFLITE_GPU_EXPERIMENTAL_FLAGS_GL_ONLY;
+  EXPECT_EQ(
+      SerializationWarmup::Start(*model_, resolver_, options_, &warmup).code(),
+      absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace tflite
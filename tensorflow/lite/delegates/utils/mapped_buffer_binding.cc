@@ -0,0 +1,246 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/utils/mapped_buffer_binding.h"
+
+#if defined(__linux__)
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/delegates/gpu/android_hardware_buffer.h"
+#include "tensorflow/lite/delegates/utils/ret_macros.h"
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite::delegates::utils {
+namespace {
+
+using ::tflite::gpu::OptionalAndroidHardwareBuffer;
+
+// Values of the NDK constants, which are not declared on other platforms.
+constexpr uint64_t kUsageCpuReadOften = 3ULL;
+constexpr uint64_t kUsageCpuWriteOften = 3ULL << 4;
+constexpr uint32_t kFormatR8G8B8A8Unorm = 1;
+constexpr uint32_t kFormatR8G8B8X8Unorm = 2;
+constexpr uint32_t kFormatBlob = 0x21;
+
+class AHardwareBufferMapping : public CpuMappableBuffer {
+ public:
+  AHardwareBufferMapping(AHardwareBuffer* buffer, size_t size)
+      : buffer_(buffer), size_(size) {
+    OptionalAndroidHardwareBuffer::Instance().Acquire(buffer_);
+  }
+
+  ~AHardwareBufferMapping() override {
+    if (locked_) Unlock();
+    OptionalAndroidHardwareBuffer::Instance().Release(buffer_);
+  }
+
+  size_t size() const override { return size_; }
+
+  TfLiteStatus Lock(bool write, void** data) override {
+    TFLITE_RET_CHECK_STATUS(!locked_, "Buffer is already locked");
+    const uint64_t usage =
+        kUsageCpuReadOften | (write ? kUsageCpuWriteOften : 0);
+    TFLITE_RET_CHECK_STATUS(
+        OptionalAndroidHardwareBuffer::Instance().Lock(
+            buffer_, usage, /*fence=*/-1, /*rect=*/nullptr, data) == 0,
+        "AHardwareBuffer_lock failed");
+    locked_ = true;
+    return kTfLiteOk;
+  }
+
+  TfLiteStatus Unlock() override {
+    TFLITE_RET_CHECK_STATUS(locked_, "Buffer is not locked");
+    locked_ = false;
+    TFLITE_RET_CHECK_STATUS(OptionalAndroidHardwareBuffer::Instance().Unlock(
+                                buffer_, /*fence=*/nullptr) == 0,
+                            "AHardwareBuffer_unlock failed");
+    return kTfLiteOk;
+  }
+
+ private:
+  AHardwareBuffer* buffer_;
+  size_t size_;
+  bool locked_ = false;
+};
+
+#if defined(__linux__)
+class DmaBufMapping : public CpuMappableBuffer {
+ public:
+  DmaBufMapping(int fd, void* data, size_t size)
+      : fd_(fd), data_(data), size_(size) {}
+
+  ~DmaBufMapping() override {
+    if (sync_flags_ != 0) Unlock();
+    munmap(data_, size_);
+  }
+
+  size_t size() const override { return size_; }
+
+  TfLiteStatus Lock(bool write, void** data) override {
+    TFLITE_RET_CHECK_STATUS(sync_flags_ == 0, "Buffer is already locked");
+    const uint64_t flags = write ? DMA_BUF_SYNC_RW : DMA_BUF_SYNC_READ;
+    TF_LITE_ENSURE_STATUS(Sync(DMA_BUF_SYNC_START | flags));
+    sync_flags_ = flags;
+    *data = data_;
+    return kTfLiteOk;
+  }
+
+  TfLiteStatus Unlock() override {
+    TFLITE_RET_CHECK_STATUS(sync_flags_ != 0, "Buffer is not locked");
+    const uint64_t flags = sync_flags_;
+    sync_flags_ = 0;
+    return Sync(DMA_BUF_SYNC_END | flags);
+  }
+
+ private:
+  TfLiteStatus Sync(uint64_t flags) {
+    struct dma_buf_sync sync = {flags};
+    int ret;
+    do {
+      ret = ioctl(fd_, DMA_BUF_IOCTL_SYNC, &sync);
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+    TFLITE_RET_CHECK_STATUS(ret == 0, "DMA_BUF_IOCTL_SYNC failed");
+    return kTfLiteOk;
+  }
+
+  int fd_;
+  void* data_;
+  size_t size_;
+  // Access flags of the current lock, or 0 if the buffer is not locked.
+  uint64_t sync_flags_ = 0;
+};
+#endif  // defined(__linux__)
+
+}  // namespace
+
+std::unique_ptr<CpuMappableBuffer> CreateAHardwareBufferMapping(
+    AHardwareBuffer* buffer) {
+  auto& ahwb = OptionalAndroidHardwareBuffer::Instance();
+  if (buffer == nullptr || !ahwb.Supported()) return nullptr;
+  AHardwareBuffer_Desc desc;
+  ahwb.Describe(buffer, &desc);
+  size_t size;
+  if (desc.format == kFormatBlob) {
+    size = desc.width;
+  } else if ((desc.format == kFormatR8G8B8A8Unorm ||
+              desc.format == kFormatR8G8B8X8Unorm) &&
+             desc.stride == desc.width) {
+    // Padded rows would not match the layout of a tensor.
+    size = static_cast<size_t>(desc.width) * desc.height * desc.layers * 4;
+  } else {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR,
+                    "Unsupported AHardwareBuffer format %u with stride %u",
+                    desc.format, desc.stride);
+    return nullptr;
+  }
+  return std::make_unique<AHardwareBufferMapping>(buffer, size);
+}
+
+std::unique_ptr<CpuMappableBuffer> CreateDmaBufMapping(int fd, size_t size) {
+#if defined(__linux__)
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "Failed to map dma-buf %d", fd);
+    return nullptr;
+  }
+  return std::make_unique<DmaBufMapping>(fd, data, size);
+#else
+  TFLITE_LOG_PROD(TFLITE_LOG_ERROR, "dma-buf is only supported on Linux");
+  return nullptr;
+#endif
+}
+
+TfLiteStatus MappedBufferBinding::Bind(
+    int tensor_index, std::unique_ptr<CpuMappableBuffer> buffer) {
+  TFLITE_RET_CHECK_STATUS(buffer != nullptr, "Buffer is null");
+  TFLITE_RET_CHECK_STATUS(
+      tensor_index >= 0 &&
+          static_cast<size_t>(tensor_index) < interpreter_->tensors_size(),
+      "Invalid tensor index");
+  const TfLiteTensor* tensor = interpreter_->tensor(tensor_index);
+  TFLITE_RET_CHECK_STATUS(tensor->allocation_type == kTfLiteArenaRw ||
+                              tensor->allocation_type ==
+                                  kTfLiteArenaRwPersistent ||
+                              tensor->allocation_type == kTfLiteCustom,
+                          "Tensor can not use a custom allocation");
+  const auto& inputs = interpreter_->inputs();
+  const bool write =
+      std::find(inputs.begin(), inputs.end(), tensor_index) == inputs.end();
+  auto it = std::find_if(bindings_.begin(), bindings_.end(),
+                         [tensor_index](const Binding& binding) {
+                           return binding.tensor_index == tensor_index;
+                         });
+  if (it != bindings_.end()) {
+    it->write = write;
+    it->buffer = std::move(buffer);
+  } else {
+    bindings_.push_back({tensor_index, write, std::move(buffer)});
+  }
+  needs_allocation_ = true;
+  return kTfLiteOk;
+}
+
+TfLiteStatus MappedBufferBinding::Invoke() {
+  TF_LITE_ENSURE_STATUS(LockAll());
+  TfLiteStatus status = kTfLiteOk;
+  if (needs_allocation_) {
+    status = interpreter_->AllocateTensors();
+    if (status == kTfLiteOk) needs_allocation_ = false;
+  }
+  if (status == kTfLiteOk) status = interpreter_->Invoke();
+  const TfLiteStatus unlock_status = UnlockFirst(bindings_.size());
+  return status == kTfLiteOk ? unlock_status : status;
+}
+
+TfLiteStatus MappedBufferBinding::LockAll() {
+  for (size_t i = 0; i < bindings_.size(); ++i) {
+    Binding& binding = bindings_[i];
+    void* data = nullptr;
+    if (binding.buffer->Lock(binding.write, &data) != kTfLiteOk) {
+      UnlockFirst(i);
+      return kTfLiteDelegateError;
+    }
+    const TfLiteCustomAllocation allocation = {data, binding.buffer->size()};
+    if (interpreter_->SetCustomAllocationForTensor(binding.tensor_index,
+                                                   allocation) != kTfLiteOk) {
+      UnlockFirst(i + 1);
+      return kTfLiteError;
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus MappedBufferBinding::UnlockFirst(size_t count) {
+  TfLiteStatus status = kTfLiteOk;
+  for (size_t i = 0; i < count; ++i) {
+    if (bindings_[i].buffer->Unlock() != kTfLiteOk) {
+      status = kTfLiteDelegateError;
+    }
+  }
+  return status;
+}
+
+}  // namespace tflite::delegates::utils
@@ -0,0 +1,111 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_DELEGATES_UTILS_MAPPED_BUFFER_BINDING_H_
+#define TENSORFLOW_LITE_DELEGATES_UTILS_MAPPED_BUFFER_BINDING_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/delegates/gpu/android_hardware_buffer.h"
+
+namespace tflite::delegates::utils {
+
+// A buffer shared with other devices, e.g. a camera, that the CPU may only
+// access while it is locked.
+class CpuMappableBuffer {
+ public:
+  virtual ~CpuMappableBuffer() = default;
+
+  // Size of the buffer in bytes.
+  virtual size_t size() const = 0;
+
+  // Maps the buffer for CPU reads, and also for CPU writes if `write` is true.
+  // Waits for pending device accesses to finish. On success, `data` points to
+  // the buffer until Unlock is called.
+  virtual TfLiteStatus Lock(bool write, void** data) = 0;
+
+  // Makes the CPU accesses since Lock visible to the other devices.
+  virtual TfLiteStatus Unlock() = 0;
+};
+
+// Returns a mapping of an AHardwareBuffer, or nullptr if the buffer can not be
+// mapped. Supports BLOB buffers and unpadded RGBA/RGBX 8888 buffers. The
+// buffer is acquired for the lifetime of the mapping.
+std::unique_ptr<CpuMappableBuffer> CreateAHardwareBufferMapping(
+    AHardwareBuffer* buffer);
+
+// Returns a mapping of `size` bytes of a dma-buf, or nullptr if the buffer
+// can not be mapped. The dma-buf is mapped for the lifetime of the mapping and
+// CPU accesses are bracketed with DMA_BUF_IOCTL_SYNC. `fd` is not owned.
+std::unique_ptr<CpuMappableBuffer> CreateDmaBufMapping(int fd, size_t size);
+
+// Binds mappable buffers to the tensors of an interpreter as custom
+// allocations, so that CPU kernels and the XNNPACK delegate read inputs and
+// write outputs in place instead of copying them from and to the buffers.
+//
+// Bound buffers stay locked only while Invoke runs. Mappings whose address is
+// the same on every lock, like dma-buf mappings, also let XNNPACK skip setting
+// up its runtime again.
+//
+// Usage:
+//
+//   MappedBufferBinding binding(interpreter.get());
+//   binding.Bind(interpreter->inputs()[0],
+//                CreateAHardwareBufferMapping(camera_buffer));
+//   // For every frame, once the producer has released the buffer:
+//   binding.Invoke();
+class MappedBufferBinding {
+ public:
+  // `interpreter` must outlive the binding. Bound tensors keep pointing at
+  // the buffers, so the interpreter must not be invoked once the binding is
+  // destroyed.
+  explicit MappedBufferBinding(Interpreter* interpreter)
+      : interpreter_(interpreter) {}
+
+  // Binds `buffer` to the tensor at `tensor_index` of the primary subgraph,
+  // replacing any buffer bound before. The tensor must be an arena tensor,
+  // e.g. an input or output. Inputs are mapped read-only.
+  TfLiteStatus Bind(int tensor_index,
+                    std::unique_ptr<CpuMappableBuffer> buffer);
+
+  // Locks the bound buffers, runs the interpreter and unlocks the buffers.
+  // Tensors are allocated again first if a buffer was bound since the last
+  // call. Bound outputs must be read through their buffers afterwards, not
+  // through the interpreter.
+  TfLiteStatus Invoke();
+
+ private:
+  struct Binding {
+    int tensor_index;
+    bool write;
+    std::unique_ptr<CpuMappableBuffer> buffer;
+  };
+
+  // Locks all bound buffers and points their tensors at the mappings.
+  TfLiteStatus LockAll();
+  // Unlocks the first `count` bound buffers.
+  TfLiteStatus UnlockFirst(size_t count);
+
+  Interpreter* interpreter_;
+  std::vector<Binding> bindings_;
+  bool needs_allocation_ = false;
+};
+
+}  // namespace tflite::delegates::utils
+
+#endif  // TENSORFLOW_LITE_DELEGATES_UTILS_MAPPED_BUFFER_BINDING_H_
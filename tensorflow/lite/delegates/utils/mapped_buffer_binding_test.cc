@@ -0,0 +1,135 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/delegates/utils/mapped_buffer_binding.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite::delegates::utils {
+namespace {
+
+// Heap memory that records how it is locked.
+class FakeBuffer : public CpuMappableBuffer {
+ public:
+  explicit FakeBuffer(size_t size)
+      : data_(static_cast<float*>(std::aligned_alloc(
+            kDefaultTensorAlignment,
+            (size + kDefaultTensorAlignment - 1) / kDefaultTensorAlignment *
+                kDefaultTensorAlignment))),
+        size_(size) {}
+  ~FakeBuffer() override { std::free(data_); }
+
+  size_t size() const override { return size_; }
+
+  TfLiteStatus Lock(bool write, void** data) override {
+    if (locked_) return kTfLiteError;
+    locked_ = true;
+    locked_for_write_ = write;
+    ++num_locks_;
+    *data = data_;
+    return kTfLiteOk;
+  }
+
+  TfLiteStatus Unlock() override {
+    if (!locked_) return kTfLiteError;
+    locked_ = false;
+    return kTfLiteOk;
+  }
+
+  float* data() { return data_; }
+  bool locked() const { return locked_; }
+  bool locked_for_write() const { return locked_for_write_; }
+  int num_locks() const { return num_locks_; }
+
+ private:
+  float* data_;
+  size_t size_;
+  bool locked_ = false;
+  bool locked_for_write_ = false;
+  int num_locks_ = 0;
+};
+
+class MappedBufferBindingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Adds the input to itself.
+    interpreter_.AddTensors(2);
+    interpreter_.SetInputs({0});
+    interpreter_.SetOutputs({1});
+    TfLiteQuantizationParams quant;
+    interpreter_.SetTensorParametersReadWrite(0, kTfLiteFloat32, "", {16},
+                                              quant);
+    interpreter_.SetTensorParametersReadWrite(1, kTfLiteFloat32, "", {16},
+                                              quant);
+    auto* params =
+        reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+    params->activation = kTfLiteActNone;
+    interpreter_.AddNodeWithParameters({0, 0}, {1}, nullptr, 0, params,
+                                       ops::builtin::Register_ADD());
+    ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  }
+
+  Interpreter interpreter_;
+};
+
+TEST_F(MappedBufferBindingTest, InvokesInPlace) {
+  auto input = std::make_unique<FakeBuffer>(16 * sizeof(float));
+  auto output = std::make_unique<FakeBuffer>(16 * sizeof(float));
+  FakeBuffer* input_ptr = input.get();
+  FakeBuffer* output_ptr = output.get();
+  MappedBufferBinding binding(&interpreter_);
+  ASSERT_EQ(binding.Bind(0, std::move(input)), kTfLiteOk);
+  ASSERT_EQ(binding.Bind(1, std::move(output)), kTfLiteOk);
+
+  for (int frame = 0; frame < 2; ++frame) {
+    for (int i = 0; i < 16; ++i) input_ptr->data()[i] = i + frame;
+    ASSERT_EQ(binding.Invoke(), kTfLiteOk);
+    for (int i = 0; i < 16; ++i) {
+      EXPECT_EQ(output_ptr->data()[i], 2.0f * (i + frame));
+    }
+  }
+  EXPECT_EQ(input_ptr->num_locks(), 2);
+  EXPECT_FALSE(input_ptr->locked());
+  EXPECT_FALSE(input_ptr->locked_for_write());
+  EXPECT_FALSE(output_ptr->locked());
+  EXPECT_TRUE(output_ptr->locked_for_write());
+}
+
+TEST_F(MappedBufferBindingTest, RejectsTooSmallBuffers) {
+  MappedBufferBinding binding(&interpreter_);
+  auto input = std::make_unique<FakeBuffer>(8 * sizeof(float));
+  FakeBuffer* input_ptr = input.get();
+  ASSERT_EQ(binding.Bind(0, std::move(input)), kTfLiteOk);
+  EXPECT_NE(binding.Invoke(), kTfLiteOk);
+  EXPECT_FALSE(input_ptr->locked());
+}
+
+TEST_F(MappedBufferBindingTest, RejectsInvalidBindings) {
+  MappedBufferBinding binding(&interpreter_);
+  EXPECT_NE(binding.Bind(0, nullptr), kTfLiteOk);
+  EXPECT_NE(binding.Bind(2, std::make_unique<FakeBuffer>(64)), kTfLiteOk);
+}
+
+}  // namespace
+}  // namespace tflite::delegates::utils
@@ -0,0 +1,95 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdlib>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+
+namespace tflite {
+namespace xnnpack {
+namespace {
+
+class ShapeBucketsTest : public testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    interpreter_ = std::make_unique<Interpreter>();
+    interpreter_->AddTensors(2);
+    interpreter_->SetInputs({0});
+    interpreter_->SetOutputs({1});
+    TfLiteQuantizationParams quant;
+    interpreter_->SetTensorParametersReadWrite(0, kTfLiteFloat32, "", {1, 4},
+                                               quant);
+    interpreter_->SetTensorParametersReadWrite(1, kTfLiteFloat32, "", {1, 4},
+                                               quant);
+    auto* params =
+        static_cast<TfLiteAddParams*>(calloc(1, sizeof(TfLiteAddParams)));
+    interpreter_->AddNodeWithParameters({0, 0}, {1}, nullptr, 0, params,
+                                        ops::builtin::Register_ADD());
+
+    TfLiteXNNPackDelegateOptions options =
+        TfLiteXNNPackDelegateOptionsDefault();
+    options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING;
+    options.runtime_shape_bucket_count = GetParam();
+    delegate_.reset(TfLiteXNNPackDelegateCreate(&options));
+    ASSERT_EQ(interpreter_->ModifyGraphWithDelegate(delegate_.get()),
+              kTfLiteOk);
+  }
+
+  // Resizes the input to `[1, size]`, runs the model and checks the output.
+  void InvokeWithSize(int size) {
+    ASSERT_EQ(interpreter_->ResizeInputTensor(0, {1, size}), kTfLiteOk);
+    ASSERT_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+    float* input = interpreter_->typed_input_tensor<float>(0);
+    for (int i = 0; i < size; ++i) {
+      input[i] = i;
+    }
+    ASSERT_EQ(interpreter_->Invoke(), kTfLiteOk);
+    const TfLiteTensor* output = interpreter_->output_tensor(0);
+    ASSERT_EQ(output->dims->size, 2);
+    ASSERT_EQ(output->dims->data[1], size);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(interpreter_->typed_output_tensor<float>(0)[i], 2.0f * i);
+    }
+  }
+
+  std::unique_ptr<TfLiteDelegate, decltype(&TfLiteXNNPackDelegateDelete)>
+      delegate_{nullptr, &TfLiteXNNPackDelegateDelete};
+  std::unique_ptr<Interpreter> interpreter_;
+};
+
+TEST_P(ShapeBucketsTest, AlternatingShapes) {
+  InvokeWithSize(4);
+  InvokeWithSize(8);
+  InvokeWithSize(4);
+  InvokeWithSize(8);
+  // Evicts a bucket when there are only two of them.
+  InvokeWithSize(16);
+  InvokeWithSize(4);
+  InvokeWithSize(16);
+}
+
+INSTANTIATE_TEST_SUITE_P(BucketCounts, ShapeBucketsTest,
+                         testing::Values(0, 1, 2, 3));
+
+}  // namespace
+}  // namespace xnnpack
+}  // namespace tflite
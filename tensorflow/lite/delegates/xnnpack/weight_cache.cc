@@ -26,6 +26,7 @@ limitations under the License.
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>  // IWYU pragma: keep
 #include <cstddef>
 #include <cstdint>
@@ -36,6 +37,7 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "xnnpack.h"  // from @XNNPACK
 #include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
@@ -68,6 +70,13 @@ namespace tflite::xnnpack {
 namespace {
 constexpr size_t kMinAlignment = 128;
 
+// Number of bytes at the start and at the end of each constant buffer that are
+// hashed in the model fingerprint.
+constexpr size_t kFingerprintSampleSize = 64;
+
+// Size of the chunks used to copy a published cache file.
+constexpr size_t kCopyChunkSize = 1 << 20;
+
 // Checks if the given path is a special value to use an in-memory cache.
 bool IsInMemoryCachePath(const char* path) {
   // Use strncmp to check for the prefix.
@@ -127,6 +136,54 @@ bool FileExists(const char* path) {
   return access(path, F_OK) != -1;
 }
 
+// Hashes `size` bytes into `hash` using FNV-1a.
+//
+// The result is saved in cache files and must not depend on the process or
+// the standard library implementation.
+uint64_t HashBytes(uint64_t hash, const void* data, const size_t size) {
+  const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+template <class T>
+uint64_t HashValue(const uint64_t hash, const T value) {
+  return HashBytes(hash, &value, sizeof(value));
+}
+
+// Computes a fingerprint of the constant tensors of a model.
+//
+// Only the start and the end of the tensor data are hashed: this is enough to
+// tell models apart without reading all of their weights.
+uint64_t ComputeModelFingerprint(
+    const TfLiteTensor* tensors,
+    const std::unordered_map<size_t, size_t>& tensor_index_to_identifier) {
+  std::vector<std::pair<size_t, size_t>> sorted_identifiers(
+      tensor_index_to_identifier.begin(), tensor_index_to_identifier.end());
+  std::sort(sorted_identifiers.begin(), sorted_identifiers.end());
+
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const auto [index, identifier] : sorted_identifiers) {
+    const TfLiteTensor& tensor = tensors[index];
+    hash = HashValue(hash, static_cast<uint64_t>(index));
+    hash = HashValue(hash, static_cast<uint64_t>(identifier));
+    hash = HashValue(hash, static_cast<uint64_t>(tensor.bytes));
+    hash = HashValue(hash, static_cast<int32_t>(tensor.type));
+    if (tensor.data.raw_const) {
+      const size_t sample_size =
+          std::min<size_t>(tensor.bytes, kFingerprintSampleSize);
+      hash = HashBytes(hash, tensor.data.raw_const, sample_size);
+      hash = HashBytes(hash,
+                       tensor.data.raw_const + tensor.bytes - sample_size,
+                       sample_size);
+    }
+  }
+  return hash;
+}
+
 }  // namespace
 
 void swap(MMapHandle& a, MMapHandle& b) {
@@ -227,10 +284,20 @@ WeightCacheBuilder::WeightCacheBuilder(WeightCacheBuilder&& other)
       XNN_MOVE_CONSTRUCT_MEMBER(build_segment_start_),
       XNN_MOVE_CONSTRUCT_MEMBER(first_write_done_),
       XNN_MOVE_CONSTRUCT_MEMBER(fd_),
-      XNN_MOVE_CONSTRUCT_MEMBER(file_path_) {}
+      XNN_MOVE_CONSTRUCT_MEMBER(file_path_),
+      XNN_MOVE_CONSTRUCT_MEMBER(temporary_file_path_),
+      XNN_MOVE_CONSTRUCT_MEMBER(published_),
+      XNN_MOVE_CONSTRUCT_MEMBER(last_build_step_copied_file_),
+      XNN_MOVE_CONSTRUCT_MEMBER(model_fingerprint_) {
+  other.temporary_file_path_.clear();
+}
 #undef XNN_MOVE_CONSTRUCT_MEMBER
 
 WeightCacheBuilder& WeightCacheBuilder::operator=(WeightCacheBuilder&& other) {
+  if (this == &other) {
+    return *this;
+  }
+  RemoveTemporaryFile();
 #define XNN_MOVE_MEMBER(x) x = std::move(other.x)
   XNN_MOVE_MEMBER(data_);
   XNN_MOVE_MEMBER(schema_);
@@ -240,22 +307,29 @@ WeightCacheBuilder& WeightCacheBuilder::operator=(WeightCacheBuilder&& other) {
   XNN_MOVE_MEMBER(first_write_done_);
   XNN_MOVE_MEMBER(fd_);
   XNN_MOVE_MEMBER(file_path_);
+  XNN_MOVE_MEMBER(temporary_file_path_);
+  XNN_MOVE_MEMBER(published_);
+  XNN_MOVE_MEMBER(last_build_step_copied_file_);
+  XNN_MOVE_MEMBER(model_fingerprint_);
 #undef XNN_MOVE_MEMBER
+  other.temporary_file_path_.clear();
   return *this;
 }
 
+WeightCacheBuilder::~WeightCacheBuilder() { RemoveTemporaryFile(); }
+
 bool WeightCacheBuilder::Start(const char* path) {
   XNNPACK_RETURN_CHECK(!IsStarted());
+  XNNPACK_RETURN_CHECK(path && *path, "no cache file path was provided.");
   file_path_ = path;
 
   if (IsInMemoryCachePath(file_path_)) {
     fd_ = CreateInMemoryFileDescriptor("XNNPack in-memory weight cache");
+    XNNPACK_RETURN_CHECK(fd_.IsValid(), "could not open file ('%s'): %s.",
+                         file_path_.c_str(), strerror(errno));
   } else {
-    fd_ = FileDescriptor::Open(file_path_.c_str(), O_CREAT | O_TRUNC | O_RDWR,
-                               0644);
+    XNNPACK_RETURN_CHECK(OpenTemporaryFile());
   }
-  XNNPACK_RETURN_CHECK(fd_.IsValid(), "could not open file ('%s'): %s.",
-                       file_path_.c_str(), strerror(errno));
 
   // Write data in the header, this will be overwritten in the `Finalize` call.
   // We explicitly set the header as invalid. If any error happens during
@@ -288,6 +362,7 @@ bool WeightCacheBuilder::StartBuildStep() {
 
   // Move cursor to end of existing data.
   build_segment_size_ = 0;
+  last_build_step_copied_file_ = false;
   build_segment_start_ = fd_.SetPos(header.buffer_list_offset);
   XNNPACK_RETURN_CHECK(build_segment_start_ != -1);
 
@@ -313,6 +388,11 @@ BufferLocation WeightCacheBuilder::Append(PackIdentifier pack_id,
                                           const void* data, uint64_t size) {
   XNNPACK_ABORT_CHECK(is_build_step_,
                       "cannot append data to an unstarted builder.");
+  // Other processes may have mapped the published file. Its content must not
+  // change under them.
+  if (published_ && !CopyPublishedFile()) {
+    return BufferLocation::Invalid();
+  }
   // Add some padding so that the cache file can be mmaped and the buffer
   // stays aligned correctly.
   const size_t offset = Align(fd_.GetPos(), kMinAlignment);
@@ -372,6 +452,7 @@ bool WeightCacheBuilder::StopBuildStep() {
          xnn_experimental_get_build_identifier_size());
   header.buffer_list_offset = fd_.GetPos();
   header.buffer_list_size = builder.GetSize();
+  header.model_fingerprint = model_fingerprint_;
 
   // Write the flatbuffer which serves as a header to index the buffer data.
   XNNPACK_RETURN_CHECK(fd_.Write(builder.GetBufferPointer(), builder.GetSize()),
@@ -387,12 +468,86 @@ bool WeightCacheBuilder::StopBuildStep() {
   XNNPACK_RETURN_CHECK(fd_.Write(&header, sizeof(header)),
                        "cannot write cache header to %s.", file_path_.c_str());
 
+  XNNPACK_RETURN_CHECK(Publish());
+
   TFLITE_LOG_PROD(tflite::TFLITE_LOG_VERBOSE,
                   "XNNPack weight cache: written to '%s'.", file_path_.c_str());
   first_write_done_ = true;
   return true;
 }
 
+bool WeightCacheBuilder::OpenTemporaryFile() {
+#if defined(_MSC_VER)
+  // A file cannot be replaced while it is opened by another process on
+  // Windows. The cache is written in place.
+  fd_ = FileDescriptor::Open(file_path_.c_str(), O_CREAT | O_TRUNC | O_RDWR,
+                             0644);
+  XNNPACK_RETURN_CHECK(fd_.IsValid(), "could not open file ('%s'): %s.",
+                       file_path_.c_str(), strerror(errno));
+#else
+  // Each builder gets its own file: several processes, or several delegates in
+  // one process, may be building the same cache concurrently.
+  static std::atomic<uint64_t> temporary_file_count{0};
+  std::string path = file_path_ + ".tmp." + std::to_string(getpid()) + "." +
+                     std::to_string(temporary_file_count++);
+  FileDescriptor fd =
+      FileDescriptor::Open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+  XNNPACK_RETURN_CHECK(fd.IsValid(), "could not open file ('%s'): %s.",
+                       path.c_str(), strerror(errno));
+  RemoveTemporaryFile();
+  temporary_file_path_ = std::move(path);
+  fd_ = std::move(fd);
+#endif
+  published_ = false;
+  return true;
+}
+
+bool WeightCacheBuilder::CopyPublishedFile() {
+  const FileDescriptor published_fd = std::move(fd_);
+  XNNPACK_RETURN_CHECK(OpenTemporaryFile());
+  XNNPACK_RETURN_CHECK(published_fd.SetPos(0) != -1,
+                       "could not move in the file: %s", strerror(errno));
+
+  // Only the data up to the current build step is kept, the step overwrites
+  // the buffer list that follows it.
+  std::vector<uint8_t> buffer(
+      std::min<size_t>(build_segment_start_, kCopyChunkSize));
+  for (size_t copied = 0; copied < build_segment_start_;) {
+    const size_t chunk_size =
+        std::min(buffer.size(), build_segment_start_ - copied);
+    XNNPACK_RETURN_CHECK(published_fd.Read(buffer.data(), chunk_size) &&
+                             fd_.Write(buffer.data(), chunk_size),
+                         "could not copy '%s' to '%s': %s.",
+                         file_path_.c_str(), temporary_file_path_.c_str(),
+                         strerror(errno));
+    copied += chunk_size;
+  }
+  last_build_step_copied_file_ = true;
+  return true;
+}
+
+bool WeightCacheBuilder::Publish() {
+  if (temporary_file_path_.empty()) {
+    return true;
+  }
+  // The rename is atomic: processes opening the cache file either get the
+  // previous complete file or this one.
+  XNNPACK_RETURN_CHECK(
+      rename(temporary_file_path_.c_str(), file_path_.c_str()) == 0,
+      "could not move '%s' to '%s': %s.", temporary_file_path_.c_str(),
+      file_path_.c_str(), strerror(errno));
+  temporary_file_path_.clear();
+  published_ = true;
+  return true;
+}
+
+void WeightCacheBuilder::RemoveTemporaryFile() {
+  if (!temporary_file_path_.empty()) {
+    std::remove(temporary_file_path_.c_str());
+    temporary_file_path_.clear();
+  }
+}
+
 MMapWeightCacheProvider::MMapWeightCacheProvider(
     MMapWeightCacheProvider&& other) {
   *this = std::move(other);
@@ -411,6 +566,9 @@ MMapWeightCacheProvider& MMapWeightCacheProvider::operator=(
   swap(mmap_handles_, other.mmap_handles_);
   swap(mmap_buffer_base_offset_, other.mmap_buffer_base_offset_);
   swap(builder_, other.builder_);
+  swap(model_fingerprint_, other.model_fingerprint_);
+  swap(has_model_fingerprint_, other.has_model_fingerprint_);
+  swap(loaded_model_fingerprint_, other.loaded_model_fingerprint_);
   return *this;
 }
 
@@ -441,6 +599,7 @@ bool MMapWeightCacheProvider::LoadOrStartBuild(const char* path) {
 bool MMapWeightCacheProvider::StartBuild(const char* path) {
   SetFilePath(path);
   building_run_ = builder_.Start(path);
+  builder_.SetModelFingerprint(model_fingerprint_);
   if (IsInMemoryCachePath(file_path_)) {
     // Duplicate the file descriptor to avoid loosing the temporary file when
     // the builder is reset.
@@ -464,6 +623,11 @@ bool MMapWeightCacheProvider::Load() {
   if (temporary_file_descriptor_.IsValid()) {
     XNNPACK_RETURN_CHECK(mmap_handle.Map(temporary_file_descriptor_,
                                          /*offset=*/0, file_path_.c_str()));
+  } else if (building_run_) {
+    // Another process may have published its own cache at `file_path_` since
+    // this one was written. Map the file that was built by this provider.
+    XNNPACK_RETURN_CHECK(mmap_handle.Map(builder_.GetFileDescriptor(),
+                                         /*offset=*/0, file_path_.c_str()));
   } else {
     XNNPACK_ABORT_CHECK(!file_path_.empty(),
                         "Path wasn't provided to weight cache provider.");
@@ -515,6 +679,7 @@ bool MMapWeightCacheProvider::Load() {
   XNNPACK_RETURN_CHECK(buffer_list,
                        "could not get packed weights from flatbuffer.");
 
+  loaded_model_fingerprint_ = header.model_fingerprint;
   mmap_buffer_base_offset_ = buffer_list->base_offset();
   if (const auto buffers = buffer_list->buffers(); buffers) {
     for (auto* buffer : *buffers) {
@@ -543,11 +708,11 @@ bool MMapWeightCacheProvider::LoadLastBuildStep() {
     return true;
   }
 
-  const XNNPackCacheHeader header = [this] {
-    XNNPackCacheHeader header;
-    memcpy(&header, mmap_handles_.front().data(), sizeof(header));
-    return header;
-  }();
+  // When the builder copied the cache to a new file, the existing mappings
+  // still refer to the previous file. They are kept alive because XNNPack may
+  // use their buffers and the new file is mapped from its start to read its
+  // header.
+  const bool copied_file = builder_.LastBuildStepCopiedFile();
 
   // Map last data segment:
   // - either resize the last mmap handle;
@@ -555,22 +720,30 @@ bool MMapWeightCacheProvider::LoadLastBuildStep() {
   {
     MMapHandle& last_mmap_handle = mmap_handles_.back();
     const int last_mmap_size = last_mmap_handle.size();
-    if (!last_mmap_handle.Resize(last_mmap_size +
-                                 builder_.LastBuildStepSize())) {
+    if (copied_file || !last_mmap_handle.Resize(last_mmap_size +
+                                                builder_.LastBuildStepSize())) {
+      const size_t offset = copied_file ? 0 : builder_.LastBuildStepStart();
       mmap_handles_.emplace_back();
       if (temporary_file_descriptor_.IsValid()) {
         XNNPACK_RETURN_CHECK(
-            mmap_handles_.back().Map(temporary_file_descriptor_,
-                                     /*offset=*/builder_.LastBuildStepStart()),
+            mmap_handles_.back().Map(temporary_file_descriptor_, offset),
             "could not map last build step");
       } else {
         XNNPACK_RETURN_CHECK(
-            mmap_handles_.back().Map(file_path_.c_str(),
-                                     /*offset=*/builder_.LastBuildStepStart()),
+            mmap_handles_.back().Map(builder_.GetFileDescriptor(), offset,
+                                     file_path_.c_str()),
             "could not map last build step");
       }
     }
   }
+
+  const XNNPackCacheHeader header = [&] {
+    XNNPackCacheHeader header;
+    memcpy(&header,
+           (copied_file ? mmap_handles_.back() : mmap_handles_.front()).data(),
+           sizeof(header));
+    return header;
+  }();
   // Read the updated buffer list.
   MMapHandle& segment_mmap_handle = mmap_handles_.back();
   const size_t buffer_list_offset =
@@ -623,6 +796,30 @@ void MMapWeightCacheProvider::MapTensorIdentifiers(
                         "Tensor index corresponds to a non existing tensor.");
     buffer_address_to_identifier_[tensors[index].data.data] = identifier;
   }
+  if (!has_model_fingerprint_) {
+    model_fingerprint_ =
+        ComputeModelFingerprint(tensors, tensor_index_to_identifier);
+    has_model_fingerprint_ = true;
+    builder_.SetModelFingerprint(model_fingerprint_);
+    if (!building_run_ && !mmap_handles_.empty() &&
+        loaded_model_fingerprint_ != model_fingerprint_) {
+      RebuildStaleCache();
+    }
+  }
+}
+
+void MMapWeightCacheProvider::RebuildStaleCache() {
+  TFLITE_LOG_PROD(tflite::TFLITE_LOG_WARNING,
+                  "XNNPack weight cache: '%s' was built for another model. "
+                  "Cache needs to be built again.",
+                  file_path_.c_str());
+  cache_key_to_offset_.clear();
+  offset_to_addr_.clear();
+  mmap_handles_.clear();
+  mmap_buffer_base_offset_ = 0;
+  XNNPACK_ABORT_CHECK(StartBuild(file_path_.c_str()),
+                      "XNNPack weight cache: could not rebuild '%s'.",
+                      file_path_.c_str());
 }
 
 void MMapWeightCacheProvider::RemapDataBuffer(const void* const buffer,
@@ -54,12 +54,17 @@ inline constexpr char kInMemoryCachePath[] = ":memory";
 //
 // When reading a cache file, the cache should be rejected if `version`
 // doesn't match `kVersion`.
+//
+// `model_fingerprint` identifies the constant tensors the cache was built
+// from. A cache whose fingerprint doesn't match the model that is being loaded
+// is stale and is rebuilt.
 struct XNNPackCacheHeader {
-  enum : uint64_t { kInvalidHeader = 0, kVersion = 1 };
+  enum : uint64_t { kInvalidHeader = 0, kVersion = 2 };
   uint64_t version;
   uint8_t xnnpack_build_identifier[32];
   uint64_t buffer_list_offset;
   uint64_t buffer_list_size;
+  uint64_t model_fingerprint;
 };
 
 struct PackIdentifier {
@@ -166,12 +171,18 @@ class MMapHandle {
 
 // Provides storage to write the packed buffers to and saves those to disk.
 //
+// Cache files may be shared by several processes that map them concurrently.
+// To avoid exposing a partially written file, the data is written to a
+// temporary file next to the cache file that is atomically renamed to the
+// cache file path at the end of each build step. A published file is never
+// modified: the next build step that appends data works on a copy.
+//
 // WARNING: the interface in this file is still under experimentation and WILL
 // CHANGE. Do not rely on it.
 class WeightCacheBuilder {
  public:
   WeightCacheBuilder() = default;
-  ~WeightCacheBuilder() = default;
+  ~WeightCacheBuilder();
 
   // Non-copyable.
   WeightCacheBuilder(const WeightCacheBuilder&) = delete;
@@ -215,10 +226,24 @@ class WeightCacheBuilder {
   BufferLocation Append(PackIdentifier pack_id, const void* data,
                         uint64_t size);
 
-  // Writes the flatbuffer to disk.
+  // Writes the flatbuffer to disk and publishes the cache file.
   [[nodiscard /*Writing the weight cache can fail.*/]]
   bool StopBuildStep();
 
+  // Sets the model fingerprint that is written in the cache header.
+  void SetModelFingerprint(uint64_t fingerprint) {
+    model_fingerprint_ = fingerprint;
+  }
+
+  // Returns true if the last build step wrote its data to a new file instead
+  // of appending to the file that was published before it.
+  //
+  // Mappings of the previous file don't see the last step's data.
+  [[nodiscard]]
+  bool LastBuildStepCopiedFile() const {
+    return last_build_step_copied_file_;
+  }
+
   // Get the offset in the cache file of the data written during the last step.
   //
   // This includes the buffers that were appended and the whole buffer mapping.
@@ -253,6 +278,22 @@ class WeightCacheBuilder {
   uint8_t* data() const { return data_.get(); }
 
  private:
+  // Opens a new temporary file to write the cache to.
+  [[nodiscard /*Opening a file may fail.*/]]
+  bool OpenTemporaryFile();
+
+  // Copies the published cache file up to the current build step start to a
+  // new temporary file and continues writing to it.
+  [[nodiscard /*Copying a file may fail.*/]]
+  bool CopyPublishedFile();
+
+  // Atomically moves the temporary file to `file_path_`.
+  [[nodiscard /*Renaming a file may fail.*/]]
+  bool Publish();
+
+  // Deletes the temporary file if it hasn't been published.
+  void RemoveTemporaryFile();
+
   std::unique_ptr<uint8_t[]> data_ = nullptr;
   cache::schema::BufferListT schema_;
   size_t capacity_ = 0;
@@ -267,6 +308,14 @@ class WeightCacheBuilder {
   // Temporary file descriptor to write the weights to disk immediately.
   FileDescriptor fd_;
   std::string file_path_;
+  // Path of the file `fd_` writes to while it isn't published. Empty when the
+  // cache is written in place (in-memory caches, Windows).
+  std::string temporary_file_path_;
+  // True when `fd_` refers to the file that was last published at
+  // `file_path_`.
+  bool published_ = false;
+  bool last_build_step_copied_file_ = false;
+  uint64_t model_fingerprint_ = 0;
 
   bool is_build_step_ = false;
 };
@@ -331,6 +380,10 @@ class MMapWeightCacheProvider {
   bool StopBuildStep();
 
   // Creates the tensor map.
+  //
+  // The first call also computes the model fingerprint from the given tensors.
+  // If a loaded cache file was built for another model, it is discarded and a
+  // new cache is built in its place.
   void MapTensorIdentifiers(
       const TfLiteTensor* tensors, size_t size,
       const std::unordered_map<size_t, size_t>& tensor_index_to_identifier);
@@ -416,6 +469,10 @@ class MMapWeightCacheProvider {
   [[nodiscard /*Loading cache data may fail.*/]]
   bool LoadLastBuildStep();
 
+  // Drops a loaded cache file that doesn't match `model_fingerprint_` and
+  // starts building a new one at the same path.
+  void RebuildStaleCache();
+
   // Cache provider implementation for XNNPack.
   xnn_weights_cache_provider cache_provider_{
       /*context=*/this,
@@ -467,6 +524,14 @@ class MMapWeightCacheProvider {
   // Stores the loaded buffer addresses corresponding to the given offset in the
   // cache file.
   std::map<size_t, void*> offset_to_addr_;
+
+  // Fingerprint of the constant tensors passed to the first
+  // `MapTensorIdentifiers` call.
+  uint64_t model_fingerprint_ = 0;
+  bool has_model_fingerprint_ = false;
+
+  // Fingerprint read from the header of the loaded cache file.
+  uint64_t loaded_model_fingerprint_ = 0;
 };
 
 }  // namespace xnnpack
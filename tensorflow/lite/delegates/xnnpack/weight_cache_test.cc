@@ -582,6 +582,69 @@ TEST(WeightCacheBuilderTest, MultipleStepBuild) {
   EXPECT_THAT(GetBufferData(buffer3), ElementsAreArray(payload3));
 }
 
+TEST(WeightCacheBuilderTest, CacheFileIsPublishedWhenBuildStepStops) {
+#if defined(_MSC_VER)
+  GTEST_SKIP() << "Cache files are written in place for this build.";
+#else
+  const std::string payload = "This is some data in the file.";
+  const std::string cache_path = testing::TempDir() + "/published_cache";
+  std::remove(cache_path.c_str());
+
+  WeightCacheBuilder builder;
+  ASSERT_TRUE(builder.Start(cache_path.c_str()));
+  ASSERT_TRUE(builder.StartBuildStep());
+  const BufferLocation loc =
+      builder.Append(PackIdentifier{1, 2, 3}, payload.data(), payload.size());
+  ASSERT_FALSE(loc.IsInvalid());
+
+  // Other processes must not see a partially written cache file.
+  EXPECT_FALSE(FileDescriptor::Open(cache_path.c_str(), O_RDONLY).IsValid());
+
+  ASSERT_TRUE(builder.StopBuildStep());
+  EXPECT_TRUE(FileDescriptor::Open(cache_path.c_str(), O_RDONLY).IsValid());
+#endif
+}
+
+TEST(WeightCacheBuilderTest, PublishedFileIsNotModified) {
+#if defined(_MSC_VER)
+  GTEST_SKIP() << "Cache files are written in place for this build.";
+#else
+  const std::string payload1 = "This is some data in the file.";
+  const std::string payload2 = "Other data in the file.";
+
+  TempFileDesc tmp_file{TempFileDesc::kAutoClose};
+
+  WeightCacheBuilder builder;
+  ASSERT_TRUE(builder.Start(tmp_file.GetCPath()));
+  ASSERT_TRUE(builder.StartBuildStep());
+  ASSERT_FALSE(
+      builder.Append(PackIdentifier{1, 2, 3}, payload1.data(), payload1.size())
+          .IsInvalid());
+  ASSERT_TRUE(builder.StopBuildStep());
+  EXPECT_FALSE(builder.LastBuildStepCopiedFile());
+
+  // Simulates another process mapping the cache file.
+  MMapHandle published;
+  ASSERT_TRUE(published.Map(tmp_file.GetCPath()));
+  const std::vector<uint8_t> published_data(published.begin(),
+                                            published.end());
+
+  ASSERT_TRUE(builder.StartBuildStep());
+  ASSERT_FALSE(
+      builder.Append(PackIdentifier{2, 3, 4}, payload2.data(), payload2.size())
+          .IsInvalid());
+  ASSERT_TRUE(builder.StopBuildStep());
+  EXPECT_TRUE(builder.LastBuildStepCopiedFile());
+
+  EXPECT_THAT(LightSpan<const uint8_t>(published.data(), published.size()),
+              ElementsAreArray(published_data));
+
+  MMapHandle updated;
+  ASSERT_TRUE(updated.Map(tmp_file.GetCPath()));
+  EXPECT_GT(updated.size(), published.size());
+#endif
+}
+
 struct FakeContext {
   // Adds a new tensor and it's backing buffer to the context.
   //
@@ -861,6 +924,39 @@ TEST_F(LoadMMapWeightCacheProviderTest, LookUpSucceeds) {
               ElementsAreArray(reference_2.buffer));
 }
 
+TEST_F(LoadMMapWeightCacheProviderTest, LoadingForTheSameModelReusesCache) {
+  MMapWeightCacheProvider loaded_provider;
+  ASSERT_TRUE(loaded_provider.Load(tmp_file.GetPath()));
+  loaded_provider.MapTensorIdentifiers(ctx.tensors.data(), ctx.tensors.size(),
+                                       ctx.tensor_buffer_identifiers);
+
+  EXPECT_FALSE(loaded_provider.CanStartBuildStep());
+  const xnn_weights_cache_look_up_key look_up_key_1 = LookUpKey1();
+  EXPECT_EQ(loaded_provider.LookUp(&look_up_key_1),
+            ctx.packed_buffers.find(pack_id_1)->second.offset);
+}
+
+TEST_F(LoadMMapWeightCacheProviderTest, LoadingForAnotherModelRebuildsCache) {
+  // Same buffer identifiers with different data.
+  FakeContext other_ctx;
+  other_ctx.AddTensor(/*buffer_identifier=*/kBufferId1, /*size=*/16);
+  other_ctx.AddTensor(/*buffer_identifier=*/kBufferId2, /*size=*/43);
+  other_ctx.AddTensor(/*buffer_identifier=*/kBufferId3, /*size=*/32);
+  other_ctx.AddTensor(/*buffer_identifier=*/kBufferId4, /*size=*/8);
+  other_ctx.FinalizeTensors();
+
+  MMapWeightCacheProvider loaded_provider;
+  ASSERT_TRUE(loaded_provider.Load(tmp_file.GetPath()));
+  loaded_provider.MapTensorIdentifiers(other_ctx.tensors.data(),
+                                       other_ctx.tensors.size(),
+                                       other_ctx.tensor_buffer_identifiers);
+
+  EXPECT_TRUE(loaded_provider.CanStartBuildStep());
+  const xnn_weights_cache_look_up_key look_up_key_1 =
+      other_ctx.LookUpKey(kAlgoSeed1, kWeightIndex1, kBiasIndex);
+  EXPECT_EQ(loaded_provider.LookUp(&look_up_key_1), SIZE_MAX);
+}
+
 TEST(MMapWeightCacheProviderTest, XnnpackCApiJourney) {
   using std::size;
   TempFileDesc temp_fd(TempFileDesc::kAutoClose);
@@ -879,7 +975,7 @@ TEST(MMapWeightCacheProviderTest, XnnpackCApiJourney) {
   {  // Build and reload scenario.
     // This isn't factored between the two scenarios. When reloading the cache
     // in another process, the buffer addresses will have changed.
-    TfLiteTensor tensors[kBufferCount];
+    TfLiteTensor tensors[kBufferCount] = {};
     std::unordered_map<size_t, size_t> tensor_buffer_identifiers;
     for (int i = 0; i < kBufferCount; ++i) {
       tensors[i].data.data = (void*)(fake_buffer_pointer + i);
@@ -994,7 +1090,7 @@ TEST(MMapWeightCacheProviderTest, XnnpackCApiJourney) {
   }
 
   {  // Load existing cache scenario.
-    TfLiteTensor tensors[kBufferCount];
+    TfLiteTensor tensors[kBufferCount] = {};
     std::unordered_map<size_t, size_t> tensor_buffer_identifiers;
     for (int i = 0; i < kBufferCount; ++i) {
       tensors[i].data.data = (void*)(fake_buffer_pointer + i);
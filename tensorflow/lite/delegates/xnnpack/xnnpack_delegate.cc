@@ -613,6 +613,15 @@ class Delegate {
 #endif
   }
 
+  // Returns the number of runtimes that each delegated partition keeps, each
+  // reshaped for different input shapes.
+  int runtime_shape_bucket_count() const {
+    if (!enable_subgraph_reshaping()) {
+      return 1;
+    }
+    return std::max(1, options_.runtime_shape_bucket_count);
+  }
+
   bool support_variable_ops() const {
     if (options_.flags & TFLITE_XNNPACK_DELEGATE_FLAG_VARIABLE_OPERATORS) {
       return true;
@@ -1150,6 +1159,28 @@ class Subgraph {
       flags |= XNN_FLAG_BASIC_PROFILING;
     }
 
+    runtime_ptr = CreateRuntime(context, delegate, subgraph.get(), flags);
+    if (runtime_ptr == nullptr) {
+      return nullptr;
+    }
+
+    Subgraph* xnnpack_subgraph =
+        new Subgraph(delegate, runtime_ptr, externals, external_inputs,
+                     external_outputs, tflite_tensor_to_xnnpack);
+    if (delegate.runtime_shape_bucket_count() > 1) {
+      // The subgraph is kept to create the runtimes of the other shape
+      // buckets.
+      xnnpack_subgraph->subgraph_ = std::move(subgraph);
+      xnnpack_subgraph->runtime_flags_ = flags;
+    }
+    return xnnpack_subgraph;
+  }
+
+  // Creates a runtime for `subgraph`, adding its packed weights to the weight
+  // cache when the cache is being built.
+  static xnn_runtime_t CreateRuntime(TfLiteContext* context,
+                                     Delegate& delegate,
+                                     xnn_subgraph_t subgraph, uint32_t flags) {
     if (delegate.weight_cache_provider_.IsActive() &&
         delegate.weight_cache_provider_.CanStartBuildStep()) {
       if (!delegate.weight_cache_provider_.StartBuildStep()) {
@@ -1158,14 +1189,18 @@ class Subgraph {
         return nullptr;
       }
     }
-    status = xnn_create_runtime_v4(subgraph.get(), delegate.weights_cache(),
-                                   delegate.workspace(), delegate.threadpool(),
-                                   flags, &runtime_ptr);
+    xnn_runtime_t runtime_ptr = nullptr;
+    const xnn_status status = xnn_create_runtime_v4(
+        subgraph, delegate.weights_cache(), delegate.workspace(),
+        delegate.threadpool(), flags, &runtime_ptr);
     if (delegate.weight_cache_provider_.IsActive() &&
         delegate.weight_cache_provider_.CanStartBuildStep()) {
       if (!delegate.weight_cache_provider_.StopBuildStep()) {
         TF_LITE_KERNEL_LOG(context,
                            "XNNPack delegate failed to stop cache build step.");
+        if (runtime_ptr != nullptr) {
+          xnn_delete_runtime(runtime_ptr);
+        }
         return nullptr;
       }
     }
@@ -1173,9 +1208,7 @@ class Subgraph {
       TF_LITE_KERNEL_LOG(context, "failed to create XNNPACK runtime");
       return nullptr;
     }
-
-    return new Subgraph(delegate, runtime_ptr, externals, external_inputs,
-                        external_outputs, tflite_tensor_to_xnnpack);
+    return runtime_ptr;
   }
 
   TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node,
@@ -1184,27 +1217,10 @@ class Subgraph {
 
     if (enable_subgraph_reshaping) {
       xnn_status status = xnn_status_invalid_state;
-      for (int i = 0; i < inputs_.size(); ++i) {
-        const TfLiteTensor* tensor = &context->tensors[inputs_[i]];
-        const int dims_count = NumDimensions(tensor);
-        std::array<size_t, XNN_MAX_TENSOR_DIMS> xnn_dims;
-        std::copy(&tensor->dims->data[0], &tensor->dims->data[dims_count],
-                  xnn_dims.begin());
-        status = xnn_reshape_external_value(
-            runtime_.get(), tflite_tensor_to_xnnpack_[inputs_[i]], dims_count,
-            xnn_dims.data());
-        if (status != xnn_status_success) {
-          TF_LITE_KERNEL_LOG(
-              context, "XNNPack delegate failed to reshape external value");
-          return kTfLiteError;
-        }
-        // signal that setup must be called.
-        externals_[inputs_[i]] = nullptr;
-      }
-      status = xnn_reshape_runtime(runtime_.get());
-      if (status != xnn_status_success) {
-        TF_LITE_KERNEL_LOG(context,
-                           "XNNPack delegate failed to reshape runtime");
+      std::vector<size_t> input_shapes = GetInputShapes(context);
+      if (input_shapes != input_shapes_ &&
+          SwitchRuntime(context, *delegate, std::move(input_shapes)) !=
+              kTfLiteOk) {
         return kTfLiteError;
       }
 
@@ -1303,6 +1319,91 @@ class Subgraph {
     return kTfLiteOk;
   }
 
+  // Returns the shapes of the partition inputs, flattened as the number of
+  // inputs followed by the rank and the dimensions of each input.
+  std::vector<size_t> GetInputShapes(const TfLiteContext* context) const {
+    std::vector<size_t> input_shapes{inputs_.size()};
+    for (const int input : inputs_) {
+      const TfLiteIntArray* dims = context->tensors[input].dims;
+      input_shapes.push_back(dims->size);
+      input_shapes.insert(input_shapes.end(), &dims->data[0],
+                          &dims->data[dims->size]);
+    }
+    return input_shapes;
+  }
+
+  // Makes `runtime_` a runtime reshaped for `input_shapes`.
+  //
+  // Runtimes already reshaped for other input shapes are kept in
+  // `shape_buckets_`, up to the delegate's `runtime_shape_bucket_count()`.
+  // Switching back to one of them doesn't reshape anything. When no bucket
+  // matches, a new runtime is created if the limit allows it, otherwise the
+  // least recently used runtime is reshaped.
+  TfLiteStatus SwitchRuntime(TfLiteContext* context, Delegate& delegate,
+                             std::vector<size_t> input_shapes) {
+    ShapeBucket active{std::move(runtime_), std::move(externals_),
+                       std::move(input_shapes_), variables_set_up_};
+    const auto match = std::find_if(
+        shape_buckets_.begin(), shape_buckets_.end(),
+        [&](const ShapeBucket& b) { return b.input_shapes == input_shapes; });
+    ShapeBucket next;
+    if (match != shape_buckets_.end()) {
+      next = std::move(*match);
+      shape_buckets_.erase(match);
+    } else if (subgraph_ != nullptr &&
+               shape_buckets_.size() + 1 <
+                   static_cast<size_t>(delegate.runtime_shape_bucket_count())) {
+      next.runtime.reset(
+          CreateRuntime(context, delegate, subgraph_.get(), runtime_flags_));
+      if (next.runtime == nullptr) {
+        RestoreRuntime(std::move(active));
+        return kTfLiteError;
+      }
+      for (const auto& external : active.externals) {
+        next.externals[external.first] = nullptr;
+      }
+    } else if (!shape_buckets_.empty()) {
+      next = std::move(shape_buckets_.front());
+      shape_buckets_.erase(shape_buckets_.begin());
+    } else {
+      next = std::move(active);
+    }
+    if (active.runtime != nullptr) {
+      shape_buckets_.push_back(std::move(active));
+    }
+    RestoreRuntime(std::move(next));
+
+    if (input_shapes_ == input_shapes) {
+      return kTfLiteOk;
+    }
+    for (int i = 0; i < inputs_.size(); ++i) {
+      const TfLiteTensor* tensor = &context->tensors[inputs_[i]];
+      const int dims_count = NumDimensions(tensor);
+      std::array<size_t, XNN_MAX_TENSOR_DIMS> xnn_dims;
+      std::copy(&tensor->dims->data[0], &tensor->dims->data[dims_count],
+                xnn_dims.begin());
+      const xnn_status status = xnn_reshape_external_value(
+          runtime_.get(), tflite_tensor_to_xnnpack_[inputs_[i]], dims_count,
+          xnn_dims.data());
+      if (status != xnn_status_success) {
+        TF_LITE_KERNEL_LOG(context,
+                           "XNNPack delegate failed to reshape external value");
+        return kTfLiteError;
+      }
+      // signal that setup must be called.
+      externals_[inputs_[i]] = nullptr;
+    }
+    // The shapes are only recorded once the reshape succeeded, so that a
+    // failed reshape is attempted again.
+    input_shapes_.clear();
+    if (xnn_reshape_runtime(runtime_.get()) != xnn_status_success) {
+      TF_LITE_KERNEL_LOG(context, "XNNPack delegate failed to reshape runtime");
+      return kTfLiteError;
+    }
+    input_shapes_ = std::move(input_shapes);
+    return kTfLiteOk;
+  }
+
   // Fetch the profile information from XNNPACK and add the events to TfLite's
   // profiler.
   static TfLiteStatus AddEventsToProfiler(Profiler* profiler,
@@ -7523,6 +7624,24 @@ class Subgraph {
   inline Delegate* GetDelegate() const { return delegate_; }
 
  private:
+  // An XNNPACK runtime that isn't in use and the state it was last set up
+  // with.
+  struct ShapeBucket {
+    std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime{
+        nullptr, &xnn_delete_runtime};
+    std::unordered_map<int, void*> externals;
+    std::vector<size_t> input_shapes;
+    bool variables_set_up = false;
+  };
+
+  // Makes the runtime held by `bucket` the one in use.
+  void RestoreRuntime(ShapeBucket bucket) {
+    runtime_ = std::move(bucket.runtime);
+    externals_ = std::move(bucket.externals);
+    input_shapes_ = std::move(bucket.input_shapes);
+    variables_set_up_ = bucket.variables_set_up;
+  }
+
   Subgraph(Delegate& delegate, xnn_runtime_t runtime,
            const std::unordered_set<int>& externals, std::vector<int>& inputs,
            std::vector<int>& outputs,
@@ -7565,6 +7684,15 @@ class Subgraph {
   bool variables_set_up_ = false;
   bool enable_subgraph_reshaping_ = false;
   Delegate* delegate_;
+  // Input shapes `runtime_` was reshaped for, see `GetInputShapes`.
+  std::vector<size_t> input_shapes_;
+  // Runtimes reshaped for other input shapes, the least recently used first.
+  std::vector<ShapeBucket> shape_buckets_;
+  // Subgraph and flags used to create the runtimes of `shape_buckets_`. Only
+  // set when the delegate keeps more than one runtime per partition.
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> subgraph_{
+      nullptr, &xnn_delete_subgraph};
+  uint32_t runtime_flags_ = 0;
 };
 
 TfLiteIntArray* Delegate::PrepareOpsToDelegate(TfLiteContext* context) {
@@ -73,6 +73,18 @@ typedef struct {
   // To keep backwards compatibility with the previous caching mechanism, the
   // weight cache will only be loaded from this if `weight_cache` is undefined.
   const char* weight_cache_file_path;
+  // Number of runtimes each delegated partition keeps when
+  // TFLITE_XNNPACK_DELEGATE_FLAG_ENABLE_SUBGRAPH_RESHAPING is set. Each runtime
+  // is reshaped for different input shapes, so alternating between up to this
+  // many input shapes doesn't reshape the partition again. When a new shape is
+  // seen and no runtime is left, the least recently used one is reshaped.
+  //
+  // Runtimes share the delegate workspace, but pack their own weights unless a
+  // weights cache is used.
+  //
+  // 0 or 1 keeps a single runtime that is reshaped every time the input shapes
+  // change.
+  int32_t runtime_shape_bucket_count;
 } TfLiteXNNPackDelegateOptions;
 
 // Returns true on systems that support running the in-memory weight cache
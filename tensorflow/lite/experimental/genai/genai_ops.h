@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_LITE_EXPERIMENTAL_GENAI_GENAI_OPS_H_
 
 #include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/mutable_op_resolver.h"
 
 namespace tflite {
@@ -25,8 +26,21 @@ namespace custom {
 
 TfLiteRegistration* Register_KV_CACHE();
 TfLiteRegistration* Register_EXTERNAL_KV_CACHE();
+TfLiteRegistration* Register_PAGED_KV_CACHE();
 TfLiteRegistration* Register_SDPA();
 
+// Keeps only the first `num_entries` entries of every layer of the KV cache
+// kept in `resources`, e.g. to drop rejected speculative tokens. Entries are
+// counted from the first slot of the cache, which is position 0 until the
+// cache overflows. Returns an error if there is no KV cache in `resources`.
+TfLiteStatus TruncateKVCache(resource::ResourceMap& resources,
+                             int num_entries);
+
+// Releases `sequence_id` from the paged KV caches of the `num_layers` layers
+// kept in `resources`, returning the blocks it no longer shares to the pool.
+void ReleasePagedKVCacheSequence(resource::ResourceMap& resources,
+                                 int num_layers, int sequence_id);
+
 extern "C" void GenAIOpsRegisterer(::tflite::MutableOpResolver* resolver);
 
 }  // namespace custom
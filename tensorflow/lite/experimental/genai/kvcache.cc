@@ -14,9 +14,12 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/lite/core/c/common.h"
@@ -57,8 +60,94 @@ struct OpData {
   bool is_initialized;
   uint8_t* key_cache_ptr;
   uint8_t* value_cache_ptr;
+  // Whether the caches hold int8 values quantized with one symmetric scale per
+  // head instead of float values.
+  bool quantize_cache;
+  // The per-head scales of the key and value caches of this layer.
+  std::vector<float> key_scales;
+  std::vector<float> value_scales;
 };
 
+namespace {
+
+// Sets per-head symmetric quantization on the cache output `tensor`, which
+// has shape (B, S, N, H).
+void SetPerHeadQuantization(TfLiteTensor* tensor,
+                            const std::vector<float>& scales) {
+  TfLiteQuantizationFree(&tensor->quantization);
+  auto* params = static_cast<TfLiteAffineQuantization*>(
+      malloc(sizeof(TfLiteAffineQuantization)));
+  params->scale = TfLiteFloatArrayCreate(scales.size());
+  params->zero_point = TfLiteIntArrayCreate(scales.size());
+  for (int i = 0; i < scales.size(); ++i) {
+    params->scale->data[i] = scales[i];
+    params->zero_point->data[i] = 0;
+  }
+  params->quantized_dimension = 2;
+  tensor->quantization.type = kTfLiteAffineQuantization;
+  tensor->quantization.params = params;
+}
+
+// Copies `scales` to the per-head quantization set on `tensor`.
+void UpdatePerHeadScales(TfLiteTensor* tensor,
+                         const std::vector<float>& scales) {
+  auto* params =
+      static_cast<TfLiteAffineQuantization*>(tensor->quantization.params);
+  std::copy(scales.begin(), scales.end(), params->scale->data);
+}
+
+// Quantizes `num_entries` float entries of shape (N, H) from `input` to the
+// int8 layer cache `cache`, starting at entry `first_entry`. When the new
+// values of a head don't fit its current scale, the scale grows and the
+// `max_num_entries` entries of that head already in the cache are
+// requantized. This only happens while the range of the values is still
+// being discovered, so most updates only touch the new entries.
+void QuantizeToCache(const float* input, int64_t num_entries, int num_heads,
+                     int head_dim, int64_t first_entry, int64_t max_num_entries,
+                     std::vector<float>& scales, int8_t* cache) {
+  constexpr float kQuantizedMax = 127.0f;
+  const int elements_in_one_entry = num_heads * head_dim;
+  for (int head = 0; head < num_heads; ++head) {
+    float max_abs = 0.0f;
+    for (int64_t entry = 0; entry < num_entries; ++entry) {
+      const float* values =
+          input + entry * elements_in_one_entry + head * head_dim;
+      for (int i = 0; i < head_dim; ++i) {
+        max_abs = std::max(max_abs, std::abs(values[i]));
+      }
+    }
+    const float needed_scale = max_abs / kQuantizedMax;
+    if (needed_scale > scales[head]) {
+      const float rescale = scales[head] / needed_scale;
+      for (int64_t entry = 0; entry < max_num_entries; ++entry) {
+        int8_t* values =
+            cache + entry * elements_in_one_entry + head * head_dim;
+        for (int i = 0; i < head_dim; ++i) {
+          values[i] = static_cast<int8_t>(std::round(values[i] * rescale));
+        }
+      }
+      scales[head] = needed_scale;
+    }
+    const float inverse_scale =
+        scales[head] > 0.0f ? 1.0f / scales[head] : 0.0f;
+    for (int64_t entry = 0; entry < num_entries; ++entry) {
+      const float* values =
+          input + entry * elements_in_one_entry + head * head_dim;
+      int8_t* quantized = cache +
+                          (first_entry + entry) * elements_in_one_entry +
+                          head * head_dim;
+      for (int i = 0; i < head_dim; ++i) {
+        quantized[i] = static_cast<int8_t>(
+            std::min(kQuantizedMax,
+                     std::max(-kQuantizedMax,
+                              std::round(values[i] * inverse_scale))));
+      }
+    }
+  }
+}
+
+}  // namespace
+
 void* KVCacheInit(TfLiteContext* context, const char* buffer, size_t length) {
   OpData* op_data = new OpData();
   // TODO(b/333891673) Reset this value via ClearCaches in
@@ -72,6 +161,7 @@ void* KVCacheInit(TfLiteContext* context, const char* buffer, size_t length) {
   op_data->is_initialized = false;
   op_data->key_cache_ptr = nullptr;
   op_data->value_cache_ptr = nullptr;
+  op_data->quantize_cache = false;
   return op_data;
 }
 
@@ -95,6 +185,7 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
         num_layers > 0 ? num_layers : kDefaultNumTransformerLayers;
     op_data->layer_index =
         layer_index > 0 ? layer_index : kDefaultTransformerLayerId;
+    op_data->quantize_cache = flexbuffer_map["quantize_cache"].AsBool();
     op_data->first_slot_index = 0;
     op_data->is_initialized = true;
   }
@@ -132,8 +223,18 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   kfull->allocation_type = kTfLiteCustom;
   vfull->allocation_type = kTfLiteCustom;
 
-  kfull->type = kTfLiteFloat32;
-  vfull->type = kTfLiteFloat32;
+  const TfLiteType cache_type =
+      op_data->quantize_cache ? kTfLiteInt8 : kTfLiteFloat32;
+  const size_t cache_element_size = TfLiteTypeGetSize(cache_type);
+  kfull->type = cache_type;
+  vfull->type = cache_type;
+  if (op_data->quantize_cache) {
+    // Num heads
+    op_data->key_scales.resize(key->dims->data[2], 0.0f);
+    op_data->value_scales.resize(key->dims->data[2], 0.0f);
+    SetPerHeadQuantization(kfull, op_data->key_scales);
+    SetPerHeadQuantization(vfull, op_data->value_scales);
+  }
 
   TfLiteIntArray* input_dims = key->dims;
   TfLiteIntArray* kcache_dims = TfLiteIntArrayCopy(input_dims);
@@ -161,7 +262,7 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
 
   if (resources.count(KVCACHE_KEY_RESOURCE) == 0) {
     auto* cbuffer = new resource::CacheBuffer();
-    cbuffer->Initialize(*kcache_buffer_dims);
+    cbuffer->Initialize(*kcache_buffer_dims, cache_type);
     resources.emplace(KVCACHE_KEY_RESOURCE, cbuffer);
     op_data->key_cache_buffer = cbuffer;
   } else {
@@ -172,7 +273,7 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
   }
   if (resources.count(KVCACHE_VALUE_RESOURCE) == 0) {
     auto* cbuffer = new resource::CacheBuffer();
-    cbuffer->Initialize(*vcache_buffer_dims);
+    cbuffer->Initialize(*vcache_buffer_dims, cache_type);
     resources.emplace(KVCACHE_VALUE_RESOURCE, cbuffer);
     op_data->value_cache_buffer = cbuffer;
   } else {
@@ -182,6 +283,11 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
     op_data->value_cache_buffer = cbuffer;
   }
 
+  // All the layers share the caches, so they must agree on quantization.
+  TF_LITE_ENSURE_EQ(context, op_data->key_cache_buffer->GetType(), cache_type);
+  TF_LITE_ENSURE_EQ(context, op_data->value_cache_buffer->GetType(),
+                    cache_type);
+
   // Get the pointers to the individual caches for a layer.
   RuntimeShape shape(GetTensorShape(key));
   const int elements_in_one_entry = shape.Dims(2) * shape.Dims(3);
@@ -191,8 +297,10 @@ TfLiteStatus KVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
       reinterpret_cast<uint8_t*>(op_data->key_cache_buffer->GetBuffer());
   uint8_t* v_ptr =
       reinterpret_cast<uint8_t*>(op_data->value_cache_buffer->GetBuffer());
-  k_ptr = k_ptr + sizeof(float) * op_data->layer_index * elements_in_one_block;
-  v_ptr = v_ptr + sizeof(float) * op_data->layer_index * elements_in_one_block;
+  k_ptr = k_ptr +
+          cache_element_size * op_data->layer_index * elements_in_one_block;
+  v_ptr = v_ptr +
+          cache_element_size * op_data->layer_index * elements_in_one_block;
 
   size_t kcache_dims_flatsize = kcache_dims->data[0] * kcache_dims->data[1] *
                                 kcache_dims->data[2] * kcache_dims->data[3];
@@ -258,13 +366,17 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   const int elements_in_one_entry = shape.Dims(2) * shape.Dims(3);
   const int elements_in_one_block =
       op_data->max_num_entries * elements_in_one_entry;
-  const int64_t num_bytes_per_tensor = sizeof(float) * elements_in_one_entry;
+  const size_t cache_element_size = TfLiteTypeGetSize(kfull->type);
+  const int64_t num_bytes_per_tensor =
+      cache_element_size * elements_in_one_entry;
 
   // Get the pointers to the individual caches for a layer.
   uint8_t* k_ptr = reinterpret_cast<uint8_t*>(key_cache_ptr);
   uint8_t* v_ptr = reinterpret_cast<uint8_t*>(value_cache_ptr);
-  k_ptr = k_ptr + sizeof(float) * op_data->layer_index * elements_in_one_block;
-  v_ptr = v_ptr + sizeof(float) * op_data->layer_index * elements_in_one_block;
+  k_ptr = k_ptr +
+          cache_element_size * op_data->layer_index * elements_in_one_block;
+  v_ptr = v_ptr +
+          cache_element_size * op_data->layer_index * elements_in_one_block;
 
   // 0. Ensure output ptr is pointing to the cache data
   TF_LITE_ENSURE_EQ(context, k_ptr, op_data->key_cache_ptr);
@@ -314,8 +426,9 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
     // And we need to write the entire cache.
     num_slots_for_output = max_num_entries;
     const int bytes_offset =
-        sizeof(float) * elements_in_one_entry * slots_to_shift;
-    const int size_bytes_to_shift = sizeof(float) * elements_in_one_entry *
+        cache_element_size * elements_in_one_entry * slots_to_shift;
+    const int size_bytes_to_shift = cache_element_size *
+                                    elements_in_one_entry *
                                     (max_num_entries - slots_to_shift);
     // TODO(b/333893996): This is O(cache_size) data motion. Consider optimizing
     // with a circular buffer or similar.
@@ -331,8 +444,19 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
   const int64_t bytes_offset_for_cache = first_slot * num_bytes_per_tensor;
 
   // 4. Put the key and value in their respective caches.
-  memcpy(k_ptr + bytes_offset_for_cache, key->data.data, key->bytes);
-  memcpy(v_ptr + bytes_offset_for_cache, value->data.data, value->bytes);
+  if (op_data->quantize_cache) {
+    QuantizeToCache(GetTensorData<float>(key), num_slots_needed, shape.Dims(2),
+                    shape.Dims(3), first_slot, max_num_entries,
+                    op_data->key_scales, reinterpret_cast<int8_t*>(k_ptr));
+    QuantizeToCache(GetTensorData<float>(value), num_slots_needed,
+                    shape.Dims(2), shape.Dims(3), first_slot, max_num_entries,
+                    op_data->value_scales, reinterpret_cast<int8_t*>(v_ptr));
+    UpdatePerHeadScales(kfull, op_data->key_scales);
+    UpdatePerHeadScales(vfull, op_data->value_scales);
+  } else {
+    memcpy(k_ptr + bytes_offset_for_cache, key->data.data, key->bytes);
+    memcpy(v_ptr + bytes_offset_for_cache, value->data.data, value->bytes);
+  }
 
   // Update counts.
   current_num_entries =
@@ -345,6 +469,20 @@ TfLiteStatus KVCacheEval(TfLiteContext* context, TfLiteNode* node) {
 
 }  // namespace llm
 
+TfLiteStatus TruncateKVCache(resource::ResourceMap& resources,
+                             int num_entries) {
+  for (const int id : {llm::KVCACHE_KEY_RESOURCE,
+                       llm::KVCACHE_VALUE_RESOURCE}) {
+    auto it = resources.find(id);
+    if (it == resources.end()) return kTfLiteError;
+    auto* cache = static_cast<resource::CacheBuffer*>(it->second.get());
+    for (int layer = 0; layer < cache->GetNumLayers(); ++layer) {
+      cache->Truncate(layer, num_entries);
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteRegistration* Register_KV_CACHE() {
   static TfLiteRegistration r = {llm::KVCacheInit, llm::KVCacheFree,
                                  llm::KVCachePrepare, llm::KVCacheEval};
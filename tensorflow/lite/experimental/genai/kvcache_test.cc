@@ -13,11 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cmath>
 #include <cstdint>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
 #include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/experimental/genai/genai_ops.h"
 #include "tensorflow/lite/kernels/test_util.h"
 #include "tensorflow/lite/schema/schema_generated.h"
@@ -30,13 +33,14 @@ static const int kDefaultMaxNumCacheEntries = 2048;
 class SimpleCacheOpModel : public SingleOpModel {
  public:
   SimpleCacheOpModel(const TensorData& pos_tensor, const TensorData& k_tensor,
-                     const TensorData& v_tensor) {
+                     const TensorData& v_tensor,
+                     const std::vector<uint8_t>& custom_options = {}) {
     pos_ = AddInput(pos_tensor);
     k_ = AddInput(k_tensor);
     v_ = AddInput(v_tensor);
     kfull_ = AddOutput(k_tensor.type);
     vfull_ = AddOutput(v_tensor.type);
-    SetCustomOp("KV_Cache", {}, ops::custom::Register_KV_CACHE);
+    SetCustomOp("KV_Cache", custom_options, ops::custom::Register_KV_CACHE);
 
     BuildInterpreter({GetShape(pos_), GetShape(k_), GetShape(v_)});
   }
@@ -67,8 +71,35 @@ class SimpleCacheOpModel : public SingleOpModel {
     return output;
   }
 
+  // Returns the dequantized values of a quantized cache `tensor` of shape
+  // (1, S, N, H).
+  std::vector<float> GetDequantized(int tensor) {
+    const TfLiteTensor* t = interpreter_->tensor(tensor);
+    const auto* params =
+        static_cast<const TfLiteAffineQuantization*>(t->quantization.params);
+    const int num_heads = t->dims->data[2];
+    const int head_dim = t->dims->data[3];
+    const std::vector<int8_t> quantized = ExtractVector<int8_t>(tensor);
+    std::vector<float> values(quantized.size());
+    for (int i = 0; i < quantized.size(); ++i) {
+      const int head = (i / head_dim) % num_heads;
+      values[i] = quantized[i] * params->scale->data[head];
+    }
+    return values;
+  }
+
+  std::vector<float> GetDequantizedFullK() { return GetDequantized(kfull_); }
+  std::vector<float> GetDequantizedFullV() { return GetDequantized(vfull_); }
+
+  const TfLiteTensor* GetFullKTensor() { return interpreter_->tensor(kfull_); }
+
   TfLiteStatus ReAllocate() { return interpreter_->AllocateTensors(); }
 
+  TfLiteStatus Truncate(int num_entries) {
+    return ops::custom::TruncateKVCache(
+        interpreter_->primary_subgraph().resources(), num_entries);
+  }
+
  protected:
   int pos_;
   int k_;
@@ -237,5 +268,126 @@ TEST(SimpleCacheOp2Test, ShiftSlotsInCache) {
   ASSERT_EQ(m.Invoke(), kTfLiteError);
 }
 
+std::vector<uint8_t> QuantizedCacheOptions(int max_num_entries) {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.Int("kv_cache_max", max_num_entries);
+    fbb.Bool("quantize_cache", true);
+  });
+  fbb.Finish();
+  return fbb.GetBuffer();
+}
+
+TEST(SimpleCacheOp2Test, TruncateDropsRejectedEntries) {
+  SimpleCacheOpModel m({TensorType_INT64, {2}},
+                       {TensorType_FLOAT32, {1, 2, 1, 2}},
+                       {TensorType_FLOAT32, {1, 2, 1, 2}});
+
+  m.SetPosition({0, 1});
+  m.SetKey({1, 2, 3, 4});
+  m.SetValue({5, 6, 7, 8});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  m.SetPosition({2, 3});
+  m.SetKey({9, 10, 11, 12});
+  m.SetValue({13, 14, 15, 16});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  // Rejecting the last three entries keeps only the first one.
+  ASSERT_EQ(m.Truncate(1), kTfLiteOk);
+  std::vector<float> fullk = m.GetFullK();
+  std::vector<float> fullv = m.GetFullV();
+  EXPECT_EQ(fullk[0], 1);
+  EXPECT_EQ(fullk[1], 2);
+  EXPECT_EQ(fullv[1], 6);
+  for (int i = 2; i < 8; ++i) {
+    EXPECT_EQ(fullk[i], 0);
+    EXPECT_EQ(fullv[i], 0);
+  }
+
+  // Decoding resumes right after the kept entry.
+  m.SetPosition({1, 2});
+  m.SetKey({17, 18, 19, 20});
+  m.SetValue({21, 22, 23, 24});
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  fullk = m.GetFullK();
+  EXPECT_EQ(fullk[2], 17);
+  EXPECT_EQ(fullk[5], 20);
+  EXPECT_EQ(fullk[6], 0);
+}
+
+TEST(QuantizedCacheOpTest, StoresInt8WithPerHeadScales) {
+  constexpr int kMaxNumEntries = 4;
+  SimpleCacheOpModel m({TensorType_INT64, {2}},
+                       {TensorType_FLOAT32, {1, 2, 2, 3}},
+                       {TensorType_FLOAT32, {1, 2, 2, 3}},
+                       QuantizedCacheOptions(kMaxNumEntries));
+
+  m.SetPosition({0, 1});
+  // The second head has a much larger range than the first one.
+  std::vector<float> key = {1, 0.5, -1, 20, 40, 10, 0.25, 1, -0.5, -40, 8, 4};
+  m.SetKey(key);
+  std::vector<float> value = {2, 3, -4, 5, 6, 7, 1, 8, -12, 11, 14, 21};
+  m.SetValue(value);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  const TfLiteTensor* kfull = m.GetFullKTensor();
+  ASSERT_EQ(kfull->type, kTfLiteInt8);
+  EXPECT_EQ(kfull->bytes, kMaxNumEntries * 2 * 3);
+
+  std::vector<float> fullk = m.GetDequantizedFullK();
+  std::vector<float> fullv = m.GetDequantizedFullV();
+  ASSERT_EQ(fullk.size(), kMaxNumEntries * 2 * 3);
+  for (int i = 0; i < key.size(); ++i) {
+    const float key_tolerance = (i / 3) % 2 == 0 ? 1.0f / 127 : 40.0f / 127;
+    EXPECT_NEAR(fullk[i], key[i], key_tolerance);
+    EXPECT_NEAR(fullv[i], value[i], 21.0f / 127);
+  }
+  for (int i = key.size(); i < fullk.size(); ++i) {
+    EXPECT_EQ(fullk[i], 0);
+    EXPECT_EQ(fullv[i], 0);
+  }
+
+  // Values out of the range seen so far grow the scale of the first head,
+  // and the entries already cached stay close to their original values.
+  m.SetPosition({2, 3});
+  std::vector<float> key2 = {4, 4, 4, 1, 1, 1, -4, -4, -4, 1, 1, 1};
+  m.SetKey(key2);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  fullk = m.GetDequantizedFullK();
+  for (int i = 0; i < key.size(); ++i) {
+    const float key_tolerance = (i / 3) % 2 == 0 ? 5.0f / 127 : 40.0f / 127;
+    EXPECT_NEAR(fullk[i], key[i], key_tolerance);
+  }
+  for (int i = 0; i < key2.size(); ++i) {
+    const float key_tolerance = (i / 3) % 2 == 0 ? 4.0f / 127 : 40.0f / 127;
+    EXPECT_NEAR(fullk[key.size() + i], key2[i], key_tolerance);
+  }
+}
+
+TEST(QuantizedCacheOpTest, ShiftsQuantizedEntries) {
+  constexpr int kMaxNumEntries = 4;
+  SimpleCacheOpModel m({TensorType_INT64, {1}},
+                       {TensorType_FLOAT32, {1, 1, 1, 2}},
+                       {TensorType_FLOAT32, {1, 1, 1, 2}},
+                       QuantizedCacheOptions(kMaxNumEntries));
+
+  for (int position = 0; position < kMaxNumEntries + 2; ++position) {
+    m.SetPosition({position});
+    m.SetKey({1.0f * position, -1.0f * position});
+    m.SetValue({2.0f * position, 1.0f});
+    ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  }
+
+  // The cache holds the last `kMaxNumEntries` positions, oldest first.
+  std::vector<float> fullk = m.GetDequantizedFullK();
+  std::vector<float> fullv = m.GetDequantizedFullV();
+  for (int entry = 0; entry < kMaxNumEntries; ++entry) {
+    const float position = entry + 2;
+    EXPECT_NEAR(fullk[2 * entry], position, 5.0f / 127);
+    EXPECT_NEAR(fullk[2 * entry + 1], -position, 5.0f / 127);
+    EXPECT_NEAR(fullv[2 * entry], 2 * position, 10.0f / 127);
+  }
+}
+
 }  // namespace
 }  // namespace tflite
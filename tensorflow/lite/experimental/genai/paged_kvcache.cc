@@ -0,0 +1,322 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "flatbuffers/flexbuffers.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+
+namespace tflite {
+namespace ops {
+namespace custom {
+namespace llm {
+
+static const int kPositionTensor = 0;
+static const int kKeySliceTensor = 1;
+static const int kValueSliceTensor = 2;
+static const int kSequenceIdTensor = 3;
+static const int kParentSequenceIdTensor = 4;
+static const int kKeyCacheTensor = 0;
+static const int kValueCacheTensor = 1;
+static const int kBlockTableTensor = 2;
+static const int kRequiredNumDimensions = 4;
+static const int kDefaultMaxNumCacheEntries = 2048;
+static const int kDefaultBlockSize = 16;
+static const int kDefaultMaxNumBlocks = 1024;
+
+// The key and value caches of layer `i` are the resources
+// PAGED_KVCACHE_RESOURCE_BASE + 2 * i and PAGED_KVCACHE_RESOURCE_BASE + 2 * i
+// + 1.
+static const int PAGED_KVCACHE_RESOURCE_BASE = 44;
+
+struct OpData {
+  int layer_index;
+  int max_num_entries;
+  int block_size;
+  int max_num_blocks;
+  // Pointers to the key and value caches that this Op doesn't own (and
+  // therefore does not free on destruction of this Op).
+  resource::PagedCacheBuffer* key_cache;
+  resource::PagedCacheBuffer* value_cache;
+};
+
+namespace {
+
+// Returns the paged cache stored under `id` in `resources`, creating it with
+// `entry_size` floats per entry if it doesn't exist yet.
+resource::PagedCacheBuffer* GetOrCreateCache(resource::ResourceMap& resources,
+                                             int id, const OpData& op_data,
+                                             int entry_size) {
+  auto it = resources.find(id);
+  if (it != resources.end()) {
+    return static_cast<resource::PagedCacheBuffer*>(it->second.get());
+  }
+  auto* cache = new resource::PagedCacheBuffer();
+  cache->Initialize(op_data.block_size, entry_size, op_data.max_num_blocks);
+  resources.emplace(id, cache);
+  return cache;
+}
+
+// Starts `sequence_id` in `cache`, sharing the entries of `parent_id` if it
+// is not negative.
+TfLiteStatus StartSequence(resource::PagedCacheBuffer* cache, int sequence_id,
+                           int parent_id) {
+  if (cache->HasSequence(sequence_id)) return kTfLiteOk;
+  if (parent_id < 0) return cache->CreateSequence(sequence_id);
+  return cache->ForkSequence(parent_id, sequence_id);
+}
+
+// Writes the cache of `sequence_id` to `output` as `max_num_entries`
+// contiguous entries.
+void GatherCache(const resource::PagedCacheBuffer& cache, int sequence_id,
+                 int max_num_entries, float* output) {
+  const int num_entries = std::min<int>(
+      max_num_entries,
+      cache.GetBlockTable(sequence_id).size() * cache.block_size());
+  cache.Gather(sequence_id, num_entries, output);
+  memset(output + static_cast<size_t>(num_entries) * cache.entry_size(), 0,
+         sizeof(float) * (max_num_entries - num_entries) * cache.entry_size());
+}
+
+}  // namespace
+
+void* PagedKVCacheInit(TfLiteContext* context, const char* buffer,
+                       size_t length) {
+  OpData* op_data = new OpData();
+  int32_t max_num_entries = 0;
+  int32_t block_size = 0;
+  int32_t max_num_blocks = 0;
+  int32_t layer_index = 0;
+  if (buffer != nullptr && length > 0) {
+    const uint8_t* options = reinterpret_cast<const uint8_t*>(buffer);
+    auto flexbuffer_map = flexbuffers::GetRoot(options, length).AsMap();
+    max_num_entries = flexbuffer_map["kv_cache_max"].AsInt32();
+    block_size = flexbuffer_map["block_size"].AsInt32();
+    max_num_blocks = flexbuffer_map["max_num_blocks"].AsInt32();
+    layer_index = flexbuffer_map["layer_index"].AsInt32();
+  }
+  op_data->max_num_entries =
+      max_num_entries > 0 ? max_num_entries : kDefaultMaxNumCacheEntries;
+  op_data->block_size = block_size > 0 ? block_size : kDefaultBlockSize;
+  op_data->max_num_blocks =
+      max_num_blocks > 0 ? max_num_blocks : kDefaultMaxNumBlocks;
+  op_data->layer_index = layer_index > 0 ? layer_index : 0;
+  op_data->key_cache = nullptr;
+  op_data->value_cache = nullptr;
+  return op_data;
+}
+
+void PagedKVCacheFree(TfLiteContext* context, void* buffer) {
+  delete static_cast<OpData*>(buffer);
+}
+
+TfLiteStatus PagedKVCachePrepare(TfLiteContext* context, TfLiteNode* node) {
+  // position, k_slice, v_slice, sequence_id, parent_sequence_id
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 5);
+  // k_cache, v_cache, block_table
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 3);
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+
+  const TfLiteTensor* position;
+  const TfLiteTensor* k_slice;
+  const TfLiteTensor* v_slice;
+  const TfLiteTensor* sequence_id;
+  const TfLiteTensor* parent_sequence_id;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kPositionTensor, &position));
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kKeySliceTensor, &k_slice));
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kValueSliceTensor, &v_slice));
+  TF_LITE_ENSURE_OK(
+      context, GetInputSafe(context, node, kSequenceIdTensor, &sequence_id));
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node,
+                                          kParentSequenceIdTensor,
+                                          &parent_sequence_id));
+
+  TF_LITE_ENSURE_EQ(context, position->type, kTfLiteInt32);
+  TF_LITE_ENSURE_EQ(context, k_slice->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_EQ(context, v_slice->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_EQ(context, sequence_id->type, kTfLiteInt32);
+  TF_LITE_ENSURE_EQ(context, parent_sequence_id->type, kTfLiteInt32);
+  TF_LITE_ENSURE_EQ(context, NumElements(sequence_id), 1);
+  TF_LITE_ENSURE_EQ(context, NumElements(parent_sequence_id), 1);
+
+  // Support only (B, S, N, H) for now.
+  TF_LITE_ENSURE(context, NumDimensions(k_slice) == kRequiredNumDimensions);
+  TF_LITE_ENSURE(context, HaveSameShapes(k_slice, v_slice));
+  // Ensure Positions correspond to KV sequence length.
+  TF_LITE_ENSURE(context, NumDimensions(position) == 1);
+  TF_LITE_ENSURE(context, GetTensorShape(position).Dims(0) ==
+                              GetTensorShape(k_slice).Dims(1));
+  // Enforce Batch == 1 for now.
+  TF_LITE_ENSURE(context, GetTensorShape(k_slice).Dims(0) == 1);
+
+  TfLiteTensor* k_cache;
+  TfLiteTensor* v_cache;
+  TfLiteTensor* block_table;
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kKeyCacheTensor, &k_cache));
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kValueCacheTensor, &v_cache));
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kBlockTableTensor, &block_table));
+  k_cache->type = kTfLiteFloat32;
+  v_cache->type = kTfLiteFloat32;
+  block_table->type = kTfLiteInt32;
+
+  // The blocks persist across invocations in the subgraph resources; the
+  // outputs are contiguous views gathered from them on every invocation.
+  const int num_heads = k_slice->dims->data[2];
+  const int head_dim = k_slice->dims->data[3];
+  Subgraph* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  auto& resources = subgraph->resources();
+  const int key_id = PAGED_KVCACHE_RESOURCE_BASE + 2 * op_data->layer_index;
+  op_data->key_cache =
+      GetOrCreateCache(resources, key_id, *op_data, num_heads * head_dim);
+  op_data->value_cache =
+      GetOrCreateCache(resources, key_id + 1, *op_data, num_heads * head_dim);
+  TF_LITE_ENSURE(context, op_data->key_cache->IsInitialized());
+  TF_LITE_ENSURE(context, op_data->value_cache->IsInitialized());
+  TF_LITE_ENSURE_EQ(context, op_data->key_cache->entry_size(),
+                    num_heads * head_dim);
+  TF_LITE_ENSURE_EQ(context, op_data->value_cache->entry_size(),
+                    num_heads * head_dim);
+
+  TfLiteIntArray* kcache_dims = TfLiteIntArrayCopy(k_slice->dims);
+  kcache_dims->data[1] = op_data->max_num_entries;
+  TF_LITE_ENSURE_OK(context,
+                    context->ResizeTensor(context, k_cache, kcache_dims));
+  TF_LITE_ENSURE_OK(context, context->ResizeTensor(
+                                 context, v_cache,
+                                 TfLiteIntArrayCopy(k_cache->dims)));
+  TfLiteIntArray* block_table_dims = TfLiteIntArrayCreate(1);
+  block_table_dims->data[0] =
+      (op_data->max_num_entries + op_data->block_size - 1) /
+      op_data->block_size;
+  return context->ResizeTensor(context, block_table, block_table_dims);
+}
+
+TfLiteStatus PagedKVCacheEval(TfLiteContext* context, TfLiteNode* node) {
+  OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
+  const TfLiteTensor* position;
+  const TfLiteTensor* k_slice;
+  const TfLiteTensor* v_slice;
+  const TfLiteTensor* sequence_id_tensor;
+  const TfLiteTensor* parent_sequence_id_tensor;
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kPositionTensor, &position));
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kKeySliceTensor, &k_slice));
+  TF_LITE_ENSURE_OK(context,
+                    GetInputSafe(context, node, kValueSliceTensor, &v_slice));
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, kSequenceIdTensor,
+                                          &sequence_id_tensor));
+  TF_LITE_ENSURE_OK(context, GetInputSafe(context, node,
+                                          kParentSequenceIdTensor,
+                                          &parent_sequence_id_tensor));
+
+  TfLiteTensor* k_cache;
+  TfLiteTensor* v_cache;
+  TfLiteTensor* block_table;
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kKeyCacheTensor, &k_cache));
+  TF_LITE_ENSURE_OK(context,
+                    GetOutputSafe(context, node, kValueCacheTensor, &v_cache));
+  TF_LITE_ENSURE_OK(
+      context, GetOutputSafe(context, node, kBlockTableTensor, &block_table));
+
+  resource::PagedCacheBuffer* key_cache = op_data->key_cache;
+  resource::PagedCacheBuffer* value_cache = op_data->value_cache;
+  const int sequence_id = sequence_id_tensor->data.i32[0];
+  const int parent_sequence_id = parent_sequence_id_tensor->data.i32[0];
+  // A new sequence forked from a parent shares the parent's blocks until it
+  // writes to them, so a common prompt prefix is only stored once.
+  TF_LITE_ENSURE_OK(context,
+                    StartSequence(key_cache, sequence_id, parent_sequence_id));
+  TF_LITE_ENSURE_OK(
+      context, StartSequence(value_cache, sequence_id, parent_sequence_id));
+
+  const int elements_in_one_entry = key_cache->entry_size();
+  int32_t last_update_position = -1;
+  for (int i = 0; i < NumElements(position); ++i) {
+    const int32_t update_position = position->data.i32[i];
+    // Like the external KV cache, positions are increasing and a decrease
+    // marks the end of the valid update slices.
+    if (update_position < last_update_position) {
+      break;
+    }
+    last_update_position = update_position;
+    TF_LITE_ENSURE(context, update_position < op_data->max_num_entries);
+    float* key_entry =
+        key_cache->GetWritableEntry(sequence_id, update_position);
+    float* value_entry =
+        value_cache->GetWritableEntry(sequence_id, update_position);
+    if (key_entry == nullptr || value_entry == nullptr) {
+      TF_LITE_KERNEL_LOG(context, "The paged KV cache is out of blocks.");
+      return kTfLiteError;
+    }
+    const size_t update_offset = static_cast<size_t>(i) * elements_in_one_entry;
+    memcpy(key_entry, k_slice->data.f + update_offset,
+           elements_in_one_entry * sizeof(float));
+    memcpy(value_entry, v_slice->data.f + update_offset,
+           elements_in_one_entry * sizeof(float));
+  }
+
+  GatherCache(*key_cache, sequence_id, op_data->max_num_entries,
+              k_cache->data.f);
+  GatherCache(*value_cache, sequence_id, op_data->max_num_entries,
+              v_cache->data.f);
+  const std::vector<int>& table = key_cache->GetBlockTable(sequence_id);
+  const int num_table_entries = NumElements(block_table);
+  for (int i = 0; i < num_table_entries; ++i) {
+    block_table->data.i32[i] = i < table.size() ? table[i] : -1;
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace llm
+
+void ReleasePagedKVCacheSequence(resource::ResourceMap& resources,
+                                 int num_layers, int sequence_id) {
+  for (int id = llm::PAGED_KVCACHE_RESOURCE_BASE;
+       id < llm::PAGED_KVCACHE_RESOURCE_BASE + 2 * num_layers; ++id) {
+    auto it = resources.find(id);
+    if (it == resources.end()) continue;
+    static_cast<resource::PagedCacheBuffer*>(it->second.get())
+        ->ReleaseSequence(sequence_id);
+  }
+}
+
+TfLiteRegistration* Register_PAGED_KV_CACHE() {
+  static TfLiteRegistration r = {llm::PagedKVCacheInit, llm::PagedKVCacheFree,
+                                 llm::PagedKVCachePrepare,
+                                 llm::PagedKVCacheEval};
+  return &r;
+}
+
+}  // namespace custom
+}  // namespace ops
+}  // namespace tflite
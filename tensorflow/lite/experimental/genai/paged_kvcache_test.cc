@@ -0,0 +1,149 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "flatbuffers/flexbuffers.h"  // from @flatbuffers
+#include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/kernels/test_util.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+constexpr int kMaxNumEntries = 6;
+
+std::vector<uint8_t> PagedCacheOptions(int block_size, int max_num_blocks) {
+  flexbuffers::Builder fbb;
+  fbb.Map([&]() {
+    fbb.Int("kv_cache_max", kMaxNumEntries);
+    fbb.Int("block_size", block_size);
+    fbb.Int("max_num_blocks", max_num_blocks);
+  });
+  fbb.Finish();
+  return fbb.GetBuffer();
+}
+
+// Updates the paged cache of a model with a single head of size 1, so every
+// entry is a single value.
+class PagedCacheOpModel : public SingleOpModel {
+ public:
+  PagedCacheOpModel(int num_new_entries, int block_size, int max_num_blocks) {
+    pos_ = AddInput({TensorType_INT32, {num_new_entries}});
+    k_ = AddInput({TensorType_FLOAT32, {1, num_new_entries, 1, 1}});
+    v_ = AddInput({TensorType_FLOAT32, {1, num_new_entries, 1, 1}});
+    sequence_id_ = AddInput({TensorType_INT32, {1}});
+    parent_sequence_id_ = AddInput({TensorType_INT32, {1}});
+    k_cache_ = AddOutput(TensorType_FLOAT32);
+    v_cache_ = AddOutput(TensorType_FLOAT32);
+    block_table_ = AddOutput(TensorType_INT32);
+    SetCustomOp("Paged_KV_Cache", PagedCacheOptions(block_size, max_num_blocks),
+                ops::custom::Register_PAGED_KV_CACHE);
+    BuildInterpreter({GetShape(pos_), GetShape(k_), GetShape(v_),
+                      GetShape(sequence_id_), GetShape(parent_sequence_id_)});
+  }
+
+  TfLiteStatus Run(int sequence_id, int parent_sequence_id,
+                   const std::vector<int32_t>& positions,
+                   const std::vector<float>& keys) {
+    PopulateTensor(pos_, positions);
+    PopulateTensor(k_, keys);
+    std::vector<float> values;
+    for (float key : keys) values.push_back(-key);
+    PopulateTensor(v_, values);
+    PopulateTensor<int32_t>(sequence_id_, {sequence_id});
+    PopulateTensor<int32_t>(parent_sequence_id_, {parent_sequence_id});
+    return SingleOpModel::Invoke();
+  }
+
+  void Release(int sequence_id) {
+    ops::custom::ReleasePagedKVCacheSequence(
+        interpreter_->primary_subgraph().resources(), /*num_layers=*/1,
+        sequence_id);
+  }
+
+  std::vector<float> GetKCache() { return ExtractVector<float>(k_cache_); }
+  std::vector<float> GetVCache() { return ExtractVector<float>(v_cache_); }
+  std::vector<int32_t> GetBlockTable() {
+    return ExtractVector<int32_t>(block_table_);
+  }
+  std::vector<int> GetKCacheShape() { return GetTensorShape(k_cache_); }
+
+ private:
+  int pos_;
+  int k_;
+  int v_;
+  int sequence_id_;
+  int parent_sequence_id_;
+  int k_cache_;
+  int v_cache_;
+  int block_table_;
+};
+
+TEST(PagedCacheOpTest, AppendsEntriesToBlocks) {
+  PagedCacheOpModel m(/*num_new_entries=*/2, /*block_size=*/2,
+                      /*max_num_blocks=*/3);
+  ASSERT_EQ(m.Run(0, -1, {0, 1}, {1, 2}), kTfLiteOk);
+  EXPECT_THAT(m.GetKCacheShape(), ElementsAre(1, kMaxNumEntries, 1, 1));
+  EXPECT_THAT(m.GetKCache(), ElementsAreArray({1, 2, 0, 0, 0, 0}));
+  EXPECT_THAT(m.GetVCache(), ElementsAreArray({-1, -2, 0, 0, 0, 0}));
+  EXPECT_THAT(m.GetBlockTable(), ElementsAre(0, -1, -1));
+
+  // A decreasing position ends the valid entries of the update.
+  ASSERT_EQ(m.Run(0, -1, {2, 0}, {3, 9}), kTfLiteOk);
+  EXPECT_THAT(m.GetKCache(), ElementsAreArray({1, 2, 3, 0, 0, 0}));
+  EXPECT_THAT(m.GetBlockTable(), ElementsAre(0, 1, -1));
+}
+
+TEST(PagedCacheOpTest, ForkedSequenceSharesPrefix) {
+  PagedCacheOpModel m(/*num_new_entries=*/1, /*block_size=*/2,
+                      /*max_num_blocks=*/3);
+  ASSERT_EQ(m.Run(0, -1, {0}, {1}), kTfLiteOk);
+  ASSERT_EQ(m.Run(0, -1, {1}, {2}), kTfLiteOk);
+  ASSERT_EQ(m.Run(0, -1, {2}, {3}), kTfLiteOk);
+
+  // The fork writes to the shared second block, which gets copied.
+  ASSERT_EQ(m.Run(1, 0, {3}, {4}), kTfLiteOk);
+  EXPECT_THAT(m.GetKCache(), ElementsAreArray({1, 2, 3, 4, 0, 0}));
+  EXPECT_THAT(m.GetBlockTable(), ElementsAre(0, 2, -1));
+
+  ASSERT_EQ(m.Run(0, -1, {3}, {5}), kTfLiteOk);
+  EXPECT_THAT(m.GetKCache(), ElementsAreArray({1, 2, 3, 5, 0, 0}));
+  EXPECT_THAT(m.GetBlockTable(), ElementsAre(0, 1, -1));
+
+  // All the blocks are in use until a sequence is released.
+  EXPECT_EQ(m.Run(1, 0, {4}, {6}), kTfLiteError);
+  m.Release(0);
+  ASSERT_EQ(m.Run(1, 0, {4}, {6}), kTfLiteOk);
+  EXPECT_THAT(m.GetKCache(), ElementsAreArray({1, 2, 3, 4, 6, 0}));
+  EXPECT_THAT(m.GetVCache(), ElementsAreArray({-1, -2, -3, -4, -6, 0}));
+}
+
+TEST(PagedCacheOpTest, FailsToForkUnknownSequence) {
+  PagedCacheOpModel m(/*num_new_entries=*/1, /*block_size=*/2,
+                      /*max_num_blocks=*/3);
+  EXPECT_EQ(m.Run(1, 0, {0}, {1}), kTfLiteError);
+}
+
+}  // namespace
+}  // namespace tflite
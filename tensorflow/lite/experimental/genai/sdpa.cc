@@ -62,6 +62,58 @@ struct OpData {
   int scratch_tensor_index;
 };
 
+namespace {
+
+// Checks that `tensor` is float32, or int8 with one symmetric scale per head
+// or a single one, like the caches of the quantized KV cache op.
+TfLiteStatus CheckKeyOrValueTensor(TfLiteContext* context,
+                                   const TfLiteTensor* tensor) {
+  if (tensor->type == kTfLiteFloat32) return kTfLiteOk;
+  TF_LITE_ENSURE_EQ(context, tensor->type, kTfLiteInt8);
+  TF_LITE_ENSURE_EQ(context, tensor->quantization.type,
+                    kTfLiteAffineQuantization);
+  const auto* params = static_cast<const TfLiteAffineQuantization*>(
+      tensor->quantization.params);
+  TF_LITE_ENSURE(context, params != nullptr && params->scale != nullptr);
+  TF_LITE_ENSURE(context, params->scale->size == 1 ||
+                              (params->quantized_dimension == 2 &&
+                               params->scale->size == tensor->dims->data[2]));
+  return kTfLiteOk;
+}
+
+// Dequantizes the int8 (B, S, N, H) `tensor` while permuting it to
+// (B, N, S, H), or to (B, N, H, S) if `sequence_last`. Folding the
+// dequantization into the transposes the attention does anyway means a
+// quantized KV cache is only ever read as int8.
+void DequantizeTranspose(const TfLiteTensor* tensor, bool sequence_last,
+                         float* output) {
+  const RuntimeShape shape = GetTensorShape(tensor);
+  const int batches = shape.Dims(0);
+  const int sequence_length = shape.Dims(1);
+  const int num_heads = shape.Dims(2);
+  const int head_dim = shape.Dims(3);
+  const auto* params = static_cast<const TfLiteAffineQuantization*>(
+      tensor->quantization.params);
+  const int8_t* input = GetTensorData<int8_t>(tensor);
+  for (int b = 0; b < batches; ++b) {
+    for (int s = 0; s < sequence_length; ++s) {
+      for (int n = 0; n < num_heads; ++n) {
+        const float scale =
+            params->scale->data[params->scale->size == 1 ? 0 : n];
+        const int8_t* values =
+            input + ((b * sequence_length + s) * num_heads + n) * head_dim;
+        float* out = output + (b * num_heads + n) * head_dim * sequence_length;
+        for (int h = 0; h < head_dim; ++h) {
+          out[sequence_last ? h * sequence_length + s : s * head_dim + h] =
+              values[h] * scale;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 void* SDPAInit(TfLiteContext* context, const char* buffer, size_t length) {
   OpData* op_data = new OpData();
   op_data->scale = 0.0f;
@@ -91,6 +143,9 @@ TfLiteStatus SDPAPrepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumDimensions(v_tensor),
                     NumDimensions(mask_tensor));
   TF_LITE_ENSURE_EQ(context, NumDimensions(mask_tensor), 4);
+  TF_LITE_ENSURE_EQ(context, q_tensor->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_OK(context, CheckKeyOrValueTensor(context, k_tensor));
+  TF_LITE_ENSURE_OK(context, CheckKeyOrValueTensor(context, v_tensor));
 
   // Get custom op params
   const uint8_t* buffer =
@@ -367,7 +422,8 @@ TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
   Notes:
   Scale is computed using 1/sqrt(head_dim),
   head_dim = q[-1] = embedding_dim // num_q_heads
-  Only support for FLOAT32 inputs for now.
+  Only support for FLOAT32 inputs for now, except for key and value which can
+  also be INT8 with per-head scales (e.g. a quantized KV cache).
   Only support static tensors for now (k/v[1] = max sequence length)
   */
 
@@ -500,8 +556,13 @@ TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
   transpose_k_params.perm[1] = 2;
   transpose_k_params.perm[2] = 1;
   transpose_k_params.perm[3] = 3;
-  reference_ops::Transpose(transpose_k_params, key_shape, key_data,
-                           transpose_k_out_shape, transpose_k_out_data);
+  if (key_tensor->type == kTfLiteInt8) {
+    DequantizeTranspose(key_tensor, /*sequence_last=*/false,
+                        transpose_k_out_data);
+  } else {
+    reference_ops::Transpose(transpose_k_params, key_shape, key_data,
+                             transpose_k_out_shape, transpose_k_out_data);
+  }
 
   // broadcast k to match num_heads
   // broadcasting similar to torch.repeat_interleave
@@ -584,8 +645,13 @@ TfLiteStatus SDPAEval(TfLiteContext* context, TfLiteNode* node) {
   transpose_v_params.perm[1] = 2;
   transpose_v_params.perm[2] = 3;
   transpose_v_params.perm[3] = 1;
-  reference_ops::Transpose(transpose_v_params, value_shape, value_data,
-                           transpose_v_out_shape, transpose_v_out_data);
+  if (value_tensor->type == kTfLiteInt8) {
+    DequantizeTranspose(value_tensor, /*sequence_last=*/true,
+                        transpose_v_out_data);
+  } else {
+    reference_ops::Transpose(transpose_v_params, value_shape, value_data,
+                             transpose_v_out_shape, transpose_v_out_data);
+  }
 
   // broadcast v to match num_heads
   // broadcasting similar to torch.repeat_interleave
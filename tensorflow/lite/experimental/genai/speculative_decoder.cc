@@ -0,0 +1,210 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/genai/speculative_decoder.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/signature_runner.h"
+#include "tensorflow/lite/experimental/genai/genai_ops.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/logger.h"
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite {
+namespace genai {
+namespace {
+
+// Writes `values` to the int32 or int64 `tensor`.
+bool SetIntValues(TfLiteTensor* tensor, const std::vector<int>& values) {
+  if (tensor == nullptr || NumElements(tensor) != values.size()) return false;
+  for (int i = 0; i < values.size(); ++i) {
+    if (tensor->type == kTfLiteInt32) {
+      tensor->data.i32[i] = values[i];
+    } else if (tensor->type == kTfLiteInt64) {
+      tensor->data.i64[i] = values[i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks that the signature of `runner` takes `num_tokens` tokens and returns
+// float logits of a single batch for each of them.
+bool HasExpectedShapes(SignatureRunner* runner,
+                       const SpeculativeDecoder::Options& options,
+                       int num_tokens) {
+  const TfLiteTensor* tokens = runner->input_tensor(options.tokens_name);
+  const TfLiteTensor* input_pos = runner->input_tensor(options.input_pos_name);
+  const TfLiteTensor* logits = runner->output_tensor(options.logits_name);
+  return tokens != nullptr && input_pos != nullptr && logits != nullptr &&
+         NumElements(tokens) == num_tokens &&
+         NumElements(input_pos) == num_tokens &&
+         logits->type == kTfLiteFloat32 && logits->dims->size == 3 &&
+         logits->dims->data[0] == 1 && logits->dims->data[1] == num_tokens;
+}
+
+}  // namespace
+
+int ArgMax(const float* logits, int vocab_size) {
+  int best = 0;
+  for (int i = 1; i < vocab_size; ++i) {
+    if (logits[i] > logits[best]) best = i;
+  }
+  return best;
+}
+
+int VerifyDraftTokens(const std::vector<int>& draft_tokens,
+                      const float* target_logits, int vocab_size,
+                      std::vector<int>* output) {
+  int num_accepted = 0;
+  for (int token : draft_tokens) {
+    const int expected =
+        ArgMax(target_logits + num_accepted * vocab_size, vocab_size);
+    if (token != expected) break;
+    output->push_back(token);
+    ++num_accepted;
+  }
+  // The target logits after the last accepted token give one more token for
+  // free: the correction of the first rejected draft token, or the token
+  // following all of them.
+  output->push_back(
+      ArgMax(target_logits + num_accepted * vocab_size, vocab_size));
+  return num_accepted;
+}
+
+std::unique_ptr<SpeculativeDecoder> SpeculativeDecoder::Create(
+    Interpreter* draft, const char* draft_signature_key, Interpreter* target,
+    const char* target_signature_key, const Options& options) {
+  if (draft == nullptr || target == nullptr || options.num_draft_tokens < 1) {
+    return nullptr;
+  }
+  SignatureRunner* draft_runner =
+      draft->GetSignatureRunner(draft_signature_key);
+  SignatureRunner* target_runner =
+      target->GetSignatureRunner(target_signature_key);
+  if (draft_runner == nullptr || target_runner == nullptr) {
+    TFLITE_LOG(tflite::TFLITE_LOG_ERROR,
+               "Speculative decoding signatures not found.");
+    return nullptr;
+  }
+
+  // The target model verifies the last decoded token and the draft tokens in
+  // one invocation.
+  const int num_verified_tokens = options.num_draft_tokens + 1;
+  if (target_runner->ResizeInputTensor(options.tokens_name,
+                                       {1, num_verified_tokens}) !=
+          kTfLiteOk ||
+      target_runner->ResizeInputTensor(options.input_pos_name,
+                                       {num_verified_tokens}) != kTfLiteOk ||
+      draft_runner->AllocateTensors() != kTfLiteOk ||
+      target_runner->AllocateTensors() != kTfLiteOk) {
+    return nullptr;
+  }
+  if (!HasExpectedShapes(draft_runner, options, 1) ||
+      !HasExpectedShapes(target_runner, options, num_verified_tokens)) {
+    TFLITE_LOG(tflite::TFLITE_LOG_ERROR,
+               "Speculative decoding signatures have unexpected shapes.");
+    return nullptr;
+  }
+  const int vocab_size =
+      draft_runner->output_tensor(options.logits_name)->dims->data[2];
+  if (target_runner->output_tensor(options.logits_name)->dims->data[2] !=
+      vocab_size) {
+    TFLITE_LOG(tflite::TFLITE_LOG_ERROR,
+               "Draft and target models have different vocabularies.");
+    return nullptr;
+  }
+  return std::unique_ptr<SpeculativeDecoder>(new SpeculativeDecoder(
+      draft, draft_runner, target, target_runner, options, vocab_size));
+}
+
+SpeculativeDecoder::SpeculativeDecoder(Interpreter* draft,
+                                       SignatureRunner* draft_runner,
+                                       Interpreter* target,
+                                       SignatureRunner* target_runner,
+                                       const Options& options, int vocab_size)
+    : draft_(draft),
+      draft_runner_(draft_runner),
+      target_(target),
+      target_runner_(target_runner),
+      options_(options),
+      vocab_size_(vocab_size) {}
+
+TfLiteStatus SpeculativeDecoder::RunDraft(int token, int position,
+                                          int* next_token) {
+  if (!SetIntValues(draft_runner_->input_tensor(options_.tokens_name),
+                    {token}) ||
+      !SetIntValues(draft_runner_->input_tensor(options_.input_pos_name),
+                    {position})) {
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_STATUS(draft_runner_->Invoke());
+  const TfLiteTensor* logits =
+      draft_runner_->output_tensor(options_.logits_name);
+  *next_token = ArgMax(logits->data.f, vocab_size_);
+  return kTfLiteOk;
+}
+
+TfLiteStatus SpeculativeDecoder::Step(int token, int position,
+                                      std::vector<int>* output) {
+  const int num_draft_tokens = options_.num_draft_tokens;
+
+  // 1. Propose the draft tokens, which stores `token` and all but the last
+  //    draft token in the draft cache.
+  draft_tokens_.clear();
+  int next_token = token;
+  for (int i = 0; i < num_draft_tokens; ++i) {
+    TF_LITE_ENSURE_STATUS(RunDraft(next_token, position + i, &next_token));
+    draft_tokens_.push_back(next_token);
+  }
+
+  // 2. Verify them with a single invocation of the target model.
+  std::vector<int> tokens = {token};
+  tokens.insert(tokens.end(), draft_tokens_.begin(), draft_tokens_.end());
+  std::vector<int> positions(tokens.size());
+  for (int i = 0; i < positions.size(); ++i) positions[i] = position + i;
+  if (!SetIntValues(target_runner_->input_tensor(options_.tokens_name),
+                    tokens) ||
+      !SetIntValues(target_runner_->input_tensor(options_.input_pos_name),
+                    positions)) {
+    return kTfLiteError;
+  }
+  TF_LITE_ENSURE_STATUS(target_runner_->Invoke());
+  const int num_accepted = VerifyDraftTokens(
+      draft_tokens_,
+      target_runner_->output_tensor(options_.logits_name)->data.f,
+      vocab_size_, output);
+
+  // 3. Keep `token` and the accepted draft tokens in the caches only.
+  const int num_kept_entries = position + num_accepted + 1;
+  TF_LITE_ENSURE_STATUS(ops::custom::TruncateKVCache(
+      target_->primary_subgraph().resources(), num_kept_entries));
+  if (num_accepted < num_draft_tokens) {
+    return ops::custom::TruncateKVCache(draft_->primary_subgraph().resources(),
+                                        num_kept_entries);
+  }
+  // All draft tokens were accepted, but the draft model hasn't seen the last
+  // one yet.
+  return RunDraft(draft_tokens_.back(), position + num_draft_tokens,
+                  &next_token);
+}
+
+}  // namespace genai
+}  // namespace tflite
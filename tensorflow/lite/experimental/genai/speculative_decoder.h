@@ -0,0 +1,99 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_GENAI_SPECULATIVE_DECODER_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_GENAI_SPECULATIVE_DECODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/signature_runner.h"
+
+namespace tflite {
+namespace genai {
+
+// Returns the index of the largest of the `vocab_size` values of `logits`.
+int ArgMax(const float* logits, int vocab_size);
+
+// Greedily verifies `draft_tokens` against `target_logits`, the logits the
+// target model computed for the last decoded token followed by the draft
+// tokens: `draft_tokens.size() + 1` rows of `vocab_size` values.
+//
+// Appends the draft tokens the target model agrees with, followed by the
+// target model's own next token, to `output`. Returns the number of accepted
+// draft tokens.
+int VerifyDraftTokens(const std::vector<int>& draft_tokens,
+                      const float* target_logits, int vocab_size,
+                      std::vector<int>* output);
+
+// Speculative decoding with a small draft model and a large target model,
+// both using the "odml.update_kv_cache" op for their caches.
+//
+// Every step, the draft model proposes `num_draft_tokens` tokens one at a
+// time, then the target model verifies all of them in a single invocation.
+// The rejected entries are dropped from both KV caches, so the next step
+// continues right after the last accepted token.
+//
+// The draft signature takes one token at a time. The token and position
+// inputs of the target signature are resized to `num_draft_tokens + 1`
+// entries. The caches must not overflow, since the positions are also the
+// cache slots rolled back to.
+/// WARNING: Experimental interface, subject to change.
+class SpeculativeDecoder {
+ public:
+  struct Options {
+    // The number of tokens the draft model proposes per step.
+    int num_draft_tokens = 4;
+    // The input and output names of both signatures.
+    const char* tokens_name = "tokens";
+    const char* input_pos_name = "input_pos";
+    const char* logits_name = "logits";
+  };
+
+  // Returns nullptr if a signature or tensor is missing or doesn't have the
+  // expected type and shape.
+  static std::unique_ptr<SpeculativeDecoder> Create(
+      Interpreter* draft, const char* draft_signature_key, Interpreter* target,
+      const char* target_signature_key, const Options& options);
+
+  // Decodes after `token`, the last decoded token, which is at `position` and
+  // is not in the caches yet. Appends between 1 and `num_draft_tokens + 1`
+  // tokens to `output`; the next step starts from the last of them at
+  // `position` plus the number of appended tokens.
+  TfLiteStatus Step(int token, int position, std::vector<int>* output);
+
+ private:
+  SpeculativeDecoder(Interpreter* draft, SignatureRunner* draft_runner,
+                     Interpreter* target, SignatureRunner* target_runner,
+                     const Options& options, int vocab_size);
+
+  // Runs the draft model on `token` at `position`, storing it in the draft
+  // cache, and returns the most likely next token in `next_token`.
+  TfLiteStatus RunDraft(int token, int position, int* next_token);
+
+  Interpreter* draft_;
+  SignatureRunner* draft_runner_;
+  Interpreter* target_;
+  SignatureRunner* target_runner_;
+  Options options_;
+  int vocab_size_;
+  std::vector<int> draft_tokens_;
+};
+
+}  // namespace genai
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_GENAI_SPECULATIVE_DECODER_H_
@@ -0,0 +1,79 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/genai/speculative_decoder.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace genai {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr int kVocabSize = 4;
+
+// Returns logits with one row per token in `tokens`, each peaking at that
+// token.
+std::vector<float> PeakedLogits(const std::vector<int>& tokens) {
+  std::vector<float> logits(tokens.size() * kVocabSize, 0.0f);
+  for (int i = 0; i < tokens.size(); ++i) {
+    logits[i * kVocabSize + tokens[i]] = 1.0f;
+  }
+  return logits;
+}
+
+TEST(SpeculativeDecoderTest, ArgMax) {
+  const float logits[kVocabSize] = {0.5f, -1.0f, 2.0f, 2.0f};
+  EXPECT_EQ(ArgMax(logits, kVocabSize), 2);
+  EXPECT_EQ(ArgMax(logits, 2), 0);
+}
+
+TEST(SpeculativeDecoderTest, AcceptsAllMatchingDraftTokens) {
+  const std::vector<float> logits = PeakedLogits({1, 2, 3, 0});
+  std::vector<int> output;
+  EXPECT_EQ(VerifyDraftTokens({1, 2, 3}, logits.data(), kVocabSize, &output),
+            3);
+  // The last row gives one more token.
+  EXPECT_THAT(output, ElementsAre(1, 2, 3, 0));
+}
+
+TEST(SpeculativeDecoderTest, StopsAtFirstRejectedDraftToken) {
+  const std::vector<float> logits = PeakedLogits({1, 3, 2, 0});
+  std::vector<int> output = {7};
+  EXPECT_EQ(VerifyDraftTokens({1, 2, 2}, logits.data(), kVocabSize, &output),
+            1);
+  // The target model's token replaces the rejected one.
+  EXPECT_THAT(output, ElementsAre(7, 1, 3));
+}
+
+TEST(SpeculativeDecoderTest, RejectsFirstDraftToken) {
+  const std::vector<float> logits = PeakedLogits({2, 2});
+  std::vector<int> output;
+  EXPECT_EQ(VerifyDraftTokens({1}, logits.data(), kVocabSize, &output), 0);
+  EXPECT_THAT(output, ElementsAre(2));
+}
+
+TEST(SpeculativeDecoderTest, CreateFailsWithoutInterpreters) {
+  EXPECT_EQ(SpeculativeDecoder::Create(nullptr, "decode", nullptr, "verify",
+                                       SpeculativeDecoder::Options()),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace genai
+}  // namespace tflite
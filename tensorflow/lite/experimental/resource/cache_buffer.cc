@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/lite/experimental/resource/cache_buffer.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 
@@ -27,11 +28,18 @@ namespace tflite {
 namespace resource {
 
 TfLiteStatus CacheBuffer::Initialize(const TfLiteIntArray& shape) {
+  return Initialize(shape, kTfLiteFloat32);
+}
+
+TfLiteStatus CacheBuffer::Initialize(const TfLiteIntArray& shape,
+                                     TfLiteType type) {
+  if (type != kTfLiteFloat32 && type != kTfLiteInt8) return kTfLiteError;
   // Set the dims and allocate the memory.
   dims_ = TfLiteIntArrayCopy(&shape);
-  const size_t buf_size = NumElements(&shape);
-  buffer_.reset(new float[buf_size]);
-  memset(buffer_.get(), 0, sizeof(float) * buf_size);
+  type_ = type;
+  const size_t buf_size = GetSize();
+  buffer_.reset(new float[(buf_size + sizeof(float) - 1) / sizeof(float)]);
+  memset(buffer_.get(), 0, buf_size);
 
   num_entries_.reset(new size_t[shape.data[1]]);
   memset(num_entries_.get(), 0, sizeof(size_t) * shape.data[1]);
@@ -39,7 +47,11 @@ TfLiteStatus CacheBuffer::Initialize(const TfLiteIntArray& shape) {
   return kTfLiteOk;
 }
 
-size_t CacheBuffer::GetSize() { return sizeof(float) * NumElements(dims_); }
+size_t CacheBuffer::GetSize() {
+  const size_t element_size =
+      type_ == kTfLiteInt8 ? sizeof(int8_t) : sizeof(float);
+  return element_size * NumElements(dims_);
+}
 
 size_t CacheBuffer::GetNumEntries(int idx) const { return num_entries_[idx]; }
 
@@ -52,5 +64,21 @@ void CacheBuffer::SetNumEntries(int idx, size_t count) {
   num_entries_[idx] = count;
 }
 
+void CacheBuffer::Truncate(int idx, size_t count) {
+  if (count >= num_entries_[idx]) return;
+  const size_t element_size =
+      type_ == kTfLiteInt8 ? sizeof(int8_t) : sizeof(float);
+  const size_t max_num_entries = dims_->data[2];
+  const size_t entry_bytes = element_size * dims_->data[3] * dims_->data[4];
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(buffer_.get());
+  for (int batch = 0; batch < dims_->data[0]; ++batch) {
+    const size_t layer_offset =
+        (static_cast<size_t>(batch) * GetNumLayers() + idx) * max_num_entries;
+    memset(buffer + (layer_offset + count) * entry_bytes, 0,
+           (num_entries_[idx] - count) * entry_bytes);
+  }
+  num_entries_[idx] = count;
+}
+
 }  // namespace resource
 }  // namespace tflite
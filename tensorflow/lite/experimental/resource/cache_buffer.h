@@ -38,18 +38,29 @@ class CacheBuffer : public ResourceVariable {
   CacheBuffer &operator=(const CacheBuffer &) = delete;
   // Initialize tensor of a certain shape using the provided type.
   TfLiteStatus Initialize(const TfLiteIntArray &shape);
+  // Same as above, but stores elements of `type`. Only kTfLiteFloat32 and
+  // kTfLiteInt8 are supported.
+  TfLiteStatus Initialize(const TfLiteIntArray &shape, TfLiteType type);
+  // Returns the type of the stored elements.
+  TfLiteType GetType() const { return type_; }
   size_t GetNumEntries(int idx) const;
   float *GetBuffer();
   size_t GetSize();
   void SetNumEntries(int idx, size_t count);
+  // Returns the number of layers, each with its own entries.
+  int GetNumLayers() const { return dims_->data[1]; }
+  // Drops the entries of layer `idx` past the first `count` ones and zeroes
+  // them, e.g. to roll back speculatively decoded tokens.
+  void Truncate(int idx, size_t count);
 
  private:
   // The number of entries currently used in the buffer;
   std::unique_ptr<size_t[]> num_entries_;
-  // The float buffer for storage. Has shape:
+  // The buffer for storage, holding elements of `type_`. Has shape:
   // <batch, num layers, seq length, num heads, head dim>
   std::unique_ptr<float[]> buffer_;
-  TfLiteIntArray *dims_;
+  TfLiteIntArray *dims_ = nullptr;
+  TfLiteType type_ = kTfLiteFloat32;
 };
 
 }  // namespace resource
@@ -40,5 +40,63 @@ TEST(CacheBufferTest, Initialize) {
   TfLiteIntArrayFree(shape);
 }
 
+TEST(CacheBufferTest, InitializeInt8) {
+  TfLiteIntArray* shape = TfLiteIntArrayCreate(4);
+  shape->data[0] = 1;
+  shape->data[1] = 3;
+  shape->data[2] = 5;
+  shape->data[3] = 7;
+
+  CacheBuffer cache_buffer;
+  ASSERT_EQ(cache_buffer.Initialize(*shape, kTfLiteInt8), kTfLiteOk);
+
+  EXPECT_EQ(cache_buffer.GetType(), kTfLiteInt8);
+  EXPECT_EQ(cache_buffer.GetSize(), 105);
+  ASSERT_NE(cache_buffer.GetBuffer(), nullptr);
+  EXPECT_EQ(cache_buffer.GetNumEntries(2), 0);
+  TfLiteIntArrayFree(shape);
+}
+
+TEST(CacheBufferTest, InitializeUnsupportedType) {
+  TfLiteIntArray* shape = TfLiteIntArrayCreate(2);
+  shape->data[0] = 1;
+  shape->data[1] = 3;
+
+  CacheBuffer cache_buffer;
+  EXPECT_EQ(cache_buffer.Initialize(*shape, kTfLiteInt16), kTfLiteError);
+  TfLiteIntArrayFree(shape);
+}
+
+TEST(CacheBufferTest, Truncate) {
+  // <batch, num layers, seq length, num heads, head dim>
+  TfLiteIntArray* shape = TfLiteIntArrayCreate(5);
+  shape->data[0] = 1;
+  shape->data[1] = 2;
+  shape->data[2] = 4;
+  shape->data[3] = 1;
+  shape->data[4] = 2;
+
+  CacheBuffer cache_buffer;
+  ASSERT_EQ(cache_buffer.Initialize(*shape), kTfLiteOk);
+  EXPECT_EQ(cache_buffer.GetNumLayers(), 2);
+  float* buffer = cache_buffer.GetBuffer();
+  for (int i = 0; i < 16; ++i) buffer[i] = i + 1;
+  cache_buffer.SetNumEntries(0, 4);
+  cache_buffer.SetNumEntries(1, 4);
+
+  cache_buffer.Truncate(1, 1);
+  EXPECT_EQ(cache_buffer.GetNumEntries(0), 4);
+  EXPECT_EQ(cache_buffer.GetNumEntries(1), 1);
+  // Layer 0 is untouched, layer 1 keeps its first entry.
+  EXPECT_EQ(buffer[7], 8);
+  EXPECT_EQ(buffer[9], 10);
+  for (int i = 10; i < 16; ++i) EXPECT_EQ(buffer[i], 0);
+
+  // Truncating past the current entries is a no-op.
+  cache_buffer.Truncate(1, 3);
+  EXPECT_EQ(cache_buffer.GetNumEntries(1), 1);
+  TfLiteIntArrayFree(shape);
+}
+
 }  // namespace resource
 }  // namespace tflite
@@ -0,0 +1,161 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace resource {
+
+TfLiteStatus PagedCacheBuffer::Initialize(int block_size, int entry_size,
+                                          int max_num_blocks) {
+  if (block_size <= 0 || entry_size <= 0 || max_num_blocks <= 0) {
+    return kTfLiteError;
+  }
+  block_size_ = block_size;
+  entry_size_ = entry_size;
+  max_num_blocks_ = max_num_blocks;
+  return kTfLiteOk;
+}
+
+size_t PagedCacheBuffer::GetMemoryUsage() {
+  size_t num_allocated_blocks = 0;
+  for (const Block& block : blocks_) {
+    if (block.data != nullptr) ++num_allocated_blocks;
+  }
+  return num_allocated_blocks * block_size_ * entry_size_ * sizeof(float);
+}
+
+bool PagedCacheBuffer::HasSequence(int sequence_id) const {
+  return block_tables_.count(sequence_id) != 0;
+}
+
+TfLiteStatus PagedCacheBuffer::CreateSequence(int sequence_id) {
+  if (!block_tables_.emplace(sequence_id, std::vector<int>()).second) {
+    return kTfLiteError;
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus PagedCacheBuffer::ForkSequence(int parent_id, int sequence_id) {
+  auto parent = block_tables_.find(parent_id);
+  if (parent == block_tables_.end() || HasSequence(sequence_id)) {
+    return kTfLiteError;
+  }
+  // Copy the table before inserting, which may invalidate `parent`.
+  std::vector<int> block_table = parent->second;
+  for (int block : block_table) {
+    if (block >= 0) ++blocks_[block].ref_count;
+  }
+  block_tables_.emplace(sequence_id, std::move(block_table));
+  return kTfLiteOk;
+}
+
+void PagedCacheBuffer::ReleaseSequence(int sequence_id) {
+  auto it = block_tables_.find(sequence_id);
+  if (it == block_tables_.end()) return;
+  for (int block : it->second) {
+    if (block >= 0) ReleaseBlock(block);
+  }
+  block_tables_.erase(it);
+}
+
+int PagedCacheBuffer::AllocateBlock() {
+  int block;
+  if (!free_blocks_.empty()) {
+    block = free_blocks_.back();
+    free_blocks_.pop_back();
+  } else if (blocks_.size() < max_num_blocks_) {
+    block = blocks_.size();
+    blocks_.emplace_back();
+    blocks_[block].data.reset(new float[block_size_ * entry_size_]);
+  } else {
+    return -1;
+  }
+  memset(blocks_[block].data.get(), 0,
+         sizeof(float) * block_size_ * entry_size_);
+  blocks_[block].ref_count = 1;
+  return block;
+}
+
+void PagedCacheBuffer::ReleaseBlock(int block) {
+  if (--blocks_[block].ref_count == 0) {
+    free_blocks_.push_back(block);
+  }
+}
+
+float* PagedCacheBuffer::GetWritableEntry(int sequence_id, int position) {
+  auto it = block_tables_.find(sequence_id);
+  if (it == block_tables_.end() || position < 0) return nullptr;
+  std::vector<int>& block_table = it->second;
+  const int index = position / block_size_;
+  if (index >= block_table.size()) block_table.resize(index + 1, -1);
+
+  int& block = block_table[index];
+  if (block < 0) {
+    block = AllocateBlock();
+    if (block < 0) return nullptr;
+  } else if (blocks_[block].ref_count > 1) {
+    // Copy on write.
+    const int copy = AllocateBlock();
+    if (copy < 0) return nullptr;
+    memcpy(blocks_[copy].data.get(), blocks_[block].data.get(),
+           sizeof(float) * block_size_ * entry_size_);
+    ReleaseBlock(block);
+    block = copy;
+  }
+  return blocks_[block].data.get() +
+         (position % block_size_) * static_cast<size_t>(entry_size_);
+}
+
+void PagedCacheBuffer::Gather(int sequence_id, int num_entries,
+                              float* output) const {
+  const std::vector<int>& block_table = GetBlockTable(sequence_id);
+  for (int first = 0; first < num_entries; first += block_size_) {
+    const int index = first / block_size_;
+    const size_t count =
+        static_cast<size_t>(std::min(block_size_, num_entries - first)) *
+        entry_size_;
+    float* destination = output + static_cast<size_t>(first) * entry_size_;
+    if (index < block_table.size() && block_table[index] >= 0) {
+      memcpy(destination, blocks_[block_table[index]].data.get(),
+             sizeof(float) * count);
+    } else {
+      memset(destination, 0, sizeof(float) * count);
+    }
+  }
+}
+
+const std::vector<int>& PagedCacheBuffer::GetBlockTable(
+    int sequence_id) const {
+  static const std::vector<int>* const kEmpty = new std::vector<int>();
+  auto it = block_tables_.find(sequence_id);
+  return it == block_tables_.end() ? *kEmpty : it->second;
+}
+
+int PagedCacheBuffer::NumUsedBlocks() const {
+  return blocks_.size() - free_blocks_.size();
+}
+
+}  // namespace resource
+}  // namespace tflite
@@ -0,0 +1,107 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+#define TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/experimental/resource/resource_base.h"
+
+namespace tflite {
+namespace resource {
+
+// A cache whose entries are stored in fixed-size blocks of `block_size`
+// entries, so memory grows with the entries actually written rather than
+// with the maximum sequence length.
+//
+// Entries belong to sequences (e.g. the conversations of several sessions).
+// Each sequence maps its positions to blocks through a block table. A
+// sequence forked from another one shares all its blocks; shared blocks are
+// copied when written to, so a common prompt prefix is stored only once.
+//
+// Blocks come from a pool of at most `max_num_blocks` blocks. They are
+// allocated on first use and recycled when no sequence references them.
+/// WARNING: Experimental interface, subject to change.
+class PagedCacheBuffer : public ResourceBase {
+ public:
+  PagedCacheBuffer() = default;
+  PagedCacheBuffer(const PagedCacheBuffer &) = delete;
+  PagedCacheBuffer &operator=(const PagedCacheBuffer &) = delete;
+
+  // Sets up blocks of `block_size` entries of `entry_size` floats each.
+  TfLiteStatus Initialize(int block_size, int entry_size, int max_num_blocks);
+
+  bool IsInitialized() override { return block_size_ > 0; }
+
+  // Returns the size of the allocated blocks in bytes.
+  size_t GetMemoryUsage() override;
+
+  int block_size() const { return block_size_; }
+  int entry_size() const { return entry_size_; }
+
+  bool HasSequence(int sequence_id) const;
+
+  // Creates an empty sequence. Fails if `sequence_id` is in use.
+  TfLiteStatus CreateSequence(int sequence_id);
+
+  // Creates `sequence_id` as a copy of `parent_id` that shares its blocks.
+  TfLiteStatus ForkSequence(int parent_id, int sequence_id);
+
+  // Drops `sequence_id` and releases its blocks.
+  void ReleaseSequence(int sequence_id);
+
+  // Returns the entry at `position` of `sequence_id` for writing, allocating
+  // its block or copying it if it is shared with other sequences. Returns
+  // nullptr if the sequence does not exist or the pool is exhausted.
+  float *GetWritableEntry(int sequence_id, int position);
+
+  // Copies the first `num_entries` entries of `sequence_id` to `output`.
+  // Entries of blocks that were never written are zeros.
+  void Gather(int sequence_id, int num_entries, float *output) const;
+
+  // Returns the block table of `sequence_id`: the block index of each range of
+  // `block_size` positions, or -1 for ranges that were never written.
+  const std::vector<int> &GetBlockTable(int sequence_id) const;
+
+  // Returns the number of blocks currently referenced by sequences.
+  int NumUsedBlocks() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<float[]> data;
+    int ref_count = 0;
+  };
+
+  // Returns a free block with a reference count of one, or -1 if the pool is
+  // exhausted.
+  int AllocateBlock();
+  void ReleaseBlock(int block);
+
+  int block_size_ = 0;
+  int entry_size_ = 0;
+  int max_num_blocks_ = 0;
+  std::vector<Block> blocks_;
+  std::vector<int> free_blocks_;
+  std::unordered_map<int, std::vector<int>> block_tables_;
+};
+
+}  // namespace resource
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_EXPERIMENTAL_RESOURCE_PAGED_CACHE_BUFFER_H_
@@ -0,0 +1,116 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/experimental/resource/paged_cache_buffer.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/lite/c/common.h"
+
+namespace tflite {
+namespace resource {
+
+using ::testing::ElementsAre;
+
+TEST(PagedCacheBufferTest, AllocatesBlocksOnWrite) {
+  PagedCacheBuffer cache;
+  EXPECT_FALSE(cache.IsInitialized());
+  EXPECT_EQ(cache.Initialize(/*block_size=*/2, /*entry_size=*/1,
+                             /*max_num_blocks=*/4),
+            kTfLiteOk);
+  EXPECT_TRUE(cache.IsInitialized());
+  ASSERT_EQ(cache.CreateSequence(0), kTfLiteOk);
+  EXPECT_EQ(cache.CreateSequence(0), kTfLiteError);
+  EXPECT_EQ(cache.GetMemoryUsage(), 0);
+
+  *cache.GetWritableEntry(0, 0) = 1.0f;
+  *cache.GetWritableEntry(0, 1) = 2.0f;
+  EXPECT_EQ(cache.GetMemoryUsage(), 2 * sizeof(float));
+  *cache.GetWritableEntry(0, 4) = 5.0f;
+  EXPECT_EQ(cache.GetMemoryUsage(), 4 * sizeof(float));
+  EXPECT_THAT(cache.GetBlockTable(0), ElementsAre(0, -1, 1));
+
+  std::vector<float> entries(5);
+  cache.Gather(0, entries.size(), entries.data());
+  EXPECT_THAT(entries, ElementsAre(1.0f, 2.0f, 0.0f, 0.0f, 5.0f));
+}
+
+TEST(PagedCacheBufferTest, SharesPrefixUntilWritten) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*block_size=*/2, /*entry_size=*/2,
+                             /*max_num_blocks=*/4),
+            kTfLiteOk);
+  ASSERT_EQ(cache.CreateSequence(0), kTfLiteOk);
+  for (int position = 0; position < 3; ++position) {
+    float* entry = cache.GetWritableEntry(0, position);
+    entry[0] = position;
+    entry[1] = -position;
+  }
+  ASSERT_EQ(cache.ForkSequence(0, 1), kTfLiteOk);
+  EXPECT_EQ(cache.ForkSequence(0, 1), kTfLiteError);
+  EXPECT_EQ(cache.ForkSequence(7, 2), kTfLiteError);
+  EXPECT_EQ(cache.NumUsedBlocks(), 2);
+  EXPECT_EQ(cache.GetBlockTable(0), cache.GetBlockTable(1));
+
+  // Writing to the shared last block copies it for the writer only.
+  float* entry = cache.GetWritableEntry(1, 3);
+  entry[0] = 10.0f;
+  entry[1] = -10.0f;
+  EXPECT_EQ(cache.NumUsedBlocks(), 3);
+  EXPECT_EQ(cache.GetBlockTable(0)[0], cache.GetBlockTable(1)[0]);
+  EXPECT_NE(cache.GetBlockTable(0)[1], cache.GetBlockTable(1)[1]);
+
+  std::vector<float> entries(8);
+  cache.Gather(0, 4, entries.data());
+  EXPECT_THAT(entries, ElementsAre(0, 0, 1, -1, 2, -2, 0, 0));
+  cache.Gather(1, 4, entries.data());
+  EXPECT_THAT(entries, ElementsAre(0, 0, 1, -1, 2, -2, 10, -10));
+
+  // Blocks return to the pool once no sequence references them.
+  cache.ReleaseSequence(0);
+  EXPECT_FALSE(cache.HasSequence(0));
+  EXPECT_EQ(cache.NumUsedBlocks(), 2);
+  cache.ReleaseSequence(1);
+  EXPECT_EQ(cache.NumUsedBlocks(), 0);
+}
+
+TEST(PagedCacheBufferTest, FailsWhenPoolIsExhausted) {
+  PagedCacheBuffer cache;
+  ASSERT_EQ(cache.Initialize(/*block_size=*/2, /*entry_size=*/1,
+                             /*max_num_blocks=*/1),
+            kTfLiteOk);
+  ASSERT_EQ(cache.CreateSequence(0), kTfLiteOk);
+  EXPECT_NE(cache.GetWritableEntry(0, 1), nullptr);
+  EXPECT_EQ(cache.GetWritableEntry(0, 2), nullptr);
+  EXPECT_EQ(cache.GetWritableEntry(1, 0), nullptr);
+
+  ASSERT_EQ(cache.ForkSequence(0, 1), kTfLiteOk);
+  EXPECT_EQ(cache.GetWritableEntry(1, 0), nullptr);
+  cache.ReleaseSequence(0);
+  // The fork is the only owner left, so it writes in place.
+  EXPECT_NE(cache.GetWritableEntry(1, 0), nullptr);
+}
+
+TEST(PagedCacheBufferTest, RejectsInvalidSizes) {
+  PagedCacheBuffer cache;
+  EXPECT_EQ(cache.Initialize(0, 1, 1), kTfLiteError);
+  EXPECT_EQ(cache.Initialize(1, 0, 1), kTfLiteError);
+  EXPECT_EQ(cache.Initialize(1, 1, 0), kTfLiteError);
+  EXPECT_FALSE(cache.IsInitialized());
+}
+
+}  // namespace resource
+}  // namespace tflite
@@ -17,6 +17,7 @@ limitations under the License.
 #include <algorithm>
 #include <vector>
 
+#include "tensorflow/lite/builtin_ops.h"
 #include "tensorflow/lite/context_util.h"
 #include "tensorflow/lite/core/c/common.h"
 
@@ -260,6 +261,40 @@ class PartitionGraphIntoIndependentNodeSubsetsImpl {
 };
 // LINT.ThenChange(//tensorflow/lite/delegates/utils.h)
 
+bool MayRunConcurrently(GraphInfo* info, const TfLiteNode& node,
+                        const TfLiteRegistration& registration) {
+  if (node.delegate != nullptr || node.might_have_side_effect) {
+    return false;
+  }
+  switch (registration.builtin_code) {
+    case kTfLiteBuiltinCustom:
+    case kTfLiteBuiltinDelegate:
+    case kTfLiteBuiltinCallOnce:
+    case kTfLiteBuiltinIf:
+    case kTfLiteBuiltinWhile:
+    case kTfLiteBuiltinStablehloComposite:
+    case kTfLiteBuiltinStablehloWhile:
+      return false;
+    default:
+      break;
+  }
+  const TfLiteTensor* tensors = info->tensors();
+  for (const TfLiteIntArray* tensor_indices : {node.inputs, node.outputs}) {
+    for (int i = 0; i < tensor_indices->size; ++i) {
+      const int tensor_index = tensor_indices->data[i];
+      if (tensor_index == kTfLiteOptionalTensor) {
+        continue;
+      }
+      const TfLiteTensor& tensor = tensors[tensor_index];
+      if (tensor.is_variable || tensor.type == kTfLiteResource ||
+          tensor.type == kTfLiteVariant) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
@@ -289,4 +324,43 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
   return kTfLiteOk;
 }
 
+std::vector<int> PartitionIntoConcurrentNodeGroups(GraphInfo* info) {
+  const int num_nodes = static_cast<int>(info->num_execution_nodes());
+  std::vector<int> groups;
+  // Tensors produced by the nodes of the current group.
+  std::vector<bool> produced_by_group(info->num_tensors(), false);
+  std::vector<int> group_outputs;
+  bool group_may_run_concurrently = false;
+  for (int i = 0; i < num_nodes; ++i) {
+    const TfLiteNode& node = info->node(i);
+    const bool may_run_concurrently =
+        MayRunConcurrently(info, node, info->registration(i));
+    bool depends_on_group = false;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index != kTfLiteOptionalTensor &&
+          produced_by_group[tensor_index]) {
+        depends_on_group = true;
+        break;
+      }
+    }
+    if (i == 0 || !may_run_concurrently || !group_may_run_concurrently ||
+        depends_on_group) {
+      for (int tensor_index : group_outputs) {
+        produced_by_group[tensor_index] = false;
+      }
+      group_outputs.clear();
+      groups.push_back(i);
+    }
+    group_may_run_concurrently = may_run_concurrently;
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (tensor_index != kTfLiteOptionalTensor) {
+        produced_by_group[tensor_index] = true;
+        group_outputs.push_back(tensor_index);
+      }
+    }
+  }
+  groups.push_back(num_nodes);
+  return groups;
+}
+
 }  // namespace tflite
@@ -70,6 +70,12 @@ class GraphInfo {
 
   // Returns the indices of the variable tensors.
   virtual const std::vector<int>& variables() const = 0;
+
+  // Returns the groups of nodes of the execution plan that may run
+  // concurrently, as computed by PartitionIntoConcurrentNodeGroups(), or an
+  // empty vector if nodes run one at a time. Memory planners must not let the
+  // tensors of nodes of the same group share memory.
+  virtual std::vector<int> concurrent_node_groups() const { return {}; }
 };
 
 // Represents a subset of nodes in a TensorFlow Lite graph.
@@ -156,6 +162,16 @@ TfLiteStatus PartitionGraphIntoIndependentNodeSubsets(
     std::vector<NodeSubset>* node_subsets, bool greedily,
     const ControlEdges* control_edges = nullptr);
 
+// Splits the execution plan of `info` into consecutive groups of nodes that
+// may run concurrently, since no node of a group consumes the outputs of
+// another node of the same group. Nodes that are not known to be safe to run
+// alongside others, i.e. delegate kernels, custom and control flow ops, nodes
+// that might have side effects and nodes using resource, variant or variable
+// tensors, get a group of their own. Returns the execution plan index of the
+// first node of each group, followed by the number of nodes in the execution
+// plan.
+std::vector<int> PartitionIntoConcurrentNodeGroups(GraphInfo* info);
+
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_GRAPH_INFO_H_
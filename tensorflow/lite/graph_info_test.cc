@@ -29,6 +29,7 @@ limitations under the License.
 namespace tflite {
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::ExplainMatchResult;
 using ::testing::Pointwise;
@@ -693,5 +694,43 @@ TEST(PartitionTest, ComplexNonGreedily) {
                                 })));
 }
 
+// Test a graph with no nodes.
+TEST(ConcurrentNodeGroupsTest, Nodes0) {
+  SimpleTestGraph graph({}, {}, {});
+  EXPECT_THAT(PartitionIntoConcurrentNodeGroups(&graph),
+              ElementsAre(0));
+}
+
+// Test a chain of nodes, none of which may run concurrently.
+TEST(ConcurrentNodeGroupsTest, Chain) {
+  SimpleTestGraph graph({0}, {3}, {{{0}, {1}, false},
+                                   {{1}, {2}, false},
+                                   {{2}, {3}, false}});
+  EXPECT_THAT(PartitionIntoConcurrentNodeGroups(&graph),
+              ElementsAre(0, 1, 2, 3));
+}
+
+// Test two independent branches joined by a final node.
+//   0 -> [0] -> 1 -> [2] -> 3 -> [4] -> 5
+//   0 -> [1] -> 2 -> [3] -> 4 ---^
+TEST(ConcurrentNodeGroupsTest, IndependentBranches) {
+  SimpleTestGraph graph({0}, {5}, {{{0}, {1}, false},
+                                   {{0}, {2}, false},
+                                   {{1}, {3}, false},
+                                   {{2}, {4}, false},
+                                   {{3, 4}, {5}, false}});
+  EXPECT_THAT(PartitionIntoConcurrentNodeGroups(&graph),
+              ElementsAre(0, 2, 4, 5));
+}
+
+// Test that nodes that might have side effects run on their own.
+TEST(ConcurrentNodeGroupsTest, SideEffects) {
+  SimpleTestGraph graph({0}, {1, 2, 3}, {{{0}, {1}, false},
+                                         {{0}, {2}, true},
+                                         {{0}, {3}, false}});
+  EXPECT_THAT(PartitionIntoConcurrentNodeGroups(&graph),
+              ElementsAre(0, 1, 2, 3));
+}
+
 }  // namespace
 }  // namespace tflite
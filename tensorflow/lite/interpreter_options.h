@@ -19,8 +19,14 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_INTERPRETER_OPTIONS_H_
 #define TENSORFLOW_LITE_INTERPRETER_OPTIONS_H_
 
+#include <cstddef>
+#include <memory>
+#include <utility>
+
 namespace tflite {
 
+class ConstantTransformCache;
+
 /// Options class for `Interpreter`.
 /// WARNING: This is an experimental API and subject to change.
 class InterpreterOptions {
@@ -103,12 +109,74 @@ class InterpreterOptions {
     return experimental_cache_constant_cast_op_;
   }
 
+  // Sets the capacity, in bytes, of a cache of transforms applied to constant
+  // tensors, such as the dequantization of constant weights. Results are
+  // keyed by the constant buffer, so the subgraphs and signatures of a model
+  // that transform the same weights share one result. Transforms that do not
+  // fit are computed per node, as without the cache. 0, the default, disables
+  // the cache.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetConstantTransformCacheSize(size_t bytes) {
+    experimental_constant_transform_cache_size_ = bytes;
+  }
+
+  // Returns the capacity, in bytes, of the cache of constant transforms.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  size_t GetConstantTransformCacheSize() const {
+    return experimental_constant_transform_cache_size_;
+  }
+
+  // Sets a cache of constant transforms to share with other interpreters, e.g.
+  // the per-thread interpreters serving one FlatBufferModel, so that they
+  // share the transformed weights instead of each holding a copy. Takes
+  // precedence over SetConstantTransformCacheSize. Results are keyed by the
+  // address of the constant buffers, so the cache must only be shared by
+  // interpreters of one model, and must not outlive that model.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetConstantTransformCache(
+      std::shared_ptr<ConstantTransformCache> cache) {
+    experimental_constant_transform_cache_ = std::move(cache);
+  }
+
+  // Returns the shared cache of constant transforms, if any.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  const std::shared_ptr<ConstantTransformCache>& GetConstantTransformCache()
+      const {
+    return experimental_constant_transform_cache_;
+  }
+
+  // Sets the number of threads used to run independent nodes of the execution
+  // plan at the same time. Nodes run one at a time if `value` is 1 or less,
+  // which is the default. Each additional thread gets its own CPU backend
+  // context, so kernels running at the same time don't share thread pools.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetInterOpNumThreads(int value) {
+    experimental_inter_op_num_threads_ = value;
+  }
+
+  // Returns the number of threads used to run independent nodes of the
+  // execution plan at the same time.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  int GetInterOpNumThreads() const {
+    return experimental_inter_op_num_threads_;
+  }
+
  private:
   bool experimental_preserve_all_tensors_ = false;
   bool experimental_ensure_dynamic_tensors_are_released_ = false;
   int experimental_optimize_memory_for_large_tensors_ = 0;
   bool experimental_disable_delegate_clustering_ = false;
   bool experimental_cache_constant_cast_op_ = false;
+  int experimental_inter_op_num_threads_ = 1;
+  size_t experimental_constant_transform_cache_size_ = 0;
+  std::shared_ptr<ConstantTransformCache>
+      experimental_constant_transform_cache_;
 };
 
 }  // namespace tflite
@@ -20,6 +20,7 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -1129,6 +1130,43 @@ TEST(BasicInterpreter, ReleaseDynamicTensors) {
   ASSERT_EQ(interpreter.tensor(3)->bytes, sizeof(float) * 6 * 6);
 }
 
+TEST(BasicInterpreter, InvokeIndependentNodesConcurrently) {
+  // Assemble a graph with two independent negate nodes reading the same input.
+  Interpreter interpreter;
+  InterpreterOptions options;
+  options.SetInterOpNumThreads(2);
+  interpreter.ApplyOptions(&options);
+  interpreter.AddTensors(3);
+  interpreter.SetInputs({0});
+  interpreter.SetOutputs({1, 2});
+  TfLiteQuantizationParams quant;
+  for (int i = 0; i < 3; ++i) {
+    interpreter.SetTensorParametersReadWrite(
+        /*tensor_index=*/i, /*type=*/kTfLiteFloat32, /*name=*/"",
+        /*dims=*/{3}, /*quantization=*/quant);
+  }
+  TfLiteRegistration* neg_op = tflite::ops::builtin::Register_NEG();
+  for (int output : {1, 2}) {
+    interpreter.AddNodeWithParameters(
+        /*inputs=*/{0}, /*outputs=*/{output}, /*init_data=*/nullptr,
+        /*init_data_size=*/0, /*builtin_data=*/nullptr,
+        /*registration=*/neg_op);
+  }
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  const std::vector<float> input = {1.0f, -2.0f, 3.0f};
+  std::copy(input.begin(), input.end(), interpreter.typed_tensor<float>(0));
+  for (int run = 0; run < 2; ++run) {
+    ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+    for (int output : {1, 2}) {
+      const float* output_data = interpreter.typed_tensor<float>(output);
+      for (int i = 0; i < input.size(); ++i) {
+        EXPECT_EQ(output_data[i], -input[i]);
+      }
+    }
+  }
+}
+
 TEST(InterpreterTensorsCapacityTest, TestWithinHeadroom) {
   Interpreter interpreter;
   ASSERT_EQ(interpreter.AddTensors(Interpreter::kTensorsReservedCapacity),
@@ -0,0 +1,464 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Per-kernel latency benchmarks of the builtin ops.
+//
+// Every case runs a single op on representative shapes, for float32 and int8,
+// through the reference kernels, the optimized kernels and XNNPACK. The
+// benchmarks are named <OP>/<type>/<shape>/<path>, where <OP> is the node type
+// reported by the profile summarizer, so that the results can be matched with
+// the per-op breakdown of benchmark_model. Results can be written as JSON with
+// the standard Google Benchmark flags, e.g.
+//
+//   builtin_op_benchmark --benchmark_filter=CONV_2D/INT8 \
+//       --benchmark_out=ops.json --benchmark_out_format=json
+//
+// Cases of ops that a resolver does not register, or that XNNPACK does not
+// delegate, are skipped and reported as errors.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/kernels/register.h"
+#include "tensorflow/lite/kernels/register_ref.h"
+#include "tensorflow/lite/mutable_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite {
+namespace {
+
+enum class KernelPath { kReference, kOptimized, kXnnpack };
+
+const char* KernelPathName(KernelPath path) {
+  switch (path) {
+    case KernelPath::kReference:
+      return "reference";
+    case KernelPath::kOptimized:
+      return "optimized";
+    case KernelPath::kXnnpack:
+      return "xnnpack";
+  }
+  return "unknown";
+}
+
+enum class TensorKind { kActivation, kWeights, kBias };
+
+struct TensorSpec {
+  std::vector<int> shape;
+  TensorKind kind = TensorKind::kActivation;
+};
+
+// A single op applied to tensors of fixed shapes.
+struct OpCase {
+  BuiltinOperator op;
+  // Short description of the shapes, used in the benchmark name.
+  std::string name;
+  std::vector<TensorSpec> inputs;
+  std::vector<int> output_shape;
+  // Returns the builtin data of the node, allocated with malloc.
+  std::function<void*()> create_params;
+  // Quantization of int8 outputs. A scale of 0 uses the input quantization.
+  float output_scale = 0.0f;
+  int output_zero_point = 0;
+};
+
+// Quantization of int8 tensors, chosen to keep requantization multipliers
+// below 1 for all cases.
+constexpr float kActivationScale = 0.05f;
+constexpr float kWeightsScale = 0.02f;
+constexpr float kAccumulatingOutputScale = 0.1f;
+
+template <typename T>
+T* CreateParams() {
+  return static_cast<T*>(calloc(1, sizeof(T)));
+}
+
+int NumElements(const std::vector<int>& shape) {
+  int elements = 1;
+  for (int dim : shape) elements *= dim;
+  return elements;
+}
+
+std::string ShapeName(const std::vector<int>& shape) {
+  std::string name;
+  for (int dim : shape) {
+    if (!name.empty()) name += "x";
+    name += std::to_string(dim);
+  }
+  return name;
+}
+
+OpCase ElementwiseCase(BuiltinOperator op, const std::vector<int>& shape,
+                       int num_inputs, std::function<void*()> create_params) {
+  OpCase op_case;
+  op_case.op = op;
+  op_case.name = ShapeName(shape);
+  op_case.inputs.assign(num_inputs, TensorSpec{shape});
+  op_case.output_shape = shape;
+  op_case.create_params = std::move(create_params);
+  return op_case;
+}
+
+OpCase ConvCase(const std::vector<int>& input_shape, int output_channels,
+                int kernel_size, int stride) {
+  const int output_size = input_shape[1] / stride;
+  OpCase op_case;
+  op_case.op = BuiltinOperator_CONV_2D;
+  op_case.name = ShapeName(input_shape) + "_k" + std::to_string(kernel_size) +
+                 "s" + std::to_string(stride) + "_o" +
+                 std::to_string(output_channels);
+  op_case.inputs = {
+      {input_shape},
+      {{output_channels, kernel_size, kernel_size, input_shape[3]},
+       TensorKind::kWeights},
+      {{output_channels}, TensorKind::kBias}};
+  op_case.output_shape = {input_shape[0], output_size, output_size,
+                          output_channels};
+  op_case.create_params = [stride]() -> void* {
+    auto* params = CreateParams<TfLiteConvParams>();
+    params->padding = kTfLitePaddingSame;
+    params->stride_width = stride;
+    params->stride_height = stride;
+    params->dilation_width_factor = 1;
+    params->dilation_height_factor = 1;
+    params->activation = kTfLiteActRelu6;
+    return params;
+  };
+  op_case.output_scale = kAccumulatingOutputScale;
+  return op_case;
+}
+
+OpCase DepthwiseConvCase(const std::vector<int>& input_shape, int kernel_size,
+                         int stride) {
+  const int channels = input_shape[3];
+  const int output_size = input_shape[1] / stride;
+  OpCase op_case;
+  op_case.op = BuiltinOperator_DEPTHWISE_CONV_2D;
+  op_case.name = ShapeName(input_shape) + "_k" + std::to_string(kernel_size) +
+                 "s" + std::to_string(stride);
+  op_case.inputs = {
+      {input_shape},
+      {{1, kernel_size, kernel_size, channels}, TensorKind::kWeights},
+      {{channels}, TensorKind::kBias}};
+  op_case.output_shape = {input_shape[0], output_size, output_size, channels};
+  op_case.create_params = [stride]() -> void* {
+    auto* params = CreateParams<TfLiteDepthwiseConvParams>();
+    params->padding = kTfLitePaddingSame;
+    params->stride_width = stride;
+    params->stride_height = stride;
+    params->depth_multiplier = 1;
+    params->dilation_width_factor = 1;
+    params->dilation_height_factor = 1;
+    params->activation = kTfLiteActRelu6;
+    return params;
+  };
+  op_case.output_scale = kAccumulatingOutputScale;
+  return op_case;
+}
+
+OpCase FullyConnectedCase(int batches, int input_depth, int output_depth) {
+  OpCase op_case;
+  op_case.op = BuiltinOperator_FULLY_CONNECTED;
+  op_case.name = std::to_string(batches) + "x" + std::to_string(input_depth) +
+                 "_o" + std::to_string(output_depth);
+  op_case.inputs = {{{batches, input_depth}},
+                    {{output_depth, input_depth}, TensorKind::kWeights},
+                    {{output_depth}, TensorKind::kBias}};
+  op_case.output_shape = {batches, output_depth};
+  op_case.create_params = []() -> void* {
+    auto* params = CreateParams<TfLiteFullyConnectedParams>();
+    params->activation = kTfLiteActNone;
+    return params;
+  };
+  op_case.output_scale = kAccumulatingOutputScale;
+  return op_case;
+}
+
+OpCase PoolCase(BuiltinOperator op, const std::vector<int>& input_shape,
+                int filter_size) {
+  const int output_size = input_shape[1] / filter_size;
+  OpCase op_case;
+  op_case.op = op;
+  op_case.name = ShapeName(input_shape) + "_k" + std::to_string(filter_size);
+  op_case.inputs = {{input_shape}};
+  op_case.output_shape = {input_shape[0], output_size, output_size,
+                          input_shape[3]};
+  op_case.create_params = [filter_size]() -> void* {
+    auto* params = CreateParams<TfLitePoolParams>();
+    params->padding = kTfLitePaddingValid;
+    params->stride_width = filter_size;
+    params->stride_height = filter_size;
+    params->filter_width = filter_size;
+    params->filter_height = filter_size;
+    params->activation = kTfLiteActNone;
+    return params;
+  };
+  return op_case;
+}
+
+std::vector<OpCase> GetOpCases() {
+  auto add_params = []() -> void* {
+    return CreateParams<TfLiteAddParams>();
+  };
+  auto mul_params = []() -> void* {
+    return CreateParams<TfLiteMulParams>();
+  };
+  auto softmax_params = []() -> void* {
+    auto* params = CreateParams<TfLiteSoftmaxParams>();
+    params->beta = 1.0f;
+    return params;
+  };
+  auto no_params = []() -> void* { return nullptr; };
+
+  std::vector<OpCase> cases = {
+      ElementwiseCase(BuiltinOperator_ADD, {1, 56, 56, 64}, 2, add_params),
+      ElementwiseCase(BuiltinOperator_ADD, {1, 14, 14, 256}, 2, add_params),
+      ElementwiseCase(BuiltinOperator_MUL, {1, 56, 56, 64}, 2, mul_params),
+      ElementwiseCase(BuiltinOperator_RELU, {1, 56, 56, 64}, 1, no_params),
+      ElementwiseCase(BuiltinOperator_LOGISTIC, {1, 56, 56, 64}, 1,
+                      no_params),
+      ElementwiseCase(BuiltinOperator_TANH, {1, 56, 56, 64}, 1, no_params),
+      ElementwiseCase(BuiltinOperator_SOFTMAX, {1, 1000}, 1, softmax_params),
+      ElementwiseCase(BuiltinOperator_SOFTMAX, {64, 512}, 1, softmax_params),
+      ConvCase({1, 112, 112, 3}, 32, 3, 2),
+      ConvCase({1, 56, 56, 64}, 64, 1, 1),
+      ConvCase({1, 28, 28, 128}, 128, 3, 1),
+      ConvCase({1, 7, 7, 512}, 512, 1, 1),
+      DepthwiseConvCase({1, 112, 112, 32}, 3, 1),
+      DepthwiseConvCase({1, 28, 28, 256}, 3, 2),
+      DepthwiseConvCase({1, 14, 14, 512}, 5, 1),
+      FullyConnectedCase(1, 1024, 1000),
+      FullyConnectedCase(16, 512, 512),
+      PoolCase(BuiltinOperator_MAX_POOL_2D, {1, 112, 112, 64}, 2),
+      PoolCase(BuiltinOperator_AVERAGE_POOL_2D, {1, 7, 7, 1024}, 7),
+  };
+  // Int8 logistic and softmax only support a fixed output quantization, and
+  // tanh a fixed output scale.
+  for (OpCase& op_case : cases) {
+    if (op_case.op == BuiltinOperator_LOGISTIC ||
+        op_case.op == BuiltinOperator_SOFTMAX) {
+      op_case.output_scale = 1.0f / 256;
+      op_case.output_zero_point = -128;
+    } else if (op_case.op == BuiltinOperator_TANH) {
+      op_case.output_scale = 1.0f / 128;
+    }
+  }
+  return cases;
+}
+
+// Returns the type and quantization of an input of a case run on `type`.
+std::pair<TfLiteType, TfLiteQuantizationParams> GetInputType(
+    const TensorSpec& spec, TfLiteType type) {
+  if (type == kTfLiteFloat32) return {kTfLiteFloat32, {}};
+  switch (spec.kind) {
+    case TensorKind::kActivation:
+      return {kTfLiteInt8, {kActivationScale, 0}};
+    case TensorKind::kWeights:
+      return {kTfLiteInt8, {kWeightsScale, 0}};
+    case TensorKind::kBias:
+      return {kTfLiteInt32, {kActivationScale * kWeightsScale, 0}};
+  }
+  return {kTfLiteNoType, {}};
+}
+
+// Returns `num_elements` deterministic values of `type`.
+std::vector<char> GenerateData(TfLiteType type, int num_elements,
+                               std::mt19937* random_engine) {
+  std::vector<char> data;
+  switch (type) {
+    case kTfLiteFloat32: {
+      std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+      data.resize(num_elements * sizeof(float));
+      float* values = reinterpret_cast<float*>(data.data());
+      for (int i = 0; i < num_elements; ++i) {
+        values[i] = distribution(*random_engine);
+      }
+      break;
+    }
+    case kTfLiteInt8: {
+      std::uniform_int_distribution<int> distribution(-127, 127);
+      data.resize(num_elements);
+      for (int i = 0; i < num_elements; ++i) {
+        data[i] = static_cast<char>(distribution(*random_engine));
+      }
+      break;
+    }
+    case kTfLiteInt32: {
+      std::uniform_int_distribution<int32_t> distribution(-1000, 1000);
+      data.resize(num_elements * sizeof(int32_t));
+      int32_t* values = reinterpret_cast<int32_t*>(data.data());
+      for (int i = 0; i < num_elements; ++i) {
+        values[i] = distribution(*random_engine);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return data;
+}
+
+const MutableOpResolver& GetResolver(KernelPath path) {
+  static const auto* const kReferenceResolver =
+      new ops::builtin::BuiltinRefOpResolver();
+  static const auto* const kOptimizedResolver =
+      new ops::builtin::BuiltinOpResolverWithoutDefaultDelegates();
+  return path == KernelPath::kReference ? *kReferenceResolver
+                                        : *kOptimizedResolver;
+}
+
+void RunOpBenchmark(benchmark::State& state, const OpCase& op_case,
+                    TfLiteType type, KernelPath path) {
+  const TfLiteRegistration* registration =
+      GetResolver(path).FindOp(op_case.op, /*version=*/1);
+  if (registration == nullptr) {
+    state.SkipWithError("Op is not registered");
+    return;
+  }
+
+  // Constant tensors point into `constant_data` and the delegate is applied to
+  // the interpreter, so both must outlive it.
+  std::mt19937 random_engine(42);
+  std::vector<std::vector<char>> constant_data;
+  Interpreter::TfLiteDelegatePtr delegate(nullptr, [](TfLiteDelegate*) {});
+  auto interpreter = std::make_unique<Interpreter>();
+  interpreter->SetNumThreads(1);
+  const int num_inputs = op_case.inputs.size();
+  interpreter->AddTensors(num_inputs + 1);
+  std::vector<int> node_inputs;
+  std::vector<int> graph_inputs;
+  TfLiteQuantizationParams input_quantization = {};
+  for (int i = 0; i < num_inputs; ++i) {
+    const TensorSpec& spec = op_case.inputs[i];
+    const auto [tensor_type, quantization] = GetInputType(spec, type);
+    node_inputs.push_back(i);
+    if (spec.kind == TensorKind::kActivation) {
+      input_quantization = quantization;
+      graph_inputs.push_back(i);
+      interpreter->SetTensorParametersReadWrite(i, tensor_type, "", spec.shape,
+                                                quantization);
+    } else {
+      constant_data.push_back(GenerateData(
+          tensor_type, NumElements(spec.shape), &random_engine));
+      interpreter->SetTensorParametersReadOnly(
+          i, tensor_type, "", spec.shape, quantization,
+          constant_data.back().data(), constant_data.back().size());
+    }
+  }
+  const int output = num_inputs;
+  TfLiteQuantizationParams output_quantization = input_quantization;
+  if (type == kTfLiteInt8 && op_case.output_scale != 0.0f) {
+    output_quantization = {op_case.output_scale, op_case.output_zero_point};
+  }
+  interpreter->SetTensorParametersReadWrite(output, type, "",
+                                            op_case.output_shape,
+                                            output_quantization);
+  interpreter->SetInputs(graph_inputs);
+  interpreter->SetOutputs({output});
+  if (interpreter->AddNodeWithParameters(node_inputs, {output}, nullptr, 0,
+                                         op_case.create_params(),
+                                         registration) != kTfLiteOk) {
+    state.SkipWithError("Failed to add the node");
+    return;
+  }
+
+  if (path == KernelPath::kXnnpack) {
+    TfLiteXNNPackDelegateOptions options =
+        TfLiteXNNPackDelegateOptionsDefault();
+    options.num_threads = 1;
+    delegate = Interpreter::TfLiteDelegatePtr(
+        TfLiteXNNPackDelegateCreate(&options), TfLiteXNNPackDelegateDelete);
+    if (interpreter->ModifyGraphWithDelegate(delegate.get()) != kTfLiteOk) {
+      state.SkipWithError("Failed to apply XNNPACK");
+      return;
+    }
+    const TfLiteRegistration& node_registration =
+        interpreter->node_and_registration(interpreter->execution_plan()[0])
+            ->second;
+    if (node_registration.builtin_code != kTfLiteBuiltinDelegate) {
+      state.SkipWithError("Op is not delegated to XNNPACK");
+      return;
+    }
+  }
+
+  if (interpreter->AllocateTensors() != kTfLiteOk) {
+    state.SkipWithError("Failed to allocate tensors");
+    return;
+  }
+  for (int input : graph_inputs) {
+    TfLiteTensor* tensor = interpreter->tensor(input);
+    const std::vector<char> data = GenerateData(
+        tensor->type, NumElements(op_case.inputs[input].shape), &random_engine);
+    std::memcpy(tensor->data.raw, data.data(), data.size());
+  }
+  // The first run includes one-time work like packing weights.
+  if (interpreter->Invoke() != kTfLiteOk) {
+    state.SkipWithError("Failed to invoke");
+    return;
+  }
+
+  for (auto _ : state) {
+    interpreter->Invoke();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          NumElements(op_case.output_shape));
+  state.SetLabel(GetOpNameByRegistration(*registration));
+}
+
+void RegisterOpBenchmarks() {
+  static const auto* const kCases = new std::vector<OpCase>(GetOpCases());
+  for (const OpCase& op_case : *kCases) {
+    for (TfLiteType type : {kTfLiteFloat32, kTfLiteInt8}) {
+      for (KernelPath path : {KernelPath::kReference, KernelPath::kOptimized,
+                              KernelPath::kXnnpack}) {
+        const std::string name = std::string(EnumNameBuiltinOperator(
+                                     op_case.op)) +
+                                 "/" + TfLiteTypeGetName(type) + "/" +
+                                 op_case.name + "/" + KernelPathName(path);
+        benchmark::RegisterBenchmark(
+            name.c_str(),
+            [&op_case, type, path](benchmark::State& state) {
+              RunOpBenchmark(state, op_case, type, path);
+            })
+            ->Unit(benchmark::kMicrosecond);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  tflite::RegisterOpBenchmarks();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "Eigen/Core"  // from @eigen_archive
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/constant_transform_cache.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
@@ -322,6 +323,18 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   // TF_LITE_ENSURE_EQ(context, input->type, params->in_data_type);
   // TF_LITE_ENSURE_EQ(context, output->type, params->out_data_type);
 
+  // Constant inputs are cast once for all subgraphs when the interpreter has
+  // a constant transform cache.
+  auto* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  if (subgraph != nullptr &&
+      subgraph->ShareConstantTransform(
+          ConstantTransform::kCast, input, output,
+          [&](TfLiteTensor* result) {
+            return EvalImpl(context, input, result, NumElements(input));
+          })) {
+    return kTfLiteOk;
+  }
+
   if (ShouldCacheOutput(context, input)) {
     output->allocation_type = kTfLiteArenaRwPersistent;
   }
@@ -339,6 +352,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   TfLiteTensor* output;
   TF_LITE_ENSURE_OK(context,
                     GetOutputSafe(context, node, kOutputTensor, &output));
+  // The output views a result shared through the constant transform cache.
+  if (IsConstantTensor(output)) return kTfLiteOk;
   const int num_elements = NumElements(input);
   TF_LITE_ENSURE_EQ(context, num_elements, NumElements(output));
 
@@ -123,8 +123,26 @@ struct OpData {
   int32_t groups = 1;
 
   TfLiteType quantized_bias_type = kTfLiteNoType;
+
+  // Int4 filters unpacked into int8. Constant filters are unpacked only once.
+  std::vector<int8_t> unpacked_filter;
 };
 
+// Returns the filter as int8 values, unpacking int4 filters into
+// `data->unpacked_filter` unless a constant filter has been unpacked already.
+const int8_t* GetInt8FilterData(const TfLiteTensor* filter, OpData* data) {
+  if (filter->type != kTfLiteInt4) return GetTensorData<int8_t>(filter);
+  const int num_elements = GetTensorShape(filter).FlatSize();
+  if (!IsConstantTensor(filter) ||
+      data->unpacked_filter.size() != static_cast<size_t>(num_elements)) {
+    data->unpacked_filter.resize(num_elements);
+    tflite::tensor_utils::UnpackDenseInt4IntoInt8(
+        GetTensorData<int8_t>(filter), num_elements,
+        data->unpacked_filter.data());
+  }
+  return data->unpacked_filter.data();
+}
+
 inline PaddingType RuntimePaddingType(TfLitePadding padding) {
   switch (padding) {
     case TfLitePadding::kTfLitePaddingSame:
@@ -770,18 +788,7 @@ void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
     effective_kernel_type = kReference;
   }
 
-  const int8_t* filter_data;
-  const size_t bytes_unpacked = filter->bytes * 2;
-  auto unpacked_filter_data = std::make_unique<int8_t[]>(bytes_unpacked);
-
-  if (filter->type == kTfLiteInt4) {
-    tflite::tensor_utils::UnpackDenseInt4IntoInt8(
-        GetTensorData<int8_t>(filter), GetTensorShape(filter).FlatSize(),
-        unpacked_filter_data.get());
-    filter_data = unpacked_filter_data.get();
-  } else {
-    filter_data = GetTensorData<int8>(filter);
-  }
+  const int8_t* filter_data = GetInt8FilterData(filter, data);
 
   switch (effective_kernel_type) {
     case kReference: {
@@ -1041,11 +1048,10 @@ TfLiteStatus EvalHybridPerChannel(TfLiteContext* context, TfLiteNode* node,
   }
 
   int8_t* im2col_ptr = nullptr;
-  int8_t* filter_ptr = nullptr;
   if (im2col != nullptr) {
     im2col_ptr = im2col->data.int8;
   }
-  filter_ptr = filter->data.int8;
+  const int8_t* filter_ptr = GetInt8FilterData(filter, data);
   const auto* affine_quantization =
       reinterpret_cast<TfLiteAffineQuantization*>(filter->quantization.params);
 
@@ -1171,7 +1177,7 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
         optimized_ops::HybridConv(
             op_params, scaling_factors_ptr, GetTensorShape(input),
             quantized_input_ptr_batch, GetTensorShape(filter),
-            GetTensorData<int8_t>(filter), GetTensorShape(bias),
+            GetInt8FilterData(filter, data), GetTensorShape(bias),
             GetTensorData<float>(bias), GetTensorShape(accum_scratch),
             GetTensorData<int32_t>(accum_scratch), GetTensorShape(output),
             GetTensorData<float>(output), GetTensorShape(im2col),
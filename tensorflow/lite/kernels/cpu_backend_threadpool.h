@@ -16,6 +16,10 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_THREADPOOL_H_
 #define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_THREADPOOL_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/kernels/internal/compatibility.h"
 
@@ -55,6 +59,54 @@ void Execute(int tasks_count, TaskType* tasks,
 
 #endif
 
+namespace internal {
+
+template <typename Fn>
+class ParallelForTask : public Task {
+ public:
+  ParallelForTask(const Fn* fn, int64_t start, int64_t end)
+      : fn_(fn), start_(start), end_(end) {}
+
+  void Run() override { (*fn_)(start_, end_); }
+
+ private:
+  const Fn* fn_;
+  int64_t start_;
+  int64_t end_;
+};
+
+}  // namespace internal
+
+// Calls `fn(start, end)` on contiguous shards covering [0, size), using up to
+// `max_num_threads()` threads of `cpu_backend_context`. Shards are at least
+// `min_shard_size` items large, so that work too small to amortize waking up
+// the thread pool runs inline on the calling thread. `fn` must be safe to call
+// concurrently on disjoint ranges.
+template <typename Fn>
+void ParallelFor(int64_t size, int64_t min_shard_size,
+                 CpuBackendContext* cpu_backend_context, const Fn& fn) {
+  if (size <= 0) {
+    return;
+  }
+  const int64_t max_num_shards =
+      std::max<int64_t>(1, size / std::max<int64_t>(1, min_shard_size));
+  const int num_shards = static_cast<int>(std::min<int64_t>(
+      cpu_backend_context->max_num_threads(), max_num_shards));
+  if (num_shards <= 1) {
+    fn(0, size);
+    return;
+  }
+  std::vector<internal::ParallelForTask<Fn>> tasks;
+  tasks.reserve(num_shards);
+  int64_t start = 0;
+  for (int i = 0; i < num_shards; ++i) {
+    const int64_t end = start + (size - start) / (num_shards - i);
+    tasks.emplace_back(&fn, start, end);
+    start = end;
+  }
+  Execute(tasks.size(), tasks.data(), cpu_backend_context);
+}
+
 }  // namespace cpu_backend_threadpool
 }  // namespace tflite
 
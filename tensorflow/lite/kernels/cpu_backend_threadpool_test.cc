@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 
+#include <cstdint>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -89,6 +90,40 @@ TEST(CpuBackendThreadpoolTest, TenThreadsSize1234567) {
   TestGenerateArrayOfIncrementingInts(10, 1234567);
 }
 
+void TestParallelForGeneratesIncrementingInts(int num_threads, int size,
+                                              int min_shard_size) {
+  std::vector<int> buffer(size, -1);
+  CpuBackendContext context;
+  context.SetMaxNumThreads(num_threads);
+
+  cpu_backend_threadpool::ParallelFor(
+      size, min_shard_size, &context, [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; i++) {
+          buffer[i] = static_cast<int>(i);
+        }
+      });
+
+  for (int i = 0; i < size; i++) {
+    ASSERT_EQ(buffer[i], i);
+  }
+}
+
+TEST(CpuBackendThreadpoolTest, ParallelForBelowMinShardSize) {
+  TestParallelForGeneratesIncrementingInts(4, 100, 1000);
+}
+
+TEST(CpuBackendThreadpoolTest, ParallelForThreeThreadsSize1000000) {
+  TestParallelForGeneratesIncrementingInts(3, 1000000, 1000);
+}
+
+TEST(CpuBackendThreadpoolTest, ParallelForMoreThreadsThanShards) {
+  TestParallelForGeneratesIncrementingInts(10, 2500, 1000);
+}
+
+TEST(CpuBackendThreadpoolTest, ParallelForEmpty) {
+  TestParallelForGeneratesIncrementingInts(4, 0, 1);
+}
+
 }  // namespace
 
 }  // namespace tflite
@@ -82,8 +82,26 @@ struct OpData {
   int32_t input_quantized_index;
   int32_t scaling_factors_index;
   int32_t input_offset_index;
+
+  // Int4 filters unpacked into int8. Constant filters are unpacked only once.
+  std::vector<int8_t> unpacked_filter;
 };
 
+// Returns the filter as int8 values, unpacking int4 filters into
+// `data->unpacked_filter` unless a constant filter has been unpacked already.
+const int8_t* GetInt8FilterData(const TfLiteTensor* filter, OpData* data) {
+  if (filter->type != kTfLiteInt4) return GetTensorData<int8_t>(filter);
+  const int num_elements = GetTensorShape(filter).FlatSize();
+  if (!IsConstantTensor(filter) ||
+      data->unpacked_filter.size() != static_cast<size_t>(num_elements)) {
+    data->unpacked_filter.resize(num_elements);
+    tflite::tensor_utils::UnpackDenseInt4IntoInt8(
+        GetTensorData<int8_t>(filter), num_elements,
+        data->unpacked_filter.data());
+  }
+  return data->unpacked_filter.data();
+}
+
 void* Init(TfLiteContext* context, const char* buffer, size_t length) {
   // This is a builtin op, so we don't use the contents in 'buffer', if any.
   // Instead, we allocate a new object to carry information from Prepare() to
@@ -405,18 +423,7 @@ TfLiteStatus EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
 
   KernelType effective_kernel_type = kernel_type;
 
-  const int8_t* filter_data;
-  const size_t bytes_unpacked = filter->bytes * 2;
-  auto unpacked_filter_data = std::make_unique<int8_t[]>(bytes_unpacked);
-
-  if (filter->type == kTfLiteInt4) {
-    tflite::tensor_utils::UnpackDenseInt4IntoInt8(
-        GetTensorData<int8_t>(filter), GetTensorShape(filter).FlatSize(),
-        unpacked_filter_data.get());
-    filter_data = unpacked_filter_data.get();
-  } else {
-    filter_data = GetTensorData<int8>(filter);
-  }
+  const int8_t* filter_data = GetInt8FilterData(filter, data);
 
   switch (effective_kernel_type) {
     case kReference: {
@@ -17,6 +17,8 @@ limitations under the License.
 #include <stddef.h>
 
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/constant_transform_cache.h"
+#include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/kernels/internal/optimized/neon_check.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 
@@ -49,6 +51,7 @@ void Free(TfLiteContext* context, void* buffer) {
   delete reinterpret_cast<OpData*>(buffer);
 }
 
+template <KernelType kernel_type>
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 1);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -66,6 +69,18 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   }
 
   op_context.output->type = kTfLiteFloat32;
+  // Constant weights are dequantized once for all subgraphs when the
+  // interpreter has a constant transform cache.
+  auto* subgraph = reinterpret_cast<Subgraph*>(context->impl_);
+  if (subgraph != nullptr &&
+      subgraph->ShareConstantTransform(
+          ConstantTransform::kDequantize, op_context.input, op_context.output,
+          [&](TfLiteTensor* output) {
+            return DequantizeImpl<kernel_type>(context, node, op_context.input,
+                                               output);
+          })) {
+    return kTfLiteOk;
+  }
   // If the input tensor is constant, we can persist the dequantized value in
   // the output tensor. Otherwise we run dequantize upon each eval.
   if (IsConstantTensor(op_context.input)) {
@@ -79,6 +94,8 @@ template <KernelType kernel_type>
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   OpData* op_data = reinterpret_cast<OpData*>(node->user_data);
   OpContext op_context(context, node);
+  // The output views a result shared through the constant transform cache.
+  if (IsConstantTensor(op_context.output)) return kTfLiteOk;
   if (IsConstantTensor(op_context.input) &&
       op_data->float_dequantized_weights_initialized) {
     return kTfLiteOk;
@@ -100,14 +117,15 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
 TfLiteRegistration* Register_DEQUANTIZE_OPT() {
   static TfLiteRegistration r = {
-      dequantize::Init, dequantize::Free, dequantize::Prepare,
+      dequantize::Init, dequantize::Free,
+      dequantize::Prepare<dequantize::kGenericOptimized>,
       dequantize::Eval<dequantize::kGenericOptimized>};
   return &r;
 }
 
 TfLiteRegistration* Register_DEQUANTIZE_REF() {
   static TfLiteRegistration r = {dequantize::Init, dequantize::Free,
-                                 dequantize::Prepare,
+                                 dequantize::Prepare<dequantize::kReference>,
                                  dequantize::Eval<dequantize::kReference>};
   return &r;
 }
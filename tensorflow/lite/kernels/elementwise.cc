@@ -22,6 +22,8 @@ limitations under the License.
 #include <limits>
 
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
 #include "tensorflow/lite/kernels/internal/common.h"
 #include "tensorflow/lite/kernels/internal/quantization_util.h"
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/lut.h"
@@ -41,6 +43,10 @@ const char kAbsName[] = "Abs";
 const char kLogName[] = "Log";
 const char kRsqrtName[] = "Rsqrt";
 
+// Elementwise ops are only sharded over the CPU backend thread pool when each
+// thread gets at least this many elements to amortize waking it up.
+constexpr int kMinElementsPerShard = 8192;
+
 struct OpData {
   int32_t multiplier;
   int32_t shift;
@@ -205,12 +211,23 @@ inline TfLiteStatus EvalImpl(TfLiteContext* context, TfLiteNode* node,
   const int64_t num_elements = NumElements(input);
   const T* in_data = GetTensorData<T>(input);
   T* out_data = GetTensorData<T>(output);
-  for (int64_t i = 0; i < num_elements; ++i) {
-    if (validate_input_func) {
+  if (validate_input_func) {
+    // Validation reports errors through the context, so it stays on the
+    // calling thread.
+    for (int64_t i = 0; i < num_elements; ++i) {
       TF_LITE_ENSURE_OK(context, validate_input_func(in_data[i]));
+      out_data[i] = func(in_data[i]);
     }
-    out_data[i] = func(in_data[i]);
+    return kTfLiteOk;
   }
+  cpu_backend_threadpool::ParallelFor(
+      num_elements, kMinElementsPerShard,
+      CpuBackendContext::GetFromContext(context),
+      [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+          out_data[i] = func(in_data[i]);
+        }
+      });
   return kTfLiteOk;
 }
 
@@ -225,10 +242,15 @@ inline TfLiteStatus AbsInt16EvalImpl(TfLiteContext* context, TfLiteNode* node,
   const int64_t num_elements = NumElements(input);
   const int16_t* in_data = GetTensorData<int16_t>(input);
   int16_t* out_data = GetTensorData<int16_t>(output);
-  for (int64_t i = 0; i < num_elements; ++i) {
-    out_data[i] = static_cast<int16_t>(
-        std::abs<int32_t>(static_cast<int32_t>(in_data[i])));
-  }
+  cpu_backend_threadpool::ParallelFor(
+      num_elements, kMinElementsPerShard,
+      CpuBackendContext::GetFromContext(context),
+      [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+          out_data[i] = static_cast<int16_t>(
+              std::abs<int32_t>(static_cast<int32_t>(in_data[i])));
+        }
+      });
   return kTfLiteOk;
 }
 
@@ -65,6 +65,16 @@ bool SupportedSparsityFormat(const TfLiteSparsity& sparsity) {
 static const int kDimMetadataSizeRandomSparse = 2;
 static const int kDimMetadataSizeBlockSparse = 3;
 
+// Returns the dimension of the weights that is split into blocks, i.e. 0 for
+// Nx1 blocks and 1 for 1xN blocks, or -1 if the weights are not block sparse.
+int GetBlockedDimension(const TfLiteSparsity& sparsity) {
+  if (sparsity.dim_metadata_size != kDimMetadataSizeBlockSparse ||
+      sparsity.block_map == nullptr || sparsity.block_map->size != 1) {
+    return -1;
+  }
+  return sparsity.block_map->data[0];
+}
+
 TfLiteStatus CreateLedgerTensor(const TfLiteSparsity* sparsity,
                                 TfLiteContext* context, TfLiteTensor* ledger) {
   TF_LITE_ENSURE(context, sparsity != nullptr);
@@ -1592,7 +1602,7 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
             filter_shape, GetTensorData<float>(filter),  // Disable formatting
             bias_shape, GetTensorData<float>(bias),      // Disable formatting
             output_shape, GetTensorData<float>(output));
-      } else if (sparsity.dim_metadata_size == kDimMetadataSizeBlockSparse &&
+      } else if (GetBlockedDimension(sparsity) == 1 &&
                  sparsity.dim_metadata[2].dense_size == 4) {
         // Block sparse with block size of 1x4.
         optimized_ops::FullyConnectedSparseWeight1x4(
@@ -1602,6 +1612,28 @@ TfLiteStatus EvalFloat(TfLiteContext* context, TfLiteNode* node,
             bias_shape, GetTensorData<float>(bias),      // Disable formatting
             output_shape, GetTensorData<float>(output),
             CpuBackendContext::GetFromContext(context));
+      } else if (GetBlockedDimension(sparsity) == 0 &&
+                 sparsity.dim_metadata[0].dense_size *
+                         sparsity.dim_metadata[2].dense_size ==
+                     filter_shape.Dims(0) &&
+                 (sparsity.dim_metadata[2].dense_size == 4 ||
+                  sparsity.dim_metadata[2].dense_size == 8)) {
+        // Block sparse with block size of 4x1 or 8x1.
+        if (sparsity.dim_metadata[2].dense_size == 4) {
+          optimized_ops::FullyConnectedSparseWeight4x1(
+              sparsity, op_params, input_shape, GetTensorData<float>(input),
+              filter_shape, GetTensorData<float>(filter), bias_shape,
+              GetTensorData<float>(bias), output_shape,
+              GetTensorData<float>(output),
+              CpuBackendContext::GetFromContext(context));
+        } else {
+          optimized_ops::FullyConnectedSparseWeight8x1(
+              sparsity, op_params, input_shape, GetTensorData<float>(input),
+              filter_shape, GetTensorData<float>(filter), bias_shape,
+              GetTensorData<float>(bias), output_shape,
+              GetTensorData<float>(output),
+              CpuBackendContext::GetFromContext(context));
+        }
       } else {
         TF_LITE_KERNEL_LOG(context,
                            "Unsupported sparse fully-connected weight format.");
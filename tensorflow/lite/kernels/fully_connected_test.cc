@@ -2105,6 +2105,85 @@ TEST_P(SparseFullyConnectedOpTest, Simple1x4TestMultiThreadedMoreBatches) {
   }
 }
 
+TEST_P(SparseFullyConnectedOpTest, Simple4x1TestMultiThreaded) {
+  std::initializer_list<float> weight_data = {
+      1, 0, 2,  0, 0, 3,   // u = 0
+      2, 0, 1,  0, 0, -1,  // u = 1
+      3, 0, -1, 0, 0, 2,   // u = 2
+      4, 0, 1,  0, 0, 1,   // u = 3
+      0, 1, 0,  0, 2, 0,   // u = 4
+      0, 2, 0,  0, -1, 0,  // u = 5
+      0, -3, 0, 0, 1, 0,   // u = 6
+      0, 1, 0,  0, 1, 0,   // u = 7
+  };
+  TensorData weight = {};
+  weight.type = TensorType_FLOAT32;
+  weight.shape = {8, 6};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {0};
+  weight.block_size = {4};
+  for (int num_threads = 1; num_threads <= 4; num_threads++) {
+    SparseFullyConnectedOpModel<float> m(
+        GetRegistration(),
+        /*units=*/8, /*batches=*/2,
+        /*input=*/{TensorType_FLOAT32, {2, 6}}, weight, weight_data,
+        /*output=*/{TensorType_FLOAT32},
+        /*bias_tensor_optional=*/false, /*num_threads=*/num_threads);
+    m.SetBias({1, 2, 3, 4, 5, 6, 7, 8});
+
+    m.SetInput({
+        1,  2, 3,  4, 5, 6,   // b = 0
+        -1, 2, -3, 4, 5, -6,  // b = 1
+    });
+
+    ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+    EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 8));
+    EXPECT_THAT(m.GetOutput(),
+                ElementsAre(26, 1, 15, 17, 17, 5, 6, 15,  // b = 0
+                            0, 3, 0, 0, 17, 5, 6, 15      // b = 1
+                            ));
+  }
+}
+
+TEST_P(SparseFullyConnectedOpTest, Simple8x1TestNoBias) {
+  std::initializer_list<float> weight_data = {
+      1, 0, 2,  0, 0, 3,   // u = 0
+      2, 0, 1,  0, 0, -1,  // u = 1
+      3, 0, -1, 0, 0, 2,   // u = 2
+      4, 0, 1,  0, 0, 1,   // u = 3
+      0, 1, 0,  0, 2, 0,   // u = 4
+      0, 2, 0,  0, -1, 0,  // u = 5
+      0, -3, 0, 0, 1, 0,   // u = 6
+      0, 1, 0,  0, 1, 0,   // u = 7
+  };
+  TensorData weight = {};
+  weight.type = TensorType_FLOAT32;
+  weight.shape = {8, 6};
+  weight.traversal_order = {0, 1, 2};
+  weight.format = {kTfLiteDimDense, kTfLiteDimSparseCSR};
+  weight.block_map = {0};
+  weight.block_size = {8};
+  SparseFullyConnectedOpModel<float> m(GetRegistration(),
+                                       /*units=*/8, /*batches=*/2,
+                                       /*input=*/{TensorType_FLOAT32, {2, 6}},
+                                       weight, weight_data,
+                                       /*output=*/{TensorType_FLOAT32},
+                                       /*bias_tensor_optional=*/true);
+  m.SetInput({
+      1,  2, 3,  4, 5, 6,   // b = 0
+      -1, 2, -3, 4, 5, -6,  // b = 1
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(2, 8));
+  EXPECT_THAT(m.GetOutput(), ElementsAre(25, 0, 12, 13, 12, 0, 0, 7,  // b = 0
+                                         0, 1, 0, 0, 12, 0, 0, 7      // b = 1
+                                         ));
+}
+
 TEST_P(SparseHybridFullyConnectedOpTest, SparseHybrid1x16Test) {
   std::initializer_list<float> weight_data = {
       /* 1st row */
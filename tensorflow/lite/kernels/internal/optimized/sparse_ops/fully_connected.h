@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "ruy/profiler/instrumentation.h"  // from @ruy
 #include "tensorflow/lite/core/c/common.h"
@@ -263,6 +264,163 @@ inline void FullyConnectedSparseWeight1x4(
                                   cpu_backend_context);
 }
 
+// Block sparse kernel for weights whose blocks span `kBlockRows` consecutive
+// output rows of a single input column, i.e. 4x1 and 8x1 blocks. Every stored
+// block multiplies a single input value, so each block row accumulates
+// `kBlockRows` outputs at once without the reduction the 1xN kernels need.
+// Processes the block rows in [block_start, block_end).
+template <int kBlockRows>
+inline void FullyConnectedSparseWeightNx1Impl(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data, int block_start,
+    int block_end) {
+  ruy::profiler::ScopeLabel label("FullyConnected");
+  ruy::profiler::ScopeLabel inner_label("Nx1 Block Sparse");
+  const float output_activation_min = params.float_activation_min;
+  const float output_activation_max = params.float_activation_max;
+
+  const int output_dims_count = output_shape.DimensionsCount();
+  const int weights_dims_count = weights_shape.DimensionsCount();
+  const int batches = FlatSizeSkipDim(output_shape, output_dims_count - 1);
+  const int output_depth = MatchingDim(weights_shape, weights_dims_count - 2,
+                                       output_shape, output_dims_count - 1);
+  const int accum_depth = weights_shape.Dims(weights_dims_count - 1);
+  const int* w1_segments = sparsity.dim_metadata[1].array_segments->data;
+  const int* w1_indices = sparsity.dim_metadata[1].array_indices->data;
+
+  for (int b = 0; b < batches; ++b) {
+    const float* input_in_batch = input_data + b * accum_depth;
+    float* output_in_batch = output_data + b * output_depth;
+    for (int block = block_start; block < block_end; ++block) {
+      const int row_start = block * kBlockRows;
+      float acc[kBlockRows];
+      for (int r = 0; r < kBlockRows; ++r) {
+        acc[r] = bias_data ? bias_data[row_start + r] : 0.f;
+      }
+      for (int pw1 = w1_segments[block]; pw1 < w1_segments[block + 1];
+           ++pw1) {
+        const float input_value = input_in_batch[w1_indices[pw1]];
+        const float* weights_block = weights_data + pw1 * kBlockRows;
+        for (int r = 0; r < kBlockRows; ++r) {
+          acc[r] += weights_block[r] * input_value;
+        }
+      }
+      for (int r = 0; r < kBlockRows; ++r) {
+        output_in_batch[row_start + r] = ActivationFunctionWithMinMax(
+            acc[r], output_activation_min, output_activation_max);
+      }
+    }
+  }
+}
+
+template <int kBlockRows>
+struct FullyConnectedSparseWeightNx1Task : cpu_backend_threadpool::Task {
+  FullyConnectedSparseWeightNx1Task(
+      const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+      const RuntimeShape& input_shape, const float* input_data,
+      const RuntimeShape& weights_shape, const float* weights_data,
+      const RuntimeShape& bias_shape, const float* bias_data,
+      const RuntimeShape& output_shape, float* output_data, int block_start,
+      int block_end)
+      : sparsity(sparsity),
+        params(params),
+        input_shape(input_shape),
+        input_data(input_data),
+        weights_shape(weights_shape),
+        weights_data(weights_data),
+        bias_shape(bias_shape),
+        bias_data(bias_data),
+        output_shape(output_shape),
+        output_data(output_data),
+        block_start(block_start),
+        block_end(block_end) {}
+
+  void Run() override {
+    FullyConnectedSparseWeightNx1Impl<kBlockRows>(
+        sparsity, params, input_shape, input_data, weights_shape, weights_data,
+        bias_shape, bias_data, output_shape, output_data, block_start,
+        block_end);
+  }
+
+ private:
+  const TfLiteSparsity& sparsity;
+  const FullyConnectedParams& params;
+  const RuntimeShape& input_shape;
+  const float* input_data;
+  const RuntimeShape& weights_shape;
+  const float* weights_data;
+  const RuntimeShape& bias_shape;
+  const float* bias_data;
+  const RuntimeShape& output_shape;
+  float* output_data;
+  int block_start;
+  int block_end;
+};
+
+// Unlike the 1x4 kernel, the Nx1 kernels slice the workload along the block
+// rows of the weights, so that single batch inference also uses all threads.
+// The output depth must be a multiple of `kBlockRows`.
+template <int kBlockRows>
+inline void FullyConnectedSparseWeightNx1(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  const int num_blocks = sparsity.dim_metadata[0].dense_size;
+  const int max_threads = cpu_backend_context->max_num_threads();
+  const int thread_count = std::max(1, std::min(num_blocks, max_threads));
+  if (thread_count == 1) {
+    return FullyConnectedSparseWeightNx1Impl<kBlockRows>(
+        sparsity, params, input_shape, input_data, weights_shape, weights_data,
+        bias_shape, bias_data, output_shape, output_data, 0, num_blocks);
+  }
+  std::vector<FullyConnectedSparseWeightNx1Task<kBlockRows>> tasks;
+  tasks.reserve(thread_count);
+  int block_start = 0;
+  for (int i = 0; i < thread_count; ++i) {
+    int block_end = block_start + num_blocks / thread_count;
+    if (i < num_blocks % thread_count) block_end++;
+
+    tasks.emplace_back(sparsity, params, input_shape, input_data, weights_shape,
+                       weights_data, bias_shape, bias_data, output_shape,
+                       output_data, block_start, block_end);
+    block_start = block_end;
+  }
+  cpu_backend_threadpool::Execute(tasks.size(), tasks.data(),
+                                  cpu_backend_context);
+}
+
+inline void FullyConnectedSparseWeight4x1(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  FullyConnectedSparseWeightNx1<4>(sparsity, params, input_shape, input_data,
+                                   weights_shape, weights_data, bias_shape,
+                                   bias_data, output_shape, output_data,
+                                   cpu_backend_context);
+}
+
+inline void FullyConnectedSparseWeight8x1(
+    const TfLiteSparsity& sparsity, const FullyConnectedParams& params,
+    const RuntimeShape& input_shape, const float* input_data,
+    const RuntimeShape& weights_shape, const float* weights_data,
+    const RuntimeShape& bias_shape, const float* bias_data,
+    const RuntimeShape& output_shape, float* output_data,
+    CpuBackendContext* cpu_backend_context) {
+  FullyConnectedSparseWeightNx1<8>(sparsity, params, input_shape, input_data,
+                                   weights_shape, weights_data, bias_shape,
+                                   bias_data, output_shape, output_data,
+                                   cpu_backend_context);
+}
+
 }  // namespace optimized_ops
 }  // namespace tflite
 #endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_SPARSE_OPS_FULLY_CONNECTED_H_
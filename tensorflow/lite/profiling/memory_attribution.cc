@@ -0,0 +1,280 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/memory_attribution.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/util.h"
+
+namespace tflite::profiling {
+namespace {
+
+double ToMB(size_t bytes) { return static_cast<double>(bytes) / (1 << 20); }
+
+std::string NodeName(const Subgraph& subgraph, int node_index) {
+  const auto* node_and_registration =
+      subgraph.node_and_registration(node_index);
+  if (node_and_registration == nullptr) return "unknown";
+  return "node " + std::to_string(node_index) + " (" +
+         GetOpNameByRegistration(node_and_registration->second) + ")";
+}
+
+std::string TensorName(const Subgraph& subgraph, int tensor_index) {
+  const TfLiteTensor* tensor = subgraph.tensor(tensor_index);
+  std::string name = "tensor " + std::to_string(tensor_index);
+  if (tensor != nullptr && tensor->name != nullptr && *tensor->name != '\0') {
+    name += " '" + std::string(tensor->name) + "'";
+  }
+  return name;
+}
+
+bool IsDelegateNode(const Subgraph& subgraph, int node_index) {
+  const auto* node_and_registration =
+      subgraph.node_and_registration(node_index);
+  return node_and_registration != nullptr &&
+         node_and_registration->second.builtin_code == kTfLiteBuiltinDelegate;
+}
+
+}  // namespace
+
+std::vector<const ArenaTensorLifetime*>
+SubgraphMemoryAttribution::LiveTensorsAt(int position) const {
+  std::vector<const ArenaTensorLifetime*> live;
+  for (const ArenaTensorLifetime& tensor : tensors) {
+    if (tensor.first_position <= position && position <= tensor.last_position) {
+      live.push_back(&tensor);
+    }
+  }
+  std::stable_sort(live.begin(), live.end(),
+                   [](const ArenaTensorLifetime* a,
+                      const ArenaTensorLifetime* b) {
+                     return a->first_position < b->first_position;
+                   });
+  return live;
+}
+
+SubgraphMemoryAttribution AttributeSubgraphMemory(const Subgraph& subgraph) {
+  SubgraphMemoryAttribution attribution;
+  Subgraph::SubgraphAllocInfo alloc_info;
+  subgraph.GetMemoryAllocInfo(&alloc_info);
+  attribution.arena_size = alloc_info.arena_size;
+  attribution.arena_persist_size = alloc_info.arena_persist_size;
+
+  const std::vector<int>& execution_plan = subgraph.execution_plan();
+  const int num_positions = execution_plan.size();
+  if (num_positions == 0) return attribution;
+  const int last_position = num_positions - 1;
+
+  // Index of each arena tensor in `attribution.tensors`, by tensor index.
+  std::vector<int> lifetime_index(subgraph.tensors_size(), -1);
+  auto lifetime = [&](int tensor_index) -> ArenaTensorLifetime* {
+    if (tensor_index < 0 ||
+        static_cast<size_t>(tensor_index) >= subgraph.tensors_size()) {
+      return nullptr;
+    }
+    const TfLiteTensor* tensor = subgraph.tensor(tensor_index);
+    if (tensor->allocation_type != kTfLiteArenaRw || tensor->bytes == 0) {
+      return nullptr;
+    }
+    if (lifetime_index[tensor_index] < 0) {
+      lifetime_index[tensor_index] = attribution.tensors.size();
+      attribution.tensors.push_back(
+          {tensor_index, tensor->bytes, num_positions, -1});
+    }
+    return &attribution.tensors[lifetime_index[tensor_index]];
+  };
+  auto extend = [](ArenaTensorLifetime* tensor, int position) {
+    tensor->first_position = std::min(tensor->first_position, position);
+    tensor->last_position = std::max(tensor->last_position, position);
+  };
+
+  // Like the arena planner, graph inputs and outputs are never overwritten.
+  for (int tensor_index : subgraph.inputs()) {
+    if (ArenaTensorLifetime* tensor = lifetime(tensor_index)) {
+      tensor->is_graph_input = true;
+      extend(tensor, 0);
+      extend(tensor, last_position);
+    }
+  }
+  for (int position = 0; position < num_positions; ++position) {
+    const int node_index = execution_plan[position];
+    const TfLiteNode& node = subgraph.node_and_registration(node_index)->first;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (ArenaTensorLifetime* tensor = lifetime(tensor_index)) {
+        extend(tensor, position);
+        tensor->last_consumer_node = node_index;
+      }
+    }
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (ArenaTensorLifetime* tensor = lifetime(tensor_index)) {
+        extend(tensor, position);
+        if (tensor->producer_node < 0 && !tensor->is_graph_input) {
+          tensor->producer_node = node_index;
+        }
+      }
+    }
+    if (node.temporaries != nullptr) {
+      for (int tensor_index : TfLiteIntArrayView(node.temporaries)) {
+        if (ArenaTensorLifetime* tensor = lifetime(tensor_index)) {
+          extend(tensor, position);
+          tensor->producer_node = node_index;
+        }
+      }
+    }
+  }
+  for (int tensor_index : subgraph.outputs()) {
+    if (ArenaTensorLifetime* tensor = lifetime(tensor_index)) {
+      tensor->is_graph_output = true;
+      extend(tensor, last_position);
+    }
+  }
+
+  attribution.live_bytes.assign(num_positions, 0);
+  for (const ArenaTensorLifetime& tensor : attribution.tensors) {
+    for (int position = tensor.first_position;
+         position <= tensor.last_position; ++position) {
+      attribution.live_bytes[position] += tensor.bytes;
+    }
+  }
+  for (int position = 0; position < num_positions; ++position) {
+    if (attribution.live_bytes[position] > attribution.peak_bytes) {
+      attribution.peak_bytes = attribution.live_bytes[position];
+      attribution.peak_position = position;
+    }
+  }
+  return attribution;
+}
+
+std::string FormatMemoryAttribution(
+    const Subgraph& subgraph, const SubgraphMemoryAttribution& attribution,
+    int top_k) {
+  std::stringstream report;
+  report << std::fixed << std::setprecision(3);
+  report << "Memory attribution of subgraph " << subgraph.GetSubgraphIndex()
+         << ": arena " << ToMB(attribution.arena_size)
+         << " MB, persistent arena " << ToMB(attribution.arena_persist_size)
+         << " MB.\n";
+  if (attribution.peak_position < 0) {
+    report << "No tensors are allocated in the arena.\n";
+    return report.str();
+  }
+
+  const std::vector<int>& execution_plan = subgraph.execution_plan();
+  report << "Live arena tensors while each node runs:\n";
+  for (size_t position = 0; position < attribution.live_bytes.size();
+       ++position) {
+    report << "  [" << position << "] "
+           << NodeName(subgraph, execution_plan[position]) << ": "
+           << ToMB(attribution.live_bytes[position]) << " MB\n";
+  }
+
+  const int peak_node = execution_plan[attribution.peak_position];
+  report << "Peak of " << ToMB(attribution.peak_bytes) << " MB at "
+         << NodeName(subgraph, peak_node) << ", position "
+         << attribution.peak_position << ".\n";
+
+  // The tensors that force the peak, in allocation order.
+  std::vector<const ArenaTensorLifetime*> live =
+      attribution.LiveTensorsAt(attribution.peak_position);
+  std::vector<const ArenaTensorLifetime*> largest = live;
+  std::stable_sort(largest.begin(), largest.end(),
+                   [](const ArenaTensorLifetime* a,
+                      const ArenaTensorLifetime* b) {
+                     return a->bytes > b->bytes;
+                   });
+  if (largest.size() > static_cast<size_t>(top_k)) largest.resize(top_k);
+  report << "Largest tensors live at the peak, in allocation order:\n";
+  for (const ArenaTensorLifetime* tensor : live) {
+    if (std::find(largest.begin(), largest.end(), tensor) == largest.end()) {
+      continue;
+    }
+    report << "  " << TensorName(subgraph, tensor->tensor_index) << ": "
+           << ToMB(tensor->bytes) << " MB, ";
+    if (tensor->is_graph_input) {
+      report << "graph input";
+    } else {
+      report << "written by " << NodeName(subgraph, tensor->producer_node);
+    }
+    if (tensor->is_graph_output) {
+      report << ", graph output";
+    } else if (tensor->last_consumer_node >= 0) {
+      report << ", held until "
+             << NodeName(subgraph, tensor->last_consumer_node);
+    }
+    report << "\n";
+  }
+
+  // Bytes at the peak, by the node that writes them.
+  std::map<int, size_t> bytes_by_producer;
+  for (const ArenaTensorLifetime* tensor : live) {
+    bytes_by_producer[tensor->producer_node] += tensor->bytes;
+  }
+  std::vector<std::pair<int, size_t>> producers(bytes_by_producer.begin(),
+                                                bytes_by_producer.end());
+  std::stable_sort(producers.begin(), producers.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second > b.second;
+                   });
+  if (producers.size() > static_cast<size_t>(top_k)) producers.resize(top_k);
+  report << "Peak bytes by the node that writes them:\n";
+  for (const auto& [node_index, bytes] : producers) {
+    report << "  "
+           << (node_index < 0 ? "graph inputs" : NodeName(subgraph, node_index))
+           << ": " << ToMB(bytes) << " MB\n";
+  }
+
+  // Delegate partitions only keep their boundary tensors in the arena.
+  bool has_delegate_partitions = false;
+  for (size_t position = 0; position < execution_plan.size(); ++position) {
+    const int node_index = execution_plan[position];
+    if (!IsDelegateNode(subgraph, node_index)) continue;
+    if (!has_delegate_partitions) {
+      report << "Delegate partitions:\n";
+      has_delegate_partitions = true;
+    }
+    size_t output_bytes = 0;
+    for (const ArenaTensorLifetime& tensor : attribution.tensors) {
+      if (tensor.producer_node == node_index) output_bytes += tensor.bytes;
+    }
+    report << "  " << NodeName(subgraph, node_index) << ": writes "
+           << ToMB(output_bytes) << " MB, "
+           << ToMB(attribution.live_bytes[position])
+           << " MB live while it runs\n";
+  }
+  return report.str();
+}
+
+std::string FormatInterpreterMemoryAttribution(const Interpreter& interpreter,
+                                               int top_k) {
+  std::string report;
+  for (size_t i = 0; i < interpreter.subgraphs_size(); ++i) {
+    const Subgraph& subgraph = *interpreter.subgraph(i);
+    report += FormatMemoryAttribution(
+        subgraph, AttributeSubgraphMemory(subgraph), top_k);
+  }
+  return report;
+}
+
+}  // namespace tflite::profiling
@@ -0,0 +1,80 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_MEMORY_ATTRIBUTION_H_
+#define TENSORFLOW_LITE_PROFILING_MEMORY_ATTRIBUTION_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+
+namespace tflite::profiling {
+
+// Lifetime of a tensor in the read-write arena of a subgraph. Positions are
+// indices into the execution plan.
+struct ArenaTensorLifetime {
+  int tensor_index;
+  size_t bytes;
+  int first_position;
+  int last_position;
+  // Node that writes the tensor, or -1 for graph inputs.
+  int producer_node = -1;
+  // Last node that reads the tensor, or -1 if it is never read.
+  int last_consumer_node = -1;
+  // Graph inputs and outputs stay allocated during the whole invocation.
+  bool is_graph_input = false;
+  bool is_graph_output = false;
+};
+
+// Attributes the read-write arena usage of a subgraph to its tensors and
+// nodes, based on the lifetimes the arena planner assigns to tensors.
+struct SubgraphMemoryAttribution {
+  std::vector<ArenaTensorLifetime> tensors;
+  // Bytes of the tensors live while each node of the execution plan runs.
+  std::vector<size_t> live_bytes;
+  // Position of the first node at which the live bytes peak, or -1 if the
+  // subgraph holds no arena tensors.
+  int peak_position = -1;
+  size_t peak_bytes = 0;
+  // Actual sizes of the arenas. The read-write arena can be larger than the
+  // peak because of fragmentation.
+  size_t arena_size = 0;
+  size_t arena_persist_size = 0;
+
+  // Returns the tensors live at `position`, in allocation order.
+  std::vector<const ArenaTensorLifetime*> LiveTensorsAt(int position) const;
+};
+
+// Computes the memory attribution of the current execution plan of
+// `subgraph`, i.e. after delegation. Tensors must have been allocated.
+SubgraphMemoryAttribution AttributeSubgraphMemory(const Subgraph& subgraph);
+
+// Returns a human readable report of `attribution`: the live bytes at every
+// node, the tensors live at the peak with the nodes that write and last read
+// them, the peak bytes written by each node, and what every delegate partition
+// keeps alive. Only the `top_k` largest entries of each list are printed.
+std::string FormatMemoryAttribution(
+    const Subgraph& subgraph, const SubgraphMemoryAttribution& attribution,
+    int top_k = 10);
+
+// Returns the reports of all subgraphs of `interpreter`.
+std::string FormatInterpreterMemoryAttribution(const Interpreter& interpreter,
+                                               int top_k = 10);
+
+}  // namespace tflite::profiling
+
+#endif  // TENSORFLOW_LITE_PROFILING_MEMORY_ATTRIBUTION_H_
@@ -0,0 +1,105 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/memory_attribution.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+
+namespace tflite::profiling {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+class MemoryAttributionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // A chain of three additions of 16 floats: 0 -> 1 -> 2 -> 3.
+    interpreter_.AddTensors(4);
+    interpreter_.SetInputs({0});
+    interpreter_.SetOutputs({3});
+    TfLiteQuantizationParams quant;
+    for (int i = 0; i < 4; ++i) {
+      const std::string name = "t" + std::to_string(i);
+      interpreter_.SetTensorParametersReadWrite(i, kTfLiteFloat32,
+                                                name.c_str(), {16}, quant);
+    }
+    for (int i = 0; i < 3; ++i) {
+      auto* params =
+          reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+      params->activation = kTfLiteActNone;
+      interpreter_.AddNodeWithParameters({i, i}, {i + 1}, nullptr, 0, params,
+                                         ops::builtin::Register_ADD());
+    }
+    ASSERT_EQ(interpreter_.AllocateTensors(), kTfLiteOk);
+  }
+
+  Interpreter interpreter_;
+};
+
+TEST_F(MemoryAttributionTest, FindsPeakAndLiveTensors) {
+  const SubgraphMemoryAttribution attribution =
+      AttributeSubgraphMemory(interpreter_.primary_subgraph());
+  ASSERT_EQ(attribution.tensors.size(), 4);
+  // The graph input stays live; intermediates die after their last reader.
+  EXPECT_THAT(attribution.live_bytes, ElementsAre(128, 192, 192));
+  EXPECT_EQ(attribution.peak_position, 1);
+  EXPECT_EQ(attribution.peak_bytes, 192);
+  EXPECT_GE(attribution.arena_size, attribution.peak_bytes);
+
+  std::vector<int> live;
+  for (const ArenaTensorLifetime* tensor : attribution.LiveTensorsAt(1)) {
+    live.push_back(tensor->tensor_index);
+  }
+  EXPECT_THAT(live, ElementsAre(0, 1, 2));
+}
+
+TEST_F(MemoryAttributionTest, RecordsProducersAndConsumers) {
+  const SubgraphMemoryAttribution attribution =
+      AttributeSubgraphMemory(interpreter_.primary_subgraph());
+  ASSERT_EQ(attribution.tensors.size(), 4);
+  const ArenaTensorLifetime& input = attribution.tensors[0];
+  EXPECT_TRUE(input.is_graph_input);
+  EXPECT_EQ(input.producer_node, -1);
+  EXPECT_EQ(input.last_position, 2);
+  const ArenaTensorLifetime& intermediate = attribution.tensors[1];
+  EXPECT_EQ(intermediate.tensor_index, 1);
+  EXPECT_EQ(intermediate.producer_node, 0);
+  EXPECT_EQ(intermediate.last_consumer_node, 1);
+  EXPECT_EQ(intermediate.first_position, 0);
+  EXPECT_EQ(intermediate.last_position, 1);
+  const ArenaTensorLifetime& output = attribution.tensors[3];
+  EXPECT_TRUE(output.is_graph_output);
+  EXPECT_EQ(output.producer_node, 2);
+}
+
+TEST_F(MemoryAttributionTest, FormatsReport) {
+  const std::string report = FormatInterpreterMemoryAttribution(interpreter_);
+  EXPECT_THAT(report, HasSubstr("Peak of"));
+  EXPECT_THAT(report, HasSubstr("node 1 (ADD)"));
+  EXPECT_THAT(report, HasSubstr("tensor 2 't2'"));
+  EXPECT_THAT(report, ::testing::Not(HasSubstr("Delegate partitions")));
+}
+
+}  // namespace
+}  // namespace tflite::profiling
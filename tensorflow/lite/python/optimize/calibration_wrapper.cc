@@ -41,6 +41,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 // NOLINTEND
@@ -815,6 +816,15 @@ PyObject* CalibrationWrapper::QuantizeModel(int input_py_type,
     *error_msg = error_reporter->message();
     return nullptr;
   }
+  // The whole representative dataset is run through the float model, so let
+  // the kernels use all cores. The statistics are still logged on the invoking
+  // thread, after each op.
+  status = interpreter->SetNumThreads(
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  if (status != kTfLiteOk) {
+    *error_msg = error_reporter->message();
+    return nullptr;
+  }
 
   auto model_str = std::make_unique<std::string>(buf, length);
   // If we are not going to use this string during quantization, reset the
@@ -234,7 +234,7 @@ TfLiteStatus SimpleMemoryArena::Allocate(
     TfLiteContext* context, size_t alignment, size_t size, int32_t tensor,
     int32_t first_node, int32_t last_node,
     ArenaAllocWithUsageInterval* new_alloc) {
-  TF_LITE_ENSURE(context, alignment <= underlying_buffer_.GetAlignment());
+  TF_LITE_ENSURE(context, alignment <= buffer().GetAlignment());
   new_alloc->tensor = tensor;
   new_alloc->first_node = first_node;
   new_alloc->last_node = last_node;
@@ -288,7 +288,13 @@ TfLiteStatus SimpleMemoryArena::Commit(bool* arena_reallocated) {
   // Resize the arena to the high water mark (calculated by Allocate), retaining
   // old contents and alignment in the process. Since Alloc pointers are offset
   // based, they will remain valid in the new memory block.
-  *arena_reallocated = underlying_buffer_.Resize(high_water_mark_);
+  *arena_reallocated = buffer().Resize(high_water_mark_);
+  // A shared buffer may also have been moved by another arena since this one
+  // was last committed.
+  if (shared_buffer_ && buffer().GetPtr() != committed_ptr_) {
+    *arena_reallocated = true;
+  }
+  committed_ptr_ = buffer().GetPtr();
   committed_ = true;
   return kTfLiteOk;
 }
@@ -298,12 +304,11 @@ TfLiteStatus SimpleMemoryArena::ResolveAlloc(
     char** output_ptr) {
   TF_LITE_ENSURE(context, committed_);
   TF_LITE_ENSURE(context, output_ptr != nullptr);
-  TF_LITE_ENSURE(context,
-                 underlying_buffer_.GetSize() >= (alloc.offset + alloc.size));
+  TF_LITE_ENSURE(context, buffer().GetSize() >= (alloc.offset + alloc.size));
   if (alloc.size == 0) {
     *output_ptr = nullptr;
   } else {
-    *output_ptr = underlying_buffer_.GetPtr() + alloc.offset;
+    *output_ptr = buffer().GetPtr() + alloc.offset;
   }
   return kTfLiteOk;
 }
@@ -317,7 +322,11 @@ TfLiteStatus SimpleMemoryArena::ClearPlan() {
 
 TfLiteStatus SimpleMemoryArena::ReleaseBuffer() {
   committed_ = false;
-  underlying_buffer_.Release();
+  // A shared buffer is still used by other arenas, and is released along with
+  // the last one of them.
+  if (!shared_buffer_) {
+    underlying_buffer_.Release();
+  }
   return kTfLiteOk;
 }
 
@@ -329,7 +338,7 @@ TFLITE_ATTRIBUTE_WEAK void DumpArenaInfo(
 
 void SimpleMemoryArena::DumpDebugInfo(
     const std::string& name, const std::vector<int>& execution_plan) const {
-  tflite::DumpArenaInfo(name, execution_plan, underlying_buffer_.GetSize(),
+  tflite::DumpArenaInfo(name, execution_plan, buffer().GetSize(),
                         active_allocs_);
 }
 
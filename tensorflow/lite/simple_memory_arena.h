@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/lite/core/c/common.h"
@@ -111,8 +113,25 @@ class SimpleMemoryArena {
       : committed_(false),
         high_water_mark_(0),
         underlying_buffer_(arena_alignment, subgraph_index),
+        committed_ptr_(nullptr),
         active_allocs_() {}
 
+  // Makes the arena place its allocations in `buffer` instead of a buffer of
+  // its own. `buffer` may be shared with arenas of other interpreters, as long
+  // as they never run at the same time: each arena grows the buffer to its own
+  // high water mark on Commit(), and tensor data does not survive the use of
+  // the buffer by another arena. Must be called before the first Commit().
+  void SetSharedBuffer(std::shared_ptr<ResizableAlignedBuffer> buffer) {
+    shared_buffer_ = std::move(buffer);
+  }
+
+  // Returns true if the arena was committed but the underlying buffer has been
+  // moved since, which can only happen when it is shared. Allocations need to
+  // be committed and resolved again before they are used.
+  bool BufferMovedSinceCommit() const {
+    return committed_ && buffer().GetPtr() != committed_ptr_;
+  }
+
   // Delete all allocs. This should be called when allocating the first node of
   // a subgraph.
   void ResetAllocs();
@@ -158,10 +177,14 @@ class SimpleMemoryArena {
   // again until Commit() is called & tensor allocations are resolved.
   TfLiteStatus ReleaseBuffer();
 
-  size_t GetBufferSize() const { return underlying_buffer_.GetSize(); }
+  size_t GetBufferSize() const { return buffer().GetSize(); }
+
+  // Size the underlying buffer needs to be to hold all allocations made so
+  // far. The buffer is only resized to this size on Commit().
+  size_t RequiredBufferSize() const { return high_water_mark_; }
 
   std::intptr_t BasePointer() const {
-    return reinterpret_cast<std::intptr_t>(underlying_buffer_.GetPtr());
+    return reinterpret_cast<std::intptr_t>(buffer().GetPtr());
   }
 
   // Dumps the memory allocation information of this memory arena (which could
@@ -182,9 +205,20 @@ class SimpleMemoryArena {
                      const std::vector<int>& execution_plan) const;
 
  private:
+  ResizableAlignedBuffer& buffer() {
+    return shared_buffer_ ? *shared_buffer_ : underlying_buffer_;
+  }
+  const ResizableAlignedBuffer& buffer() const {
+    return shared_buffer_ ? *shared_buffer_ : underlying_buffer_;
+  }
+
   bool committed_;
   size_t high_water_mark_;
   ResizableAlignedBuffer underlying_buffer_;
+  // Buffer shared with other arenas, used instead of `underlying_buffer_`.
+  std::shared_ptr<ResizableAlignedBuffer> shared_buffer_;
+  // Data pointer of the buffer at the last Commit().
+  char* committed_ptr_;
   std::vector<ArenaAllocWithUsageInterval> active_allocs_;
 };
 
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/simple_memory_arena.h"
 
+#include <memory>
+
 #include <gtest/gtest.h>
 #include "tensorflow/lite/core/c/common.h"
 
@@ -321,6 +323,50 @@ TEST(SimpleMemoryArenaTest, TestClearBuffer) {
   EXPECT_NE(resolved_ptr, nullptr);
 }
 
+TEST(SimpleMemoryArenaTest, TestSharedBuffer) {
+  TfLiteContext context;
+  context.ReportError = ReportError;
+  auto buffer = std::make_shared<ResizableAlignedBuffer>(64, 0);
+  SimpleMemoryArena small_arena(64);
+  SimpleMemoryArena large_arena(64);
+  small_arena.SetSharedBuffer(buffer);
+  large_arena.SetSharedBuffer(buffer);
+  ArenaAllocWithUsageInterval small_alloc;
+  ArenaAllocWithUsageInterval large_alloc;
+  small_arena.Allocate(&context, 32, 1023, 0, 0, 2, &small_alloc);
+  large_arena.Allocate(&context, 32, 4095, 0, 0, 2, &large_alloc);
+
+  bool reallocated = false;
+  ASSERT_EQ(small_arena.Commit(&reallocated), kTfLiteOk);
+  EXPECT_TRUE(reallocated);
+  EXPECT_FALSE(small_arena.BufferMovedSinceCommit());
+  EXPECT_EQ(buffer->GetSize(), 1023);
+
+  // Growing the buffer from the other arena invalidates the first one.
+  ASSERT_EQ(large_arena.Commit(&reallocated), kTfLiteOk);
+  EXPECT_TRUE(reallocated);
+  EXPECT_EQ(buffer->GetSize(), 4095);
+  EXPECT_TRUE(small_arena.BufferMovedSinceCommit());
+  EXPECT_EQ(small_arena.BasePointer(), large_arena.BasePointer());
+
+  // Committing again reports the move, and resolves into the shared buffer.
+  ASSERT_EQ(small_arena.Commit(&reallocated), kTfLiteOk);
+  EXPECT_TRUE(reallocated);
+  EXPECT_FALSE(small_arena.BufferMovedSinceCommit());
+  EXPECT_EQ(buffer->GetSize(), 4095);
+  ASSERT_EQ(large_arena.Commit(&reallocated), kTfLiteOk);
+  EXPECT_FALSE(reallocated);
+  char* resolved_ptr = nullptr;
+  ASSERT_EQ(small_arena.ResolveAlloc(&context, small_alloc, &resolved_ptr),
+            kTfLiteOk);
+  EXPECT_EQ(resolved_ptr, buffer->GetPtr());
+
+  // Releasing an arena leaves the shared buffer to the other ones.
+  ASSERT_EQ(small_arena.ReleaseBuffer(), kTfLiteOk);
+  EXPECT_NE(buffer->GetPtr(), nullptr);
+  EXPECT_FALSE(large_arena.BufferMovedSinceCommit());
+}
+
 // Test parameterized by whether ClearBuffer() is called before ClearPlan(), or
 // vice versa.
 class BufferAndPlanClearingTest : public ::testing::Test,
@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/cpu_backend_context.h"
 #include "tensorflow/lite/op_resolver.h"
 #include "tensorflow/lite/optional_debug_tools.h"
+#include "tensorflow/lite/profiling/memory_attribution.h"
 #include "tensorflow/lite/profiling/model_runtime_info.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 #include "tensorflow/lite/string_util.h"
@@ -264,6 +265,24 @@ class ModelRuntimeInfoListener : public BenchmarkListener {
   Interpreter* const interpreter_ = nullptr;  // not own the memory.
 };
 
+// Logs which tensors and nodes the arena memory is attributed to, when
+// report_memory_attribution is set to true.
+class MemoryAttributionListener : public BenchmarkListener {
+ public:
+  explicit MemoryAttributionListener(Interpreter* interpreter)
+      : interpreter_(interpreter) {}
+
+  // Delegates have been applied and tensors allocated at this stage, so the
+  // report covers the execution plan that is actually benchmarked.
+  void OnBenchmarkStart(const BenchmarkParams& params) override {
+    TFLITE_LOG(INFO) << profiling::FormatInterpreterMemoryAttribution(
+        *interpreter_);
+  }
+
+ private:
+  Interpreter* const interpreter_ = nullptr;  // not own the memory.
+};
+
 std::vector<std::string> Split(const std::string& str, const char delim) {
   if (str.empty()) {
     return {};
@@ -599,6 +618,8 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("model_runtime_info_output_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("report_memory_attribution",
+                          BenchmarkParam::Create<bool>(false));
   default_params.AddParam("print_preinvoke_state",
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("print_postinvoke_state",
@@ -611,6 +632,8 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("enable_builtin_cast_constant_cache",
                           BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("constant_transform_cache_size",
+                          BenchmarkParam::Create<int32_t>(0));
   default_params.AddParam("output_filepath",
                           BenchmarkParam::Create<std::string>(""));
   default_params.AddParam("output_proto_filepath",
@@ -699,6 +722,10 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
                        "Enable Model Runtime Info Export"),
       CreateFlag<std::string>("model_runtime_info_output_file", &params_,
                               "Proto File to export model runtime info to"),
+      CreateFlag<bool>("report_memory_attribution", &params_,
+                       "Report the tensors and nodes live at the peak of the "
+                       "arena memory usage, and what delegate partitions keep "
+                       "alive."),
       CreateFlag<bool>(
           "print_preinvoke_state", &params_,
           "print out the interpreter internals just before calling Invoke. The "
@@ -720,6 +747,10 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "enable_builtin_cast_constant_cache", &params_,
           "Cache the output of the builtin cast operation when its input "
           "is a constant tensor."),
+      CreateFlag<int32_t>(
+          "constant_transform_cache_size", &params_,
+          "Capacity in bytes of the cache of dequantized and cast constant "
+          "tensors shared by all subgraphs. 0 disables the cache."),
       CreateFlag<std::string>(
           "output_filepath", &params_,
           "File path to export outputs layer as binary data."),
@@ -794,6 +825,8 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Enable Model Runtime Info Export", verbose);
   LOG_BENCHMARK_PARAM(std::string, "model_runtime_info_output_file",
                       "Proto File to export model runtime info to", verbose);
+  LOG_BENCHMARK_PARAM(bool, "report_memory_attribution",
+                      "Report memory attribution", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_preinvoke_state",
                       "Print pre-invoke interpreter state", verbose);
   LOG_BENCHMARK_PARAM(bool, "print_postinvoke_state",
@@ -806,6 +839,8 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Disable delegate clustering", verbose);
   LOG_BENCHMARK_PARAM(bool, "enable_builtin_cast_constant_cache",
                       "Constant CAST output cache", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "constant_transform_cache_size",
+                      "Constant transform cache size", verbose);
   LOG_BENCHMARK_PARAM(std::string, "output_filepath",
                       "File path to export outputs layer to", verbose);
   LOG_BENCHMARK_PARAM(std::string, "output_proto_filepath",
@@ -1035,6 +1070,8 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
       params_.Get<bool>("disable_delegate_clustering"));
   options.SetCacheConstantCastOp(
       params_.Get<bool>("enable_builtin_cast_constant_cache"));
+  options.SetConstantTransformCacheSize(
+      std::max(params_.Get<int32_t>("constant_transform_cache_size"), 0));
 
   tflite::InterpreterBuilder builder(*model_, *resolver, &options);
   if (builder.SetNumThreads(num_threads) != kTfLiteOk) {
@@ -1106,6 +1143,11 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
         new ModelRuntimeInfoListener(interpreter_.get())));
   }
 
+  if (params_.Get<bool>("report_memory_attribution")) {
+    AddOwnedListener(std::unique_ptr<BenchmarkListener>(
+        new MemoryAttributionListener(interpreter_.get())));
+  }
+
   interpreter_->SetAllowFp16PrecisionForFp32(params_.Get<bool>("allow_fp16"));
 
   std::pair<TfLiteStatus, std::unique_ptr<BenchmarkInterpreterRunner>>
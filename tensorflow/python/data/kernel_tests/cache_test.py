@@ -214,6 +214,70 @@ class FileCacheTest(test_base.DatasetTestBase, parameterized.TestCase):
       do_test(i)
 
 
+class SharedCacheTest(test_base.DatasetTestBase, parameterized.TestCase):
+
+  def setUp(self):
+    super(SharedCacheTest, self).setUp()
+    self.tmp_dir = tempfile.mkdtemp()
+    os.environ["TF_DATA_SHARED_CACHE_DIR"] = self.tmp_dir
+
+  def tearDown(self):
+    del os.environ["TF_DATA_SHARED_CACHE_DIR"]
+    os.environ.pop("TF_DATA_SHARED_CACHE_MAX_BYTES", None)
+    shutil.rmtree(self.tmp_dir, ignore_errors=True)
+    super(SharedCacheTest, self).tearDown()
+
+  def _completedCaches(self):
+    return sorted(
+        f for f in os.listdir(self.tmp_dir)
+        if f.startswith("tfdata_cache_") and f.endswith(".index") and
+        "_" not in f[len("tfdata_cache_"):])
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testSharedAcrossPipelines(self):
+
+    def make_dataset(n):
+      return dataset_ops.Dataset.range(n).map(lambda x: x * 2).cache()
+
+    self.assertDatasetProduces(make_dataset(10), list(range(0, 20, 2)))
+    self.assertLen(self._completedCaches(), 1)
+    # A separately built pipeline with the same fingerprint reads the cache.
+    self.assertDatasetProduces(make_dataset(10), list(range(0, 20, 2)))
+    self.assertLen(self._completedCaches(), 1)
+    # A different pipeline gets its own cache.
+    self.assertDatasetProduces(make_dataset(5), list(range(0, 10, 2)))
+    self.assertLen(self._completedCaches(), 2)
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testConcurrentWriterPassesThrough(self):
+    dataset1 = dataset_ops.Dataset.range(5).cache()
+    dataset2 = dataset_ops.Dataset.range(5).cache()
+    get_next1 = self.getNext(dataset1)
+    get_next2 = self.getNext(dataset2)
+    self.assertEqual(self.evaluate(get_next1()), 0)
+    # The second writer reads its input instead of failing.
+    for i in range(5):
+      self.assertEqual(self.evaluate(get_next2()), i)
+    for i in range(1, 5):
+      self.assertEqual(self.evaluate(get_next1()), i)
+    with self.assertRaises(errors.OutOfRangeError):
+      self.evaluate(get_next1())
+    self.assertLen(self._completedCaches(), 1)
+
+  @combinations.generate(test_base.default_test_combinations())
+  def testEvictLeastRecentlyUsed(self):
+    os.environ["TF_DATA_SHARED_CACHE_MAX_BYTES"] = "1"
+    self.assertDatasetProduces(
+        dataset_ops.Dataset.range(5).cache(), list(range(5)))
+    first_cache = self._completedCaches()
+    self.assertLen(first_cache, 1)
+    self.assertDatasetProduces(
+        dataset_ops.Dataset.range(6).cache(), list(range(6)))
+    caches = self._completedCaches()
+    self.assertLen(caches, 1)
+    self.assertNotEqual(caches, first_cache)
+
+
 class MemoryCacheTest(test_base.DatasetTestBase, parameterized.TestCase):
 
   @combinations.generate(test_base.default_test_combinations())
@@ -165,10 +165,12 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.experimental_optimization.seq_interleave_prefetch = True
     options.experimental_warm_start = True
     options.experimental_slack = True
+    options.experimental_compress_shuffle_buffer = True
     options.dataset_name = "test_name"
     options.framework_type = ["TFDS", "TfGrain"]
     options.threading.max_intra_op_parallelism = 30
     options.threading.private_threadpool_size = 40
+    options.threading.numa_affinity = True
     pb = options._to_proto()
     result = options_lib.Options()
     result._from_proto(pb)
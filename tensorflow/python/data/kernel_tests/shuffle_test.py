@@ -530,6 +530,23 @@ class ShuffleTest(test_base.DatasetTestBase, parameterized.TestCase):
     dataset = dataset_ops.Dataset.from_tensors(42).shuffle(1, name="shuffle")
     self.assertDatasetProduces(dataset, [42])
 
+  @combinations.generate(
+      combinations.times(
+          test_base.default_test_combinations(),
+          combinations.combine(buffer_size=[1, 10, dataset_ops.UNKNOWN])))
+  def testCompressBuffer(self, buffer_size):
+
+    def build_dataset(compress_shuffle_buffer):
+      dataset = dataset_ops.Dataset.range(20).map(
+          lambda x: {"a": x, "b": array_ops.fill([x], "b")})
+      dataset = dataset.shuffle(buffer_size, seed=42).repeat(2)
+      options = options_lib.Options()
+      options.experimental_compress_shuffle_buffer = compress_shuffle_buffer
+      return dataset.with_options(options)
+
+    expected = self.getDatasetOutput(build_dataset(False))
+    self.assertDatasetProduces(build_dataset(True), expected)
+
 
 class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
                             parameterized.TestCase):
@@ -542,6 +559,7 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
       seed=None,
       reshuffle_each_iteration=None,
       symbolic_checkpoint=None,
+      compress_shuffle_buffer=None,
   ):
     dataset = (
         dataset_ops.Dataset.range(range_limit)
@@ -553,9 +571,10 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
         .repeat(num_repeats)
     )
 
-    if symbolic_checkpoint:
+    if symbolic_checkpoint or compress_shuffle_buffer:
       options = options_lib.Options()
       options.experimental_symbolic_checkpoint = symbolic_checkpoint
+      options.experimental_compress_shuffle_buffer = compress_shuffle_buffer
       dataset = dataset.with_options(options)
 
     return dataset
@@ -568,6 +587,7 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
               symbolic_checkpoint=[True, False],
               reshuffle_each_iteration=[True, False],
               buffer_size=[1, 3, 5, 8, 10, dataset_ops.UNKNOWN],
+              compress_shuffle_buffer=[True, False],
           ),
       )
   )
@@ -577,6 +597,7 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
       symbolic_checkpoint,
       reshuffle_each_iteration,
       buffer_size,
+      compress_shuffle_buffer,
   ):
     seed = 55
     range_limit = 5
@@ -592,6 +613,7 @@ class ShuffleCheckpointTest(checkpoint_test_base.CheckpointTestBase,
             seed=seed,
             reshuffle_each_iteration=reshuffle_each_iteration,
             symbolic_checkpoint=symbolic_checkpoint,
+            compress_shuffle_buffer=compress_shuffle_buffer,
         ),
         num_outputs,
     )
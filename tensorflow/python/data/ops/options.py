@@ -547,12 +547,23 @@ class ThreadingOptions(options_lib.OptionsBase):
       "The value 0 can be used to indicate that the threadpool size should be "
       "determined at runtime based on the number of available CPU cores.")
 
+  numa_affinity = options_lib.create_option(
+      name="numa_affinity",
+      ty=bool,
+      docstring=
+      "If true, parallel map transformations run their functions on threads "
+      "pinned to the NUMA node of the thread consuming their output, so that "
+      "the elements they produce are allocated on that node. If None, "
+      "defaults to False.")
+
   def _to_proto(self):
     pb = dataset_options_pb2.ThreadingOptions()
     if self.max_intra_op_parallelism is not None:
       pb.max_intra_op_parallelism = self.max_intra_op_parallelism
     if self.private_threadpool_size is not None:
       pb.private_threadpool_size = self.private_threadpool_size
+    if self.numa_affinity is not None:
+      pb.numa_affinity = self.numa_affinity
     return pb
 
   def _from_proto(self, pb):
@@ -560,6 +571,8 @@ class ThreadingOptions(options_lib.OptionsBase):
       self.max_intra_op_parallelism = pb.max_intra_op_parallelism
     if pb.WhichOneof("optional_private_threadpool_size") is not None:
       self.private_threadpool_size = pb.private_threadpool_size
+    if pb.WhichOneof("optional_numa_affinity") is not None:
+      self.numa_affinity = pb.numa_affinity
 
 
 @tf_export("data.Options")
@@ -605,6 +618,17 @@ class Options(options_lib.OptionsBase):
       "Whether the outputs need to be produced in deterministic order. If None,"
       " defaults to True.")
 
+  experimental_compress_shuffle_buffer = options_lib.create_option(
+      name="experimental_compress_shuffle_buffer",
+      ty=bool,
+      docstring=(
+          "Whether to compress the elements held in the buffers of `shuffle()` "
+          "transformations. This reduces the memory used by large shuffle "
+          "buffers, at the expense of the CPU time to compress and uncompress "
+          "each element. If None, defaults to False."
+      ),
+  )
+
   experimental_deterministic = options_lib.create_option(
       name="experimental_deterministic",
       ty=bool,
@@ -751,6 +775,8 @@ class Options(options_lib.OptionsBase):
       pb.symbolic_checkpoint = self.experimental_symbolic_checkpoint
     if self.experimental_warm_start is not None:
       pb.warm_start = self.experimental_warm_start
+    if self.experimental_compress_shuffle_buffer is not None:
+      pb.compress_shuffle_buffer = self.experimental_compress_shuffle_buffer
     if self.dataset_name is not None:
       pb.dataset_name = self.dataset_name
     if self.framework_type:
@@ -776,6 +802,8 @@ class Options(options_lib.OptionsBase):
       self.experimental_symbolic_checkpoint = pb.symbolic_checkpoint
     if pb.WhichOneof("optional_warm_start") is not None:
       self.experimental_warm_start = pb.warm_start
+    if pb.WhichOneof("optional_compress_shuffle_buffer") is not None:
+      self.experimental_compress_shuffle_buffer = pb.compress_shuffle_buffer
     if pb.WhichOneof("optional_dataset_name") is not None:
       self.dataset_name = pb.dataset_name
     if pb.framework_type:
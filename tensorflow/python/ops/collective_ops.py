@@ -118,7 +118,9 @@ def all_reduce_v2(t,
       value.  Can be 'Id' for no operation.
     communication_hint: preferred collective communication.  The implementation
       may fall back to another mechanism.  Options include `auto`, `ring`, and
-      `nccl`.
+      `nccl`. `ring_bf16` uses the ring implementation and, for float32 tensors
+      on CPU, sends values between tasks as bfloat16, trading precision for
+      half the network traffic.
     timeout: a float. If set to a non zero, set a completion timeout to detect
       staleness.  If the timer goes off, a DeadlineExceededError is raised.  The
       timeout value in seconds. This feature is experimental.
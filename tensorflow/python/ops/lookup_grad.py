@@ -17,6 +17,7 @@
 from tensorflow.python.framework import ops
 
 
+ops.NotDifferentiable("LookupTableAdmissionStats")
 ops.NotDifferentiable("LookupTableFind")
 ops.NotDifferentiable("LookupTableFindV2")
 ops.NotDifferentiable("LookupTableInsert")
@@ -35,3 +36,4 @@ ops.NotDifferentiable("MutableHashTable")
 ops.NotDifferentiable("MutableHashTableV2")
 ops.NotDifferentiable("MutableHashTableOfTensors")
 ops.NotDifferentiable("MutableHashTableOfTensorsV2")
+ops.NotDifferentiable("MutableHashTableWithAdmission")
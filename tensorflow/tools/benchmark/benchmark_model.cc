@@ -27,11 +27,13 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/numeric_types.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -39,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/init_main.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/numbers.h"
@@ -226,6 +229,15 @@ Status CalculateFlops(const GraphDef& graph,
   return absl::OkStatus();
 }
 
+Status ReadBinaryOrTextProto(const string& filename,
+                             protobuf::Message* proto) {
+  Status s = ReadBinaryProto(Env::Default(), filename, proto);
+  if (!s.ok()) {
+    s = ReadTextProto(Env::Default(), filename, proto);
+  }
+  return s;
+}
+
 void RecordBenchmarkEntry(const string& output_prefix,
                           const string& benchmark_name, const string& postfix,
                           int num_runs, double total_time_s,
@@ -263,10 +275,19 @@ void SleepSeconds(double sleep_seconds) {
 Status InitializeSession(int num_threads, const string& graph,
                          std::unique_ptr<Session>* session,
                          std::unique_ptr<GraphDef>* graph_def) {
+  return InitializeSession(num_threads, graph, ConfigProto(), session,
+                           graph_def);
+}
+
+Status InitializeSession(int num_threads, const string& graph,
+                         const ConfigProto& session_config,
+                         std::unique_ptr<Session>* session,
+                         std::unique_ptr<GraphDef>* graph_def) {
   LOG(INFO) << "Loading TensorFlow.";
 
   tensorflow::SessionOptions options;
   tensorflow::ConfigProto& config = options.config;
+  config = session_config;
   if (num_threads > 0) {
     config.set_intra_op_parallelism_threads(num_threads);
     config.set_inter_op_parallelism_threads(num_threads);
@@ -295,6 +316,42 @@ Status InitializeSession(int num_threads, const string& graph,
   return absl::OkStatus();
 }
 
+Status SetInputInfoFromRunMetadata(const RunMetadata& run_metadata,
+                                   std::vector<InputLayerInfo>* inputs) {
+  for (InputLayerInfo& input : *inputs) {
+    const std::vector<string> name_and_index = str_util::Split(input.name, ':');
+    const string& node_name = name_and_index[0];
+    const string index = name_and_index.size() > 1 ? name_and_index[1] : "0";
+    // Fed tensors are produced by the _Arg or _Recv node that the session
+    // substitutes for the fed node.
+    const string arg_prefix =
+        strings::StrCat("_arg_", node_name, "_", index, "_");
+    const string recv_name = strings::StrCat("_recv_", node_name, "_", index);
+    const TensorDescription* description = nullptr;
+    for (const DeviceStepStats& dev_stats :
+         run_metadata.step_stats().dev_stats()) {
+      for (const NodeExecStats& node_stats : dev_stats.node_stats()) {
+        if ((absl::StartsWith(node_stats.node_name(), arg_prefix) ||
+             node_stats.node_name() == recv_name) &&
+            node_stats.output_size() > 0) {
+          description = &node_stats.output(0).tensor_description();
+        }
+      }
+    }
+    if (description == nullptr) {
+      return errors::NotFound("No tensor fed for input ", input.name,
+                              " in the recorded step stats");
+    }
+    input.data_type = description->dtype();
+    TF_RETURN_IF_ERROR(
+        TensorShape::BuildTensorShape(description->shape(), &input.shape));
+    LOG(INFO) << "Recorded input " << input.name << ": "
+              << DataTypeString(input.data_type) << " "
+              << input.shape.DebugString();
+  }
+  return absl::OkStatus();
+}
+
 Status RunBenchmark(const std::vector<InputLayerInfo>& inputs,
                     const std::vector<string>& outputs,
                     const std::vector<string>& targets, Session* session,
@@ -406,6 +463,9 @@ int Main(int argc, char** argv) {
   bool show_summary = true;
   bool show_flops = false;
   int warmup_runs = 1;
+  string run_metadata_file = "";
+  string session_config_file = "";
+  string compare_session_config_file = "";
 
   std::vector<Flag> flag_list = {
       Flag("graph", &graph, "graph file name"),
@@ -441,6 +501,13 @@ int Main(int argc, char** argv) {
            "whether to show a summary of the stats"),
       Flag("show_flops", &show_flops, "whether to estimate the model's FLOPs"),
       Flag("warmup_runs", &warmup_runs, "how many runs to initialize model"),
+      Flag("run_metadata", &run_metadata_file,
+           "RunMetadata of a traced step, to take the input types and shapes "
+           "from instead of --input_layer_type and --input_layer_shape"),
+      Flag("session_config", &session_config_file,
+           "ConfigProto to create the session with"),
+      Flag("compare_session_config", &compare_session_config_file,
+           "ConfigProto of a second session to benchmark and compare with"),
   };
   string usage = Flags::Usage(argv[0], flag_list);
   const bool parse_result = Flags::Parse(&argc, argv, flag_list);
@@ -460,8 +527,9 @@ int Main(int argc, char** argv) {
       str_util::Split(input_layer_values_string, ':');
   std::vector<string> output_layers = str_util::Split(output_layer_string, ',');
   std::vector<string> target_layers = str_util::Split(target_layer_string, ',');
-  if ((input_layers.size() != input_layer_shapes.size()) ||
-      (input_layers.size() != input_layer_types.size())) {
+  if (run_metadata_file.empty() &&
+      ((input_layers.size() != input_layer_shapes.size()) ||
+       (input_layers.size() != input_layer_types.size()))) {
     LOG(ERROR) << "There must be the same number of items in --input_layer,"
                << " --input_layer_shape, and --input_layer_type, for example"
                << " --input_layer=input1,input2 --input_layer_type=float,float "
@@ -498,14 +566,38 @@ int Main(int argc, char** argv) {
   LOG(INFO) << "Output prefix: [" << output_prefix << "]";
   LOG(INFO) << "Show sizes: [" << show_sizes << "]";
   LOG(INFO) << "Warmup runs: [" << warmup_runs << "]";
+  LOG(INFO) << "Run metadata: [" << run_metadata_file << "]";
+  LOG(INFO) << "Session config: [" << session_config_file << "]";
+  LOG(INFO) << "Compare session config: [" << compare_session_config_file
+            << "]";
+
+  ConfigProto session_config;
+  if (!session_config_file.empty()) {
+    Status read_status =
+        ReadBinaryOrTextProto(session_config_file, &session_config);
+    if (!read_status.ok()) {
+      LOG(ERROR) << "Could not read --session_config: " << read_status;
+      return -1;
+    }
+  }
+  ConfigProto compare_session_config;
+  if (!compare_session_config_file.empty()) {
+    Status read_status = ReadBinaryOrTextProto(compare_session_config_file,
+                                               &compare_session_config);
+    if (!read_status.ok()) {
+      LOG(ERROR) << "Could not read --compare_session_config: " << read_status;
+      return -1;
+    }
+  }
 
   std::unique_ptr<Session> session;
   std::unique_ptr<StatSummarizer> stats;
   std::unique_ptr<GraphDef> graph_def;
 
   int64_t initialization_start_us = Env::Default()->NowMicros();
-  Status initialize_status =
-      InitializeSession(num_threads, graph, &session, &graph_def);
+  Status initialize_status = InitializeSession(num_threads, graph,
+                                               session_config, &session,
+                                               &graph_def);
   int64_t initialization_end_us = Env::Default()->NowMicros();
   double initialization_time_s =
       (initialization_end_us - initialization_start_us) / 1000000.0;
@@ -545,6 +637,12 @@ int Main(int argc, char** argv) {
   std::vector<InputLayerInfo> inputs;
   for (int n = 0; n < inputs_count; ++n) {
     InputLayerInfo input;
+    input.name = input_layers[n];
+    if (!run_metadata_file.empty()) {
+      // The type and shape are set from the run metadata below.
+      inputs.push_back(input);
+      continue;
+    }
     CHECK(DataTypeFromString(input_layer_types[n], &input.data_type))
         << input_layer_types[n] << " was an invalid type";
 
@@ -562,7 +660,6 @@ int Main(int argc, char** argv) {
         input.shape.AddDim(tmp);
       }
     }
-    input.name = input_layers[n];
     if (n < input_layer_values.size()) {
       std::vector<string> string_tokens =
           str_util::Split(input_layer_values[n], ',');
@@ -578,6 +675,19 @@ int Main(int argc, char** argv) {
     }
     inputs.push_back(input);
   }
+  if (!run_metadata_file.empty()) {
+    RunMetadata run_metadata;
+    Status run_metadata_status =
+        ReadBinaryOrTextProto(run_metadata_file, &run_metadata);
+    if (run_metadata_status.ok()) {
+      run_metadata_status = SetInputInfoFromRunMetadata(run_metadata, &inputs);
+    }
+    if (!run_metadata_status.ok()) {
+      LOG(ERROR) << "Could not get the inputs from the run metadata: "
+                 << run_metadata_status;
+      return -1;
+    }
+  }
 
   // If requested, run through the graph first to preinitialize everything
   // before the benchmarking runs.
@@ -635,6 +745,62 @@ int Main(int argc, char** argv) {
     stats->PrintOutputs();
   }
 
+  if (!compare_session_config_file.empty()) {
+    // Replays the same steps in a second session, e.g. with another executor,
+    // allocator or threadpool sizes, and compares the timings.
+    std::unique_ptr<Session> compare_session;
+    std::unique_ptr<GraphDef> compare_graph_def;
+    Status compare_status =
+        InitializeSession(num_threads, graph, compare_session_config,
+                          &compare_session, &compare_graph_def);
+    if (compare_status.ok() && !init_ops.empty()) {
+      compare_status = InitializeVariables(compare_session.get(), init_ops);
+    }
+    int64_t compare_warmup_time_us = 0;
+    int64_t compare_num_warmup_runs = 0;
+    if (compare_status.ok() && warmup_runs > 0) {
+      compare_status = TimeMultipleRuns(
+          inter_inference_sleep_seconds, warmup_runs, -1.0, inputs,
+          output_layers, target_layers, compare_session.get(), nullptr,
+          &compare_warmup_time_us, &compare_num_warmup_runs);
+    }
+    SleepSeconds(inter_benchmark_sleep_seconds);
+    int64_t compare_time_us = 0;
+    int64_t compare_num_runs = 0;
+    if (compare_status.ok()) {
+      compare_status = TimeMultipleRuns(
+          inter_inference_sleep_seconds, max_num_runs,
+          max_benchmark_time_seconds, inputs, output_layers, target_layers,
+          compare_session.get(), nullptr, &compare_time_us, &compare_num_runs);
+    }
+    auto compare_stats =
+        std::make_unique<tensorflow::StatSummarizer>(stats_options);
+    int64_t compare_stat_time_us = 0;
+    int64_t compare_stat_num_runs = 0;
+    if (compare_status.ok()) {
+      SleepSeconds(inter_benchmark_sleep_seconds);
+      compare_status = TimeMultipleRuns(
+          inter_inference_sleep_seconds, max_num_runs,
+          max_benchmark_time_seconds, inputs, output_layers, target_layers,
+          compare_session.get(), compare_stats.get(), &compare_stat_time_us,
+          &compare_stat_num_runs);
+    }
+    if (!compare_status.ok()) {
+      LOG(ERROR) << "Comparison with " << compare_session_config_file
+                 << " failed with " << compare_status;
+      return -1;
+    }
+    LOG(INFO) << "Steps with " << compare_session_config_file << ":";
+    compare_stats->PrintStepStats();
+    const int64_t baseline_us = no_stat_time_us / no_stat_num_runs;
+    const int64_t compare_us = compare_time_us / compare_num_runs;
+    LOG(INFO) << "Average inference timings in us without stats: "
+              << "baseline: " << baseline_us << ", "
+              << compare_session_config_file << ": " << compare_us << " ("
+              << (baseline_us > 0 ? 100.0 * compare_us / baseline_us : 0.0)
+              << "% of baseline)";
+  }
+
   if (show_flops) {
     int64_t total_flops;
     std::unordered_map<string, int64_t> flops_by_op;
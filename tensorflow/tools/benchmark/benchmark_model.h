@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/util/stat_summarizer.h"
 
@@ -39,6 +40,20 @@ Status InitializeSession(int num_threads, const string& graph,
                          std::unique_ptr<Session>* session,
                          std::unique_ptr<GraphDef>* graph_def);
 
+// Loads a model from disk into a new session created with `config`, whose
+// threadpool sizes are overridden by `num_threads` if positive.
+Status InitializeSession(int num_threads, const string& graph,
+                         const ConfigProto& config,
+                         std::unique_ptr<Session>* session,
+                         std::unique_ptr<GraphDef>* graph_def);
+
+// Sets the type and shape of each input to the ones of the tensor fed for it
+// in a step traced into `run_metadata` (e.g. captured in production with
+// RunOptions::FULL_TRACE), so that the step can be replayed with synthetic
+// inputs of the recorded shapes.
+Status SetInputInfoFromRunMetadata(const RunMetadata& run_metadata,
+                                   std::vector<InputLayerInfo>* inputs);
+
 // Does a single run of the model that's been loaded into the given session.
 Status RunBenchmark(const std::vector<InputLayerInfo>& inputs,
                     const std::vector<string>& outputs,
@@ -112,5 +112,40 @@ TEST(BenchmarkModeTest, TextProto) {
   ASSERT_EQ(num_runs, 10);
 }
 
+TEST(BenchmarkModelTest, InputInfoFromRunMetadata) {
+  const string dir = testing::TmpDir();
+  const string filename_pb = io::JoinPath(dir, "graphdef.pb");
+  auto root = Scope::NewRootScope().ExitOnError();
+
+  benchmark_model::InputLayerInfo input;
+  string output_name;
+  GraphDef graph_def;
+  CreateTestGraph(root, &input, &output_name, &graph_def);
+  TF_ASSERT_OK(WriteBinaryProto(Env::Default(), filename_pb, graph_def));
+
+  std::unique_ptr<Session> session;
+  std::unique_ptr<GraphDef> loaded_graph_def;
+  TF_ASSERT_OK(benchmark_model::InitializeSession(1, filename_pb, &session,
+                                                  &loaded_graph_def));
+  RunOptions run_options;
+  run_options.set_trace_level(RunOptions::FULL_TRACE);
+  RunMetadata run_metadata;
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run(run_options,
+                            {{input.name, Tensor(DT_FLOAT, input.shape)}},
+                            {output_name}, {}, &outputs, &run_metadata));
+
+  std::vector<benchmark_model::InputLayerInfo> inputs(1);
+  inputs[0].name = input.name;
+  TF_ASSERT_OK(
+      benchmark_model::SetInputInfoFromRunMetadata(run_metadata, &inputs));
+  EXPECT_EQ(inputs[0].data_type, DT_FLOAT);
+  EXPECT_EQ(inputs[0].shape, input.shape);
+
+  inputs[0].name = "missing:0";
+  EXPECT_FALSE(
+      benchmark_model::SetInputInfoFromRunMetadata(run_metadata, &inputs).ok());
+}
+
 }  // namespace
 }  // namespace tensorflow
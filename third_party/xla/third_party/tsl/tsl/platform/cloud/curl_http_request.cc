@@ -21,6 +21,7 @@ limitations under the License.
 #include "xla/tsl/util/env_var.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/macros.h"
+#include "tsl/platform/mutex.h"
 #include "tsl/platform/scanner.h"
 #include "tsl/platform/str_util.h"
 #include "tsl/platform/types.h"
@@ -112,6 +113,47 @@ class LibCurlProxy : public LibCurl {
   }
 
   void curl_free(void* p) override { ::curl_free(p); }
+
+  CURLSH* curl_share() override { return share_; }
+
+ private:
+  LibCurlProxy() {
+    // Share connections, TLS sessions and DNS entries between requests, so
+    // that consecutive requests to a host reuse a warm connection instead of
+    // each opening its own.
+    share_ = ::curl_share_init();
+    if (share_ == nullptr ||
+        ::curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &Lock) != CURLSHE_OK ||
+        ::curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &Unlock) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) !=
+            CURLSHE_OK ||
+        ::curl_share_setopt(share_, CURLSHOPT_SHARE,
+                            CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK ||
+        ::curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT) !=
+            CURLSHE_OK) {
+      LOG(WARNING) << "Couldn't set up a curl share; requests will not reuse "
+                      "connections.";
+      if (share_ != nullptr) ::curl_share_cleanup(share_);
+      share_ = nullptr;
+    }
+  }
+
+  static mutex* LockFor(curl_lock_data data) {
+    static mutex* locks = new mutex[CURL_LOCK_DATA_LAST];
+    return &locks[data];
+  }
+
+  static void Lock(CURL* handle, curl_lock_data data,
+                   curl_lock_access access, void* userptr) {
+    LockFor(data)->lock();
+  }
+
+  static void Unlock(CURL* handle, curl_lock_data data, void* userptr) {
+    LockFor(data)->unlock();
+  }
+
+  CURLSH* share_;
 };
 }  // namespace
 
@@ -139,6 +181,10 @@ CurlHttpRequest::CurlHttpRequest(LibCurl* libcurl, Env* env)
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_USERAGENT, "TSL"));
   // Do not use signals for timeouts - does not work in multi-threaded programs.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L));
+  CURLSH* share = libcurl_->curl_share();
+  if (share != nullptr) {
+    CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_SHARE, share));
+  }
 
   // TODO(b/74351157): Enable HTTP/2.
   CHECK_CURL_OK(libcurl_->curl_easy_setopt(curl_, CURLOPT_HTTP_VERSION,
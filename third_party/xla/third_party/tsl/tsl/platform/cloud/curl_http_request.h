@@ -270,6 +270,9 @@ class LibCurl {
   virtual void curl_slist_free_all(curl_slist* list) = 0;
   virtual char* curl_easy_escape(CURL* curl, const char* str, int length) = 0;
   virtual void curl_free(void* p) = 0;
+  /// Returns the share handle all requests are attached to, or nullptr if
+  /// requests should not share connections.
+  virtual CURLSH* curl_share() { return nullptr; }
 };
 
 }  // namespace tsl
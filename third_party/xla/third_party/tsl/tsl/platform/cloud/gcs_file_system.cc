@@ -41,6 +41,7 @@ limitations under the License.
 #endif
 #include "absl/base/macros.h"
 #include "json/json.h"
+#include "tsl/platform/blocking_counter.h"
 #include "tsl/platform/cloud/curl_http_request.h"
 #include "tsl/platform/cloud/file_block_cache.h"
 #include "tsl/platform/cloud/google_auth_provider.h"
@@ -80,6 +81,23 @@ constexpr uint64 HTTP_CODE_PRECONDITION_FAILED = 412;
 // The environment variable that overrides the size of the readahead buffer.
 ABSL_DEPRECATED("Use GCS_READ_CACHE_BLOCK_SIZE_MB instead.")
 constexpr char kReadaheadBufferSize[] = "GCS_READAHEAD_BUFFER_SIZE_BYTES";
+// The environment variable that overrides the size (in MB) of the ranged
+// requests large reads are split into. Setting it to 0 sends a single request
+// per read.
+constexpr char kParallelReadChunkSize[] = "GCS_PARALLEL_READ_CHUNK_SIZE_MB";
+constexpr size_t kDefaultParallelReadChunkSize = 16 * 1024 * 1024;
+// The environment variable that overrides the number of threads sending the
+// ranged requests of large reads.
+constexpr char kParallelReadThreads[] = "GCS_PARALLEL_READ_THREADS";
+constexpr int kDefaultParallelReadThreads = 8;
+// The environment variable that sets a local directory (e.g. on a local SSD)
+// where blocks read for the block cache are also stored, to be shared by all
+// the processes of a host.
+constexpr char kLocalBlockStoreDir[] = "GCS_LOCAL_BLOCK_CACHE_DIR";
+// The environment variable that overrides the maximum size (in MB) of the
+// local block store.
+constexpr char kLocalBlockStoreMaxSize[] = "GCS_LOCAL_BLOCK_CACHE_MAX_SIZE_MB";
+constexpr uint64 kDefaultLocalBlockStoreMaxSize = 16ULL * 1024 * 1024 * 1024;
 // The environment variable that overrides the maximum age of entries in the
 // Stat cache. A value of 0 means nothing is cached.
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
@@ -858,6 +876,33 @@ GcsFileSystem::GcsFileSystem(bool make_default_cache) {
           << "block size = " << block_size_ << " ; "
           << "max staleness = " << max_staleness;
   file_block_cache_ = MakeFileBlockCache(block_size_, max_bytes, max_staleness);
+
+  // Apply the overrides for parallel reads, if provided.
+  size_t parallel_read_chunk_size = kDefaultParallelReadChunkSize;
+  if (GetEnvVar(kParallelReadChunkSize, strings::safe_strtou64, &value)) {
+    parallel_read_chunk_size = value * 1024 * 1024;
+  }
+  int parallel_read_threads = kDefaultParallelReadThreads;
+  int32_t threads_value;
+  if (GetEnvVar(kParallelReadThreads, strings::safe_strto32, &threads_value)) {
+    parallel_read_threads = threads_value;
+  }
+  SetParallelReads(parallel_read_chunk_size, parallel_read_threads);
+
+  // Apply the overrides for the local block store, if provided.
+  absl::string_view local_block_store_dir;
+  if (GetEnvVar(kLocalBlockStoreDir, StringPieceIdentity,
+                &local_block_store_dir) &&
+      !local_block_store_dir.empty()) {
+    uint64 local_block_store_max_size = kDefaultLocalBlockStoreMaxSize;
+    if (GetEnvVar(kLocalBlockStoreMaxSize, strings::safe_strtou64, &value)) {
+      local_block_store_max_size = value * 1024 * 1024;
+    }
+    SetLocalBlockStore(std::make_unique<LocalFileBlockStore>(
+        string(local_block_store_dir), local_block_store_max_size,
+        Env::Default()));
+  }
+
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
   size_t stat_cache_max_entries = kStatCacheDefaultMaxEntries;
@@ -1084,8 +1129,7 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
       block_size, max_bytes, max_staleness,
       [this](const string& filename, size_t offset, size_t n, char* buffer,
              size_t* bytes_transferred) {
-        return LoadBufferFromGCS(filename, offset, n, buffer,
-                                 bytes_transferred);
+        return LoadBlock(filename, offset, n, buffer, bytes_transferred);
       }));
 
   // Check if cache is enabled here to avoid unnecessary mutex contention.
@@ -1093,6 +1137,56 @@ std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
   return file_block_cache;
 }
 
+void GcsFileSystem::SetParallelReads(size_t chunk_size, int num_threads) {
+  if (chunk_size == 0 || num_threads <= 0) {
+    parallel_read_chunk_size_ = 0;
+    parallel_read_pool_.reset();
+    return;
+  }
+  parallel_read_chunk_size_ = chunk_size;
+  parallel_read_pool_ = std::make_unique<thread::ThreadPool>(
+      Env::Default(), "gcs_parallel_read", num_threads);
+}
+
+void GcsFileSystem::SetLocalBlockStore(
+    std::unique_ptr<LocalFileBlockStore> store) {
+  local_block_store_ = std::move(store);
+}
+
+absl::Status GcsFileSystem::LoadBlock(const string& fname, size_t offset,
+                                      size_t n, char* buffer,
+                                      size_t* bytes_transferred) {
+  // The generation of the file is only known while its stat is cached, which
+  // is the case right after the block cache validated the file signature.
+  GcsFileStat stat;
+  if (local_block_store_ == nullptr || !stat_cache_->Lookup(fname, &stat)) {
+    return LoadBufferFromGCS(fname, offset, n, buffer, bytes_transferred);
+  }
+  if (local_block_store_->Lookup(fname, stat.generation_number, offset, n,
+                                 buffer, bytes_transferred)) {
+    return absl::OkStatus();
+  }
+  TF_RETURN_IF_ERROR(
+      LoadBufferFromGCS(fname, offset, n, buffer, bytes_transferred));
+  local_block_store_->Insert(fname, stat.generation_number, offset, n,
+                             absl::string_view(buffer, *bytes_transferred));
+  return absl::OkStatus();
+}
+
+absl::Status GcsFileSystem::CreateReadRequest(
+    const string& bucket, const string& object, size_t offset, size_t n,
+    char* buffer, std::unique_ptr<HttpRequest>* request) {
+  TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(request),
+                                  "when reading gs://", bucket, "/", object);
+
+  (*request)->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket,
+                                     "/", (*request)->EscapeString(object)));
+  (*request)->SetRange(offset, offset + n - 1);
+  (*request)->SetResultBufferDirect(buffer, n);
+  (*request)->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
+  return absl::OkStatus();
+}
+
 // A helper function to actually read the data from GCS.
 absl::Status GcsFileSystem::LoadBufferFromGCS(const string& fname,
                                               size_t offset, size_t n,
@@ -1106,24 +1200,52 @@ absl::Status GcsFileSystem::LoadBufferFromGCS(const string& fname,
   profiler::TraceMe activity(
       [fname]() { return absl::StrCat("LoadBufferFromGCS ", fname); });
 
-  std::unique_ptr<HttpRequest> request;
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(CreateHttpRequest(&request),
-                                  "when reading gs://", bucket, "/", object);
-
-  request->SetUri(strings::StrCat("https://", kStorageHost, "/", bucket, "/",
-                                  request->EscapeString(object)));
-  request->SetRange(offset, offset + n - 1);
-  request->SetResultBufferDirect(buffer, n);
-  request->SetTimeouts(timeouts_.connect, timeouts_.idle, timeouts_.read);
+  // Large reads are split into chunks read in parallel, since a single
+  // connection to GCS is usually far slower than the network.
+  const size_t chunk_size = parallel_read_chunk_size_ > 0 &&
+                                    n >= 2 * parallel_read_chunk_size_
+                                ? parallel_read_chunk_size_
+                                : n;
+  const size_t num_chunks =
+      n > chunk_size ? (n + chunk_size - 1) / chunk_size : 1;
+  // Requests are created in order, before any is sent.
+  std::vector<std::unique_ptr<HttpRequest>> requests(num_chunks);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    const size_t chunk_offset = i * chunk_size;
+    TF_RETURN_IF_ERROR(CreateReadRequest(
+        bucket, object, offset + chunk_offset,
+        std::min(chunk_size, n - chunk_offset), buffer + chunk_offset,
+        &requests[i]));
+  }
 
   if (stats_ != nullptr) {
     stats_->RecordBlockLoadRequest(fname, offset);
   }
 
-  TF_RETURN_WITH_CONTEXT_IF_ERROR(request->Send(), " when reading gs://",
-                                  bucket, "/", object);
+  std::vector<absl::Status> statuses(num_chunks);
+  {
+    BlockingCounter counter(num_chunks - 1);
+    for (size_t i = 1; i < num_chunks; ++i) {
+      parallel_read_pool_->Schedule([&requests, &statuses, &counter, i]() {
+        statuses[i] = requests[i]->Send();
+        counter.DecrementCount();
+      });
+    }
+    statuses[0] = requests[0]->Send();
+    counter.Wait();
+  }
 
-  size_t bytes_read = request->GetResultBufferDirectBytesTransferred();
+  // The object may end in any chunk, in which case the following ones are
+  // empty.
+  size_t bytes_read = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    TF_RETURN_WITH_CONTEXT_IF_ERROR(statuses[i], " when reading gs://",
+                                    bucket, "/", object);
+    const size_t chunk_bytes_read =
+        requests[i]->GetResultBufferDirectBytesTransferred();
+    bytes_read += chunk_bytes_read;
+    if (chunk_bytes_read < std::min(chunk_size, n - i * chunk_size)) break;
+  }
   *bytes_transferred = bytes_read;
   VLOG(1) << "Successful read of gs://" << bucket << "/" << object << " @ "
           << offset << " of size: " << bytes_read;
@@ -29,9 +29,11 @@ limitations under the License.
 #include "tsl/platform/cloud/gcs_dns_cache.h"
 #include "tsl/platform/cloud/gcs_throttle.h"
 #include "tsl/platform/cloud/http_request.h"
+#include "tsl/platform/cloud/local_file_block_store.h"
 #include "tsl/platform/file_system.h"
 #include "tsl/platform/retrying_file_system.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
 
 namespace tsl {
 
@@ -280,6 +282,21 @@ class GcsFileSystem : public FileSystem {
   /// The new auth provider will be used for all subsequent requests.
   void SetAuthProvider(std::unique_ptr<AuthProvider> auth_provider);
 
+  /// \brief Splits large reads into ranged requests that are sent in parallel.
+  ///
+  /// Reads of at least 2 * `chunk_size` bytes are split into requests of
+  /// `chunk_size` bytes, sent from `num_threads` threads. A `chunk_size` of 0
+  /// disables parallel reads. Must not be called while files are being read.
+  void SetParallelReads(size_t chunk_size, int num_threads);
+
+  /// \brief Also stores the blocks read for the block cache in `store`.
+  ///
+  /// Blocks found in the store are not read from GCS. The store is keyed by
+  /// object generation, which is only known while the stat of the object is
+  /// cached, so it is not used when the stat cache is disabled. A null `store`
+  /// disables it. Must not be called while files are being read.
+  void SetLocalBlockStore(std::unique_ptr<LocalFileBlockStore> store);
+
   /// \brief Resets the block cache and re-instantiates it with the new values.
   ///
   /// This method can be used to clear the existing block cache and/or to
@@ -412,6 +429,17 @@ class GcsFileSystem : public FileSystem {
 
   absl::Status RenameObject(const string& src, const string& target);
 
+  /// Loads a block for the block cache from the local block store, or from GCS
+  /// if it is not stored yet.
+  absl::Status LoadBlock(const string& fname, size_t offset, size_t n,
+                         char* buffer, size_t* bytes_transferred);
+
+  /// Creates a request that reads `n` bytes of `object` at `offset` into
+  /// `buffer`.
+  absl::Status CreateReadRequest(const string& bucket, const string& object,
+                                 size_t offset, size_t n, char* buffer,
+                                 std::unique_ptr<HttpRequest>* request);
+
   // Clear all the caches related to the file with name `filename`.
   void ClearFileCaches(const string& fname);
 
@@ -423,6 +451,14 @@ class GcsFileSystem : public FileSystem {
   // Reads smaller than block_size_ will trigger a read of block_size_.
   uint64 block_size_;
 
+  // Reads of at least twice parallel_read_chunk_size_ bytes are split into
+  // requests of that size, sent from parallel_read_pool_.
+  size_t parallel_read_chunk_size_ = 0;
+  std::unique_ptr<thread::ThreadPool> parallel_read_pool_;
+
+  // Blocks shared with the other processes of the host, if any.
+  std::unique_ptr<LocalFileBlockStore> local_block_store_;
+
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -20,6 +20,7 @@ limitations under the License.
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tsl/platform/cloud/http_request_fake.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/str_util.h"
 #include "tsl/platform/strcat.h"
 #include "tsl/platform/test.h"
@@ -105,6 +106,51 @@ TEST(GcsFileSystemTest, NewRandomAccessFile_NoBlockCache) {
   EXPECT_EQ("6789", result);
 }
 
+TEST(GcsFileSystemTest, NewRandomAccessFile_ParallelReads) {
+  std::vector<HttpRequest*> requests(
+      {new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com/bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 0-3\n"
+           "Timeouts: 5 1 20\n",
+           "0123"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com/bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 4-7\n"
+           "Timeouts: 5 1 20\n",
+           "4567"),
+       new FakeHttpRequest(
+           "Uri: https://storage.googleapis.com/bucket/random_access.txt\n"
+           "Auth Token: fake_token\n"
+           "Range: 8-11\n"
+           "Timeouts: 5 1 20\n",
+           "89")});
+  GcsFileSystem fs(
+      std::unique_ptr<AuthProvider>(new FakeAuthProvider),
+      std::unique_ptr<HttpRequest::Factory>(
+          new FakeHttpRequestFactory(&requests)),
+      std::unique_ptr<ZoneProvider>(new FakeZoneProvider), 0 /* block size */,
+      0 /* max bytes */, 0 /* max staleness */, 0 /* stat cache max age */,
+      0 /* stat cache max entries */, 0 /* matching paths cache max age */,
+      0 /* matching paths cache max entries */, kTestRetryConfig,
+      kTestTimeoutConfig, *kAllowedLocationsDefault,
+      nullptr /* gcs additional header */, false /* compose append */);
+  fs.SetParallelReads(/*chunk_size=*/4, /*num_threads=*/2);
+
+  std::unique_ptr<RandomAccessFile> file;
+  TF_EXPECT_OK(
+      fs.NewRandomAccessFile("gs://bucket/random_access.txt", nullptr, &file));
+
+  // The read is split into three ranged requests, the last one ending the
+  // file.
+  char scratch[12];
+  absl::string_view result;
+  EXPECT_TRUE(errors::IsOutOfRange(
+      file->Read(0, sizeof(scratch), &result, scratch)));
+  EXPECT_EQ("0123456789", result);
+}
+
 TEST(GcsFileSystemTest, NewRandomAccessFile_Buffered) {
   std::vector<HttpRequest*> requests({
       new FakeHttpRequest(
@@ -674,6 +720,57 @@ TEST(GcsFileSystemTest, NewRandomAccessFile_WithBlockCache) {
   EXPECT_EQ("0123", result);
 }
 
+TEST(GcsFileSystemTest, NewRandomAccessFile_WithBlockCache_LocalBlockStore) {
+  const string store_dir =
+      io::JoinPath(testing::TmpDir(), "gcs_local_block_store");
+  int64_t undeleted_files, undeleted_dirs;
+  Env::Default()
+      ->DeleteRecursively(store_dir, &undeleted_files, &undeleted_dirs)
+      .IgnoreError();
+  const string stat_response =
+      "{\"size\": \"15\",\"generation\": \"1\","
+      "\"updated\": \"2016-04-29T23:15:24.896Z\"}";
+  const string stat_request =
+      "Uri: https://www.googleapis.com/storage/v1/b/bucket/o/"
+      "random_access.txt?fields=size%2Cgeneration%2Cupdated\n"
+      "Auth Token: fake_token\n"
+      "Timeouts: 5 1 10\n";
+  // The first file system reads the block from GCS, the second one, as if it
+  // ran in another process, only checks the generation of the object.
+  std::vector<std::vector<HttpRequest*>> requests(
+      {{new FakeHttpRequest(stat_request, stat_response),
+        new FakeHttpRequest(
+            "Uri: https://storage.googleapis.com/bucket/random_access.txt\n"
+            "Auth Token: fake_token\n"
+            "Range: 0-8\n"
+            "Timeouts: 5 1 20\n",
+            "012345678")},
+       {new FakeHttpRequest(stat_request, stat_response)}});
+  for (int i = 0; i < 2; ++i) {
+    GcsFileSystem fs(
+        std::unique_ptr<AuthProvider>(new FakeAuthProvider),
+        std::unique_ptr<HttpRequest::Factory>(
+            new FakeHttpRequestFactory(&requests[i])),
+        std::unique_ptr<ZoneProvider>(new FakeZoneProvider), 9 /* block size */,
+        18 /* max bytes */, 0 /* max staleness */,
+        3600 /* stat cache max age */, 0 /* stat cache max entries */,
+        0 /* matching paths cache max age */,
+        0 /* matching paths cache max entries */, kTestRetryConfig,
+        kTestTimeoutConfig, *kAllowedLocationsDefault,
+        nullptr /* gcs additional header */, false /* compose append */);
+    fs.SetLocalBlockStore(std::make_unique<LocalFileBlockStore>(
+        store_dir, 1024 * 1024, Env::Default()));
+
+    std::unique_ptr<RandomAccessFile> file;
+    TF_EXPECT_OK(fs.NewRandomAccessFile("gs://bucket/random_access.txt",
+                                        nullptr, &file));
+    char scratch[100];
+    absl::string_view result;
+    TF_EXPECT_OK(file->Read(0, 4, &result, scratch));
+    EXPECT_EQ("0123", result);
+  }
+}
+
 TEST(GcsFileSystemTest, NewRandomAccessFile_WithBlockCache_Flush) {
   // Our underlying file in this test is a 15 byte file with contents
   // "0123456789abcde".
@@ -0,0 +1,136 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/platform/cloud/local_file_block_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_statistics.h"
+#include "tsl/platform/file_system.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/random.h"
+
+namespace tsl {
+namespace {
+
+constexpr char kTempSuffix[] = ".tmp";
+
+// The directory is scanned for blocks to evict every time this process
+// stored 1 / kEvictionScanFraction of the maximum size.
+constexpr uint64 kEvictionScanFraction = 16;
+
+}  // namespace
+
+LocalFileBlockStore::LocalFileBlockStore(const string& directory,
+                                         uint64 max_bytes, Env* env)
+    : directory_(directory), max_bytes_(max_bytes), env_(env) {
+  absl::Status status = env_->RecursivelyCreateDir(directory_);
+  if (!status.ok() && !errors::IsAlreadyExists(status)) {
+    LOG(WARNING) << "Could not create the local block store directory "
+                 << directory_ << ": " << status;
+  }
+}
+
+string LocalFileBlockStore::BlockPath(const string& filename,
+                                      int64_t generation, size_t offset,
+                                      size_t n) const {
+  return io::JoinPath(
+      directory_, absl::StrCat(absl::Hex(Fingerprint64(filename),
+                                         absl::kZeroPad16),
+                               "_", generation, "_", offset, "_", n));
+}
+
+bool LocalFileBlockStore::Lookup(const string& filename, int64_t generation,
+                                 size_t offset, size_t n, char* buffer,
+                                 size_t* bytes_transferred) {
+  const string path = BlockPath(filename, generation, offset, n);
+  std::unique_ptr<RandomAccessFile> file;
+  if (!env_->NewRandomAccessFile(path, &file).ok()) return false;
+  absl::string_view result;
+  absl::Status status = file->Read(0, n, &result, buffer);
+  if (!status.ok() && !errors::IsOutOfRange(status)) {
+    VLOG(1) << "Could not read block " << path << ": " << status;
+    return false;
+  }
+  if (result.data() != buffer) {
+    memmove(buffer, result.data(), result.size());
+  }
+  *bytes_transferred = result.size();
+  return true;
+}
+
+void LocalFileBlockStore::Insert(const string& filename, int64_t generation,
+                                 size_t offset, size_t n,
+                                 absl::string_view data) {
+  const string path = BlockPath(filename, generation, offset, n);
+  const string temp_path =
+      absl::StrCat(path, ".", absl::Hex(random::New64()), kTempSuffix);
+  absl::Status status = WriteStringToFile(env_, temp_path, data);
+  if (status.ok()) status = env_->RenameFile(temp_path, path);
+  if (!status.ok()) {
+    VLOG(1) << "Could not store block " << path << ": " << status;
+    env_->DeleteFile(temp_path).IgnoreError();
+    return;
+  }
+  {
+    mutex_lock l(mu_);
+    bytes_since_eviction_ += data.size();
+    if (bytes_since_eviction_ < max_bytes_ / kEvictionScanFraction) return;
+    bytes_since_eviction_ = 0;
+  }
+  Evict();
+}
+
+void LocalFileBlockStore::Evict() {
+  std::vector<string> children;
+  if (!env_->GetChildren(directory_, &children).ok()) return;
+  struct Block {
+    string path;
+    int64_t mtime_nsec;
+    int64_t length;
+  };
+  std::vector<Block> blocks;
+  uint64 total_bytes = 0;
+  for (const string& child : children) {
+    // Blocks being written by this or other processes are never evicted.
+    if (absl::EndsWith(child, kTempSuffix)) continue;
+    const string path = io::JoinPath(directory_, child);
+    FileStatistics stat;
+    if (!env_->Stat(path, &stat).ok() || stat.is_directory) continue;
+    blocks.push_back({path, stat.mtime_nsec, stat.length});
+    total_bytes += stat.length;
+  }
+  if (total_bytes <= max_bytes_) return;
+  std::sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) {
+    return a.mtime_nsec < b.mtime_nsec;
+  });
+  for (const Block& block : blocks) {
+    if (total_bytes <= max_bytes_) break;
+    // Another process may have deleted the block already.
+    env_->DeleteFile(block.path).IgnoreError();
+    total_bytes -= block.length;
+  }
+}
+
+}  // namespace tsl
@@ -0,0 +1,79 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_TSL_PLATFORM_CLOUD_LOCAL_FILE_BLOCK_STORE_H_
+#define TENSORFLOW_TSL_PLATFORM_CLOUD_LOCAL_FILE_BLOCK_STORE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/types.h"
+
+namespace tsl {
+
+/// \brief Blocks of remote files kept in a local directory (e.g. on a local
+/// SSD or in /dev/shm), shared by all the processes of a host that use it.
+///
+/// Blocks are keyed by {filename, generation, offset, size}, so blocks of a
+/// file that was rewritten on the remote filesystem are never read back.
+/// Blocks are written to a temporary file and renamed into place, so other
+/// processes only ever see complete blocks. Once more than `max_bytes` are
+/// stored, the oldest blocks are deleted.
+///
+/// The store is a best effort cache: local filesystem errors are logged and
+/// reported as misses. This class is thread safe.
+class LocalFileBlockStore {
+ public:
+  LocalFileBlockStore(const string& directory, uint64 max_bytes, Env* env);
+
+  /// Copies the block of `n` bytes of `filename` at `offset` into `buffer` if
+  /// it is stored, setting `bytes_transferred` to its size, which is smaller
+  /// than `n` for the last block of a file. Returns whether it was stored.
+  bool Lookup(const string& filename, int64_t generation, size_t offset,
+              size_t n, char* buffer, size_t* bytes_transferred);
+
+  /// Stores `data`, the result of reading `n` bytes of `filename` at
+  /// `offset`.
+  void Insert(const string& filename, int64_t generation, size_t offset,
+              size_t n, absl::string_view data);
+
+  const string& directory() const { return directory_; }
+
+ private:
+  string BlockPath(const string& filename, int64_t generation, size_t offset,
+                   size_t n) const;
+
+  /// Deletes the oldest blocks of the directory until at most `max_bytes_`
+  /// are stored.
+  void Evict();
+
+  const string directory_;
+  const uint64 max_bytes_;
+  Env* const env_;
+
+  mutex mu_;
+  // Bytes this process stored since the directory was last scanned. Other
+  // processes store blocks too, so the directory is scanned every time this
+  // grows past a fraction of max_bytes_.
+  uint64 bytes_since_eviction_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_PLATFORM_CLOUD_LOCAL_FILE_BLOCK_STORE_H_
@@ -0,0 +1,95 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/platform/cloud/local_file_block_store.h"
+
+#include <string>
+#include <vector>
+
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/test.h"
+
+namespace tsl {
+namespace {
+
+string StoreDir(const string& name) {
+  const string dir = io::JoinPath(testing::TmpDir(), name);
+  int64_t undeleted_files, undeleted_dirs;
+  Env::Default()
+      ->DeleteRecursively(dir, &undeleted_files, &undeleted_dirs)
+      .IgnoreError();
+  return dir;
+}
+
+bool Lookup(LocalFileBlockStore* store, const string& filename,
+            int64_t generation, size_t offset, size_t n, string* out) {
+  out->assign(n, 'x');
+  size_t bytes_transferred = 0;
+  if (!store->Lookup(filename, generation, offset, n, &(*out)[0],
+                     &bytes_transferred)) {
+    return false;
+  }
+  EXPECT_LE(bytes_transferred, n);
+  out->resize(bytes_transferred);
+  return true;
+}
+
+TEST(LocalFileBlockStoreTest, SharesBlocksBetweenStores) {
+  const string dir = StoreDir("shares_blocks");
+  LocalFileBlockStore writer(dir, 1024, Env::Default());
+  LocalFileBlockStore reader(dir, 1024, Env::Default());
+  string out;
+  EXPECT_FALSE(Lookup(&reader, "gs://bucket/a", 1, 0, 4, &out));
+
+  writer.Insert("gs://bucket/a", 1, 0, 4, "0123");
+  writer.Insert("gs://bucket/a", 1, 4, 4, "45");
+  ASSERT_TRUE(Lookup(&reader, "gs://bucket/a", 1, 0, 4, &out));
+  EXPECT_EQ(out, "0123");
+  // The last block of the file is shorter than requested.
+  ASSERT_TRUE(Lookup(&reader, "gs://bucket/a", 1, 4, 4, &out));
+  EXPECT_EQ(out, "45");
+
+  // Other files, offsets, sizes and generations are different blocks.
+  EXPECT_FALSE(Lookup(&reader, "gs://bucket/b", 1, 0, 4, &out));
+  EXPECT_FALSE(Lookup(&reader, "gs://bucket/a", 1, 2, 4, &out));
+  EXPECT_FALSE(Lookup(&reader, "gs://bucket/a", 1, 0, 8, &out));
+  EXPECT_FALSE(Lookup(&reader, "gs://bucket/a", 2, 0, 4, &out));
+}
+
+TEST(LocalFileBlockStoreTest, EvictsOldestBlocks) {
+  const string dir = StoreDir("evicts_blocks");
+  // The directory is scanned after every insert of a block of this size.
+  LocalFileBlockStore store(dir, 32, Env::Default());
+  const string block(16, 'b');
+  store.Insert("gs://bucket/a", 1, 0, 16, block);
+  Env::Default()->SleepForMicroseconds(10000);
+  store.Insert("gs://bucket/a", 1, 16, 16, block);
+  Env::Default()->SleepForMicroseconds(10000);
+  store.Insert("gs://bucket/a", 1, 32, 16, block);
+
+  string out;
+  EXPECT_FALSE(Lookup(&store, "gs://bucket/a", 1, 0, 16, &out));
+  EXPECT_TRUE(Lookup(&store, "gs://bucket/a", 1, 16, 16, &out));
+  EXPECT_TRUE(Lookup(&store, "gs://bucket/a", 1, 32, 16, &out));
+
+  std::vector<string> children;
+  TF_EXPECT_OK(Env::Default()->GetChildren(dir, &children));
+  EXPECT_EQ(children.size(), 2);
+}
+
+}  // namespace
+}  // namespace tsl
@@ -17,6 +17,12 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
 #include "absl/types/optional.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tsl/platform/blocking_counter.h"
@@ -99,6 +105,17 @@ struct EigenEnvironment {
   }
 };
 
+struct ThreadPool::PriorityQueues {
+  struct Task {
+    std::function<void()> fn;
+    Context context;
+  };
+
+  mutex mu;
+  std::deque<Task> queues[static_cast<int>(Priority::kLow) + 1]
+      TF_GUARDED_BY(mu);
+};
+
 ThreadPool::ThreadPool(Env* env, const string& name, int num_threads)
     : ThreadPool(env, ThreadOptions(), name, num_threads, true, nullptr) {}
 
@@ -108,7 +125,8 @@ ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
 
 ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
                        const string& name, int num_threads,
-                       bool low_latency_hint, Eigen::Allocator* allocator) {
+                       bool low_latency_hint, Eigen::Allocator* allocator)
+    : priority_queues_(std::make_shared<PriorityQueues>()) {
   CHECK_GE(num_threads, 1);
 
 #ifdef DNNL_AARCH64_USE_ACL
@@ -133,7 +151,8 @@ ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
                                                        num_threads, allocator));
 }
 
-ThreadPool::ThreadPool(thread::ThreadPoolInterface* user_threadpool) {
+ThreadPool::ThreadPool(thread::ThreadPoolInterface* user_threadpool)
+    : priority_queues_(std::make_shared<PriorityQueues>()) {
   underlying_threadpool_ = user_threadpool;
   threadpool_device_.reset(new Eigen::ThreadPoolDevice(
       underlying_threadpool_, underlying_threadpool_->NumThreads(), nullptr));
@@ -146,6 +165,32 @@ void ThreadPool::Schedule(std::function<void()> fn) {
   underlying_threadpool_->Schedule(std::move(fn));
 }
 
+void ThreadPool::Schedule(std::function<void()> fn, Priority priority) {
+  CHECK(fn != nullptr);
+  {
+    mutex_lock l(priority_queues_->mu);
+    priority_queues_->queues[static_cast<int>(priority)].push_back(
+        {std::move(fn), Context(ContextKind::kThread)});
+  }
+  // There is one closure per queued task, so each closure finds a task.
+  underlying_threadpool_->Schedule([queues = priority_queues_]() {
+    std::optional<PriorityQueues::Task> task;
+    {
+      mutex_lock l(queues->mu);
+      for (auto& queue : queues->queues) {
+        if (!queue.empty()) {
+          task = std::move(queue.front());
+          queue.pop_front();
+          break;
+        }
+      }
+    }
+    DCHECK(task.has_value());
+    WithContext wc(task->context);
+    task->fn();
+  });
+}
+
 int ThreadPool::NumShardsUsedByFixedBlockSizeScheduling(
     const int64_t total, const int64_t block_size) {
   if (block_size <= 0 || total <= 1 || total <= block_size ||
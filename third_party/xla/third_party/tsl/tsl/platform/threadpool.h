@@ -135,9 +135,19 @@ class ThreadPool {
   // set of threads.
   ~ThreadPool();
 
+  // Priorities of the tasks scheduled with Schedule(fn, priority).
+  enum class Priority { kHigh, kNormal, kLow };
+
   // Schedules fn() for execution in the pool of threads.
   void Schedule(std::function<void()> fn);
 
+  // Schedules fn() with the given priority. The thread that picks up the task
+  // runs the oldest pending task of the highest priority instead, so that high
+  // priority tasks overtake the lower priority tasks already queued, while the
+  // tasks are still distributed and stolen across threads as for Schedule(fn).
+  // Tasks scheduled without a priority are not ordered against these.
+  void Schedule(std::function<void()> fn, Priority priority);
+
   void SetStealPartitions(
       const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
@@ -228,6 +238,11 @@ class ThreadPool {
       const int64_t total, const int64_t block_size,
       const std::function<void(int64_t, int64_t)>& fn);
 
+  // The pending tasks of Schedule(fn, priority), by priority. Shared with the
+  // scheduled closures, which may outlive this object with a user_threadpool.
+  struct PriorityQueues;
+  std::shared_ptr<PriorityQueues> priority_queues_;
+
   // underlying_threadpool_ is the user_threadpool if user_threadpool is
   // provided in the constructor. Otherwise it is the eigen_threadpool_.
   Eigen::ThreadPoolInterface* underlying_threadpool_;
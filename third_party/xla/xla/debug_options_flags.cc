@@ -87,6 +87,8 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_cpu_parallel_codegen_split_count(32);
   opts.set_xla_cpu_enable_concurrency_optimized_scheduler(false);
   opts.set_xla_cpu_prefer_vector_width(256);
+  opts.set_xla_cpu_sequential_execution_buffer_threshold(512);
+  opts.set_xla_cpu_use_priority_ready_queue(false);
 
   opts.set_xla_cpu_enable_fast_math(false);
   // Disable forms of fast math that have caused users problems in the past.
@@ -267,6 +269,7 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_require_complete_aot_autotune_results(false);
 
   opts.set_xla_gpu_enable_host_memory_offloading(false);
+  opts.set_xla_gpu_host_memory_offloading_bandwidth(0);
 
   opts.set_xla_gpu_nccl_terminate_on_error(false);
 
@@ -881,6 +884,19 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       int32_setter_for(&DebugOptions::set_xla_cpu_prefer_vector_width),
       debug_options->xla_cpu_prefer_vector_width(),
       "Preferred vector with for the XLA:CPU LLVM backend."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_sequential_execution_buffer_threshold",
+      int64_setter_for(
+          &DebugOptions::set_xla_cpu_sequential_execution_buffer_threshold),
+      debug_options->xla_cpu_sequential_execution_buffer_threshold(),
+      "Execute thunk sequences that only access buffers of at most this many "
+      "bytes sequentially in the XLA:CPU thunk runtime."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_use_priority_ready_queue",
+      bool_setter_for(&DebugOptions::set_xla_cpu_use_priority_ready_queue),
+      debug_options->xla_cpu_use_priority_ready_queue(),
+      "Execute ready thunks in the order of their priority in the XLA:CPU "
+      "thunk runtime."));
   flag_list->push_back(tsl::Flag(
       "xla_gpu_crash_on_verification_failures",
       bool_setter_for(
@@ -1861,6 +1877,14 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       bool_setter_for(&DebugOptions::set_xla_gpu_enable_host_memory_offloading),
       debug_options->xla_gpu_enable_host_memory_offloading(),
       "Whether to trigger host memory offloading on a device."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_host_memory_offloading_bandwidth",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_host_memory_offloading_bandwidth),
+      debug_options->xla_gpu_host_memory_offloading_bandwidth(),
+      "Bandwidth in bytes per second of the copies between device and host "
+      "memory assumed by host memory offloading. If 0, the device memory "
+      "bandwidth is used."));
   flag_list->push_back(tsl::Flag(
       "xla_gpu_nccl_terminate_on_error",
       bool_setter_for(&DebugOptions::set_xla_gpu_nccl_terminate_on_error),
@@ -422,6 +422,141 @@ class AsyncHostToDeviceTransferManager
     return stream->DoHostCallback(std::move(cleanup));
   }
 
+  // Enqueues the copies of all the buffers back to back on the host to device
+  // stream, with a single staging copy and a single cleanup host callback for
+  // the whole batch. Every buffer still gets its own definition event, so
+  // that it becomes available as soon as its own copy completes.
+  absl::Status TransferRawDataToBuffers(
+      absl::Span<const int> buffer_indices,
+      absl::Span<const absl::string_view> data,
+      absl::AnyInvocable<void() &&> on_done) override {
+    tsl::profiler::TraceMe traceme(
+        "AsyncHostToDeviceTransferManager::TransferRawDataToBuffers");
+    if (buffer_indices.size() != data.size()) {
+      return InvalidArgument(
+          "Number of buffer indices %d does not match the number of host "
+          "buffers %d",
+          buffer_indices.size(), data.size());
+    }
+    auto* stream = device_->local_device_state()->host_to_device_stream();
+
+    auto* client =
+        tensorflow::down_cast<PjRtStreamExecutorClient*>(device_->client());
+    // Offsets of the host buffers in the staging buffer, aligned so that
+    // every copy starts at an aligned address.
+    std::vector<size_t> staging_offsets(data.size());
+    size_t staging_size = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+      staging_offsets[i] = staging_size;
+      staging_size += xla::RoundUpTo<size_t>(
+          data[i].size(), tsl::Allocator::kAllocatorAlignment);
+    }
+    std::shared_ptr<void> staging_buffer;
+    if (client->should_stage_host_to_device_transfers() && staging_size > 0) {
+      auto* host_memory_allocator = client->host_memory_allocator();
+      if (host_memory_allocator == nullptr) {
+        return InvalidArgument(
+            "host_memory_allocator should be initialized for staging buffer "
+            "transfer.");
+      }
+
+      void* ptr = host_memory_allocator->AllocateRaw(
+          tsl::Allocator::kAllocatorAlignment, staging_size);
+      staging_buffer = std::shared_ptr<void>(
+          ptr, [host_memory_allocator = host_memory_allocator](void* ptr) {
+            host_memory_allocator->DeallocateRaw(ptr);
+          });
+    }
+
+    std::vector<se::DeviceMemoryBase> sub_buffers;
+    sub_buffers.reserve(buffer_indices.size());
+    {
+      absl::MutexLock l(&mu_);
+      // Check all the buffers before starting any transfer, so that a failed
+      // call leaves every buffer untouched.
+      for (size_t i = 0; i < buffer_indices.size(); ++i) {
+        const int buffer_index = buffer_indices[i];
+        DCHECK_LT(buffer_index, buffer_ptrs_.size());
+        if (last_transfer_started_[buffer_index]) {
+          return InvalidArgument(
+              "TransferRawDataToBuffers requested for buffer index %d which "
+              "has already been fully transferred",
+              buffer_index);
+        }
+        DCHECK(buffer_ptrs_[buffer_index]);
+        if (buffer_ptrs_[buffer_index]->device_memory().empty()) {
+          return InvalidArgument(
+              "TransferRawDataToBuffers requested for buffer index %d which "
+              "has been donated. Async transfer of donated buffers is not "
+              "supported in SE:GPU",
+              buffer_index);
+        }
+        DCHECK_EQ(buffer_ptrs_[buffer_index]->device_memory().size(), 1);
+        const se::DeviceMemoryBase& buffer_memory =
+            buffer_ptrs_[buffer_index]->device_memory()[0];
+        if (data[i].size() > buffer_memory.size()) {
+          return InvalidArgument(
+              "TransferRawDataToBuffers requested to transfer %d bytes into "
+              "buffer index %d of %d bytes",
+              data[i].size(), buffer_index, buffer_memory.size());
+        }
+        if (data[i].size() < buffer_memory.size()) {
+          sub_buffers.push_back(buffer_memory.GetByteSlice(0, data[i].size()));
+        } else {
+          sub_buffers.push_back(buffer_memory);
+        }
+      }
+      for (const int buffer_index : buffer_indices) {
+        last_transfer_started_[buffer_index] = true;
+      }
+      ++transfers_in_flight_;
+    }
+
+    EventPool& event_pool = device_->local_device_state()->event_pool();
+    std::vector<EventPool::Handle> events;
+    events.reserve(buffer_indices.size());
+    for (size_t i = 0; i < buffer_indices.size(); ++i) {
+      TF_ASSIGN_OR_RETURN(EventPool::Handle event,
+                          event_pool.AllocateEvent(stream->parent()));
+      events.push_back(std::move(event));
+    }
+
+    if (staging_buffer != nullptr) {
+      std::vector<absl::string_view> host_data(data.begin(), data.end());
+      auto copy_to_staging_buffer = [host_data = std::move(host_data),
+                                     staging_offsets, staging_buffer]() {
+        char* staging = static_cast<char*>(staging_buffer.get());
+        for (size_t i = 0; i < host_data.size(); ++i) {
+          std::memcpy(staging + staging_offsets[i], host_data[i].data(),
+                      host_data[i].size());
+        }
+      };
+      TF_RETURN_IF_ERROR(
+          stream->DoHostCallback(std::move(copy_to_staging_buffer)));
+    }
+    for (size_t i = 0; i < buffer_indices.size(); ++i) {
+      if (!data[i].empty()) {
+        const void* src =
+            staging_buffer != nullptr
+                ? static_cast<char*>(staging_buffer.get()) + staging_offsets[i]
+                : data[i].data();
+        TF_RETURN_IF_ERROR(
+            stream->Memcpy(&sub_buffers[i], src, data[i].size()));
+      }
+      event_pool.ThenRecordEvent(stream, events[i]);
+    }
+
+    auto cleanup = [this, buffer_indices = std::vector<int>(
+                              buffer_indices.begin(), buffer_indices.end()),
+                    events = std::move(events), stream,
+                    on_done = std::move(on_done),
+                    staging_buffer = std::move(staging_buffer)]() mutable {
+      CleanUpBatch(buffer_indices, std::move(events), stream,
+                   std::move(on_done));
+    };
+    return stream->DoHostCallback(std::move(cleanup));
+  }
+
   void SetBufferError(int buffer_index, absl::Status error) override {
     {
       absl::MutexLock l(&mu_);
@@ -490,6 +625,33 @@ class AsyncHostToDeviceTransferManager
     // Call on_done after finishing all housekeeping and releasing the lock.
     std::move(on_done)();
   }
+
+  void CleanUpBatch(absl::Span<const int> buffer_indices,
+                    std::vector<EventPool::Handle> events, se::Stream* stream,
+                    absl::AnyInvocable<void() &&> on_done) {
+    {
+      absl::MutexLock l(&mu_);
+
+      CHECK_GT(transfers_in_flight_, 0);
+      --transfers_in_flight_;
+      for (size_t i = 0; i < buffer_indices.size(); ++i) {
+        const int buffer_index = buffer_indices[i];
+        // Drop our reference to the TrackedDeviceBuffer for this buffer.
+        CHECK(buffer_ptrs_[buffer_index]);
+        buffer_ptrs_[buffer_index] = nullptr;
+        CHECK_GT(remaining_buffer_count_, 0);
+        --remaining_buffer_count_;
+        definition_events_[buffer_index]->SetSequencingEvent(
+            std::move(events[i]), stream);
+      }
+      if (remaining_buffer_count_ == 0) {
+        VLOG(1) << "TransferRawDataToBuffers for all buffers is done.";
+      }
+    }
+
+    // Call on_done after finishing all housekeeping and releasing the lock.
+    std::move(on_done)();
+  }
 };
 
 StreamExecutorGpuClient::StreamExecutorGpuClient(
@@ -33,6 +33,7 @@ limitations under the License.
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
@@ -564,6 +565,48 @@ TEST(StreamExecutorGpuClientTest, FromHostAsync) {
   }
 }
 
+TEST(StreamExecutorGpuClientTest, FromHostAsyncBatch) {
+  GpuClientOptions options;
+  options.should_stage_host_to_device_transfers = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetStreamExecutorGpuClient(options));
+  ASSERT_GE(client->addressable_devices().size(), 1);
+
+  std::vector<Literal> src_literals;
+  std::vector<Shape> src_shapes;
+  std::vector<int> buffer_indices;
+  std::vector<absl::string_view> data;
+  for (int i = 0; i < 4; ++i) {
+    std::vector<float> values(i + 1);
+    std::iota(values.begin(), values.end(), static_cast<float>(i + 10));
+    src_literals.emplace_back(LiteralUtil::CreateR1<float>(values));
+    src_shapes.push_back(src_literals.back().shape());
+    buffer_indices.push_back(i);
+  }
+  for (const Literal& literal : src_literals) {
+    data.emplace_back(static_cast<const char*>(literal.untyped_data()),
+                      literal.size_bytes());
+  }
+  TF_ASSERT_OK_AND_ASSIGN(auto transfer_manager,
+                          client->CreateBuffersForAsyncHostToDevice(
+                              src_shapes, client->addressable_devices()[0]));
+  absl::Notification transfers_done;
+  TF_ASSERT_OK(transfer_manager->TransferRawDataToBuffers(
+      buffer_indices, data, [&]() { transfers_done.Notify(); }));
+  transfers_done.WaitForNotification();
+
+  for (int i = 0; i < src_literals.size(); ++i) {
+    std::unique_ptr<PjRtBuffer> buffer = transfer_manager->RetrieveBuffer(i);
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                            buffer->ToLiteralSync());
+    EXPECT_EQ(src_literals[i].data<float>(),
+              literal->Relayout(src_literals[i].shape().layout())
+                  .data<float>());
+  }
+  // Buffers can not be transferred into twice.
+  EXPECT_FALSE(
+      transfer_manager->TransferRawDataToBuffers({0}, {data[0]}, [] {}).ok());
+}
+
 TEST(StreamExecutorGpuClientTest, FromHostAsyncPinnedHost) {
   TF_ASSERT_OK_AND_ASSIGN(auto client,
                           GetStreamExecutorGpuClient(GpuClientOptions()));
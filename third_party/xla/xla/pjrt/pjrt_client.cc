@@ -15,13 +15,17 @@ limitations under the License.
 
 #include "xla/pjrt/pjrt_client.h"
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/base/casts.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/pjrt/utils.h"
 #include "xla/util.h"
@@ -45,6 +49,42 @@ absl::StatusOr<std::uintptr_t> PjRtClient::UnsafeBufferPointer(
   return absl::bit_cast<std::uintptr_t>(ptr);
 }
 
+absl::Status
+PjRtClient::AsyncHostToDeviceTransferManager::TransferRawDataToBuffers(
+    absl::Span<const int> buffer_indices,
+    absl::Span<const absl::string_view> data,
+    absl::AnyInvocable<void() &&> on_done) {
+  if (buffer_indices.size() != data.size()) {
+    return InvalidArgument(
+        "Number of buffer indices %d does not match the number of host "
+        "buffers %d",
+        buffer_indices.size(), data.size());
+  }
+  struct State {
+    std::atomic<size_t> pending;
+    absl::AnyInvocable<void() &&> on_done;
+  };
+  // One extra pending transfer for this call, so that on_done is not called
+  // before all the transfers are started.
+  auto state = std::make_shared<State>();
+  state->pending = buffer_indices.size() + 1;
+  state->on_done = std::move(on_done);
+  auto done = [state]() {
+    if (state->pending.fetch_sub(1) == 1) std::move(state->on_done)();
+  };
+  absl::Status status;
+  for (size_t i = 0; i < buffer_indices.size(); ++i) {
+    status = TransferRawDataToBuffer(buffer_indices[i], data[i], done);
+    if (!status.ok()) {
+      // The failed and the remaining transfers are never started.
+      state->pending -= buffer_indices.size() - i;
+      break;
+    }
+  }
+  done();
+  return status;
+}
+
 PjRtFuture<> PjRtBuffer::CopyRawToHostFuture(PjRtFuture<void*> dst,
                                              int64_t offset,
                                              int64_t transfer_size) {
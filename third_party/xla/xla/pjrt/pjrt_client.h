@@ -746,6 +746,17 @@ class PjRtClient {
         int64_t transfer_size, bool is_last_transfer,
         absl::AnyInvocable<void() &&> on_done) = 0;
 
+    // Transfers data[i] into buffer_indices[i] for every i as a single batch,
+    // with the same requirements as TransferRawDataToBuffer for each buffer.
+    // on_done is called once all the transfers started by this call are
+    // complete, also when an error is returned. Backends may amortize the
+    // per-transfer overheads, such as staging copies and host callbacks, over
+    // the batch. By default the buffers are transferred one by one.
+    virtual absl::Status TransferRawDataToBuffers(
+        absl::Span<const int> buffer_indices,
+        absl::Span<const absl::string_view> data,
+        absl::AnyInvocable<void() &&> on_done);
+
     // Indicates that a specific buffer should result in an error status. No
     // transfer calls (or further SetBufferError calls) into buffer_index can
     // be made after this call.
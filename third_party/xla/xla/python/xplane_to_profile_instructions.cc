@@ -22,6 +22,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
@@ -36,6 +37,8 @@ limitations under the License.
 #include "tsl/profiler/protobuf/xplane.pb.h"
 #include "tsl/profiler/utils/file_system_utils.h"
 #include "tsl/profiler/utils/tf_xplane_visitor.h"
+#include "tsl/profiler/utils/timespan.h"
+#include "tsl/profiler/utils/trace_utils.h"
 #include "tsl/profiler/utils/xplane_schema.h"
 #include "tsl/profiler/utils/xplane_utils.h"
 #include "tsl/profiler/utils/xplane_visitor.h"
@@ -56,12 +59,60 @@ using tsl::profiler::HostEventType;
 using tsl::profiler::IsInternalEvent;
 using tsl::profiler::ProfilerJoinPath;
 using tsl::profiler::StatType;
+using tsl::profiler::Timespan;
 using tsl::profiler::XEventMetadataVisitor;
 using tsl::profiler::XEventVisitor;
 using tsl::profiler::XLineVisitor;
 using tsl::profiler::XPlaneVisitor;
 using tsl::profiler::XStatVisitor;
 
+// Returns the cost name of the HLO instruction of the event, or nullopt if the
+// event is not an HLO instruction.
+std::optional<std::string> GetHloCostName(
+    const XEventVisitor& xevent,
+    const absl::flat_hash_map<std::string, std::string>& hlo_module_info) {
+  int64_t event_type =
+      xevent.Type().value_or(HostEventType::kUnknownHostEventType);
+  if (IsInternalEvent(event_type)) return std::nullopt;
+  std::optional<std::string> hlo_name = std::nullopt;
+  std::optional<std::string> hlo_module_name = std::nullopt;
+  std::optional<std::string> fingerprint = std::nullopt;
+  std::optional<int64_t> program_id = std::nullopt;
+
+  auto for_each_stat = [&](const XStatVisitor& stat) {
+    if (stat.ValueCase() == tsl::profiler::XStat::VALUE_NOT_SET) return;
+    if (stat.Name() == GetStatTypeStr(StatType::kHloOp)) {
+      hlo_name = stat.ToString();
+    }
+    if (stat.Name() == GetStatTypeStr(StatType::kProgramId)) {
+      program_id = stat.IntValue();
+    }
+    if (stat.Name() == GetStatTypeStr(StatType::kHloModule)) {
+      hlo_module_name = stat.ToString();
+    }
+  };
+  xevent.Metadata().ForEachStat(for_each_stat);
+  xevent.ForEachStat(for_each_stat);
+  if (!hlo_name.has_value() || !hlo_module_name.has_value()) {
+    return std::nullopt;
+  }
+
+  if (hlo_module_name.has_value()) {
+    std::string fingerprint_key = hlo_module_name.value();
+    if (program_id.has_value()) {
+      fingerprint_key = tsl::profiler::HloModuleNameWithProgramId(
+          hlo_module_name.value(), program_id.value());
+    }
+    if (hlo_module_info.contains(fingerprint_key)) {
+      fingerprint = hlo_module_info.at(fingerprint_key);
+    }
+  }
+  if (fingerprint.has_value()) {
+    return absl::StrCat(fingerprint.value(), kCostNameSep, hlo_name.value());
+  }
+  return hlo_name;
+}
+
 void GetXPlaneLatencyInfo(
     const XPlaneVisitor& xplane,
     const absl::flat_hash_map<std::string, std::string>& hlo_module_info,
@@ -74,51 +125,78 @@ void GetXPlaneLatencyInfo(
     }
     xline.ForEachEvent([hlo_latency_info,
                         hlo_module_info](const XEventVisitor& xevent) {
-      int64_t event_type =
-          xevent.Type().value_or(HostEventType::kUnknownHostEventType);
-      if (IsInternalEvent(event_type)) return;
-      std::optional<std::string> hlo_name = std::nullopt;
-      std::optional<std::string> hlo_module_name = std::nullopt;
-      std::optional<std::string> fingerprint = std::nullopt;
-      std::optional<int64_t> program_id = std::nullopt;
-
-      auto for_each_stat = [&](const XStatVisitor& stat) {
-        if (stat.ValueCase() == tsl::profiler::XStat::VALUE_NOT_SET) return;
-        // Store latency information for HLOs.
-        if (stat.Name() == GetStatTypeStr(StatType::kHloOp)) {
-          hlo_name = stat.ToString();
-        }
-        if (stat.Name() == GetStatTypeStr(StatType::kProgramId)) {
-          program_id = stat.IntValue();
-        }
-        if (stat.Name() == GetStatTypeStr(StatType::kHloModule)) {
-          hlo_module_name = stat.ToString();
-        }
-      };
-      xevent.Metadata().ForEachStat(for_each_stat);
-      xevent.ForEachStat(for_each_stat);
-      if (!hlo_name.has_value() || !hlo_module_name.has_value()) {
-        return;
-      }
-
-      if (hlo_module_name.has_value()) {
-        std::string fingerprint_key = hlo_module_name.value();
-        if (program_id.has_value()) {
-          fingerprint_key = tsl::profiler::HloModuleNameWithProgramId(
-              hlo_module_name.value(), program_id.value());
-        }
-        if (hlo_module_info.contains(fingerprint_key)) {
-          fingerprint = hlo_module_info.at(fingerprint_key);
-        }
-      }
+      std::optional<std::string> key = GetHloCostName(xevent, hlo_module_info);
+      if (!key.has_value()) return;
       double latency = static_cast<double>(xevent.DurationNs()) / 1e3;
-      std::string key = hlo_name.value();
-      if (fingerprint.has_value()) {
-        key = absl::StrCat(fingerprint.value(), kCostNameSep, hlo_name.value());
+      (*hlo_latency_info)[*key].durations.emplace_back(latency);
+    });
+  });
+}
+
+void GetXPlaneOverlapInfo(
+    const XPlaneVisitor& xplane,
+    const absl::flat_hash_map<std::string, std::string>& hlo_module_info,
+    absl::flat_hash_map<std::string, HloOverlapInfo>* hlo_overlap_info) {
+  struct HloEvent {
+    std::string name;
+    Timespan span;
+  };
+  // The events of every stream of the device. Derived lines only summarize
+  // the events of the streams, so they are skipped.
+  std::vector<std::vector<Timespan>> line_spans;
+  std::vector<std::vector<HloEvent>> line_hlo_events;
+  xplane.ForEachLine([&](const XLineVisitor& xline) {
+    if (tsl::profiler::IsDerivedThreadId(xline.Id()) ||
+        xline.DisplayName() == tsl::profiler::kXlaAsyncOpLineName) {
+      return;
+    }
+    std::vector<Timespan>& spans = line_spans.emplace_back();
+    std::vector<HloEvent>& hlo_events = line_hlo_events.emplace_back();
+    xline.ForEachEvent([&](const XEventVisitor& xevent) {
+      spans.push_back(xevent.GetTimespan());
+      std::optional<std::string> key = GetHloCostName(xevent, hlo_module_info);
+      if (key.has_value()) {
+        hlo_events.push_back({*std::move(key), xevent.GetTimespan()});
       }
-      (*hlo_latency_info)[key].durations.emplace_back(latency);
     });
   });
+
+  for (size_t i = 0; i < line_spans.size(); ++i) {
+    if (line_hlo_events[i].empty()) continue;
+    // Merge the events of the other streams into disjoint timespans.
+    std::vector<Timespan> others;
+    for (size_t j = 0; j < line_spans.size(); ++j) {
+      if (j == i) continue;
+      others.insert(others.end(), line_spans[j].begin(), line_spans[j].end());
+    }
+    absl::c_sort(others, [](const Timespan& a, const Timespan& b) {
+      return a.begin_ps() < b.begin_ps();
+    });
+    std::vector<Timespan> merged;
+    for (const Timespan& span : others) {
+      if (!merged.empty() && span.begin_ps() <= merged.back().end_ps()) {
+        merged.back().ExpandToInclude(span);
+      } else {
+        merged.push_back(span);
+      }
+    }
+
+    for (const HloEvent& event : line_hlo_events[i]) {
+      uint64_t overlapped_ps = 0;
+      auto it = absl::c_upper_bound(
+          merged, event.span.begin_ps(),
+          [](uint64_t begin_ps, const Timespan& span) {
+            return begin_ps < span.end_ps();
+          });
+      for (; it != merged.end() && it->begin_ps() < event.span.end_ps();
+           ++it) {
+        overlapped_ps += event.span.OverlappedDurationPs(*it);
+      }
+      HloOverlapInfo& info = (*hlo_overlap_info)[event.name];
+      info.duration_us += static_cast<double>(event.span.duration_ps()) / 1e6;
+      info.overlapped_us += static_cast<double>(overlapped_ps) / 1e6;
+    }
+  }
 }
 
 std::unique_ptr<xla::HloModule> CreateModuleFromProto(
@@ -174,6 +252,22 @@ void GetXPlaneHloModuleInfo(
   });
 }
 
+std::vector<const XPlane*> FindDevicePlanes(const XSpace& xspace) {
+  std::vector<const XPlane*> device_planes =
+      FindPlanesWithPrefix(xspace, tsl::profiler::kGpuPlanePrefix);
+  // We don't expect GPU and TPU planes and custom devices to be present in
+  // the same XSpace.
+  if (device_planes.empty()) {
+    device_planes =
+        FindPlanesWithPrefix(xspace, tsl::profiler::kTpuPlanePrefix);
+  }
+  if (device_planes.empty()) {
+    device_planes =
+        FindPlanesWithPrefix(xspace, tsl::profiler::kCustomPlanePrefix);
+  }
+  return device_planes;
+}
+
 }  // namespace
 
 absl::Status ConvertXplaneUnderLogdirToProfiledInstructionsProto(
@@ -215,18 +309,7 @@ absl::Status ConvertXplaneToProfiledInstructionsProto(
       XPlaneVisitor xplane = CreateTfXPlaneVisitor(metadata_plane);
       GetXPlaneHloModuleInfo(xplane, &hlo_module_info);
     }
-    std::vector<const XPlane*> device_planes =
-        FindPlanesWithPrefix(xspace, tsl::profiler::kGpuPlanePrefix);
-    // We don't expect GPU and TPU planes and custom devices to be present in
-    // the same XSpace.
-    if (device_planes.empty()) {
-      device_planes =
-          FindPlanesWithPrefix(xspace, tsl::profiler::kTpuPlanePrefix);
-    }
-    if (device_planes.empty()) {
-      device_planes =
-          FindPlanesWithPrefix(xspace, tsl::profiler::kCustomPlanePrefix);
-    }
+    std::vector<const XPlane*> device_planes = FindDevicePlanes(xspace);
     // Go over each device plane.
     for (const XPlane* device_plane : device_planes) {
       XPlaneVisitor xplane = CreateTfXPlaneVisitor(device_plane);
@@ -246,4 +329,23 @@ absl::Status ConvertXplaneToProfiledInstructionsProto(
   return absl::OkStatus();
 }
 
+absl::Status ConvertXplaneToHloOverlapInfo(
+    const std::vector<tensorflow::profiler::XSpace>& xspaces,
+    absl::flat_hash_map<std::string, HloOverlapInfo>* hlo_overlap_info) {
+  absl::flat_hash_map<std::string, std::string> hlo_module_info;
+  for (const XSpace& xspace : xspaces) {
+    const XPlane* metadata_plane =
+        FindPlaneWithName(xspace, tsl::profiler::kMetadataPlaneName);
+    if (metadata_plane != nullptr) {
+      XPlaneVisitor xplane = CreateTfXPlaneVisitor(metadata_plane);
+      GetXPlaneHloModuleInfo(xplane, &hlo_module_info);
+    }
+    for (const XPlane* device_plane : FindDevicePlanes(xspace)) {
+      XPlaneVisitor xplane = CreateTfXPlaneVisitor(device_plane);
+      GetXPlaneOverlapInfo(xplane, hlo_module_info, hlo_overlap_info);
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace xla
@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "tsl/profiler/protobuf/profiled_instructions.pb.h"
 #include "tsl/profiler/protobuf/xplane.pb.h"
@@ -34,6 +35,15 @@ struct HloLatencyInfo {
   std::vector<double> durations;
 };
 
+// Measured overlap of a single HLO instruction with the instructions running
+// concurrently on other streams of the same device.
+struct HloOverlapInfo {
+  // The total time the instruction ran.
+  double duration_us = 0;
+  // The part of `duration_us` during which other streams were busy.
+  double overlapped_us = 0;
+};
+
 // Convert XSpace to ProfiledInstructionsProto. This function will aggregate
 // all the xplane.pb info into ProfiledInstructionsProto.
 absl::Status ConvertXplaneToProfiledInstructionsProto(
@@ -47,6 +57,15 @@ absl::Status ConvertXplaneUnderLogdirToProfiledInstructionsProto(
     const std::string& logdir, tensorflow::profiler::ProfiledInstructionsProto*
                                    profiled_instructions_proto);
 
+// Measures how much of the execution of every HLO instruction in the device
+// planes of `xspaces` was overlapped with work on other streams, keyed like
+// the costs of ProfiledInstructionsProto. The exposed time of collectives,
+// `duration_us - overlapped_us`, shows how well the latency hiding scheduler
+// hid them, for example after recompiling with a profile-guided latency table.
+absl::Status ConvertXplaneToHloOverlapInfo(
+    const std::vector<tensorflow::profiler::XSpace>& xspaces,
+    absl::flat_hash_map<std::string, HloOverlapInfo>* hlo_overlap_info);
+
 }  // namespace xla
 
 #endif  // XLA_PYTHON_XPLANE_TO_PROFILE_INSTRUCTIONS_H_
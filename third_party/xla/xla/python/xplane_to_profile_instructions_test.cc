@@ -19,6 +19,8 @@ limitations under the License.
 #include <memory>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/tests/verified_hlo_module.h"
 #include "xla/tsl/profiler/convert/xla_op_utils.h"
@@ -263,5 +265,38 @@ TEST(XplaneToProfiledInstructionsProtoTest,
   EXPECT_EQ(profile_proto.costs(0).name(), "08a5::custom-call");
 }
 
+TEST(XplaneToProfiledInstructionsProtoTest, ConvertXplaneToHloOverlapInfo) {
+  XSpace space;
+  XPlaneBuilder device_plane(space.add_planes());
+  device_plane.SetName(GpuPlaneName(0));
+  auto add_hlo_event = [&](XLineBuilder& stream, absl::string_view hlo_name,
+                           int64_t timestamp_ns, int64_t duration_ns) {
+    XEventBuilder event =
+        stream.AddEvent(*device_plane.GetOrCreateEventMetadata(hlo_name));
+    event.SetTimestampNs(timestamp_ns);
+    event.SetDurationNs(duration_ns);
+    event.AddStatValue(
+        *device_plane.GetOrCreateStatMetadata(GetStatTypeStr(StatType::kHloOp)),
+        *device_plane.GetOrCreateStatMetadata(hlo_name));
+    event.AddStatValue(*device_plane.GetOrCreateStatMetadata(
+                           GetStatTypeStr(StatType::kHloModule)),
+                       *device_plane.GetOrCreateStatMetadata("test_module"));
+  };
+  XLineBuilder compute_stream = device_plane.GetOrCreateLine(1);
+  add_hlo_event(compute_stream, "fusion", 100000, 10000);
+  add_hlo_event(compute_stream, "fusion.1", 112000, 4000);
+  XLineBuilder collective_stream = device_plane.GetOrCreateLine(2);
+  add_hlo_event(collective_stream, "all-reduce-start", 105000, 15000);
+
+  absl::flat_hash_map<std::string, HloOverlapInfo> overlap_info;
+  EXPECT_TRUE(ConvertXplaneToHloOverlapInfo({space}, &overlap_info).ok());
+  ASSERT_EQ(overlap_info.size(), 3);
+  EXPECT_DOUBLE_EQ(overlap_info["all-reduce-start"].duration_us, 15);
+  EXPECT_DOUBLE_EQ(overlap_info["all-reduce-start"].overlapped_us, 9);
+  EXPECT_DOUBLE_EQ(overlap_info["fusion"].duration_us, 10);
+  EXPECT_DOUBLE_EQ(overlap_info["fusion"].overlapped_us, 5);
+  EXPECT_DOUBLE_EQ(overlap_info["fusion.1"].overlapped_us, 4);
+}
+
 }  // namespace
 }  // namespace xla
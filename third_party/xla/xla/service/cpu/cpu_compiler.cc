@@ -125,6 +125,7 @@ limitations under the License.
 #include "xla/service/cpu/executable.pb.h"
 #include "xla/service/cpu/ir_emitter.h"
 #include "xla/service/cpu/ir_emitter2.h"
+#include "xla/service/cpu/metrics.h"
 #include "xla/service/cpu/parallel_task_assignment.h"
 #include "xla/service/cpu/simple_orc_jit.h"
 #include "xla/service/cpu/target_machine_features.h"
@@ -1539,6 +1540,7 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
                               {"num_kernels", symbols.kernels.size()},
                               {"num_comparators", symbols.comparators.size()}});
       });
+      const uint64_t start_usecs = tsl::Env::Default()->NowMicros();
 
       for (const auto& kernel : symbols.kernels) {
         TraceMe trace(
@@ -1559,6 +1561,13 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
         }
       }
 
+      const uint64_t duration_usecs =
+          tsl::Env::Default()->NowMicros() - start_usecs;
+      RecordCodegenPartDuration(duration_usecs);
+      VLOG(2) << "Compiled LLVM module part " << part << " with "
+              << symbols.kernels.size() << " kernels and "
+              << symbols.comparators.size() << " comparators in "
+              << duration_usecs << " us";
       return absl::OkStatus();
     };
 
@@ -1572,6 +1581,7 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
     }
 
     // Schedule compilation of LLVM module parts in parallel.
+    const uint64_t codegen_start_usecs = tsl::Env::Default()->NowMicros();
     std::vector<AsyncValueRef<Chain>> compile_tasks(compiled_parts.size());
     for (size_t part = 0; part < compiled_parts.size(); ++part) {
       compile_tasks[part] = tsl::TryMakeAsyncValueRef(
@@ -1591,6 +1601,8 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
         tsl::BlockUntilReady(task);
         if (task.IsError()) return task.GetError();
       }
+      RecordCodegenDuration(tsl::Env::Default()->NowMicros() -
+                            codegen_start_usecs);
     }
 
     // Create constant allocations from the buffer assignment.
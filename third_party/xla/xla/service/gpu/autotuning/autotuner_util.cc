@@ -35,6 +35,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "llvm/ADT/StringRef.h"
@@ -62,6 +63,7 @@ limitations under the License.
 #include "tsl/platform/logging.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/protobuf.h"  // IWYU pragma: keep
+#include "tsl/platform/random.h"
 #include "tsl/platform/statusor.h"
 
 namespace xla {
@@ -95,16 +97,28 @@ absl::StatusOr<std::string> GetBase64EncodedSha256Hash(absl::string_view s) {
   return base64_encoded_hash;
 }
 
+absl::StatusOr<std::string> GetCacheFilename(const AutotuneCacheKey& key) {
+  // The version is hashed together with the key, so that results of older
+  // versions shared in the same cache directory are ignored rather than
+  // misparsed.
+  TF_ASSIGN_OR_RETURN(
+      std::string key_hash,
+      GetBase64EncodedSha256Hash(
+          absl::StrCat(key.ToString(), " version=", kVersion)));
+  return absl::StrCat(key_hash, ".textproto");
+}
+
 namespace {
 
 // Get the path corresponding to the given key.
 absl::StatusOr<std::string> GetCacheFilePath(absl::string_view cache_dir,
-                                             absl::string_view key_hash) {
+                                             const AutotuneCacheKey& key) {
   if (cache_dir.empty()) {
     return absl::InvalidArgumentError("autotune_cache_dir should not be empty");
   }
 
-  return tsl::io::JoinPath(cache_dir, absl::StrCat(key_hash, ".textproto"));
+  TF_ASSIGN_OR_RETURN(std::string filename, GetCacheFilename(key));
+  return tsl::io::JoinPath(cache_dir, filename);
 }
 
 struct ResultAndInserted {
@@ -138,11 +152,8 @@ absl::Status AddResultToFileBasedCacheIfEnabled(
   tsl::Env* default_env = tsl::Env::Default();
   TF_RETURN_IF_ERROR(CreateDirIfNeeded(std::string(cache_dir), default_env));
 
-  TF_ASSIGN_OR_RETURN(std::string key_hash,
-                      GetBase64EncodedSha256Hash(key.ToString()));
-
   TF_ASSIGN_OR_RETURN(const std::string file_path,
-                      GetCacheFilePath(cache_dir, key_hash));
+                      GetCacheFilePath(cache_dir, key));
 
   VLOG(1) << "Writing autotune result to file: " << file_path;
 
@@ -154,14 +165,18 @@ absl::Status AddResultToFileBasedCacheIfEnabled(
   // Rename trick: Write to a temporary file, then rename it to the final file
   // to avoid mingled files when multiple threads are writing to the same
   // file. Also avoids reading incomplete files. (This may not work on all file
-  // systems.)
+  // systems.) The random suffix keeps the temporary files of processes on
+  // different hosts sharing the cache directory apart.
   std::string tmp_dir = tsl::io::JoinPath(cache_dir, "tmp");
   TF_RETURN_IF_ERROR(CreateDirIfNeeded(tmp_dir, default_env));
   int64_t time_stamp = absl::GetCurrentTimeNanos();
 
+  absl::string_view key_hash =
+      absl::StripSuffix(tsl::io::Basename(file_path), ".textproto");
   std::string temp_file_path = tsl::io::JoinPath(
       tmp_dir, absl::StrCat("tmp_per_fusion_cache_", key_hash, "_",
-                            std::to_string(time_stamp), ".textproto"));
+                            std::to_string(time_stamp), "_",
+                            absl::Hex(tsl::random::New64()), ".textproto"));
 
   TF_RETURN_IF_ERROR(
       tsl::WriteStringToFile(default_env, temp_file_path, result_str));
@@ -199,11 +214,8 @@ TryToFindInFileBasedCacheIfEnabled(const AutotuneCacheKey& key,
     return std::nullopt;
   }
 
-  TF_ASSIGN_OR_RETURN(std::string key_hash,
-                      GetBase64EncodedSha256Hash(key.ToString()));
-
   TF_ASSIGN_OR_RETURN(const std::string file_path,
-                      GetCacheFilePath(cache_dir, key_hash));
+                      GetCacheFilePath(cache_dir, key));
   if (!tsl::Env::Default()->FileExists(file_path).ok()) {
     VLOG(1) << "Autotune result file not found: " << file_path;
     return std::nullopt;
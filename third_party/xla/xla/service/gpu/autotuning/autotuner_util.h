@@ -355,6 +355,11 @@ absl::StatusOr<std::string> AutotuneResultsToString(
 // tsl::Fingerprint128.
 absl::StatusOr<std::string> GetBase64EncodedSha256Hash(absl::string_view s);
 
+// Exposed only for testing. Returns the name of the file storing the result
+// for `key` in the per-fusion autotune cache directory. Results written by
+// XLA versions with a different autotune results version use other files.
+absl::StatusOr<std::string> GetCacheFilename(const AutotuneCacheKey& key);
+
 }  // namespace gpu
 }  // namespace xla
 
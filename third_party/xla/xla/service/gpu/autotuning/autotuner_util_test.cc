@@ -333,10 +333,9 @@ class FileBasedCacheTest : public AutotunerUtilTest {
   }
 
   std::string GetCacheFilename() const {
-    absl::StatusOr<std::string> key_hash =
-        GetBase64EncodedSha256Hash(GetCacheKey().ToString());
-    CHECK_OK(key_hash.status());
-    return absl::StrCat(key_hash.value(), ".textproto");
+    absl::StatusOr<std::string> filename = GetCacheFilename(GetCacheKey());
+    CHECK_OK(filename.status());
+    return filename.value();
   }
 
   std::string GetCacheFilePath() const {
@@ -21,6 +21,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -100,6 +101,20 @@ void RemoveUnusedAndUninitializedGlobals(
   }
 }
 
+// Returns the device the binaries of the kernel cache are compiled for.
+std::string GetKernelCacheDevice(const se::DeviceDescription& gpu_device_info) {
+  return std::visit(
+      [](const auto& cc) -> std::string {
+        using T = std::decay_t<decltype(cc)>;
+        if constexpr (std::is_same_v<T, se::RocmComputeCapability>) {
+          return absl::StrCat("ROCM: ", cc.gfx_version());
+        } else {
+          return absl::StrCat("CUDA: ", cc.ToString());
+        }
+      },
+      gpu_device_info.gpu_compute_capability());
+}
+
 }  // namespace
 
 absl::Status LoadCache(IrEmitterContext& ir_emitter_context,
@@ -117,6 +132,13 @@ absl::Status LoadCache(IrEmitterContext& ir_emitter_context,
     if (!proto.ParseFromString(serialized)) {
       return Internal("Failed to parse serialized CompilationCacheProto.");
     }
+    const std::string device =
+        GetKernelCacheDevice(ir_emitter_context.gpu_device_info());
+    if (proto.device() != device) {
+      VLOG(1) << "Ignoring compilation cache file " << resolved_path
+              << " compiled for " << proto.device() << " on " << device;
+      return absl::OkStatus();
+    }
     // Register all cached kernel names with the name uniquer to avoid
     // naming conflicts.
     for (const auto& [name, _] : proto.entries()) {
@@ -279,6 +301,8 @@ absl::StatusOr<CompileModuleResults> CompileModuleToLlvmIr(
   if (use_cache) {
     results.kernel_compilation_cache =
         ir_emitter_context.kernel_cache().Export();
+    results.kernel_compilation_cache.set_device(
+        GetKernelCacheDevice(gpu_device_info));
   }
 
   return results;
@@ -2522,13 +2522,19 @@ HloRematerialization::Options CreateRematOpts(
   if (enable_offloading) {
     int64_t host_memory_space_color =
         static_cast<int64_t>(se::MemoryType::kHost);
+    // The copies to and from the host are bound by the host link, which is
+    // typically much slower than the device memory.
+    int64_t host_bandwidth = module.config()
+                                 .debug_options()
+                                 .xla_gpu_host_memory_offloading_bandwidth();
+    if (host_bandwidth <= 0) {
+      host_bandwidth = gpu_device_info.memory_bandwidth();
+    }
     offloading_config =
         std::make_optional<HloRematerialization::HostMemoryOffloadConfig>(
             /*host_memory_space=*/host_memory_space_color,
-            /*bandwidth_to_host_bytes_per_second=*/
-            gpu_device_info.memory_bandwidth(),
-            /*bandwidth_from_host_bytes_per_second=*/
-            gpu_device_info.memory_bandwidth());
+            /*bandwidth_to_host_bytes_per_second=*/host_bandwidth,
+            /*bandwidth_from_host_bytes_per_second=*/host_bandwidth);
   }
   HloRematerialization::RematerializationModeConfig
       rematerialization_mode_config(/*recompute=*/true, /*compress=*/true,
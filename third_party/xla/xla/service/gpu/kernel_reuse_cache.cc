@@ -157,7 +157,15 @@ absl::Status UpdateDiskKernelCache(
     if (!disk_cache.ParseFromString(std::string(serialized))) {
       return Internal("Failed to parse serialized CompilationCacheProto.");
     }
+    // Kernels compiled for another device can not be linked together with the
+    // current ones, so the file is taken over by the current device.
+    if (disk_cache.device() != current_cache.device()) {
+      VLOG(1) << "Replacing the kernels compiled for " << disk_cache.device()
+              << " in the cache file.";
+      disk_cache.Clear();
+    }
   }
+  disk_cache.set_device(current_cache.device());
   auto entries = disk_cache.mutable_entries();
   int stored_kernel_count = 0;
   for (const auto& [name, binary] : binaries_to_cache) {
@@ -172,9 +180,16 @@ absl::Status UpdateDiskKernelCache(
     ++stored_kernel_count;
   }
   if (stored_kernel_count > 0) {
-    TF_RETURN_IF_ERROR(tsl::WriteStringToFile(tsl::Env::Default(),
-                                              std::string(path),
+    // Write to a temporary file first, so that concurrent compilations sharing
+    // the cache file never read a partially written one.
+    tsl::Env* env = tsl::Env::Default();
+    std::string tmp_path = std::string(path);
+    if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+      return Internal("Failed to create a temporary file name for %s", path);
+    }
+    TF_RETURN_IF_ERROR(tsl::WriteStringToFile(env, tmp_path,
                                               disk_cache.SerializeAsString()));
+    TF_RETURN_IF_ERROR(env->RenameFile(tmp_path, std::string(path)));
     VLOG(2) << "Stored " << stored_kernel_count << " / "
             << binaries_to_cache.size() << " kernels in the cache file.";
   }
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/service/gpu/kernel_reuse_cache.h"
 
+#include <string>
+
 #include <gtest/gtest.h>
 #include "absl/log/check.h"
 #include "xla/service/gpu/executable.pb.h"
@@ -77,6 +79,35 @@ TEST_F(KernelReuseTest, UpdatingDiskKernelCacheWorks) {
   EXPECT_EQ(proto.entries_size(), 2);
 }
 
+TEST_F(KernelReuseTest, UpdatingDiskKernelCacheOfAnotherDeviceReplacesIt) {
+  std::string cache_file_path;
+  CHECK(tsl::Env::Default()->LocalTempFilename(&cache_file_path));
+  auto export_cache = [](std::string kernel_name, std::string device) {
+    KernelReuseCache cache;
+    auto [result, was_cached] = cache.GetWithStatus("fingerprint", [&]() {
+      return KernelReuseCache::Entry{.kernel_name = kernel_name};
+    });
+    CompilationCacheProto proto = cache.Export();
+    proto.set_device(device);
+    return proto;
+  };
+  TF_EXPECT_OK(UpdateDiskKernelCache(cache_file_path, /*do_append=*/false,
+                                     export_cache("k1", "CUDA: 8.0"),
+                                     {{.name = "k1", .binary = {5, 6}}}));
+  TF_EXPECT_OK(UpdateDiskKernelCache(cache_file_path, /*do_append=*/true,
+                                     export_cache("k2", "CUDA: 9.0"),
+                                     {{.name = "k2", .binary = {7, 8}}}));
+
+  std::string serialized;
+  TF_EXPECT_OK(
+      tsl::ReadFileToString(tsl::Env::Default(), cache_file_path, &serialized));
+  CompilationCacheProto proto;
+  EXPECT_TRUE(proto.ParseFromString(std::string(serialized)));
+  EXPECT_EQ(proto.device(), "CUDA: 9.0");
+  EXPECT_EQ(proto.entries_size(), 1);
+  EXPECT_TRUE(proto.entries().contains("k2"));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -2499,8 +2499,32 @@ struct InstructionsAdded {
   int net_instructions_added;
   // Amount of effort expended to find the instructions to rematerialize.
   int effort;
+  // The strategy used to rematerialize the instructions.
+  RematStrategy strategy;
+  // Estimated time to recompute the instructions, for kRecompute.
+  float recompute_seconds = 0.0;
+  // Bytes copied to the host and back, for kHostOffload.
+  int64_t offloaded_bytes = 0;
 };
 
+// Adds the rematerializations of a block to the tradeoff reported by the pass.
+void AddToTradeoff(const InstructionsAdded& instructions_added,
+                   HloRematerialization::RematerializationSizes* tradeoff) {
+  switch (instructions_added.strategy.kind) {
+    case RematStrategy::kRecompute:
+      tradeoff->recomputed_instructions += instructions_added.remat_count;
+      break;
+    case RematStrategy::kCompress:
+      tradeoff->compressed_instructions += instructions_added.remat_count;
+      break;
+    case RematStrategy::kHostOffload:
+      tradeoff->offloaded_instructions += instructions_added.remat_count;
+      break;
+  }
+  tradeoff->recompute_seconds += instructions_added.recompute_seconds;
+  tradeoff->offloaded_bytes += instructions_added.offloaded_bytes;
+}
+
 // Rematerializes the best block of instructions of size between min_block_size
 // and max_block_size (both inclusive) if at least one candidate block of
 // instructions can be found. Returns number of instructions rematerialized.
@@ -2525,6 +2549,7 @@ absl::StatusOr<InstructionsAdded> RematerializeBestBlock(
   InstructionsAdded num_instructions_added;
   num_instructions_added.remat_count = best_items.size();
   num_instructions_added.effort = effort;
+  num_instructions_added.strategy = best_strategy;
   if (best_items.empty()) {
     num_instructions_added.net_instructions_added = 0;
     return num_instructions_added;
@@ -2548,6 +2573,8 @@ absl::StatusOr<InstructionsAdded> RematerializeBestBlock(
     CHECK_EQ(best_items.size(), 1)
         << "More than one buffer offloaded simultaneously.";
     VLOG(1) << "Remat via offload: " << best_items[0]->instruction->name();
+    num_instructions_added.offloaded_bytes = memory_tracker->BytesUsedByBuffers(
+        best_items[0], /*only_count_unplaced_users=*/true);
     TF_ASSIGN_OR_RETURN(
         num_instructions_added.net_instructions_added,
         OffloadInstruction(memory_tracker, best_items[0], instruction_list));
@@ -2563,6 +2590,11 @@ absl::StatusOr<InstructionsAdded> RematerializeBestBlock(
                                absl::StrAppend(out, item->instruction->name());
                              })
             << '}';
+    for (const Item* item : best_items) {
+      num_instructions_added.recompute_seconds += std::max(
+          0.0f, memory_tracker->options().hlo_cost_analysis.optimal_seconds(
+                    *item->instruction));
+    }
     TF_ASSIGN_OR_RETURN(
         num_instructions_added.net_instructions_added,
         RematerializeInstructions(memory_tracker, &best_items,
@@ -2714,6 +2746,9 @@ absl::StatusOr<bool> HloRematerialization::RematerializeComputation(
                                    &remat_move_instructions, this));
         net_instructions_added += instructions_added.net_instructions_added;
         remat_count += instructions_added.remat_count;
+        if (instructions_added.remat_count > 0) {
+          AddToTradeoff(instructions_added, &tradeoff_);
+        }
         if (is_first_phase) {
           first_phase_effort += instructions_added.effort;
         } else {
@@ -2847,6 +2882,7 @@ absl::StatusOr<bool> HloRematerialization::Run(
   rematerialized_computations_.clear();
   instructions_rematerialized_ = 0;
   net_instructions_added_ = 0;
+  tradeoff_ = RematerializationSizes();
 
   TF_RET_CHECK(module->has_schedule());
   TF_ASSIGN_OR_RETURN(points_to_analysis_, TuplePointsToAnalysis::Run(module));
@@ -2996,6 +3032,15 @@ absl::StatusOr<bool> HloRematerialization::Run(
           << HumanReadableNumBytes(reduced_peak_memory) << " ("
           << reduced_peak_memory << " bytes)";
 
+  VLOG(1) << "Traded for an estimated " << tradeoff_.recompute_seconds
+          << "s of recomputation (" << tradeoff_.recomputed_instructions
+          << " instructions), " << tradeoff_.compressed_instructions
+          << " compressed instructions and "
+          << HumanReadableNumBytes(tradeoff_.offloaded_bytes)
+          << " offloaded to host (" << tradeoff_.offloaded_instructions
+          << " instructions)";
+
+  sizes_ = tradeoff_;
   sizes_.before_bytes = before_peak_memory;
   sizes_.after_bytes = current_peak_memory;
 
@@ -53,6 +53,15 @@ class HloRematerialization : public HloModulePass {
   struct RematerializationSizes {
     int64_t before_bytes = -1;
     int64_t after_bytes = -1;
+
+    // The compute and transfers traded for the memory reduction: the number of
+    // instructions rematerialized by each strategy, the time to recompute them
+    // estimated by the cost analysis, and the bytes offloaded to the host.
+    int64_t recomputed_instructions = 0;
+    int64_t compressed_instructions = 0;
+    int64_t offloaded_instructions = 0;
+    double recompute_seconds = 0.0;
+    int64_t offloaded_bytes = 0;
   };
 
   // Mode in which the rematerialization algorithm should be run.
@@ -226,6 +235,9 @@ class HloRematerialization : public HloModulePass {
   // Count of the total instructions rematerialized.
   int64_t instructions_rematerialized_ = 0;
 
+  // The rematerializations by strategy, reported in sizes_ after the pass.
+  RematerializationSizes tradeoff_;
+
   // Count of the net instructions added to the HLO module by
   // rematerialization. This can be different than instructions_rematerialized_
   // because some rematerializations are effectively moves in the HLO
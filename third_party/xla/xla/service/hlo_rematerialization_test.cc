@@ -164,8 +164,7 @@ class RecomputeAndCompressHloRematerializationTest
         min_remat_size, /*compact_shape_function=*/nullptr,
         /*host_memory_offload_config=*/std::nullopt,
         /*async_threads=*/{});
-    HloRematerialization::RematerializationSizes sizes;
-    HloRematerialization remat(options, sizes);
+    HloRematerialization remat(options, sizes_);
     absl::StatusOr<bool> result = remat.Run(module);
 
     // Finally, get a set of instruction names after running remat.
@@ -197,6 +196,9 @@ class RecomputeAndCompressHloRematerializationTest
     }
   }
 
+  // The sizes reported by the last run of the pass.
+  HloRematerialization::RematerializationSizes sizes_;
+
  private:
   absl::flat_hash_set<absl::string_view> before_computation_names_;
   absl::flat_hash_set<absl::string_view> before_instruction_names_;
@@ -243,6 +245,13 @@ TEST_F(RecomputeAndCompressHloRematerializationTest, SingleComputation) {
             remat_bcast);
   CheckForRematInInstructionNames(
       ::testing::UnitTest::GetInstance()->current_test_info()->name());
+
+  // The pass reports the memory saved and what was traded for it.
+  EXPECT_LT(sizes_.after_bytes, sizes_.before_bytes);
+  EXPECT_EQ(sizes_.recomputed_instructions, 1);
+  EXPECT_EQ(sizes_.compressed_instructions, 0);
+  EXPECT_EQ(sizes_.offloaded_instructions, 0);
+  EXPECT_EQ(sizes_.offloaded_bytes, 0);
 }
 
 // Test rematerialization of a single computation that contains nodes that
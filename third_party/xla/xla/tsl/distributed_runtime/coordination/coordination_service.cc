@@ -162,7 +162,7 @@ class CoordinationServiceStandaloneImpl : public CoordinationServiceInterface {
   // Starts a thread to check staleness.
   void StartCheckStaleness();
   void Stop(bool shut_staleness_thread = true);
-  bool ServiceHasStopped() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(state_mu_);
+  bool ServiceHasStopped() const ABSL_SHARED_LOCKS_REQUIRED(state_mu_);
   // Report service error to a specified task.
   void ReportServiceErrorToTaskAsync(const CoordinatedTask& destination_task,
                                      absl::Status error);
@@ -898,7 +898,10 @@ absl::Status CoordinationServiceStandaloneImpl::RecordHeartbeat(
   const std::string task_name = GetTaskName(task);
   absl::Status s = absl::OkStatus();
   {
-    absl::MutexLock l(&state_mu_);
+    // Heartbeats only read the cluster state, and the time of the last
+    // heartbeat is guarded by the task state, so that the heartbeats of
+    // different tasks do not serialize on the service in large jobs.
+    absl::ReaderMutexLock l(&state_mu_);
     if (ServiceHasStopped()) {
       return MakeCoordinationError(absl::InternalError(absl::StrCat(
           "Coordination service has stopped. RecordHeartbeat() from task: ",
@@ -907,14 +910,17 @@ absl::Status CoordinationServiceStandaloneImpl::RecordHeartbeat(
           "coordination service to shut down before the workers disconnect "
           "gracefully. Check the task leader's logs for an earlier error to "
           "debug the root cause.")));
-    } else if (!cluster_state_.contains(task_name)) {
+    }
+    auto it = cluster_state_.find(task_name);
+    if (it == cluster_state_.end()) {
       return MakeCoordinationError(absl::InvalidArgumentError(
           absl::StrCat("Unexpected heartbeat request from task: ", task_name,
                        ". This usually implies a configuration error.")));
     }
-    if (!cluster_state_[task_name]->GetStatus().ok()) {
-      return cluster_state_[task_name]->GetStatus();
-    } else if (cluster_state_[task_name]->IsDisconnectedBeyondGracePeriod()) {
+    TaskState* task_state = it->second.get();
+    if (!task_state->GetStatus().ok()) {
+      return task_state->GetStatus();
+    } else if (task_state->IsDisconnectedBeyondGracePeriod()) {
       // We accept heartbeats for a short grace period to account for the lag
       // time between the service recording the state change and the agent
       // stopping heartbeats.
@@ -924,7 +930,7 @@ absl::Status CoordinationServiceStandaloneImpl::RecordHeartbeat(
     }
     VLOG(10) << "Record heartbeat from task: " << task_name
              << "at incarnation: " << incarnation << "at " << absl::Now();
-    s = cluster_state_[task_name]->RecordHeartbeat(incarnation);
+    s = task_state->RecordHeartbeat(incarnation);
   }
 
   // Set and propagate any heartbeat errors.
@@ -1255,12 +1261,12 @@ bool CoordinationServiceStandaloneImpl::ValidateBarrierArgs(
   // Check if caller task is participating in the barrier. If not, update
   // `barriers_` to cause subsequent calls from the same task and other tasks
   // that have already called this instance of the barrier to fail.
-  const std::string source_task_name = GetTaskName(task);
-
+  // Every task calls each barrier with the list of participating tasks, so
+  // the list is searched without building the name of each task.
   bool among_participating_tasks =
       std::find_if(participating_tasks.begin(), participating_tasks.end(),
-                   [&](const CoordinatedTask& task) {
-                     return GetTaskName(task) == source_task_name;
+                   [&](const CoordinatedTask& participating_task) {
+                     return CoordinatedTaskEqual()(participating_task, task);
                    }) != participating_tasks.end();
 
   if (!participating_tasks.empty() && !among_participating_tasks) {
@@ -70,14 +70,13 @@ auto* reached_sync_point_metric = monitoring::Gauge<bool, 0>::New(
     "Records that sync point is reached.");
 
 // Only start protocol if death time is within `kProtocolDuration`, so that we
-// don't synchronize too early.
-// TODO(b/230630494): Make this configurable so that users can extend this to
-// accommodate higher checkpoint durations.
+// don't synchronize too early, unless configured otherwise.
 constexpr absl::Duration kProtocolDuration = absl::Minutes(15);
 
 class PreemptionSyncManagerImpl : public PreemptionSyncManager {
  public:
-  PreemptionSyncManagerImpl() = default;
+  explicit PreemptionSyncManagerImpl(absl::Duration protocol_duration)
+      : protocol_duration_(protocol_duration) {}
   ~PreemptionSyncManagerImpl() override {
     shutdown_.Notify();
   }
@@ -96,6 +95,7 @@ class PreemptionSyncManagerImpl : public PreemptionSyncManager {
   // midway.
   void CancelPreemptionBarrier();
 
+  const absl::Duration protocol_duration_;
   absl::Mutex mu_;
   // Tracks the last step_counter passed into ReachedSyncPoint();
   int64_t call_counter_ ABSL_GUARDED_BY(mu_) = 0;
@@ -220,11 +220,11 @@ absl::Status PreemptionSyncManagerImpl::Initialize(
 
 void PreemptionSyncManagerImpl::ComputeSyncCallCounter(absl::Time death_time) {
   // 1. If death time is in the distant future, sleep until there's
-  // `kProtocolDuration` left until death time before we begin the protocol.
+  // `protocol_duration_` left until death time before we begin the protocol.
   const absl::Duration remaining_time = death_time - absl::Now();
-  if (remaining_time > kProtocolDuration) {
+  if (remaining_time > protocol_duration_) {
     LOG(INFO) << "Will begin preemption sync protocol in " << remaining_time;
-    const absl::Duration sleep_time = remaining_time - kProtocolDuration;
+    const absl::Duration sleep_time = remaining_time - protocol_duration_;
 
     if (shutdown_.WaitForNotificationWithTimeout(sleep_time)) {
       // If shutdown is triggered midway, exit thread immediately.
@@ -327,6 +327,11 @@ bool PreemptionSyncManagerImpl::ReachedSyncPoint(int step_counter) {
 }
 }  // namespace
 std::unique_ptr<PreemptionSyncManager> CreatePreemptionSyncManager() {
-  return std::make_unique<PreemptionSyncManagerImpl>();
+  return CreatePreemptionSyncManager(kProtocolDuration);
+}
+
+std::unique_ptr<PreemptionSyncManager> CreatePreemptionSyncManager(
+    absl::Duration protocol_duration) {
+  return std::make_unique<PreemptionSyncManagerImpl>(protocol_duration);
 }
 }  // namespace tsl
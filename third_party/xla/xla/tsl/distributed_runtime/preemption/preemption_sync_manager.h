@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/time/time.h"
 #include "xla/tsl/distributed_runtime/coordination/coordination_service_agent.h"
 #include "xla/tsl/distributed_runtime/preemption/preemption_notifier.h"
 
@@ -62,6 +63,14 @@ class PreemptionSyncManager {
 
 std::unique_ptr<PreemptionSyncManager> CreatePreemptionSyncManager();
 
+// Same as above, but the sync point is only computed once the death time is
+// within `protocol_duration` (15 minutes by default). Jobs whose preemption
+// handling is faster than a remote checkpoint, e.g. saving to local or peer
+// memory, can use a shorter duration to keep training closer to the death
+// time, and jobs with slow saves a longer one.
+std::unique_ptr<PreemptionSyncManager> CreatePreemptionSyncManager(
+    absl::Duration protocol_duration);
+
 }  // namespace tsl
 
 #endif  // XLA_TSL_DISTRIBUTED_RUNTIME_PREEMPTION_PREEMPTION_SYNC_MANAGER_H_
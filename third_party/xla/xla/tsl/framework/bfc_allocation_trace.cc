@@ -0,0 +1,221 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/framework/bfc_allocation_trace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "tsl/platform/coding.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
+#include "tsl/platform/logging.h"
+
+namespace tsl {
+namespace {
+
+constexpr absl::string_view kMagic = "BFCTRACE";
+constexpr uint32_t kVersion = 1;
+
+absl::Status Truncated() {
+  return absl::DataLossError("Truncated BFC allocation trace");
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<BFCAllocationTraceWriter>>
+BFCAllocationTraceWriter::Create(Env* env, const std::string& filename) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(filename, &file));
+  auto writer =
+      absl::WrapUnique(new BFCAllocationTraceWriter(std::move(file)));
+  writer->buffer_.append(kMagic.data(), kMagic.size());
+  core::PutVarint32(&writer->buffer_, kVersion);
+  TF_RETURN_IF_ERROR(writer->Flush());
+  return writer;
+}
+
+BFCAllocationTraceWriter::BFCAllocationTraceWriter(
+    std::unique_ptr<WritableFile> file)
+    : file_(std::move(file)) {}
+
+BFCAllocationTraceWriter::~BFCAllocationTraceWriter() {
+  absl::Status s = Flush();
+  if (s.ok()) {
+    s = file_->Close();
+  }
+  if (!s.ok()) {
+    LOG(ERROR) << "Failed to write BFC allocation trace: " << s;
+  }
+}
+
+void BFCAllocationTraceWriter::RecordAllocation(uint64_t now_micros,
+                                                const void* ptr,
+                                                size_t requested_bytes,
+                                                size_t allocated_bytes,
+                                                const char* op_name) {
+  // Written first, since it may append a kOpName record.
+  const uint64_t op_name_id = OpNameId(op_name);
+  buffer_.push_back(BFCAllocationTraceEvent::kAllocation);
+  AppendMicros(now_micros);
+  core::PutVarint64(&buffer_, reinterpret_cast<uintptr_t>(ptr));
+  core::PutVarint64(&buffer_, requested_bytes);
+  core::PutVarint64(&buffer_, allocated_bytes);
+  core::PutVarint64(&buffer_, op_name_id);
+  MaybeFlush();
+}
+
+void BFCAllocationTraceWriter::RecordDeallocation(uint64_t now_micros,
+                                                  const void* ptr) {
+  buffer_.push_back(BFCAllocationTraceEvent::kDeallocation);
+  AppendMicros(now_micros);
+  core::PutVarint64(&buffer_, reinterpret_cast<uintptr_t>(ptr));
+  MaybeFlush();
+}
+
+absl::Status BFCAllocationTraceWriter::Flush() {
+  if (status_.ok() && !buffer_.empty()) {
+    status_ = file_->Append(buffer_);
+    if (status_.ok()) {
+      status_ = file_->Flush();
+    }
+  }
+  buffer_.clear();
+  return status_;
+}
+
+void BFCAllocationTraceWriter::AppendMicros(uint64_t now_micros) {
+  if (!has_events_) {
+    has_events_ = true;
+    last_micros_ = now_micros;
+  }
+  // The clock is not guaranteed to be monotonic.
+  const uint64_t delta =
+      now_micros > last_micros_ ? now_micros - last_micros_ : 0;
+  last_micros_ += delta;
+  core::PutVarint64(&buffer_, delta);
+}
+
+uint64_t BFCAllocationTraceWriter::OpNameId(const char* op_name) {
+  if (op_name == nullptr) {
+    return 0;
+  }
+  auto it = op_name_ids_.find(absl::string_view(op_name));
+  if (it != op_name_ids_.end()) {
+    return it->second;
+  }
+  const uint64_t id = op_name_ids_.size() + 1;
+  const absl::string_view name(op_name);
+  op_name_ids_.emplace(name, id);
+  buffer_.push_back(BFCAllocationTraceEvent::kOpName);
+  core::PutVarint64(&buffer_, id);
+  core::PutVarint32(&buffer_, name.size());
+  buffer_.append(name.data(), name.size());
+  return id;
+}
+
+void BFCAllocationTraceWriter::MaybeFlush() {
+  if (buffer_.size() >= kFlushThresholdBytes) {
+    Flush().IgnoreError();
+  }
+}
+
+absl::StatusOr<std::unique_ptr<BFCAllocationTraceReader>>
+BFCAllocationTraceReader::Open(Env* env, const std::string& filename) {
+  std::string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(env, filename, &contents));
+  return FromString(std::move(contents));
+}
+
+absl::StatusOr<std::unique_ptr<BFCAllocationTraceReader>>
+BFCAllocationTraceReader::FromString(std::string contents) {
+  auto reader =
+      absl::WrapUnique(new BFCAllocationTraceReader(std::move(contents)));
+  absl::string_view& input = reader->input_;
+  if (!absl::ConsumePrefix(&input, kMagic)) {
+    return absl::InvalidArgumentError("Not a BFC allocation trace");
+  }
+  uint32_t version;
+  if (!core::GetVarint32(&input, &version)) {
+    return Truncated();
+  }
+  if (version != kVersion) {
+    return absl::UnimplementedError(
+        absl::StrCat("Unsupported BFC allocation trace version ", version));
+  }
+  return reader;
+}
+
+BFCAllocationTraceReader::BFCAllocationTraceReader(std::string contents)
+    : contents_(std::move(contents)), input_(contents_) {}
+
+absl::StatusOr<bool> BFCAllocationTraceReader::Next(
+    BFCAllocationTraceEvent* event) {
+  while (!input_.empty()) {
+    const auto type = static_cast<BFCAllocationTraceEvent::Type>(input_[0]);
+    input_.remove_prefix(1);
+    if (type == BFCAllocationTraceEvent::kOpName) {
+      uint64_t id;
+      uint32_t length;
+      if (!core::GetVarint64(&input_, &id) ||
+          !core::GetVarint32(&input_, &length) || input_.size() < length) {
+        return Truncated();
+      }
+      op_names_[id] = std::string(input_.substr(0, length));
+      input_.remove_prefix(length);
+      continue;
+    }
+    if (type != BFCAllocationTraceEvent::kAllocation &&
+        type != BFCAllocationTraceEvent::kDeallocation) {
+      return absl::DataLossError(absl::StrCat(
+          "Unknown BFC allocation trace record type ", static_cast<int>(type)));
+    }
+
+    *event = BFCAllocationTraceEvent();
+    event->type = type;
+    uint64_t delta;
+    if (!core::GetVarint64(&input_, &delta) ||
+        !core::GetVarint64(&input_, &event->address)) {
+      return Truncated();
+    }
+    micros_ += delta;
+    event->micros = micros_;
+    if (type == BFCAllocationTraceEvent::kAllocation &&
+        (!core::GetVarint64(&input_, &event->requested_bytes) ||
+         !core::GetVarint64(&input_, &event->allocated_bytes) ||
+         !core::GetVarint64(&input_, &event->op_name_id))) {
+      return Truncated();
+    }
+    return true;
+  }
+  return false;
+}
+
+absl::string_view BFCAllocationTraceReader::OpName(uint64_t op_name_id) const {
+  auto it = op_names_.find(op_name_id);
+  return it == op_names_.end() ? absl::string_view() : it->second;
+}
+
+}  // namespace tsl
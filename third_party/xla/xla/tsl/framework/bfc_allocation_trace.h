@@ -0,0 +1,132 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_FRAMEWORK_BFC_ALLOCATION_TRACE_H_
+#define XLA_TSL_FRAMEWORK_BFC_ALLOCATION_TRACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/file_system.h"
+
+namespace tsl {
+
+// A compact binary trace of every allocation and deallocation made by a
+// BFCAllocator, which can be replayed offline against other allocator
+// configurations (see bfc_allocator_replay.h).
+//
+// The file starts with the magic string "BFCTRACE" and a varint32 format
+// version, followed by records that each start with a one-byte type:
+//
+//   kOpName:       varint64 id, varint32 length, name bytes.
+//                  Defines an op name before the first event that uses it.
+//   kAllocation:   varint64 micros since the previous event, varint64 address,
+//                  varint64 requested bytes, varint64 allocated bytes,
+//                  varint64 op name id (0 if unknown).
+//   kDeallocation: varint64 micros since the previous event, varint64 address.
+struct BFCAllocationTraceEvent {
+  enum Type : uint8_t {
+    kOpName = 1,
+    kAllocation = 2,
+    kDeallocation = 3,
+  };
+
+  Type type = kAllocation;
+  // Microseconds since the first event of the trace.
+  uint64_t micros = 0;
+  uint64_t address = 0;
+  // Only set for allocations.
+  uint64_t requested_bytes = 0;
+  uint64_t allocated_bytes = 0;
+  uint64_t op_name_id = 0;
+};
+
+// Writes a trace to a file. Not thread-safe; the BFCAllocator calls it while
+// holding its lock.
+class BFCAllocationTraceWriter {
+ public:
+  static constexpr size_t kFlushThresholdBytes = 1 << 20;
+
+  // Creates (or truncates) `filename` and writes the trace header.
+  static absl::StatusOr<std::unique_ptr<BFCAllocationTraceWriter>> Create(
+      Env* env, const std::string& filename);
+
+  // Flushes and closes the file, logging any error.
+  ~BFCAllocationTraceWriter();
+
+  void RecordAllocation(uint64_t now_micros, const void* ptr,
+                        size_t requested_bytes, size_t allocated_bytes,
+                        const char* op_name);
+  void RecordDeallocation(uint64_t now_micros, const void* ptr);
+
+  // Writes all buffered events to the file. Returns the first error that
+  // occurred while writing; once an error has occurred, no more events are
+  // written.
+  absl::Status Flush();
+
+ private:
+  explicit BFCAllocationTraceWriter(std::unique_ptr<WritableFile> file);
+
+  // Appends the delta to the previous event's timestamp.
+  void AppendMicros(uint64_t now_micros);
+  uint64_t OpNameId(const char* op_name);
+  void MaybeFlush();
+
+  std::unique_ptr<WritableFile> file_;
+  absl::Status status_;
+  std::string buffer_;
+  uint64_t last_micros_ = 0;
+  bool has_events_ = false;
+  absl::flat_hash_map<std::string, uint64_t> op_name_ids_;
+};
+
+// Reads a trace written by BFCAllocationTraceWriter. kOpName records are
+// consumed by the reader, and never returned from Next().
+class BFCAllocationTraceReader {
+ public:
+  static absl::StatusOr<std::unique_ptr<BFCAllocationTraceReader>> Open(
+      Env* env, const std::string& filename);
+
+  // Creates a reader for the contents of a trace file.
+  static absl::StatusOr<std::unique_ptr<BFCAllocationTraceReader>>
+  FromString(std::string contents);
+
+  // Reads the next allocation or deallocation into `event`. Returns false at
+  // the end of the trace.
+  absl::StatusOr<bool> Next(BFCAllocationTraceEvent* event);
+
+  // Returns the name of the op with the given id, or "" if it is unknown.
+  absl::string_view OpName(uint64_t op_name_id) const;
+
+ private:
+  explicit BFCAllocationTraceReader(std::string contents);
+
+  std::string contents_;
+  absl::string_view input_;
+  uint64_t micros_ = 0;
+  absl::flat_hash_map<uint64_t, std::string> op_names_;
+};
+
+}  // namespace tsl
+
+#endif  // XLA_TSL_FRAMEWORK_BFC_ALLOCATION_TRACE_H_
@@ -49,6 +49,18 @@ namespace tsl {
 
 constexpr BFCAllocator::ChunkHandle BFCAllocator::kInvalidChunkHandle;
 
+namespace {
+
+// Returns a small dense id for the calling thread.
+int CurrentThreadId() {
+  static std::atomic<int> next_thread_id{0};
+  thread_local int thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id;
+}
+
+}  // namespace
+
 BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
                            size_t total_memory, const string& name,
                            const Options& opts)
@@ -94,6 +106,28 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       CHECK_NE(BinForSize(bin_size * 2), BinFromIndex(b));
     }
   }
+
+  if (opts.thread_cache_max_chunk_size > 0) {
+    VLOG(1) << "Caching freed chunks of up to "
+            << strings::HumanReadableNumBytes(opts.thread_cache_max_chunk_size)
+            << " per thread";
+    thread_caches_ = std::make_unique<ThreadCache[]>(kNumThreadCaches);
+  }
+
+  if (!opts.allocation_trace_file.empty()) {
+    absl::StatusOr<std::unique_ptr<BFCAllocationTraceWriter>> writer =
+        BFCAllocationTraceWriter::Create(Env::Default(),
+                                         opts.allocation_trace_file);
+    if (writer.ok()) {
+      LOG(INFO) << "Recording allocations of " << name << " to "
+                << opts.allocation_trace_file;
+      absl::MutexLock l(&mutex_);
+      allocation_trace_ = *std::move(writer);
+    } else {
+      LOG(ERROR) << "Not recording allocations of " << name << ": "
+                 << writer.status();
+    }
+  }
 }
 
 BFCAllocator::~BFCAllocator() {
@@ -442,7 +476,18 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
+  // Cached chunks were freed without a timestamp, so they satisfy any
+  // freed_before requirement.
+  if (thread_caches_ != nullptr &&
+      rounded_bytes <= opts_.thread_cache_max_chunk_size) {
+    void* ptr = AllocateFromThreadCache(bin_num, rounded_bytes, num_bytes);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   absl::MutexLock l(&mutex_);
+  RecordPendingAllocations();
   if (!timestamped_chunks_.empty()) {
     // Merge timestamped chunks whose counts have become safe for general use.
     MergeTimestampedChunks(0);
@@ -453,6 +498,17 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     return ptr;
   }
 
+  // Return the chunks held in thread caches to the bins before growing the
+  // pool, so that caching never makes the allocator use more memory, or fail
+  // an allocation that it could otherwise satisfy.
+  if (FlushThreadCaches()) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      AddTraceMe("MemoryAllocation", ptr);
+      return ptr;
+    }
+  }
+
   // Try to extend
   if (Extend(unused_alignment, rounded_bytes)) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
@@ -586,18 +642,7 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         // it from the free bin structure prior to using.
         RemoveFreeChunkIterFromBin(&b->free_chunks, citer);
 
-        // If we can break the size of the chunk into two reasonably large
-        // pieces, do don't waste more than max_internal_fragmentation_bytes on
-        // padding. If this threshold is not set by the user, then use 128MB as
-        // the default.
-        const int64_t max_internal_fragmentation_bytes =
-            (opts_.fragmentation_fraction > 0.0)
-                ? opts_.fragmentation_fraction * memory_limit_
-                : 128 << 20;
-
-        if (chunk->size >= rounded_bytes * 2 ||
-            static_cast<int64_t>(chunk->size) - rounded_bytes >=
-                max_internal_fragmentation_bytes) {
+        if (ShouldSplitChunk(chunk->size, rounded_bytes)) {
           SplitChunk(h, rounded_bytes);
           chunk = ChunkFromHandle(h);  // Update chunk pointer in case it moved
         }
@@ -609,38 +654,10 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         // chunk as being in use.
         chunk->allocation_id = next_allocation_id_++;
 
-        // Update stats.
-        ++stats_.num_allocs;
-        stats_.bytes_in_use += chunk->size;
-        if (stats_.bytes_in_use > stats_.peak_bytes_in_use) {
-          VLOG(2) << "New Peak memory usage of " << stats_.bytes_in_use
-                  << " bytes for " << Name();
-        }
-        stats_.peak_bytes_in_use =
-            std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
-        stats_.largest_alloc_size =
-            std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
-
-#ifdef TENSORFLOW_MEM_DEBUG
-        if (ShouldRecordOpName()) {
-          const auto& annotation =
-              profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation();
-          if (annotation.pending_op_name != nullptr) {
-            chunk->op_name = annotation.pending_op_name;
-          } else {
-            LOG(INFO) << "missing pending_op_name for " << Name()
-                      << " reading addr "
-                      << static_cast<const void*>(&annotation.pending_op_name)
-                      << "\n"
-                      << CurrentStackTrace();
-            chunk->op_name = nullptr;
-          }
-          chunk->action_count = ++action_counter_;
-          chunk->step_id = annotation.pending_step_id;
-          int slot = chunk->action_count % MEM_DEBUG_SIZE_HISTORY_SIZE;
-          size_history_[slot] = stats_.bytes_in_use;
-        }
-#endif
+        const char* op_name =
+            profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation()
+                .pending_op_name;
+        RecordAllocation(chunk, op_name);
 
         VLOG(4) << "Returning: " << chunk->ptr;
         if (VLOG_IS_ON(4)) {
@@ -654,6 +671,228 @@ void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
   return nullptr;
 }
 
+bool BFCAllocator::ShouldSplitChunk(size_t chunk_size,
+                                    size_t rounded_bytes) const {
+  // If we can break the size of the chunk into two reasonably large
+  // pieces, do don't waste more than max_internal_fragmentation_bytes on
+  // padding. If this threshold is not set by the user, then use 128MB as
+  // the default.
+  const int64_t max_internal_fragmentation_bytes =
+      (opts_.fragmentation_fraction > 0.0)
+          ? opts_.fragmentation_fraction * memory_limit_
+          : 128 << 20;
+
+  return chunk_size >= rounded_bytes * 2 ||
+         static_cast<int64_t>(chunk_size) - rounded_bytes >=
+             max_internal_fragmentation_bytes;
+}
+
+void BFCAllocator::RecordAllocation(Chunk* chunk, const char* op_name) {
+  // Update stats.
+  ++stats_.num_allocs;
+  stats_.bytes_in_use += chunk->size;
+  if (stats_.bytes_in_use > stats_.peak_bytes_in_use) {
+    VLOG(2) << "New Peak memory usage of " << stats_.bytes_in_use
+            << " bytes for " << Name();
+  }
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.largest_alloc_size =
+      std::max<std::size_t>(stats_.largest_alloc_size, chunk->size);
+
+#ifdef TENSORFLOW_MEM_DEBUG
+  if (ShouldRecordOpName()) {
+    const auto& annotation =
+        profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation();
+    if (annotation.pending_op_name != nullptr) {
+      chunk->op_name = annotation.pending_op_name;
+    } else {
+      LOG(INFO) << "missing pending_op_name for " << Name()
+                << " reading addr "
+                << static_cast<const void*>(&annotation.pending_op_name)
+                << "\n"
+                << CurrentStackTrace();
+      chunk->op_name = nullptr;
+    }
+    chunk->action_count = ++action_counter_;
+    chunk->step_id = annotation.pending_step_id;
+    int slot = chunk->action_count % MEM_DEBUG_SIZE_HISTORY_SIZE;
+    size_history_[slot] = stats_.bytes_in_use;
+  }
+#endif
+
+  if (allocation_trace_ != nullptr) {
+    allocation_trace_->RecordAllocation(Env::Default()->NowMicros(),
+                                        chunk->ptr, chunk->requested_size,
+                                        chunk->size, op_name);
+  }
+}
+
+BFCAllocator::ThreadCache& BFCAllocator::CurrentThreadCache() {
+  return thread_caches_[CurrentThreadId() % kNumThreadCaches];
+}
+
+void* BFCAllocator::AllocateFromThreadCache(BinNum bin_num,
+                                            size_t rounded_bytes,
+                                            size_t num_bytes) {
+  if (num_cached_chunks_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  ThreadCache& cache = CurrentThreadCache();
+  void* ptr = nullptr;
+  bool record_pending_allocations = false;
+  {
+    absl::MutexLock l(&cache.mu);
+    std::vector<CachedChunk>& chunks = cache.free_chunks[bin_num];
+    // Prefer the most recently freed chunk, which is most likely to still be
+    // in the caches of the device.
+    for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+      // Cached chunks are never split, so only use one that FindChunkPtr
+      // would have returned whole.
+      if (it->size < rounded_bytes ||
+          ShouldSplitChunk(it->size, rounded_bytes)) {
+        continue;
+      }
+      CachedChunk allocation = *it;
+      chunks.erase(std::next(it).base());
+      allocation.requested_size = num_bytes;
+      if (!opts_.allocation_trace_file.empty()) {
+        // The op may be gone by the time the allocation is recorded.
+        const char* op_name =
+            profiler::ScopedMemoryDebugAnnotation::CurrentAnnotation()
+                .pending_op_name;
+        if (op_name != nullptr) {
+          allocation.op_name = op_name;
+        }
+      }
+      ptr = allocation.ptr;
+      cache.pending_allocations.push_back(allocation);
+      num_cached_chunks_.fetch_sub(1, std::memory_order_relaxed);
+      num_pending_allocations_.fetch_add(1, std::memory_order_relaxed);
+      record_pending_allocations =
+          cache.pending_allocations.size() >= kMaxPendingAllocations;
+      break;
+    }
+  }
+  if (record_pending_allocations) {
+    absl::MutexLock l(&mutex_);
+    RecordPendingAllocations();
+  }
+  return ptr;
+}
+
+bool BFCAllocator::InsertFreeChunkIntoThreadCache(ChunkHandle h) {
+  if (thread_caches_ == nullptr) {
+    return false;
+  }
+  Chunk* c = ChunkFromHandle(h);
+  CHECK(!c->in_use() && (c->bin_num == kInvalidBinNum));
+  if (c->size > opts_.thread_cache_max_chunk_size) {
+    return false;
+  }
+  c->allocation_id = kCachedAllocationId;
+  CachedChunk cached;
+  cached.h = h;
+  cached.ptr = c->ptr;
+  cached.size = c->size;
+  cached.allocation_id = next_allocation_id_++;
+
+  std::vector<CachedChunk> flushed;
+  {
+    ThreadCache& cache = CurrentThreadCache();
+    absl::MutexLock l(&cache.mu);
+    std::vector<CachedChunk>& chunks =
+        cache.free_chunks[BinNumForSize(c->size)];
+    if (chunks.size() >= kMaxCachedChunksPerBin) {
+      auto end = chunks.begin() + kMaxCachedChunksPerBin / 2;
+      flushed.assign(chunks.begin(), end);
+      chunks.erase(chunks.begin(), end);
+    }
+    chunks.push_back(cached);
+    num_cached_chunks_.fetch_add(1 - static_cast<int64_t>(flushed.size()),
+                                 std::memory_order_relaxed);
+  }
+  for (const CachedChunk& f : flushed) {
+    ReturnCachedChunkToBin(f.h);
+  }
+  return true;
+}
+
+void BFCAllocator::ReturnCachedChunkToBin(ChunkHandle h) {
+  Chunk* c = ChunkFromHandle(h);
+  CHECK(c->cached() && (c->bin_num == kInvalidBinNum));
+  c->allocation_id = -1;
+  InsertFreeChunkIntoBin(TryToCoalesce(h, false));
+}
+
+bool BFCAllocator::FlushThreadCaches() {
+  if (thread_caches_ == nullptr ||
+      num_cached_chunks_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  std::vector<ChunkHandle> flushed;
+  for (int i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    absl::MutexLock l(&cache.mu);
+    int64_t num_flushed = 0;
+    for (std::vector<CachedChunk>& chunks : cache.free_chunks) {
+      for (const CachedChunk& f : chunks) {
+        flushed.push_back(f.h);
+      }
+      num_flushed += chunks.size();
+      chunks.clear();
+    }
+    num_cached_chunks_.fetch_sub(num_flushed, std::memory_order_relaxed);
+  }
+  VLOG(2) << "Flushed " << flushed.size() << " chunks from thread caches";
+  for (ChunkHandle h : flushed) {
+    ReturnCachedChunkToBin(h);
+  }
+  return !flushed.empty();
+}
+
+void BFCAllocator::RecordPendingAllocations() {
+  if (thread_caches_ == nullptr ||
+      num_pending_allocations_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::vector<CachedChunk> pending;
+  for (int i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    {
+      absl::MutexLock l(&cache.mu);
+      pending.swap(cache.pending_allocations);
+      num_pending_allocations_.fetch_sub(pending.size(),
+                                         std::memory_order_relaxed);
+    }
+    for (const CachedChunk& allocation : pending) {
+      Chunk* chunk = ChunkFromHandle(allocation.h);
+      CHECK(chunk->cached() && (chunk->bin_num == kInvalidBinNum));
+      chunk->requested_size = allocation.requested_size;
+      chunk->allocation_id = allocation.allocation_id;
+      RecordAllocation(chunk, allocation.op_name.empty()
+                                  ? nullptr
+                                  : allocation.op_name.c_str());
+      AddTraceMe("MemoryAllocation", chunk->ptr);
+    }
+    pending.clear();
+  }
+}
+
+std::optional<BFCAllocator::CachedChunk> BFCAllocator::FindPendingAllocation(
+    ChunkHandle h) const {
+  for (int i = 0; i < kNumThreadCaches; ++i) {
+    ThreadCache& cache = thread_caches_[i];
+    absl::MutexLock l(&cache.mu);
+    for (const CachedChunk& allocation : cache.pending_allocations) {
+      if (allocation.h == h) {
+        return allocation;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
 void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
   // Allocate the new chunk before we do any ChunkFromHandle
   ChunkHandle h_new_chunk = AllocateChunk();
@@ -708,6 +947,8 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
     return;
   }
   absl::MutexLock l(&mutex_);
+  // The chunk may have been handed out from a thread cache.
+  RecordPendingAllocations();
 
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
@@ -724,7 +965,7 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   if (timing_counter_) {
     InsertFreeChunkIntoBin(h);
     timestamped_chunks_.push_back(h);
-  } else {
+  } else if (!InsertFreeChunkIntoThreadCache(h)) {
     InsertFreeChunkIntoBin(TryToCoalesce(h, false));
   }
 
@@ -808,7 +1049,7 @@ void BFCAllocator::RemoveFreeChunkFromBin(BFCAllocator::ChunkHandle h) {
 
 void BFCAllocator::MarkFree(BFCAllocator::ChunkHandle h) {
   Chunk* c = ChunkFromHandle(h);
-  CHECK(c->in_use() && (c->bin_num == kInvalidBinNum));
+  CHECK(c->in_use() && !c->cached() && (c->bin_num == kInvalidBinNum));
 
   // Mark the chunk as no longer in use.
   c->allocation_id = -1;
@@ -821,6 +1062,11 @@ void BFCAllocator::MarkFree(BFCAllocator::ChunkHandle h) {
   // Updates the stats.
   stats_.bytes_in_use -= c->size;
 
+  if (allocation_trace_ != nullptr) {
+    allocation_trace_->RecordDeallocation(Env::Default()->NowMicros(),
+                                          c->ptr);
+  }
+
 #ifdef TENSORFLOW_MEM_DEBUG
   if (ShouldRecordOpName()) {
     c->action_count = ++action_counter_;
@@ -956,6 +1202,12 @@ size_t BFCAllocator::RequestedSize(const void* ptr) const {
   CHECK(h != kInvalidChunkHandle)
       << "Asked for requested size of pointer we never allocated: " << ptr;
   const BFCAllocator::Chunk* c = ChunkFromHandle(h);
+  if (c->cached()) {
+    std::optional<CachedChunk> allocation = FindPendingAllocation(h);
+    CHECK(allocation)
+        << "Asked for requested size of pointer we never allocated: " << ptr;
+    return allocation->requested_size;
+  }
   return c->requested_size;
 }
 
@@ -974,6 +1226,12 @@ int64_t BFCAllocator::AllocationId(const void* ptr) const {
   CHECK(h != kInvalidChunkHandle)
       << "Asked for allocation id of pointer we never allocated: " << ptr;
   const BFCAllocator::Chunk* c = ChunkFromHandle(h);
+  if (c->cached()) {
+    std::optional<CachedChunk> allocation = FindPendingAllocation(h);
+    CHECK(allocation)
+        << "Asked for allocation id of pointer we never allocated: " << ptr;
+    return allocation->allocation_id;
+  }
   return c->allocation_id;
 }
 
@@ -1151,6 +1409,7 @@ void BFCAllocator::MaybeWriteMemoryMap() {
 
 MemoryDump BFCAllocator::RecordMemoryMap() {
   absl::MutexLock l(&mutex_);
+  RecordPendingAllocations();
   return RecordMemoryMapInternal();
 }
 
@@ -1222,11 +1481,13 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 std::optional<AllocatorStats> BFCAllocator::GetStats() {
   absl::MutexLock l(&mutex_);
+  RecordPendingAllocations();
   return stats_;
 }
 
 bool BFCAllocator::ClearStats() {
   absl::MutexLock l(&mutex_);
+  RecordPendingAllocations();
   stats_.num_allocs = 0;
   stats_.peak_bytes_in_use = stats_.bytes_in_use;
   stats_.largest_alloc_size = 0;
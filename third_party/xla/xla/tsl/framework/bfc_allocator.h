@@ -24,6 +24,7 @@ limitations under the License.
 #include <deque>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "xla/tsl/framework/allocator.h"
 #include "xla/tsl/framework/allocator_retry.h"
+#include "xla/tsl/framework/bfc_allocation_trace.h"
 #include "xla/tsl/framework/shared_counter.h"
 #include "xla/tsl/lib/core/bits.h"
 #include "tsl/platform/logging.h"
@@ -73,6 +75,21 @@ class BFCAllocator : public Allocator {
     // Controls when a chunk should be split, if its size exceeds the requested
     // allocation size.
     double fragmentation_fraction = 0;
+
+    // If > 0, freed chunks of at most this many bytes are kept in small
+    // per-thread caches in front of the bins, from which AllocateRaw can
+    // serve requests of the same bin without acquiring the allocator-wide
+    // lock. Cached chunks are accounted as free memory, but are not coalesced
+    // with their neighbors until they are flushed back to the bins. This
+    // happens in batches when a cache fills up, and for all caches before the
+    // allocator grows its pool or fails an allocation.
+    size_t thread_cache_max_chunk_size = 0;
+
+    // If not empty, every allocation and deallocation is recorded in a
+    // BFCAllocationTraceWriter trace at this path, which can be replayed with
+    // bfc_allocator_replay. Recording adds a buffered write to every
+    // allocation and deallocation, so it is meant for offline tuning only.
+    std::string allocation_trace_file;
   };
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
                const string& name, const Options& opts);
@@ -167,6 +184,11 @@ class BFCAllocator : public Allocator {
   // The following means that the largest bin'd chunk size is 256 << 21 = 512MB.
   static constexpr int kNumBins = 21;
 
+  // allocation_id of a chunk that is held in a thread cache. Such a chunk is
+  // free as far as the stats are concerned, but it is not in a bin, and it
+  // counts as in use for coalescing.
+  static constexpr int64_t kCachedAllocationId = -2;
+
   // A Chunk points to a piece of memory that's either entirely free or entirely
   // in use by one user memory allocation.
   //
@@ -215,6 +237,8 @@ class BFCAllocator : public Allocator {
 
     bool in_use() const { return allocation_id != -1; }
 
+    bool cached() const { return allocation_id == kCachedAllocationId; }
+
 #ifdef TENSORFLOW_MEM_DEBUG
     // optional debugging info
     const char* op_name = nullptr;
@@ -504,6 +528,80 @@ class BFCAllocator : public Allocator {
   // Removes the chunk metadata represented by 'h'.
   void DeleteChunk(ChunkHandle h) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Returns true if a free chunk of 'chunk_size' bytes should be split before
+  // it is used to serve an allocation of 'rounded_bytes' bytes.
+  bool ShouldSplitChunk(size_t chunk_size, size_t rounded_bytes) const;
+
+  // Updates the stats and the allocation trace for the newly allocated chunk
+  // 'chunk', which was requested by the op 'op_name'.
+  void RecordAllocation(Chunk* chunk, const char* op_name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Thread caches.
+  //
+  // A cached chunk is moved to its thread cache under mutex_, at which point it
+  // is already accounted as free. When AllocateRaw hands it out again, only the
+  // thread cache's own lock is held, so the allocation is appended to the
+  // cache's pending allocations and recorded in the chunk metadata and stats_
+  // by the next caller of RecordPendingAllocations(). Every operation that
+  // frees a chunk or reads the stats records the pending allocations first.
+  struct CachedChunk {
+    ChunkHandle h = kInvalidChunkHandle;
+    void* ptr = nullptr;
+    size_t size = 0;
+    // The id that the chunk gets when it is handed out from the cache. It is
+    // reserved when the chunk is cached, since next_allocation_id_ is guarded
+    // by mutex_.
+    int64_t allocation_id = 0;
+    // Only set for pending allocations.
+    size_t requested_size = 0;
+    // Only set for pending allocations while recording an allocation trace.
+    std::string op_name;
+  };
+  struct alignas(64) ThreadCache {
+    absl::Mutex mu;
+    // The cached free chunks of each bin, in the order they were freed.
+    std::array<std::vector<CachedChunk>, kNumBins> free_chunks
+        ABSL_GUARDED_BY(mu);
+    std::vector<CachedChunk> pending_allocations ABSL_GUARDED_BY(mu);
+  };
+  static constexpr int kNumThreadCaches = 16;
+  // When a bin of a thread cache holds this many chunks, its older half is
+  // flushed back to the bins.
+  static constexpr int kMaxCachedChunksPerBin = 32;
+  // When a thread cache has this many pending allocations, the allocating
+  // thread records them.
+  static constexpr int kMaxPendingAllocations = 64;
+
+  ThreadCache& CurrentThreadCache();
+
+  // Tries to serve an allocation from the current thread's cache. Does not
+  // acquire mutex_, unless the allocation makes the cache reach
+  // kMaxPendingAllocations.
+  void* AllocateFromThreadCache(BinNum bin_num, size_t rounded_bytes,
+                                size_t num_bytes)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Moves the free chunk 'h', which is in no bin, to the current thread's
+  // cache. Returns false if the chunk cannot be cached.
+  bool InsertFreeChunkIntoThreadCache(ChunkHandle h)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the cached chunk 'h' to its bin, coalescing it if possible.
+  void ReturnCachedChunkToBin(ChunkHandle h)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns all chunks held in thread caches to the bins. Returns true if any
+  // chunks were returned.
+  bool FlushThreadCaches() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Records the allocations that were served from thread caches since the last
+  // call in the chunk metadata and stats_.
+  void RecordPendingAllocations() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the pending allocation of the cached chunk 'h'.
+  std::optional<CachedChunk> FindPendingAllocation(ChunkHandle h) const;
+
   string RenderOccupancy() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void DumpMemoryLog(size_t num_bytes) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   tensorflow::MemoryDump RecordMemoryMapInternal()
@@ -579,6 +677,13 @@ class BFCAllocator : public Allocator {
 
   std::atomic<uint64> safe_frontier_ = {0};
 
+  // Null if opts_.thread_cache_max_chunk_size is 0.
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+  // The number of chunks held in, and of pending allocations of, all thread
+  // caches. Only updated while holding the lock of the modified cache.
+  std::atomic<int64_t> num_cached_chunks_ = {0};
+  std::atomic<int64_t> num_pending_allocations_ = {0};
+
   // Structures mutable after construction
   mutable absl::Mutex mutex_;
   RegionManager region_manager_ ABSL_GUARDED_BY(mutex_);
@@ -595,6 +700,10 @@ class BFCAllocator : public Allocator {
   // Stats.
   AllocatorStats stats_ ABSL_GUARDED_BY(mutex_);
 
+  // Null unless opts_.allocation_trace_file is set.
+  std::unique_ptr<BFCAllocationTraceWriter> allocation_trace_
+      ABSL_GUARDED_BY(mutex_);
+
 #ifdef TENSORFLOW_MEM_DEBUG
   int64 action_counter_ ABSL_GUARDED_BY(mutex_);
 #define MEM_DEBUG_SIZE_HISTORY_SIZE 4096
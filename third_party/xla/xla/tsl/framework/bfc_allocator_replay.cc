@@ -0,0 +1,150 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/framework/bfc_allocator_replay.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/framework/allocator.h"
+#include "xla/tsl/framework/bfc_allocation_trace.h"
+#include "xla/tsl/framework/bfc_allocator.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/numbers.h"
+#include "tsl/platform/statusor.h"
+
+namespace tsl {
+namespace {
+
+// Hands out increasing addresses without backing them by memory. The
+// BFCAllocator never touches the memory it manages, so this is enough to
+// replay a trace.
+class VirtualSubAllocator : public SubAllocator {
+ public:
+  explicit VirtualSubAllocator(bool coalesce_regions)
+      : SubAllocator({}, {}), coalesce_regions_(coalesce_regions) {}
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    next_address_ = (next_address_ + alignment - 1) / alignment * alignment;
+    void* ptr = reinterpret_cast<void*>(next_address_);
+    next_address_ += num_bytes;
+    *bytes_received = num_bytes;
+    return ptr;
+  }
+
+  void Free(void* ptr, size_t num_bytes) override {}
+
+  bool SupportsCoalescing() const override { return coalesce_regions_; }
+
+ private:
+  const bool coalesce_regions_;
+  // Never 0, so that no region starts at nullptr.
+  uintptr_t next_address_ = 1 << 20;
+};
+
+}  // namespace
+
+std::string BFCAllocatorReplayResult::DebugString() const {
+  return absl::StrCat(
+      "Allocations:            ", num_allocations, "\n",
+      "Failed allocations:     ", num_failed_allocations, "\n",
+      "Recorded peak in use:   ",
+      strings::HumanReadableNumBytes(trace_peak_bytes_in_use), "\n",
+      "Replayed peak in use:   ",
+      strings::HumanReadableNumBytes(peak_bytes_in_use), "\n",
+      "Replayed peak pool:     ",
+      strings::HumanReadableNumBytes(peak_pool_bytes), "\n");
+}
+
+absl::StatusOr<BFCAllocatorReplayResult> ReplayBFCAllocationTrace(
+    BFCAllocationTraceReader* reader, const BFCAllocatorReplayConfig& config) {
+  BFCAllocator::Options options = config.options;
+  // Allocation failures are expected when exploring smaller memory limits, so
+  // fail them immediately and quietly.
+  options.allow_retry_on_failure = false;
+  options.allocation_trace_file.clear();
+  BFCAllocator allocator(
+      std::make_unique<VirtualSubAllocator>(config.coalesce_regions),
+      config.memory_limit, "bfc_replay", options);
+  AllocationAttributes attr;
+  attr.retry_on_failure = false;
+
+  struct LiveAllocation {
+    // Null if the replayed allocation failed.
+    void* ptr;
+    uint64_t recorded_bytes;
+  };
+  BFCAllocatorReplayResult result;
+  // Keyed by the recorded address.
+  absl::flat_hash_map<uint64_t, LiveAllocation> live_allocations;
+  int64_t trace_bytes_in_use = 0;
+  BFCAllocationTraceEvent event;
+  while (true) {
+    TF_ASSIGN_OR_RETURN(bool has_event, reader->Next(&event));
+    if (!has_event) {
+      break;
+    }
+    if (event.type == BFCAllocationTraceEvent::kAllocation) {
+      ++result.num_allocations;
+      trace_bytes_in_use += event.allocated_bytes;
+      result.trace_peak_bytes_in_use =
+          std::max(result.trace_peak_bytes_in_use, trace_bytes_in_use);
+      void* ptr = allocator.AllocateRaw(Allocator::kAllocatorAlignment,
+                                        event.requested_bytes, attr);
+      if (ptr == nullptr) {
+        ++result.num_failed_allocations;
+      }
+      LiveAllocation allocation = {ptr, event.allocated_bytes};
+      if (!live_allocations.emplace(event.address, allocation).second) {
+        return absl::DataLossError(
+            absl::StrCat("Address ", event.address,
+                         " was allocated twice without being deallocated"));
+      }
+    } else {
+      auto it = live_allocations.find(event.address);
+      if (it == live_allocations.end()) {
+        return absl::DataLossError(absl::StrCat(
+            "Address ", event.address, " was deallocated but not allocated"));
+      }
+      trace_bytes_in_use -= it->second.recorded_bytes;
+      if (it->second.ptr != nullptr) {
+        allocator.DeallocateRaw(it->second.ptr);
+      }
+      live_allocations.erase(it);
+    }
+  }
+
+  std::optional<AllocatorStats> stats = allocator.GetStats();
+  result.peak_bytes_in_use = stats->peak_bytes_in_use;
+  result.peak_pool_bytes = stats->peak_pool_bytes.value_or(0);
+  // Allocations that were still live when the trace ended.
+  for (const auto& [address, allocation] : live_allocations) {
+    if (allocation.ptr != nullptr) {
+      allocator.DeallocateRaw(allocation.ptr);
+    }
+  }
+  return result;
+}
+
+}  // namespace tsl
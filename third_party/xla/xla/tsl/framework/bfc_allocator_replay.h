@@ -0,0 +1,63 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_FRAMEWORK_BFC_ALLOCATOR_REPLAY_H_
+#define XLA_TSL_FRAMEWORK_BFC_ALLOCATOR_REPLAY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "xla/tsl/framework/bfc_allocation_trace.h"
+#include "xla/tsl/framework/bfc_allocator.h"
+
+namespace tsl {
+
+// The allocator configuration that a trace is replayed against.
+struct BFCAllocatorReplayConfig {
+  size_t memory_limit = size_t{1} << 40;
+  // allow_retry_on_failure and allocation_trace_file are ignored.
+  BFCAllocator::Options options;
+  // Whether the sub-allocator allows adjacent regions to be coalesced.
+  bool coalesce_regions = true;
+};
+
+struct BFCAllocatorReplayResult {
+  int64_t num_allocations = 0;
+  int64_t num_failed_allocations = 0;
+  // The peak of the bytes allocated by the recorded allocator.
+  int64_t trace_peak_bytes_in_use = 0;
+  // The peak of the bytes allocated by, and of the memory obtained from the
+  // sub-allocator by, the replayed allocator. Their difference is the memory
+  // lost to fragmentation at the peak.
+  int64_t peak_bytes_in_use = 0;
+  int64_t peak_pool_bytes = 0;
+
+  std::string DebugString() const;
+};
+
+// Replays the allocations and deallocations read from `reader` against a
+// BFCAllocator configured by `config`, in the order in which they were
+// recorded. The sub-allocator hands out address space without backing it by
+// memory, so traces of device allocators can be replayed on any host.
+//
+// Failed allocations are counted, and their deallocations ignored.
+absl::StatusOr<BFCAllocatorReplayResult> ReplayBFCAllocationTrace(
+    BFCAllocationTraceReader* reader, const BFCAllocatorReplayConfig& config);
+
+}  // namespace tsl
+
+#endif  // XLA_TSL_FRAMEWORK_BFC_ALLOCATOR_REPLAY_H_
@@ -0,0 +1,87 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Replays a BFC allocation trace, recorded with
+// BFCAllocator::Options::allocation_trace_file (for GPU allocators, by setting
+// TF_GPU_BFC_ALLOCATION_TRACE_DIR), against a BFCAllocator with the given
+// configuration, and prints the resulting peak memory usage. E.g.:
+//
+//   bfc_allocator_replay_main --trace=/tmp/traces/GPU_0_bfc.bfctrace \
+//       --memory_limit=8589934592 --allow_growth=true \
+//       --garbage_collection=true --fragmentation_fraction=0.01
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xla/tsl/framework/bfc_allocation_trace.h"
+#include "xla/tsl/framework/bfc_allocator_replay.h"
+#include "xla/tsl/util/command_line_flags.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/status.h"
+
+int main(int argc, char** argv) {
+  std::string trace;
+  int64_t memory_limit = int64_t{1} << 40;
+  bool allow_growth = true;
+  bool garbage_collection = false;
+  float fragmentation_fraction = 0;
+  bool coalesce_regions = true;
+  const std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("trace", &trace, "BFC allocation trace to replay"),
+      tsl::Flag("memory_limit", &memory_limit,
+                "memory limit of the allocator in bytes"),
+      tsl::Flag("allow_growth", &allow_growth,
+                "grow the pool on demand, instead of allocating the memory "
+                "limit up front"),
+      tsl::Flag("garbage_collection", &garbage_collection,
+                "free unused regions to avoid OOM due to fragmentation"),
+      tsl::Flag("fragmentation_fraction", &fragmentation_fraction,
+                "fraction of the memory limit above which the internal "
+                "fragmentation of an allocation causes its chunk to be split"),
+      tsl::Flag("coalesce_regions", &coalesce_regions,
+                "coalesce chunks across adjacent regions"),
+  };
+  std::string usage = tsl::Flags::Usage(argv[0], flag_list);
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(argv[0], &argc, &argv);
+  if (argc != 1 || !parse_ok) {
+    LOG(QFATAL) << usage;
+  }
+
+  if (trace.empty()) {
+    LOG(QFATAL) << "--trace is required";
+  }
+
+  tsl::BFCAllocatorReplayConfig config;
+  config.memory_limit = memory_limit;
+  config.options.allow_growth = allow_growth;
+  config.options.garbage_collection = garbage_collection;
+  config.options.fragmentation_fraction = fragmentation_fraction;
+  config.coalesce_regions = coalesce_regions;
+
+  absl::StatusOr<std::unique_ptr<tsl::BFCAllocationTraceReader>> reader =
+      tsl::BFCAllocationTraceReader::Open(tsl::Env::Default(), trace);
+  TF_QCHECK_OK(reader.status());
+  absl::StatusOr<tsl::BFCAllocatorReplayResult> result =
+      tsl::ReplayBFCAllocationTrace(reader->get(), config);
+  TF_QCHECK_OK(result.status());
+  std::cout << result->DebugString();
+  return 0;
+}
@@ -0,0 +1,175 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/framework/bfc_allocator_replay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xla/tsl/framework/allocator.h"
+#include "xla/tsl/framework/bfc_allocation_trace.h"
+#include "xla/tsl/framework/bfc_allocator.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/mem.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/test.h"
+#include "tsl/profiler/lib/scoped_memory_debug_annotation.h"
+
+namespace tsl {
+namespace {
+
+class HostSubAllocator : public SubAllocator {
+ public:
+  HostSubAllocator() : SubAllocator({}, {}) {}
+
+  void* Alloc(size_t alignment, size_t num_bytes,
+              size_t* bytes_received) override {
+    *bytes_received = num_bytes;
+    return port::AlignedMalloc(num_bytes, alignment);
+  }
+
+  void Free(void* ptr, size_t num_bytes) override { port::AlignedFree(ptr); }
+
+  bool SupportsCoalescing() const override { return false; }
+};
+
+std::string TracePath(const std::string& name) {
+  return io::JoinPath(testing::TmpDir(), name + ".bfctrace");
+}
+
+TEST(BFCAllocationTraceTest, WriteAndRead) {
+  const std::string path = TracePath("write_and_read");
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<BFCAllocationTraceWriter> writer,
+        BFCAllocationTraceWriter::Create(Env::Default(), path));
+    const void* p0 = reinterpret_cast<const void*>(0x1000);
+    const void* p1 = reinterpret_cast<const void*>(0x2000);
+    writer->RecordAllocation(100, p0, 10, 256, "matmul");
+    writer->RecordAllocation(105, p1, 300, 512, nullptr);
+    writer->RecordDeallocation(110, p0);
+    writer->RecordAllocation(120, p0, 20, 256, "matmul");
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BFCAllocationTraceReader> reader,
+      BFCAllocationTraceReader::Open(Env::Default(), path));
+  std::vector<BFCAllocationTraceEvent> events;
+  BFCAllocationTraceEvent event;
+  while (true) {
+    TF_ASSERT_OK_AND_ASSIGN(bool has_event, reader->Next(&event));
+    if (!has_event) {
+      break;
+    }
+    events.push_back(event);
+  }
+  ASSERT_EQ(events.size(), 4);
+
+  EXPECT_EQ(events[0].type, BFCAllocationTraceEvent::kAllocation);
+  EXPECT_EQ(events[0].micros, 0);
+  EXPECT_EQ(events[0].address, 0x1000);
+  EXPECT_EQ(events[0].requested_bytes, 10);
+  EXPECT_EQ(events[0].allocated_bytes, 256);
+  EXPECT_EQ(reader->OpName(events[0].op_name_id), "matmul");
+
+  EXPECT_EQ(events[1].micros, 5);
+  EXPECT_EQ(events[1].op_name_id, 0);
+
+  EXPECT_EQ(events[2].type, BFCAllocationTraceEvent::kDeallocation);
+  EXPECT_EQ(events[2].micros, 10);
+  EXPECT_EQ(events[2].address, 0x1000);
+
+  EXPECT_EQ(events[3].micros, 20);
+  EXPECT_EQ(events[3].op_name_id, events[0].op_name_id);
+}
+
+TEST(BFCAllocationTraceTest, RejectsTruncatedTrace) {
+  const std::string path = TracePath("truncated");
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<BFCAllocationTraceWriter> writer,
+        BFCAllocationTraceWriter::Create(Env::Default(), path));
+    writer->RecordAllocation(0, reinterpret_cast<const void*>(0x1000), 1000,
+                             1024, "op");
+  }
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), path, &contents));
+  contents.pop_back();
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BFCAllocationTraceReader> reader,
+                          BFCAllocationTraceReader::FromString(contents));
+  BFCAllocationTraceEvent event;
+  EXPECT_FALSE(reader->Next(&event).ok());
+  EXPECT_FALSE(BFCAllocationTraceReader::FromString("not a trace").ok());
+}
+
+TEST(BFCAllocatorReplayTest, ReplayReproducesRecordedPeak) {
+  const std::string path = TracePath("replay");
+  int64_t recorded_peak_bytes_in_use;
+  {
+    // A single region, so that the replay makes the same decisions.
+    BFCAllocator::Options opts;
+    opts.allow_growth = false;
+    opts.allocation_trace_file = path;
+    BFCAllocator a(std::make_unique<HostSubAllocator>(), 1 << 24, "bfc",
+                   opts);
+    profiler::ScopedMemoryDebugAnnotation annotation("test_op");
+    std::vector<void*> ptrs;
+    for (int i = 1; i <= 64; ++i) {
+      ptrs.push_back(a.AllocateRaw(Allocator::kAllocatorAlignment, i * 1000));
+    }
+    for (int i = 0; i < 64; i += 2) {
+      a.DeallocateRaw(ptrs[i]);
+    }
+    void* big = a.AllocateRaw(Allocator::kAllocatorAlignment, 1 << 20);
+    a.DeallocateRaw(big);
+    for (int i = 1; i < 64; i += 2) {
+      a.DeallocateRaw(ptrs[i]);
+    }
+    recorded_peak_bytes_in_use = a.GetStats()->peak_bytes_in_use;
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BFCAllocationTraceReader> reader,
+      BFCAllocationTraceReader::Open(Env::Default(), path));
+  BFCAllocatorReplayConfig config;
+  config.memory_limit = 1 << 24;
+  config.options.allow_growth = false;
+  TF_ASSERT_OK_AND_ASSIGN(BFCAllocatorReplayResult result,
+                          ReplayBFCAllocationTrace(reader.get(), config));
+  EXPECT_EQ(result.num_allocations, 65);
+  EXPECT_EQ(result.num_failed_allocations, 0);
+  EXPECT_EQ(result.trace_peak_bytes_in_use, recorded_peak_bytes_in_use);
+  EXPECT_EQ(result.peak_bytes_in_use, recorded_peak_bytes_in_use);
+  EXPECT_GE(result.peak_pool_bytes, result.peak_bytes_in_use);
+
+  // With a memory limit below the peak, some allocations fail.
+  TF_ASSERT_OK_AND_ASSIGN(
+      reader, BFCAllocationTraceReader::Open(Env::Default(), path));
+  config.memory_limit = recorded_peak_bytes_in_use / 2;
+  TF_ASSERT_OK_AND_ASSIGN(result,
+                          ReplayBFCAllocationTrace(reader.get(), config));
+  EXPECT_EQ(result.num_allocations, 65);
+  EXPECT_GT(result.num_failed_allocations, 0);
+  EXPECT_LE(result.peak_pool_bytes, config.memory_limit);
+}
+
+}  // namespace
+}  // namespace tsl
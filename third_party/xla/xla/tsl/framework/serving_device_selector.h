@@ -53,14 +53,23 @@ class DeviceReservation {
 // NOTE: This interface is experimental and subject to change.
 class ServingDeviceSelector {
  public:
-  // Tracks the running average of certain program execution time.
+  // Tracks the running average of certain program execution time. The average
+  // of the first kWindow values is exact, after which it becomes an
+  // exponentially weighted moving average with weight 1 / kWindow for new
+  // values, so that estimates follow changes in execution time.
   class RunningAverage {
    public:
+    static constexpr int64_t kWindow = 16;
+
     void Add(int64_t value) {
       DCHECK_GE(value, 0);
-      sum_ += value;
-      ++count_;
-      latency_ = sum_ / count_;
+      if (count_ < kWindow) {
+        sum_ += value;
+        ++count_;
+        latency_ = sum_ / count_;
+      } else {
+        latency_ += (value - latency_) / kWindow;
+      }
     }
 
     int64_t Get() const { return latency_; }
@@ -133,6 +142,11 @@ class ServingDeviceSelector {
   // Struct of all tracked device states, which will be passed to Policy.
   struct DeviceStates {
     absl::Span<const DeviceState> states;
+    // Estimated time in nanoseconds until each device would complete the
+    // program being selected for, i.e. the time until the device is idle plus
+    // the execution time of the program. Empty if the selector does not
+    // estimate it.
+    absl::Span<const int64_t> estimated_completion_ns;
   };
 
   // Policy used to select a device.
@@ -15,6 +15,7 @@ limitations under the License.
 #include "xla/tsl/framework/serving_device_selector_policies.h"
 
 #include <atomic>
+#include <cstdint>
 
 #include "absl/strings/string_view.h"
 #include "xla/tsl/framework/serving_device_selector.h"
@@ -28,4 +29,44 @@ int RoundRobinPolicy::SelectDevice(
   return ordinal_.fetch_add(1, std::memory_order_relaxed) % num_devices;
 }
 
+namespace {
+
+int64_t NumQueuedPrograms(const ServingDeviceSelector::DeviceState& state) {
+  int64_t num_programs = 0;
+  for (const auto& programs : state.enqueued_programs) {
+    num_programs += programs.size();
+  }
+  for (const auto& programs : state.scheduled_programs) {
+    num_programs += programs.size();
+  }
+  return num_programs;
+}
+
+}  // namespace
+
+int EarliestCompletionPolicy::SelectDevice(
+    absl::string_view program_fingerprint,
+    const ServingDeviceSelector::DeviceStates& device_states) {
+  const int num_devices = device_states.states.size();
+  const bool has_estimates =
+      device_states.estimated_completion_ns.size() == num_devices;
+  auto cost = [&](int device) -> int64_t {
+    return has_estimates ? device_states.estimated_completion_ns[device]
+                         : NumQueuedPrograms(device_states.states[device]);
+  };
+  const int first =
+      ordinal_.fetch_add(1, std::memory_order_relaxed) % num_devices;
+  int selected = first;
+  int64_t selected_cost = cost(first);
+  for (int i = 1; i < num_devices; ++i) {
+    const int device = (first + i) % num_devices;
+    const int64_t device_cost = cost(device);
+    if (device_cost < selected_cost) {
+      selected = device;
+      selected_cost = device_cost;
+    }
+  }
+  return selected;
+}
+
 }  // namespace tsl
@@ -23,6 +23,7 @@ namespace tsl {
 
 enum class ServingDeviceSelectorPolicy {
   kRoundRobin,
+  kEarliestCompletion,
 };
 
 class RoundRobinPolicy : public ServingDeviceSelector::Policy {
@@ -37,6 +38,22 @@ class RoundRobinPolicy : public ServingDeviceSelector::Policy {
   std::atomic<uint64_t> ordinal_;
 };
 
+// Selects the device with the earliest estimated completion of the program, or
+// with the fewest queued programs if the selector does not estimate completion
+// times. Ties are broken round-robin, so that programs are spread evenly while
+// execution times are unknown.
+class EarliestCompletionPolicy : public ServingDeviceSelector::Policy {
+ public:
+  EarliestCompletionPolicy() : ordinal_(0) {}
+
+  int SelectDevice(
+      absl::string_view program_fingerprint,
+      const ServingDeviceSelector::DeviceStates& device_states) override;
+
+ private:
+  std::atomic<uint64_t> ordinal_;
+};
+
 }  // namespace tsl
 
 #endif  // XLA_TSL_FRAMEWORK_SERVING_DEVICE_SELECTOR_POLICIES_H_
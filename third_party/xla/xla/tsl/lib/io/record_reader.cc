@@ -102,7 +102,7 @@ inline const char* GetChecksumErrorSuffix(uint64 offset) {
 // a reminder about the file format is added, because TFRecord files
 // contain no explicit format marker.
 absl::Status RecordReader::ReadChecksummed(uint64 offset, size_t n,
-                                           tstring* result) {
+                                           tstring* result, bool verify) {
   if (n >= SIZE_MAX - sizeof(uint32)) {
     return errors::DataLoss("record size too large",
                             GetChecksumErrorSuffix(offset));
@@ -121,7 +121,8 @@ absl::Status RecordReader::ReadChecksummed(uint64 offset, size_t n,
   }
 
   const uint32 masked_crc = core::DecodeFixed32(result->data() + n);
-  if (crc32c::Unmask(masked_crc) != crc32c::Value(result->data(), n)) {
+  if (verify &&
+      crc32c::Unmask(masked_crc) != crc32c::Value(result->data(), n)) {
     return errors::DataLoss("corrupted record at ", offset,
                             GetChecksumErrorSuffix(offset));
   }
@@ -209,7 +210,9 @@ absl::Status RecordReader::ReadRecord(uint64* offset, tstring* record) {
   const uint64 length = core::DecodeFixed64(record->data());
 
   // Read data
-  s = ReadChecksummed(*offset + kHeaderSize, length, record);
+  const bool verify = options_.data_checksum_interval <= 1 ||
+                      num_records_read_ % options_.data_checksum_interval == 0;
+  s = ReadChecksummed(*offset + kHeaderSize, length, record, verify);
   if (!s.ok()) {
     last_read_failed_ = true;
     if (errors::IsOutOfRange(s)) {
@@ -219,6 +222,7 @@ absl::Status RecordReader::ReadRecord(uint64* offset, tstring* record) {
     return s;
   }
 
+  ++num_records_read_;
   *offset += kHeaderSize + length + kFooterSize;
   DCHECK_EQ(*offset, input_stream_->Tell());
   return absl::OkStatus();
@@ -46,6 +46,12 @@ struct RecordReaderOptions {
   // compressed files.) Consider using SequentialRecordReader.
   int64_t buffer_size = 0;
 
+  // If data_checksum_interval is greater than 1, the checksum of the data of
+  // only one record out of every data_checksum_interval is verified, which
+  // saves CPU time on trusted storage. The checksums of record lengths are
+  // always verified.
+  int64_t data_checksum_interval = 1;
+
   static RecordReaderOptions CreateRecordReaderOptions(
       const string& compression_type);
 
@@ -115,12 +121,16 @@ class RecordReader {
   absl::Status GetMetadata(Metadata* md);
 
  private:
-  absl::Status ReadChecksummed(uint64 offset, size_t n, tstring* result);
+  // If `verify` is false, the checksum is read but not verified.
+  absl::Status ReadChecksummed(uint64 offset, size_t n, tstring* result,
+                               bool verify = true);
   absl::Status PositionInputStream(uint64 offset);
 
   RecordReaderOptions options_;
   std::unique_ptr<InputStreamInterface> input_stream_;
   bool last_read_failed_;
+  // Number of records read, used to sample the checksums to verify.
+  int64_t num_records_read_ = 0;
 
   std::unique_ptr<Metadata> cached_metadata_;
 
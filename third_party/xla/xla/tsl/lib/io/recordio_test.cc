@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "absl/strings/str_cat.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "xla/tsl/lib/hash/crc32c.h"
 #include "xla/tsl/lib/io/record_reader.h"
@@ -368,6 +369,39 @@ TEST_F(RecordioTest, CorruptDataCrc) {
   AssertHasSubstr(Read(), "corrupted record");
 }
 
+TEST(RecordReaderTest, SampledDataChecksums) {
+  string contents;
+  StringDest dest(&contents);
+  RecordWriter writer(&dest);
+  for (int i = 0; i < 4; ++i) {
+    TF_ASSERT_OK(writer.WriteRecord(absl::StrCat("record", i)));
+  }
+  TF_ASSERT_OK(writer.Flush());
+  // Corrupts the data of the second record.
+  const size_t record_size =
+      RecordReader::kHeaderSize + 7 + RecordReader::kFooterSize;
+  contents[record_size + RecordReader::kHeaderSize] ^= 1;
+
+  StringSource source(&contents);
+  RecordReaderOptions options;
+  options.data_checksum_interval = 2;
+  RecordReader reader(&source, options);
+  uint64 offset = 0;
+  tstring record;
+  TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+  EXPECT_EQ(record, "record0");
+  // The checksum of the second record is not verified.
+  TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+  EXPECT_EQ(record, "secord1");
+
+  // With the default options, every checksum is verified.
+  RecordReader verifying_reader(&source);
+  offset = record_size;
+  absl::Status s = verifying_reader.ReadRecord(&offset, &record);
+  EXPECT_TRUE(errors::IsDataLoss(s)) << s;
+  EXPECT_EQ(s.message(), absl::StrCat("corrupted record at ", record_size));
+}
+
 TEST_F(RecordioTest, ReadEnd) { CheckOffsetPastEndReturnsNoRecords(0); }
 
 TEST_F(RecordioTest, ReadPastEnd) { CheckOffsetPastEndReturnsNoRecords(5); }
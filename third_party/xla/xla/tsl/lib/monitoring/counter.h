@@ -84,6 +84,7 @@ class Counter {
 #include <memory>
 #include <tuple>
 
+#include "absl/base/optimization.h"
 #include "xla/tsl/lib/monitoring/collection_registry.h"
 #include "xla/tsl/lib/monitoring/metric_def.h"
 #include "tsl/platform/logging.h"
@@ -106,7 +107,9 @@ namespace monitoring {
 // This class is thread-safe.
 class CounterCell {
  public:
-  explicit CounterCell(int64_t value) : value_(value) {}
+  explicit CounterCell(int64_t value) {
+    shards_[0].value.store(value, std::memory_order_relaxed);
+  }
   ~CounterCell() {}
 
   // Atomically increments the value by step.
@@ -117,7 +120,18 @@ class CounterCell {
   int64_t value() const;
 
  private:
-  std::atomic<int64_t> value_;
+  // Counters are often incremented on hot paths from many threads, so the
+  // value is split into shards on separate cache lines. Each thread increments
+  // its own shard and value() sums them.
+  static constexpr int kNumShards = 8;
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    std::atomic<int64_t> value{0};
+  };
+
+  // Returns the shard incremented by the calling thread.
+  static int ThreadShard();
+
+  Shard shards_[kNumShards];
 
   CounterCell(const CounterCell&) = delete;
   void operator=(const CounterCell&) = delete;
@@ -201,12 +215,25 @@ class Counter {
 //  Implementation details follow. API readers may skip.
 ////
 
+inline int CounterCell::ThreadShard() {
+  static std::atomic<int> next_shard{0};
+  static thread_local const int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
 inline void CounterCell::IncrementBy(const int64_t step) {
   DCHECK_LE(0, step) << "Must not decrement cumulative metrics.";
-  value_ += step;
+  shards_[ThreadShard()].value.fetch_add(step, std::memory_order_relaxed);
 }
 
-inline int64_t CounterCell::value() const { return value_; }
+inline int64_t CounterCell::value() const {
+  int64_t value = 0;
+  for (const Shard& shard : shards_) {
+    value += shard.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
 
 template <int NumLabels>
 template <typename... MetricDefArgs>
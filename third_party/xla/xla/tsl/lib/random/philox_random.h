@@ -190,6 +190,41 @@ class PhiloxRandom {
     return counter;
   }
 
+  // Returns the next `N` groups of random numbers in `results`, the same as `N`
+  // calls to operator(). The rounds are computed for all groups in lockstep,
+  // with each word of the groups in its own array, so that the compiler can
+  // vectorize them across the groups.
+  template <int N>
+  PHILOX_DEVICE_INLINE void GenerateBlocks(ResultType* results) {
+    uint32_t c0[N], c1[N], c2[N], c3[N];
+    for (int i = 0; i < N; ++i) {
+      c0[i] = counter_[0];
+      c1[i] = counter_[1];
+      c2[i] = counter_[2];
+      c3[i] = counter_[3];
+      SkipOne();
+    }
+    Key key = key_;
+    for (int round = 0; round < 10; ++round) {
+      for (int i = 0; i < N; ++i) {
+        // Same as ComputeSingleRound().
+        const uint64_t product0 = static_cast<uint64_t>(kPhiloxM4x32A) * c0[i];
+        const uint64_t product1 = static_cast<uint64_t>(kPhiloxM4x32B) * c2[i];
+        c0[i] = static_cast<uint32_t>(product1 >> 32) ^ c1[i] ^ key[0];
+        c1[i] = static_cast<uint32_t>(product1);
+        c2[i] = static_cast<uint32_t>(product0 >> 32) ^ c3[i] ^ key[1];
+        c3[i] = static_cast<uint32_t>(product0);
+      }
+      RaiseKey(&key);
+    }
+    for (int i = 0; i < N; ++i) {
+      results[i][0] = c0[i];
+      results[i][1] = c1[i];
+      results[i][2] = c2[i];
+      results[i][3] = c3[i];
+    }
+  }
+
  private:
   // We use the same constants as recommended by the original paper.
   static constexpr uint32_t kPhiloxW32A = 0x9E3779B9;
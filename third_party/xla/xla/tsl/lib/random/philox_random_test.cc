@@ -69,6 +69,33 @@ TEST(PhiloxRandomTest, SkipMatchTest) {
   }
 }
 
+// This test checks that generating blocks of samples is equivalent to
+// generating them one group at a time, including across counter carries.
+TEST(PhiloxRandomTest, GenerateBlocksMatchTest) {
+  constexpr int kBlocks = 8;
+  PhiloxRandom::ResultType counter;
+  counter[0] = 0xfffffffc;
+  counter[1] = 0xffffffff;
+  counter[2] = 0xffffffff;
+  counter[3] = 7;
+  PhiloxRandom::Key key;
+  key[0] = static_cast<uint32>(GetTestSeed());
+  key[1] = static_cast<uint32>(GetTestSeed() >> 32);
+
+  PhiloxRandom gen1(counter, key);
+  PhiloxRandom gen2(counter, key);
+  for (int block = 0; block < 2; ++block) {
+    PhiloxRandom::ResultType results[kBlocks];
+    gen1.GenerateBlocks<kBlocks>(results);
+    for (int i = 0; i < kBlocks; ++i) {
+      PhiloxRandom::ResultType expected = gen2();
+      for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+        ASSERT_EQ(results[i][j], expected[j]);
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace random
 }  // namespace tsl